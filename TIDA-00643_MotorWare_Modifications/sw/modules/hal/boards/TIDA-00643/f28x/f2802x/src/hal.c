@@ -47,8 +47,17 @@
 #include "user.h"
 #include "hal_obj.h"
 
+#ifdef FLREC_ENABLE
+// the flash API of the device, linked from the controlSUITE library
+#include "Flash2802x_API_Library.h"
+#endif
+
 #ifdef FLASH
 #pragma CODE_SECTION(HAL_setupFlash,"ramfuncs");
+#ifdef FLREC_ENABLE
+#pragma CODE_SECTION(HAL_eraseFlashSector,"ramfuncs");
+#pragma CODE_SECTION(HAL_programFlash,"ramfuncs");
+#endif
 #endif
 
 // **************************************************************************
@@ -654,11 +663,20 @@ HAL_Handle HAL_init(void *pMemory,const size_t numBytes)
   obj->pwmHandle[1] = PWM_init((void *)PWM_ePWM2_BASE_ADDR,sizeof(PWM_Obj));
   obj->pwmHandle[2] = PWM_init((void *)PWM_ePWM3_BASE_ADDR,sizeof(PWM_Obj));
 
+#ifdef SVGEN1SHUNT_ENABLE
+  // the single shunt ADC triggers
+  obj->pwmTrigHandle = PWM_init((void *)PWM_ePWM4_BASE_ADDR,sizeof(PWM_Obj));
+#endif
+
 
   // initialize power handle
   obj->pwrHandle = PWR_init((void *)PWR_BASE_ADDR,sizeof(PWR_Obj));
 
 
+  // initialize the SCIA handle
+  obj->sciAHandle = SCI_init((void *)SCIA_BASE_ADDR,sizeof(SCI_Obj));
+
+
   // initialize timer drivers
   obj->timerHandle[0] = TIMER_init((void *)TIMER0_BASE_ADDR,sizeof(TIMER_Obj));
   obj->timerHandle[1] = TIMER_init((void *)TIMER1_BASE_ADDR,sizeof(TIMER_Obj));
@@ -758,6 +776,10 @@ void HAL_setParams(HAL_Handle handle,const USER_Params *pUserParams)
   HAL_setupSpiA(handle);
 
 
+  // setup the sciA
+  HAL_setupSciA(handle);
+
+
   // setup the timers
   HAL_setupTimers(handle,
                   pUserParams->systemFreq_MHz);
@@ -855,6 +877,29 @@ void HAL_setupAdcs(HAL_Handle handle)
 
   //configure the SOCs for boostxldrv8305evm_revA
   // sample the first sample twice due to errata sprz342f
+#ifdef SVGEN1SHUNT_ENABLE
+  // the dc link shunt on the ISEN_A input, sampled in the first and second
+  // window by the ePWM4 SOCA and SOCB, twice each since the ADC is idle before
+  // ISEN_DC, first window
+  ADC_setSocChanNumber(obj->adcHandle,ADC_SocNumber_0,ADC_SocChanNumber_B1);
+  ADC_setSocTrigSrc(obj->adcHandle,ADC_SocNumber_0,ADC_SocTrigSrc_EPWM4_ADCSOCA);
+  ADC_setSocSampleDelay(obj->adcHandle,ADC_SocNumber_0,ADC_SocSampleDelay_7_cycles);
+
+  // ISEN_DC, first window
+  ADC_setSocChanNumber(obj->adcHandle,ADC_SocNumber_1,ADC_SocChanNumber_B1);
+  ADC_setSocTrigSrc(obj->adcHandle,ADC_SocNumber_1,ADC_SocTrigSrc_EPWM4_ADCSOCA);
+  ADC_setSocSampleDelay(obj->adcHandle,ADC_SocNumber_1,ADC_SocSampleDelay_7_cycles);
+
+  // ISEN_DC, second window
+  ADC_setSocChanNumber(obj->adcHandle,ADC_SocNumber_2,ADC_SocChanNumber_B1);
+  ADC_setSocTrigSrc(obj->adcHandle,ADC_SocNumber_2,ADC_SocTrigSrc_EPWM4_ADCSOCB);
+  ADC_setSocSampleDelay(obj->adcHandle,ADC_SocNumber_2,ADC_SocSampleDelay_7_cycles);
+
+  // ISEN_DC, second window
+  ADC_setSocChanNumber(obj->adcHandle,ADC_SocNumber_3,ADC_SocChanNumber_B1);
+  ADC_setSocTrigSrc(obj->adcHandle,ADC_SocNumber_3,ADC_SocTrigSrc_EPWM4_ADCSOCB);
+  ADC_setSocSampleDelay(obj->adcHandle,ADC_SocNumber_3,ADC_SocSampleDelay_7_cycles);
+#else
   // ISEN_A
   ADC_setSocChanNumber(obj->adcHandle,ADC_SocNumber_0,ADC_SocChanNumber_B1);
   ADC_setSocTrigSrc(obj->adcHandle,ADC_SocNumber_0,ADC_SocTrigSrc_EPWM1_ADCSOCA);
@@ -874,6 +919,7 @@ void HAL_setupAdcs(HAL_Handle handle)
   ADC_setSocChanNumber(obj->adcHandle,ADC_SocNumber_3,ADC_SocChanNumber_B7);
   ADC_setSocTrigSrc(obj->adcHandle,ADC_SocNumber_3,ADC_SocTrigSrc_EPWM1_ADCSOCA);
   ADC_setSocSampleDelay(obj->adcHandle,ADC_SocNumber_3,ADC_SocSampleDelay_7_cycles);
+#endif
 
   // VSEN_A
   ADC_setSocChanNumber(obj->adcHandle,ADC_SocNumber_4,ADC_SocChanNumber_A7);
@@ -1016,8 +1062,8 @@ void HAL_setupGpios(HAL_Handle handle)
   // nFAULT
   GPIO_setMode(obj->gpioHandle,GPIO_Number_28,GPIO_28_Mode_TZ2_NOT);
 
-  // No connection (TX)
-  GPIO_setMode(obj->gpioHandle,GPIO_Number_29,GPIO_29_Mode_GeneralPurpose);
+  // TX, telemetry output
+  GPIO_setMode(obj->gpioHandle,GPIO_Number_29,GPIO_29_Mode_SCITXDA);
 
   // SPI_SDI if JP5 is soldered, No Connection if JP5 is not soldered
   GPIO_setMode(obj->gpioHandle,GPIO_Number_32,GPIO_32_Mode_GeneralPurpose);
@@ -1207,11 +1253,20 @@ void HAL_setupPwms(HAL_Handle handle,
       PWM_setLoadMode_CmpA(obj->pwmHandle[cnt],PWM_LoadMode_Zero);
       PWM_setLoadMode_CmpB(obj->pwmHandle[cnt],PWM_LoadMode_Zero);
       PWM_setShadowMode_CmpA(obj->pwmHandle[cnt],PWM_ShadowMode_Shadow);
+#ifdef SVGEN1SHUNT_ENABLE
+      // asymmetric, CMPA for the up count and CMPB for the down count
+      PWM_setShadowMode_CmpB(obj->pwmHandle[cnt],PWM_ShadowMode_Shadow);
+
+      // setup the Action-Qualifier Output A Register (AQCTLA) 
+      PWM_setActionQual_CntUp_CmpA_PwmA(obj->pwmHandle[cnt],PWM_ActionQual_Set);
+      PWM_setActionQual_CntDown_CmpB_PwmA(obj->pwmHandle[cnt],PWM_ActionQual_Clear);
+#else
       PWM_setShadowMode_CmpB(obj->pwmHandle[cnt],PWM_ShadowMode_Immediate);
 
       // setup the Action-Qualifier Output A Register (AQCTLA) 
       PWM_setActionQual_CntUp_CmpA_PwmA(obj->pwmHandle[cnt],PWM_ActionQual_Set);
       PWM_setActionQual_CntDown_CmpA_PwmA(obj->pwmHandle[cnt],PWM_ActionQual_Clear);
+#endif
 
       // setup the Dead-Band Generator Control Register (DBCTL)
       PWM_setDeadBandOutputMode(obj->pwmHandle[cnt],PWM_DeadBandOutputMode_EPWMxA_Rising_EPWMxB_Falling);
@@ -1258,6 +1313,36 @@ void HAL_setupPwms(HAL_Handle handle,
   PWM_clearIntFlag(obj->pwmHandle[PWM_Number_1]);
   PWM_clearSocAFlag(obj->pwmHandle[PWM_Number_1]);
 
+#ifdef SVGEN1SHUNT_ENABLE
+  // ePWM4 counts with the phases and starts the single shunt samples,
+  // SOCA and SOCB in the up count of every PWM period
+  PWM_setCounterMode(obj->pwmTrigHandle,PWM_CounterMode_UpDown);
+  PWM_disableCounterLoad(obj->pwmTrigHandle);
+  PWM_setPeriodLoad(obj->pwmTrigHandle,PWM_PeriodLoad_Immediate);
+  PWM_setSyncMode(obj->pwmTrigHandle,PWM_SyncMode_EPWMxSYNC);
+  PWM_setHighSpeedClkDiv(obj->pwmTrigHandle,PWM_HspClkDiv_by_1);
+  PWM_setClkDiv(obj->pwmTrigHandle,PWM_ClkDiv_by_1);
+  PWM_setPhaseDir(obj->pwmTrigHandle,PWM_PhaseDir_CountUp);
+  PWM_setRunMode(obj->pwmTrigHandle,PWM_RunMode_FreeRun);
+  PWM_setPhase(obj->pwmTrigHandle,0);
+  PWM_setCount(obj->pwmTrigHandle,0);
+  PWM_setPeriod(obj->pwmTrigHandle,0);
+
+  PWM_setLoadMode_CmpA(obj->pwmTrigHandle,PWM_LoadMode_Zero);
+  PWM_setLoadMode_CmpB(obj->pwmTrigHandle,PWM_LoadMode_Zero);
+  PWM_setShadowMode_CmpA(obj->pwmTrigHandle,PWM_ShadowMode_Shadow);
+  PWM_setShadowMode_CmpB(obj->pwmTrigHandle,PWM_ShadowMode_Shadow);
+
+  PWM_disableInt(obj->pwmTrigHandle);
+  PWM_setSocAPulseSrc(obj->pwmTrigHandle,PWM_SocPulseSrc_CounterEqualCmpAIncr);
+  PWM_setSocBPulseSrc(obj->pwmTrigHandle,PWM_SocPulseSrc_CounterEqualCmpBIncr);
+  PWM_setSocAPeriod(obj->pwmTrigHandle,PWM_SocPeriod_FirstEvent);
+  PWM_setSocBPeriod(obj->pwmTrigHandle,PWM_SocPeriod_FirstEvent);
+  PWM_enableSocAPulse(obj->pwmTrigHandle);
+  PWM_enableSocBPulse(obj->pwmTrigHandle);
+  PWM_clearSocAFlag(obj->pwmTrigHandle);
+#endif
+
   // first step to synchronize the pwms
   CLK_disableTbClockSync(obj->clkHandle);
 
@@ -1266,6 +1351,9 @@ void HAL_setupPwms(HAL_Handle handle,
   PWM_setPeriod(obj->pwmHandle[PWM_Number_1],halfPeriod_cycles);
   PWM_setPeriod(obj->pwmHandle[PWM_Number_2],halfPeriod_cycles);
   PWM_setPeriod(obj->pwmHandle[PWM_Number_3],halfPeriod_cycles);
+#ifdef SVGEN1SHUNT_ENABLE
+  PWM_setPeriod(obj->pwmTrigHandle,halfPeriod_cycles);
+#endif
 
   // last step to synchronize the pwms
   CLK_enableTbClockSync(obj->clkHandle);
@@ -1294,6 +1382,30 @@ void HAL_setupSpiA(HAL_Handle handle)
 }  // end of HAL_setupSpiA() function
 
 
+void HAL_setupSciA(HAL_Handle handle)
+{
+  HAL_Obj   *obj = (HAL_Obj *)handle;
+
+  // 8 data bits, no parity, one stop bit, transmit only
+  SCI_reset(obj->sciAHandle);
+  SCI_resetChannels(obj->sciAHandle);
+  SCI_setCharLength(obj->sciAHandle,SCI_CharLength_8_Bits);
+  SCI_disableParity(obj->sciAHandle);
+  SCI_setNumStopBits(obj->sciAHandle,SCI_NumStopBits_One);
+  SCI_setMode(obj->sciAHandle,SCI_Mode_IdleLine);
+  SCI_setBaudRate(obj->sciAHandle,HAL_SCIA_BAUD_RATE);
+  SCI_setPriority(obj->sciAHandle,SCI_Priority_FreeRun);
+  SCI_enableTx(obj->sciAHandle);
+  SCI_enableTxFifoEnh(obj->sciAHandle);
+  SCI_resetTxFifo(obj->sciAHandle);
+  SCI_enableTxFifo(obj->sciAHandle);
+  SCI_enableChannels(obj->sciAHandle);
+  SCI_enable(obj->sciAHandle);
+
+  return;
+}  // end of HAL_setupSciA() function
+
+
 void HAL_setupTimers(HAL_Handle handle,const uint_least16_t systemFreq_MHz)
 {
   HAL_Obj  *obj = (HAL_Obj *)handle;
@@ -1361,6 +1473,42 @@ void HAL_setupeCAP(HAL_Handle handle)
     //Disables counter synchronization
     CAP_disableSyncIn(obj->capHandle);
 
+#if defined(DSHOT_ENABLE) && defined(DSHOT_BIDIR_ENABLE)
+    // bidirectional DShot, the pulses are low,
+    // CAP1/CAP3 falling and CAP2/CAP4 rising edges
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_1, CAP_Polarity_Falling);
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_2, CAP_Polarity_Rising);
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_3, CAP_Polarity_Falling);
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_4, CAP_Polarity_Rising);
+#elif defined(DSHOT_ENABLE)
+    // DShot with absolute time stamps,
+    // CAP1/CAP3 rising and CAP2/CAP4 falling edges
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_1, CAP_Polarity_Rising);
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_2, CAP_Polarity_Falling);
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_3, CAP_Polarity_Rising);
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_4, CAP_Polarity_Falling);
+#endif
+
+#ifdef DSHOT_ENABLE
+    CAP_setCapEvtReset(obj->capHandle, CAP_Event_1, CAP_Reset_Disable);
+    CAP_setCapEvtReset(obj->capHandle, CAP_Event_2, CAP_Reset_Disable);
+    CAP_setCapEvtReset(obj->capHandle, CAP_Event_3, CAP_Reset_Disable);
+    CAP_setCapEvtReset(obj->capHandle, CAP_Event_4, CAP_Reset_Disable);
+
+    CAP_setCapContinuous(obj->capHandle);
+
+    CAP_setStopWrap(obj->capHandle, CAP_Stop_Wrap_CEVT4);
+
+    CAP_enableCaptureLoad(obj->capHandle);
+
+    CAP_enableTimestampCounter(obj->capHandle);
+
+    // an interrupt per pulse, CAP1/CAP2 are read while CAP3/CAP4 are
+    // loaded and the other way round, so the interrupt may wait for up
+    // to one pulse
+    CAP_enableInt(obj->capHandle, CAP_Int_Type_CEVT2);
+    CAP_enableInt(obj->capHandle, CAP_Int_Type_CEVT4);
+#else
     //Sets the capture event polarity
     CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_1, CAP_Polarity_Rising);
 
@@ -1387,6 +1535,7 @@ void HAL_setupeCAP(HAL_Handle handle)
 
     //Enables capture (CAP) interrupt source
     CAP_enableInt(obj->capHandle, CAP_Int_Type_CEVT2);
+#endif
 
     // enable eCAP interrupt
     PIE_enableInt(obj->pieHandle, PIE_GroupNumber_4, PIE_InterruptSource_ECAP1);
@@ -1397,4 +1546,140 @@ void HAL_setupeCAP(HAL_Handle handle)
     return;
 } // end of HAL_setupCAP() function
 
+
+bool HAL_startDshotReply(HAL_Handle handle,const uint32_t startCnt,
+                         const uint32_t period_cnts,const uint32_t low_cnts)
+{
+  HAL_Obj *obj = (HAL_Obj *)handle;
+
+  // the flight controller expects the reply at the start time
+  if((int32_t)(CAP_getTimestampCounter(obj->capHandle) - startCnt) >= 0)
+    {
+      return(false);
+    }
+
+  // no captures of the own edges
+  CAP_disableCaptureLoad(obj->capHandle);
+  CAP_disableInt(obj->capHandle,CAP_Int_Type_CEVT2);
+  CAP_disableInt(obj->capHandle,CAP_Int_Type_CEVT4);
+
+  // in APWM mode these also load the shadows, so set them before the
+  // switch: the line stays high up to the start time, the counter keeps
+  // the time stamp and restarts there
+  CAP_setApwmPeriod(obj->capHandle,startCnt - 1);
+  CAP_setApwmCompare(obj->capHandle,0);
+
+  CAP_setApwmPolarity(obj->capHandle,CAP_ApwmPolarity_Low);
+  CAP_setModeApwm(obj->capHandle);
+
+  CAP_setApwmShadowPeriod(obj->capHandle,period_cnts - 1);
+  CAP_setApwmShadowCompare(obj->capHandle,low_cnts);
+
+  CAP_clearInt(obj->capHandle,CAP_Int_Type_All);
+  CAP_enableInt(obj->capHandle,CAP_Int_Type_CTR_PRD);
+
+  return(true);
+} // end of HAL_startDshotReply() function
+
+
+void HAL_writeDshotReplyPeriod(HAL_Handle handle,const uint32_t period_cnts,const uint32_t low_cnts)
+{
+  HAL_Obj *obj = (HAL_Obj *)handle;
+
+  CAP_setApwmShadowPeriod(obj->capHandle,period_cnts - 1);
+  CAP_setApwmShadowCompare(obj->capHandle,low_cnts);
+
+  return;
+} // end of HAL_writeDshotReplyPeriod() function
+
+
+void HAL_stopDshotReply(HAL_Handle handle,const uint32_t endCnt)
+{
+  HAL_Obj *obj = (HAL_Obj *)handle;
+
+  // release the line, the counter holds the time since the idle period
+  // started
+  CAP_setModeCap(obj->capHandle);
+  CAP_setTimestampCounter(obj->capHandle,endCnt + CAP_getTimestampCounter(obj->capHandle));
+
+  CAP_disableInt(obj->capHandle,CAP_Int_Type_CTR_PRD);
+  CAP_clearInt(obj->capHandle,CAP_Int_Type_All);
+
+  // start the next frame with CEVT1
+  CAP_rearm(obj->capHandle);
+  CAP_enableCaptureLoad(obj->capHandle);
+  CAP_enableInt(obj->capHandle,CAP_Int_Type_CEVT2);
+  CAP_enableInt(obj->capHandle,CAP_Int_Type_CEVT4);
+
+  return;
+} // end of HAL_stopDshotReply() function
+
+
+#ifdef FLREC_ENABLE
+bool HAL_eraseFlashSector(HAL_Handle handle,uint16_t *pSector)
+{
+  FLASH_ST flashStatus;
+  uint16_t sectorMask;
+  uint16_t intState;
+  uint16_t status;
+
+  (void)handle;
+
+  // only the sectors of the flight recorder region
+  if(pSector == (uint16_t *)HAL_FLASH_LOG_ADDR)
+    {
+      sectorMask = SECTORD;
+    }
+  else if(pSector == (uint16_t *)(HAL_FLASH_LOG_ADDR + HAL_FLASH_LOG_SECTOR_WORDS))
+    {
+      sectorMask = SECTORC;
+    }
+  else
+    {
+      return(false);
+    }
+
+  // the code in flash cannot run during the erase
+  intState = __disable_interrupts();
+
+  Flash_CPUScaleFactor = SCALE_FACTOR;
+  Flash_CallbackPtr = NULL;
+
+  status = Flash_Erase(sectorMask,&flashStatus);
+
+  __restore_interrupts(intState);
+
+  return(status == STATUS_SUCCESS);
+} // end of HAL_eraseFlashSector() function
+
+
+bool HAL_programFlash(HAL_Handle handle,uint16_t *pDst,const uint16_t *pSrc,const uint_least16_t numWords)
+{
+  FLASH_ST flashStatus;
+  uint16_t intState;
+  uint16_t status;
+
+  (void)handle;
+
+  if((pDst < (uint16_t *)HAL_FLASH_LOG_ADDR) ||
+     ((pDst + numWords) > (uint16_t *)(HAL_FLASH_LOG_ADDR + HAL_FLASH_LOG_NUM_SECTORS * HAL_FLASH_LOG_SECTOR_WORDS)))
+    {
+      return(false);
+    }
+
+  // the code in flash cannot run while it is programmed
+  intState = __disable_interrupts();
+
+  Flash_CPUScaleFactor = SCALE_FACTOR;
+  Flash_CallbackPtr = NULL;
+
+  // the API verifies the programmed words
+  status = Flash_Program(pDst,(uint16_t *)pSrc,numWords,&flashStatus);
+
+  __restore_interrupts(intState);
+
+  return(status == STATUS_SUCCESS);
+} // end of HAL_programFlash() function
+#endif
+
 // end of file
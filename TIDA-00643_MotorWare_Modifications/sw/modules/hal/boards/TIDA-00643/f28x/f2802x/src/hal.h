@@ -45,6 +45,9 @@
 
 // **************************************************************************
 // modules
+#ifdef SVGEN1SHUNT_ENABLE
+#include "sw/modules/svgen/src/32b/svgen_1shunt.h"
+#endif
 
 
 // **************************************************************************
@@ -120,6 +123,20 @@ extern "C" {
 //!
 #define HAL_PWM_DBRED_CNT         1        //
 
+//! \brief Defines the change of Tabc from 0 to 100% duty, HAL_writePwmData()
+//! \brief maps Tabc from -1.0 to 1.0
+#define HAL_PWM_DUTY_SPAN         (2.0)
+
+//! \brief Defines the SCIA baud rate of the telemetry output on GPIO29
+//!
+#define HAL_SCIA_BAUD_RATE        SCI_BaudRate_468_75_kBaud
+
+//! \brief Defines the flash region of the flight recorder, sectors D and C of
+//! \brief the F28027, reserved in the linker command file of the project
+#define HAL_FLASH_LOG_ADDR        (0x3F0000)
+#define HAL_FLASH_LOG_SECTOR_WORDS (0x2000)
+#define HAL_FLASH_LOG_NUM_SECTORS (2)
+
 //! \brief Defines the function to turn LEDs off
 //!
 #define HAL_turnLedOff            HAL_setGpioLow
@@ -183,6 +200,40 @@ static inline void HAL_acqAdcInt(HAL_Handle handle,const ADC_IntNumber_e intNumb
 } // end of HAL_acqAdcInt() function
 
 
+#ifndef __TMS320C28XX__
+//! \brief     Lets interrupts preempt the running ISR of the host simulation
+//! \details   The simulation blocks the other interrupts only up to this call, see host/src/hal.c
+//! \param[in] handle     The hardware abstraction layer (HAL) handle
+//! \param[in] intNumber  The CPU interrupts allowed to preempt
+extern void HAL_SIM_enableIsrNesting(HAL_Handle handle,const CPU_IntNumber_e intNumber);
+#endif
+
+
+//! \brief     Lets interrupts preempt the running ISR
+//! \details   Call after the interrupt was acknowledged, the interrupt
+//!            return restores the interrupt enable register and the global
+//!            interrupt mask.  The given interrupts must not share data with
+//!            the rest of the ISR.
+//! \param[in] handle     The hardware abstraction layer (HAL) handle
+//! \param[in] intNumber  The CPU interrupts allowed to preempt
+static inline void HAL_enableIsrNesting(HAL_Handle handle,const CPU_IntNumber_e intNumber)
+{
+#ifdef __TMS320C28XX__
+  (void)handle;
+
+  IER = intNumber;
+
+  // the PIE acknowledge takes effect before the global enable
+  asm(" NOP");
+  EINT;
+#else
+  HAL_SIM_enableIsrNesting(handle,intNumber);
+#endif
+
+  return;
+} // end of HAL_enableIsrNesting() function
+
+
 //! \brief     Acknowledges an interrupt from the PWM so that another PWM interrupt can
 //!            happen again.
 //! \param[in] handle     The hardware abstraction layer (HAL) handle
@@ -495,6 +546,20 @@ static inline void HAL_readAdcData(HAL_Handle handle,HAL_AdcData_t *pAdcData)
   _iq voltage_sf = HAL_getVoltageScaleFactor(handle);
 
 
+#ifdef SVGEN1SHUNT_ENABLE
+  // convert the dc link current of the first and second sample window,
+  // SVGEN1SHUNT_runRegenCurrent() rebuilds the phase currents
+  // sample the first sample twice due to errata sprz342f, ignore the first sample
+  value = (_iq)ADC_readResult(obj->adcHandle,ADC_ResultNumber_1);
+  value = _IQ12mpy(value,current_sf) - obj->adcBias.I.value[0];      // divide by 2^numAdcBits = 2^12
+  pAdcData->I.value[0] = value;
+
+  value = (_iq)ADC_readResult(obj->adcHandle,ADC_ResultNumber_3);
+  value = _IQ12mpy(value,current_sf) - obj->adcBias.I.value[1];      // divide by 2^numAdcBits = 2^12
+  pAdcData->I.value[1] = value;
+
+  pAdcData->I.value[2] = _IQ(0.0);
+#else
   // convert current A
   // sample the first sample twice due to errata sprz342f, ignore the first sample
   value = (_iq)ADC_readResult(obj->adcHandle,ADC_ResultNumber_1);
@@ -510,6 +575,7 @@ static inline void HAL_readAdcData(HAL_Handle handle,HAL_AdcData_t *pAdcData)
   value = (_iq)ADC_readResult(obj->adcHandle,ADC_ResultNumber_3);
   value = _IQ12mpy(value,current_sf) - obj->adcBias.I.value[2];      // divide by 2^numAdcBits = 2^12
   pAdcData->I.value[2] = value;
+#endif
 
   // convert voltage A
   value = (_iq)ADC_readResult(obj->adcHandle,ADC_ResultNumber_4);
@@ -535,19 +601,161 @@ static inline void HAL_readAdcData(HAL_Handle handle,HAL_AdcData_t *pAdcData)
 } // end of HAL_readAdcData() function
 
 
+#ifndef __TMS320C28XX__
+//! \brief     Reads the timer count of the host simulation
+//! \details   The simulated timers count the host time while the ISR runs, see host/src/hal.c
+//! \param[in] handle       The hardware abstraction layer (HAL) handle
+//! \param[in] timerNumber  The timer number, 0,1 or 2
+//! \return    The timer count
+extern uint32_t HAL_SIM_readTimerCnt(HAL_Handle handle,const uint_least8_t timerNumber);
+
+
+//! \brief     Reads the eCAP time stamp counter of the host simulation
+//! \param[in] handle  The hardware abstraction layer (HAL) handle
+//! \return    The time stamp counter
+extern uint32_t HAL_SIM_readCapCnt(HAL_Handle handle);
+
+
+//! \brief     Waits for the next interrupt of the host simulation
+//! \details   Yields to the simulation for one ISR period, see host/src/hal.c
+//! \param[in] handle  The hardware abstraction layer (HAL) handle
+extern void HAL_SIM_idle(HAL_Handle handle);
+
+
+//! \brief     Gets the flash region of the flight recorder of the host simulation
+//! \details   The region is host memory, erased at HAL_SIM_init(), see host/src/hal.c
+//! \param[in] handle  The hardware abstraction layer (HAL) handle
+//! \return    The pointer to the first word of the region
+extern uint16_t *HAL_SIM_getFlashLogAddr(HAL_Handle handle);
+#endif
+
+
+#ifndef __TMS320C28XX__
+//! \brief     Writes to the SCIA transmit FIFO of the host simulation
+//! \details   The simulated FIFO drains at the baud rate in simulated time, see host/src/hal.c
+//! \param[in] handle    The hardware abstraction layer (HAL) handle
+//! \param[in] pData     The pointer to the bytes, one per word
+//! \param[in] numBytes  The number of bytes
+//! \return    The number of bytes written
+extern uint_least16_t HAL_SIM_writeSciTxFifo(HAL_Handle handle,const uint16_t *pData,const uint_least16_t numBytes);
+#endif
+
+
+//! \brief     Writes as many bytes to the SCIA transmit FIFO as it takes without waiting
+//! \param[in] handle    The hardware abstraction layer (HAL) handle
+//! \param[in] pData     The pointer to the bytes, one per word
+//! \param[in] numBytes  The number of bytes
+//! \return    The number of bytes written
+static inline uint_least16_t HAL_writeSciTxFifo(HAL_Handle handle,const uint16_t *pData,const uint_least16_t numBytes)
+{
+#ifdef __TMS320C28XX__
+  HAL_Obj *obj = (HAL_Obj *)handle;
+  uint_least16_t cnt = 0;
+
+  while((cnt < numBytes) && (SCI_getTxFifoStatus(obj->sciAHandle) < SCI_FifoStatus_4_Words))
+    {
+      SCI_write(obj->sciAHandle,pData[cnt]);
+      cnt++;
+    }
+
+  return(cnt);
+#else
+  return(HAL_SIM_writeSciTxFifo(handle,pData,numBytes));
+#endif
+} // end of HAL_writeSciTxFifo() function
+
+
+//! \brief     Reads the eCAP time stamp counter
+//! \details   Counts up at the system clock, the DShot input time base
+//! \param[in] handle  The hardware abstraction layer (HAL) handle
+//! \return    The time stamp counter
+static inline uint32_t HAL_readCapCnt(HAL_Handle handle)
+{
+#ifdef __TMS320C28XX__
+  HAL_Obj *obj = (HAL_Obj *)handle;
+
+  return(CAP_getTimestampCounter(obj->capHandle));
+#else
+  return(HAL_SIM_readCapCnt(handle));
+#endif
+} // end of HAL_readCapCnt() function
+
+
 //! \brief     Reads the timer count
 //! \param[in] handle       The hardware abstraction layer (HAL) handle
 //! \param[in] timerNumber  The timer number, 0,1 or 2
 //! \return    The timer count
 static inline uint32_t HAL_readTimerCnt(HAL_Handle handle,const uint_least8_t timerNumber)
 {
+#ifdef __TMS320C28XX__
   HAL_Obj *obj = (HAL_Obj *)handle;
   uint32_t timerCnt = TIMER_getCount(obj->timerHandle[timerNumber]);
 
   return(timerCnt);
+#else
+  return(HAL_SIM_readTimerCnt(handle,timerNumber));
+#endif
 } // end of HAL_readTimerCnt() function
 
 
+//! \brief     Waits for the next interrupt
+//! \details   The CPU idles until an enabled interrupt wakes it up, the background loop
+//!            calls it when it has nothing to do
+//! \param[in] handle  The hardware abstraction layer (HAL) handle
+static inline void HAL_idle(HAL_Handle handle)
+{
+#ifdef __TMS320C28XX__
+  (void)handle;
+
+  asm(" IDLE");
+#else
+  HAL_SIM_idle(handle);
+#endif
+} // end of HAL_idle() function
+
+
+//! \brief     Gets the cycle by cycle trip flag of the PWMs
+//! \details   The DRV8305 nFAULT pin trips the PWMs on TZ2, see HAL_setupFaults()
+//! \param[in] handle  The hardware abstraction layer (HAL) handle
+//! \return    true when the PWMs were tripped since the flag was cleared
+static inline bool HAL_getCbcTripFlag(HAL_Handle handle)
+{
+  HAL_Obj *obj = (HAL_Obj *)handle;
+  PWM_Obj *pwm = (PWM_Obj *)obj->pwmHandle[PWM_Number_1];
+
+  return((pwm->TZFLG & PWM_TripZoneFlag_CBC) != 0);
+} // end of HAL_getCbcTripFlag() function
+
+
+//! \brief     Clears the cycle by cycle trip flag of the PWMs
+//! \param[in] handle  The hardware abstraction layer (HAL) handle
+static inline void HAL_clearCbcTripFlag(HAL_Handle handle)
+{
+  HAL_Obj *obj = (HAL_Obj *)handle;
+
+  PWM_clearTripZone(obj->pwmHandle[PWM_Number_1],PWM_TripZoneFlag_CBC);
+  PWM_clearTripZone(obj->pwmHandle[PWM_Number_2],PWM_TripZoneFlag_CBC);
+  PWM_clearTripZone(obj->pwmHandle[PWM_Number_3],PWM_TripZoneFlag_CBC);
+
+  return;
+} // end of HAL_clearCbcTripFlag() function
+
+
+//! \brief     Gets the flash region of the flight recorder
+//! \param[in] handle  The hardware abstraction layer (HAL) handle
+//! \return    The pointer to the first word of the region
+static inline uint16_t *HAL_getFlashLogAddr(HAL_Handle handle)
+{
+#ifdef __TMS320C28XX__
+  (void)handle;
+
+  return((uint16_t *)HAL_FLASH_LOG_ADDR);
+#else
+  return(HAL_SIM_getFlashLogAddr(handle));
+#endif
+} // end of HAL_getFlashLogAddr() function
+
+
 //! \brief     Reloads the timer
 //! \param[in] handle       The hardware abstraction layer (HAL) handle
 //! \param[in] timerNumber  The timer number, 0,1 or 2
@@ -923,6 +1131,11 @@ extern void HAL_setupPwms(HAL_Handle handle,
 extern void HAL_setupSpiA(HAL_Handle handle);
 
 
+//! \brief     Sets up the sciA peripheral for transmit only at HAL_SCIA_BAUD_RATE
+//! \param[in] handle   The hardware abstraction layer (HAL) handle
+extern void HAL_setupSciA(HAL_Handle handle);
+
+
 //! \brief      Updates the ADC bias values
 //! \details    This function is called before the motor is started.  It sets the voltage
 //!             and current measurement offsets.
@@ -1049,6 +1262,38 @@ static inline uint16_t HAL_readPwmCmpB(HAL_Handle handle,const PWM_Number_e pwmN
 } // end of HAL_readPwmCmpB() function
 
 
+#ifdef SVGEN1SHUNT_ENABLE
+//! \brief     Sets the single shunt compare values and ADC triggers
+//! \details   Shifts the compare values written by HAL_writePwmData() with
+//!            SVGEN1SHUNT_run(), writes the up count values to CMPA, the down
+//!            count values to CMPB and the two sample points to the ePWM4
+//!            SOCA and SOCB compare values.  All are loaded at the next
+//!            period start.
+//! \param[in] handle             The hardware abstraction layer (HAL) handle
+//! \param[in] svgen1shuntHandle  The single shunt current reconstruction (SVGEN1SHUNT) handle
+static inline void HAL_setTrigger(HAL_Handle handle,SVGEN1SHUNT_Handle svgen1shuntHandle)
+{
+  HAL_Obj *obj = (HAL_Obj *)handle;
+  uint_least8_t cnt;
+
+  SVGEN1SHUNT_run(svgen1shuntHandle,
+                  PWM_getPeriod(obj->pwmHandle[PWM_Number_1]),
+                  PWM_get_CmpA(obj->pwmHandle[PWM_Number_1]),
+                  PWM_get_CmpA(obj->pwmHandle[PWM_Number_2]),
+                  PWM_get_CmpA(obj->pwmHandle[PWM_Number_3]));
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      PWM_write_CmpA(obj->pwmHandle[cnt],SVGEN1SHUNT_getCmpUp(svgen1shuntHandle,cnt));
+      PWM_write_CmpB(obj->pwmHandle[cnt],SVGEN1SHUNT_getCmpDown(svgen1shuntHandle,cnt));
+    }
+
+  PWM_write_CmpA(obj->pwmTrigHandle,SVGEN1SHUNT_getTrigger(svgen1shuntHandle,0));
+  PWM_write_CmpB(obj->pwmTrigHandle,SVGEN1SHUNT_getTrigger(svgen1shuntHandle,1));
+
+  return;
+} // end of HAL_setTrigger() function
+#else
 static inline void HAL_setTrigger(HAL_Handle handle,const int16_t minwidth)
 {
   HAL_Obj *obj = (HAL_Obj *)handle;
@@ -1153,6 +1398,7 @@ static inline void HAL_setTrigger(HAL_Handle handle,const int16_t minwidth)
 
   return;
 } // end of HAL_setTrigger() function
+#endif
 
 
 //! \brief     Reads PWM period register
@@ -1235,6 +1481,62 @@ void HAL_setupDrvSpi(HAL_Handle handle, DRV_SPI_8305_Vars_t *Spi_8305_Vars);
 void HAL_setupeCAP(HAL_Handle handle);
 
 
+//! \brief     Starts a bidirectional DShot reply on the eCAP1 pin
+//! \details   Switches the eCAP to an active low APWM that stays high until
+//!            the start time and then sends the first period, the shadow
+//!            registers hold it.  Every later period boundary raises the
+//!            CTR=PRD interrupt, where HAL_writeDshotReplyPeriod() gives the
+//!            period after it, until HAL_stopDshotReply().  The captures are
+//!            off meanwhile.  Call from the eCAP interrupt.
+//! \param[in] handle       The hardware abstraction layer (HAL) handle
+//! \param[in] startCnt     The eCAP time stamp to start the reply, cnts
+//! \param[in] period_cnts  The first period, cnts
+//! \param[in] low_cnts     The low time of the first period, cnts
+//! \return    false when the start time has passed and nothing was sent
+bool HAL_startDshotReply(HAL_Handle handle,const uint32_t startCnt,
+                         const uint32_t period_cnts,const uint32_t low_cnts);
+
+
+//! \brief     Sets the next period of the bidirectional DShot reply
+//! \details   Call from the CTR=PRD interrupt at the start of a period, the
+//!            period after it is sent.
+//! \param[in] handle       The hardware abstraction layer (HAL) handle
+//! \param[in] period_cnts  The period, cnts
+//! \param[in] low_cnts     The low time, cnts
+void HAL_writeDshotReplyPeriod(HAL_Handle handle,const uint32_t period_cnts,const uint32_t low_cnts);
+
+
+//! \brief     Ends the bidirectional DShot reply and rearms the capture
+//! \details   Call from the CTR=PRD interrupt of the idle period after the
+//!            reply.  The APWM restarts the counter at every period, it is
+//!            set back to the time stamp the captures continue from.
+//! \param[in] handle  The hardware abstraction layer (HAL) handle
+//! \param[in] endCnt  The eCAP time stamp of the idle period start, cnts
+void HAL_stopDshotReply(HAL_Handle handle,const uint32_t endCnt);
+
+
+//! \brief     Erases a sector of the flight recorder flash region
+//! \details   Takes the sector erase time of the flash with the interrupts
+//!            disabled, call when the motor is stopped.  Needs the flash API
+//!            library, FLREC_ENABLE.
+//! \param[in] handle   The hardware abstraction layer (HAL) handle
+//! \param[in] pSector  The pointer to the first word of the sector
+//! \return    true on success
+bool HAL_eraseFlashSector(HAL_Handle handle,uint16_t *pSector);
+
+
+//! \brief     Programs words of the flight recorder flash region
+//! \details   The interrupts are disabled for the programming time of the
+//!            words, the flash is not readable meanwhile.  Needs the flash API
+//!            library, FLREC_ENABLE.
+//! \param[in] handle    The hardware abstraction layer (HAL) handle
+//! \param[in] pDst      The pointer to the erased flash words
+//! \param[in] pSrc      The pointer to the words
+//! \param[in] numWords  The number of words
+//! \return    true when the words were programmed and verified
+bool HAL_programFlash(HAL_Handle handle,uint16_t *pDst,const uint16_t *pSrc,const uint_least16_t numWords);
+
+
 #ifdef __cplusplus
 }
 #endif // extern "C"
@@ -51,6 +51,7 @@
 #include "sw/drivers/pwm/src/32b/f28x/f2802x/pwm.h"
 #include "sw/drivers/pwmdac/src/32b/f28x/f2802x/pwmdac.h"
 #include "sw/drivers/pwr/src/32b/f28x/f2802x/pwr.h"
+#include "sw/drivers/sci/src/32b/f28x/f2802x/sci.h"
 #include "sw/drivers/spi/src/32b/f28x/f2802x/spi.h"
 #include "sw/drivers/timer/src/32b/f28x/f2802x/timer.h"
 #include "sw/drivers/wdog/src/32b/f28x/f2802x/wdog.h"
@@ -150,6 +151,10 @@ typedef struct _HAL_Obj_
 
   PWM_Handle    pwmHandle[3];     //<! the PWM handles
 
+#ifdef SVGEN1SHUNT_ENABLE
+  PWM_Handle    pwmTrigHandle;    //!< the PWM handle of the single shunt ADC triggers
+#endif
+
   PWMDAC_Handle pwmDacHandle[3];  //<! the PWMDAC handles
 
   PWR_Handle    pwrHandle;        //<! the power handle
@@ -170,6 +175,8 @@ typedef struct _HAL_Obj_
   SPI_Handle    spiAHandle;       //!< the SPIA handle
   SPI_Obj       spiA;             //!< the SPIA object
 
+  SCI_Handle    sciAHandle;       //!< the SCIA handle
+
   DRV8305_Handle drv8305Handle;   //!< the drv8305 interface handle
   DRV8305_Obj    drv8305;         //!< the drv8305 interface object
 
@@ -194,7 +201,7 @@ extern HAL_Obj hal;
 //!             speed performance of the motor drive.
 //! \param[in]  handle    The hardware abstraction layer (HAL) handle
 //! \param[in]  pAdcData  The pointer to the ADC data
-inline void HAL_runOffsetEst(HAL_Handle handle,const HAL_AdcData_t *pAdcData)
+static inline void HAL_runOffsetEst(HAL_Handle handle,const HAL_AdcData_t *pAdcData)
 {
   uint_least8_t cnt;
   HAL_Obj *obj = (HAL_Obj *)handle;
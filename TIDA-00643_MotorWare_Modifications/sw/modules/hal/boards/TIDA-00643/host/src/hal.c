@@ -0,0 +1,1703 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file  sw\modules\hal\boards\TIDA-00643\host\src\hal.c
+//! \brief Contains the host build of the HAL object and the simulation of
+//!        the TIDA-00643 power stage
+//!
+//!        The functions keep the names and the behavior of the f2802x HAL
+//!        where the behavior is observable by the project.  Clock, PLL,
+//!        flash, GPIO mux, ADC sequencer, SPI and gate driver setup have no
+//!        host equivalent and are left out.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// platforms
+#include "hal.h"
+#include "user.h"
+#include "hal_obj.h"
+
+#include "hal_sim.h"
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the number of CPU cycles per second
+//!
+#define HAL_SIM_CPU_FREQ_Hz     ((double)USER_SYSTEM_FREQ_MHz * 1000000.0)
+
+
+// **************************************************************************
+// the globals
+
+HAL_Obj hal;
+
+HAL_SIM_Obj halSim;
+
+// the core registers of the C28x CPU
+volatile unsigned int IER;
+volatile unsigned int IFR;
+
+// the peripheral frames, in host memory instead of at the device addresses
+static ADC_Obj    gAdc;
+static CAP_Obj    gCap;
+static CLK_Obj    gClk;
+static FLASH_Obj  gFlash;
+static GPIO_Obj   gGpio;
+static OSC_Obj    gOsc;
+static PIE_Obj    gPie;
+static PLL_Obj    gPll;
+static PWM_Obj    gPwm[3];
+static PWR_Obj    gPwr;
+static SCI_Obj    gSciA;
+static SPI_Obj    gSpiA;
+static TIMER_Obj  gTimer[3];
+static WDOG_Obj   gWdog;
+
+
+// **************************************************************************
+// the functions
+
+void HAL_disableWdog(HAL_Handle halHandle)
+{
+  HAL_Obj *hal = (HAL_Obj *)halHandle;
+
+
+  WDOG_disable(hal->wdogHandle);
+
+
+  return;
+} // end of HAL_disableWdog() function
+
+
+void HAL_disableGlobalInts(HAL_Handle handle)
+{
+  HAL_Obj *obj = (HAL_Obj *)handle;
+
+
+  CPU_disableGlobalInts(obj->cpuHandle);
+
+  return;
+} // end of HAL_disableGlobalInts() function
+
+
+void HAL_enableAdcInts(HAL_Handle handle)
+{
+  HAL_Obj *obj = (HAL_Obj *)handle;
+
+
+  // enable the PIE interrupts associated with the ADC interrupts
+  PIE_enableAdcInt(obj->pieHandle,ADC_IntNumber_1);
+
+
+  // enable the ADC interrupts
+  ADC_enableInt(obj->adcHandle,ADC_IntNumber_1);
+
+
+  // enable the cpu interrupt for ADC interrupts
+  CPU_enableInt(obj->cpuHandle,CPU_IntNumber_10);
+
+  return;
+} // end of HAL_enableAdcInts() function
+
+
+void HAL_enableDebugInt(HAL_Handle handle)
+{
+  HAL_Obj *obj = (HAL_Obj *)handle;
+
+
+  CPU_enableDebugInt(obj->cpuHandle);
+
+  return;
+} // end of HAL_enableDebugInt() function
+
+
+void HAL_enableDrv(HAL_Handle handle)
+{
+
+  // the simulated gate driver is always enabled
+  (void)handle;
+
+  return;
+}  // end of HAL_enableDrv() function
+
+
+void HAL_enableGlobalInts(HAL_Handle handle)
+{
+  HAL_Obj *obj = (HAL_Obj *)handle;
+
+
+  CPU_enableGlobalInts(obj->cpuHandle);
+
+  return;
+} // end of HAL_enableGlobalInts() function
+
+
+void HAL_setupFaults(HAL_Handle handle)
+{
+  HAL_Obj *obj = (HAL_Obj *)handle;
+  uint_least8_t cnt;
+
+  // Configure Trip Mechanism for the Motor control software
+  // -Cycle by cycle trip on CPU halt
+  // -One shot fault trip zone
+  // These trips need to be repeated for EPWM1 ,2 & 3
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      PWM_enableTripZoneSrc(obj->pwmHandle[cnt],PWM_TripZoneSrc_CycleByCycle_TZ2_NOT);
+
+      PWM_setTripZoneState_TZA(obj->pwmHandle[cnt],PWM_TripZoneState_EPWM_Low);
+      PWM_setTripZoneState_TZB(obj->pwmHandle[cnt],PWM_TripZoneState_EPWM_Low);
+    }
+
+  return;
+} // end of HAL_setupFaults() function
+
+
+HAL_Handle HAL_init(void *pMemory,const size_t numBytes)
+{
+  uint_least8_t cnt;
+  HAL_Handle handle;
+  HAL_Obj *obj;
+
+
+  if(numBytes < sizeof(HAL_Obj))
+    return((HAL_Handle)NULL);
+
+
+  // assign the handle
+  handle = (HAL_Handle)pMemory;
+
+
+  // assign the object
+  obj = (HAL_Obj *)handle;
+
+
+  // initialize the watchdog driver
+  obj->wdogHandle = WDOG_init(&gWdog,sizeof(gWdog));
+
+
+  // disable watchdog
+  HAL_disableWdog(handle);
+
+
+  // initialize the ADC
+  obj->adcHandle = ADC_init(&gAdc,sizeof(gAdc));
+
+
+  // initialize the eCAP
+  obj->capHandle = CAP_init(&gCap,sizeof(gCap));
+
+
+  // initialize the clock handle
+  obj->clkHandle = CLK_init(&gClk,sizeof(gClk));
+
+
+  // initialize the CPU handle
+  obj->cpuHandle = CPU_init(&cpu,sizeof(cpu));
+
+
+  // initialize the FLASH handle
+  obj->flashHandle = FLASH_init(&gFlash,sizeof(gFlash));
+
+
+  // initialize the GPIO handle
+  obj->gpioHandle = GPIO_init(&gGpio,sizeof(gGpio));
+
+
+  // initialize the current offset estimator handles
+  for(cnt=0;cnt<USER_NUM_CURRENT_SENSORS;cnt++)
+    {
+      obj->offsetHandle_I[cnt] = OFFSET_init(&obj->offset_I[cnt],sizeof(obj->offset_I[cnt]));
+    }
+
+
+  // initialize the voltage offset estimator handles
+  for(cnt=0;cnt<USER_NUM_VOLTAGE_SENSORS;cnt++)
+    {
+      obj->offsetHandle_V[cnt] = OFFSET_init(&obj->offset_V[cnt],sizeof(obj->offset_V[cnt]));
+    }
+
+
+  // initialize the oscillator handle
+  obj->oscHandle = OSC_init(&gOsc,sizeof(gOsc));
+
+
+  // initialize the PIE handle
+  obj->pieHandle = PIE_init(&gPie,sizeof(gPie));
+
+
+  // initialize the PLL handle
+  obj->pllHandle = PLL_init(&gPll,sizeof(gPll));
+
+
+  // initialize the SPIA handle
+  obj->spiAHandle = SPI_init(&gSpiA,sizeof(gSpiA));
+
+
+  // initialize PWM handle
+  obj->pwmHandle[0] = PWM_init(&gPwm[0],sizeof(gPwm[0]));
+  obj->pwmHandle[1] = PWM_init(&gPwm[1],sizeof(gPwm[1]));
+  obj->pwmHandle[2] = PWM_init(&gPwm[2],sizeof(gPwm[2]));
+
+
+  // initialize power handle
+  obj->pwrHandle = PWR_init(&gPwr,sizeof(gPwr));
+
+
+  // initialize the SCIA handle
+  obj->sciAHandle = SCI_init(&gSciA,sizeof(gSciA));
+
+
+  // initialize timer drivers
+  obj->timerHandle[0] = TIMER_init(&gTimer[0],sizeof(gTimer[0]));
+  obj->timerHandle[1] = TIMER_init(&gTimer[1],sizeof(gTimer[1]));
+  obj->timerHandle[2] = TIMER_init(&gTimer[2],sizeof(gTimer[2]));
+
+
+  // initialize drv8305 interface
+  obj->drv8305Handle = DRV8305_init(&obj->drv8305,sizeof(obj->drv8305));
+
+  return(handle);
+} // end of HAL_init() function
+
+
+void HAL_setParams(HAL_Handle handle,const USER_Params *pUserParams)
+{
+  uint_least8_t cnt;
+  HAL_Obj *obj = (HAL_Obj *)handle;
+  _iq beta_lp_pu = _IQ(pUserParams->offsetPole_rps/(float_t)pUserParams->ctrlFreq_Hz);
+
+
+  HAL_setNumCurrentSensors(handle,pUserParams->numCurrentSensors);
+  HAL_setNumVoltageSensors(handle,pUserParams->numVoltageSensors);
+
+
+  for(cnt=0;cnt<HAL_getNumCurrentSensors(handle);cnt++)
+    {
+      HAL_setOffsetBeta_lp_pu(handle,HAL_SensorType_Current,cnt,beta_lp_pu);
+      HAL_setOffsetInitCond(handle,HAL_SensorType_Current,cnt,_IQ(0.0));
+      HAL_setOffsetValue(handle,HAL_SensorType_Current,cnt,_IQ(0.0));
+    }
+
+
+  for(cnt=0;cnt<HAL_getNumVoltageSensors(handle);cnt++)
+    {
+      HAL_setOffsetBeta_lp_pu(handle,HAL_SensorType_Voltage,cnt,beta_lp_pu);
+      HAL_setOffsetInitCond(handle,HAL_SensorType_Voltage,cnt,_IQ(0.0));
+      HAL_setOffsetValue(handle,HAL_SensorType_Voltage,cnt,_IQ(0.0));
+    }
+
+
+  // disable global interrupts
+  CPU_disableGlobalInts(obj->cpuHandle);
+
+
+  // disable cpu interrupts
+  CPU_disableInts(obj->cpuHandle);
+
+
+  // clear cpu interrupt flags
+  CPU_clearIntFlags(obj->cpuHandle);
+
+
+  // setup the ECAP
+  HAL_setupeCAP(handle);
+
+
+  // setup the PWMs
+  HAL_setupPwms(handle,
+                pUserParams->systemFreq_MHz,
+                pUserParams->pwmPeriod_usec,
+                USER_NUM_PWM_TICKS_PER_ISR_TICK);
+
+
+  // setup the sciA
+  HAL_setupSciA(handle);
+
+
+  // setup the timers
+  HAL_setupTimers(handle,
+                  pUserParams->systemFreq_MHz);
+
+
+  // set the default current bias
+ {
+   uint_least8_t cnt;
+   _iq bias = _IQ12mpy(ADC_dataBias,_IQ(pUserParams->current_sf));
+
+   for(cnt=0;cnt<HAL_getNumCurrentSensors(handle);cnt++)
+     {
+       HAL_setBias(handle,HAL_SensorType_Current,cnt,bias);
+     }
+ }
+
+
+  //  set the current scale factor
+ {
+   _iq current_sf = _IQ(pUserParams->current_sf);
+
+  HAL_setCurrentScaleFactor(handle,current_sf);
+ }
+
+
+  // set the default voltage bias
+ {
+   uint_least8_t cnt;
+   _iq bias = _IQ(0.0);
+
+   for(cnt=0;cnt<HAL_getNumVoltageSensors(handle);cnt++)
+     {
+       HAL_setBias(handle,HAL_SensorType_Voltage,cnt,bias);
+     }
+ }
+
+
+  //  set the voltage scale factor
+ {
+   _iq voltage_sf = _IQ(pUserParams->voltage_sf);
+
+  HAL_setVoltageScaleFactor(handle,voltage_sf);
+ }
+
+ return;
+} // end of HAL_setParams() function
+
+
+void HAL_setupPwms(HAL_Handle handle,
+                   const uint_least16_t systemFreq_MHz,
+                   const float_t pwmPeriod_usec,
+                   const uint_least16_t numPwmTicksPerIsrTick)
+{
+  HAL_Obj   *obj = (HAL_Obj *)handle;
+  uint16_t   halfPeriod_cycles = (uint16_t)((float_t)systemFreq_MHz*pwmPeriod_usec) >> 1;
+  uint_least8_t    cnt;
+
+
+  // turns off the outputs of the EPWM peripherals which will put the power switches
+  // into a high impedance state.
+  PWM_setOneShotTrip(obj->pwmHandle[PWM_Number_1]);
+  PWM_setOneShotTrip(obj->pwmHandle[PWM_Number_2]);
+  PWM_setOneShotTrip(obj->pwmHandle[PWM_Number_3]);
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      // setup the Time-Base Control Register (TBCTL)
+      PWM_setCounterMode(obj->pwmHandle[cnt],PWM_CounterMode_UpDown);
+
+      // setup the Time-Base Counter Register (TBCTR)
+      PWM_setCount(obj->pwmHandle[cnt],0);
+
+      // setup the Counter-Compare Control Register (CMPCTL)
+      PWM_setLoadMode_CmpA(obj->pwmHandle[cnt],PWM_LoadMode_Zero);
+      PWM_setShadowMode_CmpA(obj->pwmHandle[cnt],PWM_ShadowMode_Shadow);
+
+      // setup the Action-Qualifier Output A Register (AQCTLA)
+      PWM_setActionQual_CntUp_CmpA_PwmA(obj->pwmHandle[cnt],PWM_ActionQual_Set);
+      PWM_setActionQual_CntDown_CmpA_PwmA(obj->pwmHandle[cnt],PWM_ActionQual_Clear);
+
+      // setup the Dead-Band Rising Edge Delay Register (DBRED)
+      PWM_setDeadBandRisingEdgeDelay(obj->pwmHandle[cnt],HAL_PWM_DBRED_CNT);
+
+      // setup the Dead-Band Falling Edge Delay Register (DBFED)
+      PWM_setDeadBandFallingEdgeDelay(obj->pwmHandle[cnt],HAL_PWM_DBFED_CNT);
+
+      // since the PWM is configured as an up/down counter, the period register is set to one-half
+      // of the desired PWM period
+      PWM_setPeriod(obj->pwmHandle[cnt],halfPeriod_cycles);
+
+      // start with a 50% duty cycle
+      PWM_setCmpA(obj->pwmHandle[cnt],halfPeriod_cycles >> 1);
+    }
+
+  // the simulation triggers the ADC at counter zero every numPwmTicksPerIsrTick periods
+  (void)numPwmTicksPerIsrTick;
+
+  return;
+}  // end of HAL_setupPwms() function
+
+
+void HAL_setupSciA(HAL_Handle handle)
+{
+  HAL_Obj   *obj = (HAL_Obj *)handle;
+
+  // the simulation only uses the baud rate
+  SCI_reset(obj->sciAHandle);
+  SCI_setCharLength(obj->sciAHandle,SCI_CharLength_8_Bits);
+  SCI_setBaudRate(obj->sciAHandle,HAL_SCIA_BAUD_RATE);
+  SCI_enableTx(obj->sciAHandle);
+  SCI_enable(obj->sciAHandle);
+
+  return;
+}  // end of HAL_setupSciA() function
+
+
+void HAL_setupTimers(HAL_Handle handle,const uint_least16_t systemFreq_MHz)
+{
+  HAL_Obj  *obj = (HAL_Obj *)handle;
+  uint32_t  timerPeriod_cnts = ((uint32_t)systemFreq_MHz * 1000000) - 1;
+  uint_least8_t cnt;
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      TIMER_setDecimationFactor(obj->timerHandle[cnt],0);
+      TIMER_setPeriod(obj->timerHandle[cnt],timerPeriod_cnts);
+      TIMER_setPreScaler(obj->timerHandle[cnt],0);
+
+      gTimer[cnt].TIM = timerPeriod_cnts;
+    }
+
+  return;
+}  // end of HAL_setupTimers() function
+
+
+void HAL_writeDrvData(HAL_Handle handle, DRV_SPI_8305_Vars_t *Spi_8305_Vars)
+{
+
+  // the simulated gate driver has no registers
+  (void)handle;
+  (void)Spi_8305_Vars;
+
+  return;
+}  // end of HAL_writeDrvData() function
+
+
+void HAL_readDrvData(HAL_Handle handle, DRV_SPI_8305_Vars_t *Spi_8305_Vars)
+{
+  (void)handle;
+
+  // the simulated gate driver reports the injected fault as a VDS overcurrent
+  if(Spi_8305_Vars->ReadCmd)
+    {
+      Spi_8305_Vars->Stat_Reg_01.VDS_STATUS = halSim.flag_drvFault;
+      Spi_8305_Vars->Stat_Reg_01.FAULT = halSim.flag_drvFault;
+      Spi_8305_Vars->ReadCmd = false;
+    }
+
+  // the background loop yields to the simulation once per pass
+  HAL_SIM_runTick(&halSim);
+
+  if(halSim.flag_stop)
+    {
+      longjmp(halSim.stopEnv,1);
+    }
+
+  return;
+}  // end of HAL_readDrvData() function
+
+
+void HAL_SIM_idle(HAL_Handle handle)
+{
+  (void)handle;
+
+  // the interrupt that ends the idle is the next ISR tick
+  HAL_SIM_runTick(&halSim);
+
+  if(halSim.flag_stop)
+    {
+      longjmp(halSim.stopEnv,1);
+    }
+
+  return;
+} // end of HAL_SIM_idle() function
+
+
+void HAL_setupDrvSpi(HAL_Handle handle, DRV_SPI_8305_Vars_t *Spi_8305_Vars)
+{
+
+  // the simulated gate driver has no registers
+  (void)handle;
+  (void)Spi_8305_Vars;
+
+  return;
+}  // end of HAL_setupDrvSpi() function
+
+
+// ECAP
+void HAL_setupeCAP(HAL_Handle handle)
+{
+    HAL_Obj *obj = (HAL_Obj *) handle;
+
+    CAP_setModeCap(obj->capHandle); // set mode to CAP
+
+#if defined(DSHOT_ENABLE) && defined(DSHOT_BIDIR_ENABLE)
+    // bidirectional DShot idles high, a pulse starts with the falling edge
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_1, CAP_Polarity_Falling);
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_2, CAP_Polarity_Rising);
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_3, CAP_Polarity_Falling);
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_4, CAP_Polarity_Rising);
+
+    CAP_setStopWrap(obj->capHandle, CAP_Stop_Wrap_CEVT4);
+
+    CAP_enableInt(obj->capHandle, CAP_Int_Type_CEVT2);
+    CAP_enableInt(obj->capHandle, CAP_Int_Type_CEVT4);
+#elif defined(DSHOT_ENABLE)
+    // DShot, one pulse per interrupt with absolute time stamps
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_1, CAP_Polarity_Rising);
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_2, CAP_Polarity_Falling);
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_3, CAP_Polarity_Rising);
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_4, CAP_Polarity_Falling);
+
+    CAP_setStopWrap(obj->capHandle, CAP_Stop_Wrap_CEVT4);
+
+    CAP_enableInt(obj->capHandle, CAP_Int_Type_CEVT2);
+    CAP_enableInt(obj->capHandle, CAP_Int_Type_CEVT4);
+#else
+    //Sets the capture event polarity
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_1, CAP_Polarity_Rising);
+
+    //Sets the capture event polarity
+    CAP_setCapEvtPolarity(obj->capHandle, CAP_Event_2, CAP_Polarity_Falling);
+
+    //Sets the capture event counter reset configuration (reset counting here)
+    CAP_setCapEvtReset(obj->capHandle, CAP_Event_2, CAP_Reset_Enable);
+
+    //Enables capture (CAP) interrupt source
+    CAP_enableInt(obj->capHandle, CAP_Int_Type_CEVT2);
+#endif
+
+    // enable eCAP interrupt
+    PIE_enableInt(obj->pieHandle, PIE_GroupNumber_4, PIE_InterruptSource_ECAP1);
+
+    // enable CPU ECAP Group interrupts
+    CPU_enableInt(obj->cpuHandle, CPU_IntNumber_4);
+
+    return;
+} // end of HAL_setupCAP() function
+
+
+void HAL_SIM_getTruth(void *pArg,_iq *pAngle_pu,_iq *pFm_pu)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)pArg;
+  double angle_pu = PMSM_SIM_getAngle_rad(obj->plantHandle) / MATH_TWO_PI;
+  double fm_pu = PMSM_SIM_getFe_Hz(obj->plantHandle) / USER_IQ_FULL_SCALE_FREQ_Hz;
+
+  // the estimator angle is in the range -0.5 to 0.5 pu
+  if(angle_pu >= 0.5)
+    {
+      angle_pu -= 1.0;
+    }
+
+  *pAngle_pu = _IQ(angle_pu);
+  *pFm_pu = _IQ(fm_pu);
+
+  return;
+} // end of HAL_SIM_getTruth() function
+
+
+HAL_SIM_Handle HAL_SIM_init(void *pMemory,const size_t numBytes)
+{
+  HAL_SIM_Handle handle;
+  HAL_SIM_Obj *obj;
+  uint_least32_t cnt;
+
+
+  if(numBytes < sizeof(HAL_SIM_Obj))
+    return((HAL_SIM_Handle)NULL);
+
+
+  // assign the handle
+  handle = (HAL_SIM_Handle)pMemory;
+
+
+  // assign the object
+  obj = (HAL_SIM_Obj *)handle;
+
+  memset(obj,0,sizeof(HAL_SIM_Obj));
+
+  obj->plantHandle = PMSM_SIM_init(&obj->plant,sizeof(obj->plant));
+
+  obj->voltageFilterPole_rps = USER_VOLTAGE_FILTER_POLE_rps;
+  obj->rcRise_sec = HAL_SIM_RC_PERIOD_sec;
+  obj->dshotBitRate_bps = HAL_SIM_DSHOT_BIT_RATE_bps;
+  obj->dshotFramePeriod_sec = 1.0 / HAL_SIM_DSHOT_FRAME_RATE_Hz;
+  obj->dshotEdge = 32;
+  obj->isrBusy_sec = HAL_SIM_ISR_BUSY_sec;
+  obj->flag_isrNesting = true;
+  obj->flag_tripped = true;
+  obj->sciFd = -1;
+  obj->drvFault_sec = -1.0;
+  obj->batDisconnect_sec = -1.0;
+
+  for(cnt=0;cnt<HAL_SIM_FLASH_LOG_NUM_WORDS;cnt++)
+    {
+      obj->flashLog[cnt] = 0xFFFF;
+    }
+
+  return(handle);
+} // end of HAL_SIM_init() function
+
+
+//! \brief     Sends the SCIA transmit FIFO up to the present time
+//! \details   One start, eight data and one stop bit per byte at the baud
+//!            rate set in the SCI registers, the low speed clock is a
+//!            quarter of the system clock
+//! \param[in] obj  The host simulation object
+static void HAL_SIM_runSci(HAL_SIM_Obj *obj)
+{
+  uint16_t brr = ((gSciA.SCIHBAUD & 0xFF) << 8) | (gSciA.SCILBAUD & 0xFF);
+  double byte_sec = 10.0 * 8.0 * (double)(brr + 1) / (HAL_SIM_CPU_FREQ_Hz * 0.25);
+  unsigned char buf[HAL_SIM_SCI_FIFO_DEPTH];
+  uint_least8_t numBytes = 0;
+
+  while((obj->sciFifoLevel > 0) && (obj->time_sec >= obj->sciByteDone_sec))
+    {
+      uint_least8_t cnt;
+
+      buf[numBytes++] = (unsigned char)(obj->sciFifo[0] & 0xFF);
+
+      for(cnt=1;cnt<obj->sciFifoLevel;cnt++)
+        {
+          obj->sciFifo[cnt - 1] = obj->sciFifo[cnt];
+        }
+
+      obj->sciFifoLevel--;
+      obj->sciByteDone_sec += byte_sec;
+    }
+
+  if(numBytes > 0)
+    {
+      ssize_t numWritten = 0;
+
+      obj->sciNumBytes += numBytes;
+
+      if(obj->sciFd >= 0)
+        {
+          numWritten = write(obj->sciFd,buf,numBytes);
+
+          if(numWritten < 0)
+            {
+              numWritten = 0;
+            }
+        }
+
+      obj->sciNumDropped += numBytes - (uint_least8_t)numWritten;
+    }
+
+  // an empty FIFO starts the next byte when it is written
+  if((obj->sciFifoLevel == 0) && (obj->sciByteDone_sec < obj->time_sec + byte_sec))
+    {
+      obj->sciByteDone_sec = obj->time_sec + byte_sec;
+    }
+
+  return;
+} // end of HAL_SIM_runSci() function
+
+
+uint_least16_t HAL_SIM_writeSciTxFifo(HAL_Handle handle,const uint16_t *pData,const uint_least16_t numBytes)
+{
+  HAL_SIM_Obj *obj = &halSim;
+  uint_least16_t cnt = 0;
+
+  (void)handle;
+
+  HAL_SIM_runSci(obj);
+
+  while((cnt < numBytes) && (obj->sciFifoLevel < HAL_SIM_SCI_FIFO_DEPTH))
+    {
+      obj->sciFifo[obj->sciFifoLevel++] = pData[cnt++];
+    }
+
+  return(cnt);
+} // end of HAL_SIM_writeSciTxFifo() function
+
+
+uint32_t HAL_SIM_readCapCnt(HAL_Handle handle)
+{
+  (void)handle;
+
+  return((uint32_t)(uint64_t)(halSim.capCnt_sec * HAL_SIM_CPU_FREQ_Hz + 0.5));
+} // end of HAL_SIM_readCapCnt() function
+
+
+void HAL_SIM_enableIsrNesting(HAL_Handle handle,const CPU_IntNumber_e intNumber)
+{
+  (void)handle;
+
+  halSim.isrNestMask = intNumber;
+
+  return;
+} // end of HAL_SIM_enableIsrNesting() function
+
+
+bool HAL_startDshotReply(HAL_Handle handle,const uint32_t startCnt,
+                         const uint32_t period_cnts,const uint32_t low_cnts)
+{
+  HAL_Obj *halObj = (HAL_Obj *)handle;
+  HAL_SIM_Obj *obj = &halSim;
+  uint32_t nowCnt = HAL_SIM_readCapCnt(handle);
+
+  // the reply is late when the start time stamp is not ahead of the counter
+  if((int32_t)(nowCnt - startCnt) >= 0)
+    {
+      obj->dshotNumRepliesLate++;
+      return(false);
+    }
+
+  CAP_disableCaptureLoad(halObj->capHandle);
+  CAP_disableInt(halObj->capHandle,CAP_Int_Type_CEVT2);
+  CAP_disableInt(halObj->capHandle,CAP_Int_Type_CEVT4);
+
+  CAP_setApwmPeriod(halObj->capHandle,startCnt - 1);
+  CAP_setApwmCompare(halObj->capHandle,0);
+
+  CAP_setApwmPolarity(halObj->capHandle,CAP_ApwmPolarity_Low);
+  CAP_setModeApwm(halObj->capHandle);
+
+  HAL_writeDshotReplyPeriod(handle,period_cnts,low_cnts);
+
+  CAP_clearInt(halObj->capHandle,CAP_Int_Type_All);
+  CAP_enableInt(halObj->capHandle,CAP_Int_Type_CTR_PRD);
+
+  // the line is high up to the first boundary
+  obj->replyStart_sec = obj->capCnt_sec + (double)(startCnt - nowCnt) / HAL_SIM_CPU_FREQ_Hz;
+  obj->replyBoundary_sec = obj->replyStart_sec;
+  obj->replyBits = 0;
+
+  return(true);
+} // end of HAL_startDshotReply() function
+
+
+void HAL_writeDshotReplyPeriod(HAL_Handle handle,const uint32_t period_cnts,const uint32_t low_cnts)
+{
+  HAL_Obj *halObj = (HAL_Obj *)handle;
+
+  CAP_setApwmShadowPeriod(halObj->capHandle,period_cnts - 1);
+  CAP_setApwmShadowCompare(halObj->capHandle,low_cnts);
+
+  halSim.flag_replyShadow = true;
+
+  return;
+} // end of HAL_writeDshotReplyPeriod() function
+
+
+void HAL_stopDshotReply(HAL_Handle handle,const uint32_t endCnt)
+{
+  HAL_Obj *halObj = (HAL_Obj *)handle;
+  HAL_SIM_Obj *obj = &halSim;
+
+  // the simulated counter is not restarted by the APWM
+  (void)endCnt;
+
+  CAP_setModeCap(halObj->capHandle);
+
+  CAP_disableInt(halObj->capHandle,CAP_Int_Type_CTR_PRD);
+  CAP_clearInt(halObj->capHandle,CAP_Int_Type_All);
+
+  // the rearm starts the next frame with CEVT1
+  CAP_rearm(halObj->capHandle);
+  obj->capEvent = 0;
+  CAP_enableCaptureLoad(halObj->capHandle);
+  CAP_enableInt(halObj->capHandle,CAP_Int_Type_CEVT2);
+  CAP_enableInt(halObj->capHandle,CAP_Int_Type_CEVT4);
+
+  obj->dshotReply = obj->replyBits;
+  obj->dshotNumReplies++;
+
+  return;
+} // end of HAL_stopDshotReply() function
+
+
+uint32_t HAL_SIM_readTimerCnt(HAL_Handle handle,const uint_least8_t timerNumber)
+{
+  HAL_Obj *obj = (HAL_Obj *)handle;
+  TIMER_Obj *timer = (TIMER_Obj *)obj->timerHandle[timerNumber];
+  uint32_t cnt = timer->TIM;
+
+  // while the ISR runs, count the host time down from the count at the
+  // first read, on the target that read follows the interrupt at a fixed
+  // latency, on the host a preemption before it would look like ISR jitter
+  if(halSim.flag_inIsr && !halSim.flag_isrTimed)
+    {
+      clock_gettime(CLOCK_MONOTONIC,&halSim.isrStart);
+      halSim.flag_isrTimed = true;
+    }
+  else if(halSim.flag_inIsr)
+    {
+      struct timespec now;
+      uint64_t period = (uint64_t)timer->PRD + 1;
+      double elapsed_ns;
+      uint64_t elapsed_cnts;
+
+      clock_gettime(CLOCK_MONOTONIC,&now);
+
+      elapsed_ns = (double)(now.tv_sec - halSim.isrStart.tv_sec) * 1.0e9
+                   + (double)(now.tv_nsec - halSim.isrStart.tv_nsec);
+      elapsed_cnts = (uint64_t)(elapsed_ns * HAL_SIM_CPU_FREQ_Hz * 1.0e-9) % period;
+
+      cnt = (uint32_t)(((uint64_t)cnt + period - elapsed_cnts) % period);
+    }
+
+  return(cnt);
+} // end of HAL_SIM_readTimerCnt() function
+
+
+uint16_t *HAL_SIM_getFlashLogAddr(HAL_Handle handle)
+{
+  (void)handle;
+
+  return(halSim.flashLog);
+} // end of HAL_SIM_getFlashLogAddr() function
+
+
+bool HAL_eraseFlashSector(HAL_Handle handle,uint16_t *pSector)
+{
+  HAL_SIM_Obj *obj = &halSim;
+  uint_least32_t offset = (uint_least32_t)(pSector - obj->flashLog);
+  uint_least32_t cnt;
+
+  (void)handle;
+
+  if((pSector < obj->flashLog) || (offset >= HAL_SIM_FLASH_LOG_NUM_WORDS) ||
+     ((offset % HAL_FLASH_LOG_SECTOR_WORDS) != 0))
+    {
+      return(false);
+    }
+
+  // the erase takes a sector time in the order of a second, the projects
+  // only erase before the interrupts are enabled, so no time is simulated
+  for(cnt=0;cnt<HAL_FLASH_LOG_SECTOR_WORDS;cnt++)
+    {
+      pSector[cnt] = 0xFFFF;
+    }
+
+  obj->flashNumErases++;
+
+  return(true);
+} // end of HAL_eraseFlashSector() function
+
+
+bool HAL_programFlash(HAL_Handle handle,uint16_t *pDst,const uint16_t *pSrc,const uint_least16_t numWords)
+{
+  HAL_SIM_Obj *obj = &halSim;
+  uint_least32_t offset = (uint_least32_t)(pDst - obj->flashLog);
+  bool flag_ok = true;
+  uint_least16_t cnt;
+
+  (void)handle;
+
+  if((pDst < obj->flashLog) || ((offset + numWords) > HAL_SIM_FLASH_LOG_NUM_WORDS))
+    {
+      return(false);
+    }
+
+  // programming only clears bits, the verify catches words that were not erased
+  for(cnt=0;cnt<numWords;cnt++)
+    {
+      pDst[cnt] &= pSrc[cnt];
+
+      if(pDst[cnt] != pSrc[cnt])
+        {
+          flag_ok = false;
+        }
+    }
+
+  // the interrupts are disabled while the flash is programmed, the ISR
+  // ticks that fall into the programming time are lost
+  obj->flashBusy_sec += (double)numWords * HAL_SIM_FLASH_PROGRAM_sec;
+  obj->flag_isrHeld = true;
+
+  while(obj->flashBusy_sec > 0.0)
+    {
+      HAL_SIM_runTick(obj);
+
+      obj->flashBusy_sec -= 1.0 / USER_ISR_FREQ_Hz;
+    }
+
+  obj->flag_isrHeld = false;
+
+  return(flag_ok);
+} // end of HAL_programFlash() function
+
+
+void HAL_SIM_run(HAL_SIM_Handle handle,void (*mainFcn)(void))
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  if(setjmp(obj->stopEnv) == 0)
+    {
+      mainFcn();
+    }
+
+  return;
+} // end of HAL_SIM_run() function
+
+
+//! \brief     Samples the plant into the ADC result registers
+//! \param[in] obj  The host simulation object
+static void HAL_SIM_sampleAdc(HAL_SIM_Obj *obj)
+{
+  static const double I_offset[3] = {I_A_offset,I_B_offset,I_C_offset};
+  ADC_Obj *adc = &gAdc;
+  double Iabc_A[3];
+  double count;
+  uint_least8_t cnt;
+
+  PMSM_SIM_getIabc_A(obj->plantHandle,Iabc_A);
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      // the current sense amplifiers are biased to the offsets of user.h
+      count = (Iabc_A[cnt] / USER_IQ_FULL_SCALE_CURRENT_A + I_offset[cnt]) * 4096.0 / USER_CURRENT_SF;
+      count = (count < 0.0) ? 0.0 : ((count > 4095.0) ? 4095.0 : count);
+      adc->ADCRESULT[ADC_ResultNumber_1 + cnt] = (uint16_t)(count + 0.5);
+
+      count = obj->Vsense_V[cnt] * 4096.0 / USER_ADC_FULL_SCALE_VOLTAGE_V;
+      count = (count < 0.0) ? 0.0 : ((count > 4095.0) ? 4095.0 : count);
+      adc->ADCRESULT[ADC_ResultNumber_4 + cnt] = (uint16_t)(count + 0.5);
+    }
+
+  count = obj->VdcSense_V * 4096.0 / USER_ADC_FULL_SCALE_VOLTAGE_V;
+  count = (count < 0.0) ? 0.0 : ((count > 4095.0) ? 4095.0 : count);
+  adc->ADCRESULT[ADC_ResultNumber_7] = (uint16_t)(count + 0.5);
+
+  return;
+} // end of HAL_SIM_sampleAdc() function
+
+
+//! \brief     Runs the DC bus capacitance over part of a PWM period
+//! \details   The battery charges the capacitance through its resistance,
+//!            solved exactly so that a small time constant stays stable
+//! \param[in] obj        The host simulation object
+//! \param[in] Idc_A      The current the bridge draws from the bus, negative while braking, A
+//! \param[in] delta_sec  The duration of the segment, sec
+static void HAL_SIM_runBus(HAL_SIM_Obj *obj,const double Idc_A,const double delta_sec)
+{
+  if(obj->Cbus_F > 0.0)
+    {
+      bool flag_batConnected = (obj->batDisconnect_sec < 0.0) || (obj->time_sec < obj->batDisconnect_sec);
+
+      if(flag_batConnected && (obj->Rbat_ohm > 0.0))
+        {
+          double Vss_V = obj->Vbat_V - Idc_A * obj->Rbat_ohm;
+
+          obj->Vdc_V = Vss_V + (obj->Vdc_V - Vss_V) * exp(-delta_sec / (obj->Rbat_ohm * obj->Cbus_F));
+        }
+      else if(flag_batConnected)
+        {
+          obj->Vdc_V = obj->Vbat_V;
+        }
+      else
+        {
+          obj->Vdc_V -= Idc_A * delta_sec / obj->Cbus_F;
+        }
+
+      obj->Vdc_V = fmax(obj->Vdc_V,0.0);
+    }
+
+  obj->VdcPeak_V = fmax(obj->VdcPeak_V,obj->Vdc_V);
+
+  return;
+} // end of HAL_SIM_runBus() function
+
+
+//! \brief     Runs the plant over part of a PWM period with constant switch states
+//! \param[in] obj        The host simulation object
+//! \param[in] flag_high  The upper switch state of each phase
+//! \param[in] flag_dead  The dead time state of each phase, both switches off
+//! \param[in] delta_sec  The duration of the segment, sec
+static void HAL_SIM_runSegment(HAL_SIM_Obj *obj,const bool *flag_high,const bool *flag_dead,const double delta_sec)
+{
+  double Vabc_V[3];
+  double Iabc_A[3];
+  double Iabc_end_A[3];
+  bool flag_upper[3];
+  double Idc_A = 0.0;
+  double alpha;
+  uint_least8_t cnt;
+
+  if(delta_sec <= 0.0)
+    {
+      return;
+    }
+
+  if(obj->flag_tripped)
+    {
+      PMSM_SIM_runHighZ(obj->plantHandle,obj->Vdc_V,delta_sec);
+      PMSM_SIM_getVabc_V(obj->plantHandle,Vabc_V);
+      PMSM_SIM_getIabc_A(obj->plantHandle,Iabc_A);
+
+      // a phase above the bus conducts through its upper diode
+      for(cnt=0;cnt<3;cnt++)
+        {
+          if(Vabc_V[cnt] > obj->Vdc_V)
+            {
+              Idc_A += Iabc_A[cnt];
+            }
+        }
+    }
+  else
+    {
+      PMSM_SIM_getIabc_A(obj->plantHandle,Iabc_A);
+
+      for(cnt=0;cnt<3;cnt++)
+        {
+          double sign = (Iabc_A[cnt] >= 0.0) ? 1.0 : -1.0;
+
+          if(flag_dead[cnt])
+            {
+              // a positive current flows out of the phase through the lower diode
+              Vabc_V[cnt] = (sign > 0.0) ? -obj->plant.params.Vdiode_V : (obj->Vdc_V + obj->plant.params.Vdiode_V);
+            }
+          else
+            {
+              Vabc_V[cnt] = (flag_high[cnt] ? obj->Vdc_V : 0.0) - (sign * obj->Vdrop_V);
+            }
+
+          flag_upper[cnt] = flag_dead[cnt] ? (sign < 0.0) : flag_high[cnt];
+        }
+
+      PMSM_SIM_run(obj->plantHandle,Vabc_V,delta_sec);
+      PMSM_SIM_getIabc_A(obj->plantHandle,Iabc_end_A);
+
+      // the bus supplies the phases connected to the upper rail, the
+      // current ramps over the segment so its mean is taken
+      for(cnt=0;cnt<3;cnt++)
+        {
+          if(flag_upper[cnt])
+            {
+              Idc_A += 0.5 * (Iabc_A[cnt] + Iabc_end_A[cnt]);
+            }
+        }
+    }
+
+  HAL_SIM_runBus(obj,Idc_A,delta_sec);
+
+  // the voltage feedback is a first order filter of the terminal voltages
+  alpha = 1.0 - exp(-obj->voltageFilterPole_rps * delta_sec);
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      obj->Vsense_V[cnt] += alpha * (Vabc_V[cnt] - obj->Vsense_V[cnt]);
+    }
+
+  obj->VdcSense_V += alpha * (obj->Vdc_V - obj->VdcSense_V);
+
+  return;
+} // end of HAL_SIM_runSegment() function
+
+
+//! \brief     Runs the plant over one PWM period
+//! \details   The counter counts up from zero to TBPRD and back.  A phase is
+//!            high while the counter is above its compare value, after each
+//!            edge both switches are off for the dead time.
+//! \param[in] obj  The host simulation object
+static void HAL_SIM_runPwmPeriod(HAL_SIM_Obj *obj)
+{
+  uint16_t period = gPwm[0].TBPRD;
+  double tick_sec = 1.0 / HAL_SIM_CPU_FREQ_Hz;
+  double periodEnd_sec = (double)(2 * period) * tick_sec;
+  double edge_sec[12];
+  double rise_sec[3],fall_sec[3];
+  bool flag_switching[3];
+  bool flag_high[3],flag_dead[3];
+  double t_sec = 0.0;
+  double Iabc_A[3];
+  uint_least8_t cnt,cnt2;
+
+  PMSM_SIM_getIabc_A(obj->plantHandle,Iabc_A);
+
+  // sort the switching instants and the dead time ends of the period
+  for(cnt=0;cnt<3;cnt++)
+    {
+      uint16_t cmpA = (obj->cmpA[cnt] > period) ? period : obj->cmpA[cnt];
+
+      rise_sec[cnt] = (double)cmpA * tick_sec;
+      fall_sec[cnt] = (double)(2 * period - cmpA) * tick_sec;
+      flag_switching[cnt] = (cmpA > 0) && (cmpA < period);
+
+      edge_sec[cnt] = rise_sec[cnt];
+      edge_sec[cnt + 3] = fall_sec[cnt];
+      edge_sec[cnt + 6] = flag_switching[cnt] ? (rise_sec[cnt] + obj->deadTime_sec) : rise_sec[cnt];
+      edge_sec[cnt + 9] = flag_switching[cnt] ? (fall_sec[cnt] + obj->deadTime_sec) : fall_sec[cnt];
+
+      if(edge_sec[cnt + 9] > periodEnd_sec)
+        {
+          edge_sec[cnt + 9] = periodEnd_sec;
+        }
+
+      if(flag_switching[cnt] && !obj->flag_tripped)
+        {
+          obj->numSwitchingLegs++;
+          obj->switchedCurrent_A += fabs(Iabc_A[cnt]);
+        }
+    }
+
+  for(cnt=1;cnt<12;cnt++)
+    {
+      double value = edge_sec[cnt];
+
+      for(cnt2=cnt;(cnt2 > 0) && (edge_sec[cnt2 - 1] > value);cnt2--)
+        {
+          edge_sec[cnt2] = edge_sec[cnt2 - 1];
+        }
+
+      edge_sec[cnt2] = value;
+    }
+
+  for(cnt=0;cnt<=12;cnt++)
+    {
+      double end_sec = (cnt < 12) ? edge_sec[cnt] : periodEnd_sec;
+      double mid_sec = 0.5 * (t_sec + end_sec);
+
+      for(cnt2=0;cnt2<3;cnt2++)
+        {
+          flag_high[cnt2] = (mid_sec > rise_sec[cnt2]) && (mid_sec < fall_sec[cnt2]);
+          flag_dead[cnt2] = flag_switching[cnt2]
+                            && (((mid_sec > rise_sec[cnt2]) && (mid_sec < (rise_sec[cnt2] + obj->deadTime_sec)))
+                                || ((mid_sec > fall_sec[cnt2]) && (mid_sec < (fall_sec[cnt2] + obj->deadTime_sec))));
+        }
+
+      HAL_SIM_runSegment(obj,flag_high,flag_dead,end_sec - t_sec);
+
+      t_sec = end_sec;
+    }
+
+  obj->time_sec += t_sec;
+  obj->numPwmTicks++;
+
+  return;
+} // end of HAL_SIM_runPwmPeriod() function
+
+
+//! \brief     Gets the DShot value of the RC pulse width
+//! \details   1000 to 2000 usec map to the throttle 48 to 2047, the motor
+//!            stop frames are sent for the first HAL_SIM_DSHOT_ARM_sec
+//! \param[in] obj  The host simulation object
+//! \return    The 11-bit DShot value
+static uint16_t HAL_SIM_getDshotValue(HAL_SIM_Obj *obj)
+{
+  double throttle = (obj->rcPulse_usec - 1000.0) * (1.0 / 1000.0);
+
+  if((obj->dshotSignal_sec < HAL_SIM_DSHOT_ARM_sec) || (throttle < 0.01))
+    {
+      return(0);
+    }
+
+  if(throttle > 1.0)
+    {
+      throttle = 1.0;
+    }
+
+  return((uint16_t)(48.0 + (throttle * (2047.0 - 48.0)) + 0.5));
+} // end of HAL_SIM_getDshotValue() function
+
+
+//! \brief     Runs the pending eCAP interrupt up to a time
+//! \details   The interrupt waits for the previous one to return and for
+//!            mainISR() up to the point it lets the eCAP interrupt preempt
+//! \param[in] obj       The host simulation object
+//! \param[in] until_sec The time, sec
+static void HAL_SIM_runCapIsr(HAL_SIM_Obj *obj,const double until_sec)
+{
+  CAP_Obj *cap = &gCap;
+
+  while((cap->ECEFLG & cap->ECEINT) && (IER & CPU_IntNumber_4) && (gPie.ECAP1_INT != NULL))
+    {
+      double entry_sec = obj->capPending_sec;
+
+      if(entry_sec < obj->capIsrEnd_sec)
+        {
+          entry_sec = obj->capIsrEnd_sec;
+        }
+
+      if((entry_sec >= obj->isrBlockStart_sec) && (entry_sec < obj->isrBlockEnd_sec))
+        {
+          entry_sec = obj->isrBlockEnd_sec;
+        }
+
+      if(entry_sec >= until_sec)
+        {
+          break;
+        }
+
+      if((entry_sec - obj->capPending_sec) > obj->capMaxLatency_sec)
+        {
+          obj->capMaxLatency_sec = entry_sec - obj->capPending_sec;
+        }
+
+      obj->capCnt_sec = entry_sec;
+      obj->capIsrEnd_sec = entry_sec + HAL_SIM_ECAP_ISR_sec;
+      obj->capNumIsrs++;
+
+      gPie.ECAP1_INT();
+
+      cap->ECEFLG &= ~cap->ECECLR;
+      cap->ECECLR = 0;
+
+      // the flags left set request the interrupt again
+      obj->capPending_sec = entry_sec;
+    }
+
+  return;
+} // end of HAL_SIM_runCapIsr() function
+
+
+//! \brief     Runs a period boundary of the APWM that sends the DShot reply
+//! \details   The shadow period and compare values become active and the
+//!            CTR=PRD interrupt is requested.  The edges of the period are
+//!            recorded as the transitions of the reply.
+//! \param[in] obj  The host simulation object
+static void HAL_SIM_runReplyBoundary(HAL_SIM_Obj *obj)
+{
+  CAP_Obj *cap = &gCap;
+  double bitPeriod_sec = 0.8 / obj->dshotBitRate_bps;
+  double boundary_sec = obj->replyBoundary_sec;
+  double period_sec = (double)(cap->CAP3 + 1) / HAL_SIM_CPU_FREQ_Hz;
+  double low_sec = (double)cap->CAP4 / HAL_SIM_CPU_FREQ_Hz;
+
+  // without a new period the eCAP sends the last one again
+  if(!obj->flag_replyShadow && (cap->CAP4 > 0))
+    {
+      obj->dshotNumReplyUnderruns++;
+    }
+
+  obj->flag_replyShadow = false;
+
+  if(cap->CAP4 > 0)
+    {
+      double edge_sec[2] = {boundary_sec,boundary_sec + low_sec};
+      uint_least8_t cnt;
+
+      for(cnt=0;cnt<2;cnt++)
+        {
+          long bitNumber = lround((edge_sec[cnt] - obj->replyStart_sec) / bitPeriod_sec);
+
+          if((bitNumber >= 0) && (bitNumber < HAL_SIM_DSHOT_REPLY_NUM_BITS))
+            {
+              obj->replyBits |= (uint32_t)1 << (HAL_SIM_DSHOT_REPLY_NUM_BITS - 1 - bitNumber);
+            }
+        }
+    }
+
+  if(!(cap->ECEFLG & cap->ECEINT))
+    {
+      obj->capPending_sec = boundary_sec;
+    }
+
+  cap->ECEFLG |= CAP_Int_Type_CTR_PRD;
+  obj->replyBoundary_sec = boundary_sec + period_sec;
+
+  return;
+} // end of HAL_SIM_runReplyBoundary() function
+
+
+//! \brief     Runs the DShot input and the eCAP interrupt up to a time
+//! \details   The eCAP loads the edges into CAP1 to CAP4 in turn and
+//!            requests the interrupt after CAP2 and CAP4.  The edges are run
+//!            one by one, an edge overwrites the capture of a pulse the
+//!            interrupt has not yet read.  While the eCAP sends a reply as
+//!            an APWM the edges are not captured and the period boundaries
+//!            are run in between.
+//! \param[in] obj       The host simulation object
+//! \param[in] until_sec The time, sec
+static void HAL_SIM_runDshot(HAL_SIM_Obj *obj,const double until_sec)
+{
+  CAP_Obj *cap = &gCap;
+  double bitPeriod_sec = 1.0 / obj->dshotBitRate_bps;
+  volatile uint32_t *pCap[4] = {&cap->CAP1,&cap->CAP2,&cap->CAP3,&cap->CAP4};
+
+  // a falling first event is the inverted line of bidirectional DShot
+  bool flag_bidir = (cap->ECCTL1 & CAP_ECCTL1_CAP1POL_BITS) != 0;
+
+  for(;;)
+    {
+      uint_least8_t bitNumber;
+      double edge_sec;
+
+      // the value is taken at the start of the frame
+      if((obj->dshotEdge >= 32) && (obj->dshotFrame_sec < until_sec))
+        {
+          uint16_t frame;
+
+          if(obj->rcPulse_usec <= 0.0)
+            {
+              obj->dshotSignal_sec = 0.0;
+              obj->dshotFrame_sec += obj->dshotFramePeriod_sec;
+              continue;
+            }
+
+          frame = (uint16_t)(HAL_SIM_getDshotValue(obj) << 5);
+          frame |= (frame >> 4 ^ frame >> 8 ^ frame >> 12 ^ (flag_bidir ? 0xF : 0)) & 0xF;
+
+          obj->dshotBits = frame;
+          obj->dshotEdge = 0;
+          obj->dshotSignal_sec += obj->dshotFramePeriod_sec;
+        }
+
+      edge_sec = until_sec;
+
+      if(obj->dshotEdge < 32)
+        {
+          bitNumber = obj->dshotEdge >> 1;
+          edge_sec = obj->dshotFrame_sec + (bitNumber * bitPeriod_sec);
+
+          if(obj->dshotEdge & 1)
+            {
+              edge_sec += ((obj->dshotBits << bitNumber) & 0x8000) ? (0.75 * bitPeriod_sec) : (0.375 * bitPeriod_sec);
+            }
+        }
+
+      // the reply periods before the next frame edge
+      if((cap->ECCTL2 & CAP_ECCTL2_CAPAPWM_BITS) &&
+         (obj->replyBoundary_sec < until_sec) && (obj->replyBoundary_sec < edge_sec))
+        {
+          HAL_SIM_runCapIsr(obj,obj->replyBoundary_sec);
+
+          // the interrupt may have ended the reply
+          if(cap->ECCTL2 & CAP_ECCTL2_CAPAPWM_BITS)
+            {
+              HAL_SIM_runReplyBoundary(obj);
+            }
+          continue;
+        }
+
+      if(edge_sec >= until_sec)
+        {
+          break;
+        }
+
+      HAL_SIM_runCapIsr(obj,edge_sec);
+
+      // the eCAP drives the line while it sends a reply
+      if(!(cap->ECCTL2 & CAP_ECCTL2_CAPAPWM_BITS))
+        {
+          if(!(cap->ECEFLG & cap->ECEINT))
+            {
+              obj->capPending_sec = edge_sec;
+            }
+
+          *pCap[obj->capEvent] = (uint32_t)(uint64_t)(edge_sec * HAL_SIM_CPU_FREQ_Hz + 0.5);
+          cap->ECEFLG |= CAP_Int_Type_CEVT1 << obj->capEvent;
+          obj->capEvent = (obj->capEvent + 1) & 3;
+        }
+
+      if(++obj->dshotEdge >= 32)
+        {
+          obj->dshotFrame_sec += obj->dshotFramePeriod_sec;
+        }
+    }
+
+  HAL_SIM_runCapIsr(obj,until_sec);
+
+  return;
+} // end of HAL_SIM_runDshot() function
+
+
+//! \brief     Runs the RC servo input and the eCAP interrupt up to the present time
+//! \param[in] obj  The host simulation object
+static void HAL_SIM_runCap(HAL_SIM_Obj *obj)
+{
+  CAP_Obj *cap = &gCap;
+
+  // the project set up the eCAP for DShot, which wraps after CEVT4
+  if((cap->ECCTL2 & CAP_ECCTL2_STOP_WRAP_BITS) == CAP_Stop_Wrap_CEVT4)
+    {
+      HAL_SIM_runDshot(obj,obj->time_sec);
+      return;
+    }
+
+  while(obj->time_sec >= obj->rcRise_sec + obj->rcPulse_usec * 1.0e-6)
+    {
+      if(obj->rcPulse_usec > 0.0)
+        {
+          double fall_sec = obj->rcRise_sec + obj->rcPulse_usec * 1.0e-6;
+
+          // CEVT1 captures the rising edge, CEVT2 the falling edge and resets the counter
+          cap->CAP1 = (uint32_t)((obj->rcRise_sec - obj->capReset_sec) * HAL_SIM_CPU_FREQ_Hz + 0.5);
+          cap->CAP2 = (uint32_t)((fall_sec - obj->capReset_sec) * HAL_SIM_CPU_FREQ_Hz + 0.5);
+          cap->ECEFLG |= CAP_Int_Type_CEVT1 | CAP_Int_Type_CEVT2;
+          obj->capReset_sec = fall_sec;
+
+          if((cap->ECEINT & CAP_Int_Type_CEVT2) && (IER & CPU_IntNumber_4) && (gPie.ECAP1_INT != NULL))
+            {
+              gPie.ECAP1_INT();
+
+              cap->ECEFLG &= ~cap->ECECLR;
+              cap->ECECLR = 0;
+            }
+        }
+
+      obj->rcRise_sec += HAL_SIM_RC_PERIOD_sec;
+    }
+
+  return;
+} // end of HAL_SIM_runCap() function
+
+
+void HAL_SIM_runTick(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+  uint_least8_t tick;
+  uint_least8_t cnt;
+
+  for(tick=0;tick<USER_NUM_PWM_TICKS_PER_ISR_TICK;tick++)
+    {
+      // the gate driver fault latches until the end of the simulation
+      if((obj->drvFault_sec >= 0.0) && (obj->time_sec >= obj->drvFault_sec))
+        {
+          obj->flag_drvFault = true;
+        }
+
+      // the one shot trip takes effect immediately, the compare values at counter zero
+      for(cnt=0;cnt<3;cnt++)
+        {
+          if(gPwm[cnt].TZCLR & PWM_TZCLR_OST_BITS)
+            {
+              obj->flag_tripped = false;
+            }
+
+          if(gPwm[cnt].TZCLR & PWM_TZCLR_CBC_BITS)
+            {
+              gPwm[cnt].TZFLG &= ~(PWM_TripZoneFlag_CBC | PWM_TripZoneFlag_Global);
+            }
+
+          if(gPwm[cnt].TZFRC & PWM_TZFRC_OST_BITS)
+            {
+              obj->flag_tripped = true;
+            }
+
+          // the nFAULT pin on TZ2 trips cycle by cycle while it is low
+          if(obj->flag_drvFault)
+            {
+              gPwm[cnt].TZFLG |= PWM_TripZoneFlag_CBC | PWM_TripZoneFlag_Global;
+              obj->flag_tripped = true;
+            }
+
+          gPwm[cnt].TZCLR = 0;
+          gPwm[cnt].TZFRC = 0;
+
+          obj->cmpA[cnt] = gPwm[cnt].CMPA;
+        }
+
+      if((tick == 0) && obj->flag_isrHeld)
+        {
+          obj->numIsrsHeld++;
+        }
+      else if((tick == 0) && (IER & CPU_IntNumber_10) && (gPie.ADCINT1 != NULL))
+        {
+          struct timespec start,stop;
+          double isr_ns;
+
+          // the DShot edges before the ISR are handled first
+          if((gCap.ECCTL2 & CAP_ECCTL2_STOP_WRAP_BITS) == CAP_Stop_Wrap_CEVT4)
+            {
+              HAL_SIM_runDshot(obj,obj->time_sec);
+            }
+
+          HAL_SIM_sampleAdc(obj);
+
+          obj->isrTime_sec = obj->time_sec;
+          obj->capCnt_sec = obj->time_sec;
+
+          clock_gettime(CLOCK_MONOTONIC,&start);
+          obj->flag_isrTimed = false;
+          obj->flag_inIsr = true;
+          obj->isrNestMask = (CPU_IntNumber_e)0;
+          gPie.ADCINT1();
+          obj->flag_inIsr = false;
+          clock_gettime(CLOCK_MONOTONIC,&stop);
+
+          // a running eCAP interrupt delays mainISR(), which then blocks the
+          // eCAP interrupt until it lets it preempt or until it returns
+          obj->isrBlockStart_sec = (obj->capIsrEnd_sec > obj->time_sec) ? obj->capIsrEnd_sec : obj->time_sec;
+          obj->isrBlockEnd_sec = obj->isrBlockStart_sec + obj->isrBusy_sec;
+
+          if(obj->flag_isrNesting && (obj->isrNestMask & CPU_IntNumber_4))
+            {
+              obj->isrBlockEnd_sec = obj->isrBlockStart_sec + HAL_SIM_ISR_NEST_sec;
+            }
+
+          isr_ns = (double)(stop.tv_sec - start.tv_sec) * 1.0e9 + (double)(stop.tv_nsec - start.tv_nsec);
+
+          obj->isrStats.numIsrs++;
+          obj->isrStats.total_ns += isr_ns;
+          obj->isrStats.last_ns = isr_ns;
+          if(isr_ns > obj->isrStats.max_ns)
+            {
+              obj->isrStats.max_ns = isr_ns;
+            }
+        }
+
+      HAL_SIM_runPwmPeriod(obj);
+    }
+
+  // the CPU timers count down at the system clock
+  for(cnt=0;cnt<3;cnt++)
+    {
+      uint64_t period = (uint64_t)gTimer[cnt].PRD + 1;
+      uint64_t cycles = (uint64_t)(obj->time_sec * HAL_SIM_CPU_FREQ_Hz);
+
+      gTimer[cnt].TIM = (uint32_t)(gTimer[cnt].PRD - (cycles % period));
+    }
+
+  HAL_SIM_runCap(obj);
+
+  HAL_SIM_runSci(obj);
+
+  if(obj->tickFcn != NULL)
+    {
+      obj->tickFcn(obj->pTickArg);
+    }
+
+  return;
+} // end of HAL_SIM_runTick() function
+
+
+void HAL_SIM_setBus(HAL_SIM_Handle handle,const double Cbus_F,const double Rbat_ohm,const double batDisconnect_sec)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  obj->Cbus_F = Cbus_F;
+  obj->Rbat_ohm = Rbat_ohm;
+  obj->batDisconnect_sec = batDisconnect_sec;
+
+  return;
+} // end of HAL_SIM_setBus() function
+
+
+void HAL_SIM_setDrvFault_sec(HAL_SIM_Handle handle,const double drvFault_sec)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  obj->drvFault_sec = drvFault_sec;
+
+  return;
+} // end of HAL_SIM_setDrvFault_sec() function
+
+
+void HAL_SIM_setInverter(HAL_SIM_Handle handle,const double deadTime_sec,const double Vdrop_V)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  obj->deadTime_sec = deadTime_sec;
+  obj->Vdrop_V = Vdrop_V;
+
+  return;
+} // end of HAL_SIM_setInverter() function
+
+
+void HAL_SIM_setPlantParams(HAL_SIM_Handle handle,const PMSM_SIM_Params *pParams)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  PMSM_SIM_setParams(obj->plantHandle,pParams);
+
+  return;
+} // end of HAL_SIM_setPlantParams() function
+
+
+void HAL_SIM_setDshot(HAL_SIM_Handle handle,const double bitRate_bps,const double frameRate_Hz)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  obj->dshotBitRate_bps = bitRate_bps;
+  obj->dshotFramePeriod_sec = 1.0 / frameRate_Hz;
+
+  return;
+} // end of HAL_SIM_setDshot() function
+
+
+void HAL_SIM_setIsrLatency(HAL_SIM_Handle handle,const double isrBusy_sec,const bool flag_isrNesting)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  obj->isrBusy_sec = isrBusy_sec;
+  obj->flag_isrNesting = flag_isrNesting;
+
+  return;
+} // end of HAL_SIM_setIsrLatency() function
+
+
+void HAL_SIM_setRcPulse_usec(HAL_SIM_Handle handle,const double rcPulse_usec)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  obj->rcPulse_usec = rcPulse_usec;
+
+  return;
+} // end of HAL_SIM_setRcPulse_usec() function
+
+
+void HAL_SIM_setSciOutput(HAL_SIM_Handle handle,const int fd)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  obj->sciFd = fd;
+
+  return;
+} // end of HAL_SIM_setSciOutput() function
+
+
+void HAL_SIM_setTickFcn(HAL_SIM_Handle handle,const HAL_SIM_TickFcn tickFcn,void *pArg)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  obj->tickFcn = tickFcn;
+  obj->pTickArg = pArg;
+
+  return;
+} // end of HAL_SIM_setTickFcn() function
+
+
+void HAL_SIM_setVdc_V(HAL_SIM_Handle handle,const double Vdc_V)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  obj->Vdc_V = Vdc_V;
+  obj->Vbat_V = Vdc_V;
+  obj->VdcPeak_V = Vdc_V;
+
+  return;
+} // end of HAL_SIM_setVdc_V() function
+
+
+void HAL_SIM_stop(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  obj->flag_stop = true;
+
+  return;
+} // end of HAL_SIM_stop() function
+
+// end of file
@@ -0,0 +1,584 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _HAL_SIM_H_
+#define _HAL_SIM_H_
+
+//! \file   sw\modules\hal\boards\TIDA-00643\host\src\hal_sim.h
+//! \brief  Contains the public interface to the host simulation of the
+//!         TIDA-00643 power stage
+//!
+//!         The host HAL keeps the register level interface of the f2802x HAL,
+//!         so hal.h and hal_obj.h are used unchanged and the static inline
+//!         functions in them operate on peripheral objects in host memory.
+//!         The simulation reads the PWM compare registers, drives a PMSM
+//!         plant model through an ideal three phase inverter, writes the ADC
+//!         result registers and dispatches the ADC and eCAP interrupt
+//!         vectors, one ISR tick at a time.  The background loop of the
+//!         project advances the simulation every time it calls
+//!         HAL_readDrvData(), which is the only DRV8305 access in the loop.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <setjmp.h>
+#include <time.h>
+
+#include "hal.h"
+#include "sw/modules/pmsm_sim/src/host/pmsm_sim.h"
+
+
+//!
+//!
+//! \defgroup HAL_SIM HAL_SIM
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the period of the RC servo pulses, sec
+//!
+#define HAL_SIM_RC_PERIOD_sec       (0.02)
+
+//! \brief Defines the depth of the SCI transmit FIFO
+//!
+#define HAL_SIM_SCI_FIFO_DEPTH      (4)
+
+//! \brief Defines the default DShot input, DShot600 at 8 kHz
+//!
+#define HAL_SIM_DSHOT_BIT_RATE_bps  (600000.0)
+#define HAL_SIM_DSHOT_FRAME_RATE_Hz (8000.0)
+
+//! \brief Defines the time the DShot input sends motor stop frames to arm, sec
+//!
+#define HAL_SIM_DSHOT_ARM_sec       (0.1)
+
+//! \brief Defines the number of bits of a bidirectional DShot reply, at 5/4 of the bit rate
+//!
+#define HAL_SIM_DSHOT_REPLY_NUM_BITS (21)
+
+//! \brief Defines the default execution time of mainISR(), the other interrupts wait unless it nests, sec
+//!
+#define HAL_SIM_ISR_BUSY_sec        (25.0e-6)
+
+//! \brief Defines the time from the mainISR() entry to HAL_enableIsrNesting(), sec
+//!
+#define HAL_SIM_ISR_NEST_sec        (1.0e-6)
+
+//! \brief Defines the execution time of the eCAP interrupt, sec
+//!
+#define HAL_SIM_ECAP_ISR_sec        (1.0e-6)
+
+//! \brief Defines the programming time of a flash word, sec
+//!
+#define HAL_SIM_FLASH_PROGRAM_sec   (50.0e-6)
+
+//! \brief Defines the number of words of the flight recorder flash region
+//!
+#define HAL_SIM_FLASH_LOG_NUM_WORDS (HAL_FLASH_LOG_NUM_SECTORS * HAL_FLASH_LOG_SECTOR_WORDS)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the function called after every simulated ISR tick
+//! \param[in] pArg  The argument registered with the function
+typedef void (*HAL_SIM_TickFcn)(void *pArg);
+
+
+//! \brief Defines the ISR execution statistics, measured on the host
+//!
+typedef struct _HAL_SIM_IsrStats_
+{
+  uint_least32_t  numIsrs;        //!< the number of mainISR() calls
+  double          total_ns;       //!< the total mainISR() execution time, ns
+  double          max_ns;         //!< the longest mainISR() execution time, ns
+  double          last_ns;        //!< the last mainISR() execution time, ns
+} HAL_SIM_IsrStats;
+
+
+//! \brief Defines the host simulation object
+//!
+typedef struct _HAL_SIM_Obj_
+{
+  PMSM_SIM_Obj      plant;              //!< the motor plant
+  PMSM_SIM_Handle   plantHandle;        //!< the motor plant handle
+
+  double            Vdc_V;              //!< the DC bus voltage, V
+  double            Vbat_V;             //!< the open circuit voltage of the battery, V
+  double            Rbat_ohm;           //!< the internal resistance of the battery, ohm
+  double            Cbus_F;             //!< the DC bus capacitance, F, zero for a bus held at the battery voltage
+  double            batDisconnect_sec;  //!< the time the battery is disconnected from the bus, sec, negative for never
+  double            VdcPeak_V;          //!< the highest DC bus voltage, V
+  double            time_sec;           //!< the simulated time, sec
+  uint_least32_t    numPwmTicks;        //!< the number of simulated PWM periods
+
+  uint16_t          cmpA[3];            //!< the active PWM compare values, loaded at counter zero
+  bool              flag_tripped;       //!< denotes that the bridge is in high impedance
+  double            deadTime_sec;       //!< the dead time after every switching edge, sec
+  double            Vdrop_V;            //!< the on state voltage drop of the switches, V
+  uint_least32_t    numSwitchingLegs;   //!< the number of legs switched, summed over the PWM periods
+  double            switchedCurrent_A;  //!< the current of the switched legs, summed over the PWM periods, A
+
+  double            Vsense_V[3];        //!< the filtered phase voltage feedback, V
+  double            VdcSense_V;         //!< the filtered DC bus voltage feedback, V
+  double            voltageFilterPole_rps;  //!< the voltage feedback filter pole, rad/s
+
+  double            rcPulse_usec;       //!< the RC pulse width, usec, zero for no signal
+  double            rcRise_sec;         //!< the time of the next RC rising edge, sec
+  double            capReset_sec;       //!< the time of the last eCAP counter reset, sec
+  uint_least8_t     capEvent;           //!< the next eCAP capture event of the DShot input, 0 to 3
+  double            capPending_sec;     //!< the time the pending eCAP interrupt was requested, sec
+  double            capIsrEnd_sec;      //!< the time the last eCAP interrupt returns, sec
+  uint_least32_t    capNumIsrs;         //!< the number of eCAP interrupts of the DShot input
+  double            capMaxLatency_sec;  //!< the longest time from the request to the eCAP interrupt, sec
+
+  double            dshotBitRate_bps;   //!< the DShot bit rate, bps
+  double            dshotFramePeriod_sec;  //!< the DShot frame period, sec
+  double            dshotFrame_sec;     //!< the time of the next DShot frame, sec
+  double            dshotSignal_sec;    //!< the time the DShot signal is present, sec
+  uint16_t          dshotBits;          //!< the bits of the DShot frame being sent
+  uint_least8_t     dshotEdge;          //!< the next edge of the DShot frame, 0 to 31, 32 between the frames
+  uint32_t          dshotReply;         //!< the transitions of the last bidirectional DShot reply
+  uint_least32_t    dshotNumReplies;    //!< the number of bidirectional DShot replies sent
+  uint_least32_t    dshotNumRepliesLate;   //!< the number of replies requested after their start time
+  uint_least32_t    dshotNumReplyUnderruns; //!< the number of reply periods repeated as the next one was not set in time
+  double            replyStart_sec;     //!< the start time of the reply being sent, sec
+  double            replyBoundary_sec;  //!< the time of the next APWM period boundary of the reply, sec
+  bool              flag_replyShadow;   //!< denotes that the APWM shadow registers were written since the last boundary
+  uint32_t          replyBits;          //!< the transitions of the reply being sent
+  double            capCnt_sec;         //!< the time the eCAP counter reads in an interrupt, sec
+  double            isrTime_sec;        //!< the time of the last mainISR() entry, sec
+  double            isrBusy_sec;        //!< the execution time of mainISR(), sec
+  bool              flag_isrNesting;    //!< denotes that HAL_enableIsrNesting() lets the eCAP interrupt preempt mainISR()
+  CPU_IntNumber_e   isrNestMask;        //!< the interrupts mainISR() lets preempt it
+  double            isrBlockStart_sec;  //!< the time mainISR() starts to block the other interrupts, sec
+  double            isrBlockEnd_sec;    //!< the time mainISR() stops to block the other interrupts, sec
+
+  HAL_SIM_IsrStats  isrStats;           //!< the ISR execution statistics
+  bool              flag_inIsr;         //!< denotes that mainISR() is running
+  bool              flag_isrTimed;      //!< denotes that a timer was read in the running mainISR()
+  struct timespec   isrStart;           //!< the host time at the first timer read of the running mainISR()
+
+  int               sciFd;              //!< the file descriptor of the SCIA output, -1 for none
+  uint16_t          sciFifo[HAL_SIM_SCI_FIFO_DEPTH];  //!< the SCIA transmit FIFO
+  uint_least8_t     sciFifoLevel;       //!< the number of bytes in the SCIA transmit FIFO
+  double            sciByteDone_sec;    //!< the time the first byte of the FIFO is sent, sec
+  uint_least32_t    sciNumBytes;        //!< the number of bytes sent on SCIA
+  uint_least32_t    sciNumDropped;      //!< the number of bytes the output did not take
+
+  uint16_t          flashLog[HAL_SIM_FLASH_LOG_NUM_WORDS];  //!< the flash region of the flight recorder
+  uint_least32_t    flashNumErases;     //!< the number of sector erases
+  double            flashBusy_sec;      //!< the programming time not yet simulated, sec
+  bool              flag_isrHeld;       //!< denotes that the interrupts are disabled for a flash operation
+  uint_least32_t    numIsrsHeld;        //!< the number of ISR ticks without mainISR() call
+  double            drvFault_sec;       //!< the time the gate driver reports a fault, sec, negative for none
+  bool              flag_drvFault;      //!< denotes that the gate driver reports a fault
+  HAL_SIM_TickFcn   tickFcn;            //!< the function called after every ISR tick
+  void             *pTickArg;           //!< the argument of the tick function
+
+  bool              flag_stop;          //!< a flag to end the simulation
+  jmp_buf           stopEnv;            //!< the context restored when the simulation ends
+} HAL_SIM_Obj;
+
+
+//! \brief Defines the host simulation handle
+//!
+typedef struct _HAL_SIM_Obj_ *HAL_SIM_Handle;
+
+
+// **************************************************************************
+// the globals
+
+extern HAL_SIM_Obj halSim;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Gets the ISR execution statistics
+//! \param[in] handle  The host simulation handle
+//! \return    The pointer to the ISR execution statistics
+static inline const HAL_SIM_IsrStats *HAL_SIM_getIsrStats(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(&obj->isrStats);
+} // end of HAL_SIM_getIsrStats() function
+
+
+//! \brief     Gets the number of switched legs
+//! \details   A leg switches in a PWM period unless its compare value holds
+//!            it high or low for the whole period
+//! \param[in] handle  The host simulation handle
+//! \return    The number of legs switched, summed over the PWM periods
+static inline uint_least32_t HAL_SIM_getNumSwitchingLegs(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->numSwitchingLegs);
+} // end of HAL_SIM_getNumSwitchingLegs() function
+
+
+//! \brief     Gets the flash region of the flight recorder
+//! \details   The region is erased at HAL_SIM_init(), it can be loaded from
+//!            an image before the project runs
+//! \param[in] handle  The host simulation handle
+//! \return    The pointer to HAL_SIM_FLASH_LOG_NUM_WORDS words
+static inline uint16_t *HAL_SIM_getFlashLog(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->flashLog);
+} // end of HAL_SIM_getFlashLog() function
+
+
+//! \brief     Gets the number of flash sector erases
+//! \param[in] handle  The host simulation handle
+//! \return    The number of erases
+static inline uint_least32_t HAL_SIM_getFlashNumErases(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->flashNumErases);
+} // end of HAL_SIM_getFlashNumErases() function
+
+
+//! \brief     Gets the number of ISR ticks without mainISR() call
+//! \details   The interrupts are disabled while the flash is programmed
+//! \param[in] handle  The host simulation handle
+//! \return    The number of ISR ticks
+static inline uint_least32_t HAL_SIM_getNumIsrsHeld(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->numIsrsHeld);
+} // end of HAL_SIM_getNumIsrsHeld() function
+
+
+//! \brief     Gets the motor plant handle
+//! \param[in] handle  The host simulation handle
+//! \return    The motor plant handle
+static inline PMSM_SIM_Handle HAL_SIM_getPlantHandle(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->plantHandle);
+} // end of HAL_SIM_getPlantHandle() function
+
+
+//! \brief     Gets the switched current
+//! \details   The switching loss of a leg is about proportional to the
+//!            magnitude of its current
+//! \param[in] handle  The host simulation handle
+//! \return    The current magnitude of the switched legs, summed over the PWM periods, A
+static inline double HAL_SIM_getSwitchedCurrent_A(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->switchedCurrent_A);
+} // end of HAL_SIM_getSwitchedCurrent_A() function
+
+
+//! \brief     Gets the simulated time
+//! \param[in] handle  The host simulation handle
+//! \return    The simulated time, sec
+static inline double HAL_SIM_getTime_sec(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->time_sec);
+} // end of HAL_SIM_getTime_sec() function
+
+
+//! \brief     Gets the DC bus voltage
+//! \param[in] handle  The host simulation handle
+//! \return    The DC bus voltage, V
+static inline double HAL_SIM_getVdc_V(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->Vdc_V);
+} // end of HAL_SIM_getVdc_V() function
+
+
+//! \brief     Gets the highest DC bus voltage
+//! \param[in] handle  The host simulation handle
+//! \return    The highest DC bus voltage since HAL_SIM_init(), V
+static inline double HAL_SIM_getVdcPeak_V(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->VdcPeak_V);
+} // end of HAL_SIM_getVdcPeak_V() function
+
+
+//! \brief     Denotes whether the bridge is in high impedance
+//! \param[in] handle  The host simulation handle
+//! \return    true when all switches are off
+static inline bool HAL_SIM_isTripped(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->flag_tripped);
+} // end of HAL_SIM_isTripped() function
+
+
+//! \brief     Gets the true rotor angle and speed in the units of the estimator
+//! \details   Matches EST_TruthFcn so it can be registered with the host estimator
+//! \param[in]  pArg       The host simulation handle
+//! \param[out] pAngle_pu  The pointer to the electrical angle, pu
+//! \param[out] pFm_pu     The pointer to the electrical frequency, pu
+extern void HAL_SIM_getTruth(void *pArg,_iq *pAngle_pu,_iq *pFm_pu);
+
+
+//! \brief     Initializes the host simulation
+//! \param[in] pMemory   A pointer to the memory for the host simulation object
+//! \param[in] numBytes  The number of bytes allocated for the host simulation object, bytes
+//! \return    The host simulation handle
+extern HAL_SIM_Handle HAL_SIM_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Runs a project main function until the simulation is stopped
+//! \param[in] handle   The host simulation handle
+//! \param[in] mainFcn  The main function of the project
+extern void HAL_SIM_run(HAL_SIM_Handle handle,void (*mainFcn)(void));
+
+
+//! \brief     Advances the simulation by one ISR tick
+//! \details   Runs USER_NUM_PWM_TICKS_PER_ISR_TICK PWM periods.  The ADC is
+//!            sampled and mainISR() is called at counter zero of the first
+//!            period, the new compare values are loaded at the next zero.
+//! \param[in] handle  The host simulation handle
+extern void HAL_SIM_runTick(HAL_SIM_Handle handle);
+
+
+//! \brief     Sets the DC bus capacitance and the battery
+//! \details   With a capacitance the bus voltage follows the current the
+//!            bridge draws from the bus, the battery holds it through its
+//!            internal resistance until it is disconnected.  The energy of a
+//!            braking rotor then charges the capacitance.  The capacitance is
+//!            zero after HAL_SIM_init(), the bus stays at the voltage of
+//!            HAL_SIM_setVdc_V().
+//! \param[in] handle             The host simulation handle
+//! \param[in] Cbus_F             The DC bus capacitance, F
+//! \param[in] Rbat_ohm           The internal resistance of the battery, ohm
+//! \param[in] batDisconnect_sec  The time the battery is disconnected, sec, negative for never
+extern void HAL_SIM_setBus(HAL_SIM_Handle handle,const double Cbus_F,const double Rbat_ohm,const double batDisconnect_sec);
+
+
+//! \brief     Sets the time the gate driver reports a fault
+//! \details   From this time on the nFAULT pin trips the PWMs cycle by cycle,
+//!            the bridge is in high impedance and the status register 1 of
+//!            the DRV8305 shows a VDS overcurrent fault
+//! \param[in] handle        The host simulation handle
+//! \param[in] drvFault_sec  The time, sec, negative for no fault
+extern void HAL_SIM_setDrvFault_sec(HAL_SIM_Handle handle,const double drvFault_sec);
+
+
+//! \brief     Sets the dead time and the switch voltage drop of the bridge
+//! \details   In the dead time after every switching edge both switches are
+//!            off and the freewheeling diodes carry the current, with the
+//!            forward voltage of the plant parameters.  The switches drop
+//!            Vdrop_V in the direction of the current.  Both are zero after
+//!            HAL_SIM_init().
+//! \param[in] handle        The host simulation handle
+//! \param[in] deadTime_sec  The dead time, sec
+//! \param[in] Vdrop_V       The on state voltage drop of the switches, V
+extern void HAL_SIM_setInverter(HAL_SIM_Handle handle,const double deadTime_sec,const double Vdrop_V);
+
+
+//! \brief     Sets the motor plant parameters and resets the plant
+//! \param[in] handle   The host simulation handle
+//! \param[in] pParams  The pointer to the plant parameters
+extern void HAL_SIM_setPlantParams(HAL_SIM_Handle handle,const PMSM_SIM_Params *pParams);
+
+
+//! \brief     Sets the output of the SCIA transmitter
+//! \details   The bytes are written without blocking, bytes the output does
+//!            not take are counted and dropped
+//! \param[in] handle  The host simulation handle
+//! \param[in] fd      The file descriptor, -1 discards the bytes
+extern void HAL_SIM_setSciOutput(HAL_SIM_Handle handle,const int fd);
+
+
+//! \brief     Gets the number of bytes sent on SCIA
+//! \param[in] handle  The host simulation handle
+//! \return    The number of bytes
+static inline uint_least32_t HAL_SIM_getSciNumBytes(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->sciNumBytes);
+} // end of HAL_SIM_getSciNumBytes() function
+
+
+//! \brief     Gets the number of bytes sent on SCIA that the output did not take
+//! \param[in] handle  The host simulation handle
+//! \return    The number of bytes
+static inline uint_least32_t HAL_SIM_getSciNumDropped(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->sciNumDropped);
+} // end of HAL_SIM_getSciNumDropped() function
+
+
+//! \brief     Gets the longest time from a DShot capture to the eCAP interrupt
+//! \param[in] handle  The host simulation handle
+//! \return    The latency, sec
+static inline double HAL_SIM_getCapMaxLatency_sec(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->capMaxLatency_sec);
+} // end of HAL_SIM_getCapMaxLatency_sec() function
+
+
+//! \brief     Gets the number of eCAP interrupts of the DShot input
+//! \param[in] handle  The host simulation handle
+//! \return    The number of interrupts
+static inline uint_least32_t HAL_SIM_getCapNumIsrs(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->capNumIsrs);
+} // end of HAL_SIM_getCapNumIsrs() function
+
+
+//! \brief     Gets the last bidirectional DShot reply
+//! \param[in] handle  The host simulation handle
+//! \return    The transitions of the reply, see DSHOT_decodeReply()
+static inline uint32_t HAL_SIM_getDshotReply(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->dshotReply);
+} // end of HAL_SIM_getDshotReply() function
+
+
+//! \brief     Gets the number of bidirectional DShot replies sent
+//! \param[in] handle  The host simulation handle
+//! \return    The number of replies
+static inline uint_least32_t HAL_SIM_getDshotNumReplies(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->dshotNumReplies);
+} // end of HAL_SIM_getDshotNumReplies() function
+
+
+//! \brief     Gets the number of bidirectional DShot replies requested after their start time
+//! \param[in] handle  The host simulation handle
+//! \return    The number of replies
+static inline uint_least32_t HAL_SIM_getDshotNumRepliesLate(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->dshotNumRepliesLate);
+} // end of HAL_SIM_getDshotNumRepliesLate() function
+
+
+//! \brief     Gets the number of bidirectional DShot reply periods the eCAP repeated
+//! \details   The eCAP interrupt did not set the next period before the
+//!            period boundary, the reply is corrupt
+//! \param[in] handle  The host simulation handle
+//! \return    The number of periods
+static inline uint_least32_t HAL_SIM_getDshotNumReplyUnderruns(HAL_SIM_Handle handle)
+{
+  HAL_SIM_Obj *obj = (HAL_SIM_Obj *)handle;
+
+  return(obj->dshotNumReplyUnderruns);
+} // end of HAL_SIM_getDshotNumReplyUnderruns() function
+
+
+//! \brief     Sets the DShot input used when the project sets up the eCAP for DShot
+//! \details   The RC pulse width sets the throttle
+//! \param[in] handle        The host simulation handle
+//! \param[in] bitRate_bps   The bit rate, 150000, 300000 or 600000 bps
+//! \param[in] frameRate_Hz  The frame rate, Hz
+extern void HAL_SIM_setDshot(HAL_SIM_Handle handle,const double bitRate_bps,const double frameRate_Hz);
+
+
+//! \brief     Sets the interrupt latency of the DShot input
+//! \details   The eCAP interrupt waits for mainISR() to end, or only for
+//!            HAL_SIM_ISR_NEST_sec when mainISR() lets it preempt with
+//!            HAL_enableIsrNesting()
+//! \param[in] handle           The host simulation handle
+//! \param[in] isrBusy_sec      The execution time of mainISR(), sec
+//! \param[in] flag_isrNesting  false to ignore HAL_enableIsrNesting(), as a build without it
+extern void HAL_SIM_setIsrLatency(HAL_SIM_Handle handle,const double isrBusy_sec,const bool flag_isrNesting);
+
+
+//! \brief     Sets the RC servo pulse width seen by the eCAP input
+//! \param[in] handle        The host simulation handle
+//! \param[in] rcPulse_usec  The pulse width, usec, zero removes the signal
+extern void HAL_SIM_setRcPulse_usec(HAL_SIM_Handle handle,const double rcPulse_usec);
+
+
+//! \brief     Sets the function called after every ISR tick
+//! \param[in] handle   The host simulation handle
+//! \param[in] tickFcn  The tick function
+//! \param[in] pArg     The argument passed to the tick function
+extern void HAL_SIM_setTickFcn(HAL_SIM_Handle handle,const HAL_SIM_TickFcn tickFcn,void *pArg);
+
+
+//! \brief     Sets the DC bus voltage
+//! \details   Also the open circuit voltage of the battery, see HAL_SIM_setBus()
+//! \param[in] handle  The host simulation handle
+//! \param[in] Vdc_V   The DC bus voltage, V
+extern void HAL_SIM_setVdc_V(HAL_SIM_Handle handle,const double Vdc_V);
+
+
+//! \brief     Ends the simulation
+//! \details   Takes effect the next time the background loop yields, the
+//!            project main function does not return
+//! \param[in] handle  The host simulation handle
+extern void HAL_SIM_stop(HAL_SIM_Handle handle);
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+#endif // end of _HAL_SIM_H_ definition
+
@@ -156,6 +156,31 @@ extern "C" {
 //! \brief For space vector over-modulation, see lab 10 for details on system requirements that will allow the SVM generator to go all the way to trapezoidal.
 #define USER_MAX_VS_MAG_PU        (1.0)    // Set to 1.0 if a current reconstruction technique is not used.  Look at the module svgen_current in lab10a-x for more info.
 
+//! \brief Defines the time both switches of a phase are off after an edge, nsec
+//! \brief The DRV8305 default dead time of 60 ns plus the ePWM dead band of HAL_PWM_DBRED_CNT system clocks.  Used by the dead time compensation (DTCOMP)
+#define USER_PWM_DEADTIME_ns           (80.0)
+
+//! \brief Defines the on state voltage drop of a switch at the typical phase current, V
+//! \brief Used by the dead time compensation (DTCOMP)
+#define USER_SWITCH_VDROP_V            (0.02)
+
+//! \brief Defines the phase current below which the dead time compensation is scaled down, A
+//! \brief About half the peak to peak current ripple, the polarity of the current at the switching edges is uncertain below it
+#define USER_DTCOMP_CURRENT_BAND_A     (0.3)
+
+//! \brief Defines the discontinuous PWM mode above the modulation threshold, SVGEN_DPWM_Mode_e
+//! \brief DPWM1 clamps each leg around its voltage peak, the current of the E300 stays close to the voltage up to full speed
+#define USER_DPWM_MODE                 (SVGEN_DPWM_Mode_DPWM1)
+
+//! \brief Defines the modulation index above which one leg is clamped, and the one below which all legs switch again
+//! \brief The clamped leg doubles the current ripple of the other two, at low modulation the ripple costs more than the switching
+#define USER_DPWM_MODULATION_ON        (0.6)
+#define USER_DPWM_MODULATION_OFF       (0.5)
+
+//! \brief Defines the sum of the rise and fall times of a switch, nsec
+//! \brief Used for the switching loss estimate of the discontinuous PWM
+#define USER_SWITCH_TRANSITION_ns      (30.0)
+
 
 //! \brief Defines the Pulse Width Modulation (PWM) period, usec
 //! \brief Compile time calculation
@@ -241,6 +266,110 @@ extern "C" {
 //! \brief Can be positive or negative
 #define USER_FORCE_ANGLE_FREQ_Hz   (2.0 * USER_ZEROSPEEDLIMIT * USER_IQ_FULL_SCALE_FREQ_Hz)      // Default will keep FREQ >= 2.0 * low speed limit for the flux integrator
 
+//! \brief Defines the amplitude of the square wave voltage of the high frequency injection (HFI), V
+//! \brief The sample sees about a third of it, the PWM of the first period of an ISR tick still has the previous sign
+#define USER_HFI_INJ_VOLTAGE_V         (1.0)
+
+//! \brief Defines the expected Lq over Ld of the motor, used for the gains of the HFI tracking PLL
+//! \brief HFI needs a salient motor, Lq larger than Ld.  The surface magnets of the E300 give none
+#define USER_HFI_SALIENCY_RATIO        (2.0)
+
+//! \brief Defines the bandwidth of the HFI tracking PLL and of its speed output, Hz
+#define USER_HFI_PLL_BANDWIDTH_Hz      (100.0)
+#define USER_HFI_SPEED_FILTER_Hz       (50.0)
+
+//! \brief Defines the speed above which the angle of the estimator replaces the HFI angle, and the one below which HFI takes over again, krpm
+#define USER_HFI_HANDOVER_krpm         (0.6)
+#define USER_HFI_HANDBACK_krpm         (0.4)
+
+//! \brief Defines the direct axis current of the HFI polarity pulses, A
+//! \brief Large enough to saturate the direct axis measurably, the pulses produce no torque
+#define USER_HFI_POLARITY_CURRENT_A    (5.0)
+
+//! \brief Defines the time the HFI tracking PLL locks to the rotor axis, and the duration of each polarity pulse, ms
+#define USER_HFI_ALIGN_TIME_ms         (50.0)
+#define USER_HFI_POLARITY_TIME_ms      (20.0)
+
+//! \brief Defines the bandwidth of the back-EMF filter of the observer (OBS), Hz
+//! \brief The lag of the filter is compensated, a lower value trades dynamics for less noise on the angle
+#define USER_OBS_EMF_FILTER_Hz         (500.0)
+
+//! \brief Defines the bandwidth of the OBS tracking PLL and of its speed output, Hz
+#define USER_OBS_PLL_BANDWIDTH_Hz      (150.0)
+#define USER_OBS_SPEED_FILTER_Hz       (100.0)
+
+//! \brief Defines the quadrature axis current on the forced angle while the back-EMF is too small to observe, A
+#define USER_OBS_STARTUP_CURRENT_A     (5.0)
+
+//! \brief Defines the speed above which the OBS angle replaces the forced angle, and the one below which the forced angle takes over again, krpm
+#define USER_OBS_HANDOVER_krpm         (0.8)
+#define USER_OBS_HANDBACK_krpm         (0.5)
+
+//! \brief Defines the number of entries of the harmonic compensator (HCOMP) table over one mechanical revolution as a power of two
+//! \brief 512 entries give about 6 per period of the cogging of the 12 slots and 14 poles of the E300
+#define USER_HCOMP_TABLE_SHIFT         (9)
+
+//! \brief Defines the HCOMP harmonics, their orders in periods per mechanical revolution
+//! \brief Order 1 is the unbalanced propeller, order 84 the cogging
+//! \brief Orders that are not a multiple of the pole pairs, such as order 1, are aligned again after every start
+#define USER_HCOMP_NUM_HARMONICS       (2)
+#define USER_HCOMP_ORDERS              {1, 84}
+
+//! \brief Defines the rate the HCOMP harmonics converge at, 1/s
+#define USER_HCOMP_RATE_1ps            (5.0)
+
+//! \brief Defines the largest amplitude of each HCOMP harmonic, A
+#define USER_HCOMP_MAX_CURRENT_A       (3.0)
+
+//! \brief Defines the rotor and propeller inertia HCOMP separates the disturbance from the acceleration with, kg*m^2
+//! \brief Zero learns from the speed controller output alone, which only works below the speed loop bandwidth
+#define USER_HCOMP_INERTIA_kgm2        (2.0e-5)
+
+//! \brief Defines the bandwidth of the filter that removes the mean of the HCOMP residual, Hz
+#define USER_HCOMP_MEAN_FILTER_Hz      (1.0)
+
+//! \brief Defines the speed below which HCOMP stops learning, the feedforward is kept, krpm
+#define USER_HCOMP_MIN_SPEED_krpm      (0.02)
+
+//! \brief Defines the number of entries of the field weakening (FW) Id feedforward table
+#define USER_FW_TABLE_SIZE             (32)
+
+//! \brief Defines the speed over the DC bus voltage of the last FW table entry, pu
+//! \brief 4.0 covers the full scale frequency at a 5 V DC bus
+#define USER_FW_MAX_INDEX_PU           (4.0)
+
+//! \brief Defines the gains of the FW voltage regulator, pu of current per pu of voltage
+//! \brief The integral gain is per FW tick, it sets about 30 Hz of bandwidth at 5 krpm on a 7.4 V DC bus
+#define USER_FW_KP                     (0.5)
+#define USER_FW_KI                     (0.5)
+
+//! \brief Defines the number of entries of the maximum torque per ampere (MTPA) Id table
+#define USER_MTPA_TABLE_SIZE           (32)
+
+//! \brief Defines the quadrature current of the last MTPA table entry, A
+#define USER_MTPA_MAX_CURRENT_A        (USER_MOTOR_MAX_CURRENT)
+
+//! \brief Defines the bandwidth of the catch spin (CATCH) PLL that tracks the back-EMF of a windmilling rotor with the bridge off, Hz
+#define USER_CATCH_PLL_BANDWIDTH_Hz    (100.0)
+
+//! \brief Defines the smallest back-EMF amplitude the CATCH tracks, V, about 740 rpm with the E300
+#define USER_CATCH_MIN_EMF_V           (0.5)
+
+//! \brief Defines how long the CATCH PLL stays locked before the rotor counts as caught, and how long a start waits for a lock, sec
+#define USER_CATCH_LOCK_TIME_sec       (0.01)
+#define USER_CATCH_TIMEOUT_sec         (0.05)
+
+//! \brief Defines the DC bus voltage above which the regenerative braking governor (REGEN) limits the regenerative current, V
+//! \brief Above a full 3S pack, 12.6 V
+#define USER_REGEN_START_VDC_V         (14.0)
+
+//! \brief Defines the DC bus ceiling of the REGEN, no regenerative current is allowed above it, V
+//! \brief Below the full scale of the bus voltage feedback, USER_ADC_FULL_SCALE_VOLTAGE_V
+#define USER_REGEN_MAX_VDC_V           (16.0)
+
+//! \brief Defines the Id that the REGEN injects while braking at the ceiling, its copper losses take part of the braking energy, A
+#define USER_REGEN_ID_LOSS_A           (USER_MAX_NEGATIVE_ID_REF_CURRENT_A)
+
 //! \brief Defines the maximum current slope for Id trajectory during PowerWarp
 //! \brief For Induction motors only, controls how fast Id input can change under PowerWarp control
 #define USER_MAX_CURRENT_SLOPE_POWERWARP   (0.3*USER_MOTOR_RES_EST_CURRENT/USER_IQ_FULL_SCALE_CURRENT_A/USER_TRAJ_FREQ_Hz)  // 0.3*RES_EST_CURRENT / IQ_FULL_SCALE_CURRENT / TRAJ_FREQ Typical to produce 1-sec rampup/down
@@ -720,6 +849,17 @@ extern void USER_softwareUpdate1p6(CTRL_Handle handle);
 extern void USER_calcPIgains(CTRL_Handle handle);
 
 
+//! \brief      Computes the Id feedforward table of the field weakening, see FW_setFfTable()
+//! \details    Entry n holds the Id that keeps the voltage magnitude at VsRef_pu without
+//!             load at the speed over the DC bus voltage of n * maxIndex_pu / (numPoints - 1),
+//!             limited to USER_MAX_NEGATIVE_ID_REF_CURRENT_A and zero
+//! \param[out] pTable       The pointer to the table
+//! \param[in]  numPoints    The number of table entries
+//! \param[in]  maxIndex_pu  The speed over the DC bus voltage of the last entry, pu
+//! \param[in]  VsRef_pu     The reference of the voltage magnitude, pu
+extern void USER_calcFwFfTable(_iq *pTable,const uint_least16_t numPoints,const float_t maxIndex_pu,const float_t VsRef_pu);
+
+
 //! \brief      Computes the scale factor needed to convert from torque created by Ld, Lq, Id and Iq, from per unit to Nm
 //! \return     The scale factor to convert torque from (Ld - Lq) * Id * Iq from per unit to Nm, in IQ24 format
 extern _iq USER_computeTorque_Ls_Id_Iq_pu_to_Nm_sf(void);
@@ -0,0 +1,674 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   solutions/instaspin_foc/boards/TIDA-00643/host/src/ctrl_fused_bench.c
+//! \brief  Compares the fused current loop CTRL_runOnLine_UserFused() with the
+//!         module chain of CTRL_runOnLine_User()
+//!
+//!         Two controllers are set up from the TIDA-00643 user parameters and
+//!         run on the same pseudo random ADC samples, angles, speeds,
+//!         references and integrator states.  The estimator outputs, Idq_in,
+//!         Vdq_out and the PID states must match bit for bit, Tabc must match
+//!         within the given number of LSB.
+//!
+//!         The versions are timed in alternating blocks of calls, so a change
+//!         of the host load hits both alike.  The median and the minimum time
+//!         per call over the blocks and the median of the fused to chain
+//!         ratio of neighbouring blocks are printed, a single block is too
+//!         noisy on a shared host.  Where the host provides them, the median
+//!         cycle and instruction counts are printed as well.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+// system includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "user.h"
+#include "sw/modules/ctrl/src/32b/ctrl.h"
+#include "sw/modules/est/src/32b/host/est_host.h"
+
+
+// **************************************************************************
+// the defines
+
+#define BENCH_DEFAULT_NUM_VECTORS     (1000000)   // checked vectors
+#define BENCH_DEFAULT_NUM_CALLS       (4000000)   // timed calls per version
+#define BENCH_DEFAULT_NUM_BLOCKS      (201)       // timed blocks per version
+#define BENCH_MAX_NUM_BLOCKS          (10001)
+#define BENCH_NUM_TIMED_INPUTS        (1024)      // must be a power of 2
+#define BENCH_SEED                    (0x2545F491UL)
+
+#define BENCH_MAX_FM_PU               (1.5)       // 1200 Hz electrical, 10.3 krpm
+
+//! \brief Defines the allowed Vab_out and Tabc difference, LSB
+//!
+#define BENCH_DEFAULT_MAX_ERR_LSB     (1)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the inputs of one controller tick
+//!
+typedef struct _BENCH_Input_t_
+{
+  HAL_AdcData_t   adcData;          //!< the ADC data
+  _iq             angle_pu;         //!< the estimated angle
+  _iq             Fm_pu;            //!< the estimated speed
+  _iq             Idq_ref_pu[2];    //!< the Id and Iq references
+  _iq             spd_out_pu;       //!< the speed controller output
+  _iq             Ui_pu[2];         //!< the Id and Iq integrator states
+  bool            flag_speedCtrl;   //!< the speed controller enable
+  bool            flag_dcBusComp;   //!< the DC bus compensation enable
+} BENCH_Input_t;
+
+
+//! \brief Defines the hardware counters of the host
+//!
+typedef struct _BENCH_Counters_t_
+{
+  int             fd_cycles;        //!< the cycle counter, -1 when not available
+  int             fd_instr;         //!< the instruction counter, -1 when not available
+} BENCH_Counters_t;
+
+
+//! \brief Defines the timing results of one version
+//!
+typedef struct _BENCH_Timing_t_
+{
+  double          ns;               //!< the time per call, ns
+  double          minNs;            //!< the shortest time per call of all blocks, ns
+  double          cycles;           //!< the cycles per call, negative when not available
+  double          instr;            //!< the instructions per call, negative when not available
+} BENCH_Timing_t;
+
+
+//! \brief Defines a controller tick function
+//!
+typedef void (*BENCH_CtrlFcn)(CTRL_Handle handle,const HAL_AdcData_t *pAdcData,HAL_PwmData_t *pPwmData);
+
+
+// **************************************************************************
+// the globals
+
+USER_Params gUserParams;
+
+CTRL_Obj gCtrl[2];
+
+//! \brief The estimator outputs returned by the truth function
+//!
+BENCH_Input_t *gpInput;
+
+uint32_t gRandState = BENCH_SEED;
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Returns the next pseudo random number
+//! \return    The next number of a 32-bit xorshift sequence
+static uint32_t BENCH_rand(void)
+{
+  uint32_t x = gRandState;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  gRandState = x;
+
+  return(x);
+} // end of BENCH_rand() function
+
+
+//! \brief     Returns a pseudo random IQ value
+//! \param[in] range  The magnitude of the range, the value is in [-range,range)
+//! \return    The IQ value
+static _iq BENCH_randIq(const float_t range)
+{
+  double x = ((double)BENCH_rand() / 4294967296.0 * 2.0 - 1.0) * range;
+
+  return(_IQ(x));
+} // end of BENCH_randIq() function
+
+
+//! \brief     Returns the estimator outputs of the current vector
+//! \param[in] pArg       Not used
+//! \param[out] pAngle_pu The angle, pu
+//! \param[out] pFm_pu    The speed, pu
+static void BENCH_getTruth(void *pArg,_iq *pAngle_pu,_iq *pFm_pu)
+{
+  *pAngle_pu = gpInput->angle_pu;
+  *pFm_pu = gpInput->Fm_pu;
+
+  return;
+} // end of BENCH_getTruth() function
+
+
+//! \brief     Generates the inputs of one controller tick
+//! \param[out] pInput  The inputs
+static void BENCH_genInput(BENCH_Input_t *pInput)
+{
+  uint_least8_t cnt;
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      pInput->adcData.I.value[cnt] = BENCH_randIq(0.5);
+      pInput->adcData.V.value[cnt] = BENCH_randIq(0.5);
+    }
+
+  pInput->adcData.dcBus = BENCH_randIq(0.5) + _IQ(0.5);
+  pInput->angle_pu = BENCH_randIq(1.0);
+  pInput->Fm_pu = BENCH_randIq(BENCH_MAX_FM_PU);
+  pInput->Idq_ref_pu[0] = BENCH_randIq(0.5);
+  pInput->Idq_ref_pu[1] = BENCH_randIq(0.5);
+  pInput->spd_out_pu = BENCH_randIq(0.5);
+  pInput->Ui_pu[0] = BENCH_randIq(USER_MAX_VS_MAG_PU);
+  pInput->Ui_pu[1] = BENCH_randIq(USER_MAX_VS_MAG_PU);
+  pInput->flag_speedCtrl = (BENCH_rand() & 1) != 0;
+  pInput->flag_dcBusComp = (BENCH_rand() & 2) != 0;
+
+  return;
+} // end of BENCH_genInput() function
+
+
+//! \brief     Loads the inputs that are kept in the controller object
+//! \param[in] handle  The controller (CTRL) handle
+//! \param[in] pInput  The inputs
+static void BENCH_loadCtrl(CTRL_Handle handle,const BENCH_Input_t *pInput)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+  gpInput = (BENCH_Input_t *)pInput;
+
+  CTRL_setId_ref_pu(handle,pInput->Idq_ref_pu[0]);
+  CTRL_setIq_ref_pu(handle,pInput->Idq_ref_pu[1]);
+  CTRL_setSpd_out_pu(handle,pInput->spd_out_pu);
+  CTRL_setFlag_enableSpeedCtrl(handle,pInput->flag_speedCtrl);
+  CTRL_setFlag_enableDcBusComp(handle,pInput->flag_dcBusComp);
+  PID_setUi(obj->pidHandle_Id,pInput->Ui_pu[0]);
+  PID_setUi(obj->pidHandle_Iq,pInput->Ui_pu[1]);
+
+  // run the current controllers every tick and the speed controller never,
+  // the speed controller is the same code in both versions
+  obj->counter_current = obj->numCtrlTicksPerCurrentTick;
+  obj->counter_speed = 0;
+
+  return;
+} // end of BENCH_loadCtrl() function
+
+
+//! \brief     Sets up a controller from the user parameters
+//! \param[in] pCtrl  The controller object
+//! \return    The controller (CTRL) handle
+static CTRL_Handle BENCH_setupCtrl(CTRL_Obj *pCtrl)
+{
+  CTRL_Handle handle = CTRL_initCtrl(0,pCtrl,sizeof(CTRL_Obj));
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+  CTRL_setParams(handle,&gUserParams);
+  CTRL_setFlag_enableCurrentCtrl(handle,true);
+  EST_setTruthFcn(obj->estHandle,BENCH_getTruth,NULL);
+
+  return(handle);
+} // end of BENCH_setupCtrl() function
+
+
+//! \brief     Runs the module chain
+static void __attribute__((noinline)) BENCH_runChain(CTRL_Handle handle,const HAL_AdcData_t *pAdcData,HAL_PwmData_t *pPwmData)
+{
+  CTRL_runOnLine_User(handle,pAdcData,pPwmData);
+
+  return;
+} // end of BENCH_runChain() function
+
+
+//! \brief     Runs the fused current loop
+static void __attribute__((noinline)) BENCH_runFused(CTRL_Handle handle,const HAL_AdcData_t *pAdcData,HAL_PwmData_t *pPwmData)
+{
+  CTRL_runOnLine_UserFused(handle,pAdcData,pPwmData);
+
+  return;
+} // end of BENCH_runFused() function
+
+
+//! \brief     Opens one hardware counter of the calling thread
+//! \param[in] config  The perf event
+//! \return    The file descriptor, -1 when not available
+static int BENCH_openCounter(const uint64_t config)
+{
+#ifdef __linux__
+  struct perf_event_attr attr;
+
+  memset(&attr,0,sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  return((int)syscall(__NR_perf_event_open,&attr,0,-1,-1,0));
+#else
+  return(-1);
+#endif
+} // end of BENCH_openCounter() function
+
+
+//! \brief     Starts or stops a hardware counter
+//! \param[in] fd      The file descriptor
+//! \param[in] enable  true to reset and start, false to stop
+static void BENCH_enableCounter(const int fd,const bool enable)
+{
+#ifdef __linux__
+  if(fd >= 0)
+    {
+      if(enable)
+        {
+          ioctl(fd,PERF_EVENT_IOC_RESET,0);
+          ioctl(fd,PERF_EVENT_IOC_ENABLE,0);
+        }
+      else
+        {
+          ioctl(fd,PERF_EVENT_IOC_DISABLE,0);
+        }
+    }
+#endif
+
+  return;
+} // end of BENCH_enableCounter() function
+
+
+//! \brief     Reads a hardware counter
+//! \param[in] fd  The file descriptor
+//! \return    The count, negative when not available
+static double BENCH_readCounter(const int fd)
+{
+  uint64_t count;
+
+  if((fd < 0) || (read(fd,&count,sizeof(count)) != sizeof(count)))
+    {
+      return(-1.0);
+    }
+
+  return((double)count);
+} // end of BENCH_readCounter() function
+
+
+//! \brief     Returns the monotonic time
+//! \return    The time, ns
+static double BENCH_getTime_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return((double)ts.tv_sec * 1.0e9 + (double)ts.tv_nsec);
+} // end of BENCH_getTime_ns() function
+
+
+//! \brief     Compares two doubles for qsort()
+static int BENCH_compareDouble(const void *pA,const void *pB)
+{
+  double a = *(const double *)pA;
+  double b = *(const double *)pB;
+
+  return((a > b) - (a < b));
+} // end of BENCH_compareDouble() function
+
+
+//! \brief     Returns the median, sorts the values
+//! \param[in] pValues    The values
+//! \param[in] numValues  The number of values
+//! \return    The median
+static double BENCH_median(double *pValues,const uint_least32_t numValues)
+{
+  qsort(pValues,numValues,sizeof(double),BENCH_compareDouble);
+
+  if((numValues & 1) != 0)
+    {
+      return(pValues[numValues / 2]);
+    }
+
+  return((pValues[numValues / 2 - 1] + pValues[numValues / 2]) * 0.5);
+} // end of BENCH_median() function
+
+
+//! \brief     Times one block of calls of one version over the timed inputs
+//! \param[in] handle     The controller (CTRL) handle
+//! \param[in] fcn        The controller tick function
+//! \param[in] pInputs    The timed inputs
+//! \param[in] numCalls   The number of calls
+//! \param[in] pCounters  The hardware counters
+//! \param[out] pTiming   The timing results
+static void BENCH_time(CTRL_Handle handle,const BENCH_CtrlFcn fcn,const BENCH_Input_t *pInputs,
+                       const uint_least32_t numCalls,const BENCH_Counters_t *pCounters,BENCH_Timing_t *pTiming)
+{
+  HAL_PwmData_t pwmData;
+  uint_least32_t cnt;
+  double start_ns;
+
+  BENCH_loadCtrl(handle,&pInputs[0]);
+
+  BENCH_enableCounter(pCounters->fd_cycles,true);
+  BENCH_enableCounter(pCounters->fd_instr,true);
+  start_ns = BENCH_getTime_ns();
+
+  for(cnt=0;cnt<numCalls;cnt++)
+    {
+      CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+      gpInput = (BENCH_Input_t *)&pInputs[cnt & (BENCH_NUM_TIMED_INPUTS - 1)];
+      obj->counter_current = obj->numCtrlTicksPerCurrentTick;
+
+      fcn(handle,&gpInput->adcData,&pwmData);
+    }
+
+  pTiming->ns = (BENCH_getTime_ns() - start_ns) / (double)numCalls;
+  BENCH_enableCounter(pCounters->fd_cycles,false);
+  BENCH_enableCounter(pCounters->fd_instr,false);
+
+  pTiming->cycles = BENCH_readCounter(pCounters->fd_cycles) / (double)numCalls;
+  pTiming->instr = BENCH_readCounter(pCounters->fd_instr) / (double)numCalls;
+
+  return;
+} // end of BENCH_time() function
+
+
+//! \brief     Prints one timing result
+//! \param[in] pName    The name of the version
+//! \param[in] pTiming  The timing results
+static void BENCH_printTiming(const char *pName,const BENCH_Timing_t *pTiming)
+{
+  printf("%-8s %10.1f ns %10.1f ns min",pName,pTiming->ns,pTiming->minNs);
+
+  if(pTiming->cycles >= 0.0)
+    {
+      printf(" %10.1f cycles",pTiming->cycles);
+    }
+  else
+    {
+      printf(" %10s cycles","n/a");
+    }
+
+  if(pTiming->instr >= 0.0)
+    {
+      printf(" %10.1f instr\n",pTiming->instr);
+    }
+  else
+    {
+      printf(" %10s instr\n","n/a");
+    }
+
+  return;
+} // end of BENCH_printTiming() function
+
+
+//! \brief     Prints the usage
+//! \param[in] pName  The program name
+static void BENCH_usage(const char *pName)
+{
+  fprintf(stderr,"usage: %s [-n vectors] [-c calls] [-b blocks] [-e max Tabc error, LSB]\n",pName);
+
+  return;
+} // end of BENCH_usage() function
+
+
+int main(int argc,char *argv[])
+{
+  uint_least32_t numVectors = BENCH_DEFAULT_NUM_VECTORS;
+  uint_least32_t numCalls = BENCH_DEFAULT_NUM_CALLS;
+  uint_least32_t numBlocks = BENCH_DEFAULT_NUM_BLOCKS;
+  long maxErrAllowed_lsb = BENCH_DEFAULT_MAX_ERR_LSB;
+  uint_least32_t numMismatches = 0;
+  uint_least32_t numTabcExact = 0;
+  uint_least32_t hist_lsb[4] = {0,0,0,0};
+  long maxErr_lsb = 0;
+  CTRL_Handle handle[2];
+  BENCH_Input_t *pTimedInputs;
+  BENCH_Counters_t counters;
+  BENCH_Timing_t timing[2];
+  double *pBlocks;
+  double ratio;
+  uint_least32_t cnt;
+  int opt;
+
+
+  while((opt = getopt(argc,argv,"n:c:b:e:")) != -1)
+    {
+      switch(opt)
+        {
+          case 'n':
+            numVectors = strtoul(optarg,NULL,0);
+            break;
+          case 'c':
+            numCalls = strtoul(optarg,NULL,0);
+            break;
+          case 'b':
+            numBlocks = strtoul(optarg,NULL,0);
+            break;
+          case 'e':
+            maxErrAllowed_lsb = strtol(optarg,NULL,0);
+            break;
+          default:
+            BENCH_usage(argv[0]);
+            return(2);
+        }
+    }
+
+  if((numBlocks == 0) || (numBlocks > BENCH_MAX_NUM_BLOCKS) || (numCalls < numBlocks))
+    {
+      BENCH_usage(argv[0]);
+      return(2);
+    }
+
+
+  // set up both controllers, they share the estimator
+  USER_setParams(&gUserParams);
+
+  handle[0] = BENCH_setupCtrl(&gCtrl[0]);
+  handle[1] = BENCH_setupCtrl(&gCtrl[1]);
+
+
+  // check the fused version against the module chain
+  for(cnt=0;cnt<numVectors;cnt++)
+    {
+      CTRL_Obj *chain = (CTRL_Obj *)handle[0];
+      CTRL_Obj *fused = (CTRL_Obj *)handle[1];
+      HAL_PwmData_t pwmData[2];
+      BENCH_Input_t input;
+      bool flag_mismatch = false;
+      long err_lsb = 0;
+      uint_least8_t n;
+
+      BENCH_genInput(&input);
+
+      BENCH_loadCtrl(handle[0],&input);
+      BENCH_runChain(handle[0],&input.adcData,&pwmData[0]);
+
+      BENCH_loadCtrl(handle[1],&input);
+      BENCH_runFused(handle[1],&input.adcData,&pwmData[1]);
+
+      flag_mismatch |= memcmp(&chain->Iab_in,&fused->Iab_in,sizeof(MATH_vec2)) != 0;
+      flag_mismatch |= memcmp(&chain->Vab_in,&fused->Vab_in,sizeof(MATH_vec2)) != 0;
+      flag_mismatch |= memcmp(&chain->Idq_in,&fused->Idq_in,sizeof(MATH_vec2)) != 0;
+      flag_mismatch |= memcmp(&chain->Vdq_out,&fused->Vdq_out,sizeof(MATH_vec2)) != 0;
+      flag_mismatch |= PID_getUi(chain->pidHandle_Id) != PID_getUi(fused->pidHandle_Id);
+      flag_mismatch |= PID_getUi(chain->pidHandle_Iq) != PID_getUi(fused->pidHandle_Iq);
+      flag_mismatch |= PID_getRefValue(chain->pidHandle_Id) != PID_getRefValue(fused->pidHandle_Id);
+      flag_mismatch |= PID_getRefValue(chain->pidHandle_Iq) != PID_getRefValue(fused->pidHandle_Iq);
+      flag_mismatch |= PID_getFbackValue(chain->pidHandle_Id) != PID_getFbackValue(fused->pidHandle_Id);
+      flag_mismatch |= PID_getFbackValue(chain->pidHandle_Iq) != PID_getFbackValue(fused->pidHandle_Iq);
+
+      for(n=0;n<3;n++)
+        {
+          long diff = labs((long)(pwmData[0].Tabc.value[n] - pwmData[1].Tabc.value[n]));
+
+          if(diff > err_lsb)
+            {
+              err_lsb = diff;
+            }
+        }
+
+      for(n=0;n<2;n++)
+        {
+          long diff = labs((long)(chain->Vab_out.value[n] - fused->Vab_out.value[n]));
+
+          if(diff > err_lsb)
+            {
+              err_lsb = diff;
+            }
+        }
+
+      if(flag_mismatch)
+        {
+          numMismatches++;
+        }
+
+      if(err_lsb == 0)
+        {
+          numTabcExact++;
+        }
+
+      hist_lsb[(err_lsb < 3) ? err_lsb : 3]++;
+
+      if(err_lsb > maxErr_lsb)
+        {
+          maxErr_lsb = err_lsb;
+        }
+    }
+
+  printf("vectors            %lu\n",(unsigned long)numVectors);
+  printf("state mismatches   %lu\n",(unsigned long)numMismatches);
+  printf("Vab_out/Tabc exact %lu\n",(unsigned long)numTabcExact);
+  printf("Vab_out/Tabc error 0 LSB %lu, 1 LSB %lu, 2 LSB %lu, >2 LSB %lu, max %ld LSB\n",
+         (unsigned long)hist_lsb[0],(unsigned long)hist_lsb[1],
+         (unsigned long)hist_lsb[2],(unsigned long)hist_lsb[3],maxErr_lsb);
+
+
+  // time both versions on the same inputs
+  pTimedInputs = (BENCH_Input_t *)malloc(sizeof(BENCH_Input_t) * BENCH_NUM_TIMED_INPUTS);
+  pBlocks = (double *)malloc(sizeof(double) * numBlocks * 7);
+
+  if((pTimedInputs == NULL) || (pBlocks == NULL))
+    {
+      fprintf(stderr,"out of memory\n");
+      return(2);
+    }
+
+  for(cnt=0;cnt<BENCH_NUM_TIMED_INPUTS;cnt++)
+    {
+      BENCH_genInput(&pTimedInputs[cnt]);
+    }
+
+#ifdef __linux__
+  counters.fd_cycles = BENCH_openCounter(PERF_COUNT_HW_CPU_CYCLES);
+  counters.fd_instr = BENCH_openCounter(PERF_COUNT_HW_INSTRUCTIONS);
+#else
+  counters.fd_cycles = BENCH_openCounter(0);
+  counters.fd_instr = BENCH_openCounter(0);
+#endif
+
+  // warm up, then time the versions in alternating blocks, every other
+  // block starts with the fused version
+  BENCH_time(handle[0],BENCH_runChain,pTimedInputs,numCalls / 10,&counters,&timing[0]);
+  BENCH_time(handle[1],BENCH_runFused,pTimedInputs,numCalls / 10,&counters,&timing[1]);
+
+  for(cnt=0;cnt<numBlocks;cnt++)
+    {
+      uint_least32_t numBlockCalls = numCalls / numBlocks;
+      uint_least8_t first = cnt & 1;
+      uint_least8_t n;
+
+      BENCH_time(handle[first],first ? BENCH_runFused : BENCH_runChain,
+                 pTimedInputs,numBlockCalls,&counters,&timing[first]);
+      BENCH_time(handle[first ^ 1],first ? BENCH_runChain : BENCH_runFused,
+                 pTimedInputs,numBlockCalls,&counters,&timing[first ^ 1]);
+
+      for(n=0;n<2;n++)
+        {
+          pBlocks[(n * 3 + 0) * numBlocks + cnt] = timing[n].ns;
+          pBlocks[(n * 3 + 1) * numBlocks + cnt] = timing[n].cycles;
+          pBlocks[(n * 3 + 2) * numBlocks + cnt] = timing[n].instr;
+        }
+
+      pBlocks[6 * numBlocks + cnt] = timing[1].ns / timing[0].ns;
+    }
+
+  for(cnt=0;cnt<2;cnt++)
+    {
+      double *pNs = &pBlocks[(cnt * 3 + 0) * numBlocks];
+
+      timing[cnt].ns = BENCH_median(pNs,numBlocks);
+      timing[cnt].minNs = pNs[0];
+      timing[cnt].cycles = BENCH_median(&pBlocks[(cnt * 3 + 1) * numBlocks],numBlocks);
+      timing[cnt].instr = BENCH_median(&pBlocks[(cnt * 3 + 2) * numBlocks],numBlocks);
+    }
+
+  ratio = BENCH_median(&pBlocks[6 * numBlocks],numBlocks);
+
+  printf("per call, median of %lu blocks of %lu calls, including the EST_run() stand-in\n",
+         (unsigned long)numBlocks,(unsigned long)(numCalls / numBlocks));
+  BENCH_printTiming("chain",&timing[0]);
+  BENCH_printTiming("fused",&timing[1]);
+  printf("fused/chain        %.3f median of the block ratios\n",ratio);
+
+  free(pBlocks);
+  free(pTimedInputs);
+
+  if((numMismatches != 0) || (maxErr_lsb > maxErrAllowed_lsb))
+    {
+      printf("FAIL\n");
+      return(1);
+    }
+
+  printf("PASS\n");
+
+  return(0);
+} // end of main() function
+
+
+// end of file
@@ -0,0 +1,911 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   solutions/instaspin_foc/boards/TIDA-00643/host/src/ctrl_regress.c
+//! \brief  Control quality regression benchmark on the simulated TIDA-00643
+//!         power stage and the DJI E300 motor
+//!
+//!         Each case runs the controller configuration of a lab project
+//!         closed loop against the host PMSM model:
+//!
+//!         lab04   torque mode, the speed controller is off and Iq is stepped
+//!         lab05b  speed PI, the speed reference is stepped
+//!         lab09   speed PI with field weakening above the voltage limit,
+//!                 the voltage regulator with the Id feedforward table
+//!         lab10a  speed PI with overmodulation and the svgen_current
+//!                 compensation of lab10a
+//!
+//!         The cases share the HAL, the controller and the estimator
+//!         stand-in of the simulator, every case runs in its own process.
+//!         The step response (rise time, overshoot and steady state error),
+//!         the THD of the phase A current, the torque ripple and the host
+//!         time per ISR tick are written as one CSV line per case.  With a
+//!         baseline file the control quality figures are compared against
+//!         it and a regression fails the run.  The host time depends on the
+//!         host and its load, its column in the baseline is for information
+//!         only and is not compared.
+//!
+//!         The plant is sampled once per ISR tick at the counter zero of the
+//!         PWM, the current THD therefore contains the harmonics of the
+//!         control and the modulation but not the PWM ripple.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+// system includes
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "hal_sim.h"
+#include "sw/modules/est/src/32b/host/est_host.h"
+
+
+// **************************************************************************
+// the defines
+
+#define REG_J_kgm2                  (2.0e-5)    // rotor with a 9 inch propeller
+#define REG_KLOAD_Nmps2             (1.0e-7)    // propeller drag
+
+#define REG_KP_SPD                  (2.000)     // the TIDA-00643 speed controller gains of lab05b
+#define REG_KI_SPD                  (0.059)
+
+#define REG_MAX_ACCEL_KRPMPS        (100.0)     // steep enough for the speed PI to shape the step
+
+#define REG_VS_REF_FRACTION         (0.9)       // field weakening starts at 90% of the maximum voltage
+
+#define REG_OVERMODULATION          (4.0/3.0)   // trapezoidal voltage, see USER_MAX_VS_MAG_PU
+
+#define REG_MIN_WIDTH_usec          (2.0)       // the shunt sampling window of lab10a
+
+#define REG_WINDOW_sec              (0.25)      // the steady state window at the end of a case
+
+#define REG_DEFAULT_TOLERANCE       (0.05)      // relative, 5%
+#define REG_DEFAULT_ABS_TOLERANCE   (0.5)       // absolute, ms or %
+
+#define REG_MAX_LINE_LENGTH         (256)
+
+#define REG_CSV_HEADER  "case,rise_ms,overshoot_pct,sserr_pct,thd_pct,torque_ripple_pct,isr_ns"
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Enumeration of the control modes
+//!
+typedef enum
+{
+  REG_Mode_Torque=0,            //!< Iq reference, no speed controller
+  REG_Mode_Speed,               //!< speed PI
+  REG_Mode_FieldWeakening,      //!< speed PI with field weakening
+  REG_Mode_OverModulation       //!< speed PI with overmodulation
+} REG_Mode_e;
+
+
+//! \brief Defines a benchmark case
+//!
+typedef struct _REG_Case_t_
+{
+  const char     *pName;            //!< the name, the lab project of the configuration
+  REG_Mode_e      mode;             //!< the control mode
+  double          Vdc_V;            //!< the DC bus voltage, V
+  double          ref0;             //!< the reference before the step, A or krpm
+  double          ref1;             //!< the reference after the step, A or krpm
+  double          step_sec;         //!< the time of the step, sec
+  double          duration_sec;     //!< the simulated time, sec
+} REG_Case_t;
+
+
+//! \brief Defines the figures of merit of a case
+//!
+typedef struct _REG_Result_t_
+{
+  double          rise_ms;          //!< the 10% to 90% rise time towards the final value, ms
+  double          overshoot_pct;    //!< the overshoot over the final value, percent of the response
+  double          sserr_pct;        //!< the final value less the reference, percent of the reference step
+  double          thd_pct;          //!< the total harmonic distortion of the phase A current, percent
+  double          torqueRipple_pct; //!< the rms torque ripple, percent of the mean torque
+  double          isr_ns;           //!< the mean host time per ISR tick, ns
+  bool            flag_error;       //!< denotes that the controller went to the error state
+} REG_Result_t;
+
+
+//! \brief Defines the run state of a case
+//!
+typedef struct _REG_Run_t_
+{
+  const REG_Case_t *pCase;          //!< the case
+  bool            flag_truthSet;    //!< denotes that the estimator is connected to the plant
+  bool            flag_stepped;     //!< denotes that the reference has been stepped
+  bool            flag_error;       //!< denotes that the controller went to the error state
+
+  double         *pY;               //!< the step response from the step on, one sample per ISR tick
+  uint_least32_t  numY;             //!< the number of samples of the step response
+  uint_least32_t  maxNumY;          //!< the size of the step response buffer
+
+  uint_least32_t  numSamples;       //!< the number of samples in the window
+  double          sumY;             //!< the sum of the step response
+  double          sumIa;            //!< the sum of the phase A current
+  double          sumIa2;           //!< the sum of the squared phase A current
+  double          sumIaCos;         //!< the correlation of the phase A current with the cosine of the angle
+  double          sumIaSin;         //!< the correlation of the phase A current with the sine of the angle
+  double          sumTe;            //!< the sum of the torque
+  double          sumTe2;           //!< the sum of the squared torque
+} REG_Run_t;
+
+
+// **************************************************************************
+// the globals
+
+//! \brief The benchmark cases
+//!
+static const REG_Case_t gRegCases[] =
+{
+  {"lab04",  REG_Mode_Torque,         11.1, 1.0, 3.0, 0.50, 1.50},
+  {"lab05b", REG_Mode_Speed,          11.1, 3.0, 5.0, 0.50, 1.50},
+  {"lab09",  REG_Mode_FieldWeakening,  7.4, 4.0, 6.0, 0.50, 1.50},
+  {"lab10a", REG_Mode_OverModulation,  7.4, 4.0, 6.0, 0.50, 1.50}
+};
+
+#define REG_NUM_CASES   (sizeof(gRegCases) / sizeof(gRegCases[0]))
+
+USER_Params gUserParams;
+
+HAL_Handle halHandle;
+
+HAL_PwmData_t gPwmData = {_IQ(0.0), _IQ(0.0), _IQ(0.0)};
+
+HAL_AdcData_t gAdcData;
+
+CTRL_Obj ctrl;
+
+CTRL_Handle ctrlHandle;
+
+DRV_SPI_8305_Vars_t gDrvSpi8305Vars;
+
+FW_Obj fw;
+
+FW_Handle fwHandle;
+
+_iq gFwTable[USER_FW_TABLE_SIZE];
+
+SVGENCURRENT_Obj svgencurrent;
+
+SVGENCURRENT_Handle svgencurrentHandle;
+
+uint16_t gMinWidth_counts;
+
+MATH_vec3 gIavg = {_IQ(0.0), _IQ(0.0), _IQ(0.0)};
+
+uint16_t gIavg_shift = 1;
+
+MATH_vec3 gPwmData_prev = {_IQ(0.0), _IQ(0.0), _IQ(0.0)};
+
+_iq gVsRef_pu;
+
+_iq gRef = _IQ(0.0);                // the present reference, pu of current or krpm
+
+REG_Run_t gRegRun;
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Gets the step response of a case
+//! \param[in] pCase        The case
+//! \param[in] plantHandle  The plant handle
+//! \return    The plant Iq in A for torque mode, else the plant speed in krpm
+static double REG_getResponse(const REG_Case_t *pCase,PMSM_SIM_Handle plantHandle)
+{
+  if(pCase->mode == REG_Mode_Torque)
+    {
+      double Idq_A[2];
+
+      PMSM_SIM_getIdq_A(plantHandle,Idq_A);
+
+      return(Idq_A[1]);
+    }
+
+  return(PMSM_SIM_getSpeed_krpm(plantHandle));
+} // end of REG_getResponse() function
+
+
+//! \brief     Sets the reference of the background loop
+//! \param[in] pCase  The case
+//! \param[in] ref    The reference, A or krpm
+static void REG_setRef(const REG_Case_t *pCase,const double ref)
+{
+  if(pCase->mode == REG_Mode_Torque)
+    {
+      gRef = _IQ(ref / USER_IQ_FULL_SCALE_CURRENT_A);
+    }
+  else
+    {
+      gRef = _IQ(ref);
+    }
+
+  return;
+} // end of REG_setRef() function
+
+
+//! \brief     Runs after every ISR tick, steps the reference and collects
+//!            the figures of merit
+//! \param[in] pArg  The run object
+static void REG_tick(void *pArg)
+{
+  REG_Run_t *run = (REG_Run_t *)pArg;
+  const REG_Case_t *pCase = run->pCase;
+  PMSM_SIM_Handle plantHandle = HAL_SIM_getPlantHandle(&halSim);
+  double time_sec = HAL_SIM_getTime_sec(&halSim);
+  double y = REG_getResponse(pCase,plantHandle);
+
+  // the controller is initialized by the background loop, connect the estimator once it exists
+  if((run->flag_truthSet == false) && (ctrlHandle != NULL))
+    {
+      CTRL_Obj *obj = (CTRL_Obj *)ctrlHandle;
+
+      EST_setTruthFcn(obj->estHandle,HAL_SIM_getTruth,&halSim);
+      run->flag_truthSet = true;
+    }
+
+  if((run->flag_stepped == false) && (time_sec >= pCase->step_sec))
+    {
+      REG_setRef(pCase,pCase->ref1);
+      run->flag_stepped = true;
+    }
+
+  if(run->flag_stepped && (run->numY < run->maxNumY))
+    {
+      run->pY[run->numY++] = y;
+    }
+
+  if(time_sec >= (pCase->duration_sec - REG_WINDOW_sec))
+    {
+      double angle_rad = PMSM_SIM_getAngle_rad(plantHandle);
+      double Te_Nm = PMSM_SIM_getTorque_Nm(plantHandle);
+      double Iabc_A[3];
+
+      PMSM_SIM_getIabc_A(plantHandle,Iabc_A);
+
+      run->numSamples++;
+      run->sumY += y;
+      run->sumIa += Iabc_A[0];
+      run->sumIa2 += Iabc_A[0] * Iabc_A[0];
+      run->sumIaCos += Iabc_A[0] * cos(angle_rad);
+      run->sumIaSin += Iabc_A[0] * sin(angle_rad);
+      run->sumTe += Te_Nm;
+      run->sumTe2 += Te_Nm * Te_Nm;
+    }
+
+  if((ctrlHandle != NULL) && CTRL_isError(ctrlHandle))
+    {
+      run->flag_error = true;
+      HAL_SIM_stop(&halSim);
+    }
+
+  if(time_sec >= pCase->duration_sec)
+    {
+      HAL_SIM_stop(&halSim);
+    }
+
+  return;
+} // end of REG_tick() function
+
+
+//! \brief     Sets up the HAL and the controller and runs the background
+//!            loop of the lab projects, one pass per ISR tick
+static void REG_main(void)
+{
+  const REG_Case_t *pCase = gRegRun.pCase;
+  bool flag_setGains = true;
+
+  halHandle = HAL_init(&hal,sizeof(hal));
+
+  USER_setParams(&gUserParams);
+
+  HAL_setParams(halHandle,&gUserParams);
+
+  ctrlHandle = CTRL_initCtrl(0,&ctrl,sizeof(ctrl));
+
+  CTRL_setParams(ctrlHandle,&gUserParams);
+
+
+  // lab09, the field weakening
+  fwHandle = FW_init(&fw,sizeof(fw));
+
+  FW_setFlag_enableFw(fwHandle,pCase->mode == REG_Mode_FieldWeakening);
+  FW_clearCounter(fwHandle);
+  FW_setNumIsrTicksPerFwTick(fwHandle,FW_NUM_ISR_TICKS_PER_CTRL_TICK);
+  FW_setOutput(fwHandle,_IQ(0.0));
+  FW_setMinMax(fwHandle,_IQ(USER_MAX_NEGATIVE_ID_REF_CURRENT_A/USER_IQ_FULL_SCALE_CURRENT_A),_IQ(0.0));
+
+  gVsRef_pu = _IQ(REG_VS_REF_FRACTION * USER_MAX_VS_MAG_PU);
+
+  USER_calcFwFfTable(gFwTable,USER_FW_TABLE_SIZE,USER_FW_MAX_INDEX_PU,REG_VS_REF_FRACTION * USER_MAX_VS_MAG_PU);
+
+  FW_setGains(fwHandle,_IQ(USER_FW_KP),_IQ(USER_FW_KI));
+  FW_setUi(fwHandle,_IQ(0.0));
+  FW_setFfTable(fwHandle,gFwTable,USER_FW_TABLE_SIZE,_IQ((USER_FW_TABLE_SIZE - 1) / USER_FW_MAX_INDEX_PU));
+  FW_setIsMax_pu(fwHandle,_IQ(USER_MOTOR_MAX_CURRENT/USER_IQ_FULL_SCALE_CURRENT_A));
+
+
+  // lab10a, the 100% SVM generator
+  svgencurrentHandle = SVGENCURRENT_init(&svgencurrent,sizeof(svgencurrent));
+
+  {
+    // the PWM data of this HAL spans -1.0 to 1.0, twice the range of lab10a
+    float_t fdutyLimit = 1.0-(4.0*REG_MIN_WIDTH_usec*USER_PWM_FREQ_kHz*0.001);
+
+    gMinWidth_counts = (uint16_t)(REG_MIN_WIDTH_usec * USER_SYSTEM_FREQ_MHz);
+
+    SVGENCURRENT_setMinWidth(svgencurrentHandle,gMinWidth_counts);
+    SVGENCURRENT_setIgnoreShunt(svgencurrentHandle,use_all);
+    SVGENCURRENT_setMode(svgencurrentHandle,all_phase_measurable);
+    SVGENCURRENT_setVlimit(svgencurrentHandle,_IQ(fdutyLimit));
+  }
+
+
+  HAL_setupFaults(halHandle);
+
+  HAL_initIntVectorTable(halHandle);
+
+  HAL_enableAdcInts(halHandle);
+
+  HAL_enableGlobalInts(halHandle);
+
+  HAL_enableDebugInt(halHandle);
+
+  HAL_disablePwm(halHandle);
+
+  HAL_enableDrv(halHandle);
+
+  HAL_setupDrvSpi(halHandle,&gDrvSpi8305Vars);
+
+  CTRL_setFlag_enableDcBusComp(ctrlHandle,true);
+
+  CTRL_setFlag_enableSpeedCtrl(ctrlHandle,pCase->mode != REG_Mode_Torque);
+
+  CTRL_setFlag_enableUserMotorParams(ctrlHandle,true);
+
+  CTRL_setFlag_enableOffset(ctrlHandle,false);
+
+  CTRL_setFlag_enableCtrl(ctrlHandle,true);
+
+
+  for(;;)
+    {
+      CTRL_Obj *obj = (CTRL_Obj *)ctrlHandle;
+
+      // yields to the simulation for one ISR tick, the PWM is disabled during the first
+      HAL_readDrvData(halHandle,&gDrvSpi8305Vars);
+
+      if(CTRL_updateState(ctrlHandle))
+        {
+          CTRL_State_e ctrlState = CTRL_getState(ctrlHandle);
+
+          if(ctrlState == CTRL_State_OnLine)
+            {
+              // the simulated sense amplifiers are biased to the offsets of user.h
+              HAL_setBias(halHandle,HAL_SensorType_Current,0,_IQ(I_A_offset));
+              HAL_setBias(halHandle,HAL_SensorType_Current,1,_IQ(I_B_offset));
+              HAL_setBias(halHandle,HAL_SensorType_Current,2,_IQ(I_C_offset));
+
+              HAL_setBias(halHandle,HAL_SensorType_Voltage,0,_IQ(V_A_offset));
+              HAL_setBias(halHandle,HAL_SensorType_Voltage,1,_IQ(V_B_offset));
+              HAL_setBias(halHandle,HAL_SensorType_Voltage,2,_IQ(V_C_offset));
+            }
+
+          if(ctrlState >= CTRL_State_OffLine)
+            {
+              HAL_enablePwm(halHandle);
+            }
+        }
+
+      if(EST_isMotorIdentified(obj->estHandle))
+        {
+          if(flag_setGains)
+            {
+              flag_setGains = false;
+
+              USER_calcPIgains(ctrlHandle);
+
+              CTRL_setKp(ctrlHandle,CTRL_Type_PID_spd,_IQ(REG_KP_SPD));
+              CTRL_setKi(ctrlHandle,CTRL_Type_PID_spd,_IQ(REG_KI_SPD));
+
+              if(pCase->mode == REG_Mode_OverModulation)
+                {
+                  CTRL_setMaxVsMag_pu(ctrlHandle,_IQ(REG_OVERMODULATION));
+                }
+            }
+
+          if(pCase->mode == REG_Mode_Torque)
+            {
+              CTRL_setIq_ref_pu(ctrlHandle,gRef);
+            }
+          else
+            {
+              CTRL_setSpd_ref_krpm(ctrlHandle,gRef);
+              CTRL_setMaxAccel_pu(ctrlHandle,_IQmpy(MAX_ACCEL_KRPMPS_SF,_IQ(REG_MAX_ACCEL_KRPMPS)));
+            }
+        }
+    }
+} // end of REG_main() function
+
+
+interrupt void mainISR(void)
+{
+  const REG_Case_t *pCase = gRegRun.pCase;
+  SVGENCURRENT_MeasureShunt_e measurableShuntThisCycle = SVGENCURRENT_getMode(svgencurrentHandle);
+
+  // acknowledge the ADC interrupt
+  HAL_acqAdcInt(halHandle,ADC_IntNumber_1);
+
+  // convert the ADC data
+  HAL_readAdcData(halHandle,&gAdcData);
+
+  if(pCase->mode == REG_Mode_OverModulation)
+    {
+      // run the current reconstruction algorithm of lab10a
+      SVGENCURRENT_RunRegenCurrent(svgencurrentHandle,(MATH_vec3 *)(gAdcData.I.value));
+
+      gIavg.value[0] += (gAdcData.I.value[0] - gIavg.value[0])>>gIavg_shift;
+      gIavg.value[1] += (gAdcData.I.value[1] - gIavg.value[1])>>gIavg_shift;
+      gIavg.value[2] += (gAdcData.I.value[2] - gIavg.value[2])>>gIavg_shift;
+
+      if(measurableShuntThisCycle > two_phase_measurable)
+        {
+          gAdcData.I.value[0] = gIavg.value[0];
+          gAdcData.I.value[1] = gIavg.value[1];
+          gAdcData.I.value[2] = gIavg.value[2];
+        }
+    }
+
+  // run the controller
+  CTRL_run(ctrlHandle,halHandle,&gAdcData,&gPwmData);
+
+  if(pCase->mode == REG_Mode_OverModulation)
+    {
+      // run the PWM compensation and current ignore algorithm
+      SVGENCURRENT_compPwmData(svgencurrentHandle,&(gPwmData.Tabc),&gPwmData_prev);
+    }
+
+  // write the PWM compare values
+  HAL_writePwmData(halHandle,&gPwmData);
+
+  if(pCase->mode == REG_Mode_OverModulation)
+    {
+      // set the trigger point in the middle of the low side pulse
+      HAL_setTrigger(halHandle,gMinWidth_counts);
+    }
+
+  if(FW_getFlag_enableFw(fwHandle) == true)
+    {
+      FW_incCounter(fwHandle);
+
+      if(FW_getCounter(fwHandle) > FW_getNumIsrTicksPerFwTick(fwHandle))
+        {
+          CTRL_Obj *obj = (CTRL_Obj *)ctrlHandle;
+          _iq Vd = CTRL_getVd_out_pu(ctrlHandle);
+          _iq Vq = CTRL_getVq_out_pu(ctrlHandle);
+          _iq output;
+
+          FW_clearCounter(fwHandle);
+
+          FW_run_pi(fwHandle,gVsRef_pu,_IQsqrt(_IQmpy(Vd,Vd) + _IQmpy(Vq,Vq)),
+                    EST_getFm_pu(obj->estHandle),EST_getOneOverDcBus_pu(obj->estHandle),&output);
+
+          CTRL_setId_ref_pu(ctrlHandle,output);
+
+          // hand the current left within the maximum over to the speed controller
+          CTRL_setSpdMax(ctrlHandle,FW_getIq_max_pu(fwHandle));
+        }
+    }
+
+  // setup the controller
+  CTRL_setup(ctrlHandle);
+
+  return;
+} // end of mainISR() function
+
+
+interrupt void ecapISR(void)
+{
+
+  // the benchmark has no RC input
+  return;
+} // end of ecapISR() function
+
+
+//! \brief     Runs one case
+//! \param[in] pCase    The case
+//! \param[out] pResult The figures of merit
+static void REG_runCase(const REG_Case_t *pCase,REG_Result_t *pResult)
+{
+  REG_Run_t *run = &gRegRun;
+  PMSM_SIM_Params plantParams;
+  const HAL_SIM_IsrStats *pIsrStats;
+  double step = pCase->ref1 - pCase->ref0;
+  double n;
+
+  memset(run,0,sizeof(REG_Run_t));
+  run->pCase = pCase;
+  run->maxNumY = (uint_least32_t)((pCase->duration_sec - pCase->step_sec) * USER_ISR_FREQ_Hz) + 2;
+  run->pY = (double *)malloc(sizeof(double) * run->maxNumY);
+
+  if(run->pY == NULL)
+    {
+      run->maxNumY = 0;
+    }
+
+  REG_setRef(pCase,pCase->ref0);
+
+  // the plant uses the motor parameters of user.h
+  memset(&plantParams,0,sizeof(plantParams));
+  plantParams.numPolePairs = USER_MOTOR_NUM_POLE_PAIRS;
+  plantParams.Rs_Ohm = USER_MOTOR_Rs;
+  plantParams.Ls_d_H = USER_MOTOR_Ls_d;
+  plantParams.Ls_q_H = USER_MOTOR_Ls_q;
+  plantParams.flux_Wb = USER_MOTOR_RATED_FLUX / MATH_TWO_PI;
+  plantParams.J_kgm2 = REG_J_kgm2;
+  plantParams.B_Nmps = 1.0e-6;
+  plantParams.Kload_Nmps2 = REG_KLOAD_Nmps2;
+  plantParams.Tload_Nm = 0.0;
+  plantParams.Vdiode_V = 0.7;
+
+  HAL_SIM_init(&halSim,sizeof(halSim));
+  HAL_SIM_setPlantParams(&halSim,&plantParams);
+  HAL_SIM_setVdc_V(&halSim,pCase->Vdc_V);
+  HAL_SIM_setRcPulse_usec(&halSim,0.0);
+  HAL_SIM_setTickFcn(&halSim,REG_tick,run);
+
+  // the speed cases start at the initial speed, torque mode from standstill
+  if(pCase->mode != REG_Mode_Torque)
+    {
+      PMSM_SIM_setState(HAL_SIM_getPlantHandle(&halSim),
+                        pCase->ref0 * 1000.0 * MATH_TWO_PI / 60.0,0.0);
+    }
+
+  HAL_SIM_run(&halSim,REG_main);
+
+  pIsrStats = HAL_SIM_getIsrStats(&halSim);
+  n = (run->numSamples > 0) ? (double)run->numSamples : 1.0;
+
+  // the rise time and the overshoot refer to the final value, it falls
+  // short of the reference where the voltage limits the speed
+  {
+    double yFinal = run->sumY / n;
+    double y0 = (run->numY > 0) ? run->pY[0] : 0.0;
+    double delta = yFinal - y0;
+    double max = y0;
+    int_least32_t n10 = -1;
+    int_least32_t n90 = -1;
+    uint_least32_t cnt;
+
+    for(cnt=0;cnt<run->numY;cnt++)
+      {
+        double y = run->pY[cnt];
+
+        if((n10 < 0) && ((y - y0) >= 0.1 * delta))
+          {
+            n10 = (int_least32_t)cnt;
+          }
+
+        if((n90 < 0) && ((y - y0) >= 0.9 * delta))
+          {
+            n90 = (int_least32_t)cnt;
+          }
+
+        if(y > max)
+          {
+            max = y;
+          }
+      }
+
+    pResult->rise_ms = ((delta > 0.0) && (n10 >= 0) && (n90 >= 0)) ?
+                       (double)(n90 - n10) * 1000.0 / USER_ISR_FREQ_Hz : NAN;
+    pResult->overshoot_pct = (delta > 0.0) ? (max - yFinal) / delta * 100.0 : NAN;
+    pResult->sserr_pct = (yFinal - pCase->ref1) / step * 100.0;
+  }
+
+  {
+    double meanIa = run->sumIa / n;
+    double varIa = run->sumIa2 / n - meanIa * meanIa;
+    double a1 = 2.0 * run->sumIaCos / n;
+    double b1 = 2.0 * run->sumIaSin / n;
+    double fund2 = 0.5 * (a1 * a1 + b1 * b1);
+    double harm2 = varIa - fund2;
+
+    pResult->thd_pct = (fund2 > 0.0) ? sqrt((harm2 > 0.0) ? harm2 / fund2 : 0.0) * 100.0 : NAN;
+  }
+
+  {
+    double meanTe = run->sumTe / n;
+    double varTe = run->sumTe2 / n - meanTe * meanTe;
+
+    pResult->torqueRipple_pct = (meanTe != 0.0) ? sqrt((varTe > 0.0) ? varTe : 0.0) / fabs(meanTe) * 100.0 : NAN;
+  }
+
+  pResult->isr_ns = (pIsrStats->numIsrs > 0) ? pIsrStats->total_ns / (double)pIsrStats->numIsrs : NAN;
+  pResult->flag_error = run->flag_error;
+
+  free(run->pY);
+
+  return;
+} // end of REG_runCase() function
+
+
+//! \brief     Runs one case in a child process
+//! \details   The simulated peripherals are static, a new process starts
+//!            every case from the same state
+//! \param[in] pCase    The case
+//! \param[out] pResult The figures of merit
+//! \return    true on success
+static bool REG_forkCase(const REG_Case_t *pCase,REG_Result_t *pResult)
+{
+  int fd[2];
+  pid_t pid;
+  ssize_t numBytes;
+  int status;
+
+  if(pipe(fd) != 0)
+    {
+      perror("pipe");
+      return(false);
+    }
+
+  fflush(stdout);
+
+  pid = fork();
+  if(pid < 0)
+    {
+      perror("fork");
+      return(false);
+    }
+
+  if(pid == 0)
+    {
+      REG_Result_t result;
+
+      close(fd[0]);
+      REG_runCase(pCase,&result);
+      numBytes = write(fd[1],&result,sizeof(result));
+      _exit((numBytes == (ssize_t)sizeof(result)) ? 0 : 1);
+    }
+
+  close(fd[1]);
+  numBytes = read(fd[0],pResult,sizeof(REG_Result_t));
+  close(fd[0]);
+
+  if((waitpid(pid,&status,0) != pid) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0) ||
+     (numBytes != (ssize_t)sizeof(REG_Result_t)))
+    {
+      fprintf(stderr,"%s: the case did not complete\n",pCase->pName);
+      return(false);
+    }
+
+  return(true);
+} // end of REG_forkCase() function
+
+
+//! \brief     Checks one figure of merit against the baseline, lower is better
+//! \param[in] pName      The case name
+//! \param[in] pFigure    The figure name
+//! \param[in] value      The value
+//! \param[in] baseline   The baseline value
+//! \param[in] tolerance  The relative tolerance
+//! \param[in] absTolerance  The absolute tolerance
+//! \return    true when the value is not worse than the baseline
+static bool REG_checkFigure(const char *pName,const char *pFigure,const double value,const double baseline,
+                            const double tolerance,const double absTolerance)
+{
+  double limit = baseline + fabs(baseline) * tolerance + absTolerance;
+
+  if(isnan(baseline))
+    {
+      return(true);
+    }
+
+  if(isnan(value) || (value > limit))
+    {
+      fprintf(stderr,"%s: %s regressed, %.3f > %.3f (baseline %.3f)\n",pName,pFigure,value,limit,baseline);
+      return(false);
+    }
+
+  return(true);
+} // end of REG_checkFigure() function
+
+
+//! \brief     Checks the results against a baseline CSV file
+//! \param[in] pFileName  The baseline file, written by an earlier run
+//! \param[in] pResults   The results of all cases
+//! \param[in] pFlag_run  Denotes for all cases that the case has run
+//! \param[in] tolerance  The relative tolerance
+//! \param[in] absTolerance  The absolute tolerance
+//! \return    The number of regressions, negative when the file cannot be read
+static int REG_checkBaseline(const char *pFileName,const REG_Result_t *pResults,const bool *pFlag_run,
+                             const double tolerance,const double absTolerance)
+{
+  char line[REG_MAX_LINE_LENGTH];
+  int numRegressions = 0;
+  FILE *pFile = fopen(pFileName,"r");
+
+  if(pFile == NULL)
+    {
+      perror(pFileName);
+      return(-1);
+    }
+
+  while(fgets(line,sizeof(line),pFile) != NULL)
+    {
+      char name[32];
+      REG_Result_t base;
+      uint_least8_t cnt;
+
+      if(sscanf(line,"%31[^,],%lf,%lf,%lf,%lf,%lf,%lf",name,&base.rise_ms,&base.overshoot_pct,
+                &base.sserr_pct,&base.thd_pct,&base.torqueRipple_pct,&base.isr_ns) != 7)
+        {
+          continue;
+        }
+
+      for(cnt=0;cnt<REG_NUM_CASES;cnt++)
+        {
+          const REG_Result_t *pResult = &pResults[cnt];
+
+          if(!pFlag_run[cnt] || (strcmp(name,gRegCases[cnt].pName) != 0))
+            {
+              continue;
+            }
+
+          // the steady state error is signed, its magnitude is compared
+          numRegressions += !REG_checkFigure(name,"rise_ms",pResult->rise_ms,base.rise_ms,tolerance,absTolerance);
+          numRegressions += !REG_checkFigure(name,"overshoot_pct",pResult->overshoot_pct,base.overshoot_pct,tolerance,absTolerance);
+          numRegressions += !REG_checkFigure(name,"sserr_pct",fabs(pResult->sserr_pct),fabs(base.sserr_pct),tolerance,absTolerance);
+          numRegressions += !REG_checkFigure(name,"thd_pct",pResult->thd_pct,base.thd_pct,tolerance,absTolerance);
+          numRegressions += !REG_checkFigure(name,"torque_ripple_pct",pResult->torqueRipple_pct,base.torqueRipple_pct,tolerance,absTolerance);
+        }
+    }
+
+  fclose(pFile);
+
+  return(numRegressions);
+} // end of REG_checkBaseline() function
+
+
+//! \brief     Prints the command line options
+//! \param[in] pName  The program name
+static void REG_usage(const char *pName)
+{
+  fprintf(stderr,"usage: %s [-c case] [-b baseline.csv] [-e tolerance] [-a abs tolerance]\n",pName);
+  fprintf(stderr,"  -c  runs only the given case, lab04, lab05b, lab09 or lab10a\n");
+  fprintf(stderr,"  -b  compares against a CSV file written by an earlier run\n");
+  fprintf(stderr,"  -e  relative tolerance of the comparison, default %.2f\n",REG_DEFAULT_TOLERANCE);
+  fprintf(stderr,"  -a  absolute tolerance of the comparison, ms or %%, default %.2f\n",REG_DEFAULT_ABS_TOLERANCE);
+  fprintf(stderr,"the isr_ns column depends on the host and is not compared\n");
+
+  return;
+} // end of REG_usage() function
+
+
+int main(int argc,char *argv[])
+{
+  REG_Result_t results[REG_NUM_CASES];
+  bool flag_run[REG_NUM_CASES];
+  const char *pCaseName = NULL;
+  const char *pBaselineFileName = NULL;
+  double tolerance = REG_DEFAULT_TOLERANCE;
+  double absTolerance = REG_DEFAULT_ABS_TOLERANCE;
+  int status = EXIT_SUCCESS;
+  uint_least8_t cnt;
+  int opt;
+
+  while((opt = getopt(argc,argv,"c:b:e:a:h")) != -1)
+    {
+      switch(opt)
+        {
+          case 'c':
+            pCaseName = optarg;
+            break;
+          case 'b':
+            pBaselineFileName = optarg;
+            break;
+          case 'e':
+            tolerance = atof(optarg);
+            break;
+          case 'a':
+            absTolerance = atof(optarg);
+            break;
+          default:
+            REG_usage(argv[0]);
+            return(EXIT_FAILURE);
+        }
+    }
+
+  printf("%s\n",REG_CSV_HEADER);
+
+  for(cnt=0;cnt<REG_NUM_CASES;cnt++)
+    {
+      const REG_Case_t *pCase = &gRegCases[cnt];
+      REG_Result_t *pResult = &results[cnt];
+
+      memset(pResult,0,sizeof(REG_Result_t));
+      pResult->rise_ms = NAN;
+      pResult->overshoot_pct = NAN;
+      pResult->sserr_pct = NAN;
+      pResult->thd_pct = NAN;
+      pResult->torqueRipple_pct = NAN;
+      pResult->isr_ns = NAN;
+      flag_run[cnt] = false;
+
+      if((pCaseName != NULL) && (strcmp(pCaseName,pCase->pName) != 0))
+        {
+          continue;
+        }
+
+      if(!REG_forkCase(pCase,pResult))
+        {
+          status = EXIT_FAILURE;
+          continue;
+        }
+
+      flag_run[cnt] = true;
+
+      if(pResult->flag_error)
+        {
+          fprintf(stderr,"%s: the controller went to the error state\n",pCase->pName);
+          status = EXIT_FAILURE;
+        }
+
+      printf("%s,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f\n",pCase->pName,
+             pResult->rise_ms,pResult->overshoot_pct,pResult->sserr_pct,
+             pResult->thd_pct,pResult->torqueRipple_pct,pResult->isr_ns);
+    }
+
+  if(pBaselineFileName != NULL)
+    {
+      int numRegressions = REG_checkBaseline(pBaselineFileName,results,flag_run,tolerance,absTolerance);
+
+      if(numRegressions != 0)
+        {
+          status = EXIT_FAILURE;
+        }
+    }
+
+  return(status);
+} // end of main() function
+
+// end of file
@@ -0,0 +1,604 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   solutions/instaspin_foc/boards/TIDA-00643/host/src/ctrl_static_bench.c
+//! \brief  Measures the controller tick CTRL_run() with the run time and with
+//!         the compile time (CTRL_STATIC_CONFIG) controller configuration
+//!
+//!         The file is built twice, once without and once with
+//!         CTRL_STATIC_CONFIG.  The controller is set up from the TIDA-00643
+//!         user parameters, put online and run on a pseudo random sequence
+//!         of ADC samples, angles, speeds and references.  A checksum of the
+//!         PWM outputs and of the controller state is printed with the time
+//!         per tick and, where the host provides them, the cycle and
+//!         instruction counts per tick.  Both builds must print the same
+//!         checksum.
+//!
+//!         The time and the perf counters vary from run to run.  The host
+//!         instructions executed per tick are also counted by single stepping
+//!         a forked copy of the bench over BENCH_NUM_STEPPED_TICKS ticks,
+//!         which gives the same count on every run of the same binary.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+// system includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/ptrace.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#endif
+
+#include "user.h"
+#include "sw/modules/ctrl/src/32b/ctrl.h"
+#include "sw/modules/est/src/32b/host/est_host.h"
+
+
+// **************************************************************************
+// the defines
+
+#define BENCH_DEFAULT_NUM_TICKS       (1000000)   // checked ticks
+#define BENCH_DEFAULT_NUM_CALLS       (4000000)   // timed ticks
+#define BENCH_NUM_TIMED_INPUTS        (1024)      // must be a power of 2
+#define BENCH_NUM_STEPPED_TICKS       (240)       // single stepped ticks, a multiple of the speed decimation
+#define BENCH_SEED                    (0x2545F491UL)
+
+#define BENCH_MAX_FM_PU               (1.5)       // 1200 Hz electrical, 10.3 krpm
+
+#define BENCH_FNV_OFFSET              (2166136261UL)
+#define BENCH_FNV_PRIME               (16777619UL)
+
+#ifdef CTRL_STATIC_CONFIG
+#define BENCH_CONFIG_NAME             "static"
+#else
+#define BENCH_CONFIG_NAME             "dynamic"
+#endif
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the inputs of one controller tick
+//!
+typedef struct _BENCH_Input_t_
+{
+  HAL_AdcData_t   adcData;          //!< the ADC data
+  _iq             angle_pu;         //!< the estimated angle
+  _iq             Fm_pu;            //!< the estimated speed
+} BENCH_Input_t;
+
+
+//! \brief Defines the hardware counters of the host
+//!
+typedef struct _BENCH_Counters_t_
+{
+  int             fd_cycles;        //!< the cycle counter, -1 when not available
+  int             fd_instr;         //!< the instruction counter, -1 when not available
+} BENCH_Counters_t;
+
+
+//! \brief Defines the timing results
+//!
+typedef struct _BENCH_Timing_t_
+{
+  double          ns;               //!< the time per tick, ns
+  double          cycles;           //!< the cycles per tick, negative when not available
+  double          instr;            //!< the instructions per tick, negative when not available
+} BENCH_Timing_t;
+
+
+// **************************************************************************
+// the globals
+
+USER_Params gUserParams;
+
+CTRL_Obj gCtrl;
+
+//! \brief The estimator outputs returned by the truth function
+//!
+BENCH_Input_t *gpInput;
+
+uint32_t gRandState = BENCH_SEED;
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Returns the next pseudo random number
+//! \return    The next number of a 32-bit xorshift sequence
+static uint32_t BENCH_rand(void)
+{
+  uint32_t x = gRandState;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  gRandState = x;
+
+  return(x);
+} // end of BENCH_rand() function
+
+
+//! \brief     Returns a pseudo random IQ value
+//! \param[in] range  The magnitude of the range, the value is in [-range,range)
+//! \return    The IQ value
+static _iq BENCH_randIq(const float_t range)
+{
+  double x = ((double)BENCH_rand() / 4294967296.0 * 2.0 - 1.0) * range;
+
+  return(_IQ(x));
+} // end of BENCH_randIq() function
+
+
+//! \brief     Returns the estimator outputs of the current tick
+//! \param[in] pArg       Not used
+//! \param[out] pAngle_pu The angle, pu
+//! \param[out] pFm_pu    The speed, pu
+static void BENCH_getTruth(void *pArg,_iq *pAngle_pu,_iq *pFm_pu)
+{
+  *pAngle_pu = gpInput->angle_pu;
+  *pFm_pu = gpInput->Fm_pu;
+
+  return;
+} // end of BENCH_getTruth() function
+
+
+//! \brief     Generates the inputs of one controller tick
+//! \param[out] pInput  The inputs
+static void BENCH_genInput(BENCH_Input_t *pInput)
+{
+  uint_least8_t cnt;
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      pInput->adcData.I.value[cnt] = BENCH_randIq(0.5);
+      pInput->adcData.V.value[cnt] = BENCH_randIq(0.5);
+    }
+
+  pInput->adcData.dcBus = BENCH_randIq(0.5) + _IQ(0.5);
+  pInput->angle_pu = BENCH_randIq(1.0);
+  pInput->Fm_pu = BENCH_randIq(BENCH_MAX_FM_PU);
+
+  return;
+} // end of BENCH_genInput() function
+
+
+//! \brief     Sets up the controller from the user parameters and puts it online
+//! \param[in] pCtrl  The controller object
+//! \return    The controller (CTRL) handle
+static CTRL_Handle BENCH_setupCtrl(CTRL_Obj *pCtrl)
+{
+  CTRL_Handle handle = CTRL_initCtrl(0,pCtrl,sizeof(CTRL_Obj));
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+  CTRL_setParams(handle,&gUserParams);
+  CTRL_setFlag_enableCurrentCtrl(handle,true);
+  CTRL_setFlag_enableSpeedCtrl(handle,true);
+  CTRL_setFlag_enableDcBusComp(handle,true);
+  CTRL_setSpd_max_pu(handle,_IQ(0.1));
+  CTRL_setSpd_ref_krpm(handle,_IQ(2.0));
+  EST_setTruthFcn(obj->estHandle,BENCH_getTruth,NULL);
+
+  // the motor parameters are loaded by CTRL_setParams(), go straight online
+  EST_updateState(obj->estHandle,0);
+  CTRL_setState(handle,CTRL_State_OnLine);
+
+  return(handle);
+} // end of BENCH_setupCtrl() function
+
+
+//! \brief     Runs one controller tick
+static void __attribute__((noinline)) BENCH_run(CTRL_Handle handle,const HAL_AdcData_t *pAdcData,HAL_PwmData_t *pPwmData)
+{
+  CTRL_run(handle,NULL,pAdcData,pPwmData);
+
+  return;
+} // end of BENCH_run() function
+
+
+//! \brief     Runs the controller over the timed inputs
+//! \param[in] handle     The controller (CTRL) handle
+//! \param[in] pInputs    The timed inputs
+//! \param[in] numCalls   The number of ticks
+static void __attribute__((noinline)) BENCH_runTicks(CTRL_Handle handle,const BENCH_Input_t *pInputs,
+                                                     const uint_least32_t numCalls)
+{
+  HAL_PwmData_t pwmData;
+  uint_least32_t cnt;
+
+  for(cnt=0;cnt<numCalls;cnt++)
+    {
+      gpInput = (BENCH_Input_t *)&pInputs[cnt & (BENCH_NUM_TIMED_INPUTS - 1)];
+
+      BENCH_run(handle,&gpInput->adcData,&pwmData);
+    }
+
+  return;
+} // end of BENCH_runTicks() function
+
+
+//! \brief     Adds a 32-bit value to a FNV-1a checksum
+//! \param[in] hash   The checksum
+//! \param[in] value  The value
+//! \return    The new checksum
+static uint32_t BENCH_hash(uint32_t hash,const uint32_t value)
+{
+  uint_least8_t cnt;
+
+  for(cnt=0;cnt<4;cnt++)
+    {
+      hash ^= (value >> (8 * cnt)) & 0xFF;
+      hash *= BENCH_FNV_PRIME;
+    }
+
+  return(hash);
+} // end of BENCH_hash() function
+
+
+//! \brief     Opens one hardware counter of the calling thread
+//! \param[in] config  The perf event
+//! \return    The file descriptor, -1 when not available
+static int BENCH_openCounter(const uint64_t config)
+{
+#ifdef __linux__
+  struct perf_event_attr attr;
+
+  memset(&attr,0,sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  return((int)syscall(__NR_perf_event_open,&attr,0,-1,-1,0));
+#else
+  return(-1);
+#endif
+} // end of BENCH_openCounter() function
+
+
+//! \brief     Starts or stops a hardware counter
+//! \param[in] fd      The file descriptor
+//! \param[in] enable  true to reset and start, false to stop
+static void BENCH_enableCounter(const int fd,const bool enable)
+{
+#ifdef __linux__
+  if(fd >= 0)
+    {
+      if(enable)
+        {
+          ioctl(fd,PERF_EVENT_IOC_RESET,0);
+          ioctl(fd,PERF_EVENT_IOC_ENABLE,0);
+        }
+      else
+        {
+          ioctl(fd,PERF_EVENT_IOC_DISABLE,0);
+        }
+    }
+#endif
+
+  return;
+} // end of BENCH_enableCounter() function
+
+
+//! \brief     Reads a hardware counter
+//! \param[in] fd  The file descriptor
+//! \return    The count, negative when not available
+static double BENCH_readCounter(const int fd)
+{
+  uint64_t count;
+
+  if((fd < 0) || (read(fd,&count,sizeof(count)) != sizeof(count)))
+    {
+      return(-1.0);
+    }
+
+  return((double)count);
+} // end of BENCH_readCounter() function
+
+
+//! \brief     Returns the monotonic time
+//! \return    The time, ns
+static double BENCH_getTime_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return((double)ts.tv_sec * 1.0e9 + (double)ts.tv_nsec);
+} // end of BENCH_getTime_ns() function
+
+
+//! \brief     Times the controller tick over the timed inputs
+//! \param[in] handle     The controller (CTRL) handle
+//! \param[in] pInputs    The timed inputs
+//! \param[in] numCalls   The number of ticks
+//! \param[in] pCounters  The hardware counters
+//! \param[out] pTiming   The timing results
+static void BENCH_time(CTRL_Handle handle,const BENCH_Input_t *pInputs,
+                       const uint_least32_t numCalls,const BENCH_Counters_t *pCounters,BENCH_Timing_t *pTiming)
+{
+  double start_ns;
+
+  BENCH_enableCounter(pCounters->fd_cycles,true);
+  BENCH_enableCounter(pCounters->fd_instr,true);
+  start_ns = BENCH_getTime_ns();
+
+  BENCH_runTicks(handle,pInputs,numCalls);
+
+  pTiming->ns = (BENCH_getTime_ns() - start_ns) / (double)numCalls;
+  BENCH_enableCounter(pCounters->fd_cycles,false);
+  BENCH_enableCounter(pCounters->fd_instr,false);
+
+  pTiming->cycles = BENCH_readCounter(pCounters->fd_cycles) / (double)numCalls;
+  pTiming->instr = BENCH_readCounter(pCounters->fd_instr) / (double)numCalls;
+
+  return;
+} // end of BENCH_time() function
+
+
+//! \brief     Counts the instructions executed by a forked copy of the bench
+//!            over a number of ticks by single stepping it
+//! \param[in] handle     The controller (CTRL) handle
+//! \param[in] pInputs    The timed inputs
+//! \param[in] numCalls   The number of ticks
+//! \return    The number of instructions, negative when not available
+static double BENCH_stepTicks(CTRL_Handle handle,const BENCH_Input_t *pInputs,
+                              const uint_least32_t numCalls)
+{
+#ifdef __linux__
+  double count = 0.0;
+  pid_t pid;
+  int status;
+
+  fflush(stdout);
+  pid = fork();
+
+  if(pid < 0)
+    {
+      return(-1.0);
+    }
+
+  if(pid == 0)
+    {
+      // the child stops before and after the ticks, the parent steps in between
+      if(ptrace(PTRACE_TRACEME,0,NULL,NULL) != 0)
+        {
+          _exit(1);
+        }
+
+      raise(SIGSTOP);
+      BENCH_runTicks(handle,pInputs,numCalls);
+      raise(SIGSTOP);
+      _exit(0);
+    }
+
+  if((waitpid(pid,&status,0) != pid) || !WIFSTOPPED(status))
+    {
+      waitpid(pid,&status,0);
+      return(-1.0);
+    }
+
+  for(;;)
+    {
+      if(ptrace(PTRACE_SINGLESTEP,pid,NULL,NULL) != 0)
+        {
+          count = -1.0;
+          break;
+        }
+
+      if((waitpid(pid,&status,0) != pid) || !WIFSTOPPED(status))
+        {
+          return(-1.0);
+        }
+
+      if(WSTOPSIG(status) == SIGSTOP)
+        {
+          break;
+        }
+
+      count += 1.0;
+    }
+
+  kill(pid,SIGKILL);
+  waitpid(pid,&status,0);
+
+  return(count);
+#else
+  return(-1.0);
+#endif
+} // end of BENCH_stepTicks() function
+
+
+//! \brief     Prints the usage
+//! \param[in] pName  The program name
+static void BENCH_usage(const char *pName)
+{
+  fprintf(stderr,"usage: %s [-n checked ticks] [-c timed ticks]\n",pName);
+
+  return;
+} // end of BENCH_usage() function
+
+
+int main(int argc,char *argv[])
+{
+  uint_least32_t numTicks = BENCH_DEFAULT_NUM_TICKS;
+  uint_least32_t numCalls = BENCH_DEFAULT_NUM_CALLS;
+  uint32_t hash = BENCH_FNV_OFFSET;
+  CTRL_Handle handle;
+  CTRL_Obj *obj;
+  BENCH_Input_t *pTimedInputs;
+  BENCH_Counters_t counters;
+  BENCH_Timing_t timing;
+  double instr_stepped;
+  double instr_overhead;
+  uint_least32_t cnt;
+  int opt;
+
+
+  while((opt = getopt(argc,argv,"n:c:")) != -1)
+    {
+      switch(opt)
+        {
+          case 'n':
+            numTicks = strtoul(optarg,NULL,0);
+            break;
+          case 'c':
+            numCalls = strtoul(optarg,NULL,0);
+            break;
+          default:
+            BENCH_usage(argv[0]);
+            return(2);
+        }
+    }
+
+
+  USER_setParams(&gUserParams);
+
+  handle = BENCH_setupCtrl(&gCtrl);
+  obj = (CTRL_Obj *)handle;
+
+
+  // run the checked ticks, the speed controller runs every
+  // USER_NUM_CTRL_TICKS_PER_SPEED_TICK ticks in both builds
+  for(cnt=0;cnt<numTicks;cnt++)
+    {
+      HAL_PwmData_t pwmData;
+      BENCH_Input_t input;
+      uint_least8_t n;
+
+      BENCH_genInput(&input);
+      gpInput = &input;
+
+      BENCH_run(handle,&input.adcData,&pwmData);
+
+      for(n=0;n<3;n++)
+        {
+          hash = BENCH_hash(hash,(uint32_t)pwmData.Tabc.value[n]);
+        }
+
+      hash = BENCH_hash(hash,(uint32_t)obj->Idq_in.value[0]);
+      hash = BENCH_hash(hash,(uint32_t)obj->Idq_in.value[1]);
+      hash = BENCH_hash(hash,(uint32_t)obj->Vdq_out.value[0]);
+      hash = BENCH_hash(hash,(uint32_t)obj->Vdq_out.value[1]);
+      hash = BENCH_hash(hash,(uint32_t)PID_getUi(obj->pidHandle_spd));
+      hash = BENCH_hash(hash,(uint32_t)CTRL_getIq_ref_pu(handle));
+    }
+
+  printf("config    %s\n",BENCH_CONFIG_NAME);
+  printf("ticks     %lu\n",(unsigned long)numTicks);
+  printf("checksum  %08lx\n",(unsigned long)hash);
+
+
+  // time the controller tick
+  pTimedInputs = (BENCH_Input_t *)malloc(sizeof(BENCH_Input_t) * BENCH_NUM_TIMED_INPUTS);
+
+  if(pTimedInputs == NULL)
+    {
+      fprintf(stderr,"out of memory\n");
+      return(2);
+    }
+
+  for(cnt=0;cnt<BENCH_NUM_TIMED_INPUTS;cnt++)
+    {
+      BENCH_genInput(&pTimedInputs[cnt]);
+    }
+
+#ifdef __linux__
+  counters.fd_cycles = BENCH_openCounter(PERF_COUNT_HW_CPU_CYCLES);
+  counters.fd_instr = BENCH_openCounter(PERF_COUNT_HW_INSTRUCTIONS);
+#else
+  counters.fd_cycles = BENCH_openCounter(0);
+  counters.fd_instr = BENCH_openCounter(0);
+#endif
+
+  // warm up, then time
+  BENCH_time(handle,pTimedInputs,numCalls / 10,&counters,&timing);
+  BENCH_time(handle,pTimedInputs,numCalls,&counters,&timing);
+
+  printf("per tick  %10.1f ns",timing.ns);
+
+  if(timing.cycles >= 0.0)
+    {
+      printf(" %10.1f cycles",timing.cycles);
+    }
+  else
+    {
+      printf(" %10s cycles","n/a");
+    }
+
+  if(timing.instr >= 0.0)
+    {
+      printf(" %10.1f instr\n",timing.instr);
+    }
+  else
+    {
+      printf(" %10s instr\n","n/a");
+    }
+
+  // count the instructions of the stepped ticks, less those of stopping
+  // and starting the child
+  instr_overhead = BENCH_stepTicks(handle,pTimedInputs,0);
+  instr_stepped = BENCH_stepTicks(handle,pTimedInputs,BENCH_NUM_STEPPED_TICKS);
+
+  if((instr_overhead >= 0.0) && (instr_stepped >= 0.0))
+    {
+      printf("stepped   %10.1f instr per tick over %d ticks\n",
+             (instr_stepped - instr_overhead) / (double)BENCH_NUM_STEPPED_TICKS,
+             BENCH_NUM_STEPPED_TICKS);
+    }
+  else
+    {
+      printf("stepped   %10s instr per tick\n","n/a");
+    }
+
+  free(pTimedInputs);
+
+  return(0);
+} // end of main() function
+
+
+// end of file
@@ -0,0 +1,1177 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   solutions/instaspin_foc/boards/TIDA-00643/host/src/sim.c
+//! \brief  Runs a lab project closed loop against the simulated TIDA-00643
+//!         power stage and the DJI E300 motor
+//!
+//!         The project is compiled unchanged with its main() renamed to
+//!         proj_main().  The RC servo input, or the DShot input of a
+//!         project built with DSHOT_ENABLE, commands the speed, the
+//!         simulation logs the plant and the controller to a CSV file and
+//!         prints a summary at the end of the run.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+// system includes
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "hal_sim.h"
+#include "sw/modules/est/src/32b/host/est_host.h"
+
+
+// **************************************************************************
+// the defines
+
+#define SIM_DEFAULT_DURATION_sec    (3.0)       // simulated time
+#define SIM_DEFAULT_RC_PULSE_usec   (1500.0)    // 50% speed command
+#define SIM_DEFAULT_VDC_V           (11.1)      // 3S LiPo
+#define SIM_DEFAULT_J_kgm2          (2.0e-5)    // rotor with a 9 inch propeller
+#define SIM_DEFAULT_KLOAD_Nmps2     (1.0e-7)    // propeller drag
+#define SIM_DEFAULT_COG_PERIODS     (84)        // 12 slots and 14 poles
+#define SIM_DEFAULT_LOG_DECIMATION  (15)        // log at 1 kHz
+
+#define SIM_SETTLE_FRACTION         (0.5)       // the statistics use the last half of the run
+
+#define SIM_SPIN_PEAK_WINDOW_sec    (0.02)      // the window of the peak current after a windmilling start
+#define SIM_SPIN_RESYNC_FRACTION    (0.05)      // the speed error of a resynchronized windmilling rotor
+#define SIM_STEP_SETTLE_FRACTION    (0.05)      // the speed error of a rotor settled after an RC step
+#define SIM_DEFAULT_RBAT_ohm        (0.02)      // 3S LiPo internal resistance
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the simulation run options and statistics
+//!
+typedef struct _SIM_Run_t_
+{
+  double          duration_sec;     //!< the simulated time, sec
+  double          rcPulse_usec;     //!< the RC pulse width, usec
+  double          rcLoss_sec;       //!< the time the RC signal is lost, sec, zero to keep it
+  double          rcStep_sec;       //!< the time the RC pulse width steps, sec, zero to keep it
+  double          rcStepPulse_usec; //!< the RC pulse width after the step, usec
+  double          rcReturn_sec;     //!< the time the RC pulse width returns to the one before the step, sec, zero to keep it
+  double          rcStepRef_krpm;   //!< the speed reference at the step, krpm
+  bool            flag_rcStepRef;   //!< denotes that the speed reference followed the step
+  double          rcStepSettle_sec; //!< the time the speed settled after the step, sec, negative before
+  uint_least32_t  logDecimation;    //!< the number of ISR ticks per logged line
+  FILE           *pLogFile;         //!< the CSV log, NULL to disable logging
+
+  bool            flag_truthSet;    //!< denotes that the estimator is connected to the plant
+  uint_least32_t  tickCnt;          //!< the ISR tick counter
+
+  uint_least32_t  numSamples;       //!< the number of samples in the statistics
+  double          sumSpeedErr_krpm; //!< the sum of the speed error, krpm
+  double          sumSpeedErr2_krpm2; //!< the sum of the squared speed error, krpm^2
+  double          sumIq_A;          //!< the sum of Iq, A
+  double          sumIq2_A2;        //!< the sum of the squared Iq, A^2
+  double          sumSpeed_krpm;    //!< the sum of the speed, krpm
+  double          sumSpeed2_krpm2;  //!< the sum of the squared speed, krpm^2
+  double          sumTnet_Nm;       //!< the sum of the torque less the load torque, N*m
+  double          sumTnet2_Nm2;     //!< the sum of the squared torque less the load torque, N*m^2
+  double          sumIa_A;          //!< the sum of the phase A current, A
+  double          sumIa2_A2;        //!< the sum of the squared phase A current, A^2
+  double          sumIaCos_A;       //!< the correlation of the phase A current with the cosine of the angle, A
+  double          sumIaSin_A;       //!< the correlation of the phase A current with the sine of the angle, A
+  uint_least32_t  numSwitchingLegs; //!< the switched legs of the power stage at the start of the statistics
+  double          switchedCurrent_A; //!< the switched current of the power stage at the start of the statistics, A
+#ifdef HFI_ENABLE
+  double          hfiValid_sec;     //!< the time the injection angle became valid, sec, negative before
+  double          hfiHandover_sec;  //!< the time of the first handover to the estimator, sec, negative before
+  uint_least32_t  hfiNumSamples;    //!< the number of ISR ticks on the injection angle
+  double          hfiSumErr2_deg2;  //!< the sum of the squared angle error, deg^2
+  double          hfiMaxErr_deg;    //!< the largest angle error, deg
+#endif
+#ifdef OBS_ENABLE
+  double          obsHandover_sec;  //!< the time of the first handover from the forced angle, sec, negative before
+  uint_least32_t  obsNumSamples;    //!< the number of ISR ticks on the observer angle
+  double          obsSumErr2_deg2;  //!< the sum of the squared angle error, deg^2
+  double          obsMaxErr_deg;    //!< the largest angle error, deg
+#endif
+  double          spinSpeed_krpm;   //!< the initial speed of a windmilling rotor, krpm, zero from rest
+  double          bridgeOn_sec;     //!< the time the bridge first switched, sec, negative before
+  double          spinMinSpeed_krpm; //!< the lowest speed in the direction of the initial spin once the bridge switched, krpm
+  double          spinPeakIs_A;     //!< the largest current magnitude just after the bridge switched, A
+  double          spinResync_sec;   //!< the time the speed first came close to the reference once the bridge switched, sec, negative before
+#ifdef REGEN_ENABLE
+  double          regenPowerMax_W;  //!< the largest braking power reported by the project, W
+#endif
+#ifdef MTPA_ENABLE
+  double          plantLs_q_H;      //!< the quadrature inductance of the plant, H, reported by the estimator
+  double          mtpaSumId_A;      //!< the sum of Id, A
+  double          mtpaSumIs_A;      //!< the sum of the current magnitude, A
+  double          mtpaSumTe_Nm;     //!< the sum of the electromagnetic torque, N*m
+#endif
+} SIM_Run_t;
+
+
+// **************************************************************************
+// the globals
+
+extern volatile MOTOR_Vars_t gMotorVars;
+
+extern CTRL_Handle ctrlHandle;
+
+extern HAL_Handle halHandle;
+
+extern HAL_AdcData_t gAdcData;
+
+extern HAL_PwmData_t gPwmData;
+
+#ifdef ISR_PROF_ENABLE
+extern ISR_PROF_Obj isr_prof;
+#endif
+
+#ifdef TRIGLOG_ENABLE
+extern TRIGLOG_Handle triglogHandle;
+#endif
+
+#ifdef DSHOT_ENABLE
+extern DSHOT_Handle dshotHandle;
+#endif
+
+#ifdef HFI_ENABLE
+extern HFI_Handle hfiHandle;
+#endif
+
+#ifdef OBS_ENABLE
+extern OBS_Handle obsHandle;
+#endif
+
+#ifdef HCOMP_ENABLE
+extern HCOMP_Handle hcompHandle;
+#endif
+
+#ifdef MTPA_ENABLE
+extern MTPA_Handle mtpaHandle;
+#endif
+
+#ifdef REGEN_ENABLE
+extern REGEN_Handle regenHandle;
+
+extern _iq gRegenPower_W;
+
+extern _iq gVdcBusPeak_V;
+#endif
+
+#ifdef MBOX_ENABLE
+extern MBOX_Handle mboxHandle;
+#endif
+
+#ifdef SCHED_ENABLE
+extern SCHED_Handle schedHandle;
+#endif
+
+#ifdef FLREC_ENABLE
+extern FLREC_Handle flrecHandle;
+#endif
+
+#ifdef DPWM_ENABLE
+extern SVGEN_DPWM_Mode_e gDpwmMode;
+
+extern _iq gSwitchingLoss_W;
+
+extern _iq gSwitchingLossSvpwm_W;
+#endif
+
+SIM_Run_t gSimRun;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief The main function of the lab project, renamed at compile time
+//!
+extern void proj_main(void);
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Runs after every ISR tick, connects the estimator, logs and
+//!            collects the statistics
+//! \param[in] pArg  The simulation run object
+static void SIM_tick(void *pArg)
+{
+  SIM_Run_t *run = (SIM_Run_t *)pArg;
+  PMSM_SIM_Handle plantHandle = HAL_SIM_getPlantHandle(&halSim);
+  double time_sec = HAL_SIM_getTime_sec(&halSim);
+  double speed_krpm = PMSM_SIM_getSpeed_krpm(plantHandle);
+  double Idq_A[2];
+
+  // the controller is initialized by the project, connect the estimator once it exists
+  if((run->flag_truthSet == false) && (ctrlHandle != NULL))
+    {
+      CTRL_Obj *obj = (CTRL_Obj *)ctrlHandle;
+
+      EST_setTruthFcn(obj->estHandle,HAL_SIM_getTruth,&halSim);
+#ifdef MTPA_ENABLE
+      // the saliency of the plant takes the place of the motor identification
+      EST_setMotorParams(obj->estHandle,USER_MOTOR_NUM_POLE_PAIRS,USER_MOTOR_RATED_FLUX,
+                         USER_MOTOR_Ls_d,run->plantLs_q_H,USER_MOTOR_Rs);
+#endif
+      run->flag_truthSet = true;
+    }
+
+  PMSM_SIM_getIdq_A(plantHandle,Idq_A);
+
+  // a windmilling rotor is to be taken over without braking or a current spike
+  if(run->spinSpeed_krpm != 0.0)
+    {
+      double spinSign = (run->spinSpeed_krpm > 0.0) ? 1.0 : -1.0;
+      double speedRef_krpm = _IQtoF(gMotorVars.SpeedRef_krpm);
+
+      if((run->bridgeOn_sec < 0.0) && !HAL_SIM_isTripped(&halSim))
+        {
+          run->bridgeOn_sec = time_sec;
+          run->spinMinSpeed_krpm = speed_krpm * spinSign;
+        }
+
+      if(run->bridgeOn_sec >= 0.0)
+        {
+          run->spinMinSpeed_krpm = fmin(run->spinMinSpeed_krpm,speed_krpm * spinSign);
+
+          if(time_sec < run->bridgeOn_sec + SIM_SPIN_PEAK_WINDOW_sec)
+            {
+              run->spinPeakIs_A = fmax(run->spinPeakIs_A,sqrt(Idq_A[0] * Idq_A[0] + Idq_A[1] * Idq_A[1]));
+            }
+
+          if((run->spinResync_sec < 0.0) && (speedRef_krpm != 0.0) &&
+             (fabs(speed_krpm - speedRef_krpm) < SIM_SPIN_RESYNC_FRACTION * fabs(speedRef_krpm)))
+            {
+              run->spinResync_sec = time_sec;
+            }
+        }
+    }
+
+  if((run->rcLoss_sec > 0.0) && (time_sec >= run->rcLoss_sec))
+    {
+      HAL_SIM_setRcPulse_usec(&halSim,0.0);
+      run->rcLoss_sec = 0.0;
+    }
+
+  if((run->rcStep_sec > 0.0) && (time_sec >= run->rcStep_sec))
+    {
+      HAL_SIM_setRcPulse_usec(&halSim,run->rcStepPulse_usec);
+      run->rcStep_sec = -run->rcStep_sec;
+      run->rcStepRef_krpm = _IQtoF(gMotorVars.SpeedRef_krpm);
+    }
+
+  if((run->rcReturn_sec > 0.0) && (time_sec >= run->rcReturn_sec))
+    {
+      HAL_SIM_setRcPulse_usec(&halSim,run->rcPulse_usec);
+      run->rcReturn_sec = 0.0;
+    }
+
+  // the time the rotor takes to follow the step, for a deceleration bounded by the bus
+  if((run->rcStep_sec < 0.0) && (run->rcStepSettle_sec < 0.0))
+    {
+      double speedRef_krpm = _IQtoF(gMotorVars.SpeedRef_krpm);
+
+      if(fabs(speedRef_krpm - run->rcStepRef_krpm) > SIM_STEP_SETTLE_FRACTION * fabs(run->rcStepRef_krpm))
+        {
+          run->flag_rcStepRef = true;
+        }
+
+      if(run->flag_rcStepRef && (fabs(speed_krpm - speedRef_krpm) < SIM_STEP_SETTLE_FRACTION * fabs(speedRef_krpm)))
+        {
+          run->rcStepSettle_sec = time_sec + run->rcStep_sec;
+        }
+    }
+
+#ifdef REGEN_ENABLE
+  run->regenPowerMax_W = fmax(run->regenPowerMax_W,_IQtoF(gRegenPower_W));
+#endif
+
+  if(time_sec >= SIM_SETTLE_FRACTION * run->duration_sec)
+    {
+      double speedErr_krpm = speed_krpm - _IQtoF(gMotorVars.SpeedRef_krpm);
+
+      if(run->numSamples == 0)
+        {
+          run->numSwitchingLegs = HAL_SIM_getNumSwitchingLegs(&halSim);
+          run->switchedCurrent_A = HAL_SIM_getSwitchedCurrent_A(&halSim);
+        }
+
+      run->numSamples++;
+      run->sumSpeedErr_krpm += speedErr_krpm;
+      run->sumSpeedErr2_krpm2 += speedErr_krpm * speedErr_krpm;
+      run->sumIq_A += Idq_A[1];
+      run->sumIq2_A2 += Idq_A[1] * Idq_A[1];
+      run->sumSpeed_krpm += speed_krpm;
+      run->sumSpeed2_krpm2 += speed_krpm * speed_krpm;
+
+      // the torque that accelerates the rotor, its ripple shakes the frame
+      {
+        double Tnet_Nm = PMSM_SIM_getTorque_Nm(plantHandle) - PMSM_SIM_getLoad_Nm(plantHandle);
+
+        run->sumTnet_Nm += Tnet_Nm;
+        run->sumTnet2_Nm2 += Tnet_Nm * Tnet_Nm;
+      }
+
+#ifdef MTPA_ENABLE
+      run->mtpaSumId_A += Idq_A[0];
+      run->mtpaSumIs_A += sqrt(Idq_A[0] * Idq_A[0] + Idq_A[1] * Idq_A[1]);
+      run->mtpaSumTe_Nm += PMSM_SIM_getTorque_Nm(plantHandle);
+#endif
+
+      {
+        double Iabc_A[3];
+        double angle_rad = PMSM_SIM_getAngle_rad(plantHandle);
+
+        PMSM_SIM_getIabc_A(plantHandle,Iabc_A);
+
+        run->sumIa_A += Iabc_A[0];
+        run->sumIa2_A2 += Iabc_A[0] * Iabc_A[0];
+        run->sumIaCos_A += Iabc_A[0] * cos(angle_rad);
+        run->sumIaSin_A += Iabc_A[0] * sin(angle_rad);
+      }
+    }
+
+#ifdef HFI_ENABLE
+  // the angle error of the injection against the plant, electrical degrees
+  if((hfiHandle != NULL) && (HFI_getState(hfiHandle) == HFI_State_Run))
+    {
+      double err_deg = (_IQtoF(HFI_getAngle_pu(hfiHandle)) - PMSM_SIM_getAngle_rad(plantHandle) / MATH_TWO_PI) * 360.0;
+
+      err_deg = fmod(err_deg,360.0);
+      err_deg = (err_deg > 180.0) ? (err_deg - 360.0) : ((err_deg < -180.0) ? (err_deg + 360.0) : err_deg);
+
+      if(run->hfiValid_sec < 0.0)
+        {
+          run->hfiValid_sec = time_sec;
+        }
+
+      run->hfiNumSamples++;
+      run->hfiSumErr2_deg2 += err_deg * err_deg;
+      run->hfiMaxErr_deg = fmax(run->hfiMaxErr_deg,fabs(err_deg));
+    }
+
+  if((hfiHandle != NULL) && (HFI_getState(hfiHandle) == HFI_State_Fast) && (run->hfiHandover_sec < 0.0))
+    {
+      run->hfiHandover_sec = time_sec;
+    }
+#endif
+
+#ifdef OBS_ENABLE
+  // the angle error of the observer against the plant at the sampling instant,
+  // the plant has moved on by one ISR period since, electrical degrees
+#ifdef HFI_ENABLE
+  // the observer runs from standstill, count it once the injection handed over
+  if((obsHandle != NULL) && (hfiHandle != NULL) && (HFI_getState(hfiHandle) == HFI_State_Fast))
+#else
+  if((obsHandle != NULL) && OBS_isAngleValid(obsHandle))
+#endif
+    {
+      double sampleAngle_pu = PMSM_SIM_getAngle_rad(plantHandle) / MATH_TWO_PI - PMSM_SIM_getFe_Hz(plantHandle) / USER_ISR_FREQ_Hz;
+      double err_deg = (_IQtoF(OBS_getPllAngle_pu(obsHandle)) - sampleAngle_pu) * 360.0;
+
+      err_deg = fmod(err_deg,360.0);
+      err_deg = (err_deg > 180.0) ? (err_deg - 360.0) : ((err_deg < -180.0) ? (err_deg + 360.0) : err_deg);
+
+      if(run->obsHandover_sec < 0.0)
+        {
+          run->obsHandover_sec = time_sec;
+        }
+
+      run->obsNumSamples++;
+      run->obsSumErr2_deg2 += err_deg * err_deg;
+      run->obsMaxErr_deg = fmax(run->obsMaxErr_deg,fabs(err_deg));
+    }
+#endif
+
+  if((run->pLogFile != NULL) && ((run->tickCnt % run->logDecimation) == 0))
+    {
+      fprintf(run->pLogFile,"%.6f,%.4f,%.4f,%.4f,%.4f,%.4f,%.6f,%d,%d\n",
+              time_sec,
+              _IQtoF(gMotorVars.SpeedRef_krpm),
+              speed_krpm,
+              Idq_A[0],
+              Idq_A[1],
+              PMSM_SIM_getTorque_Nm(plantHandle),
+              _IQtoF(gAdcData.dcBus) * USER_IQ_FULL_SCALE_VOLTAGE_V,
+              (int)CTRL_getState(ctrlHandle),
+              (int)HAL_SIM_isTripped(&halSim));
+    }
+
+  run->tickCnt++;
+
+  if(time_sec >= run->duration_sec)
+    {
+      HAL_SIM_stop(&halSim);
+    }
+
+  return;
+} // end of SIM_tick() function
+
+
+#ifdef TRIGLOG_ENABLE
+//! \brief     Writes the fault snapshot of the project to a CSV file
+//! \param[in] pFileName  The file name
+static void SIM_writeCapture(const char *pFileName)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)triglogHandle;
+  uint_least16_t numFrames = TRIGLOG_getNumCaptureFrames(triglogHandle);
+  uint_least16_t trigFrame = TRIGLOG_getTrigFrameNumber(triglogHandle);
+  uint_least16_t frameNumber,channelNumber;
+  FILE *pFile;
+
+  if(numFrames == 0)
+    {
+      fprintf(stderr,"%s: no fault snapshot, logger state %d\n",pFileName,(int)TRIGLOG_getState(triglogHandle));
+      return;
+    }
+
+  pFile = fopen(pFileName,"w");
+  if(pFile == NULL)
+    {
+      perror(pFileName);
+      return;
+    }
+
+  fprintf(pFile,"# trigger source %u, value %ld, at ISR %lu\n",
+          (unsigned)TRIGLOG_getTrigSource(triglogHandle),
+          (long)TRIGLOG_getTrigValue(triglogHandle),
+          (unsigned long)TRIGLOG_getTrigCallCnt(triglogHandle));
+  fprintf(pFile,"time_ms");
+  for(channelNumber=0;channelNumber<obj->numChannels;channelNumber++)
+    {
+      fprintf(pFile,",ch%u",(unsigned)channelNumber);
+    }
+  fprintf(pFile,"\n");
+
+  for(frameNumber=0;frameNumber<numFrames;frameNumber++)
+    {
+      const int32_t *pFrame = TRIGLOG_getCaptureFrame(triglogHandle,frameNumber);
+
+      fprintf(pFile,"%.4f",((int)frameNumber - (int)trigFrame) * obj->decimation * 1000.0 / USER_ISR_FREQ_Hz);
+      for(channelNumber=0;channelNumber<obj->numChannels;channelNumber++)
+        {
+          fprintf(pFile,",%ld",(long)pFrame[channelNumber]);
+        }
+      fprintf(pFile,"\n");
+    }
+
+  fclose(pFile);
+
+  printf("fault snapshot          %u frames, trigger source %u at %.3f s\n",
+         (unsigned)numFrames,(unsigned)TRIGLOG_getTrigSource(triglogHandle),
+         TRIGLOG_getTrigCallCnt(triglogHandle) / (double)USER_ISR_FREQ_Hz);
+
+  return;
+} // end of SIM_writeCapture() function
+#endif
+
+
+//! \brief     Prints the command line options
+//! \param[in] pName  The program name
+#ifdef FLREC_ENABLE
+//! \brief     Loads the flash region of the flight recorder from an image
+//! \details   The image holds 16-bit little endian words, a missing file
+//!            leaves the region erased
+//! \param[in] pFileName  The file name
+static void SIM_loadFlash(const char *pFileName)
+{
+  uint16_t *pFlash = HAL_SIM_getFlashLog(&halSim);
+  FILE *pFile = fopen(pFileName,"rb");
+  uint_least32_t cnt;
+
+  if(pFile == NULL)
+    {
+      return;
+    }
+
+  for(cnt=0;cnt<HAL_SIM_FLASH_LOG_NUM_WORDS;cnt++)
+    {
+      int lo = fgetc(pFile);
+      int hi = fgetc(pFile);
+
+      if((lo == EOF) || (hi == EOF))
+        {
+          break;
+        }
+
+      pFlash[cnt] = (uint16_t)(lo | (hi << 8));
+    }
+
+  fclose(pFile);
+
+  return;
+} // end of SIM_loadFlash() function
+
+
+//! \brief     Saves the flash region of the flight recorder to an image
+//! \param[in] pFileName  The file name
+static void SIM_saveFlash(const char *pFileName)
+{
+  const uint16_t *pFlash = HAL_SIM_getFlashLog(&halSim);
+  FILE *pFile = fopen(pFileName,"wb");
+  uint_least32_t cnt;
+
+  if(pFile == NULL)
+    {
+      perror(pFileName);
+      return;
+    }
+
+  for(cnt=0;cnt<HAL_SIM_FLASH_LOG_NUM_WORDS;cnt++)
+    {
+      fputc(pFlash[cnt] & 0xFF,pFile);
+      fputc(pFlash[cnt] >> 8,pFile);
+    }
+
+  fclose(pFile);
+
+  return;
+} // end of SIM_saveFlash() function
+#endif
+
+
+static void SIM_usage(const char *pName)
+{
+  fprintf(stderr,"usage: %s [-t sec] [-r usec] [-v V] [-l Nm] [-k Nm/(rad/s)^2] [-j kgm2] [-d ticks] [-o file.csv] [-x sec] [-T nsec] [-S V] [-L ratio] [-K 1/A] [-a deg] [-w krpm] [-c Nm] [-n periods] [-b Nm] [-M mode] [-D kbps] [-f Hz] [-B usec] [-N] [-u path] [-s file.csv] [-p file.bin] [-F file.bin] [-G sec] [-y sec] [-Y usec] [-R sec] [-C uF] [-z sec]\n",pName);
+  fprintf(stderr,"  -t  simulated time, default %.1f s\n",SIM_DEFAULT_DURATION_sec);
+  fprintf(stderr,"  -r  RC pulse width, 1000 to 2000 usec, 0 for no signal, default %.0f usec\n",SIM_DEFAULT_RC_PULSE_usec);
+  fprintf(stderr,"  -v  DC bus voltage, default %.1f V\n",SIM_DEFAULT_VDC_V);
+  fprintf(stderr,"  -l  constant load torque, default 0 Nm\n");
+  fprintf(stderr,"  -k  propeller load coefficient, default %g Nm/(rad/s)^2\n",SIM_DEFAULT_KLOAD_Nmps2);
+  fprintf(stderr,"  -j  rotor and load inertia, default %g kgm2\n",SIM_DEFAULT_J_kgm2);
+  fprintf(stderr,"  -d  ISR ticks per logged line, default %d\n",SIM_DEFAULT_LOG_DECIMATION);
+  fprintf(stderr,"  -o  CSV log file\n");
+  fprintf(stderr,"  -x  time the RC signal is lost, sec\n");
+  fprintf(stderr,"  -T  inverter dead time, default 0 nsec\n");
+  fprintf(stderr,"  -S  switch on state voltage drop, default 0 V\n");
+  fprintf(stderr,"  -L  plant saliency, Lq over Ld, default 1\n");
+  fprintf(stderr,"  -K  plant direct axis saturation, drop of the incremental Ld per A of Id, default 0 1/A\n");
+  fprintf(stderr,"  -a  initial electrical rotor angle, default 0 deg\n");
+  fprintf(stderr,"  -w  initial speed of a windmilling rotor, negative in reverse, default 0 krpm\n");
+  fprintf(stderr,"  -c  plant cogging torque amplitude, default 0 Nm\n");
+  fprintf(stderr,"  -n  cogging periods per mechanical revolution, default %d\n",SIM_DEFAULT_COG_PERIODS);
+  fprintf(stderr,"  -b  once per revolution torque amplitude of an unbalanced load, default 0 Nm\n");
+#ifdef DPWM_ENABLE
+  fprintf(stderr,"  -M  PWM mode above the modulation threshold, 0 SVPWM, 1 to 4 DPWM0 to DPWM3, 5 DPWMMAX, 6 DPWMMIN, default %d\n",(int)USER_DPWM_MODE);
+#endif
+#ifdef DSHOT_ENABLE
+  fprintf(stderr,"  -D  DShot bit rate, 150, 300 or 600 kbps, default %.0f kbps\n",HAL_SIM_DSHOT_BIT_RATE_bps / 1000.0);
+  fprintf(stderr,"  -f  DShot frame rate, default %.0f Hz\n",HAL_SIM_DSHOT_FRAME_RATE_Hz);
+  fprintf(stderr,"  -B  mainISR execution time the eCAP interrupt waits for, default %.0f usec\n",HAL_SIM_ISR_BUSY_sec * 1.0e6);
+  fprintf(stderr,"  -N  the eCAP interrupt does not preempt mainISR, as without HAL_enableIsrNesting()\n");
+#endif
+  fprintf(stderr,"  -u  SCIA output, a file, fifo or terminal such as the pty of telem_decode -p\n");
+#ifdef TRIGLOG_ENABLE
+  fprintf(stderr,"  -s  CSV file of the fault snapshot\n");
+#endif
+#ifdef ISR_PROF_ENABLE
+  fprintf(stderr,"  -p  ISR stage profiler dump, decoded with isr_prof_decode\n");
+#endif
+#ifdef FLREC_ENABLE
+  fprintf(stderr,"  -F  flash image of the flight recorder, loaded before and saved after the run\n");
+#endif
+  fprintf(stderr,"  -G  time the gate driver reports a fault, sec\n");
+  fprintf(stderr,"  -y  time the RC pulse width steps to the width of -Y, sec\n");
+  fprintf(stderr,"  -Y  RC pulse width after the step, default %.0f usec\n",SIM_DEFAULT_RC_PULSE_usec);
+  fprintf(stderr,"  -R  time the RC pulse width returns to the one of -r, for example to start again after a step to 1000 usec, sec\n");
+  fprintf(stderr,"  -C  DC bus capacitance, 0 for a bus held at the battery voltage, default 0 uF\n");
+  fprintf(stderr,"  -z  time the battery is disconnected from a bus with capacitance, sec\n");
+
+  return;
+} // end of SIM_usage() function
+
+
+int main(int argc,char *argv[])
+{
+  SIM_Run_t *run = &gSimRun;
+  PMSM_SIM_Params plantParams;
+  const HAL_SIM_IsrStats *pIsrStats;
+  double Vdc_V = SIM_DEFAULT_VDC_V;
+  const char *pLogFileName = NULL;
+  const char *pProfFileName = NULL;
+  const char *pCaptureFileName = NULL;
+  const char *pSciFileName = NULL;
+  const char *pFlashFileName = NULL;
+  double drvFault_sec = -1.0;
+  double Cbus_uF = 0.0;
+  double batDisconnect_sec = -1.0;
+  int sciFd = -1;
+  double dshotBitRate_bps = HAL_SIM_DSHOT_BIT_RATE_bps;
+  double dshotFrameRate_Hz = HAL_SIM_DSHOT_FRAME_RATE_Hz;
+  double isrBusy_usec = HAL_SIM_ISR_BUSY_sec * 1.0e6;
+  bool flag_isrNesting = true;
+  double deadTime_sec = 0.0;
+  double Vdrop_V = 0.0;
+  double angle_deg = 0.0;
+  double speed_krpm = 0.0;
+  int opt;
+
+  memset(run,0,sizeof(SIM_Run_t));
+  run->duration_sec = SIM_DEFAULT_DURATION_sec;
+  run->rcPulse_usec = SIM_DEFAULT_RC_PULSE_usec;
+  run->logDecimation = SIM_DEFAULT_LOG_DECIMATION;
+  run->bridgeOn_sec = -1.0;
+  run->spinResync_sec = -1.0;
+  run->rcStepPulse_usec = SIM_DEFAULT_RC_PULSE_usec;
+  run->rcStepSettle_sec = -1.0;
+#ifdef HFI_ENABLE
+  run->hfiValid_sec = -1.0;
+  run->hfiHandover_sec = -1.0;
+#endif
+#ifdef OBS_ENABLE
+  run->obsHandover_sec = -1.0;
+#endif
+
+  // the plant uses the motor parameters of user.h
+  memset(&plantParams,0,sizeof(plantParams));
+  plantParams.numPolePairs = USER_MOTOR_NUM_POLE_PAIRS;
+  plantParams.Rs_Ohm = USER_MOTOR_Rs;
+  plantParams.Ls_d_H = USER_MOTOR_Ls_d;
+  plantParams.Ls_q_H = USER_MOTOR_Ls_q;
+  plantParams.flux_Wb = USER_MOTOR_RATED_FLUX / MATH_TWO_PI;
+  plantParams.J_kgm2 = SIM_DEFAULT_J_kgm2;
+  plantParams.B_Nmps = 1.0e-6;
+  plantParams.Kload_Nmps2 = SIM_DEFAULT_KLOAD_Nmps2;
+  plantParams.Tload_Nm = 0.0;
+  plantParams.Vdiode_V = 0.7;
+  plantParams.numCogPeriods = SIM_DEFAULT_COG_PERIODS;
+
+  while((opt = getopt(argc,argv,"t:r:v:l:k:j:d:o:x:T:S:L:K:a:w:c:n:b:M:D:f:B:Nu:s:p:F:G:y:Y:R:C:z:h")) != -1)
+    {
+      switch(opt)
+        {
+          case 't':
+            run->duration_sec = atof(optarg);
+            break;
+          case 'r':
+            run->rcPulse_usec = atof(optarg);
+            break;
+          case 'v':
+            Vdc_V = atof(optarg);
+            break;
+          case 'l':
+            plantParams.Tload_Nm = atof(optarg);
+            break;
+          case 'k':
+            plantParams.Kload_Nmps2 = atof(optarg);
+            break;
+          case 'j':
+            plantParams.J_kgm2 = atof(optarg);
+            break;
+          case 'd':
+            run->logDecimation = (uint_least32_t)atoi(optarg);
+            if(run->logDecimation == 0)
+              {
+                run->logDecimation = 1;
+              }
+            break;
+          case 'o':
+            pLogFileName = optarg;
+            break;
+          case 'x':
+            run->rcLoss_sec = atof(optarg);
+            break;
+          case 'T':
+            deadTime_sec = atof(optarg) * 1.0e-9;
+            break;
+          case 'S':
+            Vdrop_V = atof(optarg);
+            break;
+          case 'L':
+            plantParams.Ls_q_H = USER_MOTOR_Ls_d * atof(optarg);
+            break;
+          case 'K':
+            plantParams.satCoeff_1pA = atof(optarg);
+            break;
+          case 'a':
+            angle_deg = atof(optarg);
+            break;
+          case 'w':
+            speed_krpm = atof(optarg);
+            break;
+          case 'c':
+            plantParams.Tcog_Nm = atof(optarg);
+            break;
+          case 'n':
+            plantParams.numCogPeriods = (uint_least16_t)atoi(optarg);
+            break;
+          case 'b':
+            plantParams.Timb_Nm = atof(optarg);
+            break;
+          case 'M':
+#ifdef DPWM_ENABLE
+            gDpwmMode = (SVGEN_DPWM_Mode_e)atoi(optarg);
+#endif
+            break;
+          case 'D':
+            dshotBitRate_bps = atof(optarg) * 1000.0;
+            break;
+          case 'f':
+            dshotFrameRate_Hz = atof(optarg);
+            break;
+          case 'B':
+            isrBusy_usec = atof(optarg);
+            break;
+          case 'N':
+            flag_isrNesting = false;
+            break;
+          case 'u':
+            pSciFileName = optarg;
+            break;
+          case 's':
+            pCaptureFileName = optarg;
+            break;
+          case 'p':
+            pProfFileName = optarg;
+            break;
+          case 'F':
+            pFlashFileName = optarg;
+            break;
+          case 'G':
+            drvFault_sec = atof(optarg);
+            break;
+          case 'y':
+            run->rcStep_sec = atof(optarg);
+            break;
+          case 'Y':
+            run->rcStepPulse_usec = atof(optarg);
+            break;
+          case 'R':
+            run->rcReturn_sec = atof(optarg);
+            break;
+          case 'C':
+            Cbus_uF = atof(optarg);
+            break;
+          case 'z':
+            batDisconnect_sec = atof(optarg);
+            break;
+          default:
+            SIM_usage(argv[0]);
+            return(EXIT_FAILURE);
+        }
+    }
+
+  // a frame is 16 bits, the frames need a gap
+  if((dshotBitRate_bps <= 0.0) || (dshotFrameRate_Hz <= 0.0) ||
+     ((dshotFrameRate_Hz * 20.0) > dshotBitRate_bps))
+    {
+      fprintf(stderr,"invalid DShot bit rate or frame rate\n");
+      return(EXIT_FAILURE);
+    }
+
+  if(pLogFileName != NULL)
+    {
+      run->pLogFile = fopen(pLogFileName,"w");
+      if(run->pLogFile == NULL)
+        {
+          perror(pLogFileName);
+          return(EXIT_FAILURE);
+        }
+
+      fprintf(run->pLogFile,"time_s,speedRef_krpm,speed_krpm,Id_A,Iq_A,Te_Nm,Vdc_V,ctrlState,tripped\n");
+    }
+
+  if(pSciFileName != NULL)
+    {
+      sciFd = open(pSciFileName,O_WRONLY | O_CREAT | O_TRUNC | O_NOCTTY | O_NONBLOCK,0644);
+      if(sciFd < 0)
+        {
+          perror(pSciFileName);
+          return(EXIT_FAILURE);
+        }
+
+      // a terminal passes the bytes unchanged
+      if(isatty(sciFd))
+        {
+          struct termios tio;
+
+          if(tcgetattr(sciFd,&tio) == 0)
+            {
+              cfmakeraw(&tio);
+              tcsetattr(sciFd,TCSANOW,&tio);
+            }
+        }
+    }
+
+  HAL_SIM_init(&halSim,sizeof(halSim));
+  HAL_SIM_setSciOutput(&halSim,sciFd);
+  HAL_SIM_setPlantParams(&halSim,&plantParams);
+#ifdef MTPA_ENABLE
+  run->plantLs_q_H = plantParams.Ls_q_H;
+#endif
+  run->spinSpeed_krpm = speed_krpm;
+  PMSM_SIM_setState(HAL_SIM_getPlantHandle(&halSim),speed_krpm * 1000.0 * MATH_TWO_PI / 60.0,angle_deg * MATH_TWO_PI / 360.0);
+  HAL_SIM_setVdc_V(&halSim,Vdc_V);
+  HAL_SIM_setInverter(&halSim,deadTime_sec,Vdrop_V);
+  HAL_SIM_setRcPulse_usec(&halSim,run->rcPulse_usec);
+  HAL_SIM_setDshot(&halSim,dshotBitRate_bps,dshotFrameRate_Hz);
+  HAL_SIM_setIsrLatency(&halSim,isrBusy_usec * 1.0e-6,flag_isrNesting);
+  HAL_SIM_setTickFcn(&halSim,SIM_tick,run);
+  HAL_SIM_setDrvFault_sec(&halSim,drvFault_sec);
+  HAL_SIM_setBus(&halSim,Cbus_uF * 1.0e-6,SIM_DEFAULT_RBAT_ohm,batDisconnect_sec);
+
+  if(pFlashFileName != NULL)
+    {
+#ifdef FLREC_ENABLE
+      SIM_loadFlash(pFlashFileName);
+#else
+      fprintf(stderr,"%s: built without FLREC_ENABLE, no flash image\n",pFlashFileName);
+#endif
+    }
+
+  // run the project until the simulated time has elapsed
+  HAL_SIM_run(&halSim,proj_main);
+
+  if(run->pLogFile != NULL)
+    {
+      fclose(run->pLogFile);
+    }
+
+  if(sciFd >= 0)
+    {
+      close(sciFd);
+    }
+
+  if(pProfFileName != NULL)
+    {
+#ifdef ISR_PROF_ENABLE
+      // the statistics block, 32-bit little endian words
+      FILE *pProfFile = fopen(pProfFileName,"wb");
+
+      if((pProfFile == NULL) ||
+         (fwrite(&isr_prof,sizeof(uint32_t),ISR_PROF_NUM_BLOCK_WORDS,pProfFile) != ISR_PROF_NUM_BLOCK_WORDS))
+        {
+          perror(pProfFileName);
+        }
+
+      if(pProfFile != NULL)
+        {
+          fclose(pProfFile);
+        }
+#else
+      fprintf(stderr,"%s: built without ISR_PROF_ENABLE, no profiler dump\n",pProfFileName);
+#endif
+    }
+
+  if(pCaptureFileName != NULL)
+    {
+#ifdef TRIGLOG_ENABLE
+      SIM_writeCapture(pCaptureFileName);
+#else
+      fprintf(stderr,"%s: built without TRIGLOG_ENABLE, no fault snapshot\n",pCaptureFileName);
+#endif
+    }
+
+#ifdef FLREC_ENABLE
+  if(pFlashFileName != NULL)
+    {
+      SIM_saveFlash(pFlashFileName);
+    }
+#endif
+
+  pIsrStats = HAL_SIM_getIsrStats(&halSim);
+
+  printf("simulated time          %.3f s\n",HAL_SIM_getTime_sec(&halSim));
+  printf("speed reference         %.4f krpm\n",_IQtoF(gMotorVars.SpeedRef_krpm));
+  printf("plant speed             %.4f krpm\n",PMSM_SIM_getSpeed_krpm(HAL_SIM_getPlantHandle(&halSim)));
+  printf("controller state        %d\n",(int)CTRL_getState(ctrlHandle));
+
+  if(run->numSamples > 0)
+    {
+      double n = (double)run->numSamples;
+      double meanErr = run->sumSpeedErr_krpm / n;
+      double meanIq = run->sumIq_A / n;
+      double varIq = run->sumIq2_A2 / n - meanIq * meanIq;
+
+      printf("speed error mean        %.4f krpm\n",meanErr);
+      printf("speed error rms         %.4f krpm\n",sqrt(run->sumSpeedErr2_krpm2 / n));
+      printf("Iq mean                 %.4f A\n",meanIq);
+      printf("Iq ripple rms           %.4f A\n",sqrt((varIq > 0.0) ? varIq : 0.0));
+
+      {
+        double meanSpeed = run->sumSpeed_krpm / n;
+        double varSpeed = run->sumSpeed2_krpm2 / n - meanSpeed * meanSpeed;
+        double meanTnet = run->sumTnet_Nm / n;
+        double varTnet = run->sumTnet2_Nm2 / n - meanTnet * meanTnet;
+
+        printf("speed ripple rms        %.3f rpm\n",sqrt((varSpeed > 0.0) ? varSpeed : 0.0) * 1000.0);
+        printf("net torque ripple rms   %.3f mNm\n",sqrt((varTnet > 0.0) ? varTnet : 0.0) * 1000.0);
+      }
+
+      // the fundamental of Ia from the correlation with the plant angle,
+      // everything else is distortion and ripple
+      {
+        double meanIa = run->sumIa_A / n;
+        double varIa = run->sumIa2_A2 / n - meanIa * meanIa;
+        double a1 = 2.0 * run->sumIaCos_A / n;
+        double b1 = 2.0 * run->sumIaSin_A / n;
+        double fund2 = 0.5 * (a1 * a1 + b1 * b1);
+        double harm2 = varIa - fund2;
+
+        if(fund2 > 0.0)
+          {
+            printf("Ia fundamental rms      %.4f A\n",sqrt(fund2));
+            printf("Ia THD                  %.2f %%\n",sqrt((harm2 > 0.0) ? harm2 / fund2 : 0.0) * 100.0);
+          }
+      }
+
+      // the switching loss is about proportional to the switched current
+      {
+        double numPwmPeriods = n * USER_NUM_PWM_TICKS_PER_ISR_TICK;
+
+        printf("switched legs           %.3f per PWM period\n",
+               (double)(HAL_SIM_getNumSwitchingLegs(&halSim) - run->numSwitchingLegs) / numPwmPeriods);
+        printf("switched current        %.4f A per PWM period\n",
+               (HAL_SIM_getSwitchedCurrent_A(&halSim) - run->switchedCurrent_A) / numPwmPeriods);
+      }
+    }
+
+#ifdef HFI_ENABLE
+  if(run->hfiValid_sec >= 0.0)
+    {
+      printf("HFI angle valid at      %.3f s, polarity %s\n",
+             run->hfiValid_sec,HFI_getFlag_polarityFlipped(hfiHandle) ? "turned 180 deg" : "kept");
+      printf("HFI angle error rms     %.2f deg, max %.2f deg electrical\n",
+             sqrt(run->hfiSumErr2_deg2 / (double)run->hfiNumSamples),run->hfiMaxErr_deg);
+    }
+  else
+    {
+      printf("HFI angle valid at      never, state %d\n",(int)HFI_getState(hfiHandle));
+    }
+
+  if(run->hfiHandover_sec >= 0.0)
+    {
+      printf("HFI handover at         %.3f s\n",run->hfiHandover_sec);
+    }
+#endif
+
+#ifdef OBS_ENABLE
+  if(run->obsHandover_sec >= 0.0)
+    {
+      printf("OBS handover at         %.3f s\n",run->obsHandover_sec);
+      printf("OBS angle error rms     %.2f deg, max %.2f deg electrical\n",
+             sqrt(run->obsSumErr2_deg2 / (double)run->obsNumSamples),run->obsMaxErr_deg);
+    }
+  else
+    {
+      printf("OBS handover at         never, state %d\n",(int)OBS_getState(obsHandle));
+    }
+#endif
+
+#ifdef HCOMP_ENABLE
+  {
+    uint_least16_t num;
+
+    for(num=0;num<HCOMP_getNumHarmonics(hcompHandle);num++)
+      {
+        printf("HCOMP order %-3u         %.4f A learned\n",
+               (unsigned)HCOMP_getOrder(hcompHandle,num),
+               _IQtoF(HCOMP_getAmplitude_pu(hcompHandle,num)) * USER_IQ_FULL_SCALE_CURRENT_A);
+      }
+  }
+#endif
+
+  if(run->spinSpeed_krpm != 0.0)
+    {
+      if(run->bridgeOn_sec >= 0.0)
+        {
+          printf("spin bridge on at       %.4f s\n",run->bridgeOn_sec);
+          printf("spin lowest speed       %.4f krpm in the direction of the spin\n",run->spinMinSpeed_krpm);
+          printf("spin peak current       %.4f A\n",run->spinPeakIs_A);
+        }
+      else
+        {
+          printf("spin bridge on at       never\n");
+        }
+
+      if(run->spinResync_sec >= 0.0)
+        {
+          printf("spin resync at          %.4f s\n",run->spinResync_sec);
+        }
+      else
+        {
+          printf("spin resync at          never\n");
+        }
+    }
+
+  if(run->rcStep_sec != 0.0)
+    {
+      if(run->rcStepSettle_sec >= 0.0)
+        {
+          printf("RC step settled after   %.4f s\n",run->rcStepSettle_sec);
+        }
+      else
+        {
+          printf("RC step settled after   never\n");
+        }
+    }
+
+  if(Cbus_uF > 0.0)
+    {
+      printf("DC bus                  %.3f V, peak %.3f V\n",HAL_SIM_getVdc_V(&halSim),HAL_SIM_getVdcPeak_V(&halSim));
+    }
+
+#ifdef REGEN_ENABLE
+  printf("REGEN bus peak          %.3f V measured, %.1f %% of the regenerative current allowed\n",
+         _IQtoF(gVdcBusPeak_V),_IQtoF(REGEN_getFrac(regenHandle)) * 100.0);
+  printf("REGEN braking power     %.2f W max, %lu ticks limited\n",
+         run->regenPowerMax_W,(unsigned long)REGEN_getNumLimitedTicks(regenHandle));
+#endif
+
+#ifdef MTPA_ENABLE
+  printf("MTPA K                  %.4f A, %s, table %s\n",
+         _IQtoF(MTPA_getK_pu(mtpaHandle)) * USER_IQ_FULL_SCALE_CURRENT_A,
+         MTPA_isSalient(mtpaHandle) ? "salient" : "not salient",
+         MTPA_isTableValid(mtpaHandle) ? "valid" : "not valid");
+
+  if(run->numSamples > 0)
+    {
+      double n = (double)run->numSamples;
+
+      printf("MTPA Id mean            %.4f A, Is mean %.4f A\n",run->mtpaSumId_A / n,run->mtpaSumIs_A / n);
+      printf("MTPA torque per ampere  %.5f Nm/A\n",run->mtpaSumTe_Nm / run->mtpaSumIs_A);
+    }
+#endif
+
+#ifdef MBOX_ENABLE
+  printf("MBOX commands           %lu posted, %lu applied\n",
+         (unsigned long)MBOX_getNumPosts(mboxHandle),
+         (unsigned long)MBOX_getNumTakes(mboxHandle));
+#endif
+
+#ifdef SCHED_ENABLE
+  // the times of the tasks include the interrupts, in the simulation only the waits for an ISR tick
+  {
+    double usecPerCnt = 1.0e6 / (double)SCHED_getTimerFreq_Hz(schedHandle);
+    uint_least8_t taskNum;
+
+    for(taskNum=0;taskNum<SCHED_getNumTasks(schedHandle);taskNum++)
+      {
+        const SCHED_Task_t *pTask = SCHED_getTask(schedHandle,taskNum);
+
+        printf("SCHED %-8s %6.0f Hz  %lu runs, %lu overruns, %lu skipped, latest end %.1f usec, load %.3f %%\n",
+               pTask->pName,
+               (double)SCHED_getTimerFreq_Hz(schedHandle) / (double)pTask->period_cnts,
+               (unsigned long)pTask->numRuns,
+               (unsigned long)pTask->numOverruns,
+               (unsigned long)pTask->numSkipped,
+               (double)pTask->maxLateness_cnts * usecPerCnt,
+               (double)SCHED_getLoad_ppm(schedHandle,taskNum) * 1.0e-4);
+      }
+
+    printf("SCHED load              %.3f %%\n",(double)SCHED_getLoad_ppm(schedHandle,SCHED_MAX_TASKS) * 1.0e-4);
+  }
+#endif
+
+#ifdef FLREC_ENABLE
+  // the times of the records in the CPU timer 0 counts, in the simulation only the held ISR ticks
+  {
+    double usecPerCnt = 1.0 / USER_SYSTEM_FREQ_MHz;
+
+    printf("FLREC records           %u of %u slots, %lu committed, %lu errors, %lu sector erases\n",
+           (unsigned)FLREC_getNumRecords(flrecHandle),
+           (unsigned)FLREC_getNumSlots(flrecHandle),
+           (unsigned long)FLREC_getNumCommits(flrecHandle),
+           (unsigned long)FLREC_getNumErrors(flrecHandle),
+           (unsigned long)HAL_SIM_getFlashNumErases(&halSim));
+    printf("FLREC longest run       %.1f usec, last record %.1f usec\n",
+           (double)FLREC_getMaxRun_cnts(flrecHandle) * usecPerCnt,
+           (double)FLREC_getCommit_cnts(flrecHandle) * usecPerCnt);
+    printf("FLREC ISR ticks held    %lu\n",(unsigned long)HAL_SIM_getNumIsrsHeld(&halSim));
+  }
+#endif
+
+#ifdef DPWM_ENABLE
+  printf("switching loss estimate %.3f W, %.3f W with SVPWM\n",_IQtoF(gSwitchingLoss_W),_IQtoF(gSwitchingLossSvpwm_W));
+#endif
+
+#ifdef DSHOT_ENABLE
+  printf("DShot frames            %lu, %lu CRC errors, %lu frame errors, state %d\n",
+         (unsigned long)DSHOT_getNumFrames(dshotHandle),
+         (unsigned long)DSHOT_getNumCrcErrors(dshotHandle),
+         (unsigned long)DSHOT_getNumFrameErrors(dshotHandle),
+         (int)DSHOT_getState(dshotHandle));
+  printf("DShot eCAP interrupts   %lu, longest latency %.2f usec\n",
+         (unsigned long)HAL_SIM_getCapNumIsrs(&halSim),
+         HAL_SIM_getCapMaxLatency_sec(&halSim) * 1.0e6);
+#ifdef DSHOT_BIDIR_ENABLE
+  {
+    uint16_t reply = DSHOT_decodeReply(HAL_SIM_getDshotReply(&halSim));
+    double plant_erpm = PMSM_SIM_getSpeed_krpm(HAL_SIM_getPlantHandle(&halSim)) * 1000.0 * USER_MOTOR_NUM_POLE_PAIRS;
+
+    printf("DShot replies           %lu, %lu late, %lu underruns\n",
+           (unsigned long)HAL_SIM_getDshotNumReplies(&halSim),
+           (unsigned long)HAL_SIM_getDshotNumRepliesLate(&halSim),
+           (unsigned long)HAL_SIM_getDshotNumReplyUnderruns(&halSim));
+
+    // the period in usec is the 9-bit mantissa shifted by the upper 3 bits
+    if((reply == DSHOT_REPLY_INVALID) || (reply == DSHOT_REPLY_ZERO_SPEED))
+      {
+        printf("DShot last reply        0x%03x, plant %.0f eRPM\n",(unsigned)reply,fabs(plant_erpm));
+      }
+    else
+      {
+        uint32_t period_usec = (uint32_t)(reply & 0x1FF) << (reply >> 9);
+
+        printf("DShot last reply        %lu usec, %.0f eRPM, plant %.0f eRPM\n",
+               (unsigned long)period_usec,60.0e6 / (double)period_usec,fabs(plant_erpm));
+      }
+  }
+#endif
+#endif
+
+  if(HAL_SIM_getSciNumBytes(&halSim) > 0)
+    {
+      printf("SCIA bytes sent         %lu, %lu not taken by the output\n",
+             (unsigned long)HAL_SIM_getSciNumBytes(&halSim),
+             (unsigned long)HAL_SIM_getSciNumDropped(&halSim));
+    }
+
+  if(pIsrStats->numIsrs > 0)
+    {
+      printf("mainISR calls           %lu\n",(unsigned long)pIsrStats->numIsrs);
+      printf("mainISR host time mean  %.1f ns\n",pIsrStats->total_ns / (double)pIsrStats->numIsrs);
+      printf("mainISR host time max   %.1f ns\n",pIsrStats->max_ns);
+    }
+
+  return(EXIT_SUCCESS);
+} // end of main() function
+
+// end of file
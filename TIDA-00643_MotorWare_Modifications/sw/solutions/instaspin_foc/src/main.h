@@ -45,9 +45,25 @@
 #include "sw/modules/memCopy/src/memCopy.h"
 #include "sw/modules/est/src/32b/est.h"
 #include "sw/modules/svgen/src/32b/svgen_current.h"
+#include "sw/modules/svgen/src/32b/svgen_dpwm.h"
 #include "sw/modules/fw/src/32b/fw.h"
 #include "sw/modules/fem/src/32b/fem.h"
 #include "sw/modules/cpu_usage/src/32b/cpu_usage.h"
+#include "sw/modules/isr_prof/src/32b/isr_prof.h"
+#include "sw/modules/triglog/src/32b/triglog.h"
+#include "sw/modules/telem/src/32b/telem.h"
+#include "sw/modules/dshot/src/32b/dshot.h"
+#include "sw/modules/dtcomp/src/32b/dtcomp.h"
+#include "sw/modules/hfi/src/32b/hfi.h"
+#include "sw/modules/obs/src/32b/obs.h"
+#include "sw/modules/mbox/src/32b/mbox.h"
+#include "sw/modules/sched/src/32b/sched.h"
+#include "sw/modules/flrec/src/32b/flrec.h"
+#include "sw/modules/hcomp/src/32b/hcomp.h"
+#include "sw/modules/mtpa/src/32b/mtpa.h"
+#include "sw/modules/catch/src/32b/catch.h"
+#include "sw/modules/queue/src/queue.h"
+#include "sw/modules/regen/src/32b/regen.h"
 
 
 // drivers
@@ -253,6 +269,81 @@ void updateIqRef(CTRL_Handle handle);
 void updateKpKiGains(CTRL_Handle handle);
 
 
+//! \brief     Posts the gains, references and flags of the watch window to mainISR
+//!
+void postMotorCmd(CTRL_Handle handle);
+
+
+//! \brief     Applies the latest commands posted by the background loop, called by mainISR
+//!
+void applyMotorCmd(CTRL_Handle handle);
+
+
+//! \brief     Updates the controller state, the enable flags and the references of the background loop
+//!
+void runCtrlStateTask(void);
+
+
+//! \brief     Updates the global variables of the watch window, a background task
+//!
+void runGlobalsTask(void);
+
+
+//! \brief     Hands the gains, references and flags of the watch window to the controller, a background task
+//!
+void runMotorCmdTask(void);
+
+
+//! \brief     Writes and reads the gate driver registers, a background task
+//!
+void runDrvSpiTask(void);
+
+
+//! \brief     Builds the telemetry frames and feeds the SCIA FIFO, a background task
+//!
+void runTelemTask(void);
+
+
+//! \brief     Handles the DShot commands and the data of the replies, a background task
+//!
+void runDshotCmdTask(void);
+
+
+//! \brief     Takes a DShot command posted by ecapISR(), an event of the queue
+//! \param[in] pCmd  The command, DSHOT_Cmd_e
+void runDshotCmd(void *pCmd);
+
+
+//! \brief     Reads the CPU timer of the background task scheduler
+//!
+uint32_t readSchedTimerCnt(void);
+
+
+//! \brief     Stops the motor after a fault snapshot and programs it into the flash, a background task
+//!
+void runFlrecTask(void);
+
+
+//! \brief     Erases a flash sector of the flight recorder
+//!
+bool eraseFlrecSector(uint16_t *pSector);
+
+
+//! \brief     Programs flash words of the flight recorder
+//!
+bool programFlrecFlash(uint16_t *pDst,const uint16_t *pSrc,const uint_least16_t numWords);
+
+
+//! \brief     Reads the CPU timer of the flight recorder time statistics
+//!
+uint32_t readFlrecTimerCnt(void);
+
+
+//! \brief     Hands the identified motor parameters to the MTPA generator and refreshes its table, a background task
+//!
+void runMtpaTask(void);
+
+
 //! \brief     Runs Rs online
 //!
 void runRsOnLine(CTRL_Handle handle);
@@ -51,6 +51,9 @@
 
 #ifdef FLASH
 #pragma CODE_SECTION(mainISR,"ramfuncs");
+#ifdef MBOX_ENABLE
+#pragma CODE_SECTION(applyMotorCmd,"ramfuncs");
+#endif
 #endif
 
 // Include header files used in the main function
@@ -67,6 +70,47 @@ _iq gSpeedRef_duty = _IQ(0.0);   // Speed reference from external controller
 
 uint32_t gSpeedRef_Ok = 0;       // Safety check for speed reference signal
 
+#ifdef TRIGLOG_ENABLE
+#define TRIGLOG_NUM_CHANNELS        8       // Ia, Ib, Ic, Vdc, Iq, Iq ref, speed ref, ctrl state
+#define TRIGLOG_NUM_FRAMES          64      // 4.3 ms at 15 kHz
+#define TRIGLOG_NUM_PRE_FRAMES      48
+#define TRIGLOG_OVERCURRENT_A       (USER_MOTOR_MAX_CURRENT * 2.0)
+#define TRIGLOG_CAUSE_RC_DROPOUT    1       // the speed reference signal was lost while running
+#endif
+
+#ifdef TELEM_ENABLE
+#define TELEM_FRAME_RATE_Hz         1000    // telemetry frames on SCIA, decoded with telem_decode
+#endif
+
+#ifdef DSHOT_ENABLE
+#define DSHOT_TIMEOUT_ms            20      // signal loss after 20 ms without a valid frame
+#define DSHOT_ARM_NUM_FRAMES        50      // motor stop frames before the throttle is accepted
+#define QUEUE_KEY_DSHOT_CMD         1       // a newer command replaces the pending one
+#endif
+
+#ifdef SCHED_ENABLE
+#define SCHED_TELEM_FREQ_Hz         12000   // the four bytes of the SCIA FIFO take 85 usec at 468.75 kBaud
+#define SCHED_STATE_FREQ_Hz         1000    // the controller state, the flags and the Rs recalibration
+#define SCHED_CMD_FREQ_Hz           100     // the watch window gains and references, gMotorVars and DShot
+#define SCHED_DRV_SPI_FREQ_Hz       10      // the gate driver status registers
+#endif
+
+#ifdef DPWM_ENABLE
+#define DPWM_LOSS_FILTER_Hz         10.0    // the bandwidth of the switching loss estimate
+#endif
+
+#ifdef FLREC_ENABLE
+#define FLREC_LOG_NUM_CHANNELS      8       // Id, Iq, Vd, Vq, angle, speed, Vdc, status
+#define FLREC_LOG_NUM_FRAMES        64      // 320 ms, 7 records per flash sector
+#define FLREC_LOG_DECIMATION        75      // a frame every 5 ms at 15 kHz
+#define FLREC_LOG_NUM_PRE_FRAMES    40      // the 120 ms after the trigger cover a gate driver status read
+#define FLREC_FRAME_PERIOD_usec     ((uint32_t)(FLREC_LOG_DECIMATION * 1000000.0 / USER_ISR_FREQ_Hz))
+#define FLREC_FEM_MAX_ERROR_Hz      1000.0  // the largest deviation of the ISR frequency
+#define FLREC_FAULT_TRIP            1       // the gate driver nFAULT pin tripped the PWMs
+#define FLREC_FAULT_FREQ            2       // the ISR frequency is off while the motor runs
+#define FLREC_FAULT_CTRL            4       // the controller is in the error state
+#endif
+
 // **************************************************************************
 // the globals
 
@@ -96,6 +140,172 @@ uint16_t gLEDcnt = 0;
 
 volatile MOTOR_Vars_t gMotorVars = MOTOR_Vars_INIT;
 
+#ifdef ISR_PROF_ENABLE
+// ISR stage profiler, read out with modules/isr_prof/src/32b/host/isr_prof_decode
+ISR_PROF_Obj isr_prof;
+#endif
+
+#ifdef TRIGLOG_ENABLE
+// Fault snapshot logger, set triglog.flag_arm in the watch window to arm it again
+TRIGLOG_Obj triglog;
+
+TRIGLOG_Handle triglogHandle;
+
+int32_t gTriglogBuff[TRIGLOG_NUM_CHANNELS * TRIGLOG_NUM_FRAMES];
+
+int32_t gTriglogCtrlState = 0;
+#endif
+
+#ifdef TELEM_ENABLE
+// Telemetry of Speed_krpm, Torque_Nm, VdcBus_kV, Iq_A and CtrlState on SCIA
+TELEM_Obj telem;
+
+TELEM_Handle telemHandle;
+
+int32_t gTelemCtrlState = 0;
+#endif
+
+#ifdef DSHOT_ENABLE
+// DShot throttle input on eCAP1 instead of the RC servo pulse
+DSHOT_Obj dshot;
+
+DSHOT_Handle dshotHandle;
+
+DSHOT_Cmd_e gDshotCmd = DSHOT_Cmd_None;    // the last DShot command, for the watch window
+
+// the events ecapISR() defers to the background loop
+QUEUE_Obj queue;
+
+QUEUE_Handle queueHandle;
+
+#ifdef DSHOT_BIDIR_ENABLE
+uint_least32_t gDshotNumRepliesLate = 0;    // eRPM replies that could not be sent in time
+#endif
+#endif
+
+#ifdef DPWM_ENABLE
+// Discontinuous PWM above the modulation threshold, the switching loss
+// estimate is updated with gMotorVars
+SVGEN_DPWM_Obj svgenDpwm;
+
+SVGEN_DPWM_Handle svgenDpwmHandle;
+
+SVGEN_DPWM_Mode_e gDpwmMode = USER_DPWM_MODE;                 // the mode above the threshold, set from the watch window
+SVGEN_DPWM_Mode_e gDpwmActiveMode = SVGEN_DPWM_Mode_SVPWM;    // the mode in use
+
+_iq gDpwmModulation = _IQ(0.0);         // the modulation index, 1 at the largest unsaturated voltage
+
+_iq gSwitchingLoss_W = _IQ(0.0);        // the estimated switching loss of the bridge
+
+_iq gSwitchingLossSvpwm_W = _IQ(0.0);   // the estimate for the space vector modulation
+#endif
+
+#ifdef DTCOMP_ENABLE
+// Dead time and switch voltage drop compensation of the PWM duties
+DTCOMP_Obj dtcomp;
+
+DTCOMP_Handle dtcompHandle;
+#endif
+
+#ifdef HFI_ENABLE
+// High frequency injection, the controller takes the angle from it below the
+// handover speed
+HFI_Obj hfi;
+
+HFI_Handle hfiHandle;
+#endif
+
+#ifdef OBS_ENABLE
+// Back-EMF observer, the controller takes the angle and the speed from it
+// instead of the estimator
+OBS_Obj obs;
+
+OBS_Handle obsHandle;
+#endif
+
+#ifdef HCOMP_ENABLE
+// Harmonic compensator, learns the torque ripple over the mechanical angle and
+// feeds it forward into the quadrature current reference
+HCOMP_Obj hcomp;
+
+HCOMP_Handle hcompHandle;
+
+_iq gHcompTable[1 << USER_HCOMP_TABLE_SHIFT];
+#endif
+
+#ifdef MTPA_ENABLE
+// Maximum torque per ampere generator, the Id reference of a salient motor
+// follows the quadrature current reference
+MTPA_Obj mtpa;
+
+MTPA_Handle mtpaHandle;
+
+_iq gMtpaTable[USER_MTPA_TABLE_SIZE];
+#endif
+
+#ifdef CATCH_ENABLE
+// Catch spin, tracks a windmilling rotor on the back-EMF while the bridge is
+// off and hands its angle and speed to the controller at the start
+CATCH_Obj catchSpin;
+
+CATCH_Handle catchHandle;
+#endif
+
+#ifdef REGEN_ENABLE
+// Regenerative braking governor, limits the regenerative current by the DC
+// bus voltage, the braking power is updated with gMotorVars
+REGEN_Obj regen;
+
+REGEN_Handle regenHandle;
+
+_iq gRegenPower_W = _IQ(0.0);           // the mechanical power the braking takes from the rotor
+
+_iq gVdcBusPeak_V = _IQ(0.0);           // the highest DC bus voltage
+#endif
+
+#ifdef MBOX_ENABLE
+// Command mailbox, the background loop posts the gains, references and flags
+// and mainISR applies them together at the start of a tick
+MBOX_Obj mbox;
+
+MBOX_Handle mboxHandle;
+#endif
+
+#ifdef SCHED_ENABLE
+// Background task scheduler, the statistics of the tasks are in sched.task[]
+SCHED_Obj sched;
+
+SCHED_Handle schedHandle;
+#endif
+
+#ifdef FLREC_ENABLE
+// Flight recorder, a fault snapshot of the logger is programmed into the
+// flash sectors of the HAL when the motor is stopped and kept across a reset
+TRIGLOG_Obj flrecLog;
+
+TRIGLOG_Handle flrecLogHandle;
+
+int32_t gFlrecLogBuff[FLREC_LOG_NUM_CHANNELS * FLREC_LOG_NUM_FRAMES];
+
+FLREC_Obj flrec;
+
+FLREC_Handle flrecHandle;
+
+FEM_Obj fem;
+
+FEM_Handle femHandle;
+
+int32_t gFlrecFault = 0;        // the FLREC_FAULT_ bits of the present ISR
+
+int32_t gFlrecAngle_pu = 0;
+
+int32_t gFlrecSpeed_pu = 0;
+
+int32_t gFlrecStatus = 0;       // the controller state, the fault bits << 8 and the gate driver status 1 << 16
+
+int32_t gFlrecDrvStatus = 0;    // the status register 1 of the gate driver at the last read
+#endif
+
 #ifdef FLASH
 // Used for running BackGround in flash, and ISR in RAM
 extern uint16_t *RamfuncsLoadStart, *RamfuncsLoadEnd, *RamfuncsRunStart;
@@ -193,6 +403,346 @@ void main(void)
   CTRL_setParams(ctrlHandle,&gUserParams);
 
 
+#ifdef ISR_PROF_ENABLE
+  // set up the ISR stage profiler on the free running CPU timer 1
+  {
+    ISR_PROF_Handle isr_profHandle = ISR_PROF_init(&isr_prof,sizeof(isr_prof));
+
+    ISR_PROF_setParams(isr_profHandle,halHandle,1,
+                       (uint32_t)(USER_SYSTEM_FREQ_MHz * 1000000.0),
+                       HAL_getTimerPeriod(halHandle,1),
+                       (uint32_t)(USER_SYSTEM_FREQ_MHz * 1000000.0 / USER_ISR_FREQ_Hz));
+
+    // the estimator and the whole ISR take longer than the other stages
+    ISR_PROF_setBinShift(isr_profHandle,ISR_PROF_Stage_Est,7);
+    ISR_PROF_setBinShift(isr_profHandle,ISR_PROF_Stage_Isr,8);
+
+    HAL_startTimer(halHandle,1);
+  }
+#endif
+
+
+#ifdef TRIGLOG_ENABLE
+  // set up the fault snapshot logger, every ISR is logged
+  {
+    CTRL_Obj *obj = (CTRL_Obj *)ctrlHandle;
+    _iq overCurrent_pu = _IQ(TRIGLOG_OVERCURRENT_A / USER_IQ_FULL_SCALE_CURRENT_A);
+
+    triglogHandle = TRIGLOG_init(&triglog,sizeof(triglog));
+
+    TRIGLOG_setParams(triglogHandle,gTriglogBuff,TRIGLOG_NUM_CHANNELS * TRIGLOG_NUM_FRAMES,
+                      TRIGLOG_NUM_CHANNELS,1,TRIGLOG_NUM_PRE_FRAMES);
+
+    TRIGLOG_setChannel(triglogHandle,0,&gAdcData.I.value[0]);
+    TRIGLOG_setChannel(triglogHandle,1,&gAdcData.I.value[1]);
+    TRIGLOG_setChannel(triglogHandle,2,&gAdcData.I.value[2]);
+    TRIGLOG_setChannel(triglogHandle,3,&gAdcData.dcBus);
+    TRIGLOG_setChannel(triglogHandle,4,&obj->Idq_in.value[1]);
+    TRIGLOG_setChannel(triglogHandle,5,&obj->spd_out);
+    TRIGLOG_setChannel(triglogHandle,6,&gSpeedRef_duty);
+    TRIGLOG_setChannel(triglogHandle,7,&gTriglogCtrlState);
+
+    // overcurrent on any phase and the controller error state
+    TRIGLOG_setTrig(triglogHandle,0,TRIGLOG_TrigType_AbsAbove,&gAdcData.I.value[0],overCurrent_pu);
+    TRIGLOG_setTrig(triglogHandle,1,TRIGLOG_TrigType_AbsAbove,&gAdcData.I.value[1],overCurrent_pu);
+    TRIGLOG_setTrig(triglogHandle,2,TRIGLOG_TrigType_AbsAbove,&gAdcData.I.value[2],overCurrent_pu);
+    TRIGLOG_setTrig(triglogHandle,3,TRIGLOG_TrigType_Equal,&gTriglogCtrlState,CTRL_State_Error);
+
+    TRIGLOG_setFlag_arm(triglogHandle,true);
+  }
+#endif
+
+
+#ifdef TELEM_ENABLE
+  // set up the telemetry, paced by the free running CPU timer 0
+  telemHandle = TELEM_init(&telem,sizeof(telem));
+
+  TELEM_setParams(telemHandle,
+                  (uint32_t)(USER_SYSTEM_FREQ_MHz * 1000000.0),
+                  HAL_getTimerPeriod(halHandle,0),
+                  TELEM_FRAME_RATE_Hz,
+                  TELEM_DEFAULT_KEY_PERIOD);
+
+  TELEM_addChannel(telemHandle,&gMotorVars.Speed_krpm);
+  TELEM_addChannel(telemHandle,&gMotorVars.Torque_Nm);
+  TELEM_addChannel(telemHandle,&gMotorVars.VdcBus_kV);
+  TELEM_addChannel(telemHandle,&gMotorVars.Iq_A);
+  TELEM_addChannel(telemHandle,&gTelemCtrlState);
+
+#ifdef TRIGLOG_ENABLE
+  // the fault snapshots are sent too
+  TELEM_setTriglog(telemHandle,triglogHandle);
+#endif
+
+  TELEM_setFlag_enable(telemHandle,true);
+
+  HAL_startTimer(halHandle,0);
+#endif
+
+
+#ifdef DSHOT_ENABLE
+  // set up the DShot decoder, the eCAP time stamps count at the CPU clock
+  dshotHandle = DSHOT_init(&dshot,sizeof(dshot));
+
+  queueHandle = QUEUE_init(&queue,sizeof(queue));
+
+  DSHOT_setParams(dshotHandle,
+                  (uint32_t)(USER_SYSTEM_FREQ_MHz * 1000000.0),
+                  (uint_least16_t)(USER_ISR_FREQ_Hz * DSHOT_TIMEOUT_ms / 1000),
+                  DSHOT_ARM_NUM_FRAMES);
+
+#ifdef DSHOT_BIDIR_ENABLE
+  // answer every frame, the eCAP sends the reply as an APWM
+  DSHOT_setBidirParams(dshotHandle,true,(uint32_t)USER_IQ_FULL_SCALE_FREQ_Hz);
+#endif
+#endif
+
+
+#ifdef DPWM_ENABLE
+  // set up the discontinuous PWM for the duty span of the HAL
+  svgenDpwmHandle = SVGEN_DPWM_init(&svgenDpwm,sizeof(svgenDpwm));
+
+  SVGEN_DPWM_setParams(svgenDpwmHandle,
+                       _IQ(HAL_PWM_DUTY_SPAN),
+                       _IQ(USER_DPWM_MODULATION_ON),
+                       _IQ(USER_DPWM_MODULATION_OFF),
+                       _IQ(MATH_TWO_PI * DPWM_LOSS_FILTER_Hz / USER_ISR_FREQ_Hz));
+
+  SVGEN_DPWM_setMode(svgenDpwmHandle,gDpwmMode);
+#endif
+
+
+#ifdef DTCOMP_ENABLE
+  // set up the dead time compensation for the duty span of the HAL
+  dtcompHandle = DTCOMP_init(&dtcomp,sizeof(dtcomp));
+
+  DTCOMP_setParams(dtcompHandle,
+                   _IQ(USER_PWM_DEADTIME_ns * USER_PWM_FREQ_kHz / 1000000.0),
+                   _IQ(USER_SWITCH_VDROP_V / USER_IQ_FULL_SCALE_VOLTAGE_V),
+                   _IQ(USER_DTCOMP_CURRENT_BAND_A / USER_IQ_FULL_SCALE_CURRENT_A),
+                   _IQ(HAL_PWM_DUTY_SPAN));
+#endif
+
+
+#ifdef HFI_ENABLE
+  // set up the injection and its tracking PLL, critically damped at the bandwidth of user.h
+  {
+    float_t pllGain = 4.0 * MATH_PI * (USER_HFI_SALIENCY_RATIO - 1.0) / (USER_HFI_SALIENCY_RATIO + 1.0);
+    float_t wnTs = MATH_TWO_PI * USER_HFI_PLL_BANDWIDTH_Hz / USER_ISR_FREQ_Hz;
+
+    hfiHandle = HFI_init(&hfi,sizeof(hfi));
+
+    HFI_setParams(hfiHandle,
+                  _IQ(USER_HFI_INJ_VOLTAGE_V / USER_IQ_FULL_SCALE_VOLTAGE_V * HAL_PWM_DUTY_SPAN),
+                  _IQ(2.0 * wnTs / pllGain),
+                  _IQ(wnTs * wnTs / pllGain),
+                  _IQ(USER_ISR_FREQ_Hz / USER_IQ_FULL_SCALE_FREQ_Hz),
+                  _IQ(MATH_TWO_PI * USER_HFI_SPEED_FILTER_Hz / USER_ISR_FREQ_Hz));
+
+    HFI_setHandover(hfiHandle,
+                    _IQ(USER_HFI_HANDOVER_krpm * 1000.0 * USER_MOTOR_NUM_POLE_PAIRS / 60.0 / USER_IQ_FULL_SCALE_FREQ_Hz),
+                    _IQ(USER_HFI_HANDBACK_krpm * 1000.0 * USER_MOTOR_NUM_POLE_PAIRS / 60.0 / USER_IQ_FULL_SCALE_FREQ_Hz));
+
+    HFI_setPolarity(hfiHandle,
+                    _IQ(USER_HFI_POLARITY_CURRENT_A / USER_IQ_FULL_SCALE_CURRENT_A),
+                    (uint_least32_t)(USER_HFI_ALIGN_TIME_ms * USER_ISR_FREQ_Hz / 1000.0),
+                    (uint_least32_t)(USER_HFI_POLARITY_TIME_ms * USER_ISR_FREQ_Hz / 1000.0));
+
+    CTRL_setHfiHandle(ctrlHandle,hfiHandle);
+  }
+#endif
+
+
+#ifdef OBS_ENABLE
+  // set up the observer for the motor of user.h, the PLL critically damped at the bandwidth of user.h
+  {
+    float_t Ts = 1.0 / USER_CTRL_FREQ_Hz;
+    float_t Fobs = exp(-USER_MOTOR_Rs * Ts / USER_MOTOR_Ls_q);
+    float_t wnTs = MATH_TWO_PI * USER_OBS_PLL_BANDWIDTH_Hz * Ts;
+
+    obsHandle = OBS_init(&obs,sizeof(obs));
+
+    OBS_setParams(obsHandle,
+                  _IQ(Fobs),
+                  _IQ(USER_MOTOR_Rs / (1.0 - Fobs) * USER_IQ_FULL_SCALE_CURRENT_A / USER_IQ_FULL_SCALE_VOLTAGE_V),
+                  _IQ(1.0 - exp(-MATH_TWO_PI * USER_OBS_EMF_FILTER_Hz * Ts)),
+                  _IQ(1.0 - exp(-USER_VOLTAGE_FILTER_POLE_rps * Ts)),
+                  _IQ(MATH_TWO_PI / (USER_VOLTAGE_FILTER_POLE_rps * Ts)));
+
+    OBS_setPll(obsHandle,
+               _IQ(2.0 * wnTs / MATH_TWO_PI),
+               _IQ(wnTs * wnTs / MATH_TWO_PI),
+               _IQ(USER_CTRL_FREQ_Hz / USER_IQ_FULL_SCALE_FREQ_Hz),
+               _IQ(MATH_TWO_PI * USER_OBS_SPEED_FILTER_Hz * Ts),
+               _IQ(USER_IQ_FULL_SCALE_FREQ_Hz * 60.0 / USER_MOTOR_NUM_POLE_PAIRS / 1000.0));
+
+#ifdef HFI_ENABLE
+    // the injection covers the low speeds, no forced angle
+    OBS_setStartup(obsHandle,_IQ(0.0),_IQ(0.0),_IQ(0.0));
+#else
+    OBS_setStartup(obsHandle,
+                   _IQ(USER_OBS_STARTUP_CURRENT_A / USER_IQ_FULL_SCALE_CURRENT_A),
+                   _IQ(USER_OBS_HANDOVER_krpm * 1000.0 * USER_MOTOR_NUM_POLE_PAIRS / 60.0 / USER_IQ_FULL_SCALE_FREQ_Hz),
+                   _IQ(USER_OBS_HANDBACK_krpm * 1000.0 * USER_MOTOR_NUM_POLE_PAIRS / 60.0 / USER_IQ_FULL_SCALE_FREQ_Hz));
+#endif
+
+    CTRL_setObsHandle(ctrlHandle,obsHandle);
+  }
+#endif
+
+
+#ifdef HCOMP_ENABLE
+  // set up the harmonic compensator for the orders of user.h, it runs with
+  // the speed controller and the torque constant of the motor of user.h
+  {
+    const uint_least16_t orders[USER_HCOMP_NUM_HARMONICS] = USER_HCOMP_ORDERS;
+    float_t updateFreq_Hz = (float_t)USER_CTRL_FREQ_Hz / (float_t)USER_NUM_CTRL_TICKS_PER_SPEED_TICK;
+    float_t Kt_NmpA = 1.5 * USER_MOTOR_NUM_POLE_PAIRS * USER_MOTOR_RATED_FLUX / MATH_TWO_PI;
+    float_t speedScale_radps = MATH_TWO_PI * USER_IQ_FULL_SCALE_FREQ_Hz / USER_MOTOR_NUM_POLE_PAIRS;
+    uint_least16_t num;
+
+    hcompHandle = HCOMP_init(&hcomp,sizeof(hcomp));
+
+    HCOMP_setParams(hcompHandle,
+                    USER_HCOMP_NUM_HARMONICS,
+                    USER_MOTOR_NUM_POLE_PAIRS,
+                    _IQ(2.0 * USER_HCOMP_RATE_1ps / updateFreq_Hz),
+                    _IQ(USER_HCOMP_MAX_CURRENT_A / USER_IQ_FULL_SCALE_CURRENT_A),
+                    _IQ(USER_HCOMP_INERTIA_kgm2 * speedScale_radps * updateFreq_Hz / Kt_NmpA
+                        / USER_IQ_FULL_SCALE_CURRENT_A / (float_t)(1 << HCOMP_INERTIA_SHIFT)),
+                    _IQ(1.0 - exp(-MATH_TWO_PI * USER_HCOMP_MEAN_FILTER_Hz / updateFreq_Hz)),
+                    _IQ(USER_HCOMP_MIN_SPEED_krpm * 1000.0 / 60.0 / updateFreq_Hz));
+
+    HCOMP_setTable(hcompHandle,gHcompTable,USER_HCOMP_TABLE_SHIFT);
+
+    for(num=0;num<USER_HCOMP_NUM_HARMONICS;num++)
+      {
+        HCOMP_setHarmonic(hcompHandle,num,orders[num]);
+      }
+
+    HCOMP_setFlag_enableLearning(hcompHandle,true);
+    HCOMP_setFlag_enableOutput(hcompHandle,true);
+
+    CTRL_setHcompHandle(ctrlHandle,hcompHandle);
+  }
+#endif
+
+
+#ifdef MTPA_ENABLE
+  // set up the MTPA generator, the table is built from the identified motor
+  // parameters by runMtpaTask() and the Id stays within the negative limit
+  mtpaHandle = MTPA_init(&mtpa,sizeof(mtpa));
+
+  MTPA_setMode(mtpaHandle,MTPA_Mode_Table);
+  MTPA_setIdMin_pu(mtpaHandle,_IQ(USER_MAX_NEGATIVE_ID_REF_CURRENT_A / USER_IQ_FULL_SCALE_CURRENT_A));
+  MTPA_setTable(mtpaHandle,gMtpaTable,USER_MTPA_TABLE_SIZE,
+                _IQ(USER_MTPA_MAX_CURRENT_A / USER_IQ_FULL_SCALE_CURRENT_A));
+
+  CTRL_setMtpaHandle(ctrlHandle,mtpaHandle);
+#endif
+
+
+#ifdef CATCH_ENABLE
+  // set up the catch spin, the PLL critically damped at the bandwidth of
+  // user.h, the bridge is off so the tracking starts right away
+  {
+    float_t Ts = 1.0 / USER_ISR_FREQ_Hz;
+    float_t wnTs = MATH_TWO_PI * USER_CATCH_PLL_BANDWIDTH_Hz * Ts;
+
+    catchHandle = CATCH_init(&catchSpin,sizeof(catchSpin));
+
+    CATCH_setParams(catchHandle,
+                    _IQ(2.0 * wnTs / MATH_TWO_PI),
+                    _IQ(wnTs * wnTs / MATH_TWO_PI),
+                    _IQ(USER_ISR_FREQ_Hz / USER_IQ_FULL_SCALE_FREQ_Hz),
+                    _IQ(MATH_TWO_PI / (USER_VOLTAGE_FILTER_POLE_rps * Ts)),
+                    _IQ(USER_CATCH_MIN_EMF_V / USER_IQ_FULL_SCALE_VOLTAGE_V),
+                    (uint_least16_t)(USER_CATCH_LOCK_TIME_sec * USER_ISR_FREQ_Hz),
+                    (uint_least16_t)(USER_CATCH_TIMEOUT_sec * USER_ISR_FREQ_Hz));
+
+    CATCH_start(catchHandle);
+
+    CTRL_setCatchHandle(ctrlHandle,catchHandle);
+  }
+#endif
+
+
+#ifdef REGEN_ENABLE
+  // set up the regenerative braking governor, the speed controller may brake
+  // with its full current below the start voltage of user.h
+  regenHandle = REGEN_init(&regen,sizeof(regen));
+
+  REGEN_setParams(regenHandle,
+                  _IQ(USER_REGEN_START_VDC_V / USER_IQ_FULL_SCALE_VOLTAGE_V),
+                  _IQ(USER_REGEN_MAX_VDC_V / USER_IQ_FULL_SCALE_VOLTAGE_V),
+                  _IQ(USER_MOTOR_MAX_CURRENT / USER_IQ_FULL_SCALE_CURRENT_A),
+                  _IQ(USER_REGEN_ID_LOSS_A / USER_IQ_FULL_SCALE_CURRENT_A));
+
+  CTRL_setRegenHandle(ctrlHandle,regenHandle);
+#endif
+
+
+#ifdef MBOX_ENABLE
+  // initialize the command mailbox
+  mboxHandle = MBOX_init(&mbox,sizeof(mbox));
+#endif
+
+
+#ifdef FLREC_ENABLE
+  // set up the flight recorder on the flash sectors of the HAL, the ISR
+  // frequency is measured on the free running CPU timer 0
+  {
+    CTRL_Obj *obj = (CTRL_Obj *)ctrlHandle;
+
+    femHandle = FEM_init(&fem,sizeof(fem));
+
+    FEM_setParams(femHandle,
+                  USER_SYSTEM_FREQ_MHz * 1000000.0,
+                  HAL_getTimerPeriod(halHandle,0),
+                  USER_ISR_FREQ_Hz,
+                  FLREC_FEM_MAX_ERROR_Hz);
+
+    HAL_startTimer(halHandle,0);
+
+    flrecLogHandle = TRIGLOG_init(&flrecLog,sizeof(flrecLog));
+
+    TRIGLOG_setParams(flrecLogHandle,gFlrecLogBuff,FLREC_LOG_NUM_CHANNELS * FLREC_LOG_NUM_FRAMES,
+                      FLREC_LOG_NUM_CHANNELS,FLREC_LOG_DECIMATION,FLREC_LOG_NUM_PRE_FRAMES);
+
+    TRIGLOG_setChannel(flrecLogHandle,0,&obj->Idq_in.value[0]);
+    TRIGLOG_setChannel(flrecLogHandle,1,&obj->Idq_in.value[1]);
+    TRIGLOG_setChannel(flrecLogHandle,2,&obj->Vdq_out.value[0]);
+    TRIGLOG_setChannel(flrecLogHandle,3,&obj->Vdq_out.value[1]);
+    TRIGLOG_setChannel(flrecLogHandle,4,&gFlrecAngle_pu);
+    TRIGLOG_setChannel(flrecLogHandle,5,&gFlrecSpeed_pu);
+    TRIGLOG_setChannel(flrecLogHandle,6,&gAdcData.dcBus);
+    TRIGLOG_setChannel(flrecLogHandle,7,&gFlrecStatus);
+
+    // any fault bit
+    TRIGLOG_setTrig(flrecLogHandle,0,TRIGLOG_TrigType_Rising,&gFlrecFault,0);
+
+    flrecHandle = FLREC_init(&flrec,sizeof(flrec));
+
+    FLREC_setParams(flrecHandle,
+                    HAL_getFlashLogAddr(halHandle),
+                    HAL_FLASH_LOG_SECTOR_WORDS,
+                    HAL_FLASH_LOG_NUM_SECTORS,
+                    FLREC_HEADER_WORDS + FLREC_LOG_NUM_CHANNELS * FLREC_LOG_NUM_FRAMES * 2,
+                    eraseFlrecSector,
+                    programFlrecFlash);
+
+    FLREC_setTimer(flrecHandle,readFlrecTimerCnt,HAL_getTimerPeriod(halHandle,0));
+
+    // find the records of the previous runs, a sector erase takes too long
+    // for a stopped motor with the interrupts enabled, it is only done here
+    FLREC_scan(flrecHandle);
+    FLREC_prepare(flrecHandle);
+
+    TRIGLOG_setFlag_arm(flrecLogHandle,true);
+  }
+#endif
+
+
   // setup faults
   HAL_setupFaults(halHandle);
 
@@ -243,151 +793,74 @@ void main(void)
   gTorque_Flux_Iq_pu_to_Nm_sf = USER_computeTorque_Flux_Iq_pu_to_Nm_sf();
 
 
+#ifdef SCHED_ENABLE
+  // set up the background tasks on the free running CPU timer 2
+  {
+    uint32_t timerFreq_Hz = (uint32_t)(USER_SYSTEM_FREQ_MHz * 1000000.0);
+
+    schedHandle = SCHED_init(&sched,sizeof(sched));
+
+    HAL_startTimer(halHandle,2);
+
+    SCHED_setParams(schedHandle,readSchedTimerCnt,timerFreq_Hz,HAL_getTimerPeriod(halHandle,2));
+
+#ifdef TELEM_ENABLE
+    SCHED_addTask(schedHandle,runTelemTask,"telem",timerFreq_Hz / SCHED_TELEM_FREQ_Hz,0);
+#endif
+    SCHED_addTask(schedHandle,runCtrlStateTask,"state",timerFreq_Hz / SCHED_STATE_FREQ_Hz,0);
+    SCHED_addTask(schedHandle,runMotorCmdTask,"cmd",timerFreq_Hz / SCHED_CMD_FREQ_Hz,0);
+    SCHED_addTask(schedHandle,runGlobalsTask,"globals",timerFreq_Hz / SCHED_CMD_FREQ_Hz,0);
+#ifdef DSHOT_ENABLE
+    SCHED_addTask(schedHandle,runDshotCmdTask,"dshot",timerFreq_Hz / SCHED_CMD_FREQ_Hz,0);
+#endif
+#ifdef FLREC_ENABLE
+    SCHED_addTask(schedHandle,runFlrecTask,"flrec",timerFreq_Hz / SCHED_CMD_FREQ_Hz,0);
+#endif
+#ifdef MTPA_ENABLE
+    SCHED_addTask(schedHandle,runMtpaTask,"mtpa",timerFreq_Hz / SCHED_CMD_FREQ_Hz,0);
+#endif
+    SCHED_addTask(schedHandle,runDrvSpiTask,"drv spi",timerFreq_Hz / SCHED_DRV_SPI_FREQ_Hz,0);
+  }
+#endif
+
+
   for(;;)
   {
+#ifdef FLREC_ENABLE
+    // Waiting for enable system flag to be set, the record of a fault is
+    // programmed while the motor is stopped
+    while(!(gMotorVars.Flag_enableSys) || (FLREC_getState(flrecHandle) != FLREC_State_Idle))
+      {
+        runFlrecTask();
+
+        HAL_idle(halHandle);
+      }
+#else
     // Waiting for enable system flag to be set
     while(!(gMotorVars.Flag_enableSys));
+#endif
 
     // Enable the Library internal PI.  Iq is referenced by the speed PI now
     CTRL_setFlag_enableSpeedCtrl(ctrlHandle, true);
 
+#ifdef SCHED_ENABLE
+    // run the background tasks at their rates, wait for the next interrupt when none is due
+    while(gMotorVars.Flag_enableSys)
+      {
+        if(!SCHED_run(schedHandle))
+          {
+            HAL_idle(halHandle);
+          }
+      }
+#else
     // loop while the enable system flag is true
     while(gMotorVars.Flag_enableSys)
       {
-        CTRL_Obj *obj = (CTRL_Obj *)ctrlHandle;
-
         // increment counters
         gCounter_updateGlobals++;
 
-        // enable/disable the use of motor parameters being loaded from user.h
-        CTRL_setFlag_enableUserMotorParams(ctrlHandle,gMotorVars.Flag_enableUserParams);
-
-        // enable/disable Rs recalibration during motor startup
-        EST_setFlag_enableRsRecalc(obj->estHandle,gMotorVars.Flag_enableRsRecalc);
-
-        // enable/disable automatic calculation of bias values
-        CTRL_setFlag_enableOffset(ctrlHandle,gMotorVars.Flag_enableOffsetcalc);
-
-
-        if(CTRL_isError(ctrlHandle))
-          {
-            // set the enable controller flag to false
-            CTRL_setFlag_enableCtrl(ctrlHandle,false);
-
-            // set the enable system flag to false
-            gMotorVars.Flag_enableSys = false;
-
-            // disable the PWM
-            HAL_disablePwm(halHandle);
-          }
-        else
-          {
-            // update the controller state
-            bool flag_ctrlStateChanged = CTRL_updateState(ctrlHandle);
-
-            // enable or disable the control
-            CTRL_setFlag_enableCtrl(ctrlHandle, gMotorVars.Flag_Run_Identify);
-
-            if(flag_ctrlStateChanged)
-              {
-                CTRL_State_e ctrlState = CTRL_getState(ctrlHandle);
-
-                if(ctrlState == CTRL_State_OffLine)
-                  {
-                    // enable the PWM
-                    HAL_enablePwm(halHandle);
-                  }
-                else if(ctrlState == CTRL_State_OnLine)
-                  {
-                    if(gMotorVars.Flag_enableOffsetcalc == true)
-                    {
-                      // update the ADC bias values
-                      HAL_updateAdcBias(halHandle);
-                    }
-                    else
-                    {
-                      // set the current bias
-                      HAL_setBias(halHandle,HAL_SensorType_Current,0,_IQ(I_A_offset));
-                      HAL_setBias(halHandle,HAL_SensorType_Current,1,_IQ(I_B_offset));
-                      HAL_setBias(halHandle,HAL_SensorType_Current,2,_IQ(I_C_offset));
-
-                      // set the voltage bias
-                      HAL_setBias(halHandle,HAL_SensorType_Voltage,0,_IQ(V_A_offset));
-                      HAL_setBias(halHandle,HAL_SensorType_Voltage,1,_IQ(V_B_offset));
-                      HAL_setBias(halHandle,HAL_SensorType_Voltage,2,_IQ(V_C_offset));
-                    }
-
-                    // Return the bias value for currents
-                    gMotorVars.I_bias.value[0] = HAL_getBias(halHandle,HAL_SensorType_Current,0);
-                    gMotorVars.I_bias.value[1] = HAL_getBias(halHandle,HAL_SensorType_Current,1);
-                    gMotorVars.I_bias.value[2] = HAL_getBias(halHandle,HAL_SensorType_Current,2);
-
-                    // Return the bias value for voltages
-                    gMotorVars.V_bias.value[0] = HAL_getBias(halHandle,HAL_SensorType_Voltage,0);
-                    gMotorVars.V_bias.value[1] = HAL_getBias(halHandle,HAL_SensorType_Voltage,1);
-                    gMotorVars.V_bias.value[2] = HAL_getBias(halHandle,HAL_SensorType_Voltage,2);
-
-                    // enable the PWM
-                    HAL_enablePwm(halHandle);
-                  }
-                else if(ctrlState == CTRL_State_Idle)
-                  {
-                    // disable the PWM
-                    HAL_disablePwm(halHandle);
-                    gMotorVars.Flag_Run_Identify = false;
-                  }
-
-                if((CTRL_getFlag_enableUserMotorParams(ctrlHandle) == true) &&
-                  (ctrlState > CTRL_State_Idle) &&
-                  (gMotorVars.CtrlVersion.minor == 6))
-                  {
-                    // call this function to fix 1p6
-                    USER_softwareUpdate1p6(ctrlHandle);
-                  }
-
-              }
-          }
-
-
-        if(EST_isMotorIdentified(obj->estHandle))
-          {
-            // set the current ramp
-            EST_setMaxCurrentSlope_pu(obj->estHandle,gMaxCurrentSlope);
-            gMotorVars.Flag_MotorIdentified = true;
-
-            // set the speed reference
-            CTRL_setSpd_ref_krpm(ctrlHandle,gMotorVars.SpeedRef_krpm);
-
-            // set the speed acceleration
-            CTRL_setMaxAccel_pu(ctrlHandle,_IQmpy(MAX_ACCEL_KRPMPS_SF,gMotorVars.MaxAccel_krpmps));
-            if(Flag_Latch_softwareUpdate)
-            {
-              Flag_Latch_softwareUpdate = false;
-
-              USER_calcPIgains(ctrlHandle);
-
-              // initialize the watch window kp and ki current values with pre-calculated values
-              gMotorVars.Kp_Idq = CTRL_getKp(ctrlHandle,CTRL_Type_PID_Id);
-              gMotorVars.Ki_Idq = CTRL_getKi(ctrlHandle,CTRL_Type_PID_Id);
-
-              // initialize the watch window kp and ki values with pre-calculated values
-              gMotorVars.Kp_spd = CTRL_getKp(ctrlHandle,CTRL_Type_PID_spd);
-              gMotorVars.Ki_spd = CTRL_getKi(ctrlHandle,CTRL_Type_PID_spd);
-
-              // TIDA-00643 custom values for speed controller
-              gMotorVars.Kp_spd = _IQ(2.000);
-              gMotorVars.Ki_spd = _IQ(0.059);
-            }
-
-          }
-        else
-          {
-            Flag_Latch_softwareUpdate = true;
-
-            // the estimator sets the maximum current slope during identification
-            gMaxCurrentSlope = EST_getMaxCurrentSlope_pu(obj->estHandle);
-          }
-
+        // update the controller state and the flags
+        runCtrlStateTask();
 
         // when appropriate, update the global variables
         if(gCounter_updateGlobals >= NUM_MAIN_TICKS_FOR_GLOBAL_VARIABLE_UPDATE)
@@ -398,27 +871,33 @@ void main(void)
             updateGlobalVariables_motor(ctrlHandle);
           }
 
+        // hand the gains, references and flags to the controller
+        runMotorCmdTask();
 
-        // update Kp and Ki gains
-        updateKpKiGains(ctrlHandle);
-
-        // enable/disable the forced angle
-        EST_setFlag_enableForceAngle(obj->estHandle,gMotorVars.Flag_enableForceAngle);
+        // update the gate driver registers
+        runDrvSpiTask();
 
-        // enable or disable power warp
-        CTRL_setFlag_enablePowerWarp(ctrlHandle,gMotorVars.Flag_enablePowerWarp);
+#ifdef TELEM_ENABLE
+        // send the telemetry
+        runTelemTask();
+#endif
 
-#ifdef DRV8301_SPI
-        HAL_writeDrvData(halHandle,&gDrvSpi8301Vars);
+#ifdef DSHOT_ENABLE
+        // handle the DShot commands
+        runDshotCmdTask();
+#endif
 
-        HAL_readDrvData(halHandle,&gDrvSpi8301Vars);
+#ifdef FLREC_ENABLE
+        // stop the motor after a fault snapshot
+        runFlrecTask();
 #endif
-#ifdef DRV8305_SPI
-        HAL_writeDrvData(halHandle,&gDrvSpi8305Vars);
 
-        HAL_readDrvData(halHandle,&gDrvSpi8305Vars);
+#ifdef MTPA_ENABLE
+        // follow the identified motor parameters with the MTPA table
+        runMtpaTask();
 #endif
       } // end of while(gFlag_enableSys) loop
+#endif
 
 
     // disable the PWM
@@ -435,6 +914,14 @@ void main(void)
 
 interrupt void mainISR(void)
 {
+  ISR_PROF_START();
+
+#ifdef FLREC_ENABLE
+  // measure the ISR frequency
+  FEM_updateCnts(femHandle,HAL_readTimerCnt(halHandle,0));
+  FEM_run(femHandle);
+#endif
+
   // toggle status LED
   if(gLEDcnt++ > (uint_least32_t)(USER_ISR_FREQ_Hz / LED_BLINK_FREQ_Hz))
   {
@@ -442,35 +929,139 @@ interrupt void mainISR(void)
     gLEDcnt = 0;
   }
 
-  // Check if speed reference signal is active
-  // If more than 2000 service routine cycles pass without signal, disable motor
-  if (gSpeedRef_Ok++ > 2000)
+#ifdef DSHOT_ENABLE
+  // Check if the DShot signal is active, the decoder disarms after DSHOT_TIMEOUT_ms
+  if(DSHOT_runTimeout(dshotHandle))
   {
+#ifdef TRIGLOG_ENABLE
+      TRIGLOG_trigger(triglogHandle,TRIGLOG_CAUSE_RC_DROPOUT);
+#endif
+      gSpeedRef_duty = _IQ(0);
+      gMotorVars.Flag_Run_Identify = 0;
+  }
+#else
+  // Check if speed reference signal is active
+  // If more than 2000 service routine cycles pass without signal, disable motor
+  if (gSpeedRef_Ok++ > 2000)
+  {
+#ifdef TRIGLOG_ENABLE
+      if(gMotorVars.Flag_Run_Identify)
+        {
+          TRIGLOG_trigger(triglogHandle,TRIGLOG_CAUSE_RC_DROPOUT);
+        }
+#endif
       gSpeedRef_duty = _IQ(0);
       gMotorVars.Flag_Run_Identify = 0;
       gSpeedRef_Ok = 0;
   }
+#endif
 
 
   // acknowledge the ADC interrupt
   HAL_acqAdcInt(halHandle,ADC_IntNumber_1);
 
+#ifdef DSHOT_ENABLE
+  // the eCAP interrupt takes a DShot pulse every bit, it preempts the rest
+  // of the ISR so no pulse is overwritten in the capture registers
+  HAL_enableIsrNesting(halHandle,CPU_IntNumber_4);
+#endif
+
 
   // convert the ADC data
   HAL_readAdcData(halHandle,&gAdcData);
 
+  ISR_PROF_MARK(ISR_PROF_Stage_AdcRead);
+
+#ifdef CATCH_ENABLE
+  // track a spinning rotor on the back-EMF while the bridge is off
+  CATCH_run(catchHandle,&gAdcData.V);
+#endif
+
+#ifdef MBOX_ENABLE
+  // apply the commands of the background loop at the tick boundary
+  applyMotorCmd(ctrlHandle);
+#endif
+
 
   // run the controller
   CTRL_run(ctrlHandle,halHandle,&gAdcData,&gPwmData);
 
+#ifdef DPWM_ENABLE
+  // clamp one leg above the modulation threshold, before the dead time
+  // compensation which leaves the clamped leg alone
+  SVGEN_DPWM_run(svgenDpwmHandle,&gAdcData.I,&gPwmData.Tabc);
+#endif
+
+#ifdef DTCOMP_ENABLE
+  // compensate the dead time in the direction of the phase currents
+  DTCOMP_run(dtcompHandle,
+             &gAdcData.I,
+             EST_getOneOverDcBus_pu(((CTRL_Obj *)ctrlHandle)->estHandle),
+             &gPwmData.Tabc);
+#endif
+
 
   // write the PWM compare values
   HAL_writePwmData(halHandle,&gPwmData);
 
+#ifdef CATCH_ENABLE
+  // the controller took over the caught rotor, the bridge drives it from the
+  // compare values of this tick on
+  if(CATCH_getState(catchHandle) == CATCH_State_Engaged)
+    {
+      CATCH_stop(catchHandle);
+
+      HAL_enablePwm(halHandle);
+    }
+#endif
+
+  ISR_PROF_MARK(ISR_PROF_Stage_PwmWrite);
+
+
+#ifdef TRIGLOG_ENABLE
+  // log the fault snapshot channels and check the triggers
+  gTriglogCtrlState = (int32_t)CTRL_getState(ctrlHandle);
+
+  TRIGLOG_run(triglogHandle);
+#endif
+
+#ifdef FLREC_ENABLE
+  // log the flight recorder channels, a new fault bit triggers the capture
+  {
+    CTRL_Obj *obj = (CTRL_Obj *)ctrlHandle;
+    CTRL_State_e ctrlState = CTRL_getState(ctrlHandle);
+    int32_t fault = 0;
+
+    if(HAL_getCbcTripFlag(halHandle))
+      {
+        fault |= FLREC_FAULT_TRIP;
+      }
+
+    if((ctrlState == CTRL_State_OnLine) && FEM_getFlag_freqError(femHandle))
+      {
+        fault |= FLREC_FAULT_FREQ;
+      }
+
+    if(ctrlState == CTRL_State_Error)
+      {
+        fault |= FLREC_FAULT_CTRL;
+      }
+
+    gFlrecFault = fault;
+    gFlrecAngle_pu = EST_getAngle_pu(obj->estHandle);
+    gFlrecSpeed_pu = EST_getFm_pu(obj->estHandle);
+    gFlrecStatus = (int32_t)ctrlState | (fault << 8) | (gFlrecDrvStatus << 16);
+
+    TRIGLOG_run(flrecLogHandle);
+  }
+#endif
+
 
   // setup the controller
   CTRL_setup(ctrlHandle);
 
+  ISR_PROF_STOP();
+
 
   return;
 } // end of mainISR() function
@@ -522,6 +1113,35 @@ void updateGlobalVariables_motor(CTRL_Handle handle)
   // Get the DC buss voltage
   gMotorVars.VdcBus_kV = _IQmpy(gAdcData.dcBus,_IQ(USER_IQ_FULL_SCALE_VOLTAGE_V/1000.0));
 
+  // get the Iq current
+  gMotorVars.Iq_A = _IQmpy(CTRL_getIq_in_pu(handle),_IQ(USER_IQ_FULL_SCALE_CURRENT_A));
+
+#ifdef REGEN_ENABLE
+  // the torque against the rotation returns its power to the DC bus, less the losses
+  {
+    _iq power_W = _IQmpy(_IQmpy(gMotorVars.Torque_Nm,gMotorVars.Speed_krpm),_IQ(1000.0 * MATH_TWO_PI / 60.0));
+
+    gRegenPower_W = (power_W < _IQ(0.0)) ? -power_W : _IQ(0.0);
+  }
+
+  gVdcBusPeak_V = _IQmpy(REGEN_getVdcPeak_pu(regenHandle),_IQ(USER_IQ_FULL_SCALE_VOLTAGE_V));
+#endif
+
+#ifdef DPWM_ENABLE
+  // every switching leg loses about Vdc*|I|*(tr + tf)/2 per PWM period
+  SVGEN_DPWM_setMode(svgenDpwmHandle,gDpwmMode);
+
+  gDpwmActiveMode = SVGEN_DPWM_getActiveMode(svgenDpwmHandle);
+  gDpwmModulation = SVGEN_DPWM_getModulation(svgenDpwmHandle);
+
+  gSwitchingLoss_W = _IQmpy(_IQmpy(gAdcData.dcBus,SVGEN_DPWM_getSwitchedCurrent_pu(svgenDpwmHandle)),
+                            _IQ(0.5 * USER_IQ_FULL_SCALE_VOLTAGE_V * USER_IQ_FULL_SCALE_CURRENT_A
+                                * USER_SWITCH_TRANSITION_ns * USER_PWM_FREQ_kHz / 1000000.0));
+  gSwitchingLossSvpwm_W = _IQmpy(_IQmpy(gAdcData.dcBus,SVGEN_DPWM_getTotalCurrent_pu(svgenDpwmHandle)),
+                                 _IQ(0.5 * USER_IQ_FULL_SCALE_VOLTAGE_V * USER_IQ_FULL_SCALE_CURRENT_A
+                                     * USER_SWITCH_TRANSITION_ns * USER_PWM_FREQ_kHz / 1000000.0));
+#endif
+
   return;
 } // end of updateGlobalVariables_motor() function
 
@@ -545,6 +1165,586 @@ void updateKpKiGains(CTRL_Handle handle)
 } // end of updateKpKiGains() function
 
 
+#ifdef MBOX_ENABLE
+void postMotorCmd(CTRL_Handle handle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+  MBOX_Cmd_t *pCmd = MBOX_getCmd_addr(mboxHandle);
+
+
+  // the flags of the watch window
+  pCmd->flag_enableUserMotorParams = gMotorVars.Flag_enableUserParams;
+  pCmd->flag_enableOffset = gMotorVars.Flag_enableOffsetcalc;
+  pCmd->flag_enableRsRecalc = gMotorVars.Flag_enableRsRecalc;
+  pCmd->flag_enableForceAngle = gMotorVars.Flag_enableForceAngle;
+  pCmd->flag_enablePowerWarp = gMotorVars.Flag_enablePowerWarp;
+
+  // the references once the motor is identified
+  pCmd->flag_updateRefs = EST_isMotorIdentified(obj->estHandle);
+  pCmd->speedRef_krpm = gMotorVars.SpeedRef_krpm;
+  pCmd->maxAccel_pu = _IQmpy(MAX_ACCEL_KRPMPS_SF,gMotorVars.MaxAccel_krpmps);
+  pCmd->maxCurrentSlope_pu = gMaxCurrentSlope;
+
+  // the gains under the same conditions as updateKpKiGains()
+  pCmd->flag_updateGains = (gMotorVars.CtrlState == CTRL_State_OnLine) &&
+                           (gMotorVars.Flag_MotorIdentified == true) &&
+                           (Flag_Latch_softwareUpdate == false);
+  pCmd->Kp_spd = gMotorVars.Kp_spd;
+  pCmd->Ki_spd = gMotorVars.Ki_spd;
+  pCmd->Kp_Idq = gMotorVars.Kp_Idq;
+  pCmd->Ki_Idq = gMotorVars.Ki_Idq;
+
+  MBOX_post(mboxHandle);
+
+  return;
+} // end of postMotorCmd() function
+
+
+void applyMotorCmd(CTRL_Handle handle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+  const MBOX_Cmd_t *pCmd = MBOX_take(mboxHandle);
+
+
+  // nothing posted since the last tick
+  if(pCmd == NULL)
+    {
+      return;
+    }
+
+  CTRL_setFlag_enableUserMotorParams(handle,pCmd->flag_enableUserMotorParams);
+  CTRL_setFlag_enableOffset(handle,pCmd->flag_enableOffset);
+  EST_setFlag_enableRsRecalc(obj->estHandle,pCmd->flag_enableRsRecalc);
+  EST_setFlag_enableForceAngle(obj->estHandle,pCmd->flag_enableForceAngle);
+  CTRL_setFlag_enablePowerWarp(handle,pCmd->flag_enablePowerWarp);
+
+  if(pCmd->flag_updateRefs)
+    {
+      EST_setMaxCurrentSlope_pu(obj->estHandle,pCmd->maxCurrentSlope_pu);
+      CTRL_setSpd_ref_krpm(handle,pCmd->speedRef_krpm);
+      CTRL_setMaxAccel_pu(handle,pCmd->maxAccel_pu);
+    }
+
+  if(pCmd->flag_updateGains)
+    {
+      CTRL_setKp(handle,CTRL_Type_PID_spd,pCmd->Kp_spd);
+      CTRL_setKi(handle,CTRL_Type_PID_spd,pCmd->Ki_spd);
+      CTRL_setKp(handle,CTRL_Type_PID_Id,pCmd->Kp_Idq);
+      CTRL_setKi(handle,CTRL_Type_PID_Id,pCmd->Ki_Idq);
+      CTRL_setKp(handle,CTRL_Type_PID_Iq,pCmd->Kp_Idq);
+      CTRL_setKi(handle,CTRL_Type_PID_Iq,pCmd->Ki_Idq);
+    }
+
+  return;
+} // end of applyMotorCmd() function
+#endif
+
+
+void runCtrlStateTask(void)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)ctrlHandle;
+
+
+#ifndef MBOX_ENABLE
+  // enable/disable the use of motor parameters being loaded from user.h
+  CTRL_setFlag_enableUserMotorParams(ctrlHandle,gMotorVars.Flag_enableUserParams);
+
+  // enable/disable Rs recalibration during motor startup
+  EST_setFlag_enableRsRecalc(obj->estHandle,gMotorVars.Flag_enableRsRecalc);
+
+  // enable/disable automatic calculation of bias values
+  CTRL_setFlag_enableOffset(ctrlHandle,gMotorVars.Flag_enableOffsetcalc);
+#endif
+
+
+  if(CTRL_isError(ctrlHandle))
+    {
+      // set the enable controller flag to false
+      CTRL_setFlag_enableCtrl(ctrlHandle,false);
+
+      // set the enable system flag to false
+      gMotorVars.Flag_enableSys = false;
+
+      // disable the PWM
+      HAL_disablePwm(halHandle);
+    }
+  else
+    {
+      // update the controller state
+      bool flag_ctrlStateChanged = CTRL_updateState(ctrlHandle);
+
+      // enable or disable the control
+#ifdef CATCH_ENABLE
+      // a start waits until the catch has locked to a spinning rotor or timed out
+      CTRL_setFlag_enableCtrl(ctrlHandle, gMotorVars.Flag_Run_Identify &&
+                              ((CTRL_getState(ctrlHandle) != CTRL_State_Idle) || CATCH_isDone(catchHandle)));
+#else
+      CTRL_setFlag_enableCtrl(ctrlHandle, gMotorVars.Flag_Run_Identify);
+#endif
+
+      if(flag_ctrlStateChanged)
+        {
+          CTRL_State_e ctrlState = CTRL_getState(ctrlHandle);
+
+          if(ctrlState == CTRL_State_OffLine)
+            {
+#ifdef FLREC_ENABLE
+              // a trip before the start is not a fault of this run
+              HAL_clearCbcTripFlag(halHandle);
+#endif
+
+#ifdef CATCH_ENABLE
+              // the offset calibration drives the bridge, the rotor is not caught
+              CATCH_stop(catchHandle);
+#endif
+
+              // enable the PWM
+              HAL_enablePwm(halHandle);
+            }
+          else if(ctrlState == CTRL_State_OnLine)
+            {
+              if(gMotorVars.Flag_enableOffsetcalc == true)
+              {
+                // update the ADC bias values
+                HAL_updateAdcBias(halHandle);
+              }
+              else
+              {
+                // set the current bias
+                HAL_setBias(halHandle,HAL_SensorType_Current,0,_IQ(I_A_offset));
+                HAL_setBias(halHandle,HAL_SensorType_Current,1,_IQ(I_B_offset));
+                HAL_setBias(halHandle,HAL_SensorType_Current,2,_IQ(I_C_offset));
+
+                // set the voltage bias
+                HAL_setBias(halHandle,HAL_SensorType_Voltage,0,_IQ(V_A_offset));
+                HAL_setBias(halHandle,HAL_SensorType_Voltage,1,_IQ(V_B_offset));
+                HAL_setBias(halHandle,HAL_SensorType_Voltage,2,_IQ(V_C_offset));
+              }
+
+              // Return the bias value for currents
+              gMotorVars.I_bias.value[0] = HAL_getBias(halHandle,HAL_SensorType_Current,0);
+              gMotorVars.I_bias.value[1] = HAL_getBias(halHandle,HAL_SensorType_Current,1);
+              gMotorVars.I_bias.value[2] = HAL_getBias(halHandle,HAL_SensorType_Current,2);
+
+              // Return the bias value for voltages
+              gMotorVars.V_bias.value[0] = HAL_getBias(halHandle,HAL_SensorType_Voltage,0);
+              gMotorVars.V_bias.value[1] = HAL_getBias(halHandle,HAL_SensorType_Voltage,1);
+              gMotorVars.V_bias.value[2] = HAL_getBias(halHandle,HAL_SensorType_Voltage,2);
+
+#ifdef HFI_ENABLE
+              // the rotor angle is unknown at every start
+              HFI_start(hfiHandle);
+#endif
+
+#ifdef OBS_ENABLE
+              OBS_start(obsHandle);
+#endif
+
+#ifdef HCOMP_ENABLE
+              // the mechanical angle is counted again from the new start
+              HCOMP_start(hcompHandle);
+#endif
+
+#ifdef CATCH_ENABLE
+              // while the catch tracks, the PWM waits until the controller is set up
+              if(CATCH_getState(catchHandle) == CATCH_State_Idle)
+                {
+                  HAL_enablePwm(halHandle);
+                }
+#else
+              // enable the PWM
+              HAL_enablePwm(halHandle);
+#endif
+            }
+          else if(ctrlState == CTRL_State_Idle)
+            {
+#ifdef HFI_ENABLE
+              HFI_stop(hfiHandle);
+#endif
+
+#ifdef OBS_ENABLE
+              OBS_stop(obsHandle);
+#endif
+
+              // disable the PWM
+              HAL_disablePwm(halHandle);
+              gMotorVars.Flag_Run_Identify = false;
+
+#ifdef CATCH_ENABLE
+              // track the rotor again for the next start
+              CATCH_start(catchHandle);
+#endif
+            }
+
+          if((CTRL_getFlag_enableUserMotorParams(ctrlHandle) == true) &&
+            (ctrlState > CTRL_State_Idle) &&
+            (gMotorVars.CtrlVersion.minor == 6))
+            {
+              // call this function to fix 1p6
+              USER_softwareUpdate1p6(ctrlHandle);
+            }
+
+        }
+
+#ifdef CATCH_ENABLE
+      // once the estimator is online the controller is set up, a caught
+      // rotor is handed to it and mainISR() enables the PWM, else the start
+      // is from rest
+      if((CTRL_getState(ctrlHandle) == CTRL_State_OnLine) && EST_isOnLine(obj->estHandle) &&
+         (CATCH_getState(catchHandle) == CATCH_State_Track))
+        {
+          if(!CATCH_engage(catchHandle))
+            {
+              CATCH_stop(catchHandle);
+
+              HAL_enablePwm(halHandle);
+            }
+        }
+#endif
+    }
+
+
+  if(EST_isMotorIdentified(obj->estHandle))
+    {
+      gMotorVars.Flag_MotorIdentified = true;
+
+#ifndef MBOX_ENABLE
+      // set the current ramp
+      EST_setMaxCurrentSlope_pu(obj->estHandle,gMaxCurrentSlope);
+
+      // set the speed reference
+      CTRL_setSpd_ref_krpm(ctrlHandle,gMotorVars.SpeedRef_krpm);
+
+      // set the speed acceleration
+      CTRL_setMaxAccel_pu(ctrlHandle,_IQmpy(MAX_ACCEL_KRPMPS_SF,gMotorVars.MaxAccel_krpmps));
+#endif
+      if(Flag_Latch_softwareUpdate)
+      {
+        Flag_Latch_softwareUpdate = false;
+
+        USER_calcPIgains(ctrlHandle);
+
+        // initialize the watch window kp and ki current values with pre-calculated values
+        gMotorVars.Kp_Idq = CTRL_getKp(ctrlHandle,CTRL_Type_PID_Id);
+        gMotorVars.Ki_Idq = CTRL_getKi(ctrlHandle,CTRL_Type_PID_Id);
+
+        // initialize the watch window kp and ki values with pre-calculated values
+        gMotorVars.Kp_spd = CTRL_getKp(ctrlHandle,CTRL_Type_PID_spd);
+        gMotorVars.Ki_spd = CTRL_getKi(ctrlHandle,CTRL_Type_PID_spd);
+
+        // TIDA-00643 custom values for speed controller
+        gMotorVars.Kp_spd = _IQ(2.000);
+        gMotorVars.Ki_spd = _IQ(0.059);
+      }
+
+    }
+  else
+    {
+      Flag_Latch_softwareUpdate = true;
+
+      // the estimator sets the maximum current slope during identification
+      gMaxCurrentSlope = EST_getMaxCurrentSlope_pu(obj->estHandle);
+    }
+
+  return;
+} // end of runCtrlStateTask() function
+
+
+void runGlobalsTask(void)
+{
+  updateGlobalVariables_motor(ctrlHandle);
+
+  return;
+} // end of runGlobalsTask() function
+
+
+void runMotorCmdTask(void)
+{
+#ifdef MBOX_ENABLE
+  // post the gains, references and flags, mainISR applies them at its next tick
+  postMotorCmd(ctrlHandle);
+#else
+  CTRL_Obj *obj = (CTRL_Obj *)ctrlHandle;
+
+  // update Kp and Ki gains
+  updateKpKiGains(ctrlHandle);
+
+  // enable/disable the forced angle
+  EST_setFlag_enableForceAngle(obj->estHandle,gMotorVars.Flag_enableForceAngle);
+
+  // enable or disable power warp
+  CTRL_setFlag_enablePowerWarp(ctrlHandle,gMotorVars.Flag_enablePowerWarp);
+#endif
+
+  return;
+} // end of runMotorCmdTask() function
+
+
+void runDrvSpiTask(void)
+{
+#ifdef DRV8301_SPI
+  HAL_writeDrvData(halHandle,&gDrvSpi8301Vars);
+
+  HAL_readDrvData(halHandle,&gDrvSpi8301Vars);
+#endif
+#ifdef DRV8305_SPI
+#ifdef FLREC_ENABLE
+  // read the status registers after a trip, they tell the cause of nFAULT
+  if(HAL_getCbcTripFlag(halHandle))
+    {
+      gDrvSpi8305Vars.ReadCmd = true;
+    }
+#endif
+
+  HAL_writeDrvData(halHandle,&gDrvSpi8305Vars);
+
+  HAL_readDrvData(halHandle,&gDrvSpi8305Vars);
+
+#ifdef FLREC_ENABLE
+  gFlrecDrvStatus = (gDrvSpi8305Vars.Stat_Reg_01.OTW ? DRV8305_STATUS01_OTW_BITS : 0)
+                  | (gDrvSpi8305Vars.Stat_Reg_01.VCPH_UVFL ? DRV8305_STATUS01_VCPH_UVFL_BITS : 0)
+                  | (gDrvSpi8305Vars.Stat_Reg_01.VDS_STATUS ? DRV8305_STATUS01_VDS_STATUS_BITS : 0)
+                  | (gDrvSpi8305Vars.Stat_Reg_01.PVDD_OVFL ? DRV8305_STATUS01_PVDD_OVFL_BITS : 0)
+                  | (gDrvSpi8305Vars.Stat_Reg_01.PVDD_UVFL ? DRV8305_STATUS01_PVDD_UVFL_BITS : 0)
+                  | (gDrvSpi8305Vars.Stat_Reg_01.FAULT ? DRV8305_STATUS01_FAULT_BITS : 0);
+#endif
+#endif
+
+  return;
+} // end of runDrvSpiTask() function
+
+
+#ifdef TELEM_ENABLE
+void runTelemTask(void)
+{
+  const uint16_t *pTxData;
+  uint_least16_t numTxBytes;
+
+
+  // build the telemetry frames, the SCIA FIFO takes what fits without waiting
+  gTelemCtrlState = (int32_t)gMotorVars.CtrlState;
+
+  TELEM_run(telemHandle,HAL_readTimerCnt(halHandle,0));
+
+  numTxBytes = TELEM_getTxData(telemHandle,&pTxData);
+  TELEM_advanceTx(telemHandle,HAL_writeSciTxFifo(halHandle,pTxData,numTxBytes));
+
+  return;
+} // end of runTelemTask() function
+#endif
+
+
+#ifdef DSHOT_ENABLE
+void runDshotCmdTask(void)
+{
+#ifdef DSHOT_BIDIR_ENABLE
+  CTRL_Obj *obj = (CTRL_Obj *)ctrlHandle;
+#endif
+
+
+  // the commands ecapISR() posted
+  while(QUEUE_executeEvent(queueHandle))
+    {
+    }
+
+#ifdef DSHOT_BIDIR_ENABLE
+  // the eRPM and the extended telemetry of the replies, there is no temperature sensor
+  DSHOT_setSpeed(dshotHandle,EST_getFm_pu(obj->estHandle));
+  DSHOT_setEdtValues(dshotHandle,
+                     DSHOT_EDT_NO_VALUE,
+                     (int16_t)_IQmpyI32int(gMotorVars.VdcBus_kV,4000),
+                     (int16_t)_IQint(_IQabs(gMotorVars.Iq_A)));
+#endif
+
+  return;
+} // end of runDshotCmdTask() function
+
+
+void runDshotCmd(void *pCmd)
+{
+  // the direction is applied by ecapISR(), the other commands are only shown
+  gDshotCmd = (DSHOT_Cmd_e)(uintptr_t)pCmd;
+
+  return;
+} // end of runDshotCmd() function
+#endif
+
+
+#ifdef SCHED_ENABLE
+uint32_t readSchedTimerCnt(void)
+{
+  return(HAL_readTimerCnt(halHandle,2));
+} // end of readSchedTimerCnt() function
+#endif
+
+
+#ifdef FLREC_ENABLE
+void runFlrecTask(void)
+{
+  if(FLREC_getState(flrecHandle) != FLREC_State_Idle)
+    {
+      // program the next frame or the header, log again after the record
+      if(FLREC_run(flrecHandle) == FLREC_State_Idle)
+        {
+          TRIGLOG_setFlag_arm(flrecLogHandle,true);
+        }
+    }
+  else if(TRIGLOG_getState(flrecLogHandle) == TRIGLOG_State_Done)
+    {
+      if(gMotorVars.Flag_enableSys)
+        {
+          // a fault stops the motor like a controller error, the flash is
+          // only programmed when the motor is stopped
+          gMotorVars.Flag_enableSys = false;
+        }
+      else
+        {
+          // without an erased slot the capture stays in flrecLog until the
+          // next reset prepares one
+          FLREC_start(flrecHandle,flrecLogHandle,FLREC_FRAME_PERIOD_usec);
+        }
+    }
+
+  return;
+} // end of runFlrecTask() function
+
+
+bool eraseFlrecSector(uint16_t *pSector)
+{
+  return(HAL_eraseFlashSector(halHandle,pSector));
+} // end of eraseFlrecSector() function
+
+
+bool programFlrecFlash(uint16_t *pDst,const uint16_t *pSrc,const uint_least16_t numWords)
+{
+  return(HAL_programFlash(halHandle,pDst,pSrc,numWords));
+} // end of programFlrecFlash() function
+
+
+uint32_t readFlrecTimerCnt(void)
+{
+  return(HAL_readTimerCnt(halHandle,0));
+} // end of readFlrecTimerCnt() function
+#endif
+
+
+#ifdef MTPA_ENABLE
+void runMtpaTask(void)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)ctrlHandle;
+
+  if(EST_isMotorIdentified(obj->estHandle))
+    {
+      // a change of the saliency restarts the table, until it is complete
+      // the Id is computed analytically
+      MTPA_setParams(mtpaHandle,
+                     EST_getLs_d_H(obj->estHandle),
+                     EST_getLs_q_H(obj->estHandle),
+                     EST_getFlux_VpHz(obj->estHandle),
+                     USER_IQ_FULL_SCALE_CURRENT_A);
+
+      MTPA_updateTable(mtpaHandle);
+    }
+
+  return;
+} // end of runMtpaTask() function
+#endif
+
+
+#ifdef DSHOT_ENABLE
+__interrupt void ecapISR(void)
+{
+    // CEVT2 and CEVT4 denote a pulse in CAP1/CAP2 and in CAP3/CAP4
+    uint16_t flags = CAP_getIntFlags(halHandle->capHandle);
+    uint32_t cap1 = CAP_getCap1(halHandle->capHandle);
+    uint32_t cap3 = CAP_getCap3(halHandle->capHandle);
+
+    // after a delayed interrupt both pulses are complete, the older first
+    bool flag_cap3First = ((int32_t)(cap1 - cap3) > 0);
+
+    // Clear the flags read, a pulse captured since interrupts again
+    CAP_clearInt(halHandle->capHandle, (CAP_Int_Type_e)(flags & ~CAP_Int_Type_Global));
+    CAP_clearInt(halHandle->capHandle, CAP_Int_Type_Global);
+
+#ifdef DSHOT_BIDIR_ENABLE
+    // A period of the eRPM reply started, give the one after it or end the
+    // reply in the idle period after the last one
+    if (flags & CAP_Int_Type_CTR_PRD)
+    {
+        uint32_t period_cnts, low_cnts;
+
+        if (DSHOT_getReplyPwm(dshotHandle, &period_cnts, &low_cnts))
+        {
+            HAL_writeDshotReplyPeriod(halHandle, period_cnts, low_cnts);
+        }
+        else
+        {
+            HAL_stopDshotReply(halHandle, DSHOT_getReplyEndCnt(dshotHandle));
+        }
+
+        PIE_clearInt(halHandle->pieHandle, PIE_GroupNumber_4);
+        return;
+    }
+#endif
+
+    if ((flags & CAP_Int_Type_CEVT4) && flag_cap3First)
+    {
+        DSHOT_runPulse(dshotHandle, cap3, CAP_getCap4(halHandle->capHandle));
+    }
+
+    if (flags & CAP_Int_Type_CEVT2)
+    {
+        DSHOT_runPulse(dshotHandle, cap1, CAP_getCap2(halHandle->capHandle));
+    }
+
+    if ((flags & CAP_Int_Type_CEVT4) && !flag_cap3First)
+    {
+        DSHOT_runPulse(dshotHandle, cap3, CAP_getCap4(halHandle->capHandle));
+    }
+
+    // Defer the command of a complete frame to the background loop
+    if (DSHOT_getCmd(dshotHandle) != DSHOT_Cmd_None)
+    {
+        EVENT_ArgList argList;
+
+        argList.arg[0] = (void *)(uintptr_t)DSHOT_getCmd(dshotHandle);
+        QUEUE_postEvent(queueHandle, QUEUE_KEY_DSHOT_CMD, (EVENT_Fxn)runDshotCmd, &argList, 1);
+        DSHOT_clearCmd(dshotHandle);
+    }
+
+#ifdef DSHOT_BIDIR_ENABLE
+    // Start the eRPM reply of a complete frame on the same pin
+    {
+        uint32_t startCnt, period_cnts, low_cnts;
+
+        if (DSHOT_getReply(dshotHandle, &startCnt) &&
+            DSHOT_getReplyPwm(dshotHandle, &period_cnts, &low_cnts) &&
+            !HAL_startDshotReply(halHandle, startCnt, period_cnts, low_cnts))
+        {
+            gDshotNumRepliesLate++;
+        }
+    }
+#endif
+
+    // The throttle is zero unless the decoder is armed, 48 starts the motor
+    if ((DSHOT_getState(dshotHandle) == DSHOT_State_Armed) &&
+        (DSHOT_getValue(dshotHandle) >= DSHOT_MIN_THROTTLE))
+    {
+        _iq throttle = DSHOT_getThrottle(dshotHandle);
+
+        gSpeedRef_duty = DSHOT_getFlag_reversed(dshotHandle) ? -throttle : throttle;
+        gMotorVars.Flag_Run_Identify = 1;
+    }
+    else
+    {
+        gSpeedRef_duty = _IQ(0);
+        gMotorVars.Flag_Run_Identify = 0;
+    }
+
+    // Clears an interrupt defined by group number
+    PIE_clearInt(halHandle->pieHandle, PIE_GroupNumber_4);
+}  // end of ecapISR() function
+#else
 __interrupt void ecapISR(void)
 {
     // Clear capture (CAP) interrupt flags
@@ -588,6 +1788,7 @@ __interrupt void ecapISR(void)
     // Clears an interrupt defined by group number
     PIE_clearInt(halHandle->pieHandle, PIE_GroupNumber_4);
 }  // end of ecapISR() function
+#endif
 
 
 //@} //defgroup
@@ -199,6 +199,20 @@ void CAP_setCapOneShot(CAP_Handle capHandle)
     return;
 } // end of CAP_setCapOneShot() function
 
+void CAP_setApwmPolarity(CAP_Handle capHandle, const CAP_ApwmPolarity_e polarity)
+{
+    CAP_Obj *cap = (CAP_Obj *)capHandle;
+
+
+    // clear the bits
+    cap->ECCTL2 &= (~CAP_ECCTL2_APWMPOL_BITS);
+
+    // Set the new value
+    cap->ECCTL2 |= polarity;
+
+    return;
+} // end of CAP_setApwmPolarity() function
+
 void CAP_setModeCap(CAP_Handle capHandle)
 {
     CAP_Obj *cap = (CAP_Obj *)capHandle;
@@ -298,6 +298,14 @@ typedef enum
     CAP_SyncOut_Disable = (2 << 6)    //!< Disables Sync Out
 } CAP_SyncOut_e;
 
+//! \brief Enumeration to define the APWM output polarities
+//!
+typedef enum
+{
+    CAP_ApwmPolarity_High = (0 << 10),     //!< Output is high during the compare time
+    CAP_ApwmPolarity_Low = (1 << 10)       //!< Output is low during the compare time
+} CAP_ApwmPolarity_e;
+
 
 //! \brief Defines the capture (CAP) object
 //!
@@ -424,6 +432,25 @@ static inline uint32_t CAP_getCap4(CAP_Handle capHandle)
     return (cap->CAP4);
 } // end of CAP_getCap4() function
 
+//! \brief     Gets the capture (CAP) interrupt flags
+//! \param[in] capHandle  The capture (CAP) object handle
+//! \return    The set flags, a combination of CAP_Int_Type_e
+static inline uint16_t CAP_getIntFlags(CAP_Handle capHandle)
+{
+    CAP_Obj *cap = (CAP_Obj *)capHandle;
+
+    return (cap->ECEFLG);
+} // end of CAP_getIntFlags() function
+
+//! \brief     Gets the time-stamp counter value
+//! \param[in] capHandle  The capture (CAP) object handle
+static inline uint32_t CAP_getTimestampCounter(CAP_Handle capHandle)
+{
+    CAP_Obj *cap = (CAP_Obj *)capHandle;
+
+    return (cap->TSCTR);
+} // end of CAP_getTimestampCounter() function
+
 //! \brief     (Re-)Arm the capture module
 //! \param[in] capHandle  The capture (CAP) object handle
 static inline void CAP_rearm(CAP_Handle capHandle)
@@ -491,6 +518,35 @@ static inline void CAP_setApwmShadowPeriod(CAP_Handle capHandle, const uint32_t
     return;
 } // end of CAP_setApwmShadowPeriod() function
 
+//! \brief     Sets the APWM shadow compare value
+//! \param[in] capHandle  The capture (CAP) object handle
+//! \param[in] shadowCompare  The APWM shadow compare value
+static inline void CAP_setApwmShadowCompare(CAP_Handle capHandle, const uint32_t shadowCompare)
+{
+    CAP_Obj *cap = (CAP_Obj *)capHandle;
+
+    cap->CAP4 = shadowCompare;
+
+    return;
+} // end of CAP_setApwmShadowCompare() function
+
+//! \brief     Sets the APWM output polarity
+//! \param[in] capHandle  The capture (CAP) object handle
+//! \param[in] polarity  The APWM output polarity
+extern void CAP_setApwmPolarity(CAP_Handle capHandle, const CAP_ApwmPolarity_e polarity);
+
+//! \brief     Sets the time-stamp counter value
+//! \param[in] capHandle  The capture (CAP) object handle
+//! \param[in] count  The time-stamp counter value
+static inline void CAP_setTimestampCounter(CAP_Handle capHandle, const uint32_t count)
+{
+    CAP_Obj *cap = (CAP_Obj *)capHandle;
+
+    cap->TSCTR = count;
+
+    return;
+} // end of CAP_setTimestampCounter() function
+
 //! \brief     Set the stop/wrap mode
 //! \param[in] capHandle  The capture (CAP) object handle
 //! \param[in] stopWrap  The stop/wrap mode to set
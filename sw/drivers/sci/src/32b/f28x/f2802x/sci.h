@@ -260,7 +260,9 @@ typedef enum
   SCI_BaudRate_9_6_kBaud = 194,      //!< Denotes 9.6 kBaud
   SCI_BaudRate_19_2_kBaud = 97,      //!< Denotes 19.2 kBaud
   SCI_BaudRate_57_6_kBaud = 33,      //!< Denotes 57.6 kBaud
-  SCI_BaudRate_115_2_kBaud = 15      //!< Denotes 115.2 kBaud
+  SCI_BaudRate_115_2_kBaud = 15,     //!< Denotes 115.2 kBaud
+  SCI_BaudRate_468_75_kBaud = 3,     //!< Denotes 468.75 kBaud
+  SCI_BaudRate_937_5_kBaud = 1       //!< Denotes 937.5 kBaud
 } SCI_BaudRate_e;
 
 
@@ -0,0 +1,151 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/catch/src/32b/catch.c
+//! \brief  Portable C code.  These functions define the
+//!         back-EMF catch spin (CATCH) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/catch/src/32b/catch.h"
+
+
+// **************************************************************************
+// the functions
+
+CATCH_Handle CATCH_init(void *pMemory,const size_t numBytes)
+{
+  CATCH_Handle handle;
+  CATCH_Obj *obj;
+
+
+  if(numBytes < sizeof(CATCH_Obj))
+    return((CATCH_Handle)NULL);
+
+  // assign the handle
+  handle = (CATCH_Handle)pMemory;
+
+  obj = (CATCH_Obj *)handle;
+
+  obj->Kp = _IQ(0.0);
+  obj->Ki = _IQ(0.0);
+  obj->speedScale = _IQ(0.0);
+  obj->voltageCompScale = _IQ(0.0);
+  obj->minEmf_pu = _IQ(0.0);
+  obj->numLockTicks = 0;
+  obj->numTimeoutTicks = 0;
+
+  CATCH_stop(handle);
+
+  return(handle);
+} // end of CATCH_init() function
+
+
+void CATCH_setParams(CATCH_Handle handle,
+                     const _iq Kp,
+                     const _iq Ki,
+                     const _iq speedScale,
+                     const _iq voltageCompScale,
+                     const _iq minEmf_pu,
+                     const uint_least16_t numLockTicks,
+                     const uint_least16_t numTimeoutTicks)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+
+  obj->Kp = Kp;
+  obj->Ki = Ki;
+  obj->speedScale = speedScale;
+  obj->voltageCompScale = voltageCompScale;
+  obj->minEmf_pu = minEmf_pu;
+  obj->numLockTicks = numLockTicks;
+  obj->numTimeoutTicks = numTimeoutTicks;
+
+  return;
+} // end of CATCH_setParams() function
+
+
+void CATCH_start(CATCH_Handle handle)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+
+  CATCH_stop(handle);
+
+  obj->state = CATCH_State_Track;
+
+  return;
+} // end of CATCH_start() function
+
+
+void CATCH_stop(CATCH_Handle handle)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+  uint_least8_t cnt;
+
+  obj->state = CATCH_State_Idle;
+
+  for(cnt=0;cnt<2;cnt++)
+    {
+      obj->Eab.value[cnt] = _IQ(0.0);
+      obj->Eab_comp.value[cnt] = _IQ(0.0);
+    }
+
+  obj->Emag_pu = _IQ(0.0);
+  obj->err = _IQ(0.0);
+  obj->errFilt = _IQ(0.0);
+  obj->emfAngle_pu = _IQ(0.0);
+  obj->speedTick_pu = _IQ(0.0);
+  obj->numValidTicks = 0;
+  obj->lockCnt = 0;
+  obj->timeoutCnt = 0;
+
+  return;
+} // end of CATCH_stop() function
+
+
+bool CATCH_engage(CATCH_Handle handle)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+
+  if((obj->state != CATCH_State_Track) || !CATCH_isLocked(handle))
+    {
+      return(false);
+    }
+
+  obj->state = CATCH_State_Engage;
+
+  return(true);
+} // end of CATCH_engage() function
+
+// end of file
@@ -0,0 +1,424 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _CATCH_H_
+#define _CATCH_H_
+
+//! \file   modules/catch/src/32b/catch.h
+//! \brief  Contains the public interface to the
+//!         back-EMF catch spin (CATCH) module routines
+//!
+//!         Finds the angle and the speed of a spinning rotor from the
+//!         terminal voltages while the bridge is in high impedance, so that
+//!         the controller starts on a windmilling propeller without first
+//!         braking it to rest.  With all switches off the stator carries no
+//!         current and the phase voltages are the back-EMF plus the floating
+//!         neutral, the Clarke transform removes the neutral.  The back-EMF
+//!         of a rotor at angle th is w*flux*(-sin(th),cos(th)), it leads the
+//!         rotor by a quarter turn in the direction of rotation.
+//!
+//!         The voltage feedback of the board has a first order filter, its
+//!         lag and attenuation are undone with 1 + j*w/pole as in the OBS
+//!         module.  The angle of the back-EMF on the first two ticks above
+//!         the smallest magnitude gives the phase and the speed, a type 2
+//!         PLL then tracks it.  The rotor is caught once the PLL error stays
+//!         within CATCH_LOCK_ERR for the lock time.  Without a lock for the
+//!         timeout, e.g. a rotor at rest, the controller starts as before.
+//!
+//!         CATCH_run() is called every ISR tick while the bridge is off.
+//!         CATCH_engage() hands the caught rotor to the controller, on its
+//!         next tick the controller takes the angle and the speed and starts
+//!         its current controllers at the back-EMF so that the bridge takes
+//!         over at zero current.  The PWM is enabled after that tick.
+//!
+//!         Above the speed where the line to line back-EMF exceeds the DC
+//!         bus the diodes rectify into the bus and clamp the terminals, the
+//!         back-EMF is then distorted and the lock may not be reached.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+#include "sw/modules/math/src/32b/math.h"
+
+
+//!
+//!
+//! \defgroup CATCH CATCH
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the largest filtered PLL error of a locked tick, about the sine of the angle error
+//!
+#define CATCH_LOCK_ERR              (_IQ(0.05))
+
+//! \brief Defines the shift of the PLL error filter, a time constant of 64 ticks
+//!        The ADC clips the filtered feedback of the phase held at ground below
+//!        zero, the error then ripples at multiples of the electrical frequency
+//!
+#define CATCH_ERR_FILTER_SHIFT      (6)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Enumeration for the catch spin states
+//!
+typedef enum
+{
+  CATCH_State_Idle = 0,     //!< the bridge is driven, the catch does not run
+  CATCH_State_Track,        //!< the bridge is off, the PLL tracks the back-EMF
+  CATCH_State_Engage,       //!< the controller takes over the rotor on its next tick
+  CATCH_State_Engaged,      //!< the controller took over, the PWM is to be enabled
+  CATCH_NumStates
+} CATCH_State_e;
+
+
+//! \brief Defines the back-EMF catch spin (CATCH) object
+//!
+typedef struct _CATCH_Obj_
+{
+  CATCH_State_e   state;              //!< the state
+
+  _iq             Kp;                 //!< the proportional gain of the PLL
+  _iq             Ki;                 //!< the integral gain of the PLL
+  _iq             speedScale;         //!< the ISR frequency over the full scale frequency
+  _iq             voltageCompScale;   //!< the angle per tick over the voltage feedback filter pole, 2*pi/(pole_rps*Ts)
+  _iq             minEmf_pu;          //!< the smallest back-EMF magnitude that is tracked, pu
+  uint_least16_t  numLockTicks;       //!< the number of locked ticks after which the rotor is caught
+  uint_least16_t  numTimeoutTicks;    //!< the number of ticks without a lock after which the rotor is left to the controller
+
+  MATH_vec2       Eab;                //!< the back-EMF of the voltage feedback, pu
+  MATH_vec2       Eab_comp;           //!< the back-EMF with the filter lag undone, pu
+  _iq             Emag_pu;            //!< the magnitude of the back-EMF, pu
+  _iq             err;                //!< the angle error signal, about the sine of the angle error
+  _iq             errFilt;            //!< the low pass filtered angle error signal, used for the lock
+  _iq             emfAngle_pu;        //!< the PLL angle of the back-EMF, -0.5 to 0.5 pu
+  _iq             speedTick_pu;       //!< the PLL integrator, angle per tick, pu
+  uint_least16_t  numValidTicks;      //!< the number of consecutive ticks above the smallest back-EMF, up to two
+  uint_least16_t  lockCnt;            //!< the number of consecutive locked ticks
+  uint_least16_t  timeoutCnt;         //!< the number of ticks without a lock
+} CATCH_Obj;
+
+
+//! \brief Defines the CATCH handle
+//!
+typedef struct _CATCH_Obj_ *CATCH_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Wraps an angle into -0.5 to 0.5 pu
+//! \param[in] angle_pu  The angle, -1.0 to 1.0 pu
+//! \return    The angle, -0.5 to 0.5 pu
+static inline _iq CATCH_wrapAngle_pu(const _iq angle_pu)
+{
+  if(angle_pu > _IQ(0.5))
+    {
+      return(angle_pu - _IQ(1.0));
+    }
+  else if(angle_pu < _IQ(-0.5))
+    {
+      return(angle_pu + _IQ(1.0));
+    }
+
+  return(angle_pu);
+} // end of CATCH_wrapAngle_pu() function
+
+
+//! \brief     Gets the rotor angle
+//! \param[in] handle  The catch spin (CATCH) handle
+//! \return    The angle of the back-EMF less a quarter turn in the direction of rotation, -0.5 to 0.5 pu
+static inline _iq CATCH_getAngle_pu(CATCH_Handle handle)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+  _iq lead_pu = (obj->speedTick_pu < _IQ(0.0)) ? _IQ(-0.25) : _IQ(0.25);
+
+  return(CATCH_wrapAngle_pu(obj->emfAngle_pu - lead_pu));
+} // end of CATCH_getAngle_pu() function
+
+
+//! \brief     Gets the back-EMF of the voltage feedback
+//! \param[in] handle  The catch spin (CATCH) handle
+//! \return    The pointer to the alpha/beta back-EMF, pu, with the lag of the feedback filter
+static inline const MATH_vec2 *CATCH_getEab_addr(CATCH_Handle handle)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+
+  return(&(obj->Eab));
+} // end of CATCH_getEab_addr() function
+
+
+//! \brief     Gets the quadrature back-EMF
+//! \param[in] handle  The catch spin (CATCH) handle
+//! \return    The magnitude of the back-EMF in the direction of rotation, pu
+static inline _iq CATCH_getEmf_pu(CATCH_Handle handle)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+
+  return((obj->speedTick_pu < _IQ(0.0)) ? -obj->Emag_pu : obj->Emag_pu);
+} // end of CATCH_getEmf_pu() function
+
+
+//! \brief     Gets the angle error signal of the PLL
+//! \param[in] handle  The catch spin (CATCH) handle
+//! \return    The back-EMF across the PLL angle over its magnitude
+static inline _iq CATCH_getErr(CATCH_Handle handle)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+
+  return(obj->err);
+} // end of CATCH_getErr() function
+
+
+//! \brief     Gets the electrical frequency
+//! \param[in] handle  The catch spin (CATCH) handle
+//! \return    The PLL speed, pu
+static inline _iq CATCH_getFm_pu(CATCH_Handle handle)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+
+  return(_IQmpy(obj->speedTick_pu,obj->speedScale));
+} // end of CATCH_getFm_pu() function
+
+
+//! \brief     Gets the state
+//! \param[in] handle  The catch spin (CATCH) handle
+//! \return    The state
+static inline CATCH_State_e CATCH_getState(CATCH_Handle handle)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+
+  return(obj->state);
+} // end of CATCH_getState() function
+
+
+//! \brief     Determines if the PLL is locked to the back-EMF of a spinning rotor
+//! \param[in] handle  The catch spin (CATCH) handle
+//! \return    The flag
+static inline bool CATCH_isLocked(CATCH_Handle handle)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+
+  return((obj->state != CATCH_State_Idle) && (obj->lockCnt >= obj->numLockTicks));
+} // end of CATCH_isLocked() function
+
+
+//! \brief     Determines if the controller may start
+//! \param[in] handle  The catch spin (CATCH) handle
+//! \return    The flag, false while a lock is still being acquired
+static inline bool CATCH_isDone(CATCH_Handle handle)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+
+  return((obj->state != CATCH_State_Track) || CATCH_isLocked(handle) ||
+         (obj->timeoutCnt >= obj->numTimeoutTicks));
+} // end of CATCH_isDone() function
+
+
+//! \brief     Denotes that the controller took over the rotor
+//! \param[in] handle  The catch spin (CATCH) handle
+static inline void CATCH_setEngaged(CATCH_Handle handle)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+
+  obj->state = CATCH_State_Engaged;
+
+  return;
+} // end of CATCH_setEngaged() function
+
+
+//! \brief     Initializes the back-EMF catch spin (CATCH) module
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The catch spin (CATCH) handle
+extern CATCH_Handle CATCH_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Sets the catch spin parameters
+//! \param[in] handle            The catch spin (CATCH) handle
+//! \param[in] Kp                The proportional gain of the PLL
+//! \param[in] Ki                The integral gain of the PLL
+//! \param[in] speedScale        The ISR frequency over the full scale frequency
+//! \param[in] voltageCompScale  The angle per tick over the voltage feedback filter pole, 2*pi/(pole_rps*Ts), zero without one
+//! \param[in] minEmf_pu         The smallest back-EMF magnitude that is tracked, pu
+//! \param[in] numLockTicks      The number of locked ticks after which the rotor is caught
+//! \param[in] numTimeoutTicks   The number of ticks without a lock after which the controller may start
+extern void CATCH_setParams(CATCH_Handle handle,
+                            const _iq Kp,
+                            const _iq Ki,
+                            const _iq speedScale,
+                            const _iq voltageCompScale,
+                            const _iq minEmf_pu,
+                            const uint_least16_t numLockTicks,
+                            const uint_least16_t numTimeoutTicks);
+
+
+//! \brief     Starts tracking the back-EMF, call when the bridge is turned off
+//! \param[in] handle  The catch spin (CATCH) handle
+extern void CATCH_start(CATCH_Handle handle);
+
+
+//! \brief     Stops tracking, call before the bridge is driven
+//! \param[in] handle  The catch spin (CATCH) handle
+extern void CATCH_stop(CATCH_Handle handle);
+
+
+//! \brief     Hands a caught rotor to the controller on its next tick
+//! \param[in] handle  The catch spin (CATCH) handle
+//! \return    The flag, false and the state unchanged unless the rotor is caught
+extern bool CATCH_engage(CATCH_Handle handle);
+
+
+//! \brief     Runs the back-EMF tracking
+//! \details   Call every ISR tick with the phase voltage feedback, the
+//!            tracking continues until the controller took over.
+//! \param[in] handle  The catch spin (CATCH) handle
+//! \param[in] pVabc   The pointer to the phase voltages, pu
+static inline void CATCH_run(CATCH_Handle handle,const MATH_vec3 *pVabc)
+{
+  CATCH_Obj *obj = (CATCH_Obj *)handle;
+  _iq Ealpha,Ebeta;
+
+  if((obj->state != CATCH_State_Track) && (obj->state != CATCH_State_Engage))
+    {
+      return;
+    }
+
+  // the Clarke transform of all three phases, the floating neutral drops out
+  Ealpha = _IQmpy((pVabc->value[0] << 1) - pVabc->value[1] - pVabc->value[2],_IQ(MATH_ONE_OVER_THREE));
+  Ebeta = _IQmpy(pVabc->value[1] - pVabc->value[2],_IQ(MATH_ONE_OVER_SQRT_THREE));
+
+  obj->Eab.value[0] = Ealpha;
+  obj->Eab.value[1] = Ebeta;
+
+  // undo the lag and the attenuation of the voltage feedback filter
+  {
+    _iq b = _IQmpy(obj->voltageCompScale,obj->speedTick_pu);
+
+    obj->Eab_comp.value[0] = Ealpha - _IQmpy(Ebeta,b);
+    obj->Eab_comp.value[1] = Ebeta + _IQmpy(Ealpha,b);
+  }
+
+  obj->Emag_pu = _IQmag(obj->Eab_comp.value[0],obj->Eab_comp.value[1]);
+
+  if(obj->timeoutCnt < obj->numTimeoutTicks)
+    {
+      obj->timeoutCnt++;
+    }
+
+  if(obj->Emag_pu < obj->minEmf_pu)
+    {
+      // too slow to track, the speed is found again from the next two ticks
+      obj->numValidTicks = 0;
+      obj->lockCnt = 0;
+      obj->err = _IQ(0.0);
+      obj->errFilt = _IQ(0.0);
+
+      return;
+    }
+
+  if(obj->numValidTicks < 2)
+    {
+      // the phase of the first tick, the speed from the phase of the second
+      _iq emfAngle_pu = CATCH_wrapAngle_pu(_IQatan2PU(obj->Eab_comp.value[1],obj->Eab_comp.value[0]));
+
+      if(obj->numValidTicks == 1)
+        {
+          obj->speedTick_pu = CATCH_wrapAngle_pu(emfAngle_pu - obj->emfAngle_pu);
+        }
+
+      obj->emfAngle_pu = emfAngle_pu;
+      obj->numValidTicks++;
+
+      return;
+    }
+
+  // run the PLL on the angle predicted for this tick
+  {
+    _iq anglePred_pu = CATCH_wrapAngle_pu(obj->emfAngle_pu + obj->speedTick_pu);
+    _iq cosTh = _IQcosPU(anglePred_pu);
+    _iq sinTh = _IQsinPU(anglePred_pu);
+    _iq Ecross = _IQmpy(obj->Eab_comp.value[1],cosTh) - _IQmpy(obj->Eab_comp.value[0],sinTh);
+    _iq err = _IQdiv(Ecross,obj->Emag_pu);
+
+    obj->err = err;
+
+    // rounded, the truncation of _IQmpy() would bias the speed
+    obj->speedTick_pu += _IQrmpy(obj->Ki,err);
+    obj->emfAngle_pu = CATCH_wrapAngle_pu(anglePred_pu + _IQmpy(obj->Kp,err));
+
+    obj->errFilt += (err - obj->errFilt) >> CATCH_ERR_FILTER_SHIFT;
+
+    if(_IQabs(obj->errFilt) < CATCH_LOCK_ERR)
+      {
+        if(obj->lockCnt < obj->numLockTicks)
+          {
+            obj->lockCnt++;
+          }
+      }
+    else
+      {
+        obj->lockCnt = 0;
+      }
+  }
+
+  if(obj->lockCnt >= obj->numLockTicks)
+    {
+      obj->timeoutCnt = 0;
+    }
+
+  return;
+} // end of CATCH_run() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _CATCH_H_ definition
+
@@ -141,6 +141,37 @@ static inline void CLARKE_run(CLARKE_Handle handle,const MATH_vec3 *pInVec,MATH_
 } // end of CLARKE_run() function
 
 
+//! \brief     Runs the Clarke transform module for a given number of sensors
+//! \details   Same as CLARKE_run() with the number of sensors as a parameter, a
+//!            constant folds the branch at compile time
+//! \param[in] handle      The Clarke transform handle
+//! \param[in] numSensors  The number of sensors, 2 or 3
+//! \param[in] pInVec      The pointer to the input vector
+//! \param[in] pOutVec     The pointer to the output vector
+static inline void CLARKE_run_numSensors(CLARKE_Handle handle,const uint_least8_t numSensors,
+                                         const MATH_vec3 *pInVec,MATH_vec2 *pOutVec)
+{
+  CLARKE_Obj *obj = (CLARKE_Obj *)handle;
+
+  _iq alpha_sf = obj->alpha_sf;
+  _iq beta_sf = obj->beta_sf;
+
+
+  if(numSensors == 3)
+    {
+      pOutVec->value[0] = _IQmpy(lshft_1(pInVec->value[0]) - (pInVec->value[1] + pInVec->value[2]),alpha_sf);
+      pOutVec->value[1] = _IQmpy(pInVec->value[1] - pInVec->value[2],beta_sf);
+    }
+  else if(numSensors == 2)
+    {
+      pOutVec->value[0] = _IQmpy(pInVec->value[0],alpha_sf);
+      pOutVec->value[1] = _IQmpy(pInVec->value[0] + lshft_1(pInVec->value[1]),beta_sf);
+    }
+
+  return;
+} // end of CLARKE_run_numSensors() function
+
+
 //! \brief     Runs the Clarke transform module for two inputs
 //! \param[in] handle  The Clarke transform handle
 //! \param[in] pInVec        The pointer to the input vector
@@ -196,17 +196,26 @@ void CTRL_run(CTRL_Handle handle,HAL_Handle halHandle,
               const HAL_AdcData_t *pAdcData,
               HAL_PwmData_t *pPwmData)
 {
+#ifdef CTRL_STATIC_CONFIG
+  // the decimation is a compile time constant, a ratio of one runs every tick
+  bool flag_runCtrl = !CTRL_COUNT_ISR_TICKS ||
+                      (CTRL_getCount_isr(handle) >= CTRL_STATIC_NUM_ISR_TICKS_PER_CTRL_TICK);
+#else
   uint_least16_t count_isr = CTRL_getCount_isr(handle);
   uint_least16_t numIsrTicksPerCtrlTick = CTRL_getNumIsrTicksPerCtrlTick(handle);
+  bool flag_runCtrl = (count_isr >= numIsrTicksPerCtrlTick);
+#endif
 
 
   // if needed, run the controller
-  if(count_isr >= numIsrTicksPerCtrlTick)
+  if(flag_runCtrl)
     {
       CTRL_State_e ctrlState = CTRL_getState(handle);
 
+#if CTRL_COUNT_ISR_TICKS
       // reset the isr count
       CTRL_resetCounter_isr(handle);
+#endif
 
       // increment the state counter
       CTRL_incrCounter_state(handle);
@@ -219,16 +228,24 @@ void CTRL_run(CTRL_Handle handle,HAL_Handle halHandle,
         {
     	  CTRL_Obj *obj = (CTRL_Obj *)handle;
 
+#if CTRL_COUNT_CURRENT_TICKS
           // increment the current count
           CTRL_incrCounter_current(handle);
+#endif
 
+#if CTRL_COUNT_SPEED_TICKS
           // increment the speed count
           CTRL_incrCounter_speed(handle);
+#endif
 
           if(EST_getState(obj->estHandle) >= EST_State_MotorIdentified)
             {
               // run the online controller
+#ifdef CTRL_FUSED_CURRENT_LOOP
+              CTRL_runOnLine_UserFused(handle,pAdcData,pPwmData);
+#else
               CTRL_runOnLine_User(handle,pAdcData,pPwmData);
+#endif
             }
           else
             {
@@ -249,11 +266,13 @@ void CTRL_run(CTRL_Handle handle,HAL_Handle halHandle,
           pPwmData->Tabc.value[2] = _IQ(0.0);
         }
     }
+#if CTRL_COUNT_ISR_TICKS
   else
     {
       // increment the isr count
       CTRL_incrCounter_isr(handle);
     }
+#endif
 
   return;
 } // end of CTRL_run() function
@@ -490,8 +509,6 @@ void CTRL_setSpd_ref_krpm(CTRL_Handle handle,const _iq spd_ref_krpm)
 
 void CTRL_setup(CTRL_Handle handle)
 {
-  CTRL_Obj *obj = (CTRL_Obj *)handle;
-
   uint_least16_t count_traj = CTRL_getCount_traj(handle);
   uint_least16_t numCtrlTicksPerTrajTick = CTRL_getNumCtrlTicksPerTrajTick(handle);
 
@@ -499,8 +516,6 @@ void CTRL_setup(CTRL_Handle handle)
   // as needed, update the trajectory
   if(count_traj >= numCtrlTicksPerTrajTick)
     {
-      _iq intValue_Id = TRAJ_getIntValue(obj->trajHandle_Id);
-
       // reset the trajectory count
       CTRL_resetCounter_traj(handle);
 
@@ -54,6 +54,7 @@
 #include "sw/modules/svgen/src/32b/svgen.h"
 #include "sw/modules/traj/src/32b/traj.h"
 #include "sw/modules/ctrl/src/32b/ctrl_obj.h"
+#include "sw/modules/isr_prof/src/32b/isr_prof.h"
 
 #include "sw/modules/types/src/types.h"
 
@@ -72,13 +73,97 @@ extern "C" {
 #endif
 
 
+// **************************************************************************
+// the defines
+
+#ifdef CTRL_STATIC_CONFIG
+//! \brief Defines the decimation ratios and the number of sensors as the compile
+//!        time constants of user.h
+//! \details With CTRL_STATIC_CONFIG the online controller does not read the
+//!          corresponding CTRL and CLARKE object members, CTRL_setParams() must
+//!          be called with the values of USER_setParams().  A ratio of one
+//!          needs no counter, the counter is then not maintained.
+//!
+#define CTRL_STATIC_NUM_ISR_TICKS_PER_CTRL_TICK       (USER_NUM_ISR_TICKS_PER_CTRL_TICK)
+#define CTRL_STATIC_NUM_CTRL_TICKS_PER_CURRENT_TICK   (USER_NUM_CTRL_TICKS_PER_CURRENT_TICK)
+#define CTRL_STATIC_NUM_CTRL_TICKS_PER_SPEED_TICK     (USER_NUM_CTRL_TICKS_PER_SPEED_TICK)
+#define CTRL_STATIC_NUM_CURRENT_SENSORS               (USER_NUM_CURRENT_SENSORS)
+#define CTRL_STATIC_NUM_VOLTAGE_SENSORS               (USER_NUM_VOLTAGE_SENSORS)
+
+#if (CTRL_STATIC_NUM_CURRENT_SENSORS != 2) && (CTRL_STATIC_NUM_CURRENT_SENSORS != 3)
+#error "CTRL_STATIC_CONFIG supports 2 or 3 current sensors"
+#endif
+
+#if (CTRL_STATIC_NUM_VOLTAGE_SENSORS != 3)
+#error "CTRL_STATIC_CONFIG supports 3 voltage sensors"
+#endif
+
+//! \brief Defines whether the ISR, current and speed tick counters are needed
+//!
+#define CTRL_COUNT_ISR_TICKS        (CTRL_STATIC_NUM_ISR_TICKS_PER_CTRL_TICK > 1)
+#define CTRL_COUNT_CURRENT_TICKS    (CTRL_STATIC_NUM_CTRL_TICKS_PER_CURRENT_TICK > 1)
+#define CTRL_COUNT_SPEED_TICKS      (CTRL_STATIC_NUM_CTRL_TICKS_PER_SPEED_TICK > 1)
+#else
+#define CTRL_COUNT_ISR_TICKS        (1)
+#define CTRL_COUNT_CURRENT_TICKS    (1)
+#define CTRL_COUNT_SPEED_TICKS      (1)
+#endif
+
+//! \brief Defines the bound of the difference between the rotated IQ30 phasor of
+//!        CTRL_computePhasorDelayComp() and the IQ30 sin/cos of the compensated
+//!        angle, in IQ30 LSB
+//! \details Holds for compensation angles up to CTRL_PHASOR_ROT_MAX_ANGLE_pu.  It
+//!          covers the error of two IQmath sin/cos evaluations and of the rotation,
+//!          measured on the host IQmath with one LSB of margin.
+//!
+#define CTRL_PHASOR_ROT_ERR_IQ30          (7)
+
+//! \brief Defines the largest compensation angle rotated by CTRL_computePhasorDelayComp()
+//!
+#define CTRL_PHASOR_ROT_MAX_ANGLE_pu      _IQ(0.0625)
+
+//! \brief Defines 2*pi in IQ28
+//! \details Written out, since _IQ28() rounds the constant to float.
+//!
+#define CTRL_TWO_PI_IQ28                  ((_iq28)1686629713)
+
+
+#if defined(HFI_ENABLE) && defined(CTRL_FUSED_CURRENT_LOOP)
+#error "HFI_ENABLE is only supported by CTRL_runOnLine_User()"
+#endif
+
+#if defined(OBS_ENABLE) && defined(CTRL_FUSED_CURRENT_LOOP)
+#error "OBS_ENABLE is only supported by CTRL_runOnLine_User()"
+#endif
+
+#if defined(HCOMP_ENABLE) && defined(CTRL_FUSED_CURRENT_LOOP)
+#error "HCOMP_ENABLE is only supported by CTRL_runOnLine_User()"
+#endif
+
+#if defined(MTPA_ENABLE) && defined(CTRL_FUSED_CURRENT_LOOP)
+#error "MTPA_ENABLE is only supported by CTRL_runOnLine_User()"
+#endif
+
+#if defined(CATCH_ENABLE) && defined(CTRL_FUSED_CURRENT_LOOP)
+#error "CATCH_ENABLE is only supported by CTRL_runOnLine_User()"
+#endif
+
+#if defined(CATCH_ENABLE) && defined(HFI_ENABLE)
+#error "CATCH_ENABLE is not supported with HFI_ENABLE, the injection finds the angle again at every start"
+#endif
+
+#if defined(REGEN_ENABLE) && defined(CTRL_FUSED_CURRENT_LOOP)
+#error "REGEN_ENABLE is only supported by CTRL_runOnLine_User()"
+#endif
+
+
 // **************************************************************************
 // the function prototypes
 
 
 //! \brief     Adds the Vdq offset to the Vdq values
 //! \param[in] handle        The controller (CTRL) handle
-inline void CTRL_addVdq_offset(CTRL_Handle handle)
+static inline void CTRL_addVdq_offset(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -92,7 +177,7 @@ inline void CTRL_addVdq_offset(CTRL_Handle handle)
 //! \brief      Gets the current loop count
 //! \param[in]  handle  The controller (CTRL) handle
 //! \return    The current loop count
-inline uint_least16_t CTRL_getCount_current(CTRL_Handle handle)
+static inline uint_least16_t CTRL_getCount_current(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -103,7 +188,7 @@ inline uint_least16_t CTRL_getCount_current(CTRL_Handle handle)
 //! \brief      Gets the isr count
 //! \param[in]  handle  The controller (CTRL) handle
 //! \return    The isr count
-inline uint_least16_t CTRL_getCount_isr(CTRL_Handle handle)
+static inline uint_least16_t CTRL_getCount_isr(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -114,7 +199,7 @@ inline uint_least16_t CTRL_getCount_isr(CTRL_Handle handle)
 //! \brief      Gets the speed loop count
 //! \param[in]  handle  The controller (CTRL) handle
 //! \return    The speed loop count
-inline uint_least16_t CTRL_getCount_speed(CTRL_Handle handle)
+static inline uint_least16_t CTRL_getCount_speed(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -125,7 +210,7 @@ inline uint_least16_t CTRL_getCount_speed(CTRL_Handle handle)
 //! \brief      Gets the state count 
 //! \param[in]  handle  The controller (CTRL) handle
 //! \return     The state count
-inline uint_least32_t CTRL_getCount_state(CTRL_Handle handle)
+static inline uint_least32_t CTRL_getCount_state(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -136,7 +221,7 @@ inline uint_least32_t CTRL_getCount_state(CTRL_Handle handle)
 //! \brief      Gets the trajectory loop count
 //! \param[in]  handle  The controller (CTRL) handle
 //! \return     The trajectory loop count
-inline uint_least16_t CTRL_getCount_traj(CTRL_Handle handle)
+static inline uint_least16_t CTRL_getCount_traj(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -147,7 +232,7 @@ inline uint_least16_t CTRL_getCount_traj(CTRL_Handle handle)
 //! \brief      Gets the controller execution frequency
 //! \param[in]  handle  The controller (CTRL) handle
 //! \return     The controller execution frequency, Hz
-inline uint_least32_t CTRL_getCtrlFreq(CTRL_Handle handle)
+static inline uint_least32_t CTRL_getCtrlFreq(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -158,7 +243,7 @@ inline uint_least32_t CTRL_getCtrlFreq(CTRL_Handle handle)
 //! \brief      Gets the controller execution period
 //! \param[in]  handle  The controller (CTRL) handle
 //! \return     The controller execution period, sec
-inline float_t CTRL_getCtrlPeriod_sec(CTRL_Handle handle)
+static inline float_t CTRL_getCtrlPeriod_sec(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -169,7 +254,7 @@ inline float_t CTRL_getCtrlPeriod_sec(CTRL_Handle handle)
 //! \brief     Gets the error code from the controller (CTRL) object
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The error code
-inline CTRL_ErrorCode_e CTRL_getErrorCode(CTRL_Handle handle)
+static inline CTRL_ErrorCode_e CTRL_getErrorCode(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -180,7 +265,7 @@ inline CTRL_ErrorCode_e CTRL_getErrorCode(CTRL_Handle handle)
 //! \brief     Gets the estimator handle for a given controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The estimator handle for the given controller
-inline EST_Handle CTRL_getEstHandle(CTRL_Handle handle)
+static inline EST_Handle CTRL_getEstHandle(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -201,7 +286,7 @@ static inline _iq CTRL_getFbackValue_spd_pu(CTRL_Handle handle)
 //! \brief     Gets the enable controller flag value from the estimator
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The enable controller flag value
-inline bool CTRL_getFlag_enableCtrl(CTRL_Handle handle)
+static inline bool CTRL_getFlag_enableCtrl(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -212,7 +297,7 @@ inline bool CTRL_getFlag_enableCtrl(CTRL_Handle handle)
 //! \brief     Gets the enable current controllers flag value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The enable current controller flag value
-inline bool CTRL_getFlag_enableCurrentCtrl(CTRL_Handle handle)
+static inline bool CTRL_getFlag_enableCurrentCtrl(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -223,7 +308,7 @@ inline bool CTRL_getFlag_enableCurrentCtrl(CTRL_Handle handle)
 //! \brief     Gets the enable DC bus compensation flag value from the estimator
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The enable DC bus compensation flag value
-inline bool CTRL_getFlag_enableDcBusComp(CTRL_Handle handle)
+static inline bool CTRL_getFlag_enableDcBusComp(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -234,7 +319,7 @@ inline bool CTRL_getFlag_enableDcBusComp(CTRL_Handle handle)
 //! \brief     Gets the PowerWarp enable flag value from the estimator
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The PowerWarp enable flag value
-inline bool CTRL_getFlag_enablePowerWarp(CTRL_Handle handle)
+static inline bool CTRL_getFlag_enablePowerWarp(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -245,7 +330,7 @@ inline bool CTRL_getFlag_enablePowerWarp(CTRL_Handle handle)
 //! \brief     Gets the enable offset flag value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The enable offset flag value
-inline bool CTRL_getFlag_enableOffset(CTRL_Handle handle)
+static inline bool CTRL_getFlag_enableOffset(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -256,7 +341,7 @@ inline bool CTRL_getFlag_enableOffset(CTRL_Handle handle)
 //! \brief     Gets the enable speed control flag value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The enable speed control flag value
-inline bool CTRL_getFlag_enableSpeedCtrl(CTRL_Handle handle)
+static inline bool CTRL_getFlag_enableSpeedCtrl(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -267,7 +352,7 @@ inline bool CTRL_getFlag_enableSpeedCtrl(CTRL_Handle handle)
 //! \brief     Gets the enable user motor parameters flag value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The enable user motor parameters flag value
-inline bool CTRL_getFlag_enableUserMotorParams(CTRL_Handle handle)
+static inline bool CTRL_getFlag_enableUserMotorParams(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -294,7 +379,7 @@ void CTRL_getIab_filt_pu(CTRL_Handle handle,MATH_vec2 *pIab_filt_pu);
 //! \brief     Gets the alpha/beta filtered current vector memory address from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The alpha/beta filtered current vector memory address
-inline MATH_vec2 *CTRL_getIab_filt_addr(CTRL_Handle handle)
+static inline MATH_vec2 *CTRL_getIab_filt_addr(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -305,7 +390,7 @@ inline MATH_vec2 *CTRL_getIab_filt_addr(CTRL_Handle handle)
 //! \brief     Gets the alpha/beta current input vector memory address from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The alpha/beta current input vector memory address
-inline MATH_vec2 *CTRL_getIab_in_addr(CTRL_Handle handle)
+static inline MATH_vec2 *CTRL_getIab_in_addr(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -322,7 +407,7 @@ void CTRL_getIab_in_pu(CTRL_Handle handle,MATH_vec2 *pIab_in_pu);
 //! \brief     Gets the direct current input value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The direct current input value, pu
-inline _iq CTRL_getId_in_pu(CTRL_Handle handle)
+static inline _iq CTRL_getId_in_pu(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -333,7 +418,7 @@ inline _iq CTRL_getId_in_pu(CTRL_Handle handle)
 //! \brief     Gets the direct current (Id) reference value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The direct current reference value, pu
-inline _iq CTRL_getId_ref_pu(CTRL_Handle handle)
+static inline _iq CTRL_getId_ref_pu(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -344,7 +429,7 @@ inline _iq CTRL_getId_ref_pu(CTRL_Handle handle)
 //! \brief     Gets the direct/quadrature current input vector memory address from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The direct/quadrature current input vector memory address
-inline MATH_vec2 *CTRL_getIdq_in_addr(CTRL_Handle handle)
+static inline MATH_vec2 *CTRL_getIdq_in_addr(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -378,7 +463,7 @@ static inline _iq CTRL_getId_offset_pu(CTRL_Handle handle)
 //! \brief     Gets the Id rated current value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The Id rated current value, pu
-inline _iq CTRL_getIdRated_pu(CTRL_Handle handle)
+static inline _iq CTRL_getIdRated_pu(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -389,7 +474,7 @@ inline _iq CTRL_getIdRated_pu(CTRL_Handle handle)
 //! \brief     Gets the quadrature current input value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The quadrature current input value, pu
-inline _iq CTRL_getIq_in_pu(CTRL_Handle handle)
+static inline _iq CTRL_getIq_in_pu(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -411,7 +496,7 @@ static inline _iq CTRL_getIq_offset_pu(CTRL_Handle handle)
 //! \brief     Gets the quadrature current (Iq) reference value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The quadrature current reference value, pu
-inline _iq CTRL_getIq_ref_pu(CTRL_Handle handle)
+static inline _iq CTRL_getIq_ref_pu(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -444,7 +529,7 @@ static inline _iq *CTRL_getIq_ref_pu_addr(CTRL_Handle handle)
 //! \param[in] handle    The controller (CTRL) handle
 //! \param[in] ctrlType  The controller type
 //! \return    The Ki value
-inline _iq CTRL_getKi(CTRL_Handle handle,const CTRL_Type_e ctrlType)
+static inline _iq CTRL_getKi(CTRL_Handle handle,const CTRL_Type_e ctrlType)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   _iq Ki = _IQ(0.0);
@@ -470,7 +555,7 @@ inline _iq CTRL_getKi(CTRL_Handle handle,const CTRL_Type_e ctrlType)
 //! \param[in] handle    The controller (CTRL) handle
 //! \param[in] ctrlType  The controller type
 //! \return    The Kd value
-inline _iq CTRL_getKd(CTRL_Handle handle,const CTRL_Type_e ctrlType)
+static inline _iq CTRL_getKd(CTRL_Handle handle,const CTRL_Type_e ctrlType)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   _iq Kd = _IQ(0.0);
@@ -496,7 +581,7 @@ inline _iq CTRL_getKd(CTRL_Handle handle,const CTRL_Type_e ctrlType)
 //! \param[in] handle    The controller (CTRL) handle
 //! \param[in] ctrlType  The controller type
 //! \return    The Kp value
-inline _iq CTRL_getKp(CTRL_Handle handle,const CTRL_Type_e ctrlType)
+static inline _iq CTRL_getKp(CTRL_Handle handle,const CTRL_Type_e ctrlType)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   _iq Kp = _IQ(0.0);
@@ -521,7 +606,7 @@ inline _iq CTRL_getKp(CTRL_Handle handle,const CTRL_Type_e ctrlType)
 //! \brief     Gets the high frequency inductance (Lhf) value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The Lhf value
-inline float_t CTRL_getLhf(CTRL_Handle handle)
+static inline float_t CTRL_getLhf(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -538,7 +623,7 @@ _iq CTRL_getMagCurrent_pu(CTRL_Handle handle);
 //! \brief      Gets the maximum voltage vector
 //! \param[in]  handle  The controller (CTRL) handle
 //! \return     The maximum voltage vector (value betwen 0 and 4/3)
-inline _iq CTRL_getMaxVsMag_pu(CTRL_Handle handle)
+static inline _iq CTRL_getMaxVsMag_pu(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -555,7 +640,7 @@ _iq CTRL_getMaximumSpeed_pu(CTRL_Handle handle);
 //! \brief     Gets the motor rated flux from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The motor rated flux, V*sec
-inline float_t CTRL_getMotorRatedFlux(CTRL_Handle handle)
+static inline float_t CTRL_getMotorRatedFlux(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   
@@ -566,7 +651,7 @@ inline float_t CTRL_getMotorRatedFlux(CTRL_Handle handle)
 //! \brief     Gets the motor type from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The motor type
-inline MOTOR_Type_e CTRL_getMotorType(CTRL_Handle handle)
+static inline MOTOR_Type_e CTRL_getMotorType(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   
@@ -577,7 +662,7 @@ inline MOTOR_Type_e CTRL_getMotorType(CTRL_Handle handle)
 //! \brief     Gets the number of controller clock ticks per current controller clock tick
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The number of controller clock ticks per estimator clock tick
-inline uint_least16_t CTRL_getNumCtrlTicksPerCurrentTick(CTRL_Handle handle)
+static inline uint_least16_t CTRL_getNumCtrlTicksPerCurrentTick(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   
@@ -588,7 +673,7 @@ inline uint_least16_t CTRL_getNumCtrlTicksPerCurrentTick(CTRL_Handle handle)
 //! \brief     Gets the number of controller clock ticks per speed controller clock tick
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The number of controller clock ticks per speed clock tick
-inline uint_least16_t CTRL_getNumCtrlTicksPerSpeedTick(CTRL_Handle handle)
+static inline uint_least16_t CTRL_getNumCtrlTicksPerSpeedTick(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   
@@ -599,7 +684,7 @@ inline uint_least16_t CTRL_getNumCtrlTicksPerSpeedTick(CTRL_Handle handle)
 //! \brief     Gets the number of controller clock ticks per trajectory clock tick
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The number of controller clock ticks per trajectory clock tick
-inline uint_least16_t CTRL_getNumCtrlTicksPerTrajTick(CTRL_Handle handle)
+static inline uint_least16_t CTRL_getNumCtrlTicksPerTrajTick(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   
@@ -610,7 +695,7 @@ inline uint_least16_t CTRL_getNumCtrlTicksPerTrajTick(CTRL_Handle handle)
 //! \brief     Gets the number of Interrupt Service Routine (ISR) clock ticks per controller clock tick
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The number of Interrupt Service Routine (ISR) clock ticks per controller clock tick
-inline uint_least16_t CTRL_getNumIsrTicksPerCtrlTick(CTRL_Handle handle)
+static inline uint_least16_t CTRL_getNumIsrTicksPerCtrlTick(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   
@@ -622,7 +707,7 @@ inline uint_least16_t CTRL_getNumIsrTicksPerCtrlTick(CTRL_Handle handle)
 //! \param[in] handle    The controller (CTRL) handle
 //! \param[in] ctrlType  The controller type
 //! \return    The reference value, pu
-inline _iq CTRL_getRefValue_pu(CTRL_Handle handle,const CTRL_Type_e ctrlType)
+static inline _iq CTRL_getRefValue_pu(CTRL_Handle handle,const CTRL_Type_e ctrlType)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   _iq ref = _IQ(0.0);
@@ -676,7 +761,7 @@ static inline  _iq CTRL_getRefValue_spd_pu(CTRL_Handle handle)
 //! \brief     Gets the high frequency resistance (Rhf) value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The Rhf value
-inline float_t CTRL_getRhf(CTRL_Handle handle)
+static inline float_t CTRL_getRhf(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -687,7 +772,7 @@ inline float_t CTRL_getRhf(CTRL_Handle handle)
 //! \brief     Gets the R/L value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The the R/L value
-inline float_t CTRL_getRoverL(CTRL_Handle handle)
+static inline float_t CTRL_getRoverL(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -698,7 +783,7 @@ inline float_t CTRL_getRoverL(CTRL_Handle handle)
 //! \brief     Gets the maximum speed value from the controller
 //! \param[in] handle    The controller (CTRL) handle
 //! \return    The maximum speed value, pu
-inline _iq CTRL_getSpd_max_pu(CTRL_Handle handle)
+static inline _iq CTRL_getSpd_max_pu(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -709,7 +794,7 @@ inline _iq CTRL_getSpd_max_pu(CTRL_Handle handle)
 //! \brief     Gets the output speed memory address from the controller
 //! \param[in] handle    The controller (CTRL) handle
 //! \return    The output speed memory address
-inline _iq *CTRL_getSpd_out_addr(CTRL_Handle handle)
+static inline _iq *CTRL_getSpd_out_addr(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -720,7 +805,7 @@ inline _iq *CTRL_getSpd_out_addr(CTRL_Handle handle)
 //! \brief     Gets the output speed value from the controller
 //! \param[in] handle    The controller (CTRL) handle
 //! \return    The output speed value, pu
-inline _iq CTRL_getSpd_out_pu(CTRL_Handle handle)
+static inline _iq CTRL_getSpd_out_pu(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -731,7 +816,7 @@ inline _iq CTRL_getSpd_out_pu(CTRL_Handle handle)
 //! \brief     Gets the output speed reference value from the controller
 //! \param[in] handle    The controller (CTRL) handle
 //! \return    The output speed reference value, pu
-inline _iq CTRL_getSpd_ref_pu(CTRL_Handle handle)
+static inline _iq CTRL_getSpd_ref_pu(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -742,7 +827,7 @@ inline _iq CTRL_getSpd_ref_pu(CTRL_Handle handle)
 //! \brief     Gets the output speed intermediate reference value from the controller
 //! \param[in] handle    The controller (CTRL) handle
 //! \return    The output speed intermediate reference value, pu
-inline _iq CTRL_getSpd_int_ref_pu(CTRL_Handle handle)
+static inline _iq CTRL_getSpd_int_ref_pu(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -764,7 +849,7 @@ static inline _iq CTRL_getSpeed_outMax_pu(CTRL_Handle handle)
 //! \brief     Gets the controller state
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The controller state
-inline CTRL_State_e CTRL_getState(CTRL_Handle handle)
+static inline CTRL_State_e CTRL_getState(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -775,7 +860,7 @@ inline CTRL_State_e CTRL_getState(CTRL_Handle handle)
 //! \brief      Gets the trajectory execution frequency
 //! \param[in]  handle  The controller (CTRL) handle
 //! \return     The trajectory execution frequency, Hz
-inline uint_least32_t CTRL_getTrajFreq(CTRL_Handle handle)
+static inline uint_least32_t CTRL_getTrajFreq(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -786,7 +871,7 @@ inline uint_least32_t CTRL_getTrajFreq(CTRL_Handle handle)
 //! \brief      Gets the trajectory execution period
 //! \param[in]  handle  The controller (CTRL) handle
 //! \return     The trajectory execution period, sec
-inline _iq CTRL_getTrajPeriod_sec(CTRL_Handle handle)
+static inline _iq CTRL_getTrajPeriod_sec(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -803,7 +888,7 @@ void CTRL_getTrajStep(CTRL_Handle handle);
 //! \param[in] handle  The controller (CTRL) handle
 //! \param[in] ctrlType  The controller type
 //! \return    The Ui value
-inline _iq CTRL_getUi(CTRL_Handle handle,const CTRL_Type_e ctrlType)
+static inline _iq CTRL_getUi(CTRL_Handle handle,const CTRL_Type_e ctrlType)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   _iq Ui = _IQ(0.0);
@@ -828,7 +913,7 @@ inline _iq CTRL_getUi(CTRL_Handle handle,const CTRL_Type_e ctrlType)
 //! \brief     Gets the alpha/beta voltage input vector memory address from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The alpha/beta voltage input vector memory address
-inline MATH_vec2 *CTRL_getVab_in_addr(CTRL_Handle handle)
+static inline MATH_vec2 *CTRL_getVab_in_addr(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -845,7 +930,7 @@ void CTRL_getVab_in_pu(CTRL_Handle handle,MATH_vec2 *pVab_in_pu);
 //! \brief     Gets the alpha/beta voltage output vector memory address from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The alpha/beta voltage output vector memory address
-inline MATH_vec2 *CTRL_getVab_out_addr(CTRL_Handle handle)
+static inline MATH_vec2 *CTRL_getVab_out_addr(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -862,7 +947,7 @@ void CTRL_getVab_out_pu(CTRL_Handle handle,MATH_vec2 *pVab_out_pu);
 //! \brief     Gets the direct voltage output value memory address from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The direct voltage output value memory address
-inline _iq *CTRL_getVd_out_addr(CTRL_Handle handle)
+static inline _iq *CTRL_getVd_out_addr(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -873,7 +958,7 @@ inline _iq *CTRL_getVd_out_addr(CTRL_Handle handle)
 //! \brief     Gets the direct voltage output value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The direct voltage output value, pu
-inline _iq CTRL_getVd_out_pu(CTRL_Handle handle)
+static inline _iq CTRL_getVd_out_pu(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -884,7 +969,7 @@ inline _iq CTRL_getVd_out_pu(CTRL_Handle handle)
 //! \brief     Gets the direct/quadrature voltage output vector memory address from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The direct/quadrature voltage output vector memory address
-inline MATH_vec2 *CTRL_getVdq_out_addr(CTRL_Handle handle)
+static inline MATH_vec2 *CTRL_getVdq_out_addr(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -907,7 +992,7 @@ void CTRL_getVersion(CTRL_Handle handle,CTRL_Version *pVersion);
 //! \brief     Gets the quadrature voltage output value memory address from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The quadrature voltage output value memory address
-inline _iq *CTRL_getVq_out_addr(CTRL_Handle handle)
+static inline _iq *CTRL_getVq_out_addr(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -918,7 +1003,7 @@ inline _iq *CTRL_getVq_out_addr(CTRL_Handle handle)
 //! \brief     Gets the quadrature voltage output value from the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    The quadrature voltage output value, pu
-inline _iq CTRL_getVq_out_pu(CTRL_Handle handle)
+static inline _iq CTRL_getVq_out_pu(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -930,7 +1015,7 @@ inline _iq CTRL_getVq_out_pu(CTRL_Handle handle)
 //! \param[in] handle     The controller (CTRL) handle
 //! \param[in] ctrlState  The controller state
 //! \return    The wait time, controller clock counts
-inline uint_least32_t CTRL_getWaitTime(CTRL_Handle handle,const CTRL_State_e ctrlState)
+static inline uint_least32_t CTRL_getWaitTime(CTRL_Handle handle,const CTRL_State_e ctrlState)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -946,7 +1031,7 @@ void CTRL_getWaitTimes(CTRL_Handle handle,uint_least32_t *pWaitTimes);
 
 //! \brief     Increments the current counter
 //! \param[in] handle  The controller (CTRL) handle
-inline void CTRL_incrCounter_current(CTRL_Handle handle)
+static inline void CTRL_incrCounter_current(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -964,7 +1049,7 @@ inline void CTRL_incrCounter_current(CTRL_Handle handle)
 
 //! \brief     Increments the isr counter
 //! \param[in] handle  The controller (CTRL) handle
-inline void CTRL_incrCounter_isr(CTRL_Handle handle)
+static inline void CTRL_incrCounter_isr(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -982,7 +1067,7 @@ inline void CTRL_incrCounter_isr(CTRL_Handle handle)
 
 //! \brief     Increments the speed counter
 //! \param[in] handle  The controller (CTRL) handle
-inline void CTRL_incrCounter_speed(CTRL_Handle handle)
+static inline void CTRL_incrCounter_speed(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1000,7 +1085,7 @@ inline void CTRL_incrCounter_speed(CTRL_Handle handle)
 
 //! \brief     Increments the state counter
 //! \param[in] handle  The controller (CTRL) handle
-inline void CTRL_incrCounter_state(CTRL_Handle handle)
+static inline void CTRL_incrCounter_state(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1018,7 +1103,7 @@ inline void CTRL_incrCounter_state(CTRL_Handle handle)
 
 //! \brief     Increments the trajectory counter
 //! \param[in] handle  The controller (CTRL) handle
-inline void CTRL_incrCounter_traj(CTRL_Handle handle)
+static inline void CTRL_incrCounter_traj(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1050,7 +1135,7 @@ CTRL_Handle CTRL_initCtrl(const uint_least8_t estNumber,void *pMemory,const size
 //! \brief     Determines if there is a controller error
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    A boolean value denoting if there is a controller error (true) or not (false)
-inline bool CTRL_isError(CTRL_Handle handle)
+static inline bool CTRL_isError(CTRL_Handle handle)
 {
   CTRL_State_e ctrlState = CTRL_getState(handle);
   bool state = false;
@@ -1068,7 +1153,7 @@ inline bool CTRL_isError(CTRL_Handle handle)
 
 //! \brief     Resets the current counter
 //! \param[in] handle  The controller (CTRL) handle
-inline void CTRL_resetCounter_current(CTRL_Handle handle)
+static inline void CTRL_resetCounter_current(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1080,7 +1165,7 @@ inline void CTRL_resetCounter_current(CTRL_Handle handle)
 
 //! \brief     Resets the isr counter
 //! \param[in] handle  The controller (CTRL) handle
-inline void CTRL_resetCounter_isr(CTRL_Handle handle)
+static inline void CTRL_resetCounter_isr(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1092,7 +1177,7 @@ inline void CTRL_resetCounter_isr(CTRL_Handle handle)
 
 //! \brief     Resets the speed counter
 //! \param[in] handle  The controller (CTRL) handle
-inline void CTRL_resetCounter_speed(CTRL_Handle handle)
+static inline void CTRL_resetCounter_speed(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1104,7 +1189,7 @@ inline void CTRL_resetCounter_speed(CTRL_Handle handle)
 
 //! \brief     Resets the state counter
 //! \param[in] handle  The controller (CTRL) handle
-inline void CTRL_resetCounter_state(CTRL_Handle handle)
+static inline void CTRL_resetCounter_state(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1116,7 +1201,7 @@ inline void CTRL_resetCounter_state(CTRL_Handle handle)
 
 //! \brief     Resets the trajectory counter
 //! \param[in] handle  The controller (CTRL) handle
-inline void CTRL_resetCounter_traj(CTRL_Handle handle)
+static inline void CTRL_resetCounter_traj(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1160,7 +1245,7 @@ static inline void CTRL_setAngle_pu(CTRL_Handle handle,const _iq angle_pu)
 //! \brief      Sets the controller frequency
 //! \param[in]  handle       The controller (CTRL) handle
 //! \param[in]  ctrlFreq_Hz  The controller frequency, Hz
-inline void CTRL_setCtrlFreq_Hz(CTRL_Handle handle,const uint_least32_t ctrlFreq_Hz)
+static inline void CTRL_setCtrlFreq_Hz(CTRL_Handle handle,const uint_least32_t ctrlFreq_Hz)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1173,7 +1258,7 @@ inline void CTRL_setCtrlFreq_Hz(CTRL_Handle handle,const uint_least32_t ctrlFreq
 //! \brief      Sets the controller execution period
 //! \param[in]  handle          The controller (CTRL) handle
 //! \param[in]  ctrlPeriod_sec  The controller execution period, sec
-inline void CTRL_setCtrlPeriod_sec(CTRL_Handle handle,const float_t ctrlPeriod_sec)
+static inline void CTRL_setCtrlPeriod_sec(CTRL_Handle handle,const float_t ctrlPeriod_sec)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1186,7 +1271,7 @@ inline void CTRL_setCtrlPeriod_sec(CTRL_Handle handle,const float_t ctrlPeriod_s
 //! \brief      Sets the error code in the controller
 //! \param[in]  handle  The controller (CTRL) handle
 //! \param[in]  errorCode   The error code
-inline void CTRL_setErrorCode(CTRL_Handle handle,const CTRL_ErrorCode_e errorCode)
+static inline void CTRL_setErrorCode(CTRL_Handle handle,const CTRL_ErrorCode_e errorCode)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1211,7 +1296,7 @@ void CTRL_setEstParams(EST_Handle estHandle,USER_Params *pUserParams);
 //!             motor starts to run.
 //! \param[in]  handle  The controller (CTRL) handle
 //! \param[in]  state   The desired state
-inline void CTRL_setFlag_enableCtrl(CTRL_Handle handle,const bool state)
+static inline void CTRL_setFlag_enableCtrl(CTRL_Handle handle,const bool state)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1239,7 +1324,7 @@ static inline void CTRL_setFlag_enableCurrentCtrl(CTRL_Handle handle,const bool
 //!             proportional gains for DC bus variations.
 //! \param[in]  handle  The controller (CTRL) handle
 //! \param[in]  state   The desired state
-inline void CTRL_setFlag_enableDcBusComp(CTRL_Handle handle,const bool state)
+static inline void CTRL_setFlag_enableDcBusComp(CTRL_Handle handle,const bool state)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1255,7 +1340,7 @@ inline void CTRL_setFlag_enableDcBusComp(CTRL_Handle handle,const bool state)
 //!             the motor.
 //! \param[in]  handle  The controller (CTRL) handle
 //! \param[in]  state   The desired state
-inline void CTRL_setFlag_enablePowerWarp(CTRL_Handle handle,const bool state)
+static inline void CTRL_setFlag_enablePowerWarp(CTRL_Handle handle,const bool state)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1268,7 +1353,7 @@ inline void CTRL_setFlag_enablePowerWarp(CTRL_Handle handle,const bool state)
 //! \brief      Sets the enable offset flag value in the estimator
 //! \param[in]  handle  The controller (CTRL) handle
 //! \param[in]  state   The desired state
-inline void CTRL_setFlag_enableOffset(CTRL_Handle handle,const bool state)
+static inline void CTRL_setFlag_enableOffset(CTRL_Handle handle,const bool state)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1281,7 +1366,7 @@ inline void CTRL_setFlag_enableOffset(CTRL_Handle handle,const bool state)
 //! \brief      Sets the enable speed control value in the estimator
 //! \param[in]  handle  The controller (CTRL) handle
 //! \param[in]  state   The desired state
-inline void CTRL_setFlag_enableSpeedCtrl(CTRL_Handle handle,const bool state)
+static inline void CTRL_setFlag_enableSpeedCtrl(CTRL_Handle handle,const bool state)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1297,7 +1382,7 @@ inline void CTRL_setFlag_enableSpeedCtrl(CTRL_Handle handle,const bool state)
 //!             startup.
 //! \param[in]  handle  The controller (CTRL) handle
 //! \param[in]  state   The desired state
-inline void CTRL_setFlag_enableUserMotorParams(CTRL_Handle handle,const bool state)
+static inline void CTRL_setFlag_enableUserMotorParams(CTRL_Handle handle,const bool state)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1317,10 +1402,114 @@ void CTRL_setGains(CTRL_Handle handle,const CTRL_Type_e ctrlType,
                    const _iq Kp,const _iq Ki,const _iq Kd);
 
 
+#ifdef HFI_ENABLE
+//! \brief      Sets the high frequency injection handle
+//! \details    Below the handover speed of the injection the online controller
+//!             takes the angle and the speed from it instead of the estimator.
+//! \param[in]  handle     The controller (CTRL) handle
+//! \param[in]  hfiHandle  The high frequency injection (HFI) handle
+static inline void CTRL_setHfiHandle(CTRL_Handle handle,HFI_Handle hfiHandle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+  obj->hfiHandle = hfiHandle;
+
+  return;
+} // end of CTRL_setHfiHandle() function
+#endif
+
+
+#ifdef OBS_ENABLE
+//! \brief      Sets the back-EMF observer handle
+//! \details    The online controller takes the angle and the speed from the
+//!             observer instead of the estimator.
+//! \param[in]  handle     The controller (CTRL) handle
+//! \param[in]  obsHandle  The back-EMF observer (OBS) handle
+static inline void CTRL_setObsHandle(CTRL_Handle handle,OBS_Handle obsHandle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+  obj->obsHandle = obsHandle;
+
+  return;
+} // end of CTRL_setObsHandle() function
+#endif
+
+
+#ifdef HCOMP_ENABLE
+//! \brief      Sets the harmonic compensator handle
+//! \details    The online controller runs the compensator on the output of the
+//!             speed controller and adds its feedforward to the quadrature
+//!             current reference.
+//! \param[in]  handle       The controller (CTRL) handle
+//! \param[in]  hcompHandle  The harmonic compensator (HCOMP) handle
+static inline void CTRL_setHcompHandle(CTRL_Handle handle,HCOMP_Handle hcompHandle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+  obj->hcompHandle = hcompHandle;
+
+  return;
+} // end of CTRL_setHcompHandle() function
+#endif
+
+
+#ifdef MTPA_ENABLE
+//! \brief      Sets the maximum torque per ampere (MTPA) handle
+//! \details    The online controller runs the MTPA module on the quadrature
+//!             current reference and adds its Id to the direct current
+//!             reference of the next tick.
+//! \param[in]  handle      The controller (CTRL) handle
+//! \param[in]  mtpaHandle  The MTPA handle
+static inline void CTRL_setMtpaHandle(CTRL_Handle handle,MTPA_Handle mtpaHandle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+  obj->mtpaHandle = mtpaHandle;
+
+  return;
+} // end of CTRL_setMtpaHandle() function
+#endif
+
+
+#ifdef CATCH_ENABLE
+//! \brief      Sets the back-EMF catch spin (CATCH) handle
+//! \details    The online controller takes over a rotor the catch has
+//!             engaged, see CTRL_engageCatch().
+//! \param[in]  handle       The controller (CTRL) handle
+//! \param[in]  catchHandle  The CATCH handle
+static inline void CTRL_setCatchHandle(CTRL_Handle handle,CATCH_Handle catchHandle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+  obj->catchHandle = catchHandle;
+
+  return;
+} // end of CTRL_setCatchHandle() function
+#endif
+
+
+#ifdef REGEN_ENABLE
+//! \brief      Sets the regenerative braking governor (REGEN) handle
+//! \details    The online controller limits the regenerative quadrature current
+//!             by the DC bus voltage, see regen.h.
+//! \param[in]  handle       The controller (CTRL) handle
+//! \param[in]  regenHandle  The REGEN handle
+static inline void CTRL_setRegenHandle(CTRL_Handle handle,REGEN_Handle regenHandle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+  obj->regenHandle = regenHandle;
+
+  return;
+} // end of CTRL_setRegenHandle() function
+#endif
+
+
 //! \brief      Sets the alpha/beta current (Iab) input vector values in the controller
 //! \param[in]  handle      The controller (CTRL) handle
 //! \param[in]  pIab_in_pu  The vector of the alpha/beta current input vector values, pu
-inline void CTRL_setIab_in_pu(CTRL_Handle handle,const MATH_vec2 *pIab_in_pu)
+static inline void CTRL_setIab_in_pu(CTRL_Handle handle,const MATH_vec2 *pIab_in_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1340,7 +1529,7 @@ void CTRL_setIab_filt_pu(CTRL_Handle handle,const MATH_vec2 *pIab_filt_pu);
 //! \brief      Sets the direct current (Id) reference value in the controller
 //! \param[in]  handle     The controller (CTRL) handle
 //! \param[in]  Id_ref_pu  The direct current reference value, pu
-inline void CTRL_setId_ref_pu(CTRL_Handle handle,const _iq Id_ref_pu)
+static inline void CTRL_setId_ref_pu(CTRL_Handle handle,const _iq Id_ref_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1353,7 +1542,7 @@ inline void CTRL_setId_ref_pu(CTRL_Handle handle,const _iq Id_ref_pu)
 //! \brief      Sets the direct/quadrature current (Idq) input vector values in the controller
 //! \param[in]  handle      The controller (CTRL) handle
 //! \param[in]  pIdq_in_pu  The vector of the direct/quadrature current input vector values, pu
-inline void CTRL_setIdq_in_pu(CTRL_Handle handle,const MATH_vec2 *pIdq_in_pu)
+static inline void CTRL_setIdq_in_pu(CTRL_Handle handle,const MATH_vec2 *pIdq_in_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1381,7 +1570,7 @@ static inline void CTRL_setIdq_offset_pu(CTRL_Handle handle,const MATH_vec2 *pId
 //! \brief      Sets the direct/quadrature current (Idq) reference vector values in the controller
 //! \param[in]  handle       The controller (CTRL) handle
 //! \param[in]  pIdq_ref_pu  The vector of the direct/quadrature current reference vector values, pu
-inline void CTRL_setIdq_ref_pu(CTRL_Handle handle,const MATH_vec2 *pIdq_ref_pu)
+static inline void CTRL_setIdq_ref_pu(CTRL_Handle handle,const MATH_vec2 *pIdq_ref_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1395,7 +1584,7 @@ inline void CTRL_setIdq_ref_pu(CTRL_Handle handle,const MATH_vec2 *pIdq_ref_pu)
 //! \brief      Sets the Id rated current value in the controller
 //! \param[in]  handle      The controller (CTRL) handle
 //! \param[in]  IdRated_pu  The Id rated current value, pu
-inline void CTRL_setIdRated_pu(CTRL_Handle handle,const _iq IdRated_pu)
+static inline void CTRL_setIdRated_pu(CTRL_Handle handle,const _iq IdRated_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1432,7 +1621,7 @@ static inline void CTRL_setImmediateUi(CTRL_Handle handle,const CTRL_Type_e ctrl
 //! \brief      Sets the quadrature current (Iq) reference value in the controller
 //! \param[in]  handle     The controller (CTRL) handle
 //! \param[in]  IqRef_pu  The quadrature current reference value, pu
-inline void CTRL_setIq_ref_pu(CTRL_Handle handle,const _iq IqRef_pu)
+static inline void CTRL_setIq_ref_pu(CTRL_Handle handle,const _iq IqRef_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1446,7 +1635,7 @@ inline void CTRL_setIq_ref_pu(CTRL_Handle handle,const _iq IqRef_pu)
 //! \param[in]  handle    The controller (CTRL) handle
 //! \param[in]  ctrlType  The controller type
 //! \param[in]  Kd        The Kd value
-inline void CTRL_setKd(CTRL_Handle handle,const CTRL_Type_e ctrlType,const _iq Kd)
+static inline void CTRL_setKd(CTRL_Handle handle,const CTRL_Type_e ctrlType,const _iq Kd)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1471,7 +1660,7 @@ inline void CTRL_setKd(CTRL_Handle handle,const CTRL_Type_e ctrlType,const _iq K
 //! \param[in]  handle    The controller (CTRL) handle
 //! \param[in]  ctrlType  The controller type
 //! \param[in]  Ki        The Ki value
-inline void CTRL_setKi(CTRL_Handle handle,const CTRL_Type_e ctrlType,const _iq Ki)
+static inline void CTRL_setKi(CTRL_Handle handle,const CTRL_Type_e ctrlType,const _iq Ki)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1496,7 +1685,7 @@ inline void CTRL_setKi(CTRL_Handle handle,const CTRL_Type_e ctrlType,const _iq K
 //! \param[in]  handle    The controller (CTRL) handle
 //! \param[in]  ctrlType  The controller type
 //! \param[in]  Kp        The Kp value
-inline void CTRL_setKp(CTRL_Handle handle,const CTRL_Type_e ctrlType,const _iq Kp)
+static inline void CTRL_setKp(CTRL_Handle handle,const CTRL_Type_e ctrlType,const _iq Kp)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1520,7 +1709,7 @@ inline void CTRL_setKp(CTRL_Handle handle,const CTRL_Type_e ctrlType,const _iq K
 //! \brief      Sets the high frequency inductance (Lhf) value in the controller
 //! \param[in]  handle  The controller (CTRL) handle
 //! \param[in]  Lhf     The Lhf value
-inline void CTRL_setLhf(CTRL_Handle handle,const float_t Lhf)
+static inline void CTRL_setLhf(CTRL_Handle handle,const float_t Lhf)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1539,7 +1728,7 @@ void CTRL_setMagCurrent_pu(CTRL_Handle handle,const _iq magCurrent_pu);
 //! \brief      Sets the maximum voltage vector in the controller
 //! \param[in]  handle        The controller (CTRL) handle
 //! \param[in]  maxVsMag      The maximum voltage vector (value betwen 0 and 4/3)
-inline void CTRL_setMaxVsMag_pu(CTRL_Handle handle,const _iq maxVsMag)
+static inline void CTRL_setMaxVsMag_pu(CTRL_Handle handle,const _iq maxVsMag)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1553,7 +1742,7 @@ inline void CTRL_setMaxVsMag_pu(CTRL_Handle handle,const _iq maxVsMag)
 //! \details    Sets the maximum acceleration rate of the speed reference.
 //! \param[in]  handle       The controller (CTRL) handle
 //! \param[in]  maxAccel_pu  The maximum acceleration (value betwen 0 and 1)
-inline void CTRL_setMaxAccel_pu(CTRL_Handle handle,const _iq maxAccel_pu)
+static inline void CTRL_setMaxAccel_pu(CTRL_Handle handle,const _iq maxAccel_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1578,7 +1767,7 @@ void CTRL_setMaximumSpeed_pu(CTRL_Handle handle,const _iq maxSpeed_pu);
 //! \param[in] Ls_q          The quadrature stator inductance, Henry
 //! \param[in] Rr            The rotor resistance, ohm
 //! \param[in] Rs            The stator resitance, ohm
-inline void CTRL_setMotorParams(CTRL_Handle handle,
+static inline void CTRL_setMotorParams(CTRL_Handle handle,
                                 const MOTOR_Type_e motorType,
                                 const uint_least16_t numPolePairs,
                                 const float_t ratedFlux,
@@ -1612,7 +1801,7 @@ void CTRL_setParams(CTRL_Handle handle,USER_Params *pUserParams);
 //! \brief     Sets the number of controller clock ticks per current controller clock tick
 //! \param[in] handle                      The controller (CTRL) handle
 //! \param[in] numCtrlTicksPerCurrentTick  The number of controller clock ticks per estimator clock tick
-inline void CTRL_setNumCtrlTicksPerCurrentTick(CTRL_Handle handle,
+static inline void CTRL_setNumCtrlTicksPerCurrentTick(CTRL_Handle handle,
                                                const uint_least16_t numCtrlTicksPerCurrentTick)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
@@ -1626,7 +1815,7 @@ inline void CTRL_setNumCtrlTicksPerCurrentTick(CTRL_Handle handle,
 //! \brief     Sets the number of controller clock ticks per speed controller clock tick
 //! \param[in] handle                    The controller (CTRL) handle
 //! \param[in] numCtrlTicksPerSpeedTick  The number of controller clock ticks per speed clock tick
-inline void CTRL_setNumCtrlTicksPerSpeedTick(CTRL_Handle handle,
+static inline void CTRL_setNumCtrlTicksPerSpeedTick(CTRL_Handle handle,
                                                const uint_least16_t numCtrlTicksPerSpeedTick)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
@@ -1640,7 +1829,7 @@ inline void CTRL_setNumCtrlTicksPerSpeedTick(CTRL_Handle handle,
 //! \brief     Sets the number of controller clock ticks per trajectory clock tick
 //! \param[in] handle                   The controller (CTRL) handle
 //! \param[in] numCtrlTicksPerTrajTick  The number of controller clock ticks per trajectory clock tick
-inline void CTRL_setNumCtrlTicksPerTrajTick(CTRL_Handle handle,
+static inline void CTRL_setNumCtrlTicksPerTrajTick(CTRL_Handle handle,
                                                const uint_least16_t numCtrlTicksPerTrajTick)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
@@ -1654,7 +1843,7 @@ inline void CTRL_setNumCtrlTicksPerTrajTick(CTRL_Handle handle,
 //! \brief     Sets the number of Interrupt Service Routine (ISR) clock ticks per controller clock tick
 //! \param[in] handle                  The controller (CTRL) handle
 //! \param[in] numIsrTicksPerCtrlTick  The number of Interrupt Service Routine (ISR) clock ticks per controller clock tick
-inline void CTRL_setNumIsrTicksPerCtrlTick(CTRL_Handle handle,
+static inline void CTRL_setNumIsrTicksPerCtrlTick(CTRL_Handle handle,
                                            const uint_least16_t numIsrTicksPerCtrlTick)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
@@ -1668,7 +1857,7 @@ inline void CTRL_setNumIsrTicksPerCtrlTick(CTRL_Handle handle,
 //! \brief     Sets the high frequency resistance (Rhf) value in the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \param[in] Rhf     The Rhf value
-inline void CTRL_setRhf(CTRL_Handle handle,const float_t Rhf)
+static inline void CTRL_setRhf(CTRL_Handle handle,const float_t Rhf)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1681,7 +1870,7 @@ inline void CTRL_setRhf(CTRL_Handle handle,const float_t Rhf)
 //! \brief     Sets the R/L value in the controller
 //! \param[in] handle  The controller (CTRL) handle
 //! \param[in] RoverL  The R/L value
-inline void CTRL_setRoverL(CTRL_Handle handle,const float_t RoverL)
+static inline void CTRL_setRoverL(CTRL_Handle handle,const float_t RoverL)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1707,7 +1896,7 @@ static inline void CTRL_setSpeed_fb_pu(CTRL_Handle handle,const _iq speed_fb_pu)
 //! \brief     Sets the maximum speed value in the controller
 //! \param[in] handle     The controller (CTRL) handle
 //! \param[in] maxSpd_pu  The maximum speed value, pu
-inline void CTRL_setSpd_max_pu(CTRL_Handle handle,const _iq maxSpd_pu)
+static inline void CTRL_setSpd_max_pu(CTRL_Handle handle,const _iq maxSpd_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1720,7 +1909,7 @@ inline void CTRL_setSpd_max_pu(CTRL_Handle handle,const _iq maxSpd_pu)
 //! \brief     Sets the output speed value in the controller
 //! \param[in] handle      The controller (CTRL) handle
 //! \param[in] spd_out_pu  The output speed value, pu
-inline void CTRL_setSpd_out_pu(CTRL_Handle handle,const _iq spd_out_pu)
+static inline void CTRL_setSpd_out_pu(CTRL_Handle handle,const _iq spd_out_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1771,7 +1960,7 @@ void CTRL_setSpd_ref_krpm(CTRL_Handle handle,const _iq spd_ref_krpm);
 //! \brief     Sets the controller state
 //! \param[in] handle  The controller (CTRL) handle
 //! \param[in] state       The new state
-inline void CTRL_setState(CTRL_Handle handle,const CTRL_State_e state)
+static inline void CTRL_setState(CTRL_Handle handle,const CTRL_State_e state)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1785,7 +1974,7 @@ inline void CTRL_setState(CTRL_Handle handle,const CTRL_State_e state)
 //! \brief      Sets the trajectory execution frequency
 //! \param[in]  handle       The controller (CTRL) handle
 //! \param[in]  trajFreq_Hz  The trajectory execution frequency, Hz
-inline void CTRL_setTrajFreq_Hz(CTRL_Handle handle,const uint_least32_t trajFreq_Hz)
+static inline void CTRL_setTrajFreq_Hz(CTRL_Handle handle,const uint_least32_t trajFreq_Hz)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1798,7 +1987,7 @@ inline void CTRL_setTrajFreq_Hz(CTRL_Handle handle,const uint_least32_t trajFreq
 //! \brief      Sets the trajectory execution period
 //! \param[in]  handle          The controller (CTRL) handle
 //! \param[in]  trajPeriod_sec  The trajectory execution period, sec
-inline void CTRL_setTrajPeriod_sec(CTRL_Handle handle,const _iq trajPeriod_sec)
+static inline void CTRL_setTrajPeriod_sec(CTRL_Handle handle,const _iq trajPeriod_sec)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1812,7 +2001,7 @@ inline void CTRL_setTrajPeriod_sec(CTRL_Handle handle,const _iq trajPeriod_sec)
 //! \param[in] handle  The controller (CTRL) handle
 //! \param[in] ctrlType  The controller type
 //! \param[in] Ui      The Ui value
-inline void CTRL_setUi(CTRL_Handle handle,const CTRL_Type_e ctrlType,const _iq Ui)
+static inline void CTRL_setUi(CTRL_Handle handle,const CTRL_Type_e ctrlType,const _iq Ui)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1879,7 +2068,7 @@ void CTRL_setUserMotorParams(CTRL_Handle handle);
 //! \brief     Sets the alpha/beta voltage input vector values in the controller
 //! \param[in] handle      The controller (CTRL) handle
 //! \param[in] pVab_in_pu  The vector of alpha/beta voltage input vector values, pu
-inline void CTRL_setVab_in_pu(CTRL_Handle handle,const MATH_vec2 *pVab_in_pu)
+static inline void CTRL_setVab_in_pu(CTRL_Handle handle,const MATH_vec2 *pVab_in_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1893,7 +2082,7 @@ inline void CTRL_setVab_in_pu(CTRL_Handle handle,const MATH_vec2 *pVab_in_pu)
 //! \brief     Sets the alpha/beta current output vector values in the controller
 //! \param[in] handle       The controller (CTRL) handle
 //! \param[in] pVab_out_pu  The vector of alpha/beta current output vector values, pu
-inline void CTRL_setVab_out_pu(CTRL_Handle handle,const MATH_vec2 *pVab_out_pu)
+static inline void CTRL_setVab_out_pu(CTRL_Handle handle,const MATH_vec2 *pVab_out_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1921,7 +2110,7 @@ static inline void CTRL_setVdq_offset_pu(CTRL_Handle handle,const MATH_vec2 *pVd
 //! \brief     Sets the direct/quadrature voltage output vector values in the controller
 //! \param[in] handle       The controller (CTRL) handle
 //! \param[in] pVdq_out_pu  The vector of direct/quadrature voltage output vector values, pu
-inline void CTRL_setVdq_out_pu(CTRL_Handle handle,const MATH_vec2 *pVdq_out_pu)
+static inline void CTRL_setVdq_out_pu(CTRL_Handle handle,const MATH_vec2 *pVdq_out_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1969,7 +2158,7 @@ bool CTRL_updateState(CTRL_Handle handle);
 //! \brief     Determines if a zero Iq current reference should be used in the controller
 //! \param[in] handle   The controller (CTRL) handle
 //! \return    A boolean value denoting if a zero Iq current reference should be used (true) or not (false)
-inline bool CTRL_useZeroIq_ref(CTRL_Handle handle)
+static inline bool CTRL_useZeroIq_ref(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -1979,7 +2168,7 @@ inline bool CTRL_useZeroIq_ref(CTRL_Handle handle)
 
 //! \brief      Checks for any controller errors and, if found, sets the controller state to the error state
 //! \param[in]  handle  The controller (CTRL) handle
-inline void CTRL_checkForErrors(CTRL_Handle handle)
+static inline void CTRL_checkForErrors(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -2037,7 +2226,7 @@ static inline void CTRL_computeOutputLimits_Iq(CTRL_Handle handle,
 //! \brief      Computes a phasor for a given angle
 //! \param[in]  angle_pu  The angle, pu
 //! \param[out] pPhasor   The pointer to the phasor vector values
-inline void CTRL_computePhasor(const _iq angle_pu,MATH_vec2 *pPhasor)
+static inline void CTRL_computePhasor(const _iq angle_pu,MATH_vec2 *pPhasor)
 {
 
   pPhasor->value[0] = _IQcosPU(angle_pu);
@@ -2050,12 +2239,17 @@ inline void CTRL_computePhasor(const _iq angle_pu,MATH_vec2 *pPhasor)
 //! \brief      Determines if the current controllers should be run
 //! \param[in]  handle  The controller (CTRL) handle
 //! \return     The value denoting that the current controllers should be run (true) or not (false)
-inline bool CTRL_doCurrentCtrl(CTRL_Handle handle)
+static inline bool CTRL_doCurrentCtrl(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   bool result = false;
 
+#ifdef CTRL_STATIC_CONFIG
+  if(CTRL_getFlag_enableCurrentCtrl(handle) &&
+     (!CTRL_COUNT_CURRENT_TICKS || (obj->counter_current >= CTRL_STATIC_NUM_CTRL_TICKS_PER_CURRENT_TICK)))
+#else
   if(CTRL_getFlag_enableCurrentCtrl(handle) && (obj->counter_current >= obj->numCtrlTicksPerCurrentTick))
+#endif
   {
     result = true;
   }
@@ -2067,12 +2261,16 @@ inline bool CTRL_doCurrentCtrl(CTRL_Handle handle)
 //! \brief     Determines if the speed controller should be executed
 //! \param[in] handle  The controller (CTRL) handle
 //! \return    A boolean value denoting if the speed controller should be executed (true) or not (false)
-inline bool CTRL_doSpeedCtrl(CTRL_Handle handle)
+static inline bool CTRL_doSpeedCtrl(CTRL_Handle handle)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
   bool result = false;
 
+#ifdef CTRL_STATIC_CONFIG
+  if(!CTRL_COUNT_SPEED_TICKS || (obj->counter_speed >= CTRL_STATIC_NUM_CTRL_TICKS_PER_SPEED_TICK))
+#else
   if((obj->counter_speed >= obj->numCtrlTicksPerSpeedTick))
+#endif
   {
     result = true;
   }
@@ -2086,7 +2284,7 @@ inline bool CTRL_doSpeedCtrl(CTRL_Handle handle)
 //! \param[in]  halHandle  The hardware abstraction layer (HAL) handle
 //! \param[in]  pAdcData   The pointer to the ADC data
 //! \param[out] pPwmData   The pointer to the PWM data
-inline void CTRL_runOffLine(CTRL_Handle handle,HAL_Handle halHandle,
+static inline void CTRL_runOffLine(CTRL_Handle handle,HAL_Handle halHandle,
                             const HAL_AdcData_t *pAdcData,HAL_PwmData_t *pPwmData)
 {
 
@@ -2105,7 +2303,7 @@ inline void CTRL_runOffLine(CTRL_Handle handle,HAL_Handle halHandle,
 //! \brief      Sets maximum speed controller output
 //! \param[in]  handle  The controller (CTRL) handle
 //! \param[in]  spdMax  The maximum allowed output of the speed controller
-inline void CTRL_setSpdMax(CTRL_Handle handle, const _iq spdMax)
+static inline void CTRL_setSpdMax(CTRL_Handle handle, const _iq spdMax)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -2123,10 +2321,14 @@ inline void CTRL_setSpdMax(CTRL_Handle handle, const _iq spdMax)
 //! \param[in]  handle    The controller (CTRL) handle
 //! \param[in]  angle_pu  The angle delayed
 //! \return     The phase delay compensated angle
-inline _iq CTRL_angleDelayComp(CTRL_Handle handle, const _iq angle_pu)
+static inline _iq CTRL_angleDelayComp(CTRL_Handle handle, const _iq angle_pu)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
+#ifdef OBS_ENABLE
+  _iq angleDelta_pu = _IQmpy(OBS_getFm_pu(obj->obsHandle),_IQ(USER_IQ_FULL_SCALE_FREQ_Hz/(USER_PWM_FREQ_kHz*1000.0)));
+#else
   _iq angleDelta_pu = _IQmpy(EST_getFm_pu(obj->estHandle),_IQ(USER_IQ_FULL_SCALE_FREQ_Hz/(USER_PWM_FREQ_kHz*1000.0)));
+#endif
   _iq angleUncomp_pu = angle_pu;
   _iq angleCompFactor = _IQ(1.0 + (float_t)USER_NUM_PWM_TICKS_PER_ISR_TICK * (float_t)USER_NUM_ISR_TICKS_PER_CTRL_TICK * ((float_t)USER_NUM_CTRL_TICKS_PER_EST_TICK - 0.5));
   _iq angleDeltaComp_pu = _IQmpy(angleDelta_pu, angleCompFactor);
@@ -2155,7 +2357,7 @@ inline _iq CTRL_angleDelayComp(CTRL_Handle handle, const _iq angle_pu)
 //! \param[in]  handle    The controller (CTRL) handle
 //! \param[in]  pAdcData  The pointer to the ADC data
 //! \param[out] pPwmData  The pointer to the PWM data
-inline void CTRL_runOnLine(CTRL_Handle handle,
+static inline void CTRL_runOnLine(CTRL_Handle handle,
                            const HAL_AdcData_t *pAdcData,HAL_PwmData_t *pPwmData)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
@@ -2204,8 +2406,10 @@ inline void CTRL_runOnLine(CTRL_Handle handle,
          _iq outMax = TRAJ_getIntValue(obj->trajHandle_spdMax);
          _iq outMin = -outMax;
 
+#if CTRL_COUNT_SPEED_TICKS
          // reset the speed count
          CTRL_resetCounter_speed(handle);
+#endif
 
          PID_setMinMax(obj->pidHandle_spd,outMin,outMax);
 
@@ -2233,8 +2437,10 @@ inline void CTRL_runOnLine(CTRL_Handle handle,
          
      _iq maxVsMag = CTRL_getMaxVsMag_pu(handle);
 
+#if CTRL_COUNT_CURRENT_TICKS
      // reset the current count
      CTRL_resetCounter_current(handle);
+#endif
 
      // ***********************************
      // configure and run the Id controller
@@ -2333,6 +2539,41 @@ inline void CTRL_runOnLine(CTRL_Handle handle,
 } // end of CTRL_runOnLine() function
 
 
+#ifdef CATCH_ENABLE
+//! \brief      Takes over the rotor the catch spin (CATCH) module tracked with the bridge off
+//! \details    The estimator angle, and the observer with OBS_ENABLE, start from the
+//!             caught angle and the speed trajectory from the caught speed, so the
+//!             speed controller asks for no torque.  The Iq controller starts at the
+//!             modulation of the back-EMF, a modulation of one is a phase amplitude of
+//!             half the DC bus, so the bridge takes over at zero current.
+//! \param[in]  handle  The controller (CTRL) handle
+static inline void CTRL_engageCatch(CTRL_Handle handle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+  _iq angle_pu = CATCH_getAngle_pu(obj->catchHandle);
+  _iq Fm_pu = CATCH_getFm_pu(obj->catchHandle);
+  _iq Vq_out = _IQmpy(CATCH_getEmf_pu(obj->catchHandle),EST_getOneOverDcBus_pu(obj->estHandle)) << 1;
+
+  EST_setAngle_pu(obj->estHandle,angle_pu);
+
+#ifdef OBS_ENABLE
+  OBS_startOnAngle(obj->obsHandle,angle_pu,Fm_pu,CATCH_getEab_addr(obj->catchHandle));
+#endif
+
+  TRAJ_setIntValue(obj->trajHandle_spd,Fm_pu);
+  PID_setUi(obj->pidHandle_spd,_IQ(0.0));
+  CTRL_setSpd_out_pu(handle,_IQ(0.0));
+
+  PID_setUi(obj->pidHandle_Id,_IQ(0.0));
+  PID_setUi(obj->pidHandle_Iq,Vq_out);
+
+  CATCH_setEngaged(obj->catchHandle);
+
+  return;
+} // end of CTRL_engageCatch() function
+#endif
+
+
 //! \brief      Runs the online user controller
 //! \details    An implementation of the field oriented control.  The online user controller
 //!             is executed in user's memory i.e. RAM/FLASH and can be changed in any way
@@ -2340,31 +2581,82 @@ inline void CTRL_runOnLine(CTRL_Handle handle,
 //! \param[in]  handle    The controller (CTRL) handle
 //! \param[in]  pAdcData  The pointer to the ADC data
 //! \param[out] pPwmData  The pointer to the PWM data
-inline void CTRL_runOnLine_User(CTRL_Handle handle,
+static inline void CTRL_runOnLine_User(CTRL_Handle handle,
                            const HAL_AdcData_t *pAdcData,HAL_PwmData_t *pPwmData)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
   _iq angle_pu;
 
+  _iq fbackValue;
+
   MATH_vec2 phasor;
 
+#ifdef HFI_ENABLE
+  MATH_vec2 Vdq_out;
+#endif
+
 
  // run Clarke transform on current
+#ifdef CTRL_STATIC_CONFIG
+ CLARKE_run_numSensors(obj->clarkeHandle_I,CTRL_STATIC_NUM_CURRENT_SENSORS,&pAdcData->I,CTRL_getIab_in_addr(handle));
+#else
  CLARKE_run(obj->clarkeHandle_I,&pAdcData->I,CTRL_getIab_in_addr(handle));
+#endif
+
+#ifdef HFI_ENABLE
+ // demodulate the injection, the estimator and the controllers see the fundamental
+ HFI_demodulate(obj->hfiHandle,CTRL_getIab_in_addr(handle));
+#endif
 
 
  // run Clarke transform on voltage
+#ifdef CTRL_STATIC_CONFIG
+ CLARKE_run_numSensors(obj->clarkeHandle_V,CTRL_STATIC_NUM_VOLTAGE_SENSORS,&pAdcData->V,CTRL_getVab_in_addr(handle));
+#else
  CLARKE_run(obj->clarkeHandle_V,&pAdcData->V,CTRL_getVab_in_addr(handle));
+#endif
+
+ ISR_PROF_MARK(ISR_PROF_Stage_Clarke);
+
+#ifdef CATCH_ENABLE
+ // take over a caught rotor before the estimator runs on the tick of the catch
+ if(CATCH_getState(obj->catchHandle) == CATCH_State_Engage)
+   {
+     CTRL_engageCatch(handle);
+   }
+#endif
 
 
  // run the estimator
  EST_run(obj->estHandle,CTRL_getIab_in_addr(handle),CTRL_getVab_in_addr(handle),
          pAdcData->dcBus,TRAJ_getIntValue(obj->trajHandle_spd));
 
+#ifdef OBS_ENABLE
+ // run the open back-EMF observer, it replaces the angle and speed of the estimator
+ OBS_run(obj->obsHandle,CTRL_getIab_in_addr(handle),CTRL_getVab_in_addr(handle),
+         TRAJ_getIntValue(obj->trajHandle_spd));
+#endif
+
+ ISR_PROF_MARK(ISR_PROF_Stage_Est);
+
 
  // generate the motor electrical angle
+#if defined(HFI_ENABLE) && defined(OBS_ENABLE)
+ // below the handover speed the angle comes from the injection
+ HFI_run(obj->hfiHandle,OBS_getAngle_pu(obj->obsHandle),OBS_getFm_pu(obj->obsHandle));
+
+ angle_pu = HFI_getAngle_pu(obj->hfiHandle);
+#elif defined(HFI_ENABLE)
+ // below the handover speed the angle comes from the injection
+ HFI_run(obj->hfiHandle,EST_getAngle_pu(obj->estHandle),EST_getFm_pu(obj->estHandle));
+
+ angle_pu = HFI_getAngle_pu(obj->hfiHandle);
+#elif defined(OBS_ENABLE)
+ angle_pu = OBS_getAngle_pu(obj->obsHandle);
+#else
  angle_pu = EST_getAngle_pu(obj->estHandle);
+#endif
 
 
  // compute the sin/cos phasor
@@ -2378,21 +2670,74 @@ inline void CTRL_runOnLine_User(CTRL_Handle handle,
  // run the Park transform
  PARK_run(obj->parkHandle,CTRL_getIab_in_addr(handle),CTRL_getIdq_in_addr(handle));
 
+ ISR_PROF_MARK(ISR_PROF_Stage_Park);
+
+#ifdef HCOMP_ENABLE
+ // count the mechanical angle, learn and read the feedforward of the tick
+ HCOMP_run(obj->hcompHandle,angle_pu);
+#endif
+
+
+ // the speed feedback of the governor and the speed controller
+#if defined(HFI_ENABLE)
+ fbackValue = HFI_getSpeed_pu(obj->hfiHandle);
+#elif defined(OBS_ENABLE)
+ fbackValue = OBS_getFm_pu(obj->obsHandle);
+#else
+ fbackValue = EST_getFm_pu(obj->estHandle);
+#endif
+
+#ifdef REGEN_ENABLE
+ // the regenerative current the DC bus takes on this tick
+ REGEN_run(obj->regenHandle,pAdcData->dcBus,fbackValue);
+#endif
+
 
  // when appropriate, run the PID speed controller
  if(CTRL_doSpeedCtrl(handle))
    {
      _iq refValue = TRAJ_getIntValue(obj->trajHandle_spd);
-     _iq fbackValue = EST_getFm_pu(obj->estHandle);
      _iq outMax = TRAJ_getIntValue(obj->trajHandle_spdMax);
      _iq outMin = -outMax;
 
+#if CTRL_COUNT_SPEED_TICKS
      // reset the speed count
      CTRL_resetCounter_speed(handle);
+#endif
+
+#ifdef REGEN_ENABLE
+     // the integrator does not wind up beyond the regenerative limit
+     REGEN_limitMinMax(obj->regenHandle,&outMin,&outMax);
+#endif
 
      PID_setMinMax(obj->pidHandle_spd,outMin,outMax);
 
+#ifdef HCOMP_ENABLE
+     // the residual of the period that ended, it only holds with the feedforward applied
+     {
+       bool flag_ffApplied = CTRL_getFlag_enableSpeedCtrl(handle);
+
+#ifdef HFI_ENABLE
+       flag_ffApplied = flag_ffApplied && HFI_isAngleValid(obj->hfiHandle);
+#endif
+#ifdef OBS_ENABLE
+       flag_ffApplied = flag_ffApplied && OBS_isAngleValid(obj->obsHandle);
+#endif
+
+       if(flag_ffApplied)
+         {
+           HCOMP_update(obj->hcompHandle,CTRL_getSpd_out_pu(handle),fbackValue);
+         }
+       else
+         {
+           HCOMP_resetUpdate(obj->hcompHandle);
+         }
+     }
+#endif
+
      PID_run_spd(obj->pidHandle_spd,refValue,fbackValue,CTRL_getSpd_out_addr(handle));
+
+     ISR_PROF_MARK(ISR_PROF_Stage_SpeedPi);
    }
 
 
@@ -2409,8 +2754,10 @@ inline void CTRL_runOnLine_User(CTRL_Handle handle,
      _iq maxVsMag = CTRL_getMaxVsMag_pu(handle);
 
 
+#if CTRL_COUNT_CURRENT_TICKS
      // reset the current count
      CTRL_resetCounter_current(handle);
+#endif
 
      // ***********************************
      // configure and run the Id controller
@@ -2430,6 +2777,21 @@ inline void CTRL_runOnLine_User(CTRL_Handle handle,
      // update the Id reference value
      EST_updateId_ref_pu(obj->estHandle,&refValue);
 
+#ifdef MTPA_ENABLE
+     // add the maximum torque per ampere Id of the Iq reference of the last tick
+     refValue += MTPA_getId_ref_pu(obj->mtpaHandle);
+#endif
+
+#ifdef HFI_ENABLE
+     // add the current pulses of the polarity detection
+     refValue += HFI_getId_ref_pu(obj->hfiHandle);
+#endif
+
+#ifdef REGEN_ENABLE
+     // add the loss injection of the braking Iq reference of the last tick
+     refValue += REGEN_getId_ref_pu(obj->regenHandle);
+#endif
+
      // get the feedback value
      fbackValue = CTRL_getId_in_pu(handle);
 
@@ -2459,6 +2821,15 @@ inline void CTRL_runOnLine_User(CTRL_Handle handle,
      if(CTRL_getFlag_enableSpeedCtrl(handle))
        {
          refValue = CTRL_getSpd_out_pu(handle);
+
+#ifdef HCOMP_ENABLE
+         // the feedforward of the compensator within the limit of the speed controller
+         {
+           _iq outMax = TRAJ_getIntValue(obj->trajHandle_spdMax);
+
+           refValue = _IQsat(refValue + HCOMP_getIq_ff_pu(obj->hcompHandle),outMax,-outMax);
+         }
+#endif
        }
      else
        {
@@ -2466,6 +2837,36 @@ inline void CTRL_runOnLine_User(CTRL_Handle handle,
          refValue = CTRL_getIq_ref_pu(handle);
        }
 
+#ifdef HFI_ENABLE
+     // no torque before the injection has found the rotor axis and its polarity
+     if(!HFI_isAngleValid(obj->hfiHandle))
+       {
+         refValue = _IQ(0.0);
+
+         PID_setUi(obj->pidHandle_spd,_IQ(0.0));
+       }
+#endif
+
+#ifdef OBS_ENABLE
+     // a fixed current on the forced angle, the speed controller starts from it
+     if(!OBS_isAngleValid(obj->obsHandle))
+       {
+         refValue = OBS_getIq_ref_pu(obj->obsHandle);
+
+         PID_setUi(obj->pidHandle_spd,refValue);
+       }
+#endif
+
+#ifdef REGEN_ENABLE
+     // no more regenerative current than the DC bus takes
+     refValue = REGEN_limitIq_ref(obj->regenHandle,refValue);
+#endif
+
+#ifdef MTPA_ENABLE
+     // the Id of the next tick, one tick later than the Iq reference it belongs to
+     MTPA_run(obj->mtpaHandle,refValue);
+#endif
+
      // get the feedback value
      fbackValue = CTRL_getIq_in_pu(handle);
 
@@ -2478,8 +2879,27 @@ inline void CTRL_runOnLine_User(CTRL_Handle handle,
 
      // run the Iq PID controller
      PID_run(obj->pidHandle_Iq,refValue,fbackValue,CTRL_getVq_out_addr(handle));
+
+     ISR_PROF_MARK(ISR_PROF_Stage_CurrentPi);
    }
 
+#ifdef HFI_ENABLE
+   // inject on the estimated direct axis, scaled like the controller output,
+   // into a copy of the controller output so that the injection does not add
+   // up on the ticks that do not run the current controllers
+   {
+     _iq Vinj = HFI_getVinj_pu(obj->hfiHandle);
+
+     if(CTRL_getFlag_enableDcBusComp(handle))
+       {
+         Vinj = _IQmpy(Vinj,EST_getOneOverDcBus_pu(obj->estHandle));
+       }
+
+     Vdq_out.value[0] = obj->Vdq_out.value[0] + Vinj;
+     Vdq_out.value[1] = obj->Vdq_out.value[1];
+   }
+#endif
+
    {
      _iq angleComp_pu;
 
@@ -2498,19 +2918,329 @@ inline void CTRL_runOnLine_User(CTRL_Handle handle,
 
 
  // run the inverse Park module
+#ifdef HFI_ENABLE
+ IPARK_run(obj->iparkHandle,&Vdq_out,CTRL_getVab_out_addr(handle));
+#else
  IPARK_run(obj->iparkHandle,CTRL_getVdq_out_addr(handle),CTRL_getVab_out_addr(handle));
+#endif
 
 
  // run the space Vector Generator (SVGEN) module
  SVGEN_run(obj->svgenHandle,CTRL_getVab_out_addr(handle),&(pPwmData->Tabc));
 
+ ISR_PROF_MARK(ISR_PROF_Stage_Svgen);
+
  return;
 } // end of CTRL_runOnLine_User() function
 
 
+//! \brief      Computes the phasor of the delay compensated angle from the IQ30 phasor of the angle
+//! \details    The compensation angle is a fraction of the angle travelled per PWM period, so
+//!             its sine and cosine are evaluated with a short power series in IQ30 and the
+//!             IQ30 phasor is rotated with rounding instead of computing a second sin/cos.  The
+//!             IQmath sin/cos shift their IQ30 result to GLOBAL_Q, and the one of the compensated
+//!             angle is within CTRL_PHASOR_ROT_ERR_IQ30 of the rotated value.  So the shifted
+//!             rotated value equals CTRL_computePhasor() of the compensated angle unless a
+//!             GLOBAL_Q step lies within that bound, only then the sin or cos of the compensated
+//!             angle is computed.  The result is bit exact.
+//! \param[in]  handle       The controller (CTRL) handle
+//! \param[in]  angle_pu     The angle, pu
+//! \param[in]  pPhasor30    The pointer to the IQ30 phasor of the angle
+//! \param[out] pPhasorComp  The pointer to the phasor of the delay compensated angle
+static inline void CTRL_computePhasorDelayComp(CTRL_Handle handle,const _iq angle_pu,
+                                               const MATH_vec2 *pPhasor30,MATH_vec2 *pPhasorComp)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+  _iq angleDelta_pu = _IQmpy(EST_getFm_pu(obj->estHandle),_IQ(USER_IQ_FULL_SCALE_FREQ_Hz/(USER_PWM_FREQ_kHz*1000.0)));
+  _iq angleCompFactor = _IQ(1.0 + (float_t)USER_NUM_PWM_TICKS_PER_ISR_TICK * (float_t)USER_NUM_ISR_TICKS_PER_CTRL_TICK * ((float_t)USER_NUM_CTRL_TICKS_PER_EST_TICK - 0.5));
+  _iq angleDeltaComp_pu = _IQmpy(angleDelta_pu, angleCompFactor);
+  _iq30 th_rad = _IQ28mpy(_IQtoIQ30(angleDeltaComp_pu),CTRL_TWO_PI_IQ28);
+  _iq30 th2 = _IQ30mpy(th_rad,th_rad);
+  _iq30 cosAngle = pPhasor30->value[0];
+  _iq30 sinAngle = pPhasor30->value[1];
+  _iq30 cosTh,sinTh;
+  _iq30 cosComp,sinComp;
+  bool flag_cosExact,flag_sinExact;
+
+
+  // sin(th) = th*(1 - th^2/6*(1 - th^2/20*(1 - th^2/42)))
+  sinTh = _IQ30(1.0) - _IQ30mpy(th2,_IQ30(1.0/42.0));
+  sinTh = _IQ30(1.0) - _IQ30mpy(_IQ30mpy(th2,_IQ30(1.0/20.0)),sinTh);
+  sinTh = _IQ30(1.0) - _IQ30mpy(_IQ30mpy(th2,_IQ30(1.0/6.0)),sinTh);
+  sinTh = _IQ30mpy(th_rad,sinTh);
+
+  // cos(th) = 1 - th^2/2*(1 - th^2/12*(1 - th^2/30*(1 - th^2/56)))
+  cosTh = _IQ30(1.0) - _IQ30mpy(th2,_IQ30(1.0/56.0));
+  cosTh = _IQ30(1.0) - _IQ30mpy(_IQ30mpy(th2,_IQ30(1.0/30.0)),cosTh);
+  cosTh = _IQ30(1.0) - _IQ30mpy(_IQ30mpy(th2,_IQ30(1.0/12.0)),cosTh);
+  cosTh = _IQ30(1.0) - _IQ30mpy(th2 >> 1,cosTh);
+
+  // rotate the phasor in IQ30
+  cosComp = _IQ30rmpy(cosAngle,cosTh) - _IQ30rmpy(sinAngle,sinTh);
+  sinComp = _IQ30rmpy(sinAngle,cosTh) + _IQ30rmpy(cosAngle,sinTh);
+
+  // the shift to GLOBAL_Q is exact when the whole error band shifts to the same value
+  flag_cosExact = (_IQabs(angleDeltaComp_pu) <= CTRL_PHASOR_ROT_MAX_ANGLE_pu) &&
+                  (_IQ30toIQ(cosComp - CTRL_PHASOR_ROT_ERR_IQ30) == _IQ30toIQ(cosComp + CTRL_PHASOR_ROT_ERR_IQ30));
+  flag_sinExact = (_IQabs(angleDeltaComp_pu) <= CTRL_PHASOR_ROT_MAX_ANGLE_pu) &&
+                  (_IQ30toIQ(sinComp - CTRL_PHASOR_ROT_ERR_IQ30) == _IQ30toIQ(sinComp + CTRL_PHASOR_ROT_ERR_IQ30));
+
+  if(flag_cosExact && flag_sinExact)
+    {
+      pPhasorComp->value[0] = _IQ30toIQ(cosComp);
+      pPhasorComp->value[1] = _IQ30toIQ(sinComp);
+    }
+  else
+    {
+      _iq angleComp_pu = CTRL_angleDelayComp(handle,angle_pu);
+
+      pPhasorComp->value[0] = flag_cosExact ? _IQ30toIQ(cosComp) : _IQcosPU(angleComp_pu);
+      pPhasorComp->value[1] = flag_sinExact ? _IQ30toIQ(sinComp) : _IQsinPU(angleComp_pu);
+    }
+
+  return;
+} // end of CTRL_computePhasorDelayComp() function
+
+
+//! \brief      Runs the online user controller with a fused current loop
+//! \details    Same control law as CTRL_runOnLine_User().  Clarke, Park, the Id and Iq PI
+//!             controllers, inverse Park and SVGEN run in one pass on local variables, the
+//!             gains and limits are not written to the PID objects every tick.  Only the values
+//!             read by other modules are stored: Iab_in, Vab_in, Idq_in, Vdq_out, Vab_out and the
+//!             PID integrator, reference and feedback values.  One IQ30 sin/cos phasor is
+//!             computed per tick.  Shifted to GLOBAL_Q it is the phasor of CTRL_computePhasor()
+//!             for the Park transform, rotated by the angle delay compensation it feeds the
+//!             inverse Park transform, see CTRL_computePhasorDelayComp().  The results match
+//!             CTRL_runOnLine_User() bit for bit.  Selected in CTRL_run() when
+//!             CTRL_FUSED_CURRENT_LOOP is defined, which excludes HFI, OBS, HCOMP, MTPA, CATCH
+//!             and REGEN, see above.
+//! \param[in]  handle    The controller (CTRL) handle
+//! \param[in]  pAdcData  The pointer to the ADC data
+//! \param[out] pPwmData  The pointer to the PWM data
+static inline void CTRL_runOnLine_UserFused(CTRL_Handle handle,
+                           const HAL_AdcData_t *pAdcData,HAL_PwmData_t *pPwmData)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+  CLARKE_Obj *clarke_I = (CLARKE_Obj *)obj->clarkeHandle_I;
+  CLARKE_Obj *clarke_V = (CLARKE_Obj *)obj->clarkeHandle_V;
+#ifdef CTRL_STATIC_CONFIG
+  const uint_least8_t numCurrentSensors = CTRL_STATIC_NUM_CURRENT_SENSORS;
+  const uint_least8_t numVoltageSensors = CTRL_STATIC_NUM_VOLTAGE_SENSORS;
+#else
+  const uint_least8_t numCurrentSensors = clarke_I->numSensors;
+  const uint_least8_t numVoltageSensors = clarke_V->numSensors;
+#endif
+
+  _iq Ialpha,Ibeta;
+  _iq Id,Iq;
+  _iq Vd = obj->Vdq_out.value[0];
+  _iq Vq = obj->Vdq_out.value[1];
+  _iq Valpha,Vbeta;
+  _iq angle_pu;
+  _iq cosTh,sinTh;
+
+  MATH_vec2 phasor30;
+  MATH_vec2 phasor;
+
+
+  // run Clarke transform on current and voltage
+  if(numCurrentSensors == 3)
+    {
+      Ialpha = _IQmpy(lshft_1(pAdcData->I.value[0]) - (pAdcData->I.value[1] + pAdcData->I.value[2]),clarke_I->alpha_sf);
+      Ibeta = _IQmpy(pAdcData->I.value[1] - pAdcData->I.value[2],clarke_I->beta_sf);
+    }
+  else
+    {
+      Ialpha = _IQmpy(pAdcData->I.value[0],clarke_I->alpha_sf);
+      Ibeta = _IQmpy(pAdcData->I.value[0] + lshft_1(pAdcData->I.value[1]),clarke_I->beta_sf);
+    }
+
+  obj->Iab_in.value[0] = Ialpha;
+  obj->Iab_in.value[1] = Ibeta;
+
+  if(numVoltageSensors == 3)
+    {
+      obj->Vab_in.value[0] = _IQmpy(lshft_1(pAdcData->V.value[0]) - (pAdcData->V.value[1] + pAdcData->V.value[2]),clarke_V->alpha_sf);
+      obj->Vab_in.value[1] = _IQmpy(pAdcData->V.value[1] - pAdcData->V.value[2],clarke_V->beta_sf);
+    }
+  else
+    {
+      obj->Vab_in.value[0] = _IQmpy(pAdcData->V.value[0],clarke_V->alpha_sf);
+      obj->Vab_in.value[1] = _IQmpy(pAdcData->V.value[0] + lshft_1(pAdcData->V.value[1]),clarke_V->beta_sf);
+    }
+
+  ISR_PROF_MARK(ISR_PROF_Stage_Clarke);
+
+
+  // run the estimator
+  EST_run(obj->estHandle,&obj->Iab_in,&obj->Vab_in,
+          pAdcData->dcBus,TRAJ_getIntValue(obj->trajHandle_spd));
+
+  ISR_PROF_MARK(ISR_PROF_Stage_Est);
+
+
+  // compute the sin/cos phasor of the motor electrical angle in IQ30, shifted to GLOBAL_Q
+  // it equals the phasor of CTRL_computePhasor()
+  angle_pu = EST_getAngle_pu(obj->estHandle);
+
+  phasor30.value[0] = _IQ30cosPU(_IQtoIQ30(angle_pu));
+  phasor30.value[1] = _IQ30sinPU(_IQtoIQ30(angle_pu));
+
+  cosTh = _IQ30toIQ(phasor30.value[0]);
+  sinTh = _IQ30toIQ(phasor30.value[1]);
+
+
+  // run the Park transform
+  Id = _IQmpy(Ialpha,cosTh) + _IQmpy(Ibeta,sinTh);
+  Iq = _IQmpy(Ibeta,cosTh) - _IQmpy(Ialpha,sinTh);
+
+  obj->Idq_in.value[0] = Id;
+  obj->Idq_in.value[1] = Iq;
+
+  ISR_PROF_MARK(ISR_PROF_Stage_Park);
+
+
+  // when appropriate, run the PID speed controller
+  if(CTRL_doSpeedCtrl(handle))
+    {
+      _iq refValue = TRAJ_getIntValue(obj->trajHandle_spd);
+      _iq fbackValue = EST_getFm_pu(obj->estHandle);
+      _iq outMax = TRAJ_getIntValue(obj->trajHandle_spdMax);
+      _iq outMin = -outMax;
+
+#if CTRL_COUNT_SPEED_TICKS
+      // reset the speed count
+      CTRL_resetCounter_speed(handle);
+#endif
+
+      PID_setMinMax(obj->pidHandle_spd,outMin,outMax);
+
+      PID_run_spd(obj->pidHandle_spd,refValue,fbackValue,CTRL_getSpd_out_addr(handle));
+
+      ISR_PROF_MARK(ISR_PROF_Stage_SpeedPi);
+    }
+
+
+  // when appropriate, run the PID Id and Iq controllers
+  if(CTRL_doCurrentCtrl(handle))
+    {
+      PID_Obj *pid_Id = (PID_Obj *)obj->pidHandle_Id;
+      PID_Obj *pid_Iq = (PID_Obj *)obj->pidHandle_Iq;
+      _iq Kp_Id = CTRL_getKp(handle,CTRL_Type_PID_Id);
+      _iq Kp_Iq = CTRL_getKp(handle,CTRL_Type_PID_Iq);
+      _iq maxVsMag = CTRL_getMaxVsMag_pu(handle);
+      _iq refValue;
+      _iq Up,Ui;
+      _iq outMax;
+
+
+#if CTRL_COUNT_CURRENT_TICKS
+      // reset the current count
+      CTRL_resetCounter_current(handle);
+#endif
+
+      // scale Kp instead of output to prevent saturation issues
+      if(CTRL_getFlag_enableDcBusComp(handle))
+        {
+          _iq oneOverDcBus_pu = EST_getOneOverDcBus_pu(obj->estHandle);
+
+          Kp_Id = _IQmpy(Kp_Id,oneOverDcBus_pu);
+          Kp_Iq = _IQmpy(Kp_Iq,oneOverDcBus_pu);
+        }
+
+      // run the Id controller
+      refValue = TRAJ_getIntValue(obj->trajHandle_Id) + CTRL_getId_ref_pu(handle);
+
+      EST_updateId_ref_pu(obj->estHandle,&refValue);
+
+      Up = _IQmpy(Kp_Id,refValue - Id);
+      Ui = _IQsat(pid_Id->Ui + _IQmpy(pid_Id->Ki,Up),maxVsMag,-maxVsMag);
+      Vd = _IQsat(Up + Ui,maxVsMag,-maxVsMag);
+
+      pid_Id->Ui = Ui;
+      pid_Id->refValue = refValue;
+      pid_Id->fbackValue = Id;
+
+      // run the Iq controller, limited to the voltage left over by Vd
+      refValue = CTRL_getFlag_enableSpeedCtrl(handle) ? CTRL_getSpd_out_pu(handle) : CTRL_getIq_ref_pu(handle);
+
+      outMax = _IQsqrt(_IQmpy(maxVsMag,maxVsMag) - _IQmpy(Vd,Vd));
+
+      Up = _IQmpy(Kp_Iq,refValue - Iq);
+      Ui = _IQsat(pid_Iq->Ui + _IQmpy(pid_Iq->Ki,Up),outMax,-outMax);
+      Vq = _IQsat(Up + Ui,outMax,-outMax);
+
+      pid_Iq->Ui = Ui;
+      pid_Iq->refValue = refValue;
+      pid_Iq->fbackValue = Iq;
+
+      obj->Vdq_out.value[0] = Vd;
+      obj->Vdq_out.value[1] = Vq;
+
+      ISR_PROF_MARK(ISR_PROF_Stage_CurrentPi);
+    }
+
+
+  // compute the sin/cos phasor of the delay compensated angle
+  CTRL_computePhasorDelayComp(handle,angle_pu,&phasor30,&phasor);
+
+  cosTh = phasor.value[0];
+  sinTh = phasor.value[1];
+
+
+  // run the inverse Park transform
+  Valpha = _IQmpy(Vd,cosTh) - _IQmpy(Vq,sinTh);
+  Vbeta = _IQmpy(Vq,cosTh) + _IQmpy(Vd,sinTh);
+
+  obj->Vab_out.value[0] = Valpha;
+  obj->Vab_out.value[1] = Vbeta;
+
+
+  // run the space vector generator
+  {
+    _iq Va_tmp = -(Valpha >> 1);
+    _iq Vb_tmp = _IQmpy(SVGEN_SQRT3_OVER_2,Vbeta);
+    _iq Va = Valpha;
+    _iq Vb = Va_tmp + Vb_tmp;
+    _iq Vc = Va_tmp - Vb_tmp;
+    _iq Vmax,Vmin,Vcom;
+
+    if(Va > Vb)
+      {
+        Vmax = Va;
+        Vmin = Vb;
+      }
+    else
+      {
+        Vmax = Vb;
+        Vmin = Va;
+      }
+
+    if(Vc > Vmax)
+      {
+        Vmax = Vc;
+      }
+    else if(Vc < Vmin)
+      {
+        Vmin = Vc;
+      }
+
+    Vcom = _IQmpy(Vmax + Vmin,_IQ(0.5));
+
+    pPwmData->Tabc.value[0] = Va - Vcom;
+    pPwmData->Tabc.value[1] = Vb - Vcom;
+    pPwmData->Tabc.value[2] = Vc - Vcom;
+  }
+
+  ISR_PROF_MARK(ISR_PROF_Stage_Svgen);
+
+  return;
+} // end of CTRL_runOnLine_UserFused() function
+
+
 //! \brief      Runs the online controller
 //! \param[in]  handle    The controller (CTRL) handle
-inline void CTRL_runPiOnly(CTRL_Handle handle) //,const HAL_AdcData_t *pAdcData,HAL_PwmData_t *pPwmData)
+static inline void CTRL_runPiOnly(CTRL_Handle handle) //,const HAL_AdcData_t *pAdcData,HAL_PwmData_t *pPwmData)
 {
   CTRL_Obj *obj = (CTRL_Obj *)handle;
 
@@ -2525,8 +3255,10 @@ inline void CTRL_runPiOnly(CTRL_Handle handle) //,const HAL_AdcData_t *pAdcData,
       _iq outMax = CTRL_getSpeed_outMax_pu(handle);
       _iq outMin = -outMax;
 
+#if CTRL_COUNT_SPEED_TICKS
       // reset the speed count
       CTRL_resetCounter_speed(handle);
+#endif
 
       PID_setMinMax(obj->pidHandle_spd,outMin,outMax);
 
@@ -2554,8 +3286,10 @@ inline void CTRL_runPiOnly(CTRL_Handle handle) //,const HAL_AdcData_t *pAdcData,
 
     _iq maxVsMag = CTRL_getMaxVsMag_pu(handle);
 
+#if CTRL_COUNT_CURRENT_TICKS
     // reset the current count
     CTRL_resetCounter_current(handle);
+#endif
 
     // ***********************************
     // configure and run the Id controller
@@ -60,6 +60,30 @@
 
 #include "sw/modules/datalog/src/32b/datalog.h"
 
+#ifdef HFI_ENABLE
+#include "sw/modules/hfi/src/32b/hfi.h"
+#endif
+
+#ifdef OBS_ENABLE
+#include "sw/modules/obs/src/32b/obs.h"
+#endif
+
+#ifdef HCOMP_ENABLE
+#include "sw/modules/hcomp/src/32b/hcomp.h"
+#endif
+
+#ifdef MTPA_ENABLE
+#include "sw/modules/mtpa/src/32b/mtpa.h"
+#endif
+
+#ifdef CATCH_ENABLE
+#include "sw/modules/catch/src/32b/catch.h"
+#endif
+
+#ifdef REGEN_ENABLE
+#include "sw/modules/regen/src/32b/regen.h"
+#endif
+
 //!
 //!
 //! \defgroup CTRL_OBJ CTRL_OBJ
@@ -189,6 +213,30 @@ typedef struct _CTRL_Obj_
   TRAJ_Handle        trajHandle_spdMax;            //!< the handle for the maximum speed trajectory generator
   TRAJ_Obj           traj_spdMax;                  //!< the maximum speed trajectory generator object
 
+#ifdef HFI_ENABLE
+  HFI_Handle         hfiHandle;                    //!< the handle for the high frequency injection, set by the project
+#endif
+
+#ifdef OBS_ENABLE
+  OBS_Handle         obsHandle;                    //!< the handle for the back-EMF observer, set by the project
+#endif
+
+#ifdef HCOMP_ENABLE
+  HCOMP_Handle       hcompHandle;                  //!< the handle for the harmonic compensator, set by the project
+#endif
+
+#ifdef MTPA_ENABLE
+  MTPA_Handle        mtpaHandle;                   //!< the handle for the maximum torque per ampere module, set by the project
+#endif
+
+#ifdef CATCH_ENABLE
+  CATCH_Handle       catchHandle;                  //!< the handle for the back-EMF catch spin, set by the project
+#endif
+
+#ifdef REGEN_ENABLE
+  REGEN_Handle       regenHandle;                  //!< the handle for the regenerative braking governor, set by the project
+#endif
+
   MOTOR_Params       motorParams;                  //!< the motor parameters
 
   uint_least32_t     waitTimes[CTRL_numStates];    //!< an array of wait times for each state, estimator clock counts
@@ -0,0 +1,340 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/ctrl/src/32b/host/ctrl_rom.c
+//! \brief  Contains the host stand-ins for the controller (CTRL) functions
+//!         that only exist in the ROM of the target device
+//!
+//!         Together with the host estimator in modules/est/src/32b/host these
+//!         allow ctrl.c and the projects to be built and run on a PC.  Only
+//!         the behavior needed to run a motor with parameters from user.h is
+//!         reproduced, motor identification is not.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/ctrl/src/32b/ctrl.h"
+#include "sw/modules/est/src/32b/host/est_host.h"
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the major release number reported by the host controller
+//!
+#define CTRL_HOST_VERSION_MAJOR     (1)
+
+//! \brief Defines the minor release number reported by the host controller, matches FAST_ROM_V1p7
+//!
+#define CTRL_HOST_VERSION_MINOR     (7)
+
+
+// **************************************************************************
+// the globals
+
+
+// **************************************************************************
+// the functions
+
+void CTRL_getTrajStep(CTRL_Handle handle)
+{
+
+  // the step sizes are set directly by the user, nothing to compute
+  return;
+} // end of CTRL_getTrajStep() function
+
+
+void CTRL_getVersion(CTRL_Handle handle,CTRL_Version *pVersion)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+  pVersion->rsvd = obj->version.rsvd;
+  pVersion->targetProc = obj->version.targetProc;
+  pVersion->major = obj->version.major;
+  pVersion->minor = obj->version.minor;
+
+  return;
+} // end of CTRL_getVersion() function
+
+
+CTRL_Handle CTRL_initCtrl(const uint_least8_t estNumber,void *pMemory,const size_t numBytes)
+{
+  CTRL_Handle handle;
+  CTRL_Obj *obj;
+
+
+  if(numBytes < sizeof(CTRL_Obj))
+    return((CTRL_Handle)NULL);
+
+
+  // assign the handle
+  handle = (CTRL_Handle)pMemory;
+
+
+  // assign the object
+  obj = (CTRL_Obj *)handle;
+
+
+  // set the version
+  obj->version.rsvd = 0;
+  obj->version.targetProc = CTRL_TargetProc_2802x;
+  obj->version.major = CTRL_HOST_VERSION_MAJOR;
+  obj->version.minor = CTRL_HOST_VERSION_MINOR;
+
+
+  // initialize the Clarke modules
+  obj->clarkeHandle_I = CLARKE_init(&obj->clarke_I,sizeof(obj->clarke_I));
+  obj->clarkeHandle_V = CLARKE_init(&obj->clarke_V,sizeof(obj->clarke_V));
+
+
+  // initialize the estimator
+  obj->estHandle = EST_initEst(estNumber);
+
+
+  // initialize the Park and inverse Park modules
+  obj->parkHandle = PARK_init(&obj->park,sizeof(obj->park));
+  obj->iparkHandle = IPARK_init(&obj->ipark,sizeof(obj->ipark));
+
+
+  // initialize the PID controllers
+  obj->pidHandle_Id = PID_init(&obj->pid_Id,sizeof(obj->pid_Id));
+  obj->pidHandle_Iq = PID_init(&obj->pid_Iq,sizeof(obj->pid_Iq));
+  obj->pidHandle_spd = PID_init(&obj->pid_spd,sizeof(obj->pid_spd));
+
+
+  // initialize the space vector generator module
+  obj->svgenHandle = SVGEN_init(&obj->svgen,sizeof(obj->svgen));
+
+
+  // initialize the trajectory generators
+  obj->trajHandle_Id = TRAJ_init(&obj->traj_Id,sizeof(obj->traj_Id));
+  obj->trajHandle_spd = TRAJ_init(&obj->traj_spd,sizeof(obj->traj_spd));
+  obj->trajHandle_spdMax = TRAJ_init(&obj->traj_spdMax,sizeof(obj->traj_spdMax));
+
+  return(handle);
+} // end of CTRL_initCtrl() function
+
+
+void CTRL_runTraj(CTRL_Handle handle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+
+  // the trajectories only move while the estimator is online
+  if(EST_isOnLine(obj->estHandle))
+    {
+      TRAJ_setTargetValue(obj->trajHandle_spd,CTRL_getSpd_ref_pu(handle));
+
+      TRAJ_run(obj->trajHandle_Id);
+      TRAJ_run(obj->trajHandle_spd);
+      TRAJ_run(obj->trajHandle_spdMax);
+    }
+
+  return;
+} // end of CTRL_runTraj() function
+
+
+void CTRL_setEstParams(EST_Handle estHandle,USER_Params *pUserParams)
+{
+  float_t fullScaleInductance = pUserParams->iqFullScaleVoltage_V/(pUserParams->iqFullScaleCurrent_A*pUserParams->voltageFilterPole_rps);
+  float_t fullScaleResistance = pUserParams->iqFullScaleVoltage_V/pUserParams->iqFullScaleCurrent_A;
+  float_t fullScaleFlux = pUserParams->iqFullScaleVoltage_V/(float_t)pUserParams->estFreq_Hz;
+
+
+  // set the full scale values
+  EST_setFullScaleCurrent(estHandle,pUserParams->iqFullScaleCurrent_A);
+  EST_setFullScaleVoltage(estHandle,pUserParams->iqFullScaleVoltage_V);
+  EST_setFullScaleFreq(estHandle,pUserParams->iqFullScaleFreq_Hz);
+  EST_setFullScaleInductance(estHandle,fullScaleInductance);
+  EST_setFullScaleResistance(estHandle,fullScaleResistance);
+  EST_setFullScaleFlux(estHandle,fullScaleFlux);
+
+
+  // set the number of pole pairs, needed for the speed conversions
+  EST_setNumPolePairs(estHandle,pUserParams->motor_numPolePairs);
+
+
+  // set the limits
+  EST_setMaxCurrent_pu(estHandle,_IQ(pUserParams->maxCurrent/pUserParams->iqFullScaleCurrent_A));
+  EST_setMaxCurrentSlope_pu(estHandle,_IQ(pUserParams->maxCurrentSlope));
+  EST_setMaxAccel_pu(estHandle,_IQ(pUserParams->maxAccel_Hzps/pUserParams->iqFullScaleFreq_Hz/(float_t)pUserParams->trajFreq_Hz));
+  EST_setMaxAccel_est_pu(estHandle,_IQ(pUserParams->maxAccel_est_Hzps/pUserParams->iqFullScaleFreq_Hz/(float_t)pUserParams->trajFreq_Hz));
+  EST_setIdRated_pu(estHandle,_IQ(pUserParams->IdRated/pUserParams->iqFullScaleCurrent_A));
+
+
+  // set the default state
+  EST_setIdle_all(estHandle);
+
+  return;
+} // end of CTRL_setEstParams() function
+
+
+void CTRL_setIab_filt_pu(CTRL_Handle handle,const MATH_vec2 *pIab_filt_pu)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+  obj->Iab_filt.value[0] = pIab_filt_pu->value[0];
+  obj->Iab_filt.value[1] = pIab_filt_pu->value[1];
+
+  return;
+} // end of CTRL_setIab_filt_pu() function
+
+
+void CTRL_setUserMotorParams(CTRL_Handle handle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+
+  // only load the parameters once, this is called on every idle pass
+  if(!EST_isMotorIdentified(obj->estHandle))
+    {
+      EST_setMotorParams(obj->estHandle,
+                         obj->motorParams.numPolePairs,
+                         obj->motorParams.ratedFlux_VpHz,
+                         obj->motorParams.Ls_d_H,
+                         obj->motorParams.Ls_q_H,
+                         obj->motorParams.Rs_Ohm);
+    }
+
+  return;
+} // end of CTRL_setUserMotorParams() function
+
+
+void CTRL_setupCtrl(CTRL_Handle handle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+
+  // start the controllers from rest
+  PID_setUi(obj->pidHandle_Id,_IQ(0.0));
+  PID_setUi(obj->pidHandle_Iq,_IQ(0.0));
+  PID_setUi(obj->pidHandle_spd,_IQ(0.0));
+
+  PID_setRefValue(obj->pidHandle_Id,_IQ(0.0));
+  PID_setRefValue(obj->pidHandle_Iq,_IQ(0.0));
+  PID_setRefValue(obj->pidHandle_spd,_IQ(0.0));
+
+  CTRL_setSpd_out_pu(handle,_IQ(0.0));
+  obj->Vdq_out.value[0] = _IQ(0.0);
+  obj->Vdq_out.value[1] = _IQ(0.0);
+
+
+  // load the gains
+  PID_setGains(obj->pidHandle_Id,obj->Kp_Id,obj->Ki_Id,obj->Kd_Id);
+  PID_setGains(obj->pidHandle_Iq,obj->Kp_Iq,obj->Ki_Iq,obj->Kd_Iq);
+  PID_setGains(obj->pidHandle_spd,obj->Kp_spd,obj->Ki_spd,obj->Kd_spd);
+
+  return;
+} // end of CTRL_setupCtrl() function
+
+
+void CTRL_setupEst(CTRL_Handle handle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+  EST_setIdle(obj->estHandle);
+
+  return;
+} // end of CTRL_setupEst() function
+
+
+void CTRL_setupEstIdleState(CTRL_Handle handle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+
+
+  // park the trajectories at zero
+  TRAJ_setIntValue(obj->trajHandle_spd,_IQ(0.0));
+  TRAJ_setTargetValue(obj->trajHandle_spd,_IQ(0.0));
+  TRAJ_setIntValue(obj->trajHandle_Id,_IQ(0.0));
+  TRAJ_setTargetValue(obj->trajHandle_Id,_IQ(0.0));
+
+  return;
+} // end of CTRL_setupEstIdleState() function
+
+
+void CTRL_setupEstOnLineState(CTRL_Handle handle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+  _iq maxCurrent_pu = EST_getMaxCurrent_pu(obj->estHandle);
+
+
+  // the speed controller output may use the full current once online
+  TRAJ_setTargetValue(obj->trajHandle_spdMax,maxCurrent_pu);
+  TRAJ_setMaxValue(obj->trajHandle_spdMax,maxCurrent_pu);
+
+  return;
+} // end of CTRL_setupEstOnLineState() function
+
+
+void CTRL_setupTraj(CTRL_Handle handle)
+{
+  CTRL_Obj *obj = (CTRL_Obj *)handle;
+  _iq maxCurrent_pu = EST_getMaxCurrent_pu(obj->estHandle);
+  _iq maxCurrentSlope_pu = EST_getMaxCurrentSlope_pu(obj->estHandle);
+
+
+  // Id trajectory, permanent magnet motors run at zero Id
+  TRAJ_setIntValue(obj->trajHandle_Id,_IQ(0.0));
+  TRAJ_setTargetValue(obj->trajHandle_Id,_IQ(0.0));
+  TRAJ_setMinValue(obj->trajHandle_Id,-maxCurrent_pu);
+  TRAJ_setMaxValue(obj->trajHandle_Id,maxCurrent_pu);
+  TRAJ_setMaxDelta(obj->trajHandle_Id,maxCurrentSlope_pu);
+
+
+  // speed trajectory, the acceleration is managed by CTRL_setMaxAccel_pu()
+  TRAJ_setIntValue(obj->trajHandle_spd,_IQ(0.0));
+  TRAJ_setTargetValue(obj->trajHandle_spd,_IQ(0.0));
+  TRAJ_setMinValue(obj->trajHandle_spd,_IQ(-1.0));
+  TRAJ_setMaxValue(obj->trajHandle_spd,_IQ(1.0));
+
+  if(TRAJ_getMaxDelta(obj->trajHandle_spd) == _IQ(0.0))
+    {
+      TRAJ_setMaxDelta(obj->trajHandle_spd,EST_getMaxAccel_pu(obj->estHandle));
+    }
+
+
+  // maximum speed controller output
+  TRAJ_setIntValue(obj->trajHandle_spdMax,maxCurrent_pu);
+  TRAJ_setTargetValue(obj->trajHandle_spdMax,maxCurrent_pu);
+  TRAJ_setMinValue(obj->trajHandle_spdMax,_IQ(0.0));
+  TRAJ_setMaxValue(obj->trajHandle_spdMax,maxCurrent_pu);
+  TRAJ_setMaxDelta(obj->trajHandle_spdMax,maxCurrentSlope_pu);
+
+  return;
+} // end of CTRL_setupTraj() function
+
+
+// end of file
+
@@ -134,7 +134,7 @@ extern DATALOG_Handle DATALOG_init(void *pMemory,const size_t numBytes);
 
 //! \brief     Updates the data logger
 //! \param[in] ptr  The pointer to memory
-static inline DATALOG_update(DATALOG_Handle handle)
+static inline void DATALOG_update(DATALOG_Handle handle)
 {
 	DATALOG_Obj *obj = (DATALOG_Obj *)handle;
 
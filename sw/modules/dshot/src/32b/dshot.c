@@ -0,0 +1,607 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/dshot/src/32b/dshot.c
+//! \brief  Portable C code.  These functions define the
+//!         DShot digital throttle decoder (DSHOT) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/dshot/src/32b/dshot.h"
+
+
+// **************************************************************************
+// the globals
+
+//! \brief The 5-bit GCR codes of the nibbles
+static const uint16_t DSHOT_gcrTable[16] =
+{
+  0x19, 0x1B, 0x12, 0x13, 0x1D, 0x15, 0x16, 0x17,
+  0x1A, 0x09, 0x0A, 0x0B, 0x1E, 0x0D, 0x0E, 0x0F
+};
+
+//! \brief The extended telemetry frame types, in the order of DSHOT_Edt_e
+static const uint16_t DSHOT_edtType[DSHOT_EDT_NUM_TYPES] = {0x2, 0x4, 0x6};
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Acts on a command frame
+//! \param[in] obj  The pointer to the DShot decoder (DSHOT) object
+//! \param[in] cmd  The command, 1 to DSHOT_MIN_THROTTLE - 1
+static void DSHOT_runCmd(DSHOT_Obj *obj,const uint16_t cmd)
+{
+  if(cmd == obj->cmd_z1)
+    {
+      if(obj->cmdRepeatCnt < DSHOT_CMD_NUM_REPEATS)
+        {
+          obj->cmdRepeatCnt++;
+        }
+      else
+        {
+          // act once per run of repeated frames
+          return;
+        }
+    }
+  else
+    {
+      obj->cmd_z1 = cmd;
+      obj->cmdRepeatCnt = 1;
+    }
+
+  switch(cmd)
+    {
+      case DSHOT_Cmd_Beep1:
+      case DSHOT_Cmd_Beep2:
+      case DSHOT_Cmd_Beep3:
+      case DSHOT_Cmd_Beep4:
+      case DSHOT_Cmd_Beep5:
+      case DSHOT_Cmd_EscInfo:
+        if(obj->cmdRepeatCnt == 1)
+          {
+            obj->cmd = (DSHOT_Cmd_e)cmd;
+          }
+        break;
+      case DSHOT_Cmd_SpinDirection1:
+      case DSHOT_Cmd_SpinDirectionNormal:
+        if(obj->cmdRepeatCnt == DSHOT_CMD_NUM_REPEATS)
+          {
+            obj->flag_reversed = false;
+            obj->cmd = (DSHOT_Cmd_e)cmd;
+          }
+        break;
+      case DSHOT_Cmd_SpinDirection2:
+      case DSHOT_Cmd_SpinDirectionReversed:
+        if(obj->cmdRepeatCnt == DSHOT_CMD_NUM_REPEATS)
+          {
+            obj->flag_reversed = true;
+            obj->cmd = (DSHOT_Cmd_e)cmd;
+          }
+        break;
+      case DSHOT_Cmd_SaveSettings:
+        if(obj->cmdRepeatCnt == DSHOT_CMD_NUM_REPEATS)
+          {
+            obj->cmd = (DSHOT_Cmd_e)cmd;
+          }
+        break;
+      case DSHOT_Cmd_EdtEnable:
+      case DSHOT_Cmd_EdtDisable:
+        if(obj->cmdRepeatCnt == DSHOT_CMD_NUM_REPEATS)
+          {
+            obj->flag_edt = (cmd == DSHOT_Cmd_EdtEnable);
+            obj->edtCnt = 0;
+            obj->cmd = (DSHOT_Cmd_e)cmd;
+          }
+        break;
+      default:
+        break;
+    }
+
+  return;
+} // end of DSHOT_runCmd() function
+
+
+//! \brief     Acts on a frame with a valid CRC
+//! \param[in] obj    The pointer to the DShot decoder (DSHOT) object
+//! \param[in] frame  The 16-bit frame
+static void DSHOT_runFrame(DSHOT_Obj *obj,const uint16_t frame)
+{
+  uint16_t value = frame >> 5;
+
+  obj->value = value;
+  obj->flag_telemRequest = (frame >> 4) & 1;
+  obj->timeoutCnt = 0;
+  obj->numFrames++;
+
+  // a lost signal needs the motor stop frames again
+  if((obj->state == DSHOT_State_NoSignal) || (obj->state == DSHOT_State_Failsafe))
+    {
+      obj->state = DSHOT_State_Disarmed;
+      obj->armCnt = 0;
+    }
+
+  if(value >= DSHOT_MIN_THROTTLE)
+    {
+      obj->cmd_z1 = DSHOT_Cmd_MotorStop;
+      obj->cmdRepeatCnt = 0;
+
+      if(obj->state == DSHOT_State_Armed)
+        {
+          _iq throttle = (_iq)(value - DSHOT_MIN_THROTTLE) * DSHOT_THROTTLE_SCALE;
+
+          obj->throttle = (throttle > _IQ(1.0)) ? _IQ(1.0) : throttle;
+        }
+      else
+        {
+          obj->armCnt = 0;
+        }
+
+      return;
+    }
+
+  obj->throttle = _IQ(0.0);
+
+  if(value == DSHOT_Cmd_MotorStop)
+    {
+      obj->cmd_z1 = DSHOT_Cmd_MotorStop;
+      obj->cmdRepeatCnt = 0;
+
+      if((obj->state == DSHOT_State_Disarmed) && (++obj->armCnt >= obj->armNumFrames))
+        {
+          obj->state = DSHOT_State_Armed;
+        }
+    }
+  else
+    {
+      DSHOT_runCmd(obj,value);
+    }
+
+  return;
+} // end of DSHOT_runFrame() function
+
+
+//! \brief     Builds the bidirectional DShot reply to a frame
+//! \param[in] obj          The pointer to the DShot decoder (DSHOT) object
+//! \param[in] span_cnts    The time from the first to the last pulse start, cnts
+//! \param[in] lastStartCnt The time stamp of the last pulse start, cnts
+static void DSHOT_buildReply(DSHOT_Obj *obj,const uint32_t span_cnts,const uint32_t lastStartCnt)
+{
+  uint32_t bitPeriod_cnts = ((span_cnts * 4) + 37) / 75;   // 4/5 of span/15
+  uint32_t startCnt = lastStartCnt + ((span_cnts + 7) / 15) + obj->replyDelay_cnts;
+  uint16_t value = obj->erpmValue;
+  uint16_t frame;
+  uint32_t gcr = 0;
+  uint_least8_t cnt;
+
+  // every DSHOT_EDT_PERIOD-th reply is the next measured telemetry value
+  if(obj->flag_edt && (++obj->edtCnt >= DSHOT_EDT_PERIOD))
+    {
+      obj->edtCnt = 0;
+
+      for(cnt=0;cnt<DSHOT_EDT_NUM_TYPES;cnt++)
+        {
+          obj->edtIndex = (obj->edtIndex + 1 < DSHOT_EDT_NUM_TYPES) ? (obj->edtIndex + 1) : 0;
+
+          if(obj->edtValue[obj->edtIndex] >= 0)
+            {
+              value = (DSHOT_edtType[obj->edtIndex] << 8) | (obj->edtValue[obj->edtIndex] & 0xFF);
+              break;
+            }
+        }
+    }
+
+  frame = (uint16_t)((value << 4) | (~(value ^ (value >> 4) ^ (value >> 8)) & 0xF));
+
+  for(cnt=0;cnt<4;cnt++)
+    {
+      gcr = (gcr << 5) | DSHOT_gcrTable[(frame >> (12 - (cnt * 4))) & 0xF];
+    }
+
+  // the start transition, then the GCR bits
+  obj->replyTransitions = ((uint32_t)1 << 20) | gcr;
+  obj->replyCnt = startCnt;
+  obj->replyBitPeriod_cnts = bitPeriod_cnts;
+  obj->flag_replyPending = true;
+
+  return;
+} // end of DSHOT_buildReply() function
+
+
+//! \brief     Takes the next run of the reply, a one bit and the zero bits after it
+//! \param[in] obj  The pointer to the DShot decoder (DSHOT) object
+//! \return    The length of the run, bits, zero when all bits are taken
+static uint_least8_t DSHOT_takeReplyRun(DSHOT_Obj *obj)
+{
+  uint_least8_t numBits = 0;
+
+  while(obj->replyNumBits > 0)
+    {
+      obj->replyNumBits--;
+      numBits++;
+
+      // the run ends before the next level change
+      if((obj->replyNumBits == 0) ||
+         ((obj->replyTransitions >> (obj->replyNumBits - 1)) & 1))
+        {
+          break;
+        }
+    }
+
+  return(numBits);
+} // end of DSHOT_takeReplyRun() function
+
+
+//! \brief     Decodes the bits of a complete frame
+//! \param[in] obj          The pointer to the DShot decoder (DSHOT) object
+//! \param[in] span_cnts    The time from the first to the last pulse start, cnts
+//! \param[in] lastStartCnt The time stamp of the last pulse start, cnts
+static void DSHOT_decodeFrame(DSHOT_Obj *obj,const uint32_t span_cnts,const uint32_t lastStartCnt)
+{
+  // the pulse of a one is 3/4 and of a zero 3/8 of the bit period long,
+  // the threshold 9/16 of the mean period is highCnt * 16 * 15 > span * 9
+  uint32_t threshold_cnts = span_cnts * 9;
+  uint16_t frame = 0;
+  uint16_t crc;
+  uint_least8_t bitNumber;
+
+  for(bitNumber=0;bitNumber<DSHOT_NUM_BITS;bitNumber++)
+    {
+      frame <<= 1;
+
+      if((obj->highCnt[bitNumber] * (16 * (DSHOT_NUM_BITS - 1))) > threshold_cnts)
+        {
+          frame |= 1;
+        }
+    }
+
+  crc = (frame ^ (frame >> 4) ^ (frame >> 8) ^ (frame >> 12)) & 0xF;
+
+  // bidirectional DShot inverts the CRC
+  if(crc != (obj->flag_bidir ? 0xF : 0))
+    {
+      obj->numCrcErrors++;
+      return;
+    }
+
+  DSHOT_runFrame(obj,frame);
+
+  if(obj->flag_bidir)
+    {
+      DSHOT_buildReply(obj,span_cnts,lastStartCnt);
+    }
+
+  return;
+} // end of DSHOT_decodeFrame() function
+
+
+uint16_t DSHOT_decodeReply(const uint32_t transitions)
+{
+  uint16_t frame = 0;
+  uint16_t crc;
+  uint_least8_t cnt;
+
+  if((transitions >> 20) != 1)
+    {
+      return(DSHOT_REPLY_INVALID);
+    }
+
+  for(cnt=0;cnt<4;cnt++)
+    {
+      uint16_t code = (uint16_t)(transitions >> (15 - (cnt * 5))) & 0x1F;
+      uint16_t nibble;
+
+      for(nibble=0;nibble<16;nibble++)
+        {
+          if(DSHOT_gcrTable[nibble] == code)
+            {
+              break;
+            }
+        }
+
+      if(nibble == 16)
+        {
+          return(DSHOT_REPLY_INVALID);
+        }
+
+      frame = (frame << 4) | nibble;
+    }
+
+  crc = (frame ^ (frame >> 4) ^ (frame >> 8) ^ (frame >> 12)) & 0xF;
+
+  if(crc != 0xF)
+    {
+      return(DSHOT_REPLY_INVALID);
+    }
+
+  return(frame >> 4);
+} // end of DSHOT_decodeReply() function
+
+
+bool DSHOT_getReplyPwm(DSHOT_Handle handle,uint32_t *pPeriod_cnts,uint32_t *pLow_cnts)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+  uint_least8_t lowBits = DSHOT_takeReplyRun(obj);
+  uint_least8_t highBits;
+
+  if(lowBits == 0)
+    {
+      if(!obj->flag_replyIdle)
+        {
+          return(false);
+        }
+
+      // the line stays high until the capture is rearmed
+      obj->flag_replyIdle = false;
+
+      *pPeriod_cnts = DSHOT_REPLY_NUM_BITS * obj->replyBitPeriod_cnts;
+      *pLow_cnts = 0;
+
+      return(true);
+    }
+
+  // after the last bit the line returns high
+  highBits = DSHOT_takeReplyRun(obj);
+
+  if(highBits == 0)
+    {
+      highBits = 1;
+    }
+
+  *pPeriod_cnts = (uint32_t)(lowBits + highBits) * obj->replyBitPeriod_cnts;
+  *pLow_cnts = (uint32_t)lowBits * obj->replyBitPeriod_cnts;
+
+  obj->replyCnt += *pPeriod_cnts;
+
+  return(true);
+} // end of DSHOT_getReplyPwm() function
+
+
+DSHOT_Handle DSHOT_init(void *pMemory,const size_t numBytes)
+{
+  DSHOT_Handle handle;
+  DSHOT_Obj *obj;
+  uint_least8_t cnt;
+
+  if(numBytes < sizeof(DSHOT_Obj))
+    return((DSHOT_Handle)NULL);
+
+  // assign the handle
+  handle = (DSHOT_Handle)pMemory;
+
+  obj = (DSHOT_Obj *)handle;
+
+  for(cnt=0;cnt<DSHOT_NUM_BITS;cnt++)
+    {
+      obj->highCnt[cnt] = 0;
+    }
+
+  obj->startCnt_z1 = 0;
+  obj->firstStartCnt = 0;
+  obj->bitPeriod_cnts = 0;
+  obj->numBits = 0;
+  obj->numFrames = 0;
+  obj->numCrcErrors = 0;
+  obj->numFrameErrors = 0;
+
+  obj->flag_replyPending = false;
+  obj->replyTransitions = 0;
+  obj->replyNumBits = 0;
+  obj->flag_replyIdle = false;
+  obj->replyCnt = 0;
+  obj->replyBitPeriod_cnts = 0;
+  obj->numReplies = 0;
+
+  for(cnt=0;cnt<DSHOT_EDT_NUM_TYPES;cnt++)
+    {
+      obj->edtValue[cnt] = DSHOT_EDT_NO_VALUE;
+    }
+
+  DSHOT_setParams(handle,60000000,1,1);
+  DSHOT_setBidirParams(handle,false,1);
+
+  return(handle);
+} // end of DSHOT_init() function
+
+
+void DSHOT_runPulse(DSHOT_Handle handle,const uint32_t startCnt,const uint32_t endCnt)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+  uint32_t period_cnts = startCnt - obj->startCnt_z1;
+  uint32_t high_cnts = endCnt - startCnt;
+
+  obj->startCnt_z1 = startCnt;
+
+  if(high_cnts >= obj->maxBitPeriod_cnts)
+    {
+      // the signal stuck high or the captures are out of order
+      if(obj->numBits > 0)
+        {
+          obj->numFrameErrors++;
+          obj->numBits = 0;
+        }
+
+      return;
+    }
+
+  if(obj->numBits > 0)
+    {
+      uint32_t maxPeriod_cnts = (obj->numBits == 1) ? obj->maxBitPeriod_cnts :
+                                obj->bitPeriod_cnts + (obj->bitPeriod_cnts >> 1);
+
+      if(period_cnts > maxPeriod_cnts)
+        {
+          // the gap ends an incomplete frame, this pulse starts the next one
+          obj->numFrameErrors++;
+          obj->numBits = 0;
+        }
+      else if(obj->numBits == 1)
+        {
+          if(period_cnts < obj->minBitPeriod_cnts)
+            {
+              obj->numFrameErrors++;
+              obj->numBits = 0;
+              return;
+            }
+
+          obj->bitPeriod_cnts = period_cnts;
+        }
+      else if(period_cnts < (obj->bitPeriod_cnts - (obj->bitPeriod_cnts >> 2)))
+        {
+          // a glitch or a lost edge
+          obj->numFrameErrors++;
+          obj->numBits = 0;
+          return;
+        }
+    }
+
+  if(obj->numBits == 0)
+    {
+      obj->firstStartCnt = startCnt;
+    }
+
+  obj->highCnt[obj->numBits++] = high_cnts;
+
+  if(obj->numBits == DSHOT_NUM_BITS)
+    {
+      obj->numBits = 0;
+
+      DSHOT_decodeFrame(obj,startCnt - obj->firstStartCnt,startCnt);
+    }
+
+  return;
+} // end of DSHOT_runPulse() function
+
+
+void DSHOT_setBidirParams(DSHOT_Handle handle,
+                          const bool flag_bidir,
+                          const uint32_t fullScaleFreq_Hz)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  obj->flag_bidir = flag_bidir;
+  obj->periodScale = ((uint64_t)1000000 << GLOBAL_Q) / fullScaleFreq_Hz;
+  obj->erpmValue = DSHOT_REPLY_ZERO_SPEED;
+  obj->flag_edt = false;
+  obj->edtCnt = 0;
+  obj->edtIndex = DSHOT_EDT_NUM_TYPES - 1;
+  obj->replyDelay_cnts = DSHOT_REPLY_DELAY_usec * obj->cntsPerUsec;
+  obj->flag_replyPending = false;
+
+  return;
+} // end of DSHOT_setBidirParams() function
+
+
+void DSHOT_setEdtValues(DSHOT_Handle handle,
+                        const int16_t temperature_C,
+                        const int16_t voltage_qV,
+                        const int16_t current_A)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  obj->edtValue[DSHOT_Edt_Temperature] = (temperature_C > 255) ? 255 : temperature_C;
+  obj->edtValue[DSHOT_Edt_Voltage] = (voltage_qV > 255) ? 255 : voltage_qV;
+  obj->edtValue[DSHOT_Edt_Current] = (current_A > 255) ? 255 : current_A;
+
+  return;
+} // end of DSHOT_setEdtValues() function
+
+
+void DSHOT_setParams(DSHOT_Handle handle,
+                     const uint32_t clockFreq_Hz,
+                     const uint_least16_t timeout_ticks,
+                     const uint_least16_t armNumFrames)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+  uint32_t cntsPerUsec = clockFreq_Hz / 1000000;
+
+  obj->cntsPerUsec = cntsPerUsec;
+  obj->minBitPeriod_cnts = (DSHOT_MIN_BIT_PERIOD_ns * cntsPerUsec) / 1000;
+  obj->maxBitPeriod_cnts = (DSHOT_MAX_BIT_PERIOD_ns * cntsPerUsec) / 1000;
+  obj->numBits = 0;
+
+  obj->value = 0;
+  obj->flag_telemRequest = false;
+  obj->throttle = _IQ(0.0);
+
+  obj->state = DSHOT_State_NoSignal;
+  obj->armNumFrames = (armNumFrames > 0) ? armNumFrames : 1;
+  obj->armCnt = 0;
+  obj->timeout_ticks = (timeout_ticks > 0) ? timeout_ticks : 1;
+  obj->timeoutCnt = 0;
+
+  obj->cmd_z1 = DSHOT_Cmd_MotorStop;
+  obj->cmdRepeatCnt = 0;
+  obj->cmd = DSHOT_Cmd_None;
+  obj->flag_reversed = false;
+
+  return;
+} // end of DSHOT_setParams() function
+
+
+void DSHOT_setSpeed(DSHOT_Handle handle,const _iq elecFreq_pu)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+  uint32_t freq_pu = (uint32_t)((elecFreq_pu < 0) ? -elecFreq_pu : elecFreq_pu);
+  uint64_t period_usec;
+  uint16_t shift = 0;
+
+  // the longest period is the 9-bit mantissa shifted by 7
+  if(freq_pu == 0)
+    {
+      obj->erpmValue = DSHOT_REPLY_ZERO_SPEED;
+      return;
+    }
+
+  period_usec = obj->periodScale / freq_pu;
+
+  if(period_usec > ((uint64_t)0x1FF << 7))
+    {
+      obj->erpmValue = DSHOT_REPLY_ZERO_SPEED;
+      return;
+    }
+
+  while(period_usec > 0x1FF)
+    {
+      period_usec >>= 1;
+      shift++;
+    }
+
+  obj->erpmValue = (uint16_t)((shift << 9) | (uint16_t)period_usec);
+
+  return;
+} // end of DSHOT_setSpeed() function
+
+// end of file
@@ -0,0 +1,553 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _DSHOT_H_
+#define _DSHOT_H_
+
+//! \file   modules/dshot/src/32b/dshot.h
+//! \brief  Contains the public interface to the
+//!         DShot digital throttle decoder (DSHOT) module routines
+//!
+//!         A DShot frame is 16 bits sent MSB first: an 11-bit value, the
+//!         telemetry request bit and a 4-bit CRC, the XOR of the three
+//!         nibbles of the first 12 bits.  Every bit starts with a rising
+//!         edge, a one is high for 3/4 and a zero for 3/8 of the bit period.
+//!         Values 1 to 47 are commands, 48 to 2047 the throttle and 0 stops
+//!         the motor.
+//!
+//!         The decoder takes the rising and falling edge time stamps of each
+//!         pulse, for example from the eCAP capture registers.  The bits are
+//!         classified by the ratio of the high time to the bit period
+//!         measured over the frame, so DShot150, 300, 600 and 1200 are
+//!         decoded without configuration and the capture clock only sets the
+//!         accepted bit period range.  A gap of more than 1.5 bit periods
+//!         ends a frame.
+//!
+//!         The failsafe state machine arms after a number of consecutive
+//!         motor stop frames and disarms when no valid frame arrives within
+//!         the timeout, counted by DSHOT_runTimeout() in the control ISR.
+//!         After a signal loss the throttle stays zero until the decoder is
+//!         armed again.
+//!
+//!         Bidirectional DShot inverts the signal, the line idles high and
+//!         the bits are low pulses, and inverts the CRC.  After every frame
+//!         the ESC answers on the same line with a 21-bit reply at 5/4 of
+//!         the bit rate, DSHOT_REPLY_DELAY_usec after the frame: a start
+//!         transition and the 16-bit reply, GCR coded to 20 bits, where a
+//!         one is a level change.  The reply is the electrical period in
+//!         microseconds as a 3-bit shift and a 9-bit mantissa, or an extended
+//!         telemetry value once the flight controller enabled it, with the
+//!         inverted CRC.  Every valid frame is answered.  The reply is
+//!         given as the periods of an active low PWM, a low and a high run
+//!         of the line each, so a PWM output with shadowed period and
+//!         compare registers sends it with one interrupt per period and no
+//!         busy wait, see DSHOT_getReplyPwm().
+//!
+//!         DSHOT_runPulse() has no loop and no division except at the end of
+//!         a frame, where it loops once over the 16 bits.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+// modules
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+
+
+//!
+//!
+//! \defgroup DSHOT DSHOT
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the number of bits of a frame
+//!
+#define DSHOT_NUM_BITS                (16)
+
+//! \brief Defines the lowest throttle value, lower values are commands
+//!
+#define DSHOT_MIN_THROTTLE            (48)
+
+//! \brief Defines the highest throttle value
+//!
+#define DSHOT_MAX_THROTTLE            (2047)
+
+//! \brief Defines the accepted bit periods, ns
+//! \details From DShot1200 (833 ns) to DShot150 (6667 ns) with margin
+//!
+#define DSHOT_MIN_BIT_PERIOD_ns       (600)
+#define DSHOT_MAX_BIT_PERIOD_ns       (8500)
+
+//! \brief Defines the number of times a settings command is repeated
+//!        before it takes effect
+//!
+#define DSHOT_CMD_NUM_REPEATS         (6)
+
+//! \brief Defines the throttle scale, per unit per throttle step
+//! \details Rounded up so the full throttle saturates at 1.0
+//!
+#define DSHOT_THROTTLE_SCALE          ((_IQ(1.0) / (DSHOT_MAX_THROTTLE - DSHOT_MIN_THROTTLE)) + 1)
+
+//! \brief Defines the number of bits of a bidirectional DShot reply
+//!
+#define DSHOT_REPLY_NUM_BITS          (21)
+
+//! \brief Defines the time from the end of the frame to the reply, usec
+//!
+#define DSHOT_REPLY_DELAY_usec        (30)
+
+//! \brief Defines the reply value for no rotation
+//!
+#define DSHOT_REPLY_ZERO_SPEED        (0x0FFF)
+
+//! \brief Defines the return value of DSHOT_decodeReply() for an invalid reply
+//!
+#define DSHOT_REPLY_INVALID           (0xFFFF)
+
+//! \brief Defines the number of replies per extended telemetry frame
+//!
+#define DSHOT_EDT_PERIOD              (8)
+
+//! \brief Defines the number of extended telemetry types sent
+//!
+#define DSHOT_EDT_NUM_TYPES           (3)
+
+//! \brief Defines an extended telemetry value that is not sent
+//!
+#define DSHOT_EDT_NO_VALUE            (-1)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Enumeration for the decoder states
+//!
+typedef enum
+{
+  DSHOT_State_NoSignal=0,       //!< no valid frame received yet
+  DSHOT_State_Disarmed,         //!< valid frames, waiting for the motor stop frames
+  DSHOT_State_Armed,            //!< the throttle is passed on
+  DSHOT_State_Failsafe          //!< the signal was lost while armed
+} DSHOT_State_e;
+
+
+//! \brief Enumeration for the DShot commands
+//!
+typedef enum
+{
+  DSHOT_Cmd_MotorStop=0,        //!< stop the motor
+  DSHOT_Cmd_Beep1=1,            //!< beep, tone 1
+  DSHOT_Cmd_Beep2=2,            //!< beep, tone 2
+  DSHOT_Cmd_Beep3=3,            //!< beep, tone 3
+  DSHOT_Cmd_Beep4=4,            //!< beep, tone 4
+  DSHOT_Cmd_Beep5=5,            //!< beep, tone 5
+  DSHOT_Cmd_EscInfo=6,          //!< send the ESC information
+  DSHOT_Cmd_SpinDirection1=7,   //!< set the normal direction
+  DSHOT_Cmd_SpinDirection2=8,   //!< set the reversed direction
+  DSHOT_Cmd_SaveSettings=12,    //!< save the settings
+  DSHOT_Cmd_EdtEnable=13,       //!< enable the extended telemetry
+  DSHOT_Cmd_EdtDisable=14,      //!< disable the extended telemetry
+  DSHOT_Cmd_SpinDirectionNormal=20,    //!< normal direction, not saved
+  DSHOT_Cmd_SpinDirectionReversed=21,  //!< reversed direction, not saved
+  DSHOT_Cmd_None=0xFF           //!< no command pending
+} DSHOT_Cmd_e;
+
+
+//! \brief Enumeration for the extended telemetry types, the order they are sent
+//!
+typedef enum
+{
+  DSHOT_Edt_Temperature=0,      //!< the temperature, degC
+  DSHOT_Edt_Voltage,            //!< the supply voltage, 0.25 V
+  DSHOT_Edt_Current             //!< the current, A
+} DSHOT_Edt_e;
+
+
+//! \brief Defines the DShot decoder (DSHOT) object
+//!
+typedef struct _DSHOT_Obj_
+{
+  uint32_t        cntsPerUsec;          //!< the time stamp counts per microsecond
+  uint32_t        minBitPeriod_cnts;    //!< the shortest accepted bit period, cnts
+  uint32_t        maxBitPeriod_cnts;    //!< the longest accepted bit period, cnts
+
+  uint32_t        startCnt_z1;          //!< the start time stamp of the previous pulse, cnts
+  uint32_t        firstStartCnt;        //!< the start time stamp of the first bit, cnts
+  uint32_t        bitPeriod_cnts;       //!< the period of the first bit of the frame, cnts
+  uint32_t        highCnt[DSHOT_NUM_BITS];  //!< the high times of the bits, cnts
+  uint_least8_t   numBits;              //!< the number of bits received of the frame
+
+  uint16_t        value;                //!< the 11-bit value of the last valid frame
+  bool            flag_telemRequest;    //!< the telemetry request bit of the last valid frame
+  _iq             throttle;             //!< the throttle, pu, zero unless armed
+
+  DSHOT_State_e   state;                //!< the decoder state
+  uint_least16_t  armNumFrames;         //!< the number of motor stop frames to arm
+  uint_least16_t  armCnt;               //!< the number of consecutive motor stop frames
+  uint_least16_t  timeout_ticks;        //!< the timeout, DSHOT_runTimeout() calls
+  uint_least16_t  timeoutCnt;           //!< the DSHOT_runTimeout() calls since the last valid frame
+
+  uint16_t        cmd_z1;               //!< the command of the previous frame
+  uint_least8_t   cmdRepeatCnt;         //!< the number of consecutive frames with the same command
+  DSHOT_Cmd_e     cmd;                  //!< the pending command for the application
+  bool            flag_reversed;        //!< denotes that the reversed direction was set
+
+  bool            flag_bidir;           //!< denotes bidirectional DShot
+  uint64_t        periodScale;          //!< the electrical period times the frequency, usec * 2^GLOBAL_Q pu
+  uint16_t        erpmValue;            //!< the encoded electrical period of the reply
+  bool            flag_edt;             //!< denotes that the extended telemetry is enabled
+  uint_least8_t   edtCnt;               //!< the replies since the last extended telemetry frame
+  uint_least8_t   edtIndex;             //!< the type of the last extended telemetry frame
+  int16_t         edtValue[DSHOT_EDT_NUM_TYPES];  //!< the extended telemetry values, DSHOT_EDT_NO_VALUE for none
+  uint32_t        replyDelay_cnts;      //!< the time from the end of the frame to the reply, cnts
+
+  bool            flag_replyPending;    //!< denotes that a reply is ready to send
+  uint32_t        replyTransitions;     //!< the reply, a one bit is a level change, MSB first
+  uint_least8_t   replyNumBits;         //!< the bits of the reply not yet given as PWM periods
+  bool            flag_replyIdle;       //!< denotes that the idle period after the reply is not yet given
+  uint32_t        replyCnt;             //!< the time stamp of the reply start, then of the end of the periods given, cnts
+  uint32_t        replyBitPeriod_cnts;  //!< the bit period of the reply, cnts
+  uint32_t        numReplies;           //!< the number of replies sent
+
+  uint32_t        numFrames;            //!< the number of valid frames
+  uint32_t        numCrcErrors;         //!< the number of frames with a CRC error
+  uint32_t        numFrameErrors;       //!< the number of frames with a timing error
+} DSHOT_Obj;
+
+
+//! \brief Defines the DSHOT handle
+//!
+typedef struct _DSHOT_Obj_ *DSHOT_Handle;
+
+
+// **************************************************************************
+// the globals
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Initializes the DShot decoder (DSHOT) object
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The DShot decoder (DSHOT) object handle
+extern DSHOT_Handle DSHOT_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Decodes a bidirectional DShot reply, as the flight controller does
+//! \param[in] transitions  The 21 reply bits, a one is a level change, MSB first
+//! \return    The 12-bit value, DSHOT_REPLY_INVALID for a GCR or CRC error
+extern uint16_t DSHOT_decodeReply(const uint32_t transitions);
+
+
+//! \brief     Clears the pending command
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+static inline void DSHOT_clearCmd(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  obj->cmd = DSHOT_Cmd_None;
+
+  return;
+} // end of DSHOT_clearCmd() function
+
+
+//! \brief     Gets the pending command
+//! \details   Beeps are pending after one frame, the direction and save
+//!            commands after DSHOT_CMD_NUM_REPEATS frames
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+//! \return    The command, DSHOT_Cmd_None for none
+static inline DSHOT_Cmd_e DSHOT_getCmd(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  return(obj->cmd);
+} // end of DSHOT_getCmd() function
+
+
+//! \brief     Gets the number of replies sent
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+//! \return    The number of replies
+static inline uint32_t DSHOT_getNumReplies(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  return(obj->numReplies);
+} // end of DSHOT_getNumReplies() function
+
+
+//! \brief     Gets the reply to send
+//! \details   Call from the capture interrupt after DSHOT_runPulse(), the
+//!            reply is given once, then its periods with DSHOT_getReplyPwm()
+//! \param[in] handle      The DShot decoder (DSHOT) handle
+//! \param[out] pStartCnt  The time stamp to start the reply, cnts
+//! \return    true when a reply is to be sent
+static inline bool DSHOT_getReply(DSHOT_Handle handle,uint32_t *pStartCnt)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  if(!obj->flag_replyPending)
+    {
+      return(false);
+    }
+
+  obj->flag_replyPending = false;
+  obj->replyNumBits = DSHOT_REPLY_NUM_BITS;
+  obj->flag_replyIdle = true;
+  obj->numReplies++;
+
+  *pStartCnt = obj->replyCnt;
+
+  return(true);
+} // end of DSHOT_getReply() function
+
+
+//! \brief     Gets the time stamp of the end of the reply
+//! \details   Valid once DSHOT_getReplyPwm() returned false, the idle
+//!            period starts at it
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+//! \return    The time stamp, cnts
+static inline uint32_t DSHOT_getReplyEndCnt(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  return(obj->replyCnt);
+} // end of DSHOT_getReplyEndCnt() function
+
+
+//! \brief     Gets the next period of the reply as an active low PWM
+//! \details   The line is low for the first part of every period and high
+//!            for the rest, the first period starts at the time stamp of
+//!            DSHOT_getReply().  After the last period a period of the
+//!            reply length without low time follows, the line stays high,
+//!            then false is returned.
+//!            Call at the start of every period for the period after it.
+//! \param[in] handle          The DShot decoder (DSHOT) handle
+//! \param[out] pPeriod_cnts   The period, cnts
+//! \param[out] pLow_cnts      The low time, cnts
+//! \return    false when the idle period was given
+extern bool DSHOT_getReplyPwm(DSHOT_Handle handle,uint32_t *pPeriod_cnts,uint32_t *pLow_cnts);
+
+
+//! \brief     Gets the reversed direction flag
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+//! \return    The reversed direction flag
+static inline bool DSHOT_getFlag_reversed(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  return(obj->flag_reversed);
+} // end of DSHOT_getFlag_reversed() function
+
+
+//! \brief     Gets the telemetry request bit of the last valid frame
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+//! \return    The telemetry request flag
+static inline bool DSHOT_getFlag_telemRequest(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  return(obj->flag_telemRequest);
+} // end of DSHOT_getFlag_telemRequest() function
+
+
+//! \brief     Gets the number of frames with a CRC error
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+//! \return    The number of frames
+static inline uint32_t DSHOT_getNumCrcErrors(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  return(obj->numCrcErrors);
+} // end of DSHOT_getNumCrcErrors() function
+
+
+//! \brief     Gets the number of frames with a timing error
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+//! \return    The number of frames
+static inline uint32_t DSHOT_getNumFrameErrors(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  return(obj->numFrameErrors);
+} // end of DSHOT_getNumFrameErrors() function
+
+
+//! \brief     Gets the number of valid frames
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+//! \return    The number of frames
+static inline uint32_t DSHOT_getNumFrames(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  return(obj->numFrames);
+} // end of DSHOT_getNumFrames() function
+
+
+//! \brief     Gets the decoder state
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+//! \return    The decoder state
+static inline DSHOT_State_e DSHOT_getState(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  return(obj->state);
+} // end of DSHOT_getState() function
+
+
+//! \brief     Gets the throttle
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+//! \return    The throttle, 0 to 1.0 pu, zero unless armed
+static inline _iq DSHOT_getThrottle(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  return(obj->throttle);
+} // end of DSHOT_getThrottle() function
+
+
+//! \brief     Gets the 11-bit value of the last valid frame
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+//! \return    The value
+static inline uint16_t DSHOT_getValue(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  return(obj->value);
+} // end of DSHOT_getValue() function
+
+
+//! \brief     Decodes one pulse of the DShot signal
+//! \details   Call for every pulse in order, from the capture interrupt.
+//!            The time stamps come from a free running up counter.  The
+//!            pulse starts with the rising edge, or the falling edge for
+//!            bidirectional DShot.
+//! \param[in] handle    The DShot decoder (DSHOT) handle
+//! \param[in] startCnt  The time stamp of the edge starting the pulse, cnts
+//! \param[in] endCnt    The time stamp of the edge ending the pulse, cnts
+extern void DSHOT_runPulse(DSHOT_Handle handle,const uint32_t startCnt,const uint32_t endCnt);
+
+
+//! \brief     Counts the time since the last valid frame
+//! \details   Call at a fixed rate, for example from the control ISR
+//! \param[in] handle  The DShot decoder (DSHOT) handle
+//! \return    true when the signal was just lost while armed
+static inline bool DSHOT_runTimeout(DSHOT_Handle handle)
+{
+  DSHOT_Obj *obj = (DSHOT_Obj *)handle;
+
+  if((obj->state == DSHOT_State_NoSignal) || (obj->state == DSHOT_State_Failsafe))
+    {
+      return(false);
+    }
+
+  if(++obj->timeoutCnt < obj->timeout_ticks)
+    {
+      return(false);
+    }
+
+  obj->throttle = _IQ(0.0);
+  obj->armCnt = 0;
+
+  if(obj->state == DSHOT_State_Armed)
+    {
+      obj->state = DSHOT_State_Failsafe;
+
+      return(true);
+    }
+
+  obj->state = DSHOT_State_NoSignal;
+
+  return(false);
+} // end of DSHOT_runTimeout() function
+
+
+//! \brief     Sets the bidirectional DShot parameters
+//! \details   Call after DSHOT_setParams()
+//! \param[in] handle            The DShot decoder (DSHOT) handle
+//! \param[in] flag_bidir        true for bidirectional DShot
+//! \param[in] fullScaleFreq_Hz  The frequency of 1.0 pu of DSHOT_setSpeed(), Hz
+extern void DSHOT_setBidirParams(DSHOT_Handle handle,
+                                 const bool flag_bidir,
+                                 const uint32_t fullScaleFreq_Hz);
+
+
+//! \brief     Sets the extended telemetry values
+//! \details   Call from the background loop, DSHOT_EDT_NO_VALUE for a
+//!            value that is not measured
+//! \param[in] handle         The DShot decoder (DSHOT) handle
+//! \param[in] temperature_C  The temperature, 0 to 255 degC
+//! \param[in] voltage_qV     The supply voltage, 0 to 255 in 0.25 V
+//! \param[in] current_A      The current, 0 to 255 A
+extern void DSHOT_setEdtValues(DSHOT_Handle handle,
+                               const int16_t temperature_C,
+                               const int16_t voltage_qV,
+                               const int16_t current_A);
+
+
+//! \brief     Sets the decoder parameters
+//! \details   Disarms the decoder
+//! \param[in] handle         The DShot decoder (DSHOT) handle
+//! \param[in] clockFreq_Hz   The frequency of the time stamp counter, Hz
+//! \param[in] timeout_ticks  The number of DSHOT_runTimeout() calls without a
+//!                           valid frame before the signal is lost
+//! \param[in] armNumFrames   The number of consecutive motor stop frames to arm
+extern void DSHOT_setParams(DSHOT_Handle handle,
+                            const uint32_t clockFreq_Hz,
+                            const uint_least16_t timeout_ticks,
+                            const uint_least16_t armNumFrames);
+
+
+//! \brief     Sets the electrical speed sent in the replies
+//! \details   Call from the background loop, uses a 64-bit division
+//! \param[in] handle       The DShot decoder (DSHOT) handle
+//! \param[in] elecFreq_pu  The electrical frequency, pu, either sign
+extern void DSHOT_setSpeed(DSHOT_Handle handle,const _iq elecFreq_pu);
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+#endif // end of _DSHOT_H_ definition
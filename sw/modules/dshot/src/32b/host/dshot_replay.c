@@ -0,0 +1,588 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/dshot/src/32b/host/dshot_replay.c
+//! \brief  Runs the DShot decoder (DSHOT) on a recorded edge trace
+//!
+//!         The trace is a text file with one edge per line, the time in
+//!         seconds and the level after the edge, separated by a comma or
+//!         white space, as exported by most logic analyzers.  Lines that do
+//!         not start with a number are skipped.  The time stamps are
+//!         quantized to the capture clock (-c) and every pulse is passed to
+//!         DSHOT_runPulse() as the eCAP interrupt does.
+//!
+//!         With -g a synthetic trace is written instead: motor stop frames
+//!         to arm, beeps, the reversed direction command, a throttle ramp
+//!         and, with -e, edge jitter and corrupted frames.
+//!
+//!         With -B the trace is bidirectional DShot.  The generator runs a
+//!         second decoder as the ESC, with a speed ramp and extended
+//!         telemetry, and writes its GCR replies after the frames.  The
+//!         replay takes the edges after every valid frame as the reply,
+//!         samples them at the reply bit period and decodes them with
+//!         DSHOT_decodeReply().
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sw/modules/dshot/src/32b/dshot.h"
+
+
+// **************************************************************************
+// the defines
+
+#define DSHOT_REPLAY_DEFAULT_CLOCK_Hz   (60000000.0)
+#define DSHOT_REPLAY_FRAME_RATE_Hz      (4000.0)
+#define DSHOT_REPLAY_TIMEOUT_ticks      (100)       // frame periods to the signal loss
+#define DSHOT_REPLAY_ARM_NUM_FRAMES     (50)
+#define DSHOT_REPLAY_GAP_sec            (0.03)      // the gap in the generated trace
+#define DSHOT_REPLAY_FULL_SCALE_FREQ_Hz (1000)      // the electrical frequency of the ESC at 1.0 pu
+#define DSHOT_REPLAY_REPLY_WAIT_usec    (60.0)      // the time from the frame to the latest reply start
+
+
+// **************************************************************************
+// the globals
+
+static const char *DSHOT_REPLAY_stateNames[] = {"NoSignal","Disarmed","Armed","Failsafe"};
+
+static const char *DSHOT_REPLAY_edtNames[] = {"","","temperature","","voltage","","current"};
+
+static uint32_t DSHOT_REPLAY_seed = 12345;
+
+
+// **************************************************************************
+// the functions
+
+static void DSHOT_REPLAY_usage(const char *pName)
+{
+  fprintf(stderr,"usage: %s [-c Hz] [-q] [-B] <trace>\n",pName);
+  fprintf(stderr,"       %s -g kbps [-n frames] [-e] [-B]\n",pName);
+  fprintf(stderr,"  <trace>  edge trace, time in seconds and level per line, - for the standard input\n");
+  fprintf(stderr,"  -c       capture clock, default %.0f Hz\n",DSHOT_REPLAY_DEFAULT_CLOCK_Hz);
+  fprintf(stderr,"  -q       print the summary only\n");
+  fprintf(stderr,"  -g       write a synthetic trace at this bit rate to the standard output\n");
+  fprintf(stderr,"  -n       number of throttle frames of the synthetic trace, default 2000\n");
+  fprintf(stderr,"  -e       add edge jitter and corrupt every 97th frame of the synthetic trace\n");
+  fprintf(stderr,"  -B       bidirectional DShot, inverted frames and eRPM replies\n");
+
+  return;
+} // end of DSHOT_REPLAY_usage() function
+
+
+//! \brief  Returns a pseudo random number from -1.0 to 1.0
+static double DSHOT_REPLAY_rand(void)
+{
+  DSHOT_REPLAY_seed = (DSHOT_REPLAY_seed * 1103515245) + 12345;
+
+  return((double)((DSHOT_REPLAY_seed >> 8) & 0xFFFF) / 32768.0 - 1.0);
+} // end of DSHOT_REPLAY_rand() function
+
+
+//! \brief  Writes the edges of the reply of the ESC decoder, if any
+//! \details The reply is taken as the PWM periods the ESC sends, the line
+//!          falls at the start of every period and rises after the low time
+static void DSHOT_REPLAY_writeReply(DSHOT_Handle escHandle,const double clockFreq_Hz,const bool flag_jitter)
+{
+  uint32_t startCnt,period_cnts,low_cnts;
+  double time_sec;
+
+  if(!DSHOT_getReply(escHandle,&startCnt))
+    {
+      return;
+    }
+
+  time_sec = (double)startCnt / clockFreq_Hz;
+
+  while(DSHOT_getReplyPwm(escHandle,&period_cnts,&low_cnts))
+    {
+      if(low_cnts > 0)
+        {
+          double period_sec = (double)period_cnts / clockFreq_Hz;
+          double fallJitter_sec = flag_jitter ? (0.01 * period_sec * DSHOT_REPLAY_rand()) : 0.0;
+          double riseJitter_sec = flag_jitter ? (0.01 * period_sec * DSHOT_REPLAY_rand()) : 0.0;
+
+          printf("%.9f,0\n",time_sec + fallJitter_sec);
+          printf("%.9f,1\n",time_sec + ((double)low_cnts / clockFreq_Hz) + riseJitter_sec);
+        }
+
+      time_sec += (double)period_cnts / clockFreq_Hz;
+    }
+
+  return;
+} // end of DSHOT_REPLAY_writeReply() function
+
+
+//! \brief  Writes the edges of one frame
+//! \details With an ESC decoder the frame is inverted and followed by the reply
+//! \return The time after the frame, sec
+static double DSHOT_REPLAY_writeFrame(double time_sec,const double bitPeriod_sec,
+                                      const uint16_t value,const bool flag_telem,
+                                      const bool flag_jitter,const bool flag_corrupt,
+                                      DSHOT_Handle escHandle,const double clockFreq_Hz)
+{
+  uint16_t frame = (uint16_t)((value << 5) | (flag_telem ? 0x10 : 0));
+  int startLevel = (escHandle != NULL) ? 0 : 1;
+  int bitNumber;
+
+  frame |= (frame >> 4 ^ frame >> 8 ^ frame >> 12 ^ ((escHandle != NULL) ? 0xF : 0)) & 0xF;
+
+  if(flag_corrupt)
+    {
+      frame ^= 0x0400;
+    }
+
+  for(bitNumber=0;bitNumber<16;bitNumber++)
+    {
+      double high_sec = ((frame << bitNumber) & 0x8000) ? (0.75 * bitPeriod_sec) : (0.375 * bitPeriod_sec);
+      double jitter_sec = flag_jitter ? (0.03 * bitPeriod_sec * DSHOT_REPLAY_rand()) : 0.0;
+
+      printf("%.9f,%d\n",time_sec + jitter_sec,startLevel);
+      printf("%.9f,%d\n",time_sec + high_sec,1 - startLevel);
+
+      if(escHandle != NULL)
+        {
+          DSHOT_runPulse(escHandle,
+                         (uint32_t)(int64_t)((time_sec + jitter_sec) * clockFreq_Hz + 0.5),
+                         (uint32_t)(int64_t)((time_sec + high_sec) * clockFreq_Hz + 0.5));
+        }
+
+      time_sec += bitPeriod_sec;
+    }
+
+  if(escHandle != NULL)
+    {
+      DSHOT_REPLAY_writeReply(escHandle,clockFreq_Hz,flag_jitter);
+    }
+
+  return(time_sec);
+} // end of DSHOT_REPLAY_writeFrame() function
+
+
+//! \brief  Writes the synthetic trace
+//! \details For bidirectional DShot the ESC enables the extended telemetry
+//!          after the beep and its speed follows the throttle ramp
+static void DSHOT_REPLAY_generate(const double bitRate_bps,const int numFrames,const bool flag_errors,
+                                  const bool flag_bidir,const double clockFreq_Hz)
+{
+  static DSHOT_Obj esc;
+  DSHOT_Handle escHandle = NULL;
+  double bitPeriod_sec = 1.0 / bitRate_bps;
+  double framePeriod_sec = 1.0 / DSHOT_REPLAY_FRAME_RATE_Hz;
+  double time_sec = 0.001;
+  int frameNumber;
+
+  if(flag_bidir)
+    {
+      escHandle = DSHOT_init(&esc,sizeof(esc));
+      DSHOT_setParams(escHandle,(uint32_t)clockFreq_Hz,DSHOT_REPLAY_TIMEOUT_ticks,DSHOT_REPLAY_ARM_NUM_FRAMES);
+      DSHOT_setBidirParams(escHandle,true,DSHOT_REPLAY_FULL_SCALE_FREQ_Hz);
+      DSHOT_setEdtValues(escHandle,35,50,0);
+    }
+
+  printf("Time [s],DShot\n");
+
+  // motor stop to arm, a beep and the reversed direction
+  for(frameNumber=0;frameNumber<(DSHOT_REPLAY_ARM_NUM_FRAMES + 20);frameNumber++)
+    {
+      uint16_t value = 0;
+
+      if(frameNumber == DSHOT_REPLAY_ARM_NUM_FRAMES)
+        {
+          value = DSHOT_Cmd_Beep1;
+        }
+      else if(flag_bidir && (frameNumber > DSHOT_REPLAY_ARM_NUM_FRAMES) &&
+              (frameNumber <= (DSHOT_REPLAY_ARM_NUM_FRAMES + 7)))
+        {
+          value = DSHOT_Cmd_EdtEnable;
+        }
+      else if(frameNumber > (DSHOT_REPLAY_ARM_NUM_FRAMES + 5))
+        {
+          value = DSHOT_Cmd_SpinDirectionReversed;
+        }
+
+      DSHOT_REPLAY_writeFrame(time_sec,bitPeriod_sec,value,false,flag_errors,false,escHandle,clockFreq_Hz);
+      time_sec += framePeriod_sec;
+    }
+
+  // the throttle ramp, a telemetry request every 10th frame
+  for(frameNumber=0;frameNumber<numFrames;frameNumber++)
+    {
+      uint16_t value = (uint16_t)(DSHOT_MIN_THROTTLE +
+                       ((DSHOT_MAX_THROTTLE - DSHOT_MIN_THROTTLE) * frameNumber) / (numFrames > 1 ? numFrames - 1 : 1));
+      bool flag_corrupt = flag_errors && ((frameNumber % 97) == 96);
+
+      if(escHandle != NULL)
+        {
+          _iq speed_pu = _IQ((double)(value - DSHOT_MIN_THROTTLE) / (DSHOT_MAX_THROTTLE - DSHOT_MIN_THROTTLE));
+
+          DSHOT_setSpeed(escHandle,speed_pu);
+          DSHOT_setEdtValues(escHandle,35,50,(int16_t)((30 * frameNumber) / numFrames));
+        }
+
+      DSHOT_REPLAY_writeFrame(time_sec,bitPeriod_sec,value,(frameNumber % 10) == 0,flag_errors,flag_corrupt,
+                              escHandle,clockFreq_Hz);
+      time_sec += framePeriod_sec;
+    }
+
+  // the signal is lost, then the last frames do not arm again
+  time_sec += DSHOT_REPLAY_GAP_sec;
+
+  for(frameNumber=0;frameNumber<10;frameNumber++)
+    {
+      DSHOT_REPLAY_writeFrame(time_sec,bitPeriod_sec,1000,false,flag_errors,false,escHandle,clockFreq_Hz);
+      time_sec += framePeriod_sec;
+    }
+
+  return;
+} // end of DSHOT_REPLAY_generate() function
+
+
+//! \brief  Defines the reply decoder of the replay
+typedef struct _DSHOT_REPLAY_Reply_
+{
+  bool           flag_wait;        //!< a valid frame was decoded, the reply may start
+  bool           flag_active;      //!< the reply start transition was seen
+  double         wait_sec;         //!< the latest reply start, sec
+  double         start_sec;        //!< the time of the start transition, sec
+  double         bitPeriod_sec;    //!< the reply bit period, sec
+  uint32_t       transitions;      //!< the transitions sampled so far
+  uint32_t       numReplies;       //!< the number of decoded replies
+  uint32_t       numErrors;        //!< the number of replies with a GCR or CRC error
+  uint32_t       numEdt;           //!< the number of extended telemetry replies
+  uint32_t       period_usec;      //!< the last electrical period, usec, zero at zero speed
+} DSHOT_REPLAY_Reply;
+
+
+//! \brief  Decodes the sampled reply
+static void DSHOT_REPLAY_finishReply(DSHOT_REPLAY_Reply *pReply,const bool flag_quiet)
+{
+  uint16_t value = DSHOT_decodeReply(pReply->transitions);
+
+  pReply->flag_active = false;
+
+  if(value == DSHOT_REPLY_INVALID)
+    {
+      pReply->numErrors++;
+
+      if(!flag_quiet)
+        {
+          printf("# reply error 0x%06lx at %.1f usec\n",(unsigned long)pReply->transitions,pReply->start_sec * 1.0e6);
+        }
+
+      return;
+    }
+
+  pReply->numReplies++;
+
+  // an even type with a zero mantissa MSB is extended telemetry, else eRPM
+  if(((value & 0x100) == 0) && ((value >> 8) != 0) && ((value >> 8) <= 6))
+    {
+      pReply->numEdt++;
+
+      if(!flag_quiet)
+        {
+          printf("# edt %s %u at %.1f usec\n",DSHOT_REPLAY_edtNames[value >> 8],(unsigned)(value & 0xFF),
+                 pReply->start_sec * 1.0e6);
+        }
+
+      return;
+    }
+
+  pReply->period_usec = (value == DSHOT_REPLY_ZERO_SPEED) ? 0 : ((uint32_t)(value & 0x1FF) << (value >> 9));
+
+  if(!flag_quiet && (pReply->period_usec > 0))
+    {
+      printf("# erpm %.0f at %.1f usec\n",60.0e6 / (double)pReply->period_usec,pReply->start_sec * 1.0e6);
+    }
+
+  return;
+} // end of DSHOT_REPLAY_finishReply() function
+
+
+int main(int argc,char *argv[])
+{
+  static DSHOT_Obj dshot;
+  DSHOT_Handle dshotHandle;
+  double clockFreq_Hz = DSHOT_REPLAY_DEFAULT_CLOCK_Hz;
+  double generateRate_kbps = 0.0;
+  int numGenerateFrames = 2000;
+  bool flag_errors = false;
+  bool flag_quiet = false;
+  bool flag_bidir = false;
+  DSHOT_REPLAY_Reply reply;
+  double pulseStart_sec[DSHOT_NUM_BITS];
+  uint32_t numPulses = 0;
+  char line[256];
+  FILE *pFile;
+  uint32_t riseCnt = 0;
+  bool flag_high = false;
+  bool flag_first = true;
+  double time_sec = 0.0;
+  double tickTime_sec = 0.0;
+  double tickPeriod_sec = 1.0 / DSHOT_REPLAY_FRAME_RATE_Hz;
+  uint32_t numFrames_z1 = 0;
+  uint16_t value_z1 = 0xFFFF;
+  DSHOT_State_e state_z1 = DSHOT_State_NoSignal;
+  uint32_t numEdges = 0;
+  int opt;
+
+  while((opt = getopt(argc,argv,"c:qg:n:eBh")) != -1)
+    {
+      switch(opt)
+        {
+          case 'c':
+            clockFreq_Hz = atof(optarg);
+            break;
+          case 'q':
+            flag_quiet = true;
+            break;
+          case 'g':
+            generateRate_kbps = atof(optarg);
+            break;
+          case 'n':
+            numGenerateFrames = atoi(optarg);
+            break;
+          case 'e':
+            flag_errors = true;
+            break;
+          case 'B':
+            flag_bidir = true;
+            break;
+          default:
+            DSHOT_REPLAY_usage(argv[0]);
+            return(EXIT_FAILURE);
+        }
+    }
+
+  if(generateRate_kbps > 0.0)
+    {
+      DSHOT_REPLAY_generate(generateRate_kbps * 1000.0,numGenerateFrames,flag_errors,flag_bidir,clockFreq_Hz);
+      return(EXIT_SUCCESS);
+    }
+
+  if(((argc - optind) != 1) || (clockFreq_Hz < 1.0e6))
+    {
+      DSHOT_REPLAY_usage(argv[0]);
+      return(EXIT_FAILURE);
+    }
+
+  pFile = (strcmp(argv[optind],"-") == 0) ? stdin : fopen(argv[optind],"r");
+
+  if(pFile == NULL)
+    {
+      perror(argv[optind]);
+      return(EXIT_FAILURE);
+    }
+
+  // the timeout counts the frame periods of the generated trace
+  dshotHandle = DSHOT_init(&dshot,sizeof(dshot));
+  DSHOT_setParams(dshotHandle,(uint32_t)clockFreq_Hz,DSHOT_REPLAY_TIMEOUT_ticks,DSHOT_REPLAY_ARM_NUM_FRAMES);
+  DSHOT_setBidirParams(dshotHandle,flag_bidir,DSHOT_REPLAY_FULL_SCALE_FREQ_Hz);
+
+  memset(&reply,0,sizeof(reply));
+
+  if(!flag_quiet)
+    {
+      printf("time_usec,value,telem,state,throttle\n");
+    }
+
+  while(fgets(line,sizeof(line),pFile) != NULL)
+    {
+      char *pEnd;
+      double level;
+      uint32_t edgeCnt;
+      bool flag_frame = false;
+
+      time_sec = strtod(line,&pEnd);
+
+      if((pEnd == line) || !(isdigit((unsigned char)line[0]) || (line[0] == '.') || (line[0] == '-')))
+        {
+          continue;
+        }
+
+      while((*pEnd == ',') || isspace((unsigned char)*pEnd))
+        {
+          pEnd++;
+        }
+
+      level = strtod(pEnd,NULL);
+      edgeCnt = (uint32_t)(int64_t)(time_sec * clockFreq_Hz + 0.5);
+      numEdges++;
+
+      // the edges after a valid frame are the reply, sampled at the middle of the bits
+      if(reply.flag_active && (time_sec >= reply.start_sec + (DSHOT_REPLY_NUM_BITS + 0.5) * reply.bitPeriod_sec))
+        {
+          DSHOT_REPLAY_finishReply(&reply,flag_quiet);
+        }
+
+      if(reply.flag_active)
+        {
+          int bitNumber = (int)((time_sec - reply.start_sec) / reply.bitPeriod_sec + 0.5);
+
+          if(bitNumber < DSHOT_REPLY_NUM_BITS)
+            {
+              reply.transitions |= (uint32_t)1 << (DSHOT_REPLY_NUM_BITS - 1 - bitNumber);
+            }
+
+          continue;
+        }
+
+      if(reply.flag_wait && (time_sec > reply.wait_sec))
+        {
+          reply.flag_wait = false;
+        }
+
+      if(reply.flag_wait && (level < 0.5))
+        {
+          reply.flag_wait = false;
+          reply.flag_active = true;
+          reply.start_sec = time_sec;
+          reply.transitions = (uint32_t)1 << (DSHOT_REPLY_NUM_BITS - 1);
+          continue;
+        }
+
+      // the timeout runs at the frame rate as DSHOT_runTimeout() in the ISR
+      if(flag_first)
+        {
+          tickTime_sec = time_sec;
+          flag_first = false;
+        }
+
+      while(time_sec >= tickTime_sec)
+        {
+          DSHOT_runTimeout(dshotHandle);
+          tickTime_sec += tickPeriod_sec;
+        }
+
+      // a pulse starts with the rising edge, with the falling edge for bidirectional DShot
+      if((level > 0.5) != flag_bidir)
+        {
+          riseCnt = edgeCnt;
+          flag_high = true;
+          pulseStart_sec[numPulses++ % DSHOT_NUM_BITS] = time_sec;
+        }
+      else if(flag_high)
+        {
+          flag_high = false;
+
+          DSHOT_runPulse(dshotHandle,riseCnt,edgeCnt);
+
+          if(DSHOT_getCmd(dshotHandle) != DSHOT_Cmd_None)
+            {
+              if(!flag_quiet)
+                {
+                  printf("# command %d at %.1f usec\n",(int)DSHOT_getCmd(dshotHandle),time_sec * 1.0e6);
+                }
+
+              DSHOT_clearCmd(dshotHandle);
+            }
+
+          if(!flag_quiet && (DSHOT_getNumFrames(dshotHandle) != numFrames_z1) &&
+             ((DSHOT_getValue(dshotHandle) != value_z1) || (DSHOT_getState(dshotHandle) != state_z1)))
+            {
+              printf("%.1f,%u,%d,%s,%.6f\n",time_sec * 1.0e6,(unsigned)DSHOT_getValue(dshotHandle),
+                     (int)DSHOT_getFlag_telemRequest(dshotHandle),
+                     DSHOT_REPLAY_stateNames[DSHOT_getState(dshotHandle)],
+                     _IQtoF(DSHOT_getThrottle(dshotHandle)));
+
+              value_z1 = DSHOT_getValue(dshotHandle);
+            }
+
+          flag_frame = (DSHOT_getNumFrames(dshotHandle) != numFrames_z1);
+          numFrames_z1 = DSHOT_getNumFrames(dshotHandle);
+
+          // the reply bit period is 4/5 of the frame bit period
+          if(flag_bidir && flag_frame && (numPulses >= DSHOT_NUM_BITS))
+            {
+              double span_sec = pulseStart_sec[(numPulses - 1) % DSHOT_NUM_BITS] -
+                                pulseStart_sec[numPulses % DSHOT_NUM_BITS];
+
+              reply.flag_wait = true;
+              reply.wait_sec = time_sec + DSHOT_REPLAY_REPLY_WAIT_usec * 1.0e-6;
+              reply.bitPeriod_sec = 0.8 * span_sec / (DSHOT_NUM_BITS - 1);
+            }
+        }
+
+      // the state changes of the timeout are shown too
+      if(!flag_quiet && !flag_frame && (DSHOT_getState(dshotHandle) != state_z1))
+        {
+          printf("# state %s at %.1f usec\n",DSHOT_REPLAY_stateNames[DSHOT_getState(dshotHandle)],time_sec * 1.0e6);
+        }
+
+      state_z1 = DSHOT_getState(dshotHandle);
+    }
+
+  if(reply.flag_active)
+    {
+      DSHOT_REPLAY_finishReply(&reply,flag_quiet);
+    }
+
+  if(pFile != stdin)
+    {
+      fclose(pFile);
+    }
+
+  fprintf(stderr,"edges %lu, frames %lu, CRC errors %lu, frame errors %lu, state %s, reversed %d\n",
+          (unsigned long)numEdges,(unsigned long)DSHOT_getNumFrames(dshotHandle),
+          (unsigned long)DSHOT_getNumCrcErrors(dshotHandle),
+          (unsigned long)DSHOT_getNumFrameErrors(dshotHandle),
+          DSHOT_REPLAY_stateNames[DSHOT_getState(dshotHandle)],
+          (int)DSHOT_getFlag_reversed(dshotHandle));
+
+  if(flag_bidir)
+    {
+      fprintf(stderr,"replies %lu, %lu extended telemetry, reply errors %lu, last eRPM %.0f\n",
+              (unsigned long)reply.numReplies,(unsigned long)reply.numEdt,(unsigned long)reply.numErrors,
+              (reply.period_usec > 0) ? (60.0e6 / (double)reply.period_usec) : 0.0);
+
+      // a reply error is a decoder or a timing fault, the ESC sends valid replies
+      if(reply.numErrors > 0)
+        {
+          return(EXIT_FAILURE);
+        }
+    }
+
+  return(EXIT_SUCCESS);
+} // end of main() function
+
+
+// end of file
@@ -0,0 +1,91 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/dtcomp/src/32b/dtcomp.c
+//! \brief  Portable C code.  These functions define the
+//!         dead time compensation (DTCOMP) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/dtcomp/src/32b/dtcomp.h"
+
+
+// **************************************************************************
+// the functions
+
+DTCOMP_Handle DTCOMP_init(void *pMemory,const size_t numBytes)
+{
+  DTCOMP_Handle handle;
+  DTCOMP_Obj *obj;
+
+
+  if(numBytes < sizeof(DTCOMP_Obj))
+    return((DTCOMP_Handle)NULL);
+
+  // assign the handle
+  handle = (DTCOMP_Handle)pMemory;
+
+  obj = (DTCOMP_Obj *)handle;
+
+  obj->deadTime = _IQ(0.0);
+  obj->Vdrop = _IQ(0.0);
+  obj->currentBand_pu = _IQ(0.0);
+  obj->Tlimit = _IQ(0.0);
+  obj->Tcomp = _IQ(0.0);
+
+  return(handle);
+} // end of DTCOMP_init() function
+
+
+void DTCOMP_setParams(DTCOMP_Handle handle,
+                      const _iq deadTime_pu,
+                      const _iq Vdrop_pu,
+                      const _iq currentBand_pu,
+                      const _iq dutySpan)
+{
+  DTCOMP_Obj *obj = (DTCOMP_Obj *)handle;
+
+  obj->deadTime = _IQmpy(deadTime_pu,dutySpan);
+  obj->Vdrop = _IQmpy(Vdrop_pu,dutySpan);
+  obj->Tlimit = dutySpan >> 1;
+
+  // a zero band switches the compensation with the sign of the current
+  obj->currentBand_pu = (currentBand_pu > _IQ(0.0)) ? currentBand_pu : _IQ(0.0);
+
+  return;
+} // end of DTCOMP_setParams() function
+
+
+// end of file
@@ -0,0 +1,195 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _DTCOMP_H_
+#define _DTCOMP_H_
+
+//! \file   modules/dtcomp/src/32b/dtcomp.h
+//! \brief  Contains the public interface to the
+//!         dead time compensation (DTCOMP) module routines
+//!
+//!         While both switches of a phase are off for the dead time the
+//!         phase current flows through a diode.  A current out of the phase
+//!         flows through the lower diode, the phase is low for the dead time
+//!         after every rising edge and loses the dead time times the PWM
+//!         frequency of duty.  A current into the phase gains the same duty.
+//!         The on state voltage drop of the switches adds an error of the
+//!         same sign, the drop over the dc bus voltage in duty.
+//!
+//!         DTCOMP_run() adds the lost duty back to the phase duties in the
+//!         direction of the phase current.  Close to zero current the
+//!         polarity is uncertain and the dead time only delays the edge, the
+//!         compensation is scaled linearly to zero inside the current band.
+//!         A phase held at the rail by a discontinuous PWM or by saturation
+//!         does not switch and is not compensated.
+//!
+//!         The module sits in the control ISR between the controller and the
+//!         HAL:
+//!
+//!           CTRL_run()              space vector duties in Tabc
+//!           DTCOMP_run()            compensated duties
+//!           HAL_writePwmData()
+//!
+//!         The compensated duties are what the inverter applies on average,
+//!         the estimator sees them through the phase voltage feedback.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+#include "sw/modules/math/src/32b/math.h"
+
+
+//!
+//!
+//! \defgroup DTCOMP DTCOMP
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the dead time compensation (DTCOMP) object
+//!
+typedef struct _DTCOMP_Obj_
+{
+  _iq  deadTime;        //!< the compensation for the dead time, in Tabc units
+  _iq  Vdrop;           //!< the compensation for the switch voltage drop at a dc bus of 1 pu, in Tabc units
+  _iq  currentBand_pu;  //!< the current below which the compensation is scaled down, pu
+  _iq  Tlimit;          //!< the Tabc of 0 and 100% duty, the phases at the rails are not compensated
+
+  _iq  Tcomp;           //!< the compensation of the last run, in Tabc units
+} DTCOMP_Obj;
+
+
+//! \brief Defines the DTCOMP handle
+//!
+typedef struct _DTCOMP_Obj_ *DTCOMP_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Gets the compensation of the last run
+//! \param[in] handle  The dead time compensation (DTCOMP) handle
+//! \return    The duty added at full current, in Tabc units
+static inline _iq DTCOMP_getTcomp(DTCOMP_Handle handle)
+{
+  DTCOMP_Obj *obj = (DTCOMP_Obj *)handle;
+
+  return(obj->Tcomp);
+} // end of DTCOMP_getTcomp() function
+
+
+//! \brief     Initializes the dead time compensation (DTCOMP) module
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The dead time compensation (DTCOMP) handle
+extern DTCOMP_Handle DTCOMP_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Sets the parameters
+//! \details   The duty span is the change of Tabc from 0 to 100% duty, 1.0
+//!            for HALs mapping Tabc from -0.5 to 0.5 and 2.0 for HALs mapping
+//!            Tabc from -1.0 to 1.0.
+//! \param[in] handle          The dead time compensation (DTCOMP) handle
+//! \param[in] deadTime_pu     The dead time times the PWM frequency, pu
+//! \param[in] Vdrop_pu        The switch voltage drop, pu
+//! \param[in] currentBand_pu  The current below which the compensation is scaled down, pu
+//! \param[in] dutySpan        The change of Tabc from 0 to 100% duty
+extern void DTCOMP_setParams(DTCOMP_Handle handle,
+                             const _iq deadTime_pu,
+                             const _iq Vdrop_pu,
+                             const _iq currentBand_pu,
+                             const _iq dutySpan);
+
+
+//! \brief     Runs the dead time compensation
+//! \param[in] handle        The dead time compensation (DTCOMP) handle
+//! \param[in] pIabc         The pointer to the phase currents, pu
+//! \param[in] oneOverDcBus  The inverse of the dc bus voltage, 1/pu
+//! \param[in] pTabc         The pointer to the phase duties, compensated in place
+static inline void DTCOMP_run(DTCOMP_Handle handle,
+                              const MATH_vec3 *pIabc,
+                              const _iq oneOverDcBus,
+                              MATH_vec3 *pTabc)
+{
+  DTCOMP_Obj *obj = (DTCOMP_Obj *)handle;
+  _iq Tcomp = obj->deadTime + _IQmpy(obj->Vdrop,oneOverDcBus);
+  uint_least8_t cnt;
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      _iq current = pIabc->value[cnt];
+
+      if((pTabc->value[cnt] >= obj->Tlimit) || (pTabc->value[cnt] <= -obj->Tlimit))
+        {
+          continue;
+        }
+
+      if(current >= obj->currentBand_pu)
+        {
+          pTabc->value[cnt] += Tcomp;
+        }
+      else if(current <= -obj->currentBand_pu)
+        {
+          pTabc->value[cnt] -= Tcomp;
+        }
+      else
+        {
+          pTabc->value[cnt] += _IQmpy(Tcomp,_IQdiv(current,obj->currentBand_pu));
+        }
+    }
+
+  obj->Tcomp = Tcomp;
+
+  return;
+} // end of DTCOMP_run() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _DTCOMP_H_ definition
+
@@ -0,0 +1,1099 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/est/src/32b/host/est.c
+//! \brief  Contains the host stand-in for the ROM estimator (EST)
+//!
+//!         Only the interface used by the controller and the projects is
+//!         implemented.  The estimator does not identify motors, the motor
+//!         parameters are loaded from user.h through CTRL_setUserMotorParams()
+//!         and the angle and speed come from the registered truth function.
+//!         The per unit scaling of the parameters follows the conventions
+//!         used by the USER_compute*() functions in user.c.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <math.h>
+#include <string.h>
+
+#include "sw/modules/est/src/32b/host/est_host.h"
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the number of estimator objects, matches the ROM
+//!
+#define EST_NUM_ESTS                (2)
+
+//! \brief Defines the fraction of the rated flux used to scale the flux, pu
+//!
+#define EST_FLUX_SCALE_FRACTION     (0.7)
+
+//! \brief Defines the fraction of the coarse inductance used to scale the inductance, pu
+//!
+#define EST_LS_COARSE_MAX           (0.7)
+
+//! \brief Defines the smallest DC bus voltage used for the inverse, pu
+//!
+#define EST_DCBUS_MIN_pu            (0.05)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the estimator (EST) object
+//!
+typedef struct _EST_Obj_
+{
+  EST_State_e      state;                   //!< the estimator state
+  EST_ErrorCode_e  errorCode;               //!< the estimator error code
+
+  bool             flag_motorIdentified;    //!< a flag to denote that the motor parameters are loaded
+  bool             flag_enableForceAngle;   //!< a flag to enable the force angle
+  bool             flag_enableRsRecalc;     //!< a flag to enable the Rs recalibration
+  bool             flag_enableRsOnLine;     //!< a flag to enable the online Rs estimation
+  bool             flag_enableFluxControl;  //!< a flag to enable the flux control
+  bool             flag_estComplete;        //!< a flag to denote that the estimation is complete
+  bool             flag_updateRs;           //!< a flag to update Rs
+
+  float_t          fullScaleCurrent_A;      //!< the full scale current, A
+  float_t          fullScaleVoltage_V;      //!< the full scale voltage, V
+  float_t          fullScaleFreq_Hz;        //!< the full scale frequency, Hz
+  float_t          fullScaleInductance_H;   //!< the full scale inductance, H
+  float_t          fullScaleResistance_Ohm; //!< the full scale resistance, Ohm
+  float_t          fullScaleFlux_VpHz;      //!< the full scale flux, V/Hz
+
+  uint_least16_t   numPolePairs;            //!< the number of pole pairs
+
+  float_t          Rs_Ohm;                  //!< the stator resistance, Ohm
+  float_t          Rr_Ohm;                  //!< the rotor resistance, Ohm
+  float_t          Ls_d_H;                  //!< the direct stator inductance, H
+  float_t          Ls_q_H;                  //!< the quadrature stator inductance, H
+  float_t          flux_VpHz;               //!< the rated flux, V/Hz
+  float_t          IdRated_A;               //!< the rated magnetizing current, A
+
+  _iq              Rs_pu;                   //!< the stator resistance, pu in Rs_qFmt
+  uint_least8_t    Rs_qFmt;                 //!< the Q format of the stator resistance
+  _iq              Ls_d_pu;                 //!< the direct stator inductance, pu in IQ30
+  _iq              Ls_q_pu;                 //!< the quadrature stator inductance, pu in IQ30
+  uint_least8_t    Ls_qFmt;                 //!< the Q format of the stator inductance
+  _iq              Ls_coarse_max_pu;        //!< the coarse inductance scale, pu in IQ30
+  _iq              flux_pu;                 //!< the rated flux, pu
+
+  _iq              IdRated_pu;              //!< the rated magnetizing current, pu
+  _iq              Id_ref_pu;               //!< the Id reference, pu
+  _iq              Iq_ref_pu;               //!< the Iq reference, pu
+  _iq              maxCurrent_pu;           //!< the maximum current, pu
+  _iq              maxCurrentSlope_pu;      //!< the maximum current slope, pu
+  _iq              maxCurrentSlope_epl_pu;  //!< the maximum current slope with PowerWarp, pu
+  _iq              maxAccel_pu;             //!< the maximum acceleration, pu
+  _iq              maxAccel_est_pu;         //!< the maximum acceleration during identification, pu
+  _iq              forceAngleDelta_pu;      //!< the force angle delta, pu
+
+  MATH_vec2        Iab_pu;                  //!< the alpha/beta current input, pu
+  MATH_vec2        Vab_pu;                  //!< the alpha/beta voltage input, pu
+  _iq              dcBus_pu;                //!< the DC bus voltage, pu
+  _iq              oneOverDcBus_pu;         //!< the inverse of the DC bus voltage, pu
+  _iq              angle_pu;                //!< the electrical angle, pu
+  _iq              Fm_pu;                   //!< the electrical frequency, pu
+
+  EST_TruthFcn     truthFcn;                //!< the truth function
+  void            *pTruthArg;               //!< the argument of the truth function
+} EST_Obj;
+
+
+// **************************************************************************
+// the globals
+
+//! \brief Defines the estimator objects, the ROM keeps these in protected RAM
+//!
+EST_Obj est[EST_NUM_ESTS];
+
+
+// **************************************************************************
+// the functions
+
+static void EST_scaleParams(EST_Obj *obj)
+{
+  float_t maxFlux = obj->flux_VpHz * EST_FLUX_SCALE_FRACTION;
+  float_t Ls_coarse_max = _IQ30toF(obj->Ls_coarse_max_pu);
+  int_least8_t lShift;
+
+
+  // flux, scaled to the largest power of two above the expected maximum
+  if(maxFlux > 0.0)
+    {
+      lShift = (int_least8_t)-ceil(log(obj->fullScaleFlux_VpHz/maxFlux)/log(2.0));
+      obj->flux_pu = _IQ(obj->flux_VpHz/(obj->fullScaleFlux_VpHz*pow(2.0,lShift)));
+    }
+  else
+    {
+      obj->flux_pu = _IQ(0.0);
+    }
+
+
+  // inductance, IQ30 with the shift held in the Q format
+  if((obj->Ls_d_H > 0.0) && (Ls_coarse_max > 0.0))
+    {
+      float_t L_max;
+
+      lShift = (int_least8_t)ceil(log(obj->Ls_d_H/(Ls_coarse_max*obj->fullScaleInductance_H))/log(2.0));
+      L_max = obj->fullScaleInductance_H * pow(2.0,lShift);
+
+      obj->Ls_qFmt = (uint_least8_t)(30 - lShift);
+      obj->Ls_d_pu = _IQ30(obj->Ls_d_H/L_max);
+      obj->Ls_q_pu = _IQ30(obj->Ls_q_H/L_max);
+    }
+
+
+  // resistance, same convention as the inductance
+  if(obj->Rs_Ohm > 0.0)
+    {
+      lShift = (int_least8_t)ceil(log(obj->Rs_Ohm/obj->fullScaleResistance_Ohm)/log(2.0));
+
+      obj->Rs_qFmt = (uint_least8_t)(30 - lShift);
+      obj->Rs_pu = _IQ30(obj->Rs_Ohm/(obj->fullScaleResistance_Ohm*pow(2.0,lShift)));
+    }
+
+  return;
+} // end of EST_scaleParams() function
+
+
+EST_Handle EST_initEst(const uint_least8_t estNumber)
+{
+  EST_Obj *obj;
+
+
+  if(estNumber >= EST_NUM_ESTS)
+    return((EST_Handle)NULL);
+
+  obj = &est[estNumber];
+
+  memset(obj,0,sizeof(EST_Obj));
+
+  obj->state = EST_State_Idle;
+  obj->errorCode = EST_ErrorCode_NoError;
+  obj->Ls_coarse_max_pu = _IQ30(EST_LS_COARSE_MAX);
+  obj->Rs_qFmt = 30;
+  obj->Ls_qFmt = 30;
+  obj->numPolePairs = 1;
+  obj->oneOverDcBus_pu = _IQ(1.0);
+
+  return((EST_Handle)obj);
+} // end of EST_initEst() function
+
+
+bool EST_doCurrentCtrl(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return((obj->state != EST_State_Error) && (obj->state != EST_State_Idle));
+} // end of EST_doCurrentCtrl() function
+
+
+bool EST_doSpeedCtrl(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->state >= EST_State_MotorIdentified);
+} // end of EST_doSpeedCtrl() function
+
+
+_iq EST_get_krpm_to_pu_sf(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(_IQ((float_t)obj->numPolePairs*1000.0/(60.0*obj->fullScaleFreq_Hz)));
+} // end of EST_get_krpm_to_pu_sf() function
+
+
+_iq EST_get_pu_to_krpm_sf(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(_IQ(60.0*obj->fullScaleFreq_Hz/((float_t)obj->numPolePairs*1000.0)));
+} // end of EST_get_pu_to_krpm_sf() function
+
+
+_iq EST_getAngle_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->angle_pu);
+} // end of EST_getAngle_pu() function
+
+
+_iq EST_getDcBus_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->dcBus_pu);
+} // end of EST_getDcBus_pu() function
+
+
+EST_ErrorCode_e EST_getErrorCode(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->errorCode);
+} // end of EST_getErrorCode() function
+
+
+float_t EST_getFe(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(_IQtoF(obj->Fm_pu)*obj->fullScaleFreq_Hz);
+} // end of EST_getFe() function
+
+
+_iq EST_getFe_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->Fm_pu);
+} // end of EST_getFe_pu() function
+
+
+bool EST_getFlag_enableForceAngle(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->flag_enableForceAngle);
+} // end of EST_getFlag_enableForceAngle() function
+
+
+bool EST_getFlag_enableRsOnLine(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->flag_enableRsOnLine);
+} // end of EST_getFlag_enableRsOnLine() function
+
+
+bool EST_getFlag_enableRsRecalc(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->flag_enableRsRecalc);
+} // end of EST_getFlag_enableRsRecalc() function
+
+
+bool EST_getFlag_estComplete(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->flag_estComplete);
+} // end of EST_getFlag_estComplete() function
+
+
+bool EST_getFlag_updateRs(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->flag_updateRs);
+} // end of EST_getFlag_updateRs() function
+
+
+float_t EST_getFlux_VpHz(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->flux_VpHz);
+} // end of EST_getFlux_VpHz() function
+
+
+float_t EST_getFlux_Wb(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->flux_VpHz/MATH_TWO_PI);
+} // end of EST_getFlux_Wb() function
+
+
+_iq EST_getFlux_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->flux_pu);
+} // end of EST_getFlux_pu() function
+
+
+float_t EST_getFm(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(_IQtoF(obj->Fm_pu)*obj->fullScaleFreq_Hz);
+} // end of EST_getFm() function
+
+
+_iq EST_getFm_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->Fm_pu);
+} // end of EST_getFm_pu() function
+
+
+_iq EST_getForceAngleDelta_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->forceAngleDelta_pu);
+} // end of EST_getForceAngleDelta_pu() function
+
+
+bool EST_getForceAngleStatus(EST_Handle handle)
+{
+
+  // the truth function always provides a valid angle
+  return(false);
+} // end of EST_getForceAngleStatus() function
+
+
+float_t EST_getFullScaleCurrent(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->fullScaleCurrent_A);
+} // end of EST_getFullScaleCurrent() function
+
+
+float_t EST_getFullScaleFlux(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->fullScaleFlux_VpHz);
+} // end of EST_getFullScaleFlux() function
+
+
+float_t EST_getFullScaleFreq(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->fullScaleFreq_Hz);
+} // end of EST_getFullScaleFreq() function
+
+
+float_t EST_getFullScaleInductance(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->fullScaleInductance_H);
+} // end of EST_getFullScaleInductance() function
+
+
+float_t EST_getFullScaleResistance(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->fullScaleResistance_Ohm);
+} // end of EST_getFullScaleResistance() function
+
+
+float_t EST_getFullScaleVoltage(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->fullScaleVoltage_V);
+} // end of EST_getFullScaleVoltage() function
+
+
+void EST_getIab_pu(EST_Handle handle,MATH_vec2 *pIab)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  pIab->value[0] = obj->Iab_pu.value[0];
+  pIab->value[1] = obj->Iab_pu.value[1];
+
+  return;
+} // end of EST_getIab_pu() function
+
+
+float_t EST_getIdRated(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(_IQtoF(obj->IdRated_pu)*obj->fullScaleCurrent_A);
+} // end of EST_getIdRated() function
+
+
+_iq EST_getIdRated_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->IdRated_pu);
+} // end of EST_getIdRated_pu() function
+
+
+float_t EST_getLs_d_H(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->Ls_d_H);
+} // end of EST_getLs_d_H() function
+
+
+_iq EST_getLs_d_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->Ls_d_pu);
+} // end of EST_getLs_d_pu() function
+
+
+void EST_getLs_dq_pu(EST_Handle handle,MATH_vec2 *pLs_dq_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  pLs_dq_pu->value[0] = obj->Ls_d_pu;
+  pLs_dq_pu->value[1] = obj->Ls_q_pu;
+
+  return;
+} // end of EST_getLs_dq_pu() function
+
+
+float_t EST_getLs_q_H(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->Ls_q_H);
+} // end of EST_getLs_q_H() function
+
+
+_iq EST_getLs_q_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->Ls_q_pu);
+} // end of EST_getLs_q_pu() function
+
+
+uint_least8_t EST_getLs_qFmt(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->Ls_qFmt);
+} // end of EST_getLs_qFmt() function
+
+
+_iq EST_getLs_coarse_max_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->Ls_coarse_max_pu);
+} // end of EST_getLs_coarse_max_pu() function
+
+
+_iq EST_getMaxAccel_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->maxAccel_pu);
+} // end of EST_getMaxAccel_pu() function
+
+
+_iq EST_getMaxAccel_est_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->maxAccel_est_pu);
+} // end of EST_getMaxAccel_est_pu() function
+
+
+_iq EST_getMaxCurrent_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->maxCurrent_pu);
+} // end of EST_getMaxCurrent_pu() function
+
+
+_iq EST_getMaxCurrentSlope_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->maxCurrentSlope_pu);
+} // end of EST_getMaxCurrentSlope_pu() function
+
+
+_iq EST_getMaxCurrentSlope_epl_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->maxCurrentSlope_epl_pu);
+} // end of EST_getMaxCurrentSlope_epl_pu() function
+
+
+_iq EST_getOneOverDcBus_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->oneOverDcBus_pu);
+} // end of EST_getOneOverDcBus_pu() function
+
+
+float_t EST_getRr_Ohm(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->Rr_Ohm);
+} // end of EST_getRr_Ohm() function
+
+
+float_t EST_getRs_Ohm(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->Rs_Ohm);
+} // end of EST_getRs_Ohm() function
+
+
+_iq EST_getRs_pu(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->Rs_pu);
+} // end of EST_getRs_pu() function
+
+
+uint_least8_t EST_getRs_qFmt(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->Rs_qFmt);
+} // end of EST_getRs_qFmt() function
+
+
+int_least8_t EST_getSignOfDirection(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return((obj->Fm_pu < _IQ(0.0)) ? -1 : 1);
+} // end of EST_getSignOfDirection() function
+
+
+_iq EST_getSpeed_krpm(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(_IQmpy(obj->Fm_pu,EST_get_pu_to_krpm_sf(handle)));
+} // end of EST_getSpeed_krpm() function
+
+
+EST_State_e EST_getState(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->state);
+} // end of EST_getState() function
+
+
+bool EST_isError(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->state == EST_State_Error);
+} // end of EST_isError() function
+
+
+bool EST_isIdle(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->state == EST_State_Idle);
+} // end of EST_isIdle() function
+
+
+bool EST_isLockRotor(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->state == EST_State_LockRotor);
+} // end of EST_isLockRotor() function
+
+
+bool EST_isMotorIdentified(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->flag_motorIdentified);
+} // end of EST_isMotorIdentified() function
+
+
+bool EST_isOnLine(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  return(obj->state == EST_State_OnLine);
+} // end of EST_isOnLine() function
+
+
+void EST_run(EST_Handle handle,
+             const MATH_vec2 *pIab_pu,
+             const MATH_vec2 *pVab_pu,
+             const _iq dcBus_pu,
+             const _iq speed_ref_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+  _iq dcBus_sat_pu = _IQsat(dcBus_pu,_IQ(1.0),_IQ(EST_DCBUS_MIN_pu));
+
+
+  obj->Iab_pu.value[0] = pIab_pu->value[0];
+  obj->Iab_pu.value[1] = pIab_pu->value[1];
+
+  obj->Vab_pu.value[0] = pVab_pu->value[0];
+  obj->Vab_pu.value[1] = pVab_pu->value[1];
+
+  obj->dcBus_pu = dcBus_pu;
+  obj->oneOverDcBus_pu = _IQdiv(_IQ(1.0),dcBus_sat_pu);
+
+  if(obj->truthFcn != NULL)
+    {
+      obj->truthFcn(obj->pTruthArg,&obj->angle_pu,&obj->Fm_pu);
+    }
+
+  return;
+} // end of EST_run() function
+
+
+void EST_setAngle_pu(EST_Handle handle,const _iq angle_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->angle_pu = angle_pu;
+
+  return;
+} // end of EST_setAngle_pu() function
+
+
+void EST_setDcBus_pu(EST_Handle handle,const _iq dcBus_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->dcBus_pu = dcBus_pu;
+
+  return;
+} // end of EST_setDcBus_pu() function
+
+
+void EST_setFlag_enableFluxControl(EST_Handle handle,const bool state)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->flag_enableFluxControl = state;
+
+  return;
+} // end of EST_setFlag_enableFluxControl() function
+
+
+void EST_setFlag_enableForceAngle(EST_Handle handle,const bool state)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->flag_enableForceAngle = state;
+
+  return;
+} // end of EST_setFlag_enableForceAngle() function
+
+
+void EST_setFlag_enableRsOnLine(EST_Handle handle,const bool state)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->flag_enableRsOnLine = state;
+
+  return;
+} // end of EST_setFlag_enableRsOnLine() function
+
+
+void EST_setFlag_enableRsRecalc(EST_Handle handle,const bool state)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->flag_enableRsRecalc = state;
+
+  return;
+} // end of EST_setFlag_enableRsRecalc() function
+
+
+void EST_setFlag_estComplete(EST_Handle handle,const bool state)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->flag_estComplete = state;
+
+  return;
+} // end of EST_setFlag_estComplete() function
+
+
+void EST_setFlag_updateRs(EST_Handle handle,const bool state)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->flag_updateRs = state;
+
+  return;
+} // end of EST_setFlag_updateRs() function
+
+
+void EST_setForceAngleDelta_pu(EST_Handle handle,const _iq angleDelta_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->forceAngleDelta_pu = angleDelta_pu;
+
+  return;
+} // end of EST_setForceAngleDelta_pu() function
+
+
+void EST_setFullScaleCurrent(EST_Handle handle,const float_t fullScaleCurrent)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->fullScaleCurrent_A = fullScaleCurrent;
+
+  return;
+} // end of EST_setFullScaleCurrent() function
+
+
+void EST_setFullScaleFlux(EST_Handle handle,const float_t fullScaleFlux)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->fullScaleFlux_VpHz = fullScaleFlux;
+
+  return;
+} // end of EST_setFullScaleFlux() function
+
+
+void EST_setFullScaleFreq(EST_Handle handle,const float_t fullScaleFreq)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->fullScaleFreq_Hz = fullScaleFreq;
+
+  return;
+} // end of EST_setFullScaleFreq() function
+
+
+void EST_setFullScaleInductance(EST_Handle handle,const float_t fullScaleInductance)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->fullScaleInductance_H = fullScaleInductance;
+
+  return;
+} // end of EST_setFullScaleInductance() function
+
+
+void EST_setFullScaleResistance(EST_Handle handle,const float_t fullScaleResistance)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->fullScaleResistance_Ohm = fullScaleResistance;
+
+  return;
+} // end of EST_setFullScaleResistance() function
+
+
+void EST_setFullScaleVoltage(EST_Handle handle,const float_t fullScaleVoltage)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->fullScaleVoltage_V = fullScaleVoltage;
+
+  return;
+} // end of EST_setFullScaleVoltage() function
+
+
+void EST_setIdle(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->state = EST_State_Idle;
+  obj->Id_ref_pu = _IQ(0.0);
+  obj->Iq_ref_pu = _IQ(0.0);
+
+  return;
+} // end of EST_setIdle() function
+
+
+void EST_setIdle_all(EST_Handle handle)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  EST_setIdle(handle);
+
+  obj->errorCode = EST_ErrorCode_NoError;
+  obj->flag_estComplete = false;
+
+  return;
+} // end of EST_setIdle_all() function
+
+
+void EST_setId_ref_pu(EST_Handle handle,const _iq Id_ref_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->Id_ref_pu = Id_ref_pu;
+
+  return;
+} // end of EST_setId_ref_pu() function
+
+
+void EST_setIdRated_pu(EST_Handle handle,const _iq IdRated_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->IdRated_pu = IdRated_pu;
+
+  return;
+} // end of EST_setIdRated_pu() function
+
+
+void EST_setIq_ref_pu(EST_Handle handle,const _iq Iq_ref_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->Iq_ref_pu = Iq_ref_pu;
+
+  return;
+} // end of EST_setIq_ref_pu() function
+
+
+void EST_setLs_d_pu(EST_Handle handle,const _iq Ls_d_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->Ls_d_pu = Ls_d_pu;
+
+  return;
+} // end of EST_setLs_d_pu() function
+
+
+void EST_setLs_dq_pu(EST_Handle handle,const MATH_vec2 *pLs_dq_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->Ls_d_pu = pLs_dq_pu->value[0];
+  obj->Ls_q_pu = pLs_dq_pu->value[1];
+
+  return;
+} // end of EST_setLs_dq_pu() function
+
+
+void EST_setLs_q_pu(EST_Handle handle,const _iq Ls_q_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->Ls_q_pu = Ls_q_pu;
+
+  return;
+} // end of EST_setLs_q_pu() function
+
+
+void EST_setLs_qFmt(EST_Handle handle,const uint_least8_t Ls_qFmt)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->Ls_qFmt = Ls_qFmt;
+
+  return;
+} // end of EST_setLs_qFmt() function
+
+
+void EST_setMaxAccel_pu(EST_Handle handle,const _iq maxAccel_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->maxAccel_pu = maxAccel_pu;
+
+  return;
+} // end of EST_setMaxAccel_pu() function
+
+
+void EST_setMaxAccel_est_pu(EST_Handle handle,const _iq maxAccel_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->maxAccel_est_pu = maxAccel_pu;
+
+  return;
+} // end of EST_setMaxAccel_est_pu() function
+
+
+void EST_setMaxCurrent_pu(EST_Handle handle,const _iq maxCurrent_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->maxCurrent_pu = maxCurrent_pu;
+
+  return;
+} // end of EST_setMaxCurrent_pu() function
+
+
+void EST_setMaxCurrentSlope_pu(EST_Handle handle,const _iq maxCurrentSlope_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->maxCurrentSlope_pu = maxCurrentSlope_pu;
+
+  return;
+} // end of EST_setMaxCurrentSlope_pu() function
+
+
+void EST_setMaxCurrentSlope_epl_pu(EST_Handle handle,const _iq maxCurrentSlope_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->maxCurrentSlope_epl_pu = maxCurrentSlope_pu;
+
+  return;
+} // end of EST_setMaxCurrentSlope_epl_pu() function
+
+
+void EST_setMotorParams(EST_Handle handle,
+                        const uint_least16_t numPolePairs,
+                        const float_t ratedFlux,
+                        const float_t Ls_d_H,
+                        const float_t Ls_q_H,
+                        const float_t Rs_Ohm)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->numPolePairs = numPolePairs;
+  obj->flux_VpHz = ratedFlux;
+  obj->Ls_d_H = Ls_d_H;
+  obj->Ls_q_H = Ls_q_H;
+  obj->Rs_Ohm = Rs_Ohm;
+
+  EST_scaleParams(obj);
+
+  obj->flag_motorIdentified = true;
+
+  return;
+} // end of EST_setMotorParams() function
+
+
+void EST_setNumPolePairs(EST_Handle handle,const uint_least16_t numPolePairs)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->numPolePairs = numPolePairs;
+
+  return;
+} // end of EST_setNumPolePairs() function
+
+
+void EST_setRs_pu(EST_Handle handle,const _iq Rs_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->Rs_pu = Rs_pu;
+  obj->Rs_Ohm = ldexp((double)Rs_pu,-(int)obj->Rs_qFmt) * obj->fullScaleResistance_Ohm;
+
+  return;
+} // end of EST_setRs_pu() function
+
+
+void EST_setRs_qFmt(EST_Handle handle,uint_least8_t Rs_qFmt)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->Rs_qFmt = Rs_qFmt;
+
+  return;
+} // end of EST_setRs_qFmt() function
+
+
+void EST_setTruthFcn(EST_Handle handle,const EST_TruthFcn truthFcn,void *pArg)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+
+  obj->truthFcn = truthFcn;
+  obj->pTruthArg = pArg;
+
+  return;
+} // end of EST_setTruthFcn() function
+
+
+void EST_updateId_ref_pu(EST_Handle handle,_iq *pId_ref_pu)
+{
+
+  // permanent magnet motors only, no flux control, the reference is left as is
+  return;
+} // end of EST_updateId_ref_pu() function
+
+
+bool EST_updateState(EST_Handle handle,const _iq Id_target_pu)
+{
+  EST_Obj *obj = (EST_Obj *)handle;
+  EST_State_e prevState = obj->state;
+
+
+  if(obj->state == EST_State_Idle)
+    {
+      if(obj->flag_motorIdentified)
+        {
+          // skip the recalibration and go straight to online
+          obj->state = EST_State_OnLine;
+        }
+      else
+        {
+          // motor identification needs the ROM estimator
+          obj->state = EST_State_Error;
+        }
+    }
+  else if(obj->state == EST_State_MotorIdentified)
+    {
+      obj->state = EST_State_OnLine;
+    }
+
+  return(obj->state != prevState);
+} // end of EST_updateState() function
+
+
+bool EST_useZeroIq_ref(EST_Handle handle)
+{
+
+  // only used during the identification
+  return(false);
+} // end of EST_useZeroIq_ref() function
+
+
+// end of file
+
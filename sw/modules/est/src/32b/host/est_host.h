@@ -0,0 +1,139 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _EST_HOST_H_
+#define _EST_HOST_H_
+
+//! \file   modules/est/src/32b/host/est_host.h
+//! \brief  Contains the host only extensions to the estimator (EST) interface
+//!
+//!         The FAST estimator only exists in the ROM of the target device.
+//!         The host simulator links a stand-in estimator instead, which
+//!         implements the interface in est.h around an ideal observer: the
+//!         rotor angle and speed are taken from a truth function supplied by
+//!         the plant model.  Everything downstream of the estimator, i.e. the
+//!         controller, trajectories and the HAL, runs unmodified.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/est/src/32b/est.h"
+
+
+//!
+//!
+//! \defgroup EST_HOST EST_HOST
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the truth function used by the host estimator
+//! \param[in]  pArg       The argument registered with the function
+//! \param[out] pAngle_pu  The pointer to the electrical angle, pu
+//! \param[out] pFm_pu     The pointer to the electrical frequency, pu
+typedef void (*EST_TruthFcn)(void *pArg,_iq *pAngle_pu,_iq *pFm_pu);
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Initializes the estimator
+//! \details   Mirrors the ROM initialization, which hands out one of a fixed
+//!            number of statically allocated estimator objects
+//! \param[in] estNumber  The estimator number
+//! \return    The estimator (EST) handle
+extern EST_Handle EST_initEst(const uint_least8_t estNumber);
+
+
+//! \brief     Gets the maximum current
+//! \details   The ROM keeps the current limit of the speed controller in the
+//!            estimator object, the host estimator does the same
+//! \param[in] handle  The estimator (EST) handle
+//! \return    The maximum current, pu
+extern _iq EST_getMaxCurrent_pu(EST_Handle handle);
+
+
+//! \brief     Sets the maximum current
+//! \param[in] handle         The estimator (EST) handle
+//! \param[in] maxCurrent_pu  The maximum current, pu
+extern void EST_setMaxCurrent_pu(EST_Handle handle,const _iq maxCurrent_pu);
+
+
+//! \brief     Sets the motor parameters in the estimator
+//! \details   Takes the place of the motor identification, the estimator is
+//!            marked as identified on return
+//! \param[in] handle        The estimator (EST) handle
+//! \param[in] numPolePairs  The number of pole pairs
+//! \param[in] ratedFlux     The rated flux, V/Hz
+//! \param[in] Ls_d_H        The direct stator inductance, H
+//! \param[in] Ls_q_H        The quadrature stator inductance, H
+//! \param[in] Rs_Ohm        The stator resistance, Ohm
+extern void EST_setMotorParams(EST_Handle handle,
+                               const uint_least16_t numPolePairs,
+                               const float_t ratedFlux,
+                               const float_t Ls_d_H,
+                               const float_t Ls_q_H,
+                               const float_t Rs_Ohm);
+
+
+//! \brief     Sets the number of pole pairs used for the krpm conversions
+//! \param[in] handle        The estimator (EST) handle
+//! \param[in] numPolePairs  The number of pole pairs
+extern void EST_setNumPolePairs(EST_Handle handle,const uint_least16_t numPolePairs);
+
+
+//! \brief     Sets the truth function
+//! \details   Without a truth function the estimator holds the angle and
+//!            speed at zero
+//! \param[in] handle     The estimator (EST) handle
+//! \param[in] truthFcn   The truth function
+//! \param[in] pArg       The argument passed to the truth function
+extern void EST_setTruthFcn(EST_Handle handle,const EST_TruthFcn truthFcn,void *pArg);
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+#endif // end of _EST_HOST_H_ definition
+
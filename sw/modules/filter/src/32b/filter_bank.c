@@ -0,0 +1,123 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/filter/src/32b/filter_bank.c
+//! \brief  Portable C fixed point code.  These functions define the
+//!         filter bank (FILTER_BANK) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/filter/src/32b/filter_bank.h"
+
+
+// **************************************************************************
+// the functions
+
+FILTER_BANK_Handle FILTER_BANK_init(void *pMemory,const size_t numBytes)
+{
+  FILTER_BANK_Handle handle;
+  FILTER_BANK_Obj *obj;
+  uint_least8_t cnt;
+
+
+  if(numBytes < sizeof(FILTER_BANK_Obj))
+    return((FILTER_BANK_Handle)NULL);
+
+  // assign the handle
+  handle = (FILTER_BANK_Handle)pMemory;
+
+  obj = (FILTER_BANK_Obj *)handle;
+
+  obj->a1 = _IQ(0.0);
+  obj->a2 = _IQ(0.0);
+  obj->b0 = _IQ(0.0);
+  obj->b1 = _IQ(0.0);
+  obj->b2 = _IQ(0.0);
+
+  for(cnt=0;cnt<FILTER_BANK_MAX_CHANNELS;cnt++)
+    {
+      FILTER_BANK_setInitialConditions(handle,cnt,_IQ(0.0),_IQ(0.0),_IQ(0.0),_IQ(0.0));
+    }
+
+  return(handle);
+} // end of FILTER_BANK_init() function
+
+
+void FILTER_BANK_setDenCoeffs(FILTER_BANK_Handle handle,const _iq a1,const _iq a2)
+{
+  FILTER_BANK_Obj *obj = (FILTER_BANK_Obj *)handle;
+
+
+  obj->a1 = a1;
+  obj->a2 = a2;
+
+  return;
+} // end of FILTER_BANK_setDenCoeffs() function
+
+
+void FILTER_BANK_setInitialConditions(FILTER_BANK_Handle handle,
+                                      const uint_least8_t channel,
+                                      const _iq x1,
+                                      const _iq x2,
+                                      const _iq y1,
+                                      const _iq y2)
+{
+  FILTER_BANK_Obj *obj = (FILTER_BANK_Obj *)handle;
+
+
+  obj->x1[channel] = x1;
+  obj->x2[channel] = x2;
+
+  obj->y1[channel] = y1;
+  obj->y2[channel] = y2;
+
+  return;
+} // end of FILTER_BANK_setInitialConditions() function
+
+
+void FILTER_BANK_setNumCoeffs(FILTER_BANK_Handle handle,const _iq b0,const _iq b1,const _iq b2)
+{
+  FILTER_BANK_Obj *obj = (FILTER_BANK_Obj *)handle;
+
+
+  obj->b0 = b0;
+  obj->b1 = b1;
+  obj->b2 = b2;
+
+  return;
+} // end of FILTER_BANK_setNumCoeffs() function
+
+
+// end of file
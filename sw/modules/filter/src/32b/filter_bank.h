@@ -0,0 +1,245 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _FILTER_BANK_H_
+#define _FILTER_BANK_H_
+
+//! \file   modules/filter/src/32b/filter_bank.h
+//! \brief  Contains the public interface to the
+//!         filter bank (FILTER_BANK) module routines
+//!
+//!         A bank runs the same first-order or second-order filter on up to
+//!         FILTER_BANK_MAX_CHANNELS channels.  The coefficients are stored
+//!         once and the states as one array per delay, so a call filters a
+//!         range of channels in one loop over consecutive words instead of
+//!         one FILTER_FO_run() or FILTER_SO_run() per channel object.  The
+//!         arithmetic is the same as in those functions, the outputs are
+//!         identical.
+//!
+//!         The object holds no pointers, it can be placed in a message RAM
+//!         and the floating point version in modules/filter/src/float runs
+//!         on the CLA.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+
+
+//!
+//!
+//! \defgroup FILTER_BANK FILTER_BANK
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the maximum number of channels of a bank
+//!
+#define FILTER_BANK_MAX_CHANNELS    (8)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the filter bank (FILTER_BANK) object
+//!
+typedef struct _FILTER_BANK_Obj_
+{
+  _iq     a1;                               //!< the denominator filter coefficient value for z^(-1)
+  _iq     a2;                               //!< the denominator filter coefficient value for z^(-2)
+
+  _iq     b0;                               //!< the numerator filter coefficient value for z^0
+  _iq     b1;                               //!< the numerator filter coefficient value for z^(-1)
+  _iq     b2;                               //!< the numerator filter coefficient value for z^(-2)
+
+  _iq     x1[FILTER_BANK_MAX_CHANNELS];     //!< the input values at time sample n=-1
+  _iq     x2[FILTER_BANK_MAX_CHANNELS];     //!< the input values at time sample n=-2
+
+  _iq     y1[FILTER_BANK_MAX_CHANNELS];     //!< the output values at time sample n=-1
+  _iq     y2[FILTER_BANK_MAX_CHANNELS];     //!< the output values at time sample n=-2
+} FILTER_BANK_Obj;
+
+
+//! \brief Defines the filter bank (FILTER_BANK) handle
+//!
+typedef struct _FILTER_BANK_Obj_ *FILTER_BANK_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Gets the output value of a channel at time sample n=-1
+//! \details   After a run this is the latest output of the channel
+//! \param[in] handle   The filter bank handle
+//! \param[in] channel  The channel
+//! \return    The output value at time sample n=-1
+static inline _iq FILTER_BANK_get_y1(FILTER_BANK_Handle handle,const uint_least8_t channel)
+{
+  FILTER_BANK_Obj *obj = (FILTER_BANK_Obj *)handle;
+
+  return(obj->y1[channel]);
+} // end of FILTER_BANK_get_y1() function
+
+
+//! \brief     Initializes the filter bank
+//! \details   The coefficients and the states of all channels are zero
+//! \param[in] pMemory   A pointer to the memory for the filter bank object
+//! \param[in] numBytes  The number of bytes allocated for the filter bank object, bytes
+//! \return    The filter bank (FILTER_BANK) object handle
+extern FILTER_BANK_Handle FILTER_BANK_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Runs a first-order filter of the form
+//!            y[n] = b0*x[n] + b1*x[n-1] - a1*y[n-1]
+//!            on consecutive channels
+//! \param[in] handle       The filter bank handle
+//! \param[in] channel      The first channel
+//! \param[in] numChannels  The number of channels
+//! \param[in] pInput       The pointer to the input values of the channels
+static inline void FILTER_BANK_runFo(FILTER_BANK_Handle handle,
+                                     const uint_least8_t channel,
+                                     const uint_least8_t numChannels,
+                                     const _iq *pInput)
+{
+  FILTER_BANK_Obj *obj = (FILTER_BANK_Obj *)handle;
+  _iq a1 = obj->a1;
+  _iq b0 = obj->b0;
+  _iq b1 = obj->b1;
+  uint_least8_t cnt;
+
+
+  for(cnt=0;cnt<numChannels;cnt++)
+    {
+      _iq x0 = pInput[cnt];
+      _iq y0 = _IQmpy(b0,x0) + _IQmpy(b1,obj->x1[channel + cnt])
+        - _IQmpy(a1,obj->y1[channel + cnt]);
+
+      // store values for next time
+      obj->x1[channel + cnt] = x0;
+      obj->y1[channel + cnt] = y0;
+    }
+
+  return;
+} // end of FILTER_BANK_runFo() function
+
+
+//! \brief     Runs a second-order filter of the form
+//!            y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] - a1*y[n-1] - a2*y[n-2]
+//!            on consecutive channels
+//! \param[in] handle       The filter bank handle
+//! \param[in] channel      The first channel
+//! \param[in] numChannels  The number of channels
+//! \param[in] pInput       The pointer to the input values of the channels
+static inline void FILTER_BANK_runSo(FILTER_BANK_Handle handle,
+                                     const uint_least8_t channel,
+                                     const uint_least8_t numChannels,
+                                     const _iq *pInput)
+{
+  FILTER_BANK_Obj *obj = (FILTER_BANK_Obj *)handle;
+  _iq a1 = obj->a1;
+  _iq a2 = obj->a2;
+  _iq b0 = obj->b0;
+  _iq b1 = obj->b1;
+  _iq b2 = obj->b2;
+  uint_least8_t cnt;
+
+
+  for(cnt=0;cnt<numChannels;cnt++)
+    {
+      _iq x0 = pInput[cnt];
+      _iq x1 = obj->x1[channel + cnt];
+      _iq y1 = obj->y1[channel + cnt];
+      _iq y0 = _IQmpy(b0,x0) + _IQmpy(b1,x1) + _IQmpy(b2,obj->x2[channel + cnt])
+        - _IQmpy(a1,y1) - _IQmpy(a2,obj->y2[channel + cnt]);
+
+      // store values for next time
+      obj->x1[channel + cnt] = x0;
+      obj->x2[channel + cnt] = x1;
+      obj->y1[channel + cnt] = y0;
+      obj->y2[channel + cnt] = y1;
+    }
+
+  return;
+} // end of FILTER_BANK_runSo() function
+
+
+//! \brief     Sets the denominator coefficients
+//! \details   The first-order filter only uses a1
+//! \param[in] handle  The filter bank handle
+//! \param[in] a1      The filter coefficient value for z^(-1)
+//! \param[in] a2      The filter coefficient value for z^(-2)
+extern void FILTER_BANK_setDenCoeffs(FILTER_BANK_Handle handle,const _iq a1,const _iq a2);
+
+
+//! \brief     Sets the initial conditions of a channel
+//! \param[in] handle   The filter bank handle
+//! \param[in] channel  The channel
+//! \param[in] x1       The input value at time sample n=-1
+//! \param[in] x2       The input value at time sample n=-2
+//! \param[in] y1       The output value at time sample n=-1
+//! \param[in] y2       The output value at time sample n=-2
+extern void FILTER_BANK_setInitialConditions(FILTER_BANK_Handle handle,
+                                             const uint_least8_t channel,
+                                             const _iq x1,
+                                             const _iq x2,
+                                             const _iq y1,
+                                             const _iq y2);
+
+
+//! \brief     Sets the numerator coefficients
+//! \details   The first-order filter only uses b0 and b1
+//! \param[in] handle  The filter bank handle
+//! \param[in] b0      The filter coefficient value for z^0
+//! \param[in] b1      The filter coefficient value for z^(-1)
+//! \param[in] b2      The filter coefficient value for z^(-2)
+extern void FILTER_BANK_setNumCoeffs(FILTER_BANK_Handle handle,const _iq b0,const _iq b1,const _iq b2);
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _FILTER_BANK_H_ definition
+
@@ -0,0 +1,374 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/filter/src/32b/host/filter_bank_bench.c
+//! \brief  Compares the filter bank (FILTER_BANK) with one FILTER_FO or
+//!         FILTER_SO object per channel
+//!
+//!         Six channels, three currents and three voltages, are filtered
+//!         per simulated ISR the way proj_lab11a filters them for the
+//!         offset calibration: a loop over a handle array with two
+//!         FILTER_FO_run() calls per phase.  The bank filters the same
+//!         inputs with two FILTER_BANK_runFo() calls.  The second-order
+//!         filters are compared the same way.
+//!
+//!         The outputs of both have to be identical in every ISR, the
+//!         program prints the host time per ISR of both.  With -c it
+//!         returns an error when an output differs.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sw/modules/math/src/32b/math.h"
+#include "sw/modules/filter/src/32b/filter_fo.h"
+#include "sw/modules/filter/src/32b/filter_so.h"
+#include "sw/modules/filter/src/32b/filter_bank.h"
+
+
+// **************************************************************************
+// the defines
+
+#define BENCH_NUM_PHASES        (3)         // per current and voltage
+#define BENCH_NUM_CHANNELS      (2 * BENCH_NUM_PHASES)
+#define BENCH_NUM_SAMPLES       (4096)      // the length of the input table, a power of 2
+#define BENCH_DEFAULT_NUM_ISRS  (20000000)
+#define BENCH_FS_Hz             (15000.0)   // the ISR rate of the offset filters
+#define BENCH_FC_Hz             (20.0)      // the cut-off frequency
+
+
+// **************************************************************************
+// the globals
+
+MATH_vec3 gInputI[BENCH_NUM_SAMPLES];
+
+MATH_vec3 gInputV[BENCH_NUM_SAMPLES];
+
+FILTER_FO_Handle gFoHandle[BENCH_NUM_CHANNELS];
+
+FILTER_FO_Obj gFo[BENCH_NUM_CHANNELS];
+
+FILTER_SO_Handle gSoHandle[BENCH_NUM_CHANNELS];
+
+FILTER_SO_Obj gSo[BENCH_NUM_CHANNELS];
+
+FILTER_BANK_Handle gBankHandle;
+
+FILTER_BANK_Obj gBank;
+
+volatile _iq gSink;
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Gets the monotonic time
+//! \return    The time, nsec
+static double BENCH_getTime_ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC,&now);
+
+  return((double)now.tv_sec * 1.0e9 + (double)now.tv_nsec);
+} // end of BENCH_getTime_ns() function
+
+
+//! \brief     Sets up the per channel filters and the bank with the same coefficients
+//! \param[in] flag_so  Denotes the second-order filters
+static void BENCH_setup(const bool flag_so)
+{
+  double wc = tan(MATH_PI * BENCH_FC_Hz / BENCH_FS_Hz);
+  _iq a1,a2,b0,b1,b2;
+  uint_least8_t cnt;
+
+  if(flag_so)
+    {
+      // the bilinear transform of a second-order Butterworth low-pass
+      double k = 1.0 / (1.0 + sqrt(2.0) * wc + wc * wc);
+
+      b0 = _IQ(wc * wc * k);
+      b1 = _IQ(2.0 * wc * wc * k);
+      b2 = _IQ(wc * wc * k);
+      a1 = _IQ(2.0 * (wc * wc - 1.0) * k);
+      a2 = _IQ((1.0 - sqrt(2.0) * wc + wc * wc) * k);
+    }
+  else
+    {
+      // the pole of proj_lab11a, form y = b0*x - a1*y
+      a1 = _IQ(-exp(-2.0 * MATH_PI * BENCH_FC_Hz / BENCH_FS_Hz));
+      a2 = _IQ(0.0);
+      b0 = _IQ(1.0) + a1;
+      b1 = _IQ(0.0);
+      b2 = _IQ(0.0);
+    }
+
+  for(cnt=0;cnt<BENCH_NUM_CHANNELS;cnt++)
+    {
+      gFoHandle[cnt] = FILTER_FO_init(&gFo[cnt],sizeof(gFo[0]));
+      FILTER_FO_setDenCoeffs(gFoHandle[cnt],a1);
+      FILTER_FO_setNumCoeffs(gFoHandle[cnt],b0,b1);
+      FILTER_FO_setInitialConditions(gFoHandle[cnt],_IQ(0.0),_IQ(0.0));
+
+      gSoHandle[cnt] = FILTER_SO_init(&gSo[cnt],sizeof(gSo[0]));
+      FILTER_SO_setDenCoeffs(gSoHandle[cnt],a1,a2);
+      FILTER_SO_setNumCoeffs(gSoHandle[cnt],b0,b1,b2);
+      FILTER_SO_setInitialConditions(gSoHandle[cnt],_IQ(0.0),_IQ(0.0),_IQ(0.0),_IQ(0.0));
+    }
+
+  gBankHandle = FILTER_BANK_init(&gBank,sizeof(gBank));
+  FILTER_BANK_setDenCoeffs(gBankHandle,a1,a2);
+  FILTER_BANK_setNumCoeffs(gBankHandle,b0,b1,b2);
+
+  return;
+} // end of BENCH_setup() function
+
+
+//! \brief     Runs the per channel filters and the bank side by side
+//! \param[in] flag_so  Denotes the second-order filters
+//! \return    The number of ISRs with differing outputs
+static uint_least32_t BENCH_compare(const bool flag_so,const uint_least32_t numIsrs)
+{
+  uint_least32_t numErrors = 0;
+  uint_least32_t isrCnt;
+  uint_least8_t cnt;
+
+  BENCH_setup(flag_so);
+
+  for(isrCnt=0;isrCnt<numIsrs;isrCnt++)
+    {
+      const MATH_vec3 *pI = &gInputI[isrCnt & (BENCH_NUM_SAMPLES - 1)];
+      const MATH_vec3 *pV = &gInputV[isrCnt & (BENCH_NUM_SAMPLES - 1)];
+      bool flag_error = false;
+
+      for(cnt=0;cnt<BENCH_NUM_PHASES;cnt++)
+        {
+          if(flag_so)
+            {
+              FILTER_SO_run(gSoHandle[cnt],pI->value[cnt]);
+              FILTER_SO_run(gSoHandle[cnt + 3],pV->value[cnt]);
+            }
+          else
+            {
+              FILTER_FO_run(gFoHandle[cnt],pI->value[cnt]);
+              FILTER_FO_run(gFoHandle[cnt + 3],pV->value[cnt]);
+            }
+        }
+
+      if(flag_so)
+        {
+          FILTER_BANK_runSo(gBankHandle,0,BENCH_NUM_PHASES,pI->value);
+          FILTER_BANK_runSo(gBankHandle,3,BENCH_NUM_PHASES,pV->value);
+        }
+      else
+        {
+          FILTER_BANK_runFo(gBankHandle,0,BENCH_NUM_PHASES,pI->value);
+          FILTER_BANK_runFo(gBankHandle,3,BENCH_NUM_PHASES,pV->value);
+        }
+
+      for(cnt=0;cnt<BENCH_NUM_CHANNELS;cnt++)
+        {
+          _iq y1 = flag_so ? FILTER_SO_get_y1(gSoHandle[cnt]) : FILTER_FO_get_y1(gFoHandle[cnt]);
+
+          if(y1 != FILTER_BANK_get_y1(gBankHandle,cnt))
+            {
+              flag_error = true;
+            }
+        }
+
+      numErrors += flag_error ? 1 : 0;
+    }
+
+  return(numErrors);
+} // end of BENCH_compare() function
+
+
+//! \brief     Times the per channel filters
+//! \param[in] flag_so  Denotes the second-order filters
+//! \return    The host time per ISR, nsec
+static double BENCH_timeObjects(const bool flag_so,const uint_least32_t numIsrs)
+{
+  double start_ns;
+  uint_least32_t isrCnt;
+  uint_least8_t cnt;
+
+  BENCH_setup(flag_so);
+
+  start_ns = BENCH_getTime_ns();
+
+  for(isrCnt=0;isrCnt<numIsrs;isrCnt++)
+    {
+      const MATH_vec3 *pI = &gInputI[isrCnt & (BENCH_NUM_SAMPLES - 1)];
+      const MATH_vec3 *pV = &gInputV[isrCnt & (BENCH_NUM_SAMPLES - 1)];
+
+      for(cnt=0;cnt<BENCH_NUM_PHASES;cnt++)
+        {
+          if(flag_so)
+            {
+              FILTER_SO_run(gSoHandle[cnt],pI->value[cnt]);
+              FILTER_SO_run(gSoHandle[cnt + 3],pV->value[cnt]);
+            }
+          else
+            {
+              FILTER_FO_run(gFoHandle[cnt],pI->value[cnt]);
+              FILTER_FO_run(gFoHandle[cnt + 3],pV->value[cnt]);
+            }
+        }
+    }
+
+  gSink = flag_so ? FILTER_SO_get_y1(gSoHandle[0]) : FILTER_FO_get_y1(gFoHandle[0]);
+
+  return((BENCH_getTime_ns() - start_ns) / (double)numIsrs);
+} // end of BENCH_timeObjects() function
+
+
+//! \brief     Times the filter bank
+//! \param[in] flag_so  Denotes the second-order filters
+//! \return    The host time per ISR, nsec
+static double BENCH_timeBank(const bool flag_so,const uint_least32_t numIsrs)
+{
+  double start_ns;
+  uint_least32_t isrCnt;
+
+  BENCH_setup(flag_so);
+
+  start_ns = BENCH_getTime_ns();
+
+  for(isrCnt=0;isrCnt<numIsrs;isrCnt++)
+    {
+      const MATH_vec3 *pI = &gInputI[isrCnt & (BENCH_NUM_SAMPLES - 1)];
+      const MATH_vec3 *pV = &gInputV[isrCnt & (BENCH_NUM_SAMPLES - 1)];
+
+      if(flag_so)
+        {
+          FILTER_BANK_runSo(gBankHandle,0,BENCH_NUM_PHASES,pI->value);
+          FILTER_BANK_runSo(gBankHandle,3,BENCH_NUM_PHASES,pV->value);
+        }
+      else
+        {
+          FILTER_BANK_runFo(gBankHandle,0,BENCH_NUM_PHASES,pI->value);
+          FILTER_BANK_runFo(gBankHandle,3,BENCH_NUM_PHASES,pV->value);
+        }
+    }
+
+  gSink = FILTER_BANK_get_y1(gBankHandle,0);
+
+  return((BENCH_getTime_ns() - start_ns) / (double)numIsrs);
+} // end of BENCH_timeBank() function
+
+
+//! \brief     Prints the command line options
+//! \param[in] pName  The program name
+static void BENCH_usage(const char *pName)
+{
+  fprintf(stderr,"usage: %s [-n isrs] [-c]\n",pName);
+  fprintf(stderr,"  -n  number of timed ISRs, default %d\n",BENCH_DEFAULT_NUM_ISRS);
+  fprintf(stderr,"  -c  check, return an error when the outputs differ\n");
+
+  return;
+} // end of BENCH_usage() function
+
+
+int main(int argc,char *argv[])
+{
+  uint_least32_t numIsrs = BENCH_DEFAULT_NUM_ISRS;
+  bool flag_check = false;
+  uint_least32_t numErrors = 0;
+  uint_least32_t cnt;
+  int opt;
+
+  while((opt = getopt(argc,argv,"n:ch")) != -1)
+    {
+      switch(opt)
+        {
+          case 'n':
+            numIsrs = (uint_least32_t)atol(optarg);
+            break;
+          case 'c':
+            flag_check = true;
+            break;
+          default:
+            BENCH_usage(argv[0]);
+            return(EXIT_FAILURE);
+        }
+    }
+
+  // offset plus a 50 Hz fundamental plus PWM ripple
+  srand(1);
+
+  for(cnt=0;cnt<BENCH_NUM_SAMPLES;cnt++)
+    {
+      uint_least8_t phase;
+
+      for(phase=0;phase<BENCH_NUM_PHASES;phase++)
+        {
+          double angle_rad = MATH_TWO_PI * (50.0 * (double)cnt / BENCH_FS_Hz - (double)phase / 3.0);
+          double ripple = ((double)rand() / (double)RAND_MAX - 0.5) * 0.02;
+
+          gInputI[cnt].value[phase] = _IQ(0.01 + 0.5 * cos(angle_rad) + ripple);
+          gInputV[cnt].value[phase] = _IQ(0.33 + 0.3 * cos(angle_rad) + ripple);
+        }
+    }
+
+  printf("filter    objects ns/ISR    bank ns/ISR    ISRs differing\n");
+
+  for(cnt=0;cnt<2;cnt++)
+    {
+      bool flag_so = (cnt == 1);
+      uint_least32_t numDiffs = BENCH_compare(flag_so,BENCH_NUM_SAMPLES * 16);
+      double objects_ns = BENCH_timeObjects(flag_so,numIsrs);
+      double bank_ns = BENCH_timeBank(flag_so,numIsrs);
+
+      printf("%-9s %15.2f %14.2f %17lu\n",flag_so ? "FILTER_SO" : "FILTER_FO",objects_ns,bank_ns,(unsigned long)numDiffs);
+
+      numErrors += numDiffs;
+    }
+
+  if(flag_check && (numErrors > 0))
+    {
+      fprintf(stderr,"FAIL: the bank outputs differ from the per channel filters\n");
+      return(EXIT_FAILURE);
+    }
+
+  return(EXIT_SUCCESS);
+} // end of main() function
+
+// end of file
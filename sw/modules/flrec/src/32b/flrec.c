@@ -0,0 +1,506 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/flrec/src/32b/flrec.c
+//! \brief  Portable C code.  These functions define the
+//!         flight recorder (FLREC) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/flrec/src/32b/flrec.h"
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Gets the first word of a slot
+//! \param[in] obj      The recorder object
+//! \param[in] slotNum  The slot number
+//! \return    The pointer to the first word of the slot
+static uint16_t *FLREC_getSlotAddr(FLREC_Obj *obj,const uint_least16_t slotNum)
+{
+  uint_least16_t sectorNum = slotNum / obj->numSlotsPerSector;
+  uint_least16_t slotInSector = slotNum - (sectorNum * obj->numSlotsPerSector);
+
+  return(obj->pFlash + ((uint32_t)sectorNum * obj->sectorSize_words) +
+         ((uint32_t)slotInSector * obj->slotSize_words));
+} // end of FLREC_getSlotAddr() function
+
+
+//! \brief     Checks that a slot is erased
+//! \param[in] obj      The recorder object
+//! \param[in] slotNum  The slot number
+//! \return    true when all words of the slot are erased
+static bool FLREC_isErased(FLREC_Obj *obj,const uint_least16_t slotNum)
+{
+  const uint16_t *pSlot = FLREC_getSlotAddr(obj,slotNum);
+  uint_least16_t cnt;
+
+  for(cnt=0;cnt<obj->slotSize_words;cnt++)
+    {
+      if(pSlot[cnt] != FLREC_ERASED_WORD)
+        {
+          return(false);
+        }
+    }
+
+  return(true);
+} // end of FLREC_isErased() function
+
+
+//! \brief     Finds the slot of the next record, the first erased slot from the
+//!            given one on, or the first slot of the next sector
+//! \param[in] obj        The recorder object
+//! \param[in] startSlot  The slot after the newest record
+static void FLREC_findNextSlot(FLREC_Obj *obj,const uint_least16_t startSlot)
+{
+  uint_least16_t slotNum = startSlot;
+  uint_least16_t cnt;
+
+  for(cnt=0;cnt<obj->numSlots;cnt++)
+    {
+      if(FLREC_isErased(obj,slotNum))
+        {
+          obj->nextSlot = slotNum;
+          obj->flag_nextErased = true;
+          return;
+        }
+
+      // a sector with older records is erased as a whole
+      if((slotNum % obj->numSlotsPerSector) == 0)
+        {
+          break;
+        }
+
+      slotNum++;
+
+      if(slotNum >= obj->numSlots)
+        {
+          slotNum = 0;
+        }
+    }
+
+  obj->nextSlot = slotNum;
+  obj->flag_nextErased = false;
+
+  return;
+} // end of FLREC_findNextSlot() function
+
+
+//! \brief     Updates the timer based statistics
+//! \param[in] obj         The recorder object
+//! \param[in] start_cnts  The timer count at the start of the call
+static void FLREC_updateTime(FLREC_Obj *obj,const uint32_t start_cnts)
+{
+  uint32_t end_cnts = obj->readCntFxn();
+  uint32_t run_cnts;
+  uint32_t elapsed_cnts;
+
+  // NOTE: count down timer
+  run_cnts = (start_cnts >= end_cnts) ? (start_cnts - end_cnts) :
+             (start_cnts + obj->timerPeriod_cnts + 1 - end_cnts);
+
+  elapsed_cnts = (obj->cnt_z1 >= end_cnts) ? (obj->cnt_z1 - end_cnts) :
+                 (obj->cnt_z1 + obj->timerPeriod_cnts + 1 - end_cnts);
+
+  if(run_cnts > obj->maxRun_cnts)
+    {
+      obj->maxRun_cnts = run_cnts;
+    }
+
+  obj->commit_cnts += elapsed_cnts;
+  obj->cnt_z1 = end_cnts;
+
+  return;
+} // end of FLREC_updateTime() function
+
+
+uint16_t FLREC_computeCrc(uint16_t crc,const uint16_t *pData,const uint_least16_t numWords)
+{
+  uint_least16_t cnt;
+  uint_least16_t bit;
+
+  for(cnt=0;cnt<numWords;cnt++)
+    {
+      uint16_t data = pData[cnt];
+
+      for(bit=0;bit<16;bit++)
+        {
+          bool flag_xor = ((crc ^ data) & 0x8000) != 0;
+
+          crc = (uint16_t)(crc << 1);
+          data = (uint16_t)(data << 1);
+
+          if(flag_xor)
+            {
+              crc ^= 0x1021;
+            }
+        }
+    }
+
+  return(crc);
+} // end of FLREC_computeCrc() function
+
+
+bool FLREC_isValid(FLREC_Handle handle,const uint_least16_t slotNum)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+  const uint16_t *pSlot = FLREC_getSlotAddr(obj,slotNum);
+  uint32_t numFrameWords;
+  uint16_t crc;
+
+  if((pSlot[FLREC_HDR_MAGIC] != FLREC_MAGIC) || (pSlot[FLREC_HDR_VERSION] != FLREC_VERSION))
+    {
+      return(false);
+    }
+
+  numFrameWords = (uint32_t)pSlot[FLREC_HDR_NUM_CHANNELS] * pSlot[FLREC_HDR_NUM_FRAMES] * 2;
+
+  if((pSlot[FLREC_HDR_NUM_CHANNELS] > TRIGLOG_MAX_CHANNELS) ||
+     ((numFrameWords + FLREC_HEADER_WORDS) > obj->slotSize_words))
+    {
+      return(false);
+    }
+
+  crc = FLREC_computeCrc(0xFFFF,&pSlot[FLREC_HDR_VERSION],FLREC_HDR_CRC - FLREC_HDR_VERSION);
+  crc = FLREC_computeCrc(crc,&pSlot[FLREC_HEADER_WORDS],(uint_least16_t)numFrameWords);
+
+  return(crc == pSlot[FLREC_HDR_CRC]);
+} // end of FLREC_isValid() function
+
+
+const uint16_t *FLREC_getSlot(FLREC_Handle handle,const uint_least16_t slotNum)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+  return(FLREC_getSlotAddr(obj,slotNum));
+} // end of FLREC_getSlot() function
+
+
+FLREC_Handle FLREC_init(void *pMemory,const size_t numBytes)
+{
+  FLREC_Handle handle;
+  FLREC_Obj *obj;
+
+
+  if(numBytes < sizeof(FLREC_Obj))
+    return((FLREC_Handle)NULL);
+
+  // assign the handle
+  handle = (FLREC_Handle)pMemory;
+
+  obj = (FLREC_Obj *)handle;
+
+  memset(obj,0,sizeof(FLREC_Obj));
+
+  obj->nextSeq = 1;
+
+  return(handle);
+} // end of FLREC_init() function
+
+
+bool FLREC_prepare(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+  uint_least16_t firstSlot;
+  uint_least16_t cnt;
+
+
+  if(obj->flag_nextErased || (obj->state != FLREC_State_Idle) || (obj->numSlots == 0))
+    {
+      return(obj->flag_nextErased);
+    }
+
+  // the records of the sector are lost
+  firstSlot = obj->nextSlot - (obj->nextSlot % obj->numSlotsPerSector);
+
+  for(cnt=0;cnt<obj->numSlotsPerSector;cnt++)
+    {
+      if(FLREC_isValid(handle,firstSlot + cnt) && (obj->numRecords > 0))
+        {
+          obj->numRecords--;
+        }
+    }
+
+  obj->numErases++;
+
+  if(!obj->eraseFxn(FLREC_getSlotAddr(obj,firstSlot)))
+    {
+      obj->numErrors++;
+    }
+
+  FLREC_findNextSlot(obj,obj->nextSlot);
+
+  return(obj->flag_nextErased);
+} // end of FLREC_prepare() function
+
+
+FLREC_State_e FLREC_run(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+  uint16_t *pSlot = FLREC_getSlotAddr(obj,obj->nextSlot);
+  uint32_t start_cnts = 0;
+  bool flag_ok = true;
+
+
+  if(obj->state == FLREC_State_Idle)
+    {
+      return(obj->state);
+    }
+
+  if(obj->readCntFxn != NULL)
+    {
+      start_cnts = obj->readCntFxn();
+    }
+
+  if(obj->state == FLREC_State_Frames)
+    {
+      // one frame per call
+      uint_least16_t numFrameWords = TRIGLOG_getNumChannels(obj->triglogHandle) * 2;
+      const uint16_t *pFrame = (const uint16_t *)TRIGLOG_getCaptureFrame(obj->triglogHandle,obj->frameNumber);
+
+      if(pFrame == NULL)
+        {
+          // the capture was lost, the logger was armed again
+          flag_ok = false;
+        }
+      else
+        {
+          uint16_t *pDst = pSlot + FLREC_HEADER_WORDS + ((uint32_t)obj->frameNumber * numFrameWords);
+
+          obj->crc = FLREC_computeCrc(obj->crc,pFrame,numFrameWords);
+
+          flag_ok = obj->programFxn(pDst,pFrame,numFrameWords);
+
+          obj->frameNumber++;
+
+          if(obj->frameNumber >= obj->numFrames)
+            {
+              obj->state = FLREC_State_Header;
+            }
+        }
+    }
+  else
+    {
+      // the header, the magic word last
+      obj->header[FLREC_HDR_CRC] = obj->crc;
+
+      flag_ok = obj->programFxn(&pSlot[FLREC_HDR_VERSION],&obj->header[FLREC_HDR_VERSION],FLREC_HDR_CRC);
+
+      if(flag_ok)
+        {
+          flag_ok = obj->programFxn(&pSlot[FLREC_HDR_MAGIC],&obj->header[FLREC_HDR_MAGIC],1);
+        }
+
+      if(flag_ok)
+        {
+          obj->numCommits++;
+          obj->numRecords++;
+          obj->nextSeq++;
+          obj->state = FLREC_State_Idle;
+        }
+    }
+
+  if(obj->readCntFxn != NULL)
+    {
+      FLREC_updateTime(obj,start_cnts);
+    }
+
+  if(!flag_ok)
+    {
+      obj->numErrors++;
+      obj->state = FLREC_State_Idle;
+    }
+
+  // the next record goes to the next erased slot, a failed slot is skipped
+  if(obj->state == FLREC_State_Idle)
+    {
+      uint_least16_t slotNum = obj->nextSlot + 1;
+
+      if(slotNum >= obj->numSlots)
+        {
+          slotNum = 0;
+        }
+
+      FLREC_findNextSlot(obj,slotNum);
+    }
+
+  return(obj->state);
+} // end of FLREC_run() function
+
+
+uint_least16_t FLREC_scan(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+  uint_least16_t startSlot = 0;
+  uint32_t newestSeq = 0;
+  uint_least16_t slotNum;
+
+
+  obj->numRecords = 0;
+
+  for(slotNum=0;slotNum<obj->numSlots;slotNum++)
+    {
+      if(FLREC_isValid(handle,slotNum))
+        {
+          const uint16_t *pSlot = FLREC_getSlotAddr(obj,slotNum);
+          uint32_t seq = ((uint32_t)pSlot[FLREC_HDR_SEQ + 1] << 16) | pSlot[FLREC_HDR_SEQ];
+
+          obj->numRecords++;
+
+          if(seq >= newestSeq)
+            {
+              newestSeq = seq;
+              startSlot = slotNum + 1;
+            }
+        }
+    }
+
+  if(startSlot >= obj->numSlots)
+    {
+      startSlot = 0;
+    }
+
+  obj->nextSeq = newestSeq + 1;
+
+  FLREC_findNextSlot(obj,startSlot);
+
+  return(obj->numRecords);
+} // end of FLREC_scan() function
+
+
+uint_least16_t FLREC_setParams(FLREC_Handle handle,
+                               uint16_t *pFlash,
+                               const uint32_t sectorSize_words,
+                               const uint_least16_t numSectors,
+                               const uint_least16_t maxRecord_words,
+                               const FLREC_EraseFxn eraseFxn,
+                               const FLREC_ProgramFxn programFxn)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+
+  obj->pFlash = pFlash;
+  obj->sectorSize_words = sectorSize_words;
+  obj->numSectors = numSectors;
+  obj->slotSize_words = maxRecord_words;
+  obj->eraseFxn = eraseFxn;
+  obj->programFxn = programFxn;
+  obj->state = FLREC_State_Idle;
+
+  if((maxRecord_words < FLREC_HEADER_WORDS) || (maxRecord_words > sectorSize_words))
+    {
+      obj->numSlotsPerSector = 0;
+      obj->numSlots = 0;
+      obj->flag_nextErased = false;
+
+      return(0);
+    }
+
+  obj->numSlotsPerSector = (uint_least16_t)(sectorSize_words / maxRecord_words);
+  obj->numSlots = obj->numSlotsPerSector * numSectors;
+
+  return(obj->numSlots);
+} // end of FLREC_setParams() function
+
+
+void FLREC_setTimer(FLREC_Handle handle,
+                    const FLREC_ReadCntFxn readCntFxn,
+                    const uint32_t timerPeriod_cnts)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+
+  obj->readCntFxn = readCntFxn;
+  obj->timerPeriod_cnts = timerPeriod_cnts;
+
+  return;
+} // end of FLREC_setTimer() function
+
+
+status FLREC_start(FLREC_Handle handle,
+                   TRIGLOG_Handle triglogHandle,
+                   const uint32_t framePeriod_usec)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+  uint_least16_t numChannels = TRIGLOG_getNumChannels(triglogHandle);
+  uint_least16_t numFrames = TRIGLOG_getNumCaptureFrames(triglogHandle);
+  uint32_t seq = obj->nextSeq;
+  int32_t trigValue = TRIGLOG_getTrigValue(triglogHandle);
+  uint_least16_t cnt;
+
+
+  if((obj->state != FLREC_State_Idle) || !obj->flag_nextErased || (numFrames == 0) ||
+     (((uint32_t)numChannels * numFrames * 2 + FLREC_HEADER_WORDS) > obj->slotSize_words))
+    {
+      return(ERROR);
+    }
+
+  // the unused header words stay erased
+  for(cnt=0;cnt<FLREC_HEADER_WORDS;cnt++)
+    {
+      obj->header[cnt] = FLREC_ERASED_WORD;
+    }
+
+  obj->header[FLREC_HDR_MAGIC] = FLREC_MAGIC;
+  obj->header[FLREC_HDR_VERSION] = FLREC_VERSION;
+  obj->header[FLREC_HDR_SEQ] = (uint16_t)(seq & 0xFFFF);
+  obj->header[FLREC_HDR_SEQ + 1] = (uint16_t)(seq >> 16);
+  obj->header[FLREC_HDR_NUM_CHANNELS] = numChannels;
+  obj->header[FLREC_HDR_NUM_FRAMES] = numFrames;
+  obj->header[FLREC_HDR_TRIG_FRAME] = TRIGLOG_getTrigFrameNumber(triglogHandle);
+  obj->header[FLREC_HDR_TRIG_SOURCE] = TRIGLOG_getTrigSource(triglogHandle);
+  obj->header[FLREC_HDR_TRIG_VALUE] = (uint16_t)((uint32_t)trigValue & 0xFFFF);
+  obj->header[FLREC_HDR_TRIG_VALUE + 1] = (uint16_t)((uint32_t)trigValue >> 16);
+  obj->header[FLREC_HDR_FRAME_PERIOD] = (uint16_t)(framePeriod_usec & 0xFFFF);
+  obj->header[FLREC_HDR_FRAME_PERIOD + 1] = (uint16_t)(framePeriod_usec >> 16);
+
+  obj->crc = FLREC_computeCrc(0xFFFF,&obj->header[FLREC_HDR_VERSION],FLREC_HDR_CRC - FLREC_HDR_VERSION);
+
+  obj->triglogHandle = triglogHandle;
+  obj->numFrames = numFrames;
+  obj->frameNumber = 0;
+  obj->commit_cnts = 0;
+  obj->state = FLREC_State_Frames;
+
+  if(obj->readCntFxn != NULL)
+    {
+      obj->cnt_z1 = obj->readCntFxn();
+    }
+
+  return(OK);
+} // end of FLREC_start() function
+
+// end of file
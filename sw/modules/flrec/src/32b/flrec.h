@@ -0,0 +1,418 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _FLREC_H_
+#define _FLREC_H_
+
+//! \file   modules/flrec/src/32b/flrec.h
+//! \brief  Contains the public interface to the
+//!         flight recorder (FLREC) module routines
+//!
+//!         The flight recorder keeps the captures of a triggered data logger
+//!         (TRIGLOG) across a reset.  A complete capture is programmed into
+//!         one slot of a reserved flash region as a record of a header and
+//!         the frames of the capture, the oldest frame first.
+//!
+//!         The slots are used in turn, so the sectors wear evenly.  A record
+//!         only goes to an erased slot.  When the next slot is the first slot
+//!         of a sector that holds older records, the whole sector is erased
+//!         by FLREC_prepare(), which takes the sector erase time of the flash
+//!         and is called when the motor is stopped, e.g. before the
+//!         interrupts are enabled.  With two or more sectors the records of
+//!         the other sectors survive the erase.
+//!
+//!         FLREC_run() programs one frame or the header per call, so the
+//!         time of a call is bounded by the programming time of
+//!         FLREC_MAX_WORDS_PER_RUN words.  The magic word of the header is
+//!         programmed last, a record cut short by a reset is not valid.
+//!         The header has a CRC of its words and of the frames, and a
+//!         sequence number that orders the records.
+//!
+//!         The layout of a record, 16-bit words, a 32-bit value low word
+//!         first:
+//!
+//!           0      FLREC_MAGIC
+//!           1      FLREC_VERSION
+//!           2,3    sequence number
+//!           4      number of channels
+//!           5      number of frames
+//!           6      frame number of the trigger frame
+//!           7      trigger source, TRIGLOG_TRIG_SOFTWARE for TRIGLOG_trigger()
+//!           8,9    trigger value or cause
+//!           10,11  frame period, usec
+//!           12     CRC-16-CCITT of the words 1 to 11 and of the frames
+//!           13-15  erased
+//!           16...  the frames, the 32-bit channels of a frame next to each other
+//!
+//!         The host tool in modules/flrec/src/32b/host extracts the records
+//!         from an image of the flash region.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+// modules
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/triglog/src/32b/triglog.h"
+
+
+//!
+//!
+//! \defgroup FLREC FLREC
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the first word of a valid record
+//!
+#define FLREC_MAGIC                   (0x5246)
+
+//! \brief Defines the version of the record layout
+//!
+#define FLREC_VERSION                 (1)
+
+//! \brief Defines the value of an erased flash word
+//!
+#define FLREC_ERASED_WORD             (0xFFFF)
+
+//! \brief Defines the number of words of the record header
+//!
+#define FLREC_HEADER_WORDS            (16)
+
+//! \brief Defines the header words
+//!
+#define FLREC_HDR_MAGIC               (0)
+#define FLREC_HDR_VERSION             (1)
+#define FLREC_HDR_SEQ                 (2)
+#define FLREC_HDR_NUM_CHANNELS        (4)
+#define FLREC_HDR_NUM_FRAMES          (5)
+#define FLREC_HDR_TRIG_FRAME          (6)
+#define FLREC_HDR_TRIG_SOURCE         (7)
+#define FLREC_HDR_TRIG_VALUE          (8)
+#define FLREC_HDR_FRAME_PERIOD        (10)
+#define FLREC_HDR_CRC                 (12)
+
+//! \brief Defines the largest number of words programmed by one call of FLREC_run()
+//!
+#define FLREC_MAX_WORDS_PER_RUN       (2 * TRIGLOG_MAX_CHANNELS)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Enumeration for the recorder states
+//!
+typedef enum
+{
+  FLREC_State_Idle=0,           //!< no record is programmed
+  FLREC_State_Frames,           //!< programming the frames
+  FLREC_State_Header            //!< programming the header
+} FLREC_State_e;
+
+
+//! \brief Defines the function that erases a flash sector
+//! \param[in] pSector  The pointer to the first word of the sector
+//! \return    true on success
+typedef bool (*FLREC_EraseFxn)(uint16_t *pSector);
+
+
+//! \brief Defines the function that programs flash words
+//! \param[in] pDst      The pointer to the erased flash words
+//! \param[in] pSrc      The pointer to the words
+//! \param[in] numWords  The number of words
+//! \return    true on success
+typedef bool (*FLREC_ProgramFxn)(uint16_t *pDst,const uint16_t *pSrc,const uint_least16_t numWords);
+
+
+//! \brief Defines the timer read function
+//!
+typedef uint32_t (*FLREC_ReadCntFxn)(void);
+
+
+//! \brief Defines the flight recorder (FLREC) object
+//!
+typedef struct _FLREC_Obj_
+{
+  uint16_t          *pFlash;            //!< the pointer to the first sector of the flash region
+  uint32_t           sectorSize_words;  //!< the number of words of a sector
+  uint_least16_t     numSectors;        //!< the number of sectors
+  uint_least16_t     slotSize_words;    //!< the number of words of a slot
+  uint_least16_t     numSlotsPerSector; //!< the number of slots of a sector
+  uint_least16_t     numSlots;          //!< the number of slots
+
+  FLREC_EraseFxn     eraseFxn;          //!< the function that erases a sector
+  FLREC_ProgramFxn   programFxn;        //!< the function that programs words
+  FLREC_ReadCntFxn   readCntFxn;        //!< the function that reads the timer, NULL without time statistics
+  uint32_t           timerPeriod_cnts;  //!< the timer period register, cnts
+
+  uint_least16_t     numRecords;        //!< the number of valid records
+  uint32_t           nextSeq;           //!< the sequence number of the next record
+  uint_least16_t     nextSlot;          //!< the slot of the next record
+  bool               flag_nextErased;   //!< denotes that the next slot is erased
+
+  FLREC_State_e      state;             //!< the recorder state
+  TRIGLOG_Handle     triglogHandle;     //!< the logger of the record being programmed
+  uint_least16_t     numFrames;         //!< the number of frames of the record being programmed
+  uint_least16_t     frameNumber;       //!< the next frame to program
+  uint16_t           crc;               //!< the CRC of the record being programmed
+  uint16_t           header[FLREC_HEADER_WORDS];  //!< the header of the record being programmed
+  uint32_t           cnt_z1;            //!< the timer count of the previous call, cnts
+
+  uint32_t           numCommits;        //!< the number of records programmed
+  uint32_t           numErrors;         //!< the number of failed programs and erases
+  uint32_t           numErases;         //!< the number of sector erases
+  uint32_t           maxRun_cnts;       //!< the longest call of FLREC_run(), cnts
+  uint32_t           commit_cnts;       //!< the time from FLREC_start() to the end of the last record, cnts
+} FLREC_Obj;
+
+
+//! \brief Defines the FLREC handle
+//!
+typedef struct _FLREC_Obj_ *FLREC_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Gets the recorder state
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    The recorder state
+static inline FLREC_State_e FLREC_getState(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+  return(obj->state);
+} // end of FLREC_getState() function
+
+
+//! \brief     Denotes that a record can be started without an erase
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    true when the next slot is erased
+static inline bool FLREC_isReady(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+  return(obj->flag_nextErased);
+} // end of FLREC_isReady() function
+
+
+//! \brief     Gets the number of valid records
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    The number of records
+static inline uint_least16_t FLREC_getNumRecords(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+  return(obj->numRecords);
+} // end of FLREC_getNumRecords() function
+
+
+//! \brief     Gets the number of slots
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    The number of slots
+static inline uint_least16_t FLREC_getNumSlots(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+  return(obj->numSlots);
+} // end of FLREC_getNumSlots() function
+
+
+//! \brief     Gets the sequence number of the next record
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    The sequence number
+static inline uint32_t FLREC_getNextSeq(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+  return(obj->nextSeq);
+} // end of FLREC_getNextSeq() function
+
+
+//! \brief     Gets the number of records programmed since the initialization
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    The number of records
+static inline uint32_t FLREC_getNumCommits(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+  return(obj->numCommits);
+} // end of FLREC_getNumCommits() function
+
+
+//! \brief     Gets the number of failed programs and erases
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    The number of errors
+static inline uint32_t FLREC_getNumErrors(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+  return(obj->numErrors);
+} // end of FLREC_getNumErrors() function
+
+
+//! \brief     Gets the number of sector erases
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    The number of erases
+static inline uint32_t FLREC_getNumErases(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+  return(obj->numErases);
+} // end of FLREC_getNumErases() function
+
+
+//! \brief     Gets the longest call of FLREC_run()
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    The time, cnts
+static inline uint32_t FLREC_getMaxRun_cnts(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+  return(obj->maxRun_cnts);
+} // end of FLREC_getMaxRun_cnts() function
+
+
+//! \brief     Gets the time from FLREC_start() to the end of the last record
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    The time, cnts
+static inline uint32_t FLREC_getCommit_cnts(FLREC_Handle handle)
+{
+  FLREC_Obj *obj = (FLREC_Obj *)handle;
+
+  return(obj->commit_cnts);
+} // end of FLREC_getCommit_cnts() function
+
+
+//! \brief     Computes the CRC-16-CCITT of 16-bit words, the high byte of a word first
+//! \param[in] crc       The CRC of the previous words, 0xFFFF for the first
+//! \param[in] pData     The pointer to the words
+//! \param[in] numWords  The number of words
+//! \return    The CRC
+extern uint16_t FLREC_computeCrc(uint16_t crc,const uint16_t *pData,const uint_least16_t numWords);
+
+
+//! \brief     Checks that a slot holds a valid record
+//! \param[in] handle   The flight recorder (FLREC) handle
+//! \param[in] slotNum  The slot number
+//! \return    true for a valid record
+extern bool FLREC_isValid(FLREC_Handle handle,const uint_least16_t slotNum);
+
+
+//! \brief     Gets the first word of a slot
+//! \param[in] handle   The flight recorder (FLREC) handle
+//! \param[in] slotNum  The slot number
+//! \return    The pointer to the first word of the slot
+extern const uint16_t *FLREC_getSlot(FLREC_Handle handle,const uint_least16_t slotNum);
+
+
+//! \brief     Initializes the flight recorder (FLREC) module
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The flight recorder (FLREC) handle
+extern FLREC_Handle FLREC_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Prepares the next slot, erases its sector when it holds older records
+//! \details   Takes the sector erase time, call when the motor is stopped
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    true when the next slot is erased
+extern bool FLREC_prepare(FLREC_Handle handle);
+
+
+//! \brief     Runs the recorder, programs one frame or the header of a started record
+//! \details   Call from the background loop
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    The recorder state after the call
+extern FLREC_State_e FLREC_run(FLREC_Handle handle);
+
+
+//! \brief     Scans the flash region for the valid records and finds the next slot
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    The number of valid records
+extern uint_least16_t FLREC_scan(FLREC_Handle handle);
+
+
+//! \brief     Sets the flash region and the flash functions
+//! \param[in] handle            The flight recorder (FLREC) handle
+//! \param[in] pFlash            The pointer to the first sector of the flash region
+//! \param[in] sectorSize_words  The number of words of a sector
+//! \param[in] numSectors        The number of sectors
+//! \param[in] maxRecord_words   The number of words of the largest record, header included
+//! \param[in] eraseFxn          The function that erases a sector
+//! \param[in] programFxn        The function that programs words
+//! \return    The number of slots, zero if a record does not fit into a sector
+extern uint_least16_t FLREC_setParams(FLREC_Handle handle,
+                                      uint16_t *pFlash,
+                                      const uint32_t sectorSize_words,
+                                      const uint_least16_t numSectors,
+                                      const uint_least16_t maxRecord_words,
+                                      const FLREC_EraseFxn eraseFxn,
+                                      const FLREC_ProgramFxn programFxn);
+
+
+//! \brief     Sets the timer of the time statistics
+//! \param[in] handle            The flight recorder (FLREC) handle
+//! \param[in] readCntFxn        The function that reads the free running timer
+//! \param[in] timerPeriod_cnts  The timer period register, the timer counts from it down to zero, cnts
+extern void FLREC_setTimer(FLREC_Handle handle,
+                           const FLREC_ReadCntFxn readCntFxn,
+                           const uint32_t timerPeriod_cnts);
+
+
+//! \brief     Starts a record of the complete capture of a logger
+//! \param[in] handle            The flight recorder (FLREC) handle
+//! \param[in] triglogHandle     The triggered data logging (TRIGLOG) handle, the capture must stay until the record is done
+//! \param[in] framePeriod_usec  The time between two frames of the capture, usec
+//! \return    OK, or ERROR when a record is in progress, the next slot is not erased, there is no complete capture or it does not fit into a slot
+extern status FLREC_start(FLREC_Handle handle,
+                          TRIGLOG_Handle triglogHandle,
+                          const uint32_t framePeriod_usec);
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _FLREC_H_ definition
+
@@ -0,0 +1,536 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/flrec/src/32b/host/flrec_check.c
+//! \brief  Checks the flight recorder (FLREC) on a flash region in RAM
+//!
+//!         The flash functions behave as the flash: an erase sets a sector
+//!         to 0xFFFF, a program only clears bits, and a word that is
+//!         programmed twice is an error.  The checks
+//!
+//!           - commit more records than there are slots, so the recorder
+//!             wraps around the region and erases the sectors in turn,
+//!           - compare the records with the captures of the logger,
+//!           - scan the region with a new object after every record, as
+//!             after a reset, and compare the next slot and sequence number,
+//!           - cut a record short, as a reset while programming, and check
+//!             that it is not valid and that the next record skips its slot,
+//!           - check that no call of FLREC_run() programs more than
+//!             FLREC_MAX_WORDS_PER_RUN words.
+//!
+//!         The time of TRIGLOG_run() with TRIGLOG_MAX_CHANNELS channels and
+//!         of FLREC_run() on the host are printed.  With -o the flash region
+//!         is written as an image for flrec_extract.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sw/modules/flrec/src/32b/flrec.h"
+
+
+// **************************************************************************
+// the defines
+
+#define FLREC_CHECK_SECTOR_WORDS      (1024)
+#define FLREC_CHECK_NUM_SECTORS       (2)
+#define FLREC_CHECK_NUM_CHANNELS      (3)
+#define FLREC_CHECK_NUM_FRAMES        (20)
+#define FLREC_CHECK_NUM_PRE_FRAMES    (15)
+#define FLREC_CHECK_DECIMATION        (4)
+#define FLREC_CHECK_FRAME_PERIOD_usec (200)
+#define FLREC_CHECK_RECORD_WORDS      (FLREC_HEADER_WORDS + FLREC_CHECK_NUM_CHANNELS * FLREC_CHECK_NUM_FRAMES * 2)
+#define FLREC_CHECK_NUM_RECORDS       (40)
+#define FLREC_CHECK_NUM_BENCH_CALLS   (10000000L)
+
+
+// **************************************************************************
+// the globals
+
+uint16_t gFlash[FLREC_CHECK_NUM_SECTORS * FLREC_CHECK_SECTOR_WORDS];
+
+uint32_t gNumProgramCalls = 0;
+uint32_t gNumProgramWords = 0;
+uint_least16_t gMaxProgramWords = 0;
+uint32_t gNumDoublePrograms = 0;
+uint32_t gNumEraseCalls = 0;
+
+//! \brief Limits the number of words programmed before a simulated reset, -1 for no limit
+long gProgramBudget_words = -1;
+
+volatile int32_t gChan[TRIGLOG_MAX_CHANNELS];
+
+FLREC_Obj gFlrec;
+TRIGLOG_Obj gTriglog;
+int32_t gTriglogBuffer[TRIGLOG_MAX_CHANNELS * FLREC_CHECK_NUM_FRAMES];
+
+uint32_t gNumFailed = 0;
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Erases a sector of the flash region in RAM
+//! \param[in] pSector  The pointer to the first word of the sector
+//! \return    true on success
+static bool FLREC_CHECK_erase(uint16_t *pSector)
+{
+  size_t offset = (size_t)(pSector - gFlash);
+  size_t cnt;
+
+  if((offset % FLREC_CHECK_SECTOR_WORDS) != 0)
+    {
+      return(false);
+    }
+
+  for(cnt=0;cnt<FLREC_CHECK_SECTOR_WORDS;cnt++)
+    {
+      pSector[cnt] = FLREC_ERASED_WORD;
+    }
+
+  gNumEraseCalls++;
+
+  return(true);
+} // end of FLREC_CHECK_erase() function
+
+
+//! \brief     Programs words of the flash region in RAM
+//! \param[in] pDst      The pointer to the erased words
+//! \param[in] pSrc      The pointer to the words
+//! \param[in] numWords  The number of words
+//! \return    true on success
+static bool FLREC_CHECK_program(uint16_t *pDst,const uint16_t *pSrc,const uint_least16_t numWords)
+{
+  uint_least16_t cnt;
+
+  gNumProgramCalls++;
+
+  if(numWords > gMaxProgramWords)
+    {
+      gMaxProgramWords = numWords;
+    }
+
+  for(cnt=0;cnt<numWords;cnt++)
+    {
+      if(gProgramBudget_words == 0)
+        {
+          // the reset, the remaining words stay erased
+          return(false);
+        }
+
+      if(gProgramBudget_words > 0)
+        {
+          gProgramBudget_words--;
+        }
+
+      if(pDst[cnt] != FLREC_ERASED_WORD)
+        {
+          gNumDoublePrograms++;
+        }
+
+      // a program only clears bits
+      pDst[cnt] &= pSrc[cnt];
+      gNumProgramWords++;
+
+      if(pDst[cnt] != pSrc[cnt])
+        {
+          return(false);
+        }
+    }
+
+  return(true);
+} // end of FLREC_CHECK_program() function
+
+
+//! \brief     Checks a condition and counts the failures
+//! \param[in] flag_ok  The condition
+//! \param[in] pText    The description of the check
+static void FLREC_CHECK_expect(const bool flag_ok,const char *pText)
+{
+  if(!flag_ok)
+    {
+      printf("failed: %s\n",pText);
+      gNumFailed++;
+    }
+
+  return;
+} // end of FLREC_CHECK_expect() function
+
+
+//! \brief     Gets the time of the host
+//! \return    The time, nsec
+static double FLREC_CHECK_getTime_nsec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return((double)ts.tv_sec * 1.0e9 + (double)ts.tv_nsec);
+} // end of FLREC_CHECK_getTime_nsec() function
+
+
+//! \brief     Runs the logger to a complete capture, the channels count up from a seed
+//! \param[in] handle  The triggered data logging (TRIGLOG) handle
+//! \param[in] seed    The seed of the channel values
+static void FLREC_CHECK_capture(TRIGLOG_Handle handle,const int32_t seed)
+{
+  int32_t callCnt = 0;
+  uint_least16_t chan;
+
+  TRIGLOG_arm(handle);
+
+  while(TRIGLOG_getState(handle) != TRIGLOG_State_Done)
+    {
+      for(chan=0;chan<FLREC_CHECK_NUM_CHANNELS;chan++)
+        {
+          gChan[chan] = (seed << 16) + (callCnt << 2) + (int32_t)chan;
+        }
+
+      // a fault after the pre trigger frames are full
+      if(callCnt == (FLREC_CHECK_NUM_PRE_FRAMES * FLREC_CHECK_DECIMATION + 7))
+        {
+          TRIGLOG_trigger(handle,seed);
+        }
+
+      TRIGLOG_run(handle);
+      callCnt++;
+    }
+
+  return;
+} // end of FLREC_CHECK_capture() function
+
+
+//! \brief     Commits a capture, as the background loop of the project
+//! \param[in] handle         The flight recorder (FLREC) handle
+//! \param[in] triglogHandle  The triggered data logging (TRIGLOG) handle
+//! \param[in] pSlotNum       The slot of the record
+//! \return    true when the record was programmed
+static bool FLREC_CHECK_commit(FLREC_Handle handle,TRIGLOG_Handle triglogHandle,uint_least16_t *pSlotNum)
+{
+  uint32_t numErrors = FLREC_getNumErrors(handle);
+
+  if(!FLREC_isReady(handle))
+    {
+      FLREC_prepare(handle);
+    }
+
+  *pSlotNum = ((FLREC_Obj *)handle)->nextSlot;
+
+  if(FLREC_start(handle,triglogHandle,FLREC_CHECK_FRAME_PERIOD_usec) != OK)
+    {
+      return(false);
+    }
+
+  while(FLREC_getState(handle) != FLREC_State_Idle)
+    {
+      FLREC_run(handle);
+    }
+
+  return(FLREC_getNumErrors(handle) == numErrors);
+} // end of FLREC_CHECK_commit() function
+
+
+//! \brief     Compares a record with the capture of the logger
+//! \param[in] handle         The flight recorder (FLREC) handle
+//! \param[in] triglogHandle  The triggered data logging (TRIGLOG) handle
+//! \param[in] slotNum        The slot of the record
+//! \param[in] seq            The expected sequence number
+//! \return    true when the record matches the capture
+static bool FLREC_CHECK_compare(FLREC_Handle handle,TRIGLOG_Handle triglogHandle,
+                                const uint_least16_t slotNum,const uint32_t seq)
+{
+  const uint16_t *pSlot = FLREC_getSlot(handle,slotNum);
+  uint_least16_t numFrames = TRIGLOG_getNumCaptureFrames(triglogHandle);
+  uint_least16_t frame;
+
+  if(!FLREC_isValid(handle,slotNum) ||
+     ((((uint32_t)pSlot[FLREC_HDR_SEQ + 1] << 16) | pSlot[FLREC_HDR_SEQ]) != seq) ||
+     (pSlot[FLREC_HDR_NUM_FRAMES] != numFrames) ||
+     (pSlot[FLREC_HDR_TRIG_FRAME] != TRIGLOG_getTrigFrameNumber(triglogHandle)) ||
+     (pSlot[FLREC_HDR_TRIG_SOURCE] != TRIGLOG_TRIG_SOFTWARE))
+    {
+      return(false);
+    }
+
+  for(frame=0;frame<numFrames;frame++)
+    {
+      const int32_t *pFrame = TRIGLOG_getCaptureFrame(triglogHandle,frame);
+
+      if(memcmp(&pSlot[FLREC_HEADER_WORDS + frame * FLREC_CHECK_NUM_CHANNELS * 2],pFrame,
+                FLREC_CHECK_NUM_CHANNELS * sizeof(int32_t)) != 0)
+        {
+          return(false);
+        }
+    }
+
+  return(true);
+} // end of FLREC_CHECK_compare() function
+
+
+//! \brief     Scans the region with a new object, as after a reset
+//! \param[in] pObj  The memory of the new object
+//! \return    The flight recorder (FLREC) handle
+static FLREC_Handle FLREC_CHECK_reset(FLREC_Obj *pObj)
+{
+  FLREC_Handle handle = FLREC_init(pObj,sizeof(FLREC_Obj));
+
+  FLREC_setParams(handle,gFlash,FLREC_CHECK_SECTOR_WORDS,FLREC_CHECK_NUM_SECTORS,
+                  FLREC_CHECK_RECORD_WORDS,FLREC_CHECK_erase,FLREC_CHECK_program);
+  FLREC_scan(handle);
+
+  return(handle);
+} // end of FLREC_CHECK_reset() function
+
+
+//! \brief     Counts the valid records of the region
+//! \param[in] handle  The flight recorder (FLREC) handle
+//! \return    The number of valid records
+static uint_least16_t FLREC_CHECK_countValid(FLREC_Handle handle)
+{
+  uint_least16_t numValid = 0;
+  uint_least16_t slotNum;
+
+  for(slotNum=0;slotNum<FLREC_getNumSlots(handle);slotNum++)
+    {
+      if(FLREC_isValid(handle,slotNum))
+        {
+          numValid++;
+        }
+    }
+
+  return(numValid);
+} // end of FLREC_CHECK_countValid() function
+
+
+//! \brief     Measures the time of TRIGLOG_run() with all channels, armed and not triggered
+static void FLREC_CHECK_benchTriglog(void)
+{
+  static int32_t buffer[TRIGLOG_MAX_CHANNELS * 64];
+  TRIGLOG_Obj triglog;
+  TRIGLOG_Handle handle = TRIGLOG_init(&triglog,sizeof(triglog));
+  double start_nsec;
+  double end_nsec;
+  uint_least16_t chan;
+  long cnt;
+
+  TRIGLOG_setParams(handle,buffer,sizeof(buffer) / sizeof(buffer[0]),TRIGLOG_MAX_CHANNELS,1,56);
+
+  for(chan=0;chan<TRIGLOG_MAX_CHANNELS;chan++)
+    {
+      TRIGLOG_setChannel(handle,chan,&gChan[chan]);
+    }
+
+  // the triggers of the project, never met
+  TRIGLOG_setTrig(handle,0,TRIGLOG_TrigType_Rising,&gChan[TRIGLOG_MAX_CHANNELS - 1],0xFF);
+  TRIGLOG_setTrig(handle,1,TRIGLOG_TrigType_Equal,&gChan[TRIGLOG_MAX_CHANNELS - 1],-1);
+
+  TRIGLOG_arm(handle);
+
+  start_nsec = FLREC_CHECK_getTime_nsec();
+
+  for(cnt=0;cnt<FLREC_CHECK_NUM_BENCH_CALLS;cnt++)
+    {
+      gChan[0] = (int32_t)cnt;
+      TRIGLOG_run(handle);
+    }
+
+  end_nsec = FLREC_CHECK_getTime_nsec();
+
+  printf("TRIGLOG_run %u chan      %.1f nsec/call\n",(unsigned)TRIGLOG_MAX_CHANNELS,
+         (end_nsec - start_nsec) / (double)FLREC_CHECK_NUM_BENCH_CALLS);
+
+  return;
+} // end of FLREC_CHECK_benchTriglog() function
+
+
+int main(int argc,char *argv[])
+{
+  const char *pImageFileName = NULL;
+  TRIGLOG_Handle triglogHandle;
+  FLREC_Handle flrecHandle;
+  FLREC_Obj scanObj;
+  FLREC_Handle scanHandle;
+  uint_least16_t slotNum;
+  uint_least16_t partialSlot;
+  uint32_t seq;
+  double start_nsec;
+  double commit_nsec = 0.0;
+  uint_least16_t chan;
+  int opt;
+
+  while((opt = getopt(argc,argv,"o:h")) != -1)
+    {
+      switch(opt)
+        {
+          case 'o':
+            pImageFileName = optarg;
+            break;
+          default:
+            fprintf(stderr,"usage: %s [-o image.bin]\n",argv[0]);
+            return(EXIT_FAILURE);
+        }
+    }
+
+  // the flash is erased
+  memset(gFlash,0xFF,sizeof(gFlash));
+
+  triglogHandle = TRIGLOG_init(&gTriglog,sizeof(gTriglog));
+  TRIGLOG_setParams(triglogHandle,gTriglogBuffer,FLREC_CHECK_NUM_CHANNELS * FLREC_CHECK_NUM_FRAMES,
+                    FLREC_CHECK_NUM_CHANNELS,FLREC_CHECK_DECIMATION,FLREC_CHECK_NUM_PRE_FRAMES);
+
+  for(chan=0;chan<FLREC_CHECK_NUM_CHANNELS;chan++)
+    {
+      TRIGLOG_setChannel(triglogHandle,chan,&gChan[chan]);
+    }
+
+  flrecHandle = FLREC_CHECK_reset(&gFlrec);
+
+  FLREC_CHECK_expect(FLREC_getNumSlots(flrecHandle) ==
+                     FLREC_CHECK_NUM_SECTORS * (FLREC_CHECK_SECTOR_WORDS / FLREC_CHECK_RECORD_WORDS),
+                     "number of slots");
+  FLREC_CHECK_expect(FLREC_getNumRecords(flrecHandle) == 0,"erased region has no records");
+  FLREC_CHECK_expect(FLREC_isReady(flrecHandle),"erased region is ready");
+
+  // more records than slots, the region wraps around
+  for(seq=1;seq<=FLREC_CHECK_NUM_RECORDS;seq++)
+    {
+      FLREC_CHECK_capture(triglogHandle,(int32_t)seq);
+
+      start_nsec = FLREC_CHECK_getTime_nsec();
+
+      FLREC_CHECK_expect(FLREC_CHECK_commit(flrecHandle,triglogHandle,&slotNum),"commit");
+
+      commit_nsec += FLREC_CHECK_getTime_nsec() - start_nsec;
+
+      FLREC_CHECK_expect(FLREC_CHECK_compare(flrecHandle,triglogHandle,slotNum,seq),"record matches the capture");
+      FLREC_CHECK_expect(FLREC_getNumRecords(flrecHandle) == FLREC_CHECK_countValid(flrecHandle),
+                         "number of records");
+
+      scanHandle = FLREC_CHECK_reset(&scanObj);
+
+      FLREC_CHECK_expect(FLREC_getNumRecords(scanHandle) == FLREC_getNumRecords(flrecHandle),"scan number of records");
+      FLREC_CHECK_expect(FLREC_getNextSeq(scanHandle) == (seq + 1),"scan sequence number");
+      FLREC_CHECK_expect(scanObj.nextSlot == gFlrec.nextSlot,"scan next slot");
+    }
+
+  FLREC_CHECK_expect(gNumEraseCalls >= (FLREC_CHECK_NUM_RECORDS / FLREC_getNumSlots(flrecHandle)),
+                     "sectors erased on wrap around");
+  FLREC_CHECK_expect(FLREC_getNumRecords(flrecHandle) >= (FLREC_getNumSlots(flrecHandle) / FLREC_CHECK_NUM_SECTORS),
+                     "records of the other sectors survive the erase");
+
+  // a reset while programming the frames
+  FLREC_CHECK_capture(triglogHandle,0x7FF);
+
+  if(!FLREC_isReady(flrecHandle))
+    {
+      FLREC_prepare(flrecHandle);
+    }
+
+  partialSlot = gFlrec.nextSlot;
+  gProgramBudget_words = FLREC_CHECK_NUM_CHANNELS * 2 * 5 + 1;
+
+  FLREC_start(flrecHandle,triglogHandle,FLREC_CHECK_FRAME_PERIOD_usec);
+
+  while(FLREC_getState(flrecHandle) != FLREC_State_Idle)
+    {
+      FLREC_run(flrecHandle);
+    }
+
+  gProgramBudget_words = -1;
+
+  flrecHandle = FLREC_CHECK_reset(&gFlrec);
+
+  FLREC_CHECK_expect(!FLREC_isValid(flrecHandle,partialSlot),"partial record is not valid");
+  FLREC_CHECK_expect(FLREC_getNextSeq(flrecHandle) == (FLREC_CHECK_NUM_RECORDS + 1),"partial record has no sequence number");
+
+  FLREC_CHECK_capture(triglogHandle,(int32_t)(FLREC_CHECK_NUM_RECORDS + 1));
+  FLREC_CHECK_expect(FLREC_CHECK_commit(flrecHandle,triglogHandle,&slotNum),"commit after the reset");
+  FLREC_CHECK_expect(slotNum != partialSlot,"partial slot is skipped");
+  FLREC_CHECK_expect(FLREC_CHECK_compare(flrecHandle,triglogHandle,slotNum,FLREC_CHECK_NUM_RECORDS + 1),
+                     "record after the reset matches the capture");
+
+  FLREC_CHECK_expect(gMaxProgramWords <= FLREC_MAX_WORDS_PER_RUN,"words per program call");
+  FLREC_CHECK_expect(gNumDoublePrograms == 0,"no word programmed twice");
+
+  printf("slots                   %u of %u words\n",(unsigned)FLREC_getNumSlots(flrecHandle),
+         (unsigned)FLREC_CHECK_RECORD_WORDS);
+  printf("records committed       %lu\n",(unsigned long)(FLREC_CHECK_NUM_RECORDS + 1));
+  printf("records valid           %u\n",(unsigned)FLREC_getNumRecords(flrecHandle));
+  printf("sector erases           %lu\n",(unsigned long)gNumEraseCalls);
+  printf("program calls           %lu, %lu words\n",(unsigned long)gNumProgramCalls,(unsigned long)gNumProgramWords);
+  printf("max words per call      %u of %u\n",(unsigned)gMaxProgramWords,(unsigned)FLREC_MAX_WORDS_PER_RUN);
+  printf("FLREC commit            %.1f usec/record\n",commit_nsec * 1.0e-3 / (double)FLREC_CHECK_NUM_RECORDS);
+
+  FLREC_CHECK_benchTriglog();
+
+  if(pImageFileName != NULL)
+    {
+      FILE *pFile = fopen(pImageFileName,"wb");
+      size_t cnt;
+
+      if(pFile == NULL)
+        {
+          perror(pImageFileName);
+          return(EXIT_FAILURE);
+        }
+
+      // little endian, as the memory browser saves the flash
+      for(cnt=0;cnt<(sizeof(gFlash) / sizeof(gFlash[0]));cnt++)
+        {
+          fputc(gFlash[cnt] & 0xFF,pFile);
+          fputc(gFlash[cnt] >> 8,pFile);
+        }
+
+      fclose(pFile);
+    }
+
+  if(gNumFailed != 0)
+    {
+      printf("FAIL\n");
+      return(EXIT_FAILURE);
+    }
+
+  printf("PASS\n");
+
+  return(EXIT_SUCCESS);
+} // end of main() function
+
+// end of file
@@ -0,0 +1,360 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/flrec/src/32b/host/flrec_extract.c
+//! \brief  Extracts the records of the flight recorder (FLREC) from a flash image
+//!
+//!         The image is a raw dump of the flash region, 16-bit little endian
+//!         words, as saved from the debugger memory browser or written by
+//!         proj_lab05b_sim -F.  The records are found at any word offset by
+//!         their magic word and their CRC, the slot size of the project is
+//!         not needed.
+//!
+//!         The records are listed in the order of their sequence numbers.
+//!         With -r the frames of one record are written as CSV, one line per
+//!         frame with the time relative to the trigger frame and the raw
+//!         32-bit channel values.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sw/modules/flrec/src/32b/flrec.h"
+
+
+// **************************************************************************
+// the defines
+
+#define FLREC_EXTRACT_MAX_RECORDS      (256)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines a record found in the image
+//!
+typedef struct _FLREC_EXTRACT_Record_t_
+{
+  size_t          offset_words;     //!< the word offset of the record in the image
+  uint32_t        seq;              //!< the sequence number
+} FLREC_EXTRACT_Record_t;
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Gets a 32-bit value of a record, low word first
+//! \param[in] pWords  The pointer to the low word
+//! \return    The value
+static uint32_t FLREC_EXTRACT_get32(const uint16_t *pWords)
+{
+  return(((uint32_t)pWords[1] << 16) | pWords[0]);
+} // end of FLREC_EXTRACT_get32() function
+
+
+//! \brief     Checks for a valid record at a word offset
+//! \param[in] pImage    The image
+//! \param[in] numWords  The number of words from the offset to the end of the image
+//! \return    The number of words of the record, zero if there is none
+static size_t FLREC_EXTRACT_check(const uint16_t *pImage,const size_t numWords)
+{
+  size_t numFrameWords;
+  uint16_t crc;
+
+  if((numWords < FLREC_HEADER_WORDS) ||
+     (pImage[FLREC_HDR_MAGIC] != FLREC_MAGIC) ||
+     (pImage[FLREC_HDR_VERSION] != FLREC_VERSION) ||
+     (pImage[FLREC_HDR_NUM_CHANNELS] == 0) ||
+     (pImage[FLREC_HDR_NUM_CHANNELS] > TRIGLOG_MAX_CHANNELS))
+    {
+      return(0);
+    }
+
+  numFrameWords = (size_t)pImage[FLREC_HDR_NUM_CHANNELS] * pImage[FLREC_HDR_NUM_FRAMES] * 2;
+
+  if((FLREC_HEADER_WORDS + numFrameWords) > numWords)
+    {
+      return(0);
+    }
+
+  crc = FLREC_computeCrc(0xFFFF,&pImage[FLREC_HDR_VERSION],FLREC_HDR_CRC - FLREC_HDR_VERSION);
+  crc = FLREC_computeCrc(crc,&pImage[FLREC_HEADER_WORDS],(uint_least16_t)numFrameWords);
+
+  if(crc != pImage[FLREC_HDR_CRC])
+    {
+      return(0);
+    }
+
+  return(FLREC_HEADER_WORDS + numFrameWords);
+} // end of FLREC_EXTRACT_check() function
+
+
+//! \brief     Orders the records by their sequence numbers
+//! \param[in] pA  The first record
+//! \param[in] pB  The second record
+//! \return    The order
+static int FLREC_EXTRACT_compare(const void *pA,const void *pB)
+{
+  const FLREC_EXTRACT_Record_t *pRecA = (const FLREC_EXTRACT_Record_t *)pA;
+  const FLREC_EXTRACT_Record_t *pRecB = (const FLREC_EXTRACT_Record_t *)pB;
+
+  return((pRecA->seq > pRecB->seq) - (pRecA->seq < pRecB->seq));
+} // end of FLREC_EXTRACT_compare() function
+
+
+//! \brief     Writes the frames of a record as CSV
+//! \param[in] pFile    The output file
+//! \param[in] pRecord  The pointer to the first word of the record
+//! \param[in] pNames   The comma separated channel names, NULL for ch0, ch1, ...
+static void FLREC_EXTRACT_writeCsv(FILE *pFile,const uint16_t *pRecord,const char *pNames)
+{
+  uint_least16_t numChannels = pRecord[FLREC_HDR_NUM_CHANNELS];
+  uint_least16_t numFrames = pRecord[FLREC_HDR_NUM_FRAMES];
+  uint_least16_t trigFrame = pRecord[FLREC_HDR_TRIG_FRAME];
+  double framePeriod_ms = (double)FLREC_EXTRACT_get32(&pRecord[FLREC_HDR_FRAME_PERIOD]) * 1.0e-3;
+  const uint16_t *pFrame = &pRecord[FLREC_HEADER_WORDS];
+  uint_least16_t frame;
+  uint_least16_t chan;
+
+  fprintf(pFile,"time_ms");
+
+  if(pNames != NULL)
+    {
+      fprintf(pFile,",%s",pNames);
+    }
+  else
+    {
+      for(chan=0;chan<numChannels;chan++)
+        {
+          fprintf(pFile,",ch%u",(unsigned)chan);
+        }
+    }
+
+  fprintf(pFile,"\n");
+
+  for(frame=0;frame<numFrames;frame++)
+    {
+      fprintf(pFile,"%.3f",((double)frame - (double)trigFrame) * framePeriod_ms);
+
+      for(chan=0;chan<numChannels;chan++)
+        {
+          fprintf(pFile,",%ld",(long)(int32_t)FLREC_EXTRACT_get32(pFrame));
+          pFrame += 2;
+        }
+
+      fprintf(pFile,"\n");
+    }
+
+  return;
+} // end of FLREC_EXTRACT_writeCsv() function
+
+
+//! \brief     Prints the command line options
+//! \param[in] pName  The program name
+static void FLREC_EXTRACT_usage(const char *pName)
+{
+  fprintf(stderr,"usage: %s [-r seq] [-o file.csv] [-c names] image.bin\n",pName);
+  fprintf(stderr,"  -r  write the frames of the record with this sequence number, 0 for the newest\n");
+  fprintf(stderr,"  -o  CSV file of the frames, default the standard output\n");
+  fprintf(stderr,"  -c  comma separated channel names of the CSV header\n");
+
+  return;
+} // end of FLREC_EXTRACT_usage() function
+
+
+int main(int argc,char *argv[])
+{
+  FLREC_EXTRACT_Record_t records[FLREC_EXTRACT_MAX_RECORDS];
+  size_t numRecords = 0;
+  const char *pCsvFileName = NULL;
+  const char *pNames = NULL;
+  bool flag_writeCsv = false;
+  uint32_t csvSeq = 0;
+  uint16_t *pImage;
+  size_t numWords;
+  size_t offset;
+  FILE *pFile;
+  long fileSize;
+  size_t cnt;
+  int opt;
+
+  while((opt = getopt(argc,argv,"r:o:c:h")) != -1)
+    {
+      switch(opt)
+        {
+          case 'r':
+            flag_writeCsv = true;
+            csvSeq = (uint32_t)strtoul(optarg,NULL,0);
+            break;
+          case 'o':
+            pCsvFileName = optarg;
+            break;
+          case 'c':
+            pNames = optarg;
+            break;
+          default:
+            FLREC_EXTRACT_usage(argv[0]);
+            return(EXIT_FAILURE);
+        }
+    }
+
+  if(optind != (argc - 1))
+    {
+      FLREC_EXTRACT_usage(argv[0]);
+      return(EXIT_FAILURE);
+    }
+
+  pFile = fopen(argv[optind],"rb");
+  if((pFile == NULL) || (fseek(pFile,0,SEEK_END) != 0) || ((fileSize = ftell(pFile)) < 0))
+    {
+      perror(argv[optind]);
+      return(EXIT_FAILURE);
+    }
+
+  rewind(pFile);
+
+  numWords = (size_t)fileSize / 2;
+  pImage = malloc((numWords + 1) * sizeof(uint16_t));
+
+  if(pImage == NULL)
+    {
+      fprintf(stderr,"out of memory\n");
+      return(EXIT_FAILURE);
+    }
+
+  // the image is little endian
+  for(cnt=0;cnt<numWords;cnt++)
+    {
+      int lo = fgetc(pFile);
+      int hi = fgetc(pFile);
+
+      pImage[cnt] = (uint16_t)((lo & 0xFF) | ((hi & 0xFF) << 8));
+    }
+
+  fclose(pFile);
+
+  // a record can start at any word
+  offset = 0;
+
+  while(offset < numWords)
+    {
+      size_t recordWords = FLREC_EXTRACT_check(&pImage[offset],numWords - offset);
+
+      if(recordWords == 0)
+        {
+          offset++;
+          continue;
+        }
+
+      if(numRecords < FLREC_EXTRACT_MAX_RECORDS)
+        {
+          records[numRecords].offset_words = offset;
+          records[numRecords].seq = FLREC_EXTRACT_get32(&pImage[offset + FLREC_HDR_SEQ]);
+          numRecords++;
+        }
+
+      offset += recordWords;
+    }
+
+  qsort(records,numRecords,sizeof(records[0]),FLREC_EXTRACT_compare);
+
+  fprintf(stderr,"%-8s %-8s %-8s %-8s %-8s %-8s %-12s %s\n",
+          "seq","offset","channels","frames","trigger","source","value","frame period");
+
+  for(cnt=0;cnt<numRecords;cnt++)
+    {
+      const uint16_t *pRecord = &pImage[records[cnt].offset_words];
+
+      fprintf(stderr,"%-8lu 0x%06lx %-8u %-8u %-8u %-8u 0x%08lx   %lu usec\n",
+              (unsigned long)records[cnt].seq,
+              (unsigned long)records[cnt].offset_words,
+              (unsigned)pRecord[FLREC_HDR_NUM_CHANNELS],
+              (unsigned)pRecord[FLREC_HDR_NUM_FRAMES],
+              (unsigned)pRecord[FLREC_HDR_TRIG_FRAME],
+              (unsigned)pRecord[FLREC_HDR_TRIG_SOURCE],
+              (unsigned long)FLREC_EXTRACT_get32(&pRecord[FLREC_HDR_TRIG_VALUE]),
+              (unsigned long)FLREC_EXTRACT_get32(&pRecord[FLREC_HDR_FRAME_PERIOD]));
+    }
+
+  fprintf(stderr,"%lu records\n",(unsigned long)numRecords);
+
+  if(flag_writeCsv)
+    {
+      const uint16_t *pRecord = NULL;
+      FILE *pCsvFile = stdout;
+
+      for(cnt=0;cnt<numRecords;cnt++)
+        {
+          if((csvSeq == 0) || (records[cnt].seq == csvSeq))
+            {
+              pRecord = &pImage[records[cnt].offset_words];
+            }
+        }
+
+      if(pRecord == NULL)
+        {
+          fprintf(stderr,"no record %lu\n",(unsigned long)csvSeq);
+          return(EXIT_FAILURE);
+        }
+
+      if(pCsvFileName != NULL)
+        {
+          pCsvFile = fopen(pCsvFileName,"w");
+          if(pCsvFile == NULL)
+            {
+              perror(pCsvFileName);
+              return(EXIT_FAILURE);
+            }
+        }
+
+      FLREC_EXTRACT_writeCsv(pCsvFile,pRecord,pNames);
+
+      if(pCsvFile != stdout)
+        {
+          fclose(pCsvFile);
+        }
+    }
+
+  free(pImage);
+
+  return(EXIT_SUCCESS);
+} // end of main() function
+
+// end of file
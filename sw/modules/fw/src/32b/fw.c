@@ -55,6 +55,7 @@
 FW_Handle FW_init(void *pMemory,const size_t numBytes)
 {
   FW_Handle fwHandle;
+  FW_Obj *fw;
 
   if(numBytes < sizeof(FW_Obj))
     return((FW_Handle)NULL);
@@ -62,6 +63,19 @@ FW_Handle FW_init(void *pMemory,const size_t numBytes)
   // assign the handle
   fwHandle = (FW_Handle)pMemory;
 
+  fw = (FW_Obj *)fwHandle;
+
+  // the voltage regulator and the feedforward are off until configured
+  fw->Kp = _IQ(0.0);
+  fw->Ki = _IQ(0.0);
+  fw->Ui = _IQ(0.0);
+  fw->pTable = NULL;
+  fw->numTablePoints = 0;
+  fw->tableScale = _IQ(0.0);
+  fw->Id_ff = _IQ(0.0);
+  fw->IsMax = _IQ(0.0);
+  fw->Iq_max = _IQ(0.0);
+
   return(fwHandle);
 } // end of FW_init() function
 
@@ -76,6 +76,11 @@ extern "C" {
 #define FW_NUM_ISR_TICKS_PER_CTRL_TICK   (10)
 
 
+//! \brief Defines the maximum number of entries of the Id feedforward table
+//!
+#define FW_MAX_TABLE_SIZE                (64)
+
+
 // **************************************************************************
 // the typedefs
   
@@ -98,7 +103,19 @@ typedef struct _FW_Obj_
 	
   _iq          outMin;                 //!< the minimum output value allowed for the FW controller
   _iq          outMax;                 //!< the maximum output value allowed for the FW controller
-  
+
+  _iq          Kp;                     //!< the proportional gain of the voltage regulator of FW_run_pi()
+  _iq          Ki;                     //!< the integral gain of the voltage regulator of FW_run_pi()
+  _iq          Ui;                     //!< the integrator of the voltage regulator
+
+  const _iq   *pTable;                 //!< the Id feedforward table, indexed by the speed over the DC bus voltage
+  uint_least16_t numTablePoints;       //!< the number of entries of the feedforward table
+  _iq          tableScale;             //!< the number of table entries per unit of the index
+  _iq          Id_ff;                  //!< the Id feedforward of the last run
+
+  _iq          IsMax;                  //!< the maximum current magnitude, the Iq limit keeps to it
+  _iq          Iq_max;                 //!< the maximum Iq left by the Id output
+
   bool       flag_enableFw;          //!< a flag to enable field weakening
 } FW_Obj;
 
@@ -275,7 +292,148 @@ static inline _iq FW_getOutput(FW_Handle fwHandle)
 } // end of FW_getOutput() function
 
 
+//! \brief     Sets the gains of the voltage regulator of FW_run_pi()
+//! \param[in] fwHandle  The FW controller handle
+//! \param[in] Kp        The proportional gain, pu of current per pu of voltage
+//! \param[in] Ki        The integral gain per FW tick, pu of current per pu of voltage
+static inline void FW_setGains(FW_Handle fwHandle,const _iq Kp,const _iq Ki)
+{
+  FW_Obj *fw = (FW_Obj *)fwHandle;
+
+  fw->Kp = Kp;
+  fw->Ki = Ki;
+
+  return;
+} // end of FW_setGains() function
+
+
+//! \brief      Gets the gains of the voltage regulator of FW_run_pi()
+//! \param[in]  fwHandle  The FW controller handle
+//! \param[out] pKp       The pointer to the proportional gain
+//! \param[out] pKi       The pointer to the integral gain
+static inline void FW_getGains(FW_Handle fwHandle,_iq *pKp,_iq *pKi)
+{
+  FW_Obj *fw = (FW_Obj *)fwHandle;
+
+  *pKp = fw->Kp;
+  *pKi = fw->Ki;
+
+  return;
+} // end of FW_getGains() function
+
+
+//! \brief     Sets the integrator of the voltage regulator of FW_run_pi()
+//! \param[in] fwHandle  The FW controller handle
+//! \param[in] Ui        The integrator value, pu
+static inline void FW_setUi(FW_Handle fwHandle,const _iq Ui)
+{
+  FW_Obj *fw = (FW_Obj *)fwHandle;
+
+  fw->Ui = Ui;
+
+  return;
+} // end of FW_setUi() function
+
+
+//! \brief     Gets the integrator of the voltage regulator of FW_run_pi()
+//! \param[in] fwHandle  The FW controller handle
+//! \return    The integrator value, pu
+static inline _iq FW_getUi(FW_Handle fwHandle)
+{
+  FW_Obj *fw = (FW_Obj *)fwHandle;
+
+  return(fw->Ui);
+} // end of FW_getUi() function
+
+
+//! \brief     Sets the Id feedforward table of FW_run_pi()
+//! \details   The table is indexed by the speed times the inverse DC bus voltage, both
+//!            in pu, and holds the Id in pu that keeps the voltage at the reference
+//!            without load.  Entry n belongs to the index n / tableScale, beyond the
+//!            last entry the last one applies.  A NULL table runs the regulator alone.
+//! \param[in] fwHandle        The FW controller handle
+//! \param[in] pTable          The pointer to the table
+//! \param[in] numTablePoints  The number of table entries, at most FW_MAX_TABLE_SIZE
+//! \param[in] tableScale      The number of table entries per unit of the index
+static inline void FW_setFfTable(FW_Handle fwHandle,const _iq *pTable,
+                                 const uint_least16_t numTablePoints,const _iq tableScale)
+{
+  FW_Obj *fw = (FW_Obj *)fwHandle;
+
+  fw->pTable = pTable;
+  fw->numTablePoints = numTablePoints;
+  fw->tableScale = tableScale;
+
+  return;
+} // end of FW_setFfTable() function
+
+
+//! \brief     Gets the Id feedforward of the last run of FW_run_pi()
+//! \param[in] fwHandle  The FW controller handle
+//! \return    The Id feedforward, pu
+static inline _iq FW_getId_ff_pu(FW_Handle fwHandle)
+{
+  FW_Obj *fw = (FW_Obj *)fwHandle;
+
+  return(fw->Id_ff);
+} // end of FW_getId_ff_pu() function
+
+
+//! \brief     Sets the maximum current magnitude the Iq limit of FW_run_pi() keeps to
+//! \param[in] fwHandle  The FW controller handle
+//! \param[in] IsMax     The maximum current magnitude, pu
+static inline void FW_setIsMax_pu(FW_Handle fwHandle,const _iq IsMax)
+{
+  FW_Obj *fw = (FW_Obj *)fwHandle;
+
+  fw->IsMax = IsMax;
+  fw->Iq_max = IsMax;
+
+  return;
+} // end of FW_setIsMax_pu() function
+
+
+//! \brief     Gets the maximum Iq left by the Id output of FW_run_pi()
+//! \details   The maximum Iq is sqrt(IsMax^2 - Id^2), it is meant as the maximum
+//!            output of the speed controller, see CTRL_setSpdMax()
+//! \param[in] fwHandle  The FW controller handle
+//! \return    The maximum Iq, pu
+static inline _iq FW_getIq_max_pu(FW_Handle fwHandle)
+{
+  FW_Obj *fw = (FW_Obj *)fwHandle;
+
+  return(fw->Iq_max);
+} // end of FW_getIq_max_pu() function
+
+
+//! \brief     Gets the Id feedforward from the table
+//! \param[in] fwHandle  The FW controller handle
+//! \param[in] index     The speed times the inverse DC bus voltage, pu
+//! \return    The linearly interpolated table value, pu
+static inline _iq FW_getTableValue(FW_Handle fwHandle,const _iq index)
+{
+  FW_Obj *fw = (FW_Obj *)fwHandle;
+  _iq position = _IQmpy(index,fw->tableScale);
+  int_least32_t n = _IQint(position);
+
+  if(fw->pTable == NULL)
+    {
+      return(_IQ(0.0));
+    }
+
+  if(n >= (int_least32_t)(fw->numTablePoints - 1))
+    {
+      return(fw->pTable[fw->numTablePoints - 1]);
+    }
+
+  return(fw->pTable[n] + _IQmpy(fw->pTable[n + 1] - fw->pTable[n],_IQfrac(position)));
+} // end of FW_getTableValue() function
+
+
 //! \brief     Runs the FW controller
+//! \details   Steps the output by delta_inc while the feedback is below the reference
+//!            and by delta_dec while it is above, see FW_run_pi() for the voltage
+//!            regulator with the Id feedforward
 //! \param[in] fwHandle    The FW controller handle
 //! \param[in] refValue    The reference value to the controller
 //! \param[in] fbackValue  The feedback value to the controller
@@ -287,7 +445,7 @@ static inline void FW_run(FW_Handle fwHandle,const _iq refValue,const _iq fbackV
   _iq Error;
   _iq output = fw->output;
   _iq delta_inc = fw->delta_inc;
-  _iq delta_dec = fw->delta_inc;
+  _iq delta_dec = fw->delta_dec;
 
 
   Error = refValue - fbackValue;
@@ -313,6 +471,56 @@ static inline void FW_run(FW_Handle fwHandle,const _iq refValue,const _iq fbackV
 } // end of FW_run() function
 
 
+//! \brief     Runs the FW voltage regulator with the Id feedforward
+//! \details   The Id reference is the sum of the feedforward table value at the speed
+//!            over the DC bus voltage and of a PI regulator on the error of the voltage
+//!            magnitude.  The feedforward tracks throttle steps as fast as the speed
+//!            changes, the PI only removes what the table misses, mostly the drop of
+//!            the load current.  The integrator is limited so that it cannot push the
+//!            output past the limits on its own, once Id is at outMin the error stays
+//!            negative without winding up and Id leaves the limit as soon as the
+//!            voltage has room again.  The Iq left by the Id output within IsMax is
+//!            available from FW_getIq_max_pu().
+//! \param[in] fwHandle         The FW controller handle
+//! \param[in] refValue         The reference of the voltage magnitude, pu
+//! \param[in] fbackValue       The voltage magnitude, pu
+//! \param[in] speed_pu         The electrical speed, pu
+//! \param[in] oneOverDcBus_pu  The inverse of the DC bus voltage, pu
+//! \param[in] pOutValue        The pointer to the Id reference, pu
+static inline void FW_run_pi(FW_Handle fwHandle,const _iq refValue,const _iq fbackValue,
+                             const _iq speed_pu,const _iq oneOverDcBus_pu,_iq *pOutValue)
+{
+  FW_Obj *fw = (FW_Obj *)fwHandle;
+
+  _iq Error = refValue - fbackValue;
+  _iq Id_ff = FW_getTableValue(fwHandle,_IQmpy(_IQabs(speed_pu),oneOverDcBus_pu));
+  _iq Ui = fw->Ui + _IQmpy(fw->Ki,Error);
+  _iq output;
+  _iq Iq_max2;
+
+
+  // the integrator alone stays within the output limits around the feedforward
+  Ui = _IQsat(Ui,fw->outMax - Id_ff,fw->outMin - Id_ff);
+
+  output = _IQsat(Id_ff + _IQmpy(fw->Kp,Error) + Ui,fw->outMax,fw->outMin);
+
+  // the current circle, Iq^2 + Id^2 = Is^2
+  Iq_max2 = _IQmpy(fw->IsMax,fw->IsMax) - _IQmpy(output,output);
+
+  fw->Iq_max = (Iq_max2 > _IQ(0.0)) ? _IQsqrt(Iq_max2) : _IQ(0.0);
+
+  fw->Ui = Ui;
+  fw->Id_ff = Id_ff;
+  fw->output = output;
+  fw->refValue = refValue;
+  fw->fbackValue = fbackValue;
+
+  *pOutValue = output;
+
+  return;
+} // end of FW_run_pi() function
+
+
 #ifdef __cplusplus
 }
 #endif // extern "C"
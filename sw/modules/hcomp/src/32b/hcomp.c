@@ -0,0 +1,372 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/hcomp/src/32b/hcomp.c
+//! \brief  Portable C code.  These functions define the
+//!         harmonic compensator (HCOMP) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/hcomp/src/32b/hcomp.h"
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Sets the synthesis phasor of a harmonic for the next table entry
+//! \param[in] obj    The harmonic compensator (HCOMP) object
+//! \param[in] pHarm  The pointer to the harmonic
+static void HCOMP_setSynthPhasor(HCOMP_Obj *obj,HCOMP_Harmonic_t *pHarm)
+{
+  uint_least16_t shift = GLOBAL_Q - obj->tableShift;
+  _iq phase = (_iq)((((uint32_t)obj->synthIndex * (uint32_t)pHarm->order) << shift) & HCOMP_ANGLE_MASK);
+
+  pHarm->cosSynth = _IQcosPU(phase);
+  pHarm->sinSynth = _IQsinPU(phase);
+
+  return;
+} // end of HCOMP_setSynthPhasor() function
+
+
+void HCOMP_align(HCOMP_Handle handle)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+  _iq zr[HCOMP_MAX_HARMONICS],zi[HCOMP_MAX_HARMONICS];
+  _iq cosStep[HCOMP_MAX_HARMONICS],sinStep[HCOMP_MAX_HARMONICS];
+  _iq cosRot[HCOMP_MAX_HARMONICS],sinRot[HCOMP_MAX_HARMONICS];
+  _iq bestScore = _IQ(0.0);
+  uint_least16_t bestK = 0;
+  uint_least16_t num;
+  uint_least16_t k;
+
+
+  // the product of the learned and the kept coefficients, and the phase a
+  // harmonic turns by per revolution over the number of pole pairs
+  for(num=0;num<obj->numHarmonics;num++)
+    {
+      HCOMP_Harmonic_t *pHarm = &obj->harmonic[num];
+      uint32_t rem = pHarm->order % obj->numPolePairs;
+      _iq step = (_iq)((rem << GLOBAL_Q) / obj->numPolePairs);
+
+      if(rem != 0)
+        {
+          zr[num] = _IQmpy(pHarm->a,pHarm->aKept) + _IQmpy(pHarm->b,pHarm->bKept);
+          zi[num] = _IQmpy(pHarm->b,pHarm->aKept) - _IQmpy(pHarm->a,pHarm->bKept);
+        }
+      else
+        {
+          zr[num] = _IQ(0.0);
+          zi[num] = _IQ(0.0);
+        }
+
+      cosStep[num] = _IQcosPU(step);
+      sinStep[num] = _IQsinPU(step);
+      cosRot[num] = _IQ(1.0);
+      sinRot[num] = _IQ(0.0);
+    }
+
+  // the correlation of every candidate
+  for(k=0;k<obj->numPolePairs;k++)
+    {
+      _iq score = _IQ(0.0);
+
+      for(num=0;num<obj->numHarmonics;num++)
+        {
+          _iq cosRotLast = cosRot[num];
+
+          score += _IQmpy(zr[num],cosRot[num]) - _IQmpy(zi[num],sinRot[num]);
+
+          cosRot[num] = _IQmpy(cosRotLast,cosStep[num]) - _IQmpy(sinRot[num],sinStep[num]);
+          sinRot[num] = _IQmpy(sinRot[num],cosStep[num]) + _IQmpy(cosRotLast,sinStep[num]);
+        }
+
+      if((k == 0) || (score > bestScore))
+        {
+          bestScore = score;
+          bestK = k;
+        }
+    }
+
+  // move the mechanical angle and restore the kept coefficients
+  obj->angleMech_poles += (_iq)bestK << GLOBAL_Q;
+
+  if(obj->angleMech_poles >= obj->polePairs)
+    {
+      obj->angleMech_poles -= obj->polePairs;
+    }
+
+  obj->angleMech = (uint32_t)_IQmpy(obj->angleMech_poles,obj->oneOverPolePairs) & HCOMP_ANGLE_MASK;
+
+  for(num=0;num<obj->numHarmonics;num++)
+    {
+      HCOMP_Harmonic_t *pHarm = &obj->harmonic[num];
+
+      if((pHarm->order % obj->numPolePairs) != 0)
+        {
+          pHarm->a = pHarm->aKept;
+          pHarm->b = pHarm->bKept;
+        }
+    }
+
+  // the residual of the period was taken on the angle before the move
+  obj->learnNum = obj->numHarmonics;
+  obj->flag_align = false;
+
+  return;
+} // end of HCOMP_align() function
+
+
+HCOMP_Handle HCOMP_init(void *pMemory,const size_t numBytes)
+{
+  HCOMP_Handle handle;
+  HCOMP_Obj *obj;
+  uint_least16_t num;
+
+
+  if(numBytes < sizeof(HCOMP_Obj))
+    return((HCOMP_Handle)NULL);
+
+  // assign the handle
+  handle = (HCOMP_Handle)pMemory;
+
+  obj = (HCOMP_Obj *)handle;
+
+  obj->pTable = NULL;
+  obj->tableShift = 0;
+  obj->numHarmonics = 0;
+  obj->synthIndex = 0;
+
+  for(num=0;num<HCOMP_MAX_HARMONICS;num++)
+    {
+      obj->harmonic[num].order = 0;
+      obj->harmonic[num].cosStep = _IQ(1.0);
+      obj->harmonic[num].sinStep = _IQ(0.0);
+    }
+
+  obj->numPolePairs = 1;
+  obj->polePairs = _IQ(1.0);
+  obj->oneOverPolePairs = _IQ(1.0);
+  obj->gain = _IQ(0.0);
+  obj->maxCoeff_pu = _IQ(0.0);
+  obj->inertia_pu = _IQ(0.0);
+  obj->meanFilterCoeff = _IQ(0.0);
+  obj->minAngleDelta_pu = _IQ(0.0);
+  obj->alignNumUpdates = 1;
+
+  obj->flag_enableLearning = false;
+  obj->flag_enableOutput = false;
+
+  obj->angleMech_poles = _IQ(0.0);
+  obj->angleMech = 0;
+
+  HCOMP_reset(handle);
+  HCOMP_start(handle);
+
+  return(handle);
+} // end of HCOMP_init() function
+
+
+void HCOMP_reset(HCOMP_Handle handle)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+  uint_least16_t num;
+
+
+  for(num=0;num<HCOMP_MAX_HARMONICS;num++)
+    {
+      obj->harmonic[num].a = _IQ(0.0);
+      obj->harmonic[num].b = _IQ(0.0);
+      obj->harmonic[num].aKept = _IQ(0.0);
+      obj->harmonic[num].bKept = _IQ(0.0);
+    }
+
+  obj->flag_align = false;
+
+  if(obj->pTable != NULL)
+    {
+      uint_least16_t index;
+
+      for(index=0;index<HCOMP_getTableSize(handle);index++)
+        {
+          obj->pTable[index] = _IQ(0.0);
+        }
+    }
+
+  obj->resMean_pu = _IQ(0.0);
+  obj->res_pu = _IQ(0.0);
+  obj->Iq_ff_pu = _IQ(0.0);
+
+  return;
+} // end of HCOMP_reset() function
+
+
+void HCOMP_setHarmonic(HCOMP_Handle handle,const uint_least16_t num,const uint_least16_t order)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+  HCOMP_Harmonic_t *pHarm = &obj->harmonic[num];
+  uint_least16_t shift = GLOBAL_Q - obj->tableShift;
+  _iq step = (_iq)(((uint32_t)order << shift) & HCOMP_ANGLE_MASK);
+
+
+  if((num >= obj->numHarmonics) || (obj->pTable == NULL))
+    {
+      return;
+    }
+
+  pHarm->order = order;
+  pHarm->a = _IQ(0.0);
+  pHarm->b = _IQ(0.0);
+  pHarm->aKept = _IQ(0.0);
+  pHarm->bKept = _IQ(0.0);
+  pHarm->cosStep = _IQcosPU(step);
+  pHarm->sinStep = _IQsinPU(step);
+
+  HCOMP_setSynthPhasor(obj,pHarm);
+
+  return;
+} // end of HCOMP_setHarmonic() function
+
+
+void HCOMP_setParams(HCOMP_Handle handle,
+                     const uint_least16_t numHarmonics,
+                     const uint_least16_t numPolePairs,
+                     const _iq gain,
+                     const _iq maxCoeff_pu,
+                     const _iq inertia_pu,
+                     const _iq meanFilterCoeff,
+                     const _iq minAngleDelta_pu)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  obj->numHarmonics = (numHarmonics > HCOMP_MAX_HARMONICS) ? HCOMP_MAX_HARMONICS : numHarmonics;
+  obj->numPolePairs = (numPolePairs > 0) ? numPolePairs : 1;
+  obj->polePairs = (_iq)obj->numPolePairs << GLOBAL_Q;
+  obj->oneOverPolePairs = _IQdiv(_IQ(1.0),obj->polePairs);
+  obj->gain = gain;
+  obj->maxCoeff_pu = maxCoeff_pu;
+  obj->inertia_pu = inertia_pu;
+  obj->meanFilterCoeff = meanFilterCoeff;
+  obj->minAngleDelta_pu = minAngleDelta_pu;
+  obj->learnNum = obj->numHarmonics;
+
+  // align after about one time constant of the learning
+  if(gain > _IQ(0.0))
+    {
+      uint32_t numUpdates = ((uint32_t)1 << GLOBAL_Q) / (uint32_t)gain;
+
+      obj->alignNumUpdates = (numUpdates > 0xFFFF) ? 0xFFFF : ((numUpdates < 1) ? 1 : (uint_least16_t)numUpdates);
+    }
+  else
+    {
+      obj->alignNumUpdates = 1;
+    }
+
+  return;
+} // end of HCOMP_setParams() function
+
+
+uint_least16_t HCOMP_setTable(HCOMP_Handle handle,_iq *pTable,const uint_least16_t tableShift)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+  uint_least16_t num;
+
+
+  if((pTable == NULL) || (tableShift < HCOMP_MIN_TABLE_SHIFT) ||
+     (tableShift > HCOMP_MAX_TABLE_SHIFT) || (tableShift > GLOBAL_Q))
+    {
+      obj->pTable = NULL;
+      obj->flag_enableOutput = false;
+      return(0);
+    }
+
+  obj->pTable = pTable;
+  obj->tableShift = tableShift;
+  obj->synthIndex = 0;
+
+  for(num=0;num<HCOMP_MAX_HARMONICS;num++)
+    {
+      obj->harmonic[num].cosSynth = _IQ(1.0);
+      obj->harmonic[num].sinSynth = _IQ(0.0);
+    }
+
+  HCOMP_reset(handle);
+
+  return(HCOMP_getTableSize(handle));
+} // end of HCOMP_setTable() function
+
+
+void HCOMP_start(HCOMP_Handle handle)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+  uint_least16_t num;
+  bool flag_kept = false;
+
+
+  // the mechanical angle is only known up to a pole pair, keep the other
+  // orders aside and learn them again until HCOMP_align() found it
+  for(num=0;num<obj->numHarmonics;num++)
+    {
+      HCOMP_Harmonic_t *pHarm = &obj->harmonic[num];
+
+      if((pHarm->order % obj->numPolePairs) != 0)
+        {
+          // a start before the alignment keeps the coefficients kept before
+          if(!obj->flag_align)
+            {
+              pHarm->aKept = pHarm->a;
+              pHarm->bKept = pHarm->b;
+            }
+
+          pHarm->a = _IQ(0.0);
+          pHarm->b = _IQ(0.0);
+
+          flag_kept = flag_kept || (pHarm->aKept != _IQ(0.0)) || (pHarm->bKept != _IQ(0.0));
+        }
+    }
+
+  obj->flag_align = flag_kept;
+  obj->alignCnt = 0;
+
+  obj->flag_firstTick = true;
+  obj->flag_firstUpdate = true;
+  obj->angleDelta_poles = _IQ(0.0);
+  obj->resMean_pu = _IQ(0.0);
+  obj->learnNum = obj->numHarmonics;
+  obj->Iq_ff_pu = _IQ(0.0);
+
+  return;
+} // end of HCOMP_start() function
+
+// end of file
@@ -0,0 +1,605 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _HCOMP_H_
+#define _HCOMP_H_
+
+//! \file   modules/hcomp/src/32b/hcomp.h
+//! \brief  Contains the public interface to the
+//!         harmonic compensator (HCOMP) module routines
+//!
+//!         An open alternative to the VIB_COMP library.  A torque that
+//!         repeats with the mechanical angle, the cogging of the magnets
+//!         over the slots or the once per revolution pull of an unbalanced
+//!         propeller, shakes the rotor and the frame.  The module learns the
+//!         quadrature current that cancels it as a sum of harmonics of the
+//!         mechanical angle th
+//!
+//!           Iq_ff(th) = sum over h of a[h]*cos(n[h]*th) + b[h]*sin(n[h]*th)
+//!
+//!         and feeds it forward into the current reference.  The orders n[h]
+//!         are selected by the project.
+//!
+//!         The speed controller only answers a disturbance up to its own
+//!         bandwidth and with a lag that changes with the frequency, so its
+//!         output alone is a poor measure of the torque ripple.  Over one
+//!         period of the speed controller the rotor inertia J is accelerated
+//!         by the motor torque less the disturbance, with the current Iq and
+//!         the speed w in pu
+//!
+//!           Iq_spd + Iq_ff - Iq_dist = K_J*(w[k] - w[k-1])
+//!
+//!         where K_J is the current that changes the speed by one pu over a
+//!         period.  The residual e = Iq_spd - K_J*(w[k] - w[k-1]) is then
+//!         Iq_dist - Iq_ff averaged over the period, independent of the
+//!         dynamics of the speed loop.  It is correlated with the basis of
+//!         every harmonic at the mechanical angle of the middle of the
+//!         period
+//!
+//!           a[h] += gain*e*cos(n[h]*th),  b[h] += gain*e*sin(n[h]*th)
+//!
+//!         and the coefficients settle at the harmonics of the disturbance.
+//!         An error of K_J only slows the learning down, with K_J zero the
+//!         module learns from the output of the speed controller alone,
+//!         which is enough below the bandwidth of the speed loop.  A harmonic
+//!         is only learned while it completes less than 0.4 of a period per
+//!         period of the speed controller, above that its feedforward is
+//!         kept.
+//!
+//!         The feedforward is read from a table over one mechanical
+//!         revolution with linear interpolation.  The table is rebuilt one
+//!         entry per tick from the coefficients with a rotating phasor per
+//!         harmonic and one harmonic is learned per tick, so a tick costs
+//!         at most one sine and cosine and a few multiplications per
+//!         harmonic whatever the table size.  The size is a power of two,
+//!         the table memory is provided by the project.
+//!
+//!         The mechanical angle is counted from the electrical angle.  It
+//!         is only known up to a multiple k of one revolution over the
+//!         number of pole pairs P after the angle of the rotor was lost, the
+//!         rotor may have turned by any number of electrical revolutions
+//!         while the motor was stopped.  The harmonics whose order is a
+//!         multiple of P, such as the cogging, do not depend on k and are
+//!         kept on a start.  The others, such as order 1 of the unbalanced
+//!         propeller, are kept aside by HCOMP_start() and learned from zero
+//!         for about one time constant of the learning.  The kept
+//!         coefficients turned by each of the P candidates of k are then
+//!         correlated with the ones just learned,
+//!
+//!           k = arg max over k of sum over h of Re{C'[h] * conj(C[h]) * e^(j*2*pi*n[h]*k/P)}
+//!
+//!         with C = a + j*b, the counted mechanical angle is moved by k/P of
+//!         a revolution and the kept coefficients are restored.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+
+
+//!
+//!
+//! \defgroup HCOMP HCOMP
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the maximum number of harmonics
+//!
+#define HCOMP_MAX_HARMONICS         (8)
+
+//! \brief Defines the smallest and the largest number of table entries as a power of two
+//!
+#define HCOMP_MIN_TABLE_SHIFT       (4)
+#define HCOMP_MAX_TABLE_SHIFT       (12)
+
+//! \brief Defines the mask of one revolution, the angles are kept as the fraction of a revolution in GLOBAL_Q
+//!
+#define HCOMP_ANGLE_MASK            ((uint32_t)((1L << GLOBAL_Q) - 1))
+
+//! \brief Defines the shift of the inertia current K_J, it is kept divided by 2^HCOMP_INERTIA_SHIFT so heavy propellers fit
+//!
+#define HCOMP_INERTIA_SHIFT         (6)
+
+//! \brief Defines the largest phase of a harmonic per period of the speed controller it is learned at, fraction of a period
+//!
+#define HCOMP_MAX_PHASE_PER_UPDATE  (_IQ(0.4))
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines a learned harmonic
+//!
+typedef struct _HCOMP_Harmonic_t_
+{
+  uint_least16_t  order;              //!< the order, periods per mechanical revolution
+  _iq             a;                  //!< the learned cosine coefficient, pu
+  _iq             b;                  //!< the learned sine coefficient, pu
+  _iq             cosStep;            //!< the cosine of the phase step per table entry
+  _iq             sinStep;            //!< the sine of the phase step per table entry
+  _iq             cosSynth;           //!< the cosine of the phase of the table entry synthesized next
+  _iq             sinSynth;           //!< the sine of the phase of the table entry synthesized next
+  _iq             aKept;              //!< the cosine coefficient learned before the start, held until the mechanical angle is aligned, pu
+  _iq             bKept;              //!< the sine coefficient learned before the start, held until the mechanical angle is aligned, pu
+} HCOMP_Harmonic_t;
+
+
+//! \brief Defines the harmonic compensator (HCOMP) object
+//!
+typedef struct _HCOMP_Obj_
+{
+  _iq            *pTable;             //!< the feedforward table over one mechanical revolution, pu
+  uint_least16_t  tableShift;         //!< the number of table entries as a power of two
+  uint_least16_t  numHarmonics;       //!< the number of harmonics
+  HCOMP_Harmonic_t harmonic[HCOMP_MAX_HARMONICS]; //!< the harmonics
+
+  uint_least16_t  numPolePairs;       //!< the number of pole pairs
+  _iq             polePairs;          //!< the number of pole pairs, one mechanical revolution in electrical revolutions
+  _iq             oneOverPolePairs;   //!< one over the number of pole pairs
+  _iq             gain;               //!< the learning gain per period of the speed controller
+  _iq             maxCoeff_pu;        //!< the limit of the magnitude of each coefficient, pu
+  _iq             inertia_pu;         //!< the current K_J that changes the speed by one pu over a period, pu, divided by 2^HCOMP_INERTIA_SHIFT
+  _iq             meanFilterCoeff;    //!< the coefficient of the low pass filter of the mean of the residual, per period
+  _iq             minAngleDelta_pu;   //!< the smallest mechanical angle per period the compensator learns at, pu
+
+  bool            flag_enableLearning; //!< enables the learning of the coefficients
+  bool            flag_enableOutput;  //!< enables the feedforward output
+  bool            flag_firstTick;     //!< denotes that the electrical angle of the last tick is not valid yet
+  bool            flag_firstUpdate;   //!< denotes that the speed of the last period is not valid yet
+  bool            flag_align;         //!< denotes that the mechanical angle is not aligned with the kept harmonics yet
+  uint_least16_t  alignCnt;           //!< the number of periods learned since the start
+  uint_least16_t  alignNumUpdates;    //!< the number of periods learned before the mechanical angle is aligned, one over the gain
+
+  _iq             angle_z1_pu;        //!< the electrical angle of the last tick, pu
+  _iq             angleMech_poles;    //!< the mechanical angle times the number of pole pairs, 0 to numPolePairs
+  uint32_t        angleMech;          //!< the mechanical angle, fraction of a revolution in GLOBAL_Q
+  _iq             angleDelta_poles;   //!< the mechanical angle times the number of pole pairs travelled in the period
+  _iq             speed_z1_pu;        //!< the speed of the last period, pu
+  _iq             resMean_pu;         //!< the filtered mean of the residual, pu
+  _iq             res_pu;             //!< the residual of the last period less its mean, pu
+  uint32_t        angleRes;           //!< the mechanical angle of the middle of the last period, fraction of a revolution in GLOBAL_Q
+  _iq             angleDeltaRes_pu;   //!< the mechanical angle travelled in the last period, pu
+  uint_least16_t  learnNum;           //!< the harmonic learned next, numHarmonics when done
+  uint_least16_t  synthIndex;         //!< the table entry synthesized next
+  _iq             Iq_ff_pu;           //!< the feedforward of the tick, pu
+} HCOMP_Obj;
+
+
+//! \brief Defines the HCOMP handle
+//!
+typedef struct _HCOMP_Obj_ *HCOMP_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Aligns the mechanical angle with the harmonics kept over a start
+//! \details   Called by HCOMP_update() once the harmonics whose order is not
+//!            a multiple of the number of pole pairs were learned for
+//!            alignNumUpdates periods after a start.  Moves the mechanical
+//!            angle by the number of revolutions over the number of pole
+//!            pairs that best matches the kept coefficients to the learned
+//!            ones and restores the kept coefficients.
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+extern void HCOMP_align(HCOMP_Handle handle);
+
+
+//! \brief     Gets the magnitude of a learned harmonic
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+//! \param[in] num     The harmonic number
+//! \return    The magnitude, pu
+static inline _iq HCOMP_getAmplitude_pu(HCOMP_Handle handle,const uint_least16_t num)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  return(_IQmag(obj->harmonic[num].a,obj->harmonic[num].b));
+} // end of HCOMP_getAmplitude_pu() function
+
+
+//! \brief     Gets the mechanical angle
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+//! \return    The mechanical angle, 0 to 1 pu
+static inline _iq HCOMP_getAngleMech_pu(HCOMP_Handle handle)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  return((_iq)obj->angleMech);
+} // end of HCOMP_getAngleMech_pu() function
+
+
+//! \brief     Gets the enable learning flag
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+//! \return    The enable learning flag
+static inline bool HCOMP_getFlag_enableLearning(HCOMP_Handle handle)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  return(obj->flag_enableLearning);
+} // end of HCOMP_getFlag_enableLearning() function
+
+
+//! \brief     Gets the enable output flag
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+//! \return    The enable output flag
+static inline bool HCOMP_getFlag_enableOutput(HCOMP_Handle handle)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  return(obj->flag_enableOutput);
+} // end of HCOMP_getFlag_enableOutput() function
+
+
+//! \brief     Gets the quadrature current feedforward
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+//! \return    The feedforward of the tick, zero with the output disabled, pu
+static inline _iq HCOMP_getIq_ff_pu(HCOMP_Handle handle)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  return(obj->Iq_ff_pu);
+} // end of HCOMP_getIq_ff_pu() function
+
+
+//! \brief     Gets the number of harmonics
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+//! \return    The number of harmonics
+static inline uint_least16_t HCOMP_getNumHarmonics(HCOMP_Handle handle)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  return(obj->numHarmonics);
+} // end of HCOMP_getNumHarmonics() function
+
+
+//! \brief     Gets the order of a harmonic
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+//! \param[in] num     The harmonic number
+//! \return    The order, periods per mechanical revolution
+static inline uint_least16_t HCOMP_getOrder(HCOMP_Handle handle,const uint_least16_t num)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  return(obj->harmonic[num].order);
+} // end of HCOMP_getOrder() function
+
+
+//! \brief     Gets the number of table entries
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+//! \return    The number of table entries
+static inline uint_least16_t HCOMP_getTableSize(HCOMP_Handle handle)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  return((uint_least16_t)1 << obj->tableShift);
+} // end of HCOMP_getTableSize() function
+
+
+//! \brief     Initializes the harmonic compensator (HCOMP) module
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The harmonic compensator (HCOMP) handle
+extern HCOMP_Handle HCOMP_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Clears the learned coefficients and the table
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+extern void HCOMP_reset(HCOMP_Handle handle);
+
+
+//! \brief     Sets the enable learning flag
+//! \details   With the learning disabled the learned feedforward is kept
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+//! \param[in] state   The desired state
+static inline void HCOMP_setFlag_enableLearning(HCOMP_Handle handle,const bool state)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  obj->flag_enableLearning = state;
+
+  return;
+} // end of HCOMP_setFlag_enableLearning() function
+
+
+//! \brief     Sets the enable output flag
+//! \details   The residual assumes the feedforward is applied, the learning
+//!            stops while the output is disabled
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+//! \param[in] state   The desired state
+static inline void HCOMP_setFlag_enableOutput(HCOMP_Handle handle,const bool state)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  obj->flag_enableOutput = state;
+
+  return;
+} // end of HCOMP_setFlag_enableOutput() function
+
+
+//! \brief     Sets a harmonic
+//! \details   The coefficients of the harmonic are cleared, also the ones kept over a start
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+//! \param[in] num     The harmonic number, less than the number of harmonics
+//! \param[in] order   The order, periods per mechanical revolution
+extern void HCOMP_setHarmonic(HCOMP_Handle handle,const uint_least16_t num,const uint_least16_t order);
+
+
+//! \brief     Sets the compensator parameters
+//! \param[in] handle            The harmonic compensator (HCOMP) handle
+//! \param[in] numHarmonics      The number of harmonics, up to HCOMP_MAX_HARMONICS
+//! \param[in] numPolePairs      The number of pole pairs
+//! \param[in] gain              The learning gain per period of the speed controller
+//! \param[in] maxCoeff_pu       The limit of the magnitude of each coefficient, pu
+//! \param[in] inertia_pu        The current K_J that changes the speed by one pu over a period, pu, divided by 2^HCOMP_INERTIA_SHIFT
+//! \param[in] meanFilterCoeff   The coefficient of the low pass filter of the mean of the residual, per period
+//! \param[in] minAngleDelta_pu  The smallest mechanical angle per period the compensator learns at, pu
+extern void HCOMP_setParams(HCOMP_Handle handle,
+                            const uint_least16_t numHarmonics,
+                            const uint_least16_t numPolePairs,
+                            const _iq gain,
+                            const _iq maxCoeff_pu,
+                            const _iq inertia_pu,
+                            const _iq meanFilterCoeff,
+                            const _iq minAngleDelta_pu);
+
+
+//! \brief     Sets the feedforward table
+//! \details   Call before HCOMP_setHarmonic(), the table is cleared
+//! \param[in] handle      The harmonic compensator (HCOMP) handle
+//! \param[in] pTable      The pointer to the table memory, 2^tableShift entries
+//! \param[in] tableShift  The number of table entries as a power of two, HCOMP_MIN_TABLE_SHIFT to HCOMP_MAX_TABLE_SHIFT
+//! \return    The number of table entries, zero for an invalid size
+extern uint_least16_t HCOMP_setTable(HCOMP_Handle handle,_iq *pTable,const uint_least16_t tableShift);
+
+
+//! \brief     Starts the compensator on a new run of the motor
+//! \details   The mechanical angle is counted again from the electrical
+//!            angle of the next tick, up to a whole number of electrical
+//!            revolutions.  The harmonics whose order is a multiple of the
+//!            number of pole pairs keep their coefficients.  The
+//!            coefficients of the others are kept aside and learned from
+//!            zero until HCOMP_align() found the number of electrical
+//!            revolutions and restored them, their table entries are
+//!            rebuilt within one pass of the table.
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+extern void HCOMP_start(HCOMP_Handle handle);
+
+
+//! \brief     Synthesizes the next table entry from the coefficients
+//! \param[in] obj  The harmonic compensator (HCOMP) object
+static inline void HCOMP_synthesize(HCOMP_Obj *obj)
+{
+  uint_least16_t mask = ((uint_least16_t)1 << obj->tableShift) - 1;
+  uint_least16_t num;
+  _iq sum = _IQ(0.0);
+
+  for(num=0;num<obj->numHarmonics;num++)
+    {
+      HCOMP_Harmonic_t *pHarm = &obj->harmonic[num];
+      _iq cosSynth = pHarm->cosSynth;
+      _iq sinSynth = pHarm->sinSynth;
+
+      sum += _IQmpy(pHarm->a,cosSynth) + _IQmpy(pHarm->b,sinSynth);
+
+      // rotate to the next entry, from the exact phasor at the start of a pass
+      if(obj->synthIndex == mask)
+        {
+          pHarm->cosSynth = _IQ(1.0);
+          pHarm->sinSynth = _IQ(0.0);
+        }
+      else
+        {
+          pHarm->cosSynth = _IQmpy(cosSynth,pHarm->cosStep) - _IQmpy(sinSynth,pHarm->sinStep);
+          pHarm->sinSynth = _IQmpy(sinSynth,pHarm->cosStep) + _IQmpy(cosSynth,pHarm->sinStep);
+        }
+    }
+
+  obj->pTable[obj->synthIndex] = sum;
+  obj->synthIndex = (obj->synthIndex + 1) & mask;
+
+  return;
+} // end of HCOMP_synthesize() function
+
+
+//! \brief     Discards the period of the speed controller that ended
+//! \details   Call instead of HCOMP_update() when the feedforward was not
+//!            applied, the residual of the next period is not valid either
+//! \param[in] handle  The harmonic compensator (HCOMP) handle
+static inline void HCOMP_resetUpdate(HCOMP_Handle handle)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  obj->angleDelta_poles = _IQ(0.0);
+  obj->flag_firstUpdate = true;
+
+  return;
+} // end of HCOMP_resetUpdate() function
+
+
+//! \brief     Runs the harmonic compensator
+//! \details   Call every tick with the electrical angle of the controller,
+//!            after HCOMP_update() on the ticks of the speed controller.
+//!            Learns one harmonic from the residual of the last period,
+//!            rebuilds one table entry and reads the feedforward.
+//! \param[in] handle    The harmonic compensator (HCOMP) handle
+//! \param[in] angle_pu  The electrical angle, pu
+static inline void HCOMP_run(HCOMP_Handle handle,const _iq angle_pu)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+
+  if(obj->pTable == NULL)
+    {
+      return;
+    }
+
+  // count the mechanical angle from the change of the electrical angle, on
+  // the first tick take the fraction of the electrical revolution from it
+  if(obj->flag_firstTick)
+    {
+      obj->angleMech_poles = (_iq)(((uint32_t)obj->angleMech_poles & ~HCOMP_ANGLE_MASK) |
+                                   ((uint32_t)angle_pu & HCOMP_ANGLE_MASK));
+    }
+  else
+    {
+      _iq angleDelta_pu = angle_pu - obj->angle_z1_pu;
+
+      if(angleDelta_pu > _IQ(0.5))
+        {
+          angleDelta_pu -= _IQ(1.0);
+        }
+      else if(angleDelta_pu < _IQ(-0.5))
+        {
+          angleDelta_pu += _IQ(1.0);
+        }
+
+      obj->angleMech_poles += angleDelta_pu;
+      obj->angleDelta_poles += angleDelta_pu;
+
+      if(obj->angleMech_poles >= obj->polePairs)
+        {
+          obj->angleMech_poles -= obj->polePairs;
+        }
+      else if(obj->angleMech_poles < _IQ(0.0))
+        {
+          obj->angleMech_poles += obj->polePairs;
+        }
+    }
+
+  // a rounded product at the end of the revolution wraps to zero
+  obj->angleMech = (uint32_t)_IQmpy(obj->angleMech_poles,obj->oneOverPolePairs) & HCOMP_ANGLE_MASK;
+
+  obj->angle_z1_pu = angle_pu;
+  obj->flag_firstTick = false;
+
+  // learn one harmonic per tick from the residual of the last period
+  if(obj->learnNum < obj->numHarmonics)
+    {
+      HCOMP_Harmonic_t *pHarm = &obj->harmonic[obj->learnNum];
+      _iq phaseDelta_pu = _IQabs(obj->angleDeltaRes_pu * (int32_t)pHarm->order);
+
+      if(phaseDelta_pu < HCOMP_MAX_PHASE_PER_UPDATE)
+        {
+          _iq phase = (_iq)((obj->angleRes * (uint32_t)pHarm->order) & HCOMP_ANGLE_MASK);
+          _iq err = _IQmpy(obj->gain,obj->res_pu);
+
+          pHarm->a = _IQsat(pHarm->a + _IQmpy(err,_IQcosPU(phase)),obj->maxCoeff_pu,-obj->maxCoeff_pu);
+          pHarm->b = _IQsat(pHarm->b + _IQmpy(err,_IQsinPU(phase)),obj->maxCoeff_pu,-obj->maxCoeff_pu);
+        }
+
+      obj->learnNum++;
+    }
+
+  HCOMP_synthesize(obj);
+
+  // read the table with linear interpolation
+  if(obj->flag_enableOutput)
+    {
+      uint_least16_t mask = ((uint_least16_t)1 << obj->tableShift) - 1;
+      uint_least16_t index = (uint_least16_t)(obj->angleMech >> (GLOBAL_Q - obj->tableShift));
+      _iq frac = (_iq)((obj->angleMech << obj->tableShift) & HCOMP_ANGLE_MASK);
+      _iq value = obj->pTable[index];
+
+      obj->Iq_ff_pu = value + _IQmpy(frac,obj->pTable[(index + 1) & mask] - value);
+    }
+  else
+    {
+      obj->Iq_ff_pu = _IQ(0.0);
+    }
+
+  return;
+} // end of HCOMP_run() function
+
+
+//! \brief     Updates the residual of the disturbance
+//! \details   Call on every tick of the speed controller before it runs,
+//!            with its output still the one held over the period that just
+//!            ended.  The harmonics learn from the residual on the next
+//!            ticks of HCOMP_run().
+//! \param[in] handle    The harmonic compensator (HCOMP) handle
+//! \param[in] in_pu     The output of the speed controller, pu
+//! \param[in] speed_pu  The speed feedback of the speed controller, pu
+static inline void HCOMP_update(HCOMP_Handle handle,const _iq in_pu,const _iq speed_pu)
+{
+  HCOMP_Obj *obj = (HCOMP_Obj *)handle;
+  _iq angleDelta_pu = _IQmpy(obj->angleDelta_poles,obj->oneOverPolePairs);
+
+  if(!obj->flag_firstUpdate)
+    {
+      // the current that did not go into accelerating the rotor
+      _iq accel_pu = (speed_pu - obj->speed_z1_pu) << HCOMP_INERTIA_SHIFT;
+      _iq res_pu = in_pu - _IQmpy(obj->inertia_pu,accel_pu);
+
+      obj->resMean_pu += _IQmpy(obj->meanFilterCoeff,res_pu - obj->resMean_pu);
+
+      if(obj->flag_enableLearning && obj->flag_enableOutput &&
+         (_IQabs(angleDelta_pu) >= obj->minAngleDelta_pu))
+        {
+          obj->res_pu = res_pu - obj->resMean_pu;
+          obj->angleRes = (obj->angleMech - (uint32_t)(angleDelta_pu >> 1)) & HCOMP_ANGLE_MASK;
+          obj->angleDeltaRes_pu = angleDelta_pu;
+          obj->learnNum = 0;
+
+          // after a start, align once the other orders were learned again for a while
+          if(obj->flag_align && (++obj->alignCnt >= obj->alignNumUpdates))
+            {
+              HCOMP_align(handle);
+            }
+        }
+    }
+
+  obj->speed_z1_pu = speed_pu;
+  obj->angleDelta_poles = _IQ(0.0);
+  obj->flag_firstUpdate = false;
+
+  return;
+} // end of HCOMP_update() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _HCOMP_H_ definition
+
@@ -0,0 +1,166 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/hfi/src/32b/hfi.c
+//! \brief  Portable C code.  These functions define the
+//!         high frequency injection (HFI) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/hfi/src/32b/hfi.h"
+
+
+// **************************************************************************
+// the functions
+
+HFI_Handle HFI_init(void *pMemory,const size_t numBytes)
+{
+  HFI_Handle handle;
+  HFI_Obj *obj;
+
+
+  if(numBytes < sizeof(HFI_Obj))
+    return((HFI_Handle)NULL);
+
+  // assign the handle
+  handle = (HFI_Handle)pMemory;
+
+  obj = (HFI_Obj *)handle;
+
+  obj->Vinj_pu = _IQ(0.0);
+  obj->Kp = _IQ(0.0);
+  obj->Ki = _IQ(0.0);
+  obj->speedScale = _IQ(0.0);
+  obj->speedScaleInv = _IQ(0.0);
+  obj->speedFilterCoeff = _IQ(0.0);
+  obj->handoverSpeed_pu = _IQ(0.0);
+  obj->handbackSpeed_pu = _IQ(0.0);
+  obj->Id_polarity_pu = _IQ(0.0);
+  obj->numAlignTicks = 0;
+  obj->numPolarityTicks = 0;
+
+  HFI_stop(handle);
+
+  return(handle);
+} // end of HFI_init() function
+
+
+void HFI_setHandover(HFI_Handle handle,
+                     const _iq handoverSpeed_pu,
+                     const _iq handbackSpeed_pu)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  obj->handoverSpeed_pu = handoverSpeed_pu;
+  obj->handbackSpeed_pu = handbackSpeed_pu;
+
+  return;
+} // end of HFI_setHandover() function
+
+
+void HFI_setParams(HFI_Handle handle,
+                   const _iq Vinj_pu,
+                   const _iq Kp,
+                   const _iq Ki,
+                   const _iq speedScale,
+                   const _iq speedFilterCoeff)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  obj->Vinj_pu = Vinj_pu;
+  obj->Kp = Kp;
+  obj->Ki = Ki;
+  obj->speedScale = speedScale;
+  obj->speedScaleInv = _IQdiv(_IQ(1.0),speedScale);
+  obj->speedFilterCoeff = speedFilterCoeff;
+
+  return;
+} // end of HFI_setParams() function
+
+
+void HFI_setPolarity(HFI_Handle handle,
+                     const _iq Id_polarity_pu,
+                     const uint_least32_t numAlignTicks,
+                     const uint_least32_t numPolarityTicks)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  obj->Id_polarity_pu = Id_polarity_pu;
+  obj->numAlignTicks = numAlignTicks;
+  obj->numPolarityTicks = numPolarityTicks;
+
+  return;
+} // end of HFI_setPolarity() function
+
+
+void HFI_start(HFI_Handle handle)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  HFI_stop(handle);
+
+  obj->state = HFI_State_Align;
+
+  return;
+} // end of HFI_start() function
+
+
+void HFI_stop(HFI_Handle handle)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  obj->state = HFI_State_Idle;
+  obj->sign = 0;
+  obj->counter = 0;
+  obj->Iab_prev.value[0] = _IQ(0.0);
+  obj->Iab_prev.value[1] = _IQ(0.0);
+  obj->Idq_hf.value[0] = _IQ(0.0);
+  obj->Idq_hf.value[1] = _IQ(0.0);
+  obj->phasor.value[0] = _IQ(1.0);
+  obj->phasor.value[1] = _IQ(0.0);
+  obj->err = _IQ(0.0);
+  obj->speedTick_pu = _IQ(0.0);
+  obj->speed_pu = _IQ(0.0);
+  obj->angle_pu = _IQ(0.0);
+  obj->Vinj_out_pu = _IQ(0.0);
+  obj->Id_ref_pu = _IQ(0.0);
+  obj->polaritySum[0] = _IQ(0.0);
+  obj->polaritySum[1] = _IQ(0.0);
+  obj->flag_polarityFlipped = false;
+
+  return;
+} // end of HFI_stop() function
+
+// end of file
@@ -0,0 +1,493 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _HFI_H_
+#define _HFI_H_
+
+//! \file   modules/hfi/src/32b/hfi.h
+//! \brief  Contains the public interface to the
+//!         high frequency injection (HFI) module routines
+//!
+//!         A square wave voltage of alternating sign every ISR tick is
+//!         injected on the estimated direct axis.  On a salient motor, Ld
+//!         smaller than Lq, the current step it causes has a component on
+//!         the estimated quadrature axis proportional to the sine of twice
+//!         the angle error:
+//!
+//!           dId = Vinj*Ts*(1/Ld + 1/Lq)/2 + Vinj*Ts*(1/Ld - 1/Lq)/2*cos(2*err)
+//!           dIq =                           Vinj*Ts*(1/Ld - 1/Lq)/2*sin(2*err)
+//!
+//!         HFI_demodulate() takes the difference of two current samples,
+//!         multiplies it by the sign of the injection and rotates it into
+//!         the estimated frame.  The mean of the two samples is the
+//!         fundamental current, which replaces the samples for the estimator
+//!         and the current controllers.  dIq over dId drives a tracking PLL
+//!         in HFI_run(), the ratio does not depend on the dc bus voltage or
+//!         the inductance magnitude.
+//!
+//!         The PLL locks to the rotor axis with a 180 degree ambiguity.  The
+//!         polarity is found after the alignment from the saturation of the
+//!         direct axis: a positive Id along the magnet flux lowers Ld and
+//!         raises dId, a negative Id does the opposite.
+//!
+//!         Above the handover speed the angle and speed of the estimator
+//!         are passed through and the injection stops, below the handback
+//!         speed the PLL restarts from the estimator angle.
+//!
+//!         The sample at ISR tick n sees the compare values written at tick
+//!         n - 1 for all PWM periods of the tick except the first, so the
+//!         current step is attributed to the injection of the previous tick.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+#include "sw/modules/math/src/32b/math.h"
+
+
+//!
+//!
+//! \defgroup HFI HFI
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the smallest direct axis current step used for the angle error, pu
+//!
+#define HFI_MIN_ID_STEP_pu          (_IQ(0.001))
+
+//! \brief Defines the largest angle error signal, dIq over dId
+//!
+#define HFI_MAX_ERROR               (_IQ(1.0))
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Enumeration for the high frequency injection states
+//!
+typedef enum
+{
+  HFI_State_Idle = 0,       //!< no injection
+  HFI_State_Align,          //!< the PLL locks to the rotor axis
+  HFI_State_Polarity,       //!< the direct axis current pulses find the north pole
+  HFI_State_Run,            //!< the angle of the injection is used
+  HFI_State_Fast,           //!< the angle of the estimator is used
+  HFI_NumStates
+} HFI_State_e;
+
+
+//! \brief Defines the high frequency injection (HFI) object
+//!
+typedef struct _HFI_Obj_
+{
+  HFI_State_e     state;              //!< the state
+
+  _iq             Vinj_pu;            //!< the injected voltage at a dc bus of 1 pu, in controller output units
+  _iq             Kp;                 //!< the proportional gain of the PLL
+  _iq             Ki;                 //!< the integral gain of the PLL
+  _iq             speedScale;         //!< the ISR frequency over the full scale frequency
+  _iq             speedScaleInv;      //!< the full scale frequency over the ISR frequency
+  _iq             speedFilterCoeff;   //!< the coefficient of the speed low pass filter
+  _iq             handoverSpeed_pu;   //!< the speed above which the estimator angle is used, pu
+  _iq             handbackSpeed_pu;   //!< the speed below which the injection angle is used, pu
+  _iq             Id_polarity_pu;     //!< the direct axis current of the polarity detection, pu
+  uint_least32_t  numAlignTicks;      //!< the duration of the alignment, ISR ticks
+  uint_least32_t  numPolarityTicks;   //!< the duration of each polarity pulse, ISR ticks
+
+  int_least8_t    sign;               //!< the sign of the injection of the last tick, 0 without injection
+  uint_least32_t  counter;            //!< the ticks in the current state
+  MATH_vec2       Iab_prev;           //!< the current sample of the last tick, pu
+  MATH_vec2       Idq_hf;             //!< the demodulated current step in the estimated frame, pu
+  MATH_vec2       phasor;             //!< the cosine and sine of the angle of the last tick
+  _iq             err;                //!< the angle error signal, dIq over dId
+  _iq             speedTick_pu;       //!< the PLL integrator, angle per ISR tick, pu
+  _iq             speed_pu;           //!< the filtered speed, pu
+  _iq             angle_pu;           //!< the angle, -0.5 to 0.5 pu
+  _iq             Vinj_out_pu;        //!< the injected voltage of this tick
+  _iq             Id_ref_pu;          //!< the direct axis current reference of the polarity detection, pu
+  _iq             polaritySum[2];     //!< the sum of dId with a positive and a negative Id, pu
+  bool            flag_polarityFlipped; //!< denotes that the polarity detection turned the angle by 180 degrees
+} HFI_Obj;
+
+
+//! \brief Defines the HFI handle
+//!
+typedef struct _HFI_Obj_ *HFI_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Gets the angle
+//! \param[in] handle  The high frequency injection (HFI) handle
+//! \return    The angle, -0.5 to 0.5 pu
+static inline _iq HFI_getAngle_pu(HFI_Handle handle)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  return(obj->angle_pu);
+} // end of HFI_getAngle_pu() function
+
+
+//! \brief     Gets the angle error signal
+//! \param[in] handle  The high frequency injection (HFI) handle
+//! \return    The demodulated dIq over dId, about (Lq - Ld)/(Lq + Ld)*sin(2*err)
+static inline _iq HFI_getErr(HFI_Handle handle)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  return(obj->err);
+} // end of HFI_getErr() function
+
+
+//! \brief     Gets the flag denoting that the polarity detection turned the angle
+//! \param[in] handle  The high frequency injection (HFI) handle
+//! \return    The flag
+static inline bool HFI_getFlag_polarityFlipped(HFI_Handle handle)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  return(obj->flag_polarityFlipped);
+} // end of HFI_getFlag_polarityFlipped() function
+
+
+//! \brief     Gets the direct axis current reference of the polarity detection
+//! \param[in] handle  The high frequency injection (HFI) handle
+//! \return    The current added to the Id reference, pu
+static inline _iq HFI_getId_ref_pu(HFI_Handle handle)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  return(obj->Id_ref_pu);
+} // end of HFI_getId_ref_pu() function
+
+
+//! \brief     Gets the demodulated current step
+//! \param[in] handle  The high frequency injection (HFI) handle
+//! \return    The current step on the estimated direct axis, pu
+static inline _iq HFI_getId_hf_pu(HFI_Handle handle)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  return(obj->Idq_hf.value[0]);
+} // end of HFI_getId_hf_pu() function
+
+
+//! \brief     Gets the speed
+//! \param[in] handle  The high frequency injection (HFI) handle
+//! \return    The electrical frequency, pu
+static inline _iq HFI_getSpeed_pu(HFI_Handle handle)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  return(obj->speed_pu);
+} // end of HFI_getSpeed_pu() function
+
+
+//! \brief     Gets the state
+//! \param[in] handle  The high frequency injection (HFI) handle
+//! \return    The state
+static inline HFI_State_e HFI_getState(HFI_Handle handle)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  return(obj->state);
+} // end of HFI_getState() function
+
+
+//! \brief     Gets the injected voltage of this tick
+//! \param[in] handle  The high frequency injection (HFI) handle
+//! \return    The direct axis voltage at a dc bus of 1 pu, in controller output units
+static inline _iq HFI_getVinj_pu(HFI_Handle handle)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  return(obj->Vinj_out_pu);
+} // end of HFI_getVinj_pu() function
+
+
+//! \brief     Determines if the angle can be used for torque
+//! \param[in] handle  The high frequency injection (HFI) handle
+//! \return    The flag, true after the polarity detection
+static inline bool HFI_isAngleValid(HFI_Handle handle)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  return(obj->state >= HFI_State_Run);
+} // end of HFI_isAngleValid() function
+
+
+//! \brief     Initializes the high frequency injection (HFI) module
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The high frequency injection (HFI) handle
+extern HFI_Handle HFI_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Sets the handover speeds
+//! \param[in] handle            The high frequency injection (HFI) handle
+//! \param[in] handoverSpeed_pu  The speed above which the estimator angle is used, pu
+//! \param[in] handbackSpeed_pu  The speed below which the injection angle is used, pu
+extern void HFI_setHandover(HFI_Handle handle,
+                            const _iq handoverSpeed_pu,
+                            const _iq handbackSpeed_pu);
+
+
+//! \brief     Sets the injection and the PLL parameters
+//! \details   The speed scale is the ISR frequency over the full scale
+//!            frequency, it converts the PLL integrator from angle per tick
+//!            to the frequency in pu.
+//! \param[in] handle            The high frequency injection (HFI) handle
+//! \param[in] Vinj_pu           The injected voltage at a dc bus of 1 pu, in controller output units
+//! \param[in] Kp                The proportional gain of the PLL
+//! \param[in] Ki                The integral gain of the PLL
+//! \param[in] speedScale        The ISR frequency over the full scale frequency
+//! \param[in] speedFilterCoeff  The coefficient of the speed low pass filter
+extern void HFI_setParams(HFI_Handle handle,
+                          const _iq Vinj_pu,
+                          const _iq Kp,
+                          const _iq Ki,
+                          const _iq speedScale,
+                          const _iq speedFilterCoeff);
+
+
+//! \brief     Sets the alignment and polarity detection
+//! \param[in] handle            The high frequency injection (HFI) handle
+//! \param[in] Id_polarity_pu    The direct axis current of the polarity pulses, pu
+//! \param[in] numAlignTicks     The duration of the alignment, ISR ticks
+//! \param[in] numPolarityTicks  The duration of each polarity pulse, ISR ticks
+extern void HFI_setPolarity(HFI_Handle handle,
+                            const _iq Id_polarity_pu,
+                            const uint_least32_t numAlignTicks,
+                            const uint_least32_t numPolarityTicks);
+
+
+//! \brief     Starts the alignment from an unknown angle at standstill
+//! \param[in] handle  The high frequency injection (HFI) handle
+extern void HFI_start(HFI_Handle handle);
+
+
+//! \brief     Stops the injection
+//! \param[in] handle  The high frequency injection (HFI) handle
+extern void HFI_stop(HFI_Handle handle);
+
+
+//! \brief     Demodulates the current samples
+//! \details   Call after the Clarke transform of the current.  While
+//!            injecting, the samples are replaced by the fundamental current.
+//! \param[in] handle  The high frequency injection (HFI) handle
+//! \param[in] pIab    The pointer to the alpha/beta current, pu, replaced by the fundamental
+static inline void HFI_demodulate(HFI_Handle handle,MATH_vec2 *pIab)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+  _iq Ialpha = pIab->value[0];
+  _iq Ibeta = pIab->value[1];
+
+  if(obj->sign != 0)
+    {
+      _iq dIalpha = Ialpha - obj->Iab_prev.value[0];
+      _iq dIbeta = Ibeta - obj->Iab_prev.value[1];
+      _iq cosTh = obj->phasor.value[0];
+      _iq sinTh = obj->phasor.value[1];
+      _iq dId = _IQmpy(dIalpha,cosTh) + _IQmpy(dIbeta,sinTh);
+      _iq dIq = _IQmpy(dIbeta,cosTh) - _IQmpy(dIalpha,sinTh);
+
+      obj->Idq_hf.value[0] = (obj->sign > 0) ? dId : -dId;
+      obj->Idq_hf.value[1] = (obj->sign > 0) ? dIq : -dIq;
+
+      // the injection alternates every tick, the mean of two samples is the fundamental
+      pIab->value[0] = (Ialpha + obj->Iab_prev.value[0]) >> 1;
+      pIab->value[1] = (Ibeta + obj->Iab_prev.value[1]) >> 1;
+    }
+  else
+    {
+      obj->Idq_hf.value[0] = _IQ(0.0);
+      obj->Idq_hf.value[1] = _IQ(0.0);
+    }
+
+  obj->Iab_prev.value[0] = Ialpha;
+  obj->Iab_prev.value[1] = Ibeta;
+
+  return;
+} // end of HFI_demodulate() function
+
+
+//! \brief     Runs the polarity detection
+//! \details   The second half of each pulse, after the Id controller has
+//!            settled, sums dId.  The larger sum is on the north pole.
+//! \param[in] handle  The high frequency injection (HFI) handle
+static inline void HFI_runPolarity(HFI_Handle handle)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+  uint_least8_t pulse = (obj->Id_ref_pu > _IQ(0.0)) ? 0 : 1;
+
+  if(obj->counter > (obj->numPolarityTicks >> 1))
+    {
+      obj->polaritySum[pulse] += obj->Idq_hf.value[0];
+    }
+
+  if(obj->counter >= obj->numPolarityTicks)
+    {
+      obj->counter = 0;
+
+      if(pulse == 0)
+        {
+          obj->Id_ref_pu = -obj->Id_polarity_pu;
+        }
+      else
+        {
+          obj->Id_ref_pu = _IQ(0.0);
+
+          if(obj->polaritySum[0] < obj->polaritySum[1])
+            {
+              obj->angle_pu += (obj->angle_pu < _IQ(0.0)) ? _IQ(0.5) : _IQ(-0.5);
+              obj->flag_polarityFlipped = true;
+            }
+
+          obj->state = HFI_State_Run;
+        }
+    }
+
+  return;
+} // end of HFI_runPolarity() function
+
+
+//! \brief     Runs the tracking PLL and the state machine
+//! \details   Call after the estimator and HFI_demodulate(), then use the
+//!            angle, speed, injected voltage and Id reference of the tick.
+//! \param[in] handle       The high frequency injection (HFI) handle
+//! \param[in] estAngle_pu  The angle of the estimator, pu
+//! \param[in] estSpeed_pu  The electrical frequency of the estimator, pu
+static inline void HFI_run(HFI_Handle handle,const _iq estAngle_pu,const _iq estSpeed_pu)
+{
+  HFI_Obj *obj = (HFI_Obj *)handle;
+
+  if(obj->state == HFI_State_Idle)
+    {
+      obj->sign = 0;
+      obj->Vinj_out_pu = _IQ(0.0);
+
+      return;
+    }
+
+  if(obj->state == HFI_State_Fast)
+    {
+      // follow the estimator, the PLL restarts from its angle and speed
+      obj->angle_pu = estAngle_pu;
+      obj->speed_pu = estSpeed_pu;
+      obj->speedTick_pu = _IQmpy(estSpeed_pu,obj->speedScaleInv);
+      obj->err = _IQ(0.0);
+      obj->sign = 0;
+
+      if(_IQabs(estSpeed_pu) < obj->handbackSpeed_pu)
+        {
+          obj->state = HFI_State_Run;
+        }
+    }
+  else
+    {
+      _iq err = _IQ(0.0);
+
+      if(obj->Idq_hf.value[0] > HFI_MIN_ID_STEP_pu)
+        {
+          err = _IQsat(_IQdiv(obj->Idq_hf.value[1],obj->Idq_hf.value[0]),HFI_MAX_ERROR,-HFI_MAX_ERROR);
+        }
+
+      obj->err = err;
+      obj->speedTick_pu += _IQmpy(obj->Ki,err);
+      obj->angle_pu += obj->speedTick_pu + _IQmpy(obj->Kp,err);
+
+      if(obj->angle_pu > _IQ(0.5))
+        {
+          obj->angle_pu -= _IQ(1.0);
+        }
+      else if(obj->angle_pu < _IQ(-0.5))
+        {
+          obj->angle_pu += _IQ(1.0);
+        }
+
+      obj->speed_pu += _IQmpy(obj->speedFilterCoeff,_IQmpy(obj->speedTick_pu,obj->speedScale) - obj->speed_pu);
+
+      obj->counter++;
+
+      if(obj->state == HFI_State_Align)
+        {
+          if(obj->counter >= obj->numAlignTicks)
+            {
+              obj->state = HFI_State_Polarity;
+              obj->counter = 0;
+              obj->Id_ref_pu = obj->Id_polarity_pu;
+            }
+        }
+      else if(obj->state == HFI_State_Polarity)
+        {
+          HFI_runPolarity(handle);
+        }
+      else if(_IQabs(obj->speed_pu) > obj->handoverSpeed_pu)
+        {
+          obj->state = HFI_State_Fast;
+        }
+
+      // alternate the sign every tick
+      obj->sign = (obj->sign > 0) ? -1 : 1;
+    }
+
+  obj->Vinj_out_pu = (obj->sign > 0) ? obj->Vinj_pu : ((obj->sign < 0) ? -obj->Vinj_pu : _IQ(0.0));
+
+  // the angle of the injection, for the demodulation of the next tick
+  obj->phasor.value[0] = _IQcosPU(obj->angle_pu);
+  obj->phasor.value[1] = _IQsinPU(obj->angle_pu);
+
+  return;
+} // end of HFI_run() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _HFI_H_ definition
+
@@ -209,8 +209,13 @@ extern "C" {
 #define   Q2          2
 #define   Q1          1
 
+#if defined(__TMS320C28XX__)
 #define   MAX_IQ_POS  LONG_MAX
 #define   MAX_IQ_NEG  LONG_MIN
+#else
+#define   MAX_IQ_POS  INT32_MAX
+#define   MAX_IQ_NEG  INT32_MIN
+#endif
 #define   MIN_IQ_POS  1
 #define   MIN_IQ_NEG  -1
 
@@ -220,6 +225,7 @@ extern "C" {
 // If IQ_MATH is used, the following IQmath library function definitions
 // are used:
 //===========================================================================
+#if defined(__TMS320C28XX__)
 typedef   long    _iq;
 typedef   long    _iq30;
 typedef   long    _iq29;
@@ -251,6 +257,13 @@ typedef   long    _iq4;
 typedef   long    _iq3;
 typedef   long    _iq2;
 typedef   long    _iq1;
+#else
+//---------------------------------------------------------------------------
+// Host builds (e.g. the simulator) have no IQmath intrinsics and do not
+// guarantee a 32-bit long, so the host port supplies both.
+//
+#include "sw/modules/iqmath/src/32b/host/IQmathLib_host.h"
+#endif
 //---------------------------------------------------------------------------
 #define _IQmpy2(A)          ((A)<<1)
 #define _IQmpy4(A)          ((A)<<2)
@@ -266,6 +279,7 @@ typedef   long    _iq1;
 #define _IQdiv32(A)         ((A)>>5)
 #define _IQdiv64(A)         ((A)>>6)
 //---------------------------------------------------------------------------
+#if defined(__TMS320C28XX__)
 #define   _IQ30(A)      (long) ((A) * 1073741824.0L)
 #define   _IQ29(A)      (long) ((A) * 536870912.0L)
 #define   _IQ28(A)      (long) ((A) * 268435456.0L)
@@ -296,6 +310,46 @@ typedef   long    _iq1;
 #define   _IQ3(A)       (long) ((A) * 8.0L)
 #define   _IQ2(A)       (long) ((A) * 4.0L)
 #define   _IQ1(A)       (long) ((A) * 2.0L)
+#else
+// On the C28x double is 32 bits wide, so constant arguments are rounded to
+// float before the conversion.  The host does the same for the arguments the
+// compiler can fold, so the constants of the code get the target values.
+// Arguments only known at run time, such as the double values of the host
+// simulation, are converted from their full value: rounding them to float
+// first would change the result by up to |A| * 2^(N-24) LSB.  IQmath_bench.c
+// checks both cases.
+#define   _IQHOST_CONST(A)  (__builtin_constant_p(A) ? (long double) (float) (A) : (long double) (A))
+#define   _IQ30(A)      (long) (_IQHOST_CONST(A) * 1073741824.0L)
+#define   _IQ29(A)      (long) (_IQHOST_CONST(A) * 536870912.0L)
+#define   _IQ28(A)      (long) (_IQHOST_CONST(A) * 268435456.0L)
+#define   _IQ27(A)      (long) (_IQHOST_CONST(A) * 134217728.0L)
+#define   _IQ26(A)      (long) (_IQHOST_CONST(A) * 67108864.0L)
+#define   _IQ25(A)      (long) (_IQHOST_CONST(A) * 33554432.0L)
+#define   _IQ24(A)      (long) (_IQHOST_CONST(A) * 16777216.0L)
+#define   _IQ23(A)      (long) (_IQHOST_CONST(A) * 8388608.0L)
+#define   _IQ22(A)      (long) (_IQHOST_CONST(A) * 4194304.0L)
+#define   _IQ21(A)      (long) (_IQHOST_CONST(A) * 2097152.0L)
+#define   _IQ20(A)      (long) (_IQHOST_CONST(A) * 1048576.0L)
+#define   _IQ19(A)      (long) (_IQHOST_CONST(A) * 524288.0L)
+#define   _IQ18(A)      (long) (_IQHOST_CONST(A) * 262144.0L)
+#define   _IQ17(A)      (long) (_IQHOST_CONST(A) * 131072.0L)
+#define   _IQ16(A)      (long) (_IQHOST_CONST(A) * 65536.0L)
+#define   _IQ15(A)      (long) (_IQHOST_CONST(A) * 32768.0L)
+#define   _IQ14(A)      (long) (_IQHOST_CONST(A) * 16384.0L)
+#define   _IQ13(A)      (long) (_IQHOST_CONST(A) * 8192.0L)
+#define   _IQ12(A)      (long) (_IQHOST_CONST(A) * 4096.0L)
+#define   _IQ11(A)      (long) (_IQHOST_CONST(A) * 2048.0L)
+#define   _IQ10(A)      (long) (_IQHOST_CONST(A) * 1024.0L)
+#define   _IQ9(A)       (long) (_IQHOST_CONST(A) * 512.0L)
+#define   _IQ8(A)       (long) (_IQHOST_CONST(A) * 256.0L)
+#define   _IQ7(A)       (long) (_IQHOST_CONST(A) * 128.0L)
+#define   _IQ6(A)       (long) (_IQHOST_CONST(A) * 64.0L)
+#define   _IQ5(A)       (long) (_IQHOST_CONST(A) * 32.0L)
+#define   _IQ4(A)       (long) (_IQHOST_CONST(A) * 16.0L)
+#define   _IQ3(A)       (long) (_IQHOST_CONST(A) * 8.0L)
+#define   _IQ2(A)       (long) (_IQHOST_CONST(A) * 4.0L)
+#define   _IQ1(A)       (long) (_IQHOST_CONST(A) * 2.0L)
+#endif
 
 #if GLOBAL_Q == 30
 #define   _IQ(A)  _IQ30(A)
@@ -0,0 +1,700 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+//! \file   modules/iqmath/src/32b/host/IQmathLib_host.c
+//! \brief  Host (non-C28x) implementation of the IQmath library functions
+//!
+//!         Every Q format from 1 to 30 is generated from one generic
+//!         implementation.  The arguments and results of the library
+//!         functions are declared as long in IQmathLib.h; on the host the
+//!         values are held in the low 32 bits, exactly as on the C28x.
+//!
+//!         Multiplication, division, square root and magnitude are computed
+//!         exactly in integer arithmetic and truncated like on the C28x.
+//!         The trigonometric and exponential functions use the algorithms of
+//!         the C28x library: a table lookup in Q30 with a Taylor series
+//!         interpolation, truncated after every product, and the Q30 result
+//!         shifted to the Q format.  So _IQ30sinPU(A << (30 - N)) >> (30 - N)
+//!         equals _IQNsinPU(A), which the controller relies on to share one
+//!         phasor between Q formats.  The tables are computed on the host
+//!         with the values of the boot ROM tables.
+//!
+//!         IQmath_bench.c checks the results against the exact results and,
+//!         bit for bit, against reference tables captured on the C28x.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the value of 2*pi
+//!
+#define IQHOST_TWO_PI   (6.283185307179586476925286766559)
+
+//! \brief Defines the distance from an integer, in LSB, below which a double result is taken as exact
+//!
+#define IQHOST_DOUBLE_TOL   (1.0e-6)
+
+//! \brief Defines one in Q30
+//!
+#define IQHOST_Q30          (1073741824.0)
+#define IQHOST_ONE_Q30      ((int64_t)1 << 30)
+#define IQHOST_Q32          (4294967296.0)
+
+//! \brief Defines the constants of the trigonometric functions
+//!
+#define IQHOST_HALF_PI_Q30        ((int32_t)1686629713)       // pi/2 in Q30
+#define IQHOST_ONE_SIXTH_Q30      ((int32_t)178956971)        // 1/6 in Q30
+#define IQHOST_TWO_PI_Q29         ((int64_t)3373259426)       // 2*pi in Q29
+#define IQHOST_INV_TWO_PI_Q34     ((int64_t)2734261102)       // 1/(2*pi) in Q34
+
+//! \brief Defines the sine table, one revolution plus a quarter for the cosine
+//!
+#define IQHOST_SIN_TABLE_BITS     (9)
+#define IQHOST_SIN_TABLE_SIZE     (1 << IQHOST_SIN_TABLE_BITS)
+#define IQHOST_SIN_TABLE_LENGTH   (IQHOST_SIN_TABLE_SIZE + IQHOST_SIN_TABLE_SIZE / 4)
+#define IQHOST_SIN_FRAC_MASK      ((1UL << (32 - IQHOST_SIN_TABLE_BITS)) - 1)
+
+//! \brief Defines the arctangent table, segments of the ratio from 0 to 1
+//!
+#define IQHOST_ATAN_TABLE_BITS    (7)
+#define IQHOST_ATAN_TABLE_SIZE    (1 << IQHOST_ATAN_TABLE_BITS)
+#define IQHOST_ATAN_FRAC_MASK     ((1UL << (30 - IQHOST_ATAN_TABLE_BITS)) - 1)
+
+//! \brief Defines the exponential tables
+//!
+#define IQHOST_EXP_NUM_COEFFS     (13)      // Taylor coefficients 1/k!
+#define IQHOST_EXP_MAX_INT        (22)      // e^22 exceeds the Q1 range
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the exponential of an integer, mantissa * 2^(exponent - 31)
+//!
+typedef struct _IQhost_ExpInt_t_
+{
+  uint32_t  mantissa;     //!< the mantissa in Q31, from 0.5 to 1
+  int       exponent;     //!< the binary exponent
+} IQhost_ExpInt_t;
+
+
+// **************************************************************************
+// the globals
+
+static bool gIQhost_flag_tablesInit = false;
+
+static int32_t gIQhost_sinTable[IQHOST_SIN_TABLE_LENGTH];
+
+static int32_t gIQhost_atanTable[IQHOST_ATAN_TABLE_SIZE + 1][4];
+
+static uint32_t gIQhost_expCoeff[IQHOST_EXP_NUM_COEFFS];
+
+static IQhost_ExpInt_t gIQhost_expIntTable[2 * IQHOST_EXP_MAX_INT + 1];
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Converts a double into a saturated IQ value
+//! \details   The value is truncated toward minus infinity like the C28x
+//!            library results.  Values within the rounding error of the
+//!            double computation from an integer are rounded to it, so exact
+//!            results such as sin(pi) = 0 are not truncated to -1 LSB.
+//! \param[in] x  The value
+//! \param[in] q  The Q format
+//! \return    The IQ value
+static long IQhost_fromDouble(const double x,const int q)
+{
+  double value = x * (double)((int64_t)1 << q);
+  double nearest = nearbyint(value);
+
+  value = (fabs(value - nearest) < IQHOST_DOUBLE_TOL) ? nearest : floor(value);
+
+  if(value >= (double)INT32_MAX)
+    {
+      return((long)INT32_MAX);
+    }
+
+  if(value <= (double)INT32_MIN)
+    {
+      return((long)INT32_MIN);
+    }
+
+  return((long)value);
+} // end of IQhost_fromDouble() function
+
+
+//! \brief     Converts an IQ value into a double
+//! \param[in] A  The IQ value
+//! \param[in] q  The Q format
+//! \return    The value
+static double IQhost_toDouble(const long A,const int q)
+{
+  return((double)(int32_t)A / (double)((int64_t)1 << q));
+} // end of IQhost_toDouble() function
+
+
+//! \brief     Saturates a 64-bit intermediate to the 32-bit IQ range
+//! \param[in] value  The value
+//! \return    The saturated value
+static long IQhost_sat32(const int64_t value)
+{
+  if(value > (int64_t)INT32_MAX)
+    {
+      return((long)INT32_MAX);
+    }
+
+  if(value < (int64_t)INT32_MIN)
+    {
+      return((long)INT32_MIN);
+    }
+
+  return((long)value);
+} // end of IQhost_sat32() function
+
+
+static float IQhost_toF(const long A,const int q)
+{
+  return((float)IQhost_toDouble(A,q));
+} // end of IQhost_toF() function
+
+
+static long IQhost_rmpy(const long A,const long B,const int q)
+{
+  int64_t product = (int64_t)(int32_t)A * (int64_t)(int32_t)B;
+
+  product += (int64_t)1 << (q - 1);
+
+  return((long)(int32_t)(uint32_t)(uint64_t)(product >> q));
+} // end of IQhost_rmpy() function
+
+
+static long IQhost_rsmpy(const long A,const long B,const int q)
+{
+  int64_t product = (int64_t)(int32_t)A * (int64_t)(int32_t)B;
+
+  product += (int64_t)1 << (q - 1);
+
+  return(IQhost_sat32(product >> q));
+} // end of IQhost_rsmpy() function
+
+
+static long IQhost_div(const long A,const long B,const int q)
+{
+  int64_t num = (int64_t)(int32_t)A * ((int64_t)1 << q);
+  int64_t den = (int64_t)(int32_t)B;
+
+  if(den == 0)
+    {
+      return(((int32_t)A < 0) ? (long)INT32_MIN : (long)INT32_MAX);
+    }
+
+  return(IQhost_sat32(num / den));
+} // end of IQhost_div() function
+
+
+//! \brief     Builds the sine, arctangent and exponential tables
+//! \details   The tables hold the same values as the IQmath tables of the
+//!            C28x boot ROM, the host computes them once at the first call
+static void IQhost_initTables(void)
+{
+  int cnt;
+
+  if(gIQhost_flag_tablesInit)
+    {
+      return;
+    }
+
+  for(cnt=0;cnt<IQHOST_SIN_TABLE_LENGTH;cnt++)
+    {
+      gIQhost_sinTable[cnt] = (int32_t)lrint(sin(IQHOST_TWO_PI * (double)cnt / (double)IQHOST_SIN_TABLE_SIZE) * IQHOST_Q30);
+    }
+
+  for(cnt=0;cnt<=IQHOST_ATAN_TABLE_SIZE;cnt++)
+    {
+      double r = (double)cnt / (double)IQHOST_ATAN_TABLE_SIZE;
+      double d = 1.0 + r * r;
+
+      // atan(r) / (2*pi) and its first three Taylor coefficients in Q32, below 1/4
+      gIQhost_atanTable[cnt][0] = (int32_t)lrint(atan(r) / IQHOST_TWO_PI * IQHOST_Q32);
+      gIQhost_atanTable[cnt][1] = (int32_t)lrint(1.0 / d / IQHOST_TWO_PI * IQHOST_Q32);
+      gIQhost_atanTable[cnt][2] = (int32_t)lrint(-r / (d * d) / IQHOST_TWO_PI * IQHOST_Q32);
+      gIQhost_atanTable[cnt][3] = (int32_t)lrint((3.0 * r * r - 1.0) / (3.0 * d * d * d) / IQHOST_TWO_PI * IQHOST_Q32);
+    }
+
+  for(cnt=0;cnt<IQHOST_EXP_NUM_COEFFS;cnt++)
+    {
+      gIQhost_expCoeff[cnt] = (uint32_t)lrint(IQHOST_Q30 / tgamma((double)cnt + 1.0));
+    }
+
+  for(cnt=-IQHOST_EXP_MAX_INT;cnt<=IQHOST_EXP_MAX_INT;cnt++)
+    {
+      int exponent;
+      double mantissa = frexp(exp((double)cnt),&exponent);
+
+      // e^n = mantissa * 2^(exponent - 31), the mantissa in Q31 from 0.5 to 1
+      gIQhost_expIntTable[cnt + IQHOST_EXP_MAX_INT].mantissa = (uint32_t)llrint(ldexp(mantissa,31));
+      gIQhost_expIntTable[cnt + IQHOST_EXP_MAX_INT].exponent = exponent;
+    }
+
+  gIQhost_flag_tablesInit = true;
+
+  return;
+} // end of IQhost_initTables() function
+
+
+//! \brief     Computes the sine or cosine of a per unit angle in Q30
+//! \details   Like the C28x library, the upper 9 bits of the angle select the
+//!            sine table entry and the rest is interpolated with a third
+//!            order Taylor series.  Every product is truncated to Q30.
+//! \param[in] angle      The angle, 2^32 is one revolution
+//! \param[in] flag_cos   Computes the cosine when true
+//! \return    The sine or cosine in Q30
+static int32_t IQhost_sinCosPU30(const uint32_t angle,const bool flag_cos)
+{
+  uint32_t index = angle >> (32 - IQHOST_SIN_TABLE_BITS);
+  int32_t sinValue = gIQhost_sinTable[index];
+  int32_t cosValue = gIQhost_sinTable[index + IQHOST_SIN_TABLE_SIZE / 4];
+  int32_t x = __IQmpy((int32_t)(angle & IQHOST_SIN_FRAC_MASK),IQHOST_HALF_PI_Q30,30);
+  int32_t f0 = flag_cos ? cosValue : sinValue;
+  int32_t f1 = flag_cos ? -sinValue : cosValue;
+  int32_t sum;
+
+  // f(x) = f0 + x * (f1 - x * (f0 / 2 + x * f1 / 6))
+  sum = (f0 >> 1) + __IQmpy(x,__IQmpy(f1,IQHOST_ONE_SIXTH_Q30,30),30);
+  sum = f1 - __IQmpy(x,sum,30);
+
+  return(f0 + __IQmpy(x,sum,30));
+} // end of IQhost_sinCosPU30() function
+
+
+//! \brief     Converts an angle in radians into a per unit angle
+//! \param[in] A  The angle, rad
+//! \param[in] q  The Q format
+//! \return    The angle, 2^32 is one revolution
+static uint32_t IQhost_radToPU(const long A,const int q)
+{
+  // 1 / (2*pi) in Q34, the product wraps to one revolution in the low 32 bits
+  return((uint32_t)(uint64_t)(((int64_t)(int32_t)A * IQHOST_INV_TWO_PI_Q34) >> (q + 2)));
+} // end of IQhost_radToPU() function
+
+
+static long IQhost_sin(const long A,const int q)
+{
+  IQhost_initTables();
+
+  return((long)(IQhost_sinCosPU30(IQhost_radToPU(A,q),false) >> (30 - q)));
+} // end of IQhost_sin() function
+
+
+static long IQhost_cos(const long A,const int q)
+{
+  IQhost_initTables();
+
+  return((long)(IQhost_sinCosPU30(IQhost_radToPU(A,q),true) >> (30 - q)));
+} // end of IQhost_cos() function
+
+
+static long IQhost_sinPU(const long A,const int q)
+{
+  IQhost_initTables();
+
+  return((long)(IQhost_sinCosPU30((uint32_t)A << (32 - q),false) >> (30 - q)));
+} // end of IQhost_sinPU() function
+
+
+static long IQhost_cosPU(const long A,const int q)
+{
+  IQhost_initTables();
+
+  return((long)(IQhost_sinCosPU30((uint32_t)A << (32 - q),true) >> (30 - q)));
+} // end of IQhost_cosPU() function
+
+
+//! \brief     Computes the per unit angle of a vector, without the sign of y
+//! \details   The ratio of the smaller to the larger component is divided out
+//!            and its arctangent is interpolated from the arctangent table
+//!            with a third order Taylor series, the octant is then restored.
+//!            The caller applies the sign of y, so an angle rounded to half
+//!            a revolution keeps the sign of the exact result.
+//! \param[in] y  The y component
+//! \param[in] x  The x component
+//! \return    The angle of (|y|, x) from 0 to 2^31, 2^32 is one revolution
+static int64_t IQhost_atanAbsPU32(const int32_t y,const int32_t x)
+{
+  uint64_t absX = (x < 0) ? (uint64_t)(-(int64_t)x) : (uint64_t)x;
+  uint64_t absY = (y < 0) ? (uint64_t)(-(int64_t)y) : (uint64_t)y;
+  bool flag_swap = absY > absX;
+  uint32_t ratio,index;
+  int32_t dx,sum;
+  uint32_t angle;
+
+  if((absX == 0) && (absY == 0))
+    {
+      return(0);
+    }
+
+  // the ratio from 0 to 1 in Q30
+  ratio = flag_swap ? (uint32_t)((absX << 30) / absY) : (uint32_t)((absY << 30) / absX);
+  index = ratio >> (30 - IQHOST_ATAN_TABLE_BITS);
+  dx = (int32_t)(ratio & IQHOST_ATAN_FRAC_MASK);
+
+  sum = __IQmpy(dx,gIQhost_atanTable[index][3],30) + gIQhost_atanTable[index][2];
+  sum = __IQmpy(dx,sum,30) + gIQhost_atanTable[index][1];
+  sum = __IQmpy(dx,sum,30) + gIQhost_atanTable[index][0];
+
+  // in Q32 one revolution is 2^32, the first octant ends at 2^29
+  angle = (uint32_t)sum;
+
+  if(flag_swap)
+    {
+      angle = ((uint32_t)1 << 30) - angle;
+    }
+
+  if(x < 0)
+    {
+      angle = ((uint32_t)1 << 31) - angle;
+    }
+
+  return((int64_t)angle);
+} // end of IQhost_atanAbsPU32() function
+
+
+//! \brief     Converts a per unit angle into radians
+//! \param[in] angle  The angle, 2^32 is one revolution
+//! \param[in] q      The Q format
+//! \return    The angle, rad
+static long IQhost_puToRad(const int64_t angle,const int q)
+{
+  return(IQhost_sat32((angle * IQHOST_TWO_PI_Q29) >> (32 + 29 - q)));
+} // end of IQhost_puToRad() function
+
+
+static long IQhost_atan2(const long A,const long B,const int q)
+{
+  int64_t angle;
+
+  IQhost_initTables();
+
+  angle = IQhost_atanAbsPU32((int32_t)A,(int32_t)B);
+
+  return(IQhost_puToRad(((int32_t)A < 0) ? -angle : angle,q));
+} // end of IQhost_atan2() function
+
+
+static long IQhost_atan2PU(const long A,const long B,const int q)
+{
+  uint32_t angle;
+
+  IQhost_initTables();
+
+  angle = (uint32_t)IQhost_atanAbsPU32((int32_t)A,(int32_t)B);
+
+  // the per unit result is in the range 0 to 1
+  return((long)((((int32_t)A < 0) ? (uint32_t)0 - angle : angle) >> (32 - q)));
+} // end of IQhost_atan2PU() function
+
+
+//! \brief     Computes the integer square root of a 64-bit value
+//! \param[in] value  The value
+//! \return    The square root, truncated toward zero
+static uint64_t IQhost_usqrt64(const uint64_t value)
+{
+  uint64_t root = (uint64_t)sqrt((double)value);
+
+  // the double estimate is within one of the result, correct it exactly
+  while((root > 0) && (root * root > value))
+    {
+      root--;
+    }
+
+  while((root + 1) * (root + 1) <= value)
+    {
+      root++;
+    }
+
+  return(root);
+} // end of IQhost_usqrt64() function
+
+
+static long IQhost_sqrt(const long A,const int q)
+{
+  if((int32_t)A <= 0)
+    {
+      return(0);
+    }
+
+  // sqrt(A / 2^q) * 2^q = sqrt(A * 2^q), exact in 64 bits since A < 2^31 and q <= 30
+  return((long)IQhost_usqrt64((uint64_t)(int32_t)A << q));
+} // end of IQhost_sqrt() function
+
+
+static long IQhost_isqrt(const long A,const int q)
+{
+  unsigned __int128 value;
+
+  if((int32_t)A <= 0)
+    {
+      return((long)INT32_MAX);
+    }
+
+  // 2^q / sqrt(A / 2^q) = sqrt(2^(3q) / A), truncating the quotient first does not change the result
+  value = ((unsigned __int128)1 << (3 * q)) / (unsigned __int128)(uint32_t)(int32_t)A;
+
+  if(value >= ((unsigned __int128)1 << 62))
+    {
+      return((long)INT32_MAX);
+    }
+
+  return(IQhost_sat32((int64_t)IQhost_usqrt64((uint64_t)value)));
+} // end of IQhost_isqrt() function
+
+
+//! \brief     Computes the arcsine of a value as the angle of (A, sqrt(1 - A^2))
+//! \param[in] A  The value, limited to -1 to 1
+//! \param[in] q  The Q format
+//! \return    The angle, 2^32 is one revolution
+static int64_t IQhost_asinPU32(const long A,const int q)
+{
+  int64_t x = (int64_t)(int32_t)A << (30 - q);
+
+  x = (x > IQHOST_ONE_Q30) ? IQHOST_ONE_Q30 : ((x < -IQHOST_ONE_Q30) ? -IQHOST_ONE_Q30 : x);
+
+  int64_t angle = IQhost_atanAbsPU32((int32_t)x,(int32_t)IQhost_usqrt64((uint64_t)(IQHOST_ONE_Q30 * IQHOST_ONE_Q30 - x * x)));
+
+  return((x < 0) ? -angle : angle);
+} // end of IQhost_asinPU32() function
+
+
+static long IQhost_asin(const long A,const int q)
+{
+  IQhost_initTables();
+
+  return(IQhost_puToRad(IQhost_asinPU32(A,q),q));
+} // end of IQhost_asin() function
+
+
+static long IQhost_acos(const long A,const int q)
+{
+  IQhost_initTables();
+
+  // acos(A) = pi/2 - asin(A), from 0 to pi
+  return(IQhost_puToRad(((int64_t)1 << 30) - IQhost_asinPU32(A,q),q));
+} // end of IQhost_acos() function
+
+
+//! \brief     Computes the exponential
+//! \details   The argument is split into its integer and fractional parts.
+//!            The exponential of the fractional part is a Taylor series in
+//!            Q30, the one of the integer part is taken from a table.
+//! \param[in] A  The argument
+//! \param[in] q  The Q format
+//! \return    The exponential, saturated
+static long IQhost_exp(const long A,const int q)
+{
+  int32_t n = (int32_t)A >> q;
+  uint64_t frac = (uint64_t)((uint32_t)(int32_t)A & (((uint32_t)1 << q) - 1)) << (30 - q);
+  uint64_t sum = 0;
+  const IQhost_ExpInt_t *pExpInt;
+  int shift,cnt;
+
+  IQhost_initTables();
+
+  if(n > IQHOST_EXP_MAX_INT)
+    {
+      return((long)INT32_MAX);
+    }
+
+  if(n < -IQHOST_EXP_MAX_INT)
+    {
+      return(0);
+    }
+
+  // e^frac from 1 to e in unsigned Q30
+  for(cnt=IQHOST_EXP_NUM_COEFFS-1;cnt>=0;cnt--)
+    {
+      sum = gIQhost_expCoeff[cnt] + ((sum * frac) >> 30);
+    }
+
+  // e^frac * e^n, from Q30 times Q31 to the Q format
+  pExpInt = &gIQhost_expIntTable[n + IQHOST_EXP_MAX_INT];
+  shift = 30 + 31 - q - pExpInt->exponent;
+
+  if(shift >= 64)
+    {
+      return(0);
+    }
+
+  return(IQhost_sat32((int64_t)((sum * pExpInt->mantissa) >> shift)));
+} // end of IQhost_exp() function
+
+
+static long IQhost_int(const long A,const int q)
+{
+  int32_t value = (int32_t)A;
+
+  // the integer part is truncated toward zero
+  if(value < 0)
+    {
+      return(-(long)((-(int64_t)value) >> q));
+    }
+
+  return((long)(value >> q));
+} // end of IQhost_int() function
+
+
+static long IQhost_frac(const long A,const int q)
+{
+  return((long)((int32_t)A - (int32_t)(IQhost_int(A,q) << q)));
+} // end of IQhost_frac() function
+
+
+static long IQhost_mpyI32int(const long A,const long B,const int q)
+{
+  int64_t product = (int64_t)(int32_t)A * (int64_t)(int32_t)B;
+
+  if(product < 0)
+    {
+      return(IQhost_sat32(-((-product) >> q)));
+    }
+
+  return(IQhost_sat32(product >> q));
+} // end of IQhost_mpyI32int() function
+
+
+static long IQhost_mpyI32frac(const long A,const long B,const int q)
+{
+  int64_t product = (int64_t)(int32_t)A * (int64_t)(int32_t)B;
+  int64_t mask = ((int64_t)1 << q) - 1;
+
+  if(product < 0)
+    {
+      return((long)-((-product) & mask));
+    }
+
+  return((long)(product & mask));
+} // end of IQhost_mpyI32frac() function
+
+
+static long IQhost_mag(const long A,const long B)
+{
+  int64_t a = (int64_t)(int32_t)A;
+  int64_t b = (int64_t)(int32_t)B;
+
+  // the magnitude has the same Q format as the operands, the sum of squares fits in 63 bits
+  return(IQhost_sat32((int64_t)IQhost_usqrt64((uint64_t)(a * a) + (uint64_t)(b * b))));
+} // end of IQhost_mag() function
+
+
+long _atoIQN(const char *A,long q_value)
+{
+  return(IQhost_fromDouble(strtod(A,NULL),(int)q_value));
+} // end of _atoIQN() function
+
+
+int __IQNtoa(char *A,const char *B,long C,int D)
+{
+  // B is a "%<int>.<frac>f" style format, which printf understands directly
+  return((sprintf(A,B,IQhost_toDouble(C,D)) < 0) ? 1 : 0);
+} // end of __IQNtoa() function
+
+
+//! \brief Generates the library entry points for one Q format
+//!
+#define IQHOST_FUNCTIONS(N)                                                                       \
+  float _IQ##N##toF(long A)                   { return(IQhost_toF(A,N)); }                       \
+  long  _IQ##N##rmpy(long A,long B)           { return(IQhost_rmpy(A,B,N)); }                    \
+  long  _IQ##N##rsmpy(long A,long B)          { return(IQhost_rsmpy(A,B,N)); }                   \
+  long  _IQ##N##div(long A,long B)            { return(IQhost_div(A,B,N)); }                     \
+  long  _IQ##N##sin(long A)                   { return(IQhost_sin(A,N)); }                       \
+  long  _IQ##N##sinPU(long A)                 { return(IQhost_sinPU(A,N)); }                     \
+  long  _IQ##N##asin(long A)                  { return(IQhost_asin(A,N)); }                      \
+  long  _IQ##N##cos(long A)                   { return(IQhost_cos(A,N)); }                       \
+  long  _IQ##N##cosPU(long A)                 { return(IQhost_cosPU(A,N)); }                     \
+  long  _IQ##N##acos(long A)                  { return(IQhost_acos(A,N)); }                      \
+  long  _IQ##N##atan2(long A,long B)          { return(IQhost_atan2(A,B,N)); }                   \
+  long  _IQ##N##atan2PU(long A,long B)        { return(IQhost_atan2PU(A,B,N)); }                 \
+  long  _IQ##N##sqrt(long A)                  { return(IQhost_sqrt(A,N)); }                      \
+  long  _IQ##N##isqrt(long A)                 { return(IQhost_isqrt(A,N)); }                     \
+  long  _IQ##N##exp(long A)                   { return(IQhost_exp(A,N)); }                       \
+  long  _IQ##N##int(long A)                   { return(IQhost_int(A,N)); }                       \
+  long  _IQ##N##frac(long A)                  { return(IQhost_frac(A,N)); }                      \
+  long  _IQ##N##mpyI32int(long A,long B)      { return(IQhost_mpyI32int(A,B,N)); }               \
+  long  _IQ##N##mpyI32frac(long A,long B)     { return(IQhost_mpyI32frac(A,B,N)); }              \
+  long  _IQ##N##mag(long A,long B)            { return(IQhost_mag(A,B)); }  
+
+IQHOST_FUNCTIONS(30)
+IQHOST_FUNCTIONS(29)
+IQHOST_FUNCTIONS(28)
+IQHOST_FUNCTIONS(27)
+IQHOST_FUNCTIONS(26)
+IQHOST_FUNCTIONS(25)
+IQHOST_FUNCTIONS(24)
+IQHOST_FUNCTIONS(23)
+IQHOST_FUNCTIONS(22)
+IQHOST_FUNCTIONS(21)
+IQHOST_FUNCTIONS(20)
+IQHOST_FUNCTIONS(19)
+IQHOST_FUNCTIONS(18)
+IQHOST_FUNCTIONS(17)
+IQHOST_FUNCTIONS(16)
+IQHOST_FUNCTIONS(15)
+IQHOST_FUNCTIONS(14)
+IQHOST_FUNCTIONS(13)
+IQHOST_FUNCTIONS(12)
+IQHOST_FUNCTIONS(11)
+IQHOST_FUNCTIONS(10)
+IQHOST_FUNCTIONS(9)
+IQHOST_FUNCTIONS(8)
+IQHOST_FUNCTIONS(7)
+IQHOST_FUNCTIONS(6)
+IQHOST_FUNCTIONS(5)
+IQHOST_FUNCTIONS(4)
+IQHOST_FUNCTIONS(3)
+IQHOST_FUNCTIONS(2)
+IQHOST_FUNCTIONS(1)
+
+// end of file
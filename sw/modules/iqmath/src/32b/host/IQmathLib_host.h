@@ -0,0 +1,159 @@
+#ifndef _IQMATHLIB_HOST_H_
+#define _IQMATHLIB_HOST_H_
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+//! \file   modules/iqmath/src/32b/host/IQmathLib_host.h
+//! \brief  Host (non-C28x) port of the IQmath types and compiler intrinsics
+//!
+//!         On the C28x, long is 32 bits wide and __IQmpy(), __IQxmpy() and
+//!         __IQsat() are compiler intrinsics.  None of that holds for a host
+//!         compiler, so this file pins the IQ types to 32 bits and supplies
+//!         the intrinsics with the same truncation and wrap-around behavior.
+//!         The library functions (_IQNdiv(), _IQNsinPU(), ...) are provided
+//!         by IQmathLib_host.c.
+//!
+//!         This file is only included by IQmathLib.h.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <stdint.h>
+#include <stdlib.h>   // needed for labs(), used by _IQabs()
+
+
+// **************************************************************************
+// the typedefs
+
+typedef   int32_t _iq;
+typedef   int32_t _iq30;
+typedef   int32_t _iq29;
+typedef   int32_t _iq28;
+typedef   int32_t _iq27;
+typedef   int32_t _iq26;
+typedef   int32_t _iq25;
+typedef   int32_t _iq24;
+typedef   int32_t _iq23;
+typedef   int32_t _iq22;
+typedef   int32_t _iq21;
+typedef   int32_t _iq20;
+typedef   int32_t _iq19;
+typedef   int32_t _iq18;
+typedef   int32_t _iq17;
+typedef   int32_t _iq16;
+typedef   int32_t _iq15;
+typedef   int32_t _iq14;
+typedef   int32_t _iq13;
+typedef   int32_t _iq12;
+typedef   int32_t _iq11;
+typedef   int32_t _iq10;
+typedef   int32_t _iq9;
+typedef   int32_t _iq8;
+typedef   int32_t _iq7;
+typedef   int32_t _iq6;
+typedef   int32_t _iq5;
+typedef   int32_t _iq4;
+typedef   int32_t _iq3;
+typedef   int32_t _iq2;
+typedef   int32_t _iq1;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Multiplies two IQ numbers, same as the C28x __IQmpy() intrinsic
+//! \details   The 64-bit product is arithmetically shifted right by Q and
+//!            the lower 32 bits are kept, i.e. the result is truncated
+//!            toward minus infinity and wraps on overflow
+//! \param[in] A  The first operand
+//! \param[in] B  The second operand
+//! \param[in] Q  The Q format of the result
+//! \return    The product
+static inline int32_t __IQmpy(const int32_t A,const int32_t B,const int Q)
+{
+  int64_t product = (int64_t)A * (int64_t)B;
+
+  return((int32_t)(uint32_t)(uint64_t)(product >> Q));
+} // end of __IQmpy() function
+
+
+//! \brief     Multiplies two IQ numbers of different Q formats, same as the
+//!            C28x __IQxmpy() intrinsic
+//! \details   The 64-bit product is shifted by N - 32, i.e. right when N is
+//!            below 32 and left when N is above 32
+//! \param[in] A  The first operand
+//! \param[in] B  The second operand
+//! \param[in] N  The shift, N = Qresult + 32 - QA - QB
+//! \return    The product
+static inline int32_t __IQxmpy(const int32_t A,const int32_t B,const int N)
+{
+  int64_t product = (int64_t)A * (int64_t)B;
+
+  if(N <= 32)
+    {
+      product >>= (32 - N);
+    }
+  else
+    {
+      product = (int64_t)((uint64_t)product << (N - 32));
+    }
+
+  return((int32_t)(uint32_t)(uint64_t)product);
+} // end of __IQxmpy() function
+
+
+//! \brief     Saturates an IQ number, same as the C28x __IQsat() intrinsic
+//! \param[in] A    The value
+//! \param[in] Pos  The upper limit
+//! \param[in] Neg  The lower limit
+//! \return    The saturated value
+static inline int32_t __IQsat(const int32_t A,const int32_t Pos,const int32_t Neg)
+{
+  if(A > Pos)
+    {
+      return(Pos);
+    }
+
+  if(A < Neg)
+    {
+      return(Neg);
+    }
+
+  return(A);
+} // end of __IQsat() function
+
+
+#endif // end of _IQMATHLIB_HOST_H_ definition
+
@@ -0,0 +1,848 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/iqmath/src/32b/host/IQmath_bench.c
+//! \brief  Accuracy, reference table and speed checks of the host IQmath port
+//!
+//!         For every Q format from 1 to 30 the functions are run on a fixed,
+//!         pseudo random set of inputs.  The results are compared with the
+//!         exact result and, when a reference table is given, bit for bit
+//!         with the table.  Reference tables are written with -w on the host
+//!         or captured on the C28x with the same inputs, one line per vector:
+//!
+//!             <function> <Q> <A> <B> <result>
+//!
+//!         with A, B and the result as 32-bit hexadecimal numbers.  The check
+//!         fails when a function exceeds its allowed error to the exact
+//!         result, when a result differs from the reference table or when
+//!         the given reference table holds no vector.  The time per call is
+//!         measured at GLOBAL_Q and compared with the float operation that
+//!         replaces the function when MATH_TYPE is FLOAT_MATH.
+//!
+//!         The _IQN() conversion of constant and run time arguments is
+//!         checked as well, see IQmathLib.h.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+
+
+// **************************************************************************
+// the defines
+
+#define IQBENCH_NUM_Q                   (30)        // Q1 to Q30
+#define IQBENCH_DEFAULT_NUM_VECTORS     (2000)      // per function and Q format
+#define IQBENCH_DEFAULT_NUM_CALLS       (1000000)   // per timed function
+#define IQBENCH_NUM_TIMED_INPUTS        (1024)      // must be a power of 2
+#define IQBENCH_SEED                    (0x2545F491UL)
+
+#define IQBENCH_CONV_VALUE              (0.1)       // not exact in float
+
+#define IQBENCH_TWO_PI                  (6.283185307179586476925286766559)
+#define IQBENCH_PI                      (3.1415926535897932384626433832795)
+
+//! \brief Builds the table of one library function for all Q formats, indexed by Q
+//!
+#define IQBENCH_TABLE(fcn)  { NULL,                                                          \
+  _IQ1##fcn,  _IQ2##fcn,  _IQ3##fcn,  _IQ4##fcn,  _IQ5##fcn,  _IQ6##fcn,  _IQ7##fcn,  _IQ8##fcn,  \
+  _IQ9##fcn,  _IQ10##fcn, _IQ11##fcn, _IQ12##fcn, _IQ13##fcn, _IQ14##fcn, _IQ15##fcn, _IQ16##fcn, \
+  _IQ17##fcn, _IQ18##fcn, _IQ19##fcn, _IQ20##fcn, _IQ21##fcn, _IQ22##fcn, _IQ23##fcn, _IQ24##fcn, \
+  _IQ25##fcn, _IQ26##fcn, _IQ27##fcn, _IQ28##fcn, _IQ29##fcn, _IQ30##fcn }
+
+
+// **************************************************************************
+// the typedefs
+
+typedef long (*IQBENCH_Fcn1)(long A);
+typedef long (*IQBENCH_Fcn2)(long A,long B);
+
+
+//! \brief Enumeration of the checked functions
+//!
+typedef enum
+{
+  IQBENCH_Fcn_mpy=0,      //!< _IQNmpy()
+  IQBENCH_Fcn_rmpy,       //!< _IQNrmpy()
+  IQBENCH_Fcn_div,        //!< _IQNdiv()
+  IQBENCH_Fcn_sin,        //!< _IQNsin()
+  IQBENCH_Fcn_cos,        //!< _IQNcos()
+  IQBENCH_Fcn_sinPU,      //!< _IQNsinPU()
+  IQBENCH_Fcn_cosPU,      //!< _IQNcosPU()
+  IQBENCH_Fcn_atan2,      //!< _IQNatan2()
+  IQBENCH_Fcn_atan2PU,    //!< _IQNatan2PU()
+  IQBENCH_Fcn_asin,       //!< _IQNasin()
+  IQBENCH_Fcn_acos,       //!< _IQNacos()
+  IQBENCH_Fcn_exp,        //!< _IQNexp()
+  IQBENCH_Fcn_sqrt,       //!< _IQNsqrt()
+  IQBENCH_Fcn_isqrt,      //!< _IQNisqrt()
+  IQBENCH_Fcn_mag,        //!< _IQNmag()
+  IQBENCH_numFcns
+} IQBENCH_Fcn_e;
+
+
+//! \brief Defines the results of one function
+//!
+typedef struct _IQBENCH_Result_t_
+{
+  double          maxErr_lsb[IQBENCH_NUM_Q + 1];  //!< the largest error to the exact result per Q, LSB
+  uint_least32_t  numVectors;                     //!< the number of checked vectors
+  uint_least32_t  numRefVectors;                  //!< the number of vectors found in the reference table
+  uint_least32_t  numRefMismatches;               //!< the number of results different from the reference table
+  double          iq_ns;                          //!< the time per call at GLOBAL_Q, ns
+  double          float_ns;                       //!< the time per call of the float operation, ns
+} IQBENCH_Result_t;
+
+
+//! \brief Defines one entry of a reference table
+//!
+typedef struct _IQBENCH_RefVector_t_
+{
+  uint8_t   fcn;      //!< the function
+  uint8_t   q;        //!< the Q format
+  uint32_t  A;        //!< the first argument
+  uint32_t  B;        //!< the second argument
+  uint32_t  result;   //!< the result
+} IQBENCH_RefVector_t;
+
+
+// **************************************************************************
+// the globals
+
+static const char *const gFcnNames[IQBENCH_numFcns] =
+{
+  "mpy","rmpy","div","sin","cos","sinPU","cosPU","atan2","atan2PU","asin","acos","exp","sqrt","isqrt","mag"
+};
+
+//! \brief Defines the allowed error to the exact result over all Q formats, LSB
+//!
+static const double gMaxErrAllowed_lsb[IQBENCH_numFcns] =
+{
+  1.0,0.5,1.0,4.0,4.0,3.0,3.0,6.0,2.0,6.0,6.0,8.0,1.0,1.0,1.0
+};
+
+static const IQBENCH_Fcn2 gRmpy[IQBENCH_NUM_Q + 1]    = IQBENCH_TABLE(rmpy);
+static const IQBENCH_Fcn2 gDiv[IQBENCH_NUM_Q + 1]     = IQBENCH_TABLE(div);
+static const IQBENCH_Fcn1 gSin[IQBENCH_NUM_Q + 1]     = IQBENCH_TABLE(sin);
+static const IQBENCH_Fcn1 gCos[IQBENCH_NUM_Q + 1]     = IQBENCH_TABLE(cos);
+static const IQBENCH_Fcn1 gSinPU[IQBENCH_NUM_Q + 1]   = IQBENCH_TABLE(sinPU);
+static const IQBENCH_Fcn1 gCosPU[IQBENCH_NUM_Q + 1]   = IQBENCH_TABLE(cosPU);
+static const IQBENCH_Fcn2 gAtan2[IQBENCH_NUM_Q + 1]   = IQBENCH_TABLE(atan2);
+static const IQBENCH_Fcn2 gAtan2PU[IQBENCH_NUM_Q + 1] = IQBENCH_TABLE(atan2PU);
+static const IQBENCH_Fcn1 gAsin[IQBENCH_NUM_Q + 1]    = IQBENCH_TABLE(asin);
+static const IQBENCH_Fcn1 gAcos[IQBENCH_NUM_Q + 1]    = IQBENCH_TABLE(acos);
+static const IQBENCH_Fcn1 gExp[IQBENCH_NUM_Q + 1]     = IQBENCH_TABLE(exp);
+static const IQBENCH_Fcn1 gSqrt[IQBENCH_NUM_Q + 1]    = IQBENCH_TABLE(sqrt);
+static const IQBENCH_Fcn1 gIsqrt[IQBENCH_NUM_Q + 1]   = IQBENCH_TABLE(isqrt);
+static const IQBENCH_Fcn2 gMag[IQBENCH_NUM_Q + 1]     = IQBENCH_TABLE(mag);
+
+static IQBENCH_Result_t gResults[IQBENCH_numFcns];
+
+static uint32_t gRandState = IQBENCH_SEED;
+
+// keeps the timed loops from being optimized away
+volatile int32_t gSink_iq;
+volatile float gSink_float;
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Gets the next pseudo random number (xorshift32)
+//! \return    The random number
+static uint32_t IQBENCH_rand(void)
+{
+  uint32_t x = gRandState;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  gRandState = x;
+
+  return(x);
+} // end of IQBENCH_rand() function
+
+
+//! \brief     Gets a random value with a random magnitude, so small arguments are covered too
+//! \return    The random value
+static int32_t IQBENCH_randScaled(void)
+{
+  int32_t value = (int32_t)IQBENCH_rand();
+
+  return(value >> (IQBENCH_rand() % 31));
+} // end of IQBENCH_randScaled() function
+
+
+//! \brief     Generates the arguments of one vector
+//! \details   The arguments are drawn until the exact result is representable
+//!            in the Q format, out of range results are saturated on the C28x
+//!            and carry no information about the accuracy
+//! \param[in]  fcn     The function
+//! \param[in]  q       The Q format
+//! \param[out] pA      The first argument
+//! \param[out] pB      The second argument
+//! \param[out] pExact  The exact result in LSB of the Q format
+static void IQBENCH_genVector(const IQBENCH_Fcn_e fcn,const int q,int32_t *pA,int32_t *pB,double *pExact)
+{
+  double one = ldexp(1.0,q);
+  double exact;
+  int32_t A,B;
+
+  for(;;)
+    {
+      A = IQBENCH_randScaled();
+      B = IQBENCH_randScaled();
+
+      switch(fcn)
+        {
+          case IQBENCH_Fcn_mpy:
+          case IQBENCH_Fcn_rmpy:
+            exact = (double)A * (double)B / one;
+            break;
+          case IQBENCH_Fcn_div:
+            if(B == 0)
+              {
+                continue;
+              }
+            exact = (double)A * one / (double)B;
+            break;
+          case IQBENCH_Fcn_sin:
+          case IQBENCH_Fcn_cos:
+            // the C28x functions take angles from -pi to pi
+            if(fabs((double)A / one) > IQBENCH_PI)
+              {
+                continue;
+              }
+            exact = ((fcn == IQBENCH_Fcn_sin) ? sin((double)A / one) : cos((double)A / one)) * one;
+            break;
+          case IQBENCH_Fcn_sinPU:
+            exact = sin(IQBENCH_TWO_PI * ((double)A / one)) * one;
+            break;
+          case IQBENCH_Fcn_cosPU:
+            exact = cos(IQBENCH_TWO_PI * ((double)A / one)) * one;
+            break;
+          case IQBENCH_Fcn_atan2:
+            exact = atan2((double)A,(double)B) * one;
+            break;
+          case IQBENCH_Fcn_atan2PU:
+            exact = atan2((double)A,(double)B) / IQBENCH_TWO_PI;
+            exact = ((exact < 0.0) ? exact + 1.0 : exact) * one;
+            break;
+          case IQBENCH_Fcn_asin:
+          case IQBENCH_Fcn_acos:
+            if(fabs((double)A / one) > 1.0)
+              {
+                continue;
+              }
+            exact = ((fcn == IQBENCH_Fcn_asin) ? asin((double)A / one) : acos((double)A / one)) * one;
+            break;
+          case IQBENCH_Fcn_exp:
+            exact = exp((double)A / one) * one;
+            break;
+          case IQBENCH_Fcn_sqrt:
+            A = (A < 0) ? -(A + 1) : A;
+            exact = sqrt((double)A * one);
+            break;
+          case IQBENCH_Fcn_isqrt:
+            A = (A < 0) ? -(A + 1) : A;
+            if(A == 0)
+              {
+                continue;
+              }
+            exact = one / sqrt((double)A / one);
+            break;
+          case IQBENCH_Fcn_mag:
+            exact = sqrt((double)A * (double)A + (double)B * (double)B);
+            break;
+          default:
+            exact = 0.0;
+            break;
+        }
+
+      if((exact < 2147483647.0) && (exact >= -2147483648.0))
+        {
+          break;
+        }
+    }
+
+  *pA = A;
+  *pB = B;
+  *pExact = exact;
+
+  return;
+} // end of IQBENCH_genVector() function
+
+
+//! \brief     Runs one library function
+//! \param[in] fcn  The function
+//! \param[in] q    The Q format
+//! \param[in] A    The first argument
+//! \param[in] B    The second argument
+//! \return    The result
+static int32_t IQBENCH_call(const IQBENCH_Fcn_e fcn,const int q,const int32_t A,const int32_t B)
+{
+  switch(fcn)
+    {
+      case IQBENCH_Fcn_mpy:     return(__IQmpy(A,B,q));
+      case IQBENCH_Fcn_rmpy:    return((int32_t)gRmpy[q](A,B));
+      case IQBENCH_Fcn_div:     return((int32_t)gDiv[q](A,B));
+      case IQBENCH_Fcn_sin:     return((int32_t)gSin[q](A));
+      case IQBENCH_Fcn_cos:     return((int32_t)gCos[q](A));
+      case IQBENCH_Fcn_sinPU:   return((int32_t)gSinPU[q](A));
+      case IQBENCH_Fcn_cosPU:   return((int32_t)gCosPU[q](A));
+      case IQBENCH_Fcn_atan2:   return((int32_t)gAtan2[q](A,B));
+      case IQBENCH_Fcn_atan2PU: return((int32_t)gAtan2PU[q](A,B));
+      case IQBENCH_Fcn_asin:    return((int32_t)gAsin[q](A));
+      case IQBENCH_Fcn_acos:    return((int32_t)gAcos[q](A));
+      case IQBENCH_Fcn_exp:     return((int32_t)gExp[q](A));
+      case IQBENCH_Fcn_sqrt:    return((int32_t)gSqrt[q](A));
+      case IQBENCH_Fcn_isqrt:   return((int32_t)gIsqrt[q](A));
+      case IQBENCH_Fcn_mag:     return((int32_t)gMag[q](A,B));
+      default:                  return(0);
+    }
+} // end of IQBENCH_call() function
+
+
+//! \brief     Loads a reference table
+//! \param[in]  pFileName  The file name
+//! \param[out] pNumRefs   The number of vectors read
+//! \return    The vectors, NULL on error
+static IQBENCH_RefVector_t *IQBENCH_loadRef(const char *pFileName,size_t *pNumRefs)
+{
+  FILE *pFile = fopen(pFileName,"r");
+  IQBENCH_RefVector_t *pRefs = NULL;
+  size_t numRefs = 0,maxRefs = 0;
+  char name[16];
+  unsigned int q,A,B,result;
+
+  if(pFile == NULL)
+    {
+      perror(pFileName);
+      return(NULL);
+    }
+
+  while(fscanf(pFile,"%15s %u %x %x %x",name,&q,&A,&B,&result) == 5)
+    {
+      int fcn;
+
+      for(fcn=0;fcn<IQBENCH_numFcns;fcn++)
+        {
+          if(strcmp(name,gFcnNames[fcn]) == 0)
+            {
+              break;
+            }
+        }
+
+      if((fcn == IQBENCH_numFcns) || (q < 1) || (q > IQBENCH_NUM_Q))
+        {
+          continue;
+        }
+
+      if(numRefs == maxRefs)
+        {
+          maxRefs = (maxRefs == 0) ? 4096 : 2 * maxRefs;
+          pRefs = realloc(pRefs,maxRefs * sizeof(IQBENCH_RefVector_t));
+          if(pRefs == NULL)
+            {
+              fclose(pFile);
+              return(NULL);
+            }
+        }
+
+      pRefs[numRefs].fcn = (uint8_t)fcn;
+      pRefs[numRefs].q = (uint8_t)q;
+      pRefs[numRefs].A = A;
+      pRefs[numRefs].B = B;
+      pRefs[numRefs].result = result;
+      numRefs++;
+    }
+
+  fclose(pFile);
+
+  *pNumRefs = numRefs;
+
+  return(pRefs);
+} // end of IQBENCH_loadRef() function
+
+
+//! \brief     Checks the results against the exact results and the reference table
+//! \param[in] numVectors  The number of vectors per function and Q format
+//! \param[in] pRefFile    The reference table to write, NULL for none
+static void IQBENCH_runAccuracy(const uint_least32_t numVectors,FILE *pRefFile)
+{
+  int fcn,q;
+  uint_least32_t cnt;
+
+  for(fcn=0;fcn<IQBENCH_numFcns;fcn++)
+    {
+      IQBENCH_Result_t *pResult = &gResults[fcn];
+
+      for(q=1;q<=IQBENCH_NUM_Q;q++)
+        {
+          double one = ldexp(1.0,q);
+
+          for(cnt=0;cnt<numVectors;cnt++)
+            {
+              int32_t A,B,result;
+              double exact,err;
+
+              IQBENCH_genVector((IQBENCH_Fcn_e)fcn,q,&A,&B,&exact);
+
+              result = IQBENCH_call((IQBENCH_Fcn_e)fcn,q,A,B);
+              err = fabs((double)result - exact);
+
+              // the per unit angle wraps from one to zero
+              if(fcn == IQBENCH_Fcn_atan2PU)
+                {
+                  err = fmin(err,fabs(err - one));
+                }
+
+              if(err > pResult->maxErr_lsb[q])
+                {
+                  pResult->maxErr_lsb[q] = err;
+                }
+
+              pResult->numVectors++;
+
+              if(pRefFile != NULL)
+                {
+                  fprintf(pRefFile,"%s %d %08x %08x %08x\n",gFcnNames[fcn],q,
+                          (unsigned int)(uint32_t)A,(unsigned int)(uint32_t)B,(unsigned int)(uint32_t)result);
+                }
+            }
+        }
+    }
+
+  return;
+} // end of IQBENCH_runAccuracy() function
+
+
+//! \brief     Checks the results bit for bit against a reference table
+//! \param[in] pRefs    The reference vectors
+//! \param[in] numRefs  The number of reference vectors
+//! \param[in] flag_verbose  Prints every mismatch when true
+static void IQBENCH_runReference(const IQBENCH_RefVector_t *pRefs,const size_t numRefs,const bool flag_verbose)
+{
+  size_t cnt;
+
+  for(cnt=0;cnt<numRefs;cnt++)
+    {
+      const IQBENCH_RefVector_t *pRef = &pRefs[cnt];
+      IQBENCH_Result_t *pResult = &gResults[pRef->fcn];
+      int32_t result = IQBENCH_call((IQBENCH_Fcn_e)pRef->fcn,pRef->q,(int32_t)pRef->A,(int32_t)pRef->B);
+
+      pResult->numRefVectors++;
+
+      if((uint32_t)result != pRef->result)
+        {
+          pResult->numRefMismatches++;
+
+          if(flag_verbose)
+            {
+              printf("mismatch %s Q%d %08x %08x: host %08x reference %08x\n",
+                     gFcnNames[pRef->fcn],pRef->q,(unsigned int)pRef->A,(unsigned int)pRef->B,
+                     (unsigned int)(uint32_t)result,(unsigned int)pRef->result);
+            }
+        }
+    }
+
+  return;
+} // end of IQBENCH_runReference() function
+
+
+//! \brief Checks _IQN() for a constant and for a run time argument
+//!
+#define IQBENCH_CHECK_CONV(N)                                                             \
+  numErrors += (_IQ##N(IQBENCH_CONV_VALUE) != (long)ldexpl((float)IQBENCH_CONV_VALUE,N)); \
+  numErrors += (_IQ##N(value) != (long)ldexpl(value,N))
+
+
+//! \brief     Checks the conversion of constant and run time arguments by _IQN()
+//! \details   Constants are rounded to float like on the C28x, run time
+//!            arguments are converted from their full value
+//! \return    The number of wrong conversions
+static uint_least32_t IQBENCH_runConversion(void)
+{
+  volatile double value = IQBENCH_CONV_VALUE;
+  uint_least32_t numErrors = 0;
+
+  IQBENCH_CHECK_CONV(30);
+  IQBENCH_CHECK_CONV(24);
+  IQBENCH_CHECK_CONV(15);
+
+  // the value is chosen so both conversions differ at Q30
+  numErrors += (_IQ30(IQBENCH_CONV_VALUE) == _IQ30(value));
+
+  return(numErrors);
+} // end of IQBENCH_runConversion() function
+
+
+//! \brief     Gets the time in nanoseconds
+//! \return    The time, ns
+static double IQBENCH_getTime_ns(void)
+{
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC,&time);
+
+  return((double)time.tv_sec * 1.0e9 + (double)time.tv_nsec);
+} // end of IQBENCH_getTime_ns() function
+
+
+//! \brief     Times the functions at GLOBAL_Q and the matching float operations
+//! \param[in] numCalls  The number of calls per function
+static void IQBENCH_runSpeed(const uint_least32_t numCalls)
+{
+  static int32_t A[IQBENCH_NUM_TIMED_INPUTS],B[IQBENCH_NUM_TIMED_INPUTS];
+  static float fA[IQBENCH_NUM_TIMED_INPUTS],fB[IQBENCH_NUM_TIMED_INPUTS];
+  int fcn;
+  uint_least32_t cnt;
+
+  for(fcn=0;fcn<IQBENCH_numFcns;fcn++)
+    {
+      IQBENCH_Result_t *pResult = &gResults[fcn];
+      int32_t sum_iq = 0;
+      float sum_float = 0.0f;
+      double start_ns;
+
+      for(cnt=0;cnt<IQBENCH_NUM_TIMED_INPUTS;cnt++)
+        {
+          double exact;
+
+          IQBENCH_genVector((IQBENCH_Fcn_e)fcn,GLOBAL_Q,&A[cnt],&B[cnt],&exact);
+          fA[cnt] = _IQtoF(A[cnt]);
+          fB[cnt] = _IQtoF(B[cnt]);
+        }
+
+      // IQ_MATH
+      start_ns = IQBENCH_getTime_ns();
+
+      switch(fcn)
+        {
+          case IQBENCH_Fcn_mpy:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQmpy(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)],B[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_rmpy:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQrmpy(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)],B[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_div:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQdiv(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)],B[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_sin:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQsin(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_cos:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQcos(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_sinPU:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQsinPU(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_cosPU:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQcosPU(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_atan2:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQatan2(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)],B[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_atan2PU:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQatan2PU(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)],B[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_asin:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQasin(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_acos:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQacos(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_exp:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQexp(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_sqrt:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQsqrt(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_isqrt:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQisqrt(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_mag:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_iq += _IQmag(A[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)],B[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          default:
+            break;
+        }
+
+      pResult->iq_ns = (IQBENCH_getTime_ns() - start_ns) / (double)numCalls;
+
+      // FLOAT_MATH
+      start_ns = IQBENCH_getTime_ns();
+
+      switch(fcn)
+        {
+          case IQBENCH_Fcn_mpy:
+          case IQBENCH_Fcn_rmpy:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)] * fB[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)];
+            break;
+          case IQBENCH_Fcn_div:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)] / fB[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)];
+            break;
+          case IQBENCH_Fcn_sin:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += sinf(fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_cos:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += cosf(fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_sinPU:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += sinf((float)IQBENCH_TWO_PI * fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_cosPU:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += cosf((float)IQBENCH_TWO_PI * fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_atan2:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += atan2f(fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)],fB[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_atan2PU:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += atan2f(fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)],fB[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]) * (float)(1.0 / IQBENCH_TWO_PI);
+            break;
+          case IQBENCH_Fcn_asin:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += asinf(fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_acos:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += acosf(fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_exp:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += expf(fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_sqrt:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += sqrtf(fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_isqrt:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += 1.0f / sqrtf(fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          case IQBENCH_Fcn_mag:
+            for(cnt=0;cnt<numCalls;cnt++)
+              sum_float += sqrtf(fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)] * fA[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)] +
+                                 fB[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)] * fB[cnt & (IQBENCH_NUM_TIMED_INPUTS - 1)]);
+            break;
+          default:
+            break;
+        }
+
+      pResult->float_ns = (IQBENCH_getTime_ns() - start_ns) / (double)numCalls;
+
+      gSink_iq = sum_iq;
+      gSink_float = sum_float;
+    }
+
+  return;
+} // end of IQBENCH_runSpeed() function
+
+
+//! \brief     Prints the command line options
+//! \param[in] pName  The program name
+static void IQBENCH_usage(const char *pName)
+{
+  fprintf(stderr,"usage: %s [-n vectors] [-c calls] [-w table] [-r table] [-v]\n",pName);
+  fprintf(stderr,"  -n  vectors per function and Q format, default %d\n",IQBENCH_DEFAULT_NUM_VECTORS);
+  fprintf(stderr,"  -c  calls per timed function, default %d, 0 skips the timing\n",IQBENCH_DEFAULT_NUM_CALLS);
+  fprintf(stderr,"  -w  writes the host results as a reference table\n");
+  fprintf(stderr,"  -r  checks the results bit for bit against a reference table\n");
+  fprintf(stderr,"  -v  prints the error per Q format and every reference mismatch\n");
+
+  return;
+} // end of IQBENCH_usage() function
+
+
+int main(int argc,char *argv[])
+{
+  uint_least32_t numVectors = IQBENCH_DEFAULT_NUM_VECTORS;
+  uint_least32_t numCalls = IQBENCH_DEFAULT_NUM_CALLS;
+  const char *pWriteName = NULL;
+  const char *pRefName = NULL;
+  bool flag_verbose = false;
+  FILE *pRefFile = NULL;
+  uint_least32_t numMismatches = 0;
+  uint_least32_t numRefVectors = 0;
+  uint_least32_t numConvErrors;
+  bool flag_accuracy = true;
+  int fcn,q,opt;
+
+  while((opt = getopt(argc,argv,"n:c:w:r:vh")) != -1)
+    {
+      switch(opt)
+        {
+          case 'n':
+            numVectors = (uint_least32_t)strtoul(optarg,NULL,0);
+            break;
+          case 'c':
+            numCalls = (uint_least32_t)strtoul(optarg,NULL,0);
+            break;
+          case 'w':
+            pWriteName = optarg;
+            break;
+          case 'r':
+            pRefName = optarg;
+            break;
+          case 'v':
+            flag_verbose = true;
+            break;
+          default:
+            IQBENCH_usage(argv[0]);
+            return(EXIT_FAILURE);
+        }
+    }
+
+  if(pWriteName != NULL)
+    {
+      pRefFile = fopen(pWriteName,"w");
+      if(pRefFile == NULL)
+        {
+          perror(pWriteName);
+          return(EXIT_FAILURE);
+        }
+    }
+
+  IQBENCH_runAccuracy(numVectors,pRefFile);
+
+  if(pRefFile != NULL)
+    {
+      fclose(pRefFile);
+    }
+
+  if(pRefName != NULL)
+    {
+      size_t numRefs = 0;
+      IQBENCH_RefVector_t *pRefs = IQBENCH_loadRef(pRefName,&numRefs);
+
+      if(pRefs == NULL)
+        {
+          return(EXIT_FAILURE);
+        }
+
+      IQBENCH_runReference(pRefs,numRefs,flag_verbose);
+      free(pRefs);
+    }
+
+  if(numCalls > 0)
+    {
+      IQBENCH_runSpeed(numCalls);
+    }
+
+  numConvErrors = IQBENCH_runConversion();
+
+  printf("function  max err (LSB)  allowed  worst Q  ref vectors  ref mismatches  IQ%d ns/op  float ns/op\n",GLOBAL_Q);
+
+  for(fcn=0;fcn<IQBENCH_numFcns;fcn++)
+    {
+      const IQBENCH_Result_t *pResult = &gResults[fcn];
+      double maxErr_lsb = 0.0;
+      int worstQ = 1;
+
+      for(q=1;q<=IQBENCH_NUM_Q;q++)
+        {
+          if(pResult->maxErr_lsb[q] > maxErr_lsb)
+            {
+              maxErr_lsb = pResult->maxErr_lsb[q];
+              worstQ = q;
+            }
+        }
+
+      printf("%-8s  %13.4f  %7.1f  %7d  %11lu  %14lu  %10.2f  %11.2f\n",
+             gFcnNames[fcn],maxErr_lsb,gMaxErrAllowed_lsb[fcn],worstQ,
+             (unsigned long)pResult->numRefVectors,(unsigned long)pResult->numRefMismatches,
+             pResult->iq_ns,pResult->float_ns);
+
+      if(flag_verbose)
+        {
+          for(q=1;q<=IQBENCH_NUM_Q;q++)
+            {
+              printf("          Q%-2d %8.4f\n",q,pResult->maxErr_lsb[q]);
+            }
+        }
+
+      numMismatches += pResult->numRefMismatches;
+      numRefVectors += pResult->numRefVectors;
+
+      if(maxErr_lsb > gMaxErrAllowed_lsb[fcn])
+        {
+          flag_accuracy = false;
+        }
+    }
+
+  printf("_IQN() conversion errors %lu\n",(unsigned long)numConvErrors);
+
+  // a reference table without vectors checks nothing
+  if((pRefName != NULL) && (numRefVectors == 0))
+    {
+      fprintf(stderr,"%s: no reference vectors\n",pRefName);
+      return(EXIT_FAILURE);
+    }
+
+  return(((numMismatches == 0) && (numConvErrors == 0) && flag_accuracy) ? EXIT_SUCCESS : EXIT_FAILURE);
+} // end of main() function
+
+// end of file
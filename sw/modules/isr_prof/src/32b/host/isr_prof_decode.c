@@ -0,0 +1,442 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/isr_prof/src/32b/host/isr_prof_decode.c
+//! \brief  Decodes a memory dump of the ISR stage profiler (ISR_PROF) object
+//!
+//!         The dump is either a binary file of 32-bit little endian words,
+//!         as written by the host simulator, or a CCS data file (File ->
+//!         Data -> Save Memory, hex format) of the isr_prof object with
+//!         32-bit or 16-bit words.  With 16-bit words the low word of each
+//!         32-bit value comes first, as in the C28x memory.
+//!
+//!         The block is found by ISR_PROF_MAGIC, so the dump may start
+//!         before the object.  For every stage the number of samples, the
+//!         minimum, mean and maximum time, the time in the longest ISR and
+//!         the histogram are printed in timer counts and microseconds.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sw/modules/isr_prof/src/32b/isr_prof.h"
+
+
+// **************************************************************************
+// the defines
+
+#define ISR_PROF_DECODE_MAX_WORDS       (65536)     // 32-bit words read from the dump
+#define ISR_PROF_DECODE_HEADER_WORDS    (11)        // words before the stage statistics
+#define ISR_PROF_DECODE_STATS_WORDS     (8)         // words of a stage before the histogram
+#define ISR_PROF_DECODE_BAR_WIDTH       (40)        // characters of the longest histogram bar
+#define ISR_PROF_DECODE_MAX_STAGES      (64)
+
+
+// **************************************************************************
+// the globals
+
+static const char *ISR_PROF_DECODE_stageNames[ISR_PROF_numStages] = ISR_PROF_STAGE_NAMES;
+
+
+// **************************************************************************
+// the functions
+
+static void ISR_PROF_DECODE_usage(const char *pName)
+{
+  fprintf(stderr,"usage: %s [-H] [-q] <dump>\n",pName);
+  fprintf(stderr,"  <dump>  binary file of 32-bit little endian words or a CCS hex data file\n");
+  fprintf(stderr,"  -H      do not print the histograms\n");
+  fprintf(stderr,"  -q      print one summary line per stage only\n");
+
+  return;
+} // end of ISR_PROF_DECODE_usage() function
+
+
+//! \brief     Reads a CCS data file
+//! \details   The header line is "1651 <format> <address> <page> <length>",
+//!            followed by one value per line.  Values of up to four hex
+//!            digits are taken as 16-bit words and paired, low word first.
+static size_t ISR_PROF_DECODE_readText(FILE *pFile,uint32_t *pWords,const size_t maxWords)
+{
+  char line[128];
+  size_t numWords = 0;
+  bool flag_16bit = false;
+  bool flag_haveLow = false;
+  bool flag_header = true;
+  bool flag_first = true;
+  uint32_t lowWord = 0;
+
+  while((numWords < maxWords) && (fgets(line,sizeof(line),pFile) != NULL))
+    {
+      char *pStr = line;
+      char *pEnd;
+      size_t numDigits;
+      unsigned long value;
+
+      while(isspace((unsigned char)*pStr))
+        {
+          pStr++;
+        }
+
+      if(*pStr == '\0')
+        {
+          continue;
+        }
+
+      // the CCS header
+      if(flag_header && (strncmp(pStr,"1651",4) == 0) && isspace((unsigned char)pStr[4]))
+        {
+          flag_header = false;
+          continue;
+        }
+
+      flag_header = false;
+
+      if((pStr[0] == '0') && ((pStr[1] == 'x') || (pStr[1] == 'X')))
+        {
+          pStr += 2;
+        }
+
+      value = strtoul(pStr,&pEnd,16);
+
+      if(pEnd == pStr)
+        {
+          continue;
+        }
+
+      numDigits = (size_t)(pEnd - pStr);
+
+      if(flag_first)
+        {
+          flag_16bit = (numDigits <= 4);
+          flag_first = false;
+        }
+
+      if(flag_16bit)
+        {
+          if(flag_haveLow)
+            {
+              pWords[numWords++] = lowWord | ((uint32_t)(value & 0xFFFF) << 16);
+            }
+          else
+            {
+              lowWord = (uint32_t)(value & 0xFFFF);
+            }
+
+          flag_haveLow = !flag_haveLow;
+        }
+      else
+        {
+          pWords[numWords++] = (uint32_t)value;
+        }
+    }
+
+  return(numWords);
+} // end of ISR_PROF_DECODE_readText() function
+
+
+static size_t ISR_PROF_DECODE_readBinary(FILE *pFile,uint32_t *pWords,const size_t maxWords)
+{
+  unsigned char bytes[4];
+  size_t numWords = 0;
+
+  while((numWords < maxWords) && (fread(bytes,1,4,pFile) == 4))
+    {
+      pWords[numWords++] = (uint32_t)bytes[0] |
+                           ((uint32_t)bytes[1] << 8) |
+                           ((uint32_t)bytes[2] << 16) |
+                           ((uint32_t)bytes[3] << 24);
+    }
+
+  return(numWords);
+} // end of ISR_PROF_DECODE_readBinary() function
+
+
+static size_t ISR_PROF_DECODE_read(const char *pFileName,uint32_t *pWords,const size_t maxWords)
+{
+  FILE *pFile = fopen(pFileName,"rb");
+  size_t numWords;
+  bool flag_text = true;
+  unsigned char bytes[16];
+  size_t numBytes,cnt;
+
+  if(pFile == NULL)
+    {
+      perror(pFileName);
+      return(0);
+    }
+
+  // a text dump only has printable characters at the start
+  numBytes = fread(bytes,1,sizeof(bytes),pFile);
+
+  for(cnt=0;cnt<numBytes;cnt++)
+    {
+      if(!isprint(bytes[cnt]) && !isspace(bytes[cnt]))
+        {
+          flag_text = false;
+          break;
+        }
+    }
+
+  rewind(pFile);
+
+  if(flag_text && (numBytes > 0))
+    {
+      numWords = ISR_PROF_DECODE_readText(pFile,pWords,maxWords);
+    }
+  else
+    {
+      numWords = ISR_PROF_DECODE_readBinary(pFile,pWords,maxWords);
+    }
+
+  fclose(pFile);
+
+  return(numWords);
+} // end of ISR_PROF_DECODE_read() function
+
+
+static const char *ISR_PROF_DECODE_getStageName(const uint32_t stage,const uint32_t numStages,char *pBuf,const size_t bufSize)
+{
+  if((numStages == ISR_PROF_numStages) && (stage < ISR_PROF_numStages))
+    {
+      return(ISR_PROF_DECODE_stageNames[stage]);
+    }
+
+  snprintf(pBuf,bufSize,"Stage%u",(unsigned)stage);
+
+  return(pBuf);
+} // end of ISR_PROF_DECODE_getStageName() function
+
+
+static void ISR_PROF_DECODE_printHist(const uint32_t *pHist,const uint32_t numBins,const uint32_t binShift,
+                                      const uint32_t numSamples,const double cnts_to_us)
+{
+  uint32_t maxCount = 0;
+  uint32_t bin;
+
+  for(bin=0;bin<numBins;bin++)
+    {
+      if(pHist[bin] > maxCount)
+        {
+          maxCount = pHist[bin];
+        }
+    }
+
+  if(maxCount == 0)
+    {
+      return;
+    }
+
+  for(bin=0;bin<numBins;bin++)
+    {
+      uint32_t lo_cnts = bin << binShift;
+      uint32_t barLength = (uint32_t)(((uint64_t)pHist[bin] * ISR_PROF_DECODE_BAR_WIDTH + maxCount - 1) / maxCount);
+      char bar[ISR_PROF_DECODE_BAR_WIDTH + 1];
+
+      if(pHist[bin] == 0)
+        {
+          continue;
+        }
+
+      memset(bar,'#',barLength);
+      bar[barLength] = '\0';
+
+      if(bin == (numBins - 1))
+        {
+          printf("      >= %6u cnts %8.2f us  %10u %6.2f%%  %s\n",
+                 (unsigned)lo_cnts,lo_cnts * cnts_to_us,(unsigned)pHist[bin],
+                 100.0 * pHist[bin] / numSamples,bar);
+        }
+      else
+        {
+          printf("      <  %6u cnts %8.2f us  %10u %6.2f%%  %s\n",
+                 (unsigned)(lo_cnts + (1u << binShift)),(lo_cnts + (1u << binShift)) * cnts_to_us,
+                 (unsigned)pHist[bin],100.0 * pHist[bin] / numSamples,bar);
+        }
+    }
+
+  return;
+} // end of ISR_PROF_DECODE_printHist() function
+
+
+int main(int argc,char *argv[])
+{
+  uint32_t *pWords;
+  size_t numWords,offset;
+  const uint32_t *pBlock;
+  uint32_t version,numStages,numBins,timerFreq_Hz,timerPeriod_cnts,isrPeriod_cnts,numOverruns;
+  uint32_t stage;
+  uint64_t worstTotal_cnts = 0;
+  bool flag_hist = true;
+  bool flag_quiet = false;
+  double cnts_to_us;
+  int opt;
+
+  while((opt = getopt(argc,argv,"Hqh")) != -1)
+    {
+      switch(opt)
+        {
+          case 'H':
+            flag_hist = false;
+            break;
+          case 'q':
+            flag_quiet = true;
+            flag_hist = false;
+            break;
+          default:
+            ISR_PROF_DECODE_usage(argv[0]);
+            return(opt == 'h' ? 0 : 2);
+        }
+    }
+
+  if(optind != (argc - 1))
+    {
+      ISR_PROF_DECODE_usage(argv[0]);
+      return(2);
+    }
+
+  pWords = malloc(ISR_PROF_DECODE_MAX_WORDS * sizeof(uint32_t));
+
+  if(pWords == NULL)
+    {
+      fprintf(stderr,"out of memory\n");
+      return(1);
+    }
+
+  numWords = ISR_PROF_DECODE_read(argv[optind],pWords,ISR_PROF_DECODE_MAX_WORDS);
+
+  // find the block
+  for(offset=0;offset<numWords;offset++)
+    {
+      if(pWords[offset] == ISR_PROF_MAGIC)
+        {
+          break;
+        }
+    }
+
+  if((numWords - offset) < ISR_PROF_DECODE_HEADER_WORDS)
+    {
+      fprintf(stderr,"%s: no ISR_PROF block found in %u words\n",argv[optind],(unsigned)numWords);
+      free(pWords);
+      return(1);
+    }
+
+  pBlock = &pWords[offset];
+  version = pBlock[1];
+  numStages = pBlock[2];
+  numBins = pBlock[3];
+  timerFreq_Hz = pBlock[4];
+  timerPeriod_cnts = pBlock[5];
+  isrPeriod_cnts = pBlock[6];
+  numOverruns = pBlock[7];
+
+  if((version != ISR_PROF_VERSION) || (numStages == 0) || (numStages > ISR_PROF_DECODE_MAX_STAGES) ||
+     (numBins == 0) || (numBins > 32) || (timerFreq_Hz == 0))
+    {
+      fprintf(stderr,"%s: unsupported ISR_PROF block, version %u, %u stages, %u bins\n",
+              argv[optind],(unsigned)version,(unsigned)numStages,(unsigned)numBins);
+      free(pWords);
+      return(1);
+    }
+
+  if((numWords - offset) < (ISR_PROF_DECODE_HEADER_WORDS + numStages * (ISR_PROF_DECODE_STATS_WORDS + numBins)))
+    {
+      fprintf(stderr,"%s: truncated ISR_PROF block\n",argv[optind]);
+      free(pWords);
+      return(1);
+    }
+
+  cnts_to_us = 1.0e6 / (double)timerFreq_Hz;
+
+  printf("timer           %.3f MHz, period %u cnts\n",timerFreq_Hz * 1.0e-6,(unsigned)(timerPeriod_cnts + 1));
+  printf("ISR period      %u cnts, %.2f us\n",(unsigned)isrPeriod_cnts,isrPeriod_cnts * cnts_to_us);
+  printf("ISR overruns    %u\n\n",(unsigned)numOverruns);
+
+  printf("%-10s %10s %8s %10s %8s %8s %9s\n","stage","samples","min","mean","max","worst","max us");
+
+  for(stage=0;stage<numStages;stage++)
+    {
+      const uint32_t *pStats = &pBlock[ISR_PROF_DECODE_HEADER_WORDS + stage * (ISR_PROF_DECODE_STATS_WORDS + numBins)];
+      uint32_t numSamples = pStats[0];
+      uint32_t min_cnts = pStats[1];
+      uint32_t max_cnts = pStats[2];
+      uint64_t sum_cnts = (uint64_t)pStats[3] | ((uint64_t)pStats[4] << 32);
+      uint32_t worst_cnts = pStats[6];
+      uint32_t binShift = pStats[7];
+      char nameBuf[16];
+      const char *pName = ISR_PROF_DECODE_getStageName(stage,numStages,nameBuf,sizeof(nameBuf));
+
+      if(numSamples == 0)
+        {
+          printf("%-10s %10s\n",pName,"-");
+          continue;
+        }
+
+      printf("%-10s %10u %8u %10.1f %8u %8u %9.2f\n",pName,(unsigned)numSamples,(unsigned)min_cnts,
+             (double)sum_cnts / numSamples,(unsigned)max_cnts,(unsigned)worst_cnts,max_cnts * cnts_to_us);
+
+      if(stage != (numStages - 1))
+        {
+          worstTotal_cnts += worst_cnts;
+        }
+
+      // the last stage is the whole ISR
+      if((stage == (numStages - 1)) && (isrPeriod_cnts != 0) && !flag_quiet)
+        {
+          printf("%-10s CPU load mean %.1f%%, max %.1f%%, stages in the longest ISR %.1f%% of it\n","",
+                 100.0 * ((double)sum_cnts / numSamples) / isrPeriod_cnts,
+                 100.0 * max_cnts / isrPeriod_cnts,
+                 max_cnts != 0 ? 100.0 * worstTotal_cnts / max_cnts : 0.0);
+        }
+
+      if(flag_hist && (binShift < 32))
+        {
+          ISR_PROF_DECODE_printHist(&pStats[ISR_PROF_DECODE_STATS_WORDS],numBins,binShift,numSamples,cnts_to_us);
+        }
+    }
+
+  free(pWords);
+
+  return(0);
+} // end of main() function
+
+
+// end of file
@@ -0,0 +1,131 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/isr_prof/src/32b/isr_prof.c
+//! \brief  Portable C code.  These functions define the
+//!         ISR stage profiler (ISR_PROF) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/isr_prof/src/32b/isr_prof.h"
+
+
+// **************************************************************************
+// the globals
+
+
+// **************************************************************************
+// the functions
+
+ISR_PROF_Handle ISR_PROF_init(void *pMemory,const size_t numBytes)
+{
+  ISR_PROF_Handle handle;
+
+  if(numBytes < sizeof(ISR_PROF_Obj))
+    return((ISR_PROF_Handle)NULL);
+
+  // assign the handle
+  handle = (ISR_PROF_Handle)pMemory;
+
+  return(handle);
+} // end of ISR_PROF_init() function
+
+
+void ISR_PROF_resetStats(ISR_PROF_Handle handle)
+{
+  ISR_PROF_Obj *obj = (ISR_PROF_Obj *)handle;
+  uint_least8_t stage;
+  uint_least8_t bin;
+
+  for(stage=0;stage<ISR_PROF_numStages;stage++)
+    {
+      ISR_PROF_Stats_t *pStats = &obj->stats[stage];
+
+      pStats->numSamples = 0;
+      pStats->min_cnts = 0xFFFFFFFF;
+      pStats->max_cnts = 0;
+      pStats->sumLo_cnts = 0;
+      pStats->sumHi_cnts = 0;
+      pStats->last_cnts = 0;
+      pStats->worst_cnts = 0;
+
+      for(bin=0;bin<ISR_PROF_NUM_BINS;bin++)
+        {
+          pStats->hist[bin] = 0;
+        }
+    }
+
+  obj->numOverruns = 0;
+  obj->flag_resetStats = false;
+
+  return;
+} // end of ISR_PROF_resetStats() function
+
+
+void ISR_PROF_setParams(ISR_PROF_Handle handle,
+                        struct _HAL_Obj_ *halHandle,
+                        const uint_least8_t timerNumber,
+                        const uint32_t timerFreq_Hz,
+                        const uint32_t timerPeriod_cnts,
+                        const uint32_t isrPeriod_cnts)
+{
+  ISR_PROF_Obj *obj = (ISR_PROF_Obj *)handle;
+  uint_least8_t stage;
+
+  obj->magic = ISR_PROF_MAGIC;
+  obj->version = ISR_PROF_VERSION;
+  obj->numStages = ISR_PROF_numStages;
+  obj->numBins = ISR_PROF_NUM_BINS;
+  obj->timerFreq_Hz = timerFreq_Hz;
+  obj->timerPeriod_cnts = timerPeriod_cnts;
+  obj->isrPeriod_cnts = isrPeriod_cnts;
+  obj->cnt_start = 0;
+  obj->cnt_z1 = 0;
+
+  obj->halHandle = halHandle;
+  obj->timerNumber = timerNumber;
+
+  for(stage=0;stage<ISR_PROF_numStages;stage++)
+    {
+      ISR_PROF_setBinShift(handle,(ISR_PROF_Stage_e)stage,ISR_PROF_DEFAULT_BIN_SHIFT);
+    }
+
+  ISR_PROF_resetStats(handle);
+
+  return;
+} // end of ISR_PROF_setParams() function
+
+
+// end of file
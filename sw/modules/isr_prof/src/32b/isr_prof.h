@@ -0,0 +1,409 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _ISR_PROF_H_
+#define _ISR_PROF_H_
+
+//! \file   modules/isr_prof/src/32b/isr_prof.h
+//! \brief  Contains the public interface to the
+//!         ISR stage profiler (ISR_PROF) module routines
+//!
+//!         The profiler timestamps the stages of the ISR and of the online
+//!         controller with a free running CPU timer and keeps, per stage,
+//!         the number of samples, the minimum, the sum, the maximum, the time
+//!         of the stage in the longest ISR and a histogram.  The statistics
+//!         are in one block of 32-bit words starting with ISR_PROF_MAGIC, so
+//!         a memory dump of the object is decoded on the host with
+//!         modules/isr_prof/src/32b/host/isr_prof_decode.c.
+//!
+//!         The ISR_PROF_START(), ISR_PROF_MARK() and ISR_PROF_STOP() macros
+//!         expand to nothing unless ISR_PROF_ENABLE is defined.  When it is,
+//!         the project defines the isr_prof object and sets it up with
+//!         ISR_PROF_init() and ISR_PROF_setParams().
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+// modules
+#include "sw/modules/types/src/types.h"
+
+
+//!
+//!
+//! \defgroup ISR_PROF ISR_PROF
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the first word of the statistics block, "ISRP"
+//!
+#define ISR_PROF_MAGIC                (0x50525349UL)
+
+//! \brief Defines the version of the statistics block layout
+//!
+#define ISR_PROF_VERSION              (1)
+
+//! \brief Defines the number of histogram bins per stage, the last bin
+//!        counts everything at or above its lower edge
+//!
+#define ISR_PROF_NUM_BINS             (16)
+
+//! \brief Defines the default histogram bin width, 2^6 = 64 cnts
+//!
+#define ISR_PROF_DEFAULT_BIN_SHIFT    (6)
+
+//! \brief Defines the stage names, in the order of ISR_PROF_Stage_e
+//!
+#define ISR_PROF_STAGE_NAMES          { "AdcRead", "Clarke", "Est", "Park", \
+                                        "SpeedPi", "CurrentPi", "Svgen", "PwmWrite", "Isr" }
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Enumeration for the profiled stages
+//! \details Every stage is the time from the previous mark to its own mark, so
+//!          a stage that is skipped in an ISR is not counted in that ISR and
+//!          its time goes to the next stage that is marked.
+//!
+typedef enum
+{
+  ISR_PROF_Stage_AdcRead=0,     //!< ISR entry to the end of HAL_readAdcData()
+  ISR_PROF_Stage_Clarke,        //!< Clarke transforms of current and voltage
+  ISR_PROF_Stage_Est,           //!< EST_run()
+  ISR_PROF_Stage_Park,          //!< sin/cos phasor and Park transform
+  ISR_PROF_Stage_SpeedPi,       //!< speed PI controller
+  ISR_PROF_Stage_CurrentPi,     //!< Id and Iq PI controllers
+  ISR_PROF_Stage_Svgen,         //!< angle delay compensation, inverse Park and SVGEN
+  ISR_PROF_Stage_PwmWrite,      //!< HAL_writePwmData()
+  ISR_PROF_Stage_Isr,           //!< ISR entry to ISR_PROF_STOP()
+  ISR_PROF_numStages
+} ISR_PROF_Stage_e;
+
+
+//! \brief Defines the statistics of one stage
+//!
+typedef struct _ISR_PROF_Stats_t_
+{
+  uint32_t          numSamples;                   //!< the number of samples
+  uint32_t          min_cnts;                     //!< the minimum time, cnts
+  uint32_t          max_cnts;                     //!< the maximum time, cnts
+  uint32_t          sumLo_cnts;                   //!< the low word of the sum of the times, cnts
+  uint32_t          sumHi_cnts;                   //!< the high word of the sum of the times, cnts
+  uint32_t          last_cnts;                    //!< the time in the latest ISR, 0 when not run, cnts
+  uint32_t          worst_cnts;                   //!< the time in the longest ISR, cnts
+  uint32_t          binShift;                     //!< the histogram bin width is 2^binShift cnts
+  uint32_t          hist[ISR_PROF_NUM_BINS];      //!< the histogram
+} ISR_PROF_Stats_t;
+
+
+//! \brief Defines the ISR stage profiler (ISR_PROF) object
+//! \details All members up to and including stats[] are 32-bit words so the
+//!          block has the same layout on the C28x and on the host.
+//!
+typedef struct _ISR_PROF_Obj_
+{
+  uint32_t          magic;                        //!< ISR_PROF_MAGIC
+  uint32_t          version;                      //!< ISR_PROF_VERSION
+  uint32_t          numStages;                    //!< the number of stages
+  uint32_t          numBins;                      //!< the number of histogram bins per stage
+  uint32_t          timerFreq_Hz;                 //!< the timer frequency, Hz
+  uint32_t          timerPeriod_cnts;             //!< the timer period, cnts
+  uint32_t          isrPeriod_cnts;               //!< the ISR period, cnts
+  uint32_t          numOverruns;                  //!< the number of ISRs longer than the ISR period
+  uint32_t          flag_resetStats;              //!< a flag to reset all statistics in the next ISR
+  uint32_t          cnt_start;                    //!< the timer count at the ISR entry, cnts
+  uint32_t          cnt_z1;                       //!< the timer count at the previous mark, cnts
+
+  ISR_PROF_Stats_t  stats[ISR_PROF_numStages];    //!< the statistics per stage
+
+  struct _HAL_Obj_  *halHandle;                   //!< the HAL handle used to read the timer
+  uint_least8_t     timerNumber;                  //!< the CPU timer number
+} ISR_PROF_Obj;
+
+
+//! \brief Defines the ISR_PROF handle
+//!
+typedef struct _ISR_PROF_Obj_ *ISR_PROF_Handle;
+
+
+//! \brief Defines the number of 32-bit words in the statistics block
+//!
+#define ISR_PROF_NUM_BLOCK_WORDS      (11 + ISR_PROF_numStages * (8 + ISR_PROF_NUM_BINS))
+
+
+// **************************************************************************
+// the globals
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Initializes the ISR stage profiler (ISR_PROF) object
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The ISR stage profiler (ISR_PROF) object handle
+extern ISR_PROF_Handle ISR_PROF_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Resets all statistics
+//! \param[in] handle  The ISR stage profiler (ISR_PROF) handle
+extern void ISR_PROF_resetStats(ISR_PROF_Handle handle);
+
+
+//! \brief     Sets the histogram bin width of a stage
+//! \param[in] handle    The ISR stage profiler (ISR_PROF) handle
+//! \param[in] stage     The stage
+//! \param[in] binShift  The bin width is 2^binShift cnts
+static inline void ISR_PROF_setBinShift(ISR_PROF_Handle handle,const ISR_PROF_Stage_e stage,const uint_least8_t binShift)
+{
+  ISR_PROF_Obj *obj = (ISR_PROF_Obj *)handle;
+
+  obj->stats[stage].binShift = binShift;
+
+  return;
+} // end of ISR_PROF_setBinShift() function
+
+
+//! \brief     Sets the flag to reset all statistics in the next ISR
+//! \param[in] handle  The ISR stage profiler (ISR_PROF) handle
+//! \param[in] state   The desired state
+static inline void ISR_PROF_setFlag_resetStats(ISR_PROF_Handle handle,const bool state)
+{
+  ISR_PROF_Obj *obj = (ISR_PROF_Obj *)handle;
+
+  obj->flag_resetStats = state;
+
+  return;
+} // end of ISR_PROF_setFlag_resetStats() function
+
+
+//! \brief     Sets the ISR stage profiler parameters and resets the statistics
+//! \param[in] handle            The ISR stage profiler (ISR_PROF) handle
+//! \param[in] halHandle         The hardware abstraction layer (HAL) handle
+//! \param[in] timerNumber       The free running CPU timer, read with HAL_readTimerCnt()
+//! \param[in] timerFreq_Hz      The timer frequency, Hz
+//! \param[in] timerPeriod_cnts  The timer period, cnts
+//! \param[in] isrPeriod_cnts    The ISR period, cnts
+extern void ISR_PROF_setParams(ISR_PROF_Handle handle,
+                               struct _HAL_Obj_ *halHandle,
+                               const uint_least8_t timerNumber,
+                               const uint32_t timerFreq_Hz,
+                               const uint32_t timerPeriod_cnts,
+                               const uint32_t isrPeriod_cnts);
+
+
+//! \brief     Computes the time between two counts of the count down timer
+//! \param[in] handle  The ISR stage profiler (ISR_PROF) handle
+//! \param[in] cnt_z1  The earlier count, cnts
+//! \param[in] cnt     The later count, cnts
+//! \return    The time, cnts
+static inline uint32_t ISR_PROF_computeDelta(ISR_PROF_Handle handle,const uint32_t cnt_z1,const uint32_t cnt)
+{
+  ISR_PROF_Obj *obj = (ISR_PROF_Obj *)handle;
+  uint32_t deltaCnt;
+
+  // handle wrap around of the timer count
+  // NOTE: count down timer
+  if(cnt > cnt_z1)
+    {
+      deltaCnt = cnt_z1 + obj->timerPeriod_cnts - cnt + 1;
+    }
+  else
+    {
+      deltaCnt = cnt_z1 - cnt;
+    }
+
+  return(deltaCnt);
+} // end of ISR_PROF_computeDelta() function
+
+
+//! \brief     Adds one sample to the statistics of a stage
+//! \param[in] pStats    The pointer to the statistics of the stage
+//! \param[in] deltaCnt  The time of the stage, cnts
+static inline void ISR_PROF_addSample(ISR_PROF_Stats_t *pStats,const uint32_t deltaCnt)
+{
+  uint32_t bin = deltaCnt >> pStats->binShift;
+
+  if(bin >= ISR_PROF_NUM_BINS)
+    {
+      bin = ISR_PROF_NUM_BINS - 1;
+    }
+
+  pStats->hist[bin]++;
+  pStats->numSamples++;
+  pStats->last_cnts = deltaCnt;
+
+  pStats->sumLo_cnts += deltaCnt;
+  if(pStats->sumLo_cnts < deltaCnt)
+    {
+      pStats->sumHi_cnts++;
+    }
+
+  if(deltaCnt < pStats->min_cnts)
+    {
+      pStats->min_cnts = deltaCnt;
+    }
+
+  if(deltaCnt > pStats->max_cnts)
+    {
+      pStats->max_cnts = deltaCnt;
+    }
+
+  return;
+} // end of ISR_PROF_addSample() function
+
+
+//! \brief     Starts the profiling of an ISR, call at the ISR entry
+//! \param[in] handle  The ISR stage profiler (ISR_PROF) handle
+//! \param[in] cnt     The timer count, cnts
+static inline void ISR_PROF_start(ISR_PROF_Handle handle,const uint32_t cnt)
+{
+  ISR_PROF_Obj *obj = (ISR_PROF_Obj *)handle;
+  uint_least8_t stage;
+
+  if(obj->flag_resetStats)
+    {
+      ISR_PROF_resetStats(handle);
+    }
+
+  for(stage=0;stage<ISR_PROF_numStages;stage++)
+    {
+      obj->stats[stage].last_cnts = 0;
+    }
+
+  obj->cnt_start = cnt;
+  obj->cnt_z1 = cnt;
+
+  return;
+} // end of ISR_PROF_start() function
+
+
+//! \brief     Marks the end of a stage
+//! \param[in] handle  The ISR stage profiler (ISR_PROF) handle
+//! \param[in] stage   The stage that ends
+//! \param[in] cnt     The timer count, cnts
+static inline void ISR_PROF_mark(ISR_PROF_Handle handle,const ISR_PROF_Stage_e stage,const uint32_t cnt)
+{
+  ISR_PROF_Obj *obj = (ISR_PROF_Obj *)handle;
+
+  ISR_PROF_addSample(&obj->stats[stage],ISR_PROF_computeDelta(handle,obj->cnt_z1,cnt));
+
+  obj->cnt_z1 = cnt;
+
+  return;
+} // end of ISR_PROF_mark() function
+
+
+//! \brief     Stops the profiling of an ISR, call at the end of the ISR
+//! \details   When the ISR is the longest so far, the times of its stages are
+//!            kept in worst_cnts, which shows where an overrun comes from.
+//! \param[in] handle  The ISR stage profiler (ISR_PROF) handle
+//! \param[in] cnt     The timer count, cnts
+static inline void ISR_PROF_stop(ISR_PROF_Handle handle,const uint32_t cnt)
+{
+  ISR_PROF_Obj *obj = (ISR_PROF_Obj *)handle;
+  uint32_t deltaCnt = ISR_PROF_computeDelta(handle,obj->cnt_start,cnt);
+
+  if(deltaCnt > obj->isrPeriod_cnts)
+    {
+      obj->numOverruns++;
+    }
+
+  if(deltaCnt > obj->stats[ISR_PROF_Stage_Isr].max_cnts)
+    {
+      uint_least8_t stage;
+
+      obj->stats[ISR_PROF_Stage_Isr].last_cnts = deltaCnt;
+
+      for(stage=0;stage<ISR_PROF_numStages;stage++)
+        {
+          obj->stats[stage].worst_cnts = obj->stats[stage].last_cnts;
+        }
+    }
+
+  ISR_PROF_addSample(&obj->stats[ISR_PROF_Stage_Isr],deltaCnt);
+
+  return;
+} // end of ISR_PROF_stop() function
+
+
+// **************************************************************************
+// the instrumentation macros
+
+#ifdef ISR_PROF_ENABLE
+
+#include "hal.h"
+
+//! \brief The profiler object, defined by the project
+//!
+extern ISR_PROF_Obj isr_prof;
+
+//! \brief Starts the profiling of an ISR
+//!
+#define ISR_PROF_START()      ISR_PROF_start(&isr_prof,HAL_readTimerCnt(isr_prof.halHandle,isr_prof.timerNumber))
+
+//! \brief Marks the end of a stage
+//!
+#define ISR_PROF_MARK(stage)  ISR_PROF_mark(&isr_prof,(stage),HAL_readTimerCnt(isr_prof.halHandle,isr_prof.timerNumber))
+
+//! \brief Stops the profiling of an ISR
+//!
+#define ISR_PROF_STOP()       ISR_PROF_stop(&isr_prof,HAL_readTimerCnt(isr_prof.halHandle,isr_prof.timerNumber))
+
+#else
+
+#define ISR_PROF_START()
+#define ISR_PROF_MARK(stage)
+#define ISR_PROF_STOP()
+
+#endif // ISR_PROF_ENABLE
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _ISR_PROF_H_ definition
+
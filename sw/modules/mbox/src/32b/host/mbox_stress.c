@@ -0,0 +1,299 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/mbox/src/32b/host/mbox_stress.c
+//! \brief  Checks the command mailbox (MBOX) under preemption
+//!
+//!         The main loop is the producer and posts command records as fast
+//!         as it can.  A periodic timer signal is the consumer and takes
+//!         the records as mainISR does, the signal handler is never
+//!         interrupted by the main loop, as the ISR is never interrupted by
+//!         the background loop.  All fields of a record are derived from one
+//!         sequence number, so a record mixed from two posts is detected,
+//!         and the sequence numbers must never go back.
+//!
+//!         With -u the producer writes the fields straight into the record
+//!         the consumer reads, as the background loop writes the controller
+//!         without the mailbox, and the torn records are counted for
+//!         comparison.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "sw/modules/mbox/src/32b/mbox.h"
+
+
+// **************************************************************************
+// the defines
+
+#define MBOX_STRESS_DEFAULT_DURATION_sec   (1.0)
+#define MBOX_STRESS_TIMER_PERIOD_usec      (20)
+#define MBOX_STRESS_MIN_TAKES              (1000)
+
+
+// **************************************************************************
+// the globals
+
+static MBOX_Obj mbox;
+
+static MBOX_Handle mboxHandle;
+
+// the record written in place with -u
+static volatile MBOX_Cmd_t gUnprotectedCmd;
+
+static bool gFlag_unprotected = false;
+
+static volatile sig_atomic_t gFlag_stop = 0;
+
+static volatile uint32_t gNumChecked = 0;
+
+static volatile uint32_t gNumTorn = 0;
+
+static volatile uint32_t gNumBackwards = 0;
+
+static volatile int32_t gLastSeq = -1;
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Fills the command record of a sequence number, one field at a time
+//! \param[in] pCmd  The command record
+//! \param[in] seq   The sequence number
+static void MBOX_STRESS_fill(volatile MBOX_Cmd_t *pCmd,const int32_t seq)
+{
+  pCmd->flag_enableUserMotorParams = (seq & 1) != 0;
+  pCmd->flag_enableOffset = (seq & 2) != 0;
+  pCmd->flag_updateRefs = true;
+  pCmd->speedRef_krpm = seq;
+  pCmd->maxAccel_pu = seq * 3 + 1;
+  pCmd->maxCurrentSlope_pu = seq ^ 0x5555555;
+  pCmd->flag_updateGains = true;
+  pCmd->Kp_spd = seq;
+  pCmd->Ki_spd = -seq;
+  pCmd->Kp_Idq = seq + 7;
+  pCmd->Ki_Idq = ~seq;
+
+  return;
+} // end of MBOX_STRESS_fill() function
+
+
+//! \brief     Checks a command record and its sequence number
+//! \param[in] pCmd  The command record
+static void MBOX_STRESS_check(const volatile MBOX_Cmd_t *pCmd)
+{
+  int32_t seq = pCmd->Kp_spd;
+
+  // nothing posted yet
+  if(pCmd->flag_updateGains == false)
+    {
+      return;
+    }
+
+  gNumChecked++;
+
+  if((pCmd->flag_enableUserMotorParams != ((seq & 1) != 0)) ||
+     (pCmd->flag_enableOffset != ((seq & 2) != 0)) ||
+     (pCmd->speedRef_krpm != seq) ||
+     (pCmd->maxAccel_pu != seq * 3 + 1) ||
+     (pCmd->maxCurrentSlope_pu != (seq ^ 0x5555555)) ||
+     (pCmd->Ki_spd != -seq) ||
+     (pCmd->Kp_Idq != seq + 7) ||
+     (pCmd->Ki_Idq != ~seq))
+    {
+      gNumTorn++;
+      return;
+    }
+
+  if(seq < gLastSeq)
+    {
+      gNumBackwards++;
+    }
+
+  gLastSeq = seq;
+
+  return;
+} // end of MBOX_STRESS_check() function
+
+
+//! \brief     The consumer, runs on the timer signal as mainISR on the ADC interrupt
+//! \param[in] sig  The signal number
+static void MBOX_STRESS_isr(int sig)
+{
+  (void)sig;
+
+  if(gFlag_unprotected)
+    {
+      MBOX_STRESS_check(&gUnprotectedCmd);
+    }
+  else
+    {
+      const MBOX_Cmd_t *pCmd = MBOX_take(mboxHandle);
+
+      if(pCmd != NULL)
+        {
+          MBOX_STRESS_check(pCmd);
+        }
+    }
+
+  return;
+} // end of MBOX_STRESS_isr() function
+
+
+//! \brief     Stops the producer at the end of the run
+//! \param[in] sig  The signal number
+static void MBOX_STRESS_stop(int sig)
+{
+  (void)sig;
+
+  gFlag_stop = 1;
+
+  return;
+} // end of MBOX_STRESS_stop() function
+
+
+static void MBOX_STRESS_usage(const char *pName)
+{
+  fprintf(stderr,
+          "usage: %s [-t sec] [-u] [-c]\n"
+          "  -t sec  run time, default %.1f s\n"
+          "  -u      write the record in place without the mailbox\n"
+          "  -c      check, fail on a torn or older record or too few records\n",
+          pName,MBOX_STRESS_DEFAULT_DURATION_sec);
+
+  return;
+} // end of MBOX_STRESS_usage() function
+
+
+int main(int argc,char *argv[])
+{
+  double duration_sec = MBOX_STRESS_DEFAULT_DURATION_sec;
+  bool flag_check = false;
+  struct sigaction action;
+  struct itimerval timer;
+  int32_t seq = 0;
+  int opt;
+
+
+  while((opt = getopt(argc,argv,"t:uch")) != -1)
+    {
+      switch(opt)
+        {
+          case 't':
+            duration_sec = atof(optarg);
+            break;
+          case 'u':
+            gFlag_unprotected = true;
+            break;
+          case 'c':
+            flag_check = true;
+            break;
+          default:
+            MBOX_STRESS_usage(argv[0]);
+            return(opt == 'h' ? 0 : 1);
+        }
+    }
+
+  mboxHandle = MBOX_init(&mbox,sizeof(mbox));
+
+  // the consumer preempts the producer at a fixed rate, the end of the run
+  // is a second signal on the process time, most of which the signals spend
+  // in the kernel
+  memset(&action,0,sizeof(action));
+  sigemptyset(&action.sa_mask);
+  action.sa_handler = MBOX_STRESS_isr;
+  sigaction(SIGALRM,&action,NULL);
+
+  action.sa_handler = MBOX_STRESS_stop;
+  sigaction(SIGPROF,&action,NULL);
+
+  memset(&timer,0,sizeof(timer));
+  timer.it_interval.tv_usec = MBOX_STRESS_TIMER_PERIOD_usec;
+  timer.it_value.tv_usec = MBOX_STRESS_TIMER_PERIOD_usec;
+  setitimer(ITIMER_REAL,&timer,NULL);
+
+  memset(&timer,0,sizeof(timer));
+  timer.it_value.tv_sec = (time_t)duration_sec;
+  timer.it_value.tv_usec = (suseconds_t)((duration_sec - (double)timer.it_value.tv_sec) * 1.0e6);
+  setitimer(ITIMER_PROF,&timer,NULL);
+
+  // the producer
+  while(!gFlag_stop)
+    {
+      seq = (seq + 1) & 0x3fffffff;
+
+      if(gFlag_unprotected)
+        {
+          MBOX_STRESS_fill(&gUnprotectedCmd,seq);
+        }
+      else
+        {
+          MBOX_STRESS_fill(MBOX_getCmd_addr(mboxHandle),seq);
+          MBOX_post(mboxHandle);
+        }
+    }
+
+  memset(&timer,0,sizeof(timer));
+  setitimer(ITIMER_REAL,&timer,NULL);
+
+  printf("%s\n",gFlag_unprotected ? "in place" : "mailbox");
+  printf("records posted          %ld\n",(long)seq);
+  printf("records checked         %lu\n",(unsigned long)gNumChecked);
+  printf("records torn            %lu\n",(unsigned long)gNumTorn);
+  printf("records older           %lu\n",(unsigned long)gNumBackwards);
+
+  if(flag_check)
+    {
+      if((gNumTorn != 0) || (gNumBackwards != 0) || (gNumChecked < MBOX_STRESS_MIN_TAKES))
+        {
+          printf("FAIL\n");
+          return(1);
+        }
+
+      printf("PASS\n");
+    }
+
+  return(0);
+} // end of main() function
+
+// end of file
@@ -0,0 +1,91 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/mbox/src/32b/mbox.c
+//! \brief  Portable C code.  These functions define the
+//!         command mailbox (MBOX) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/mbox/src/32b/mbox.h"
+
+
+// **************************************************************************
+// the functions
+
+MBOX_Handle MBOX_init(void *pMemory,const size_t numBytes)
+{
+  MBOX_Handle handle;
+  MBOX_Obj *obj;
+
+
+  if(numBytes < sizeof(MBOX_Obj))
+    return((MBOX_Handle)NULL);
+
+  // assign the handle
+  handle = (MBOX_Handle)pMemory;
+
+  obj = (MBOX_Obj *)handle;
+
+  memset(&obj->cmd[0],0,sizeof(obj->cmd));
+
+  obj->postedIdx = 0;
+  obj->writeIdx = 0;
+  obj->numPosts = 0;
+  obj->numTakes = 0;
+
+  return(handle);
+} // end of MBOX_init() function
+
+
+void MBOX_post(MBOX_Handle handle)
+{
+  MBOX_Obj *obj = (MBOX_Obj *)handle;
+  uint_least16_t writeIdx = obj->writeIdx;
+
+
+  // a single store, the ISR sees either the previous or this buffer
+  obj->postedIdx = writeIdx + 1;
+  obj->numPosts++;
+
+  // the ISR cannot read the other buffer before the next post, continue on a copy
+  writeIdx ^= 1;
+  obj->cmd[writeIdx] = obj->cmd[writeIdx ^ 1];
+  obj->writeIdx = writeIdx;
+
+  return;
+} // end of MBOX_post() function
+
+// end of file
@@ -0,0 +1,205 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _MBOX_H_
+#define _MBOX_H_
+
+//! \file   modules/mbox/src/32b/mbox.h
+//! \brief  Contains the public interface to the
+//!         command mailbox (MBOX) module routines
+//!
+//!         The mailbox carries the gains, references and flags from the
+//!         background loop to mainISR.  The background loop is the only
+//!         producer and fills a complete command record, then posts it with
+//!         MBOX_post().  The ISR is the only consumer and takes the latest
+//!         posted record with MBOX_take() at the start of a tick, so the
+//!         controller never runs with half of a gain pair or a torn 32-bit
+//!         value.
+//!
+//!         The record is double buffered.  The producer writes the buffer
+//!         that is not posted and posts it with a single 16-bit store of its
+//!         index.  The consumer is never interrupted by the producer, as for
+//!         mainISR and the background loop, so it reads the posted buffer
+//!         in one piece without a lock.  A record posted again before the
+//!         ISR took it replaces the previous one, the ISR applies the
+//!         latest one only.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+// modules
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+
+
+//!
+//!
+//! \defgroup MBOX MBOX
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the command record from the background loop to the ISR
+//!
+typedef struct _MBOX_Cmd_t_
+{
+  bool   flag_enableUserMotorParams;  //!< the flag to use the motor parameters of user.h
+  bool   flag_enableOffset;           //!< the flag to calculate the offsets
+  bool   flag_enableRsRecalc;         //!< the flag to recalibrate Rs at startup
+  bool   flag_enableForceAngle;       //!< the flag to force the angle at low speed
+  bool   flag_enablePowerWarp;        //!< the flag to enable PowerWarp
+
+  bool   flag_updateRefs;             //!< the flag to apply the references below
+  _iq    speedRef_krpm;               //!< the speed reference, krpm
+  _iq    maxAccel_pu;                 //!< the maximum acceleration, pu
+  _iq    maxCurrentSlope_pu;          //!< the maximum current slope of the estimator, pu
+
+  bool   flag_updateGains;            //!< the flag to apply the gains below
+  _iq    Kp_spd;                      //!< the proportional gain of the speed controller
+  _iq    Ki_spd;                      //!< the integral gain of the speed controller
+  _iq    Kp_Idq;                      //!< the proportional gain of the Id and Iq controllers
+  _iq    Ki_Idq;                      //!< the integral gain of the Id and Iq controllers
+} MBOX_Cmd_t;
+
+
+//! \brief Defines the command mailbox (MBOX) object
+//!
+typedef struct _MBOX_Obj_
+{
+  MBOX_Cmd_t                cmd[2];       //!< the two command buffers
+  volatile uint_least16_t   postedIdx;    //!< the index of the posted buffer plus one, zero when taken
+  uint_least16_t            writeIdx;     //!< the index of the buffer the producer fills
+  uint32_t                  numPosts;     //!< the number of posted records
+  volatile uint32_t         numTakes;     //!< the number of taken records
+} MBOX_Obj;
+
+
+//! \brief Defines the MBOX handle
+//!
+typedef struct _MBOX_Obj_ *MBOX_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Gets the command record the producer fills
+//! \details   The record holds the last posted values, so the producer only
+//!            needs to write what changed.
+//! \param[in] handle  The command mailbox (MBOX) handle
+//! \return    The pointer to the command record
+static inline MBOX_Cmd_t *MBOX_getCmd_addr(MBOX_Handle handle)
+{
+  MBOX_Obj *obj = (MBOX_Obj *)handle;
+
+  return(&obj->cmd[obj->writeIdx]);
+} // end of MBOX_getCmd_addr() function
+
+
+//! \brief     Gets the number of posted records
+//! \param[in] handle  The command mailbox (MBOX) handle
+//! \return    The number of posted records
+static inline uint32_t MBOX_getNumPosts(MBOX_Handle handle)
+{
+  MBOX_Obj *obj = (MBOX_Obj *)handle;
+
+  return(obj->numPosts);
+} // end of MBOX_getNumPosts() function
+
+
+//! \brief     Gets the number of taken records, the difference to the
+//!            number of posted records were replaced before the ISR took them
+//! \param[in] handle  The command mailbox (MBOX) handle
+//! \return    The number of taken records
+static inline uint32_t MBOX_getNumTakes(MBOX_Handle handle)
+{
+  MBOX_Obj *obj = (MBOX_Obj *)handle;
+
+  return(obj->numTakes);
+} // end of MBOX_getNumTakes() function
+
+
+//! \brief     Initializes the command mailbox (MBOX) module
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The command mailbox (MBOX) handle
+extern MBOX_Handle MBOX_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Posts the command record, called by the producer only
+//! \details   The ISR takes the record from the next tick on.  The producer
+//!            continues on the other buffer, which starts as a copy of the
+//!            posted one.
+//! \param[in] handle  The command mailbox (MBOX) handle
+extern void MBOX_post(MBOX_Handle handle);
+
+
+//! \brief     Takes the latest posted command record, called by the consumer only
+//! \details   The record stays valid until the producer posts again, which
+//!            cannot happen before the ISR returns.
+//! \param[in] handle  The command mailbox (MBOX) handle
+//! \return    The pointer to the command record, NULL when nothing was posted since the last call
+static inline const MBOX_Cmd_t *MBOX_take(MBOX_Handle handle)
+{
+  MBOX_Obj *obj = (MBOX_Obj *)handle;
+  uint_least16_t postedIdx = obj->postedIdx;
+
+
+  if(postedIdx == 0)
+    {
+      return((const MBOX_Cmd_t *)NULL);
+    }
+
+  obj->postedIdx = 0;
+  obj->numTakes++;
+
+  return(&obj->cmd[postedIdx - 1]);
+} // end of MBOX_take() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _MBOX_H_ definition
+
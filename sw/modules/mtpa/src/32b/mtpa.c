@@ -0,0 +1,159 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/mtpa/src/32b/mtpa.c
+//! \brief  Portable C code.  These functions define the
+//!         maximum torque per ampere (MTPA) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/mtpa/src/32b/mtpa.h"
+#include "sw/modules/math/src/32b/math.h"
+
+
+// **************************************************************************
+// the functions
+
+MTPA_Handle MTPA_init(void *pMemory,const size_t numBytes)
+{
+  MTPA_Handle handle;
+  MTPA_Obj *obj;
+
+
+  if(numBytes < sizeof(MTPA_Obj))
+    return((MTPA_Handle)NULL);
+
+  // assign the handle
+  handle = (MTPA_Handle)pMemory;
+
+  obj = (MTPA_Obj *)handle;
+
+  obj->mode = MTPA_Mode_Analytic;
+  obj->flag_salient = false;
+  obj->K_pu = _IQ(0.0);
+  obj->IdMin_pu = _IQ(0.0);
+
+  obj->pTable = NULL;
+  obj->numTablePoints = 0;
+  obj->maxIq_pu = _IQ(0.0);
+  obj->tableScale = _IQ(0.0);
+  obj->K_table_pu = _IQ(0.0);
+  obj->refreshIndex = 0;
+  obj->flag_tableValid = false;
+
+  obj->Id_ref_pu = _IQ(0.0);
+
+  return(handle);
+} // end of MTPA_init() function
+
+
+void MTPA_setParams(MTPA_Handle handle,const float_t Ls_d_H,const float_t Ls_q_H,
+                    const float_t flux_VpHz,const float_t fullScaleCurrent)
+{
+  MTPA_Obj *obj = (MTPA_Obj *)handle;
+  float_t deltaLs_H = Ls_q_H - Ls_d_H;
+  float_t K_pu = MTPA_MAX_K_PU;
+  bool flag_salient;
+
+
+  if(deltaLs_H > 0.0)
+    {
+      K_pu = (flux_VpHz/MATH_TWO_PI)/(2.0*deltaLs_H*fullScaleCurrent);
+    }
+
+  flag_salient = (K_pu < MTPA_MAX_K_PU);
+
+  if(flag_salient)
+    {
+      _iq K_table_pu = obj->K_table_pu;
+      _iq tolerance_pu = _IQmpy(K_table_pu,_IQ(MTPA_K_TOLERANCE));
+
+      obj->K_pu = _IQ(K_pu);
+
+      // a new table for a new motor, the analytic Id applies until it is complete
+      if(!obj->flag_salient || (_IQabs(obj->K_pu - K_table_pu) > tolerance_pu))
+        {
+          obj->flag_tableValid = false;
+          obj->K_table_pu = obj->K_pu;
+          obj->refreshIndex = 0;
+        }
+    }
+
+  obj->flag_salient = flag_salient;
+
+  return;
+} // end of MTPA_setParams() function
+
+
+void MTPA_setTable(MTPA_Handle handle,_iq *pTable,const uint_least16_t numTablePoints,const _iq maxIq_pu)
+{
+  MTPA_Obj *obj = (MTPA_Obj *)handle;
+
+
+  obj->flag_tableValid = false;
+  obj->pTable = pTable;
+  obj->numTablePoints = numTablePoints;
+  obj->maxIq_pu = maxIq_pu;
+  obj->tableScale = _IQdiv(_IQmpyI32(_IQ(1.0),(int32_t)(numTablePoints - 1)),maxIq_pu);
+  obj->refreshIndex = 0;
+
+  return;
+} // end of MTPA_setTable() function
+
+
+void MTPA_updateTable(MTPA_Handle handle)
+{
+  MTPA_Obj *obj = (MTPA_Obj *)handle;
+
+
+  if(obj->flag_salient && !obj->flag_tableValid && (obj->pTable != NULL))
+    {
+      uint_least16_t n = obj->refreshIndex;
+      _iq Iq_pu = _IQmpyI32(obj->maxIq_pu,(int32_t)n) / (int32_t)(obj->numTablePoints - 1);
+
+      obj->pTable[n] = MTPA_computeId_pu(obj->K_table_pu,Iq_pu);
+
+      if(++n >= obj->numTablePoints)
+        {
+          obj->flag_tableValid = true;
+        }
+
+      obj->refreshIndex = n;
+    }
+
+  return;
+} // end of MTPA_updateTable() function
+
+// end of file
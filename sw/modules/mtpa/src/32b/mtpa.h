@@ -0,0 +1,321 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _MTPA_H_
+#define _MTPA_H_
+
+//! \file   modules/mtpa/src/32b/mtpa.h
+//! \brief  Contains the public interface to the
+//!         maximum torque per ampere (MTPA) module routines
+//!
+//!         A salient motor, Ls_q larger than Ls_d, adds a reluctance torque
+//!         to the magnet torque
+//!
+//!           Te = 3/2*p*(flux*Iq + (Ls_d - Ls_q)*Id*Iq)
+//!
+//!         which a negative Id turns into more torque for the same current.
+//!         The torque for a given current magnitude is largest where
+//!
+//!           flux*Id + (Ls_d - Ls_q)*(Id^2 - Iq^2) = 0
+//!
+//!         and solved for Id with K = flux/(2*(Ls_q - Ls_d))
+//!
+//!           Id = K - sqrt(K^2 + Iq^2) = -Iq^2/(K + sqrt(K^2 + Iq^2))
+//!
+//!         The second form is used, it keeps the precision for a large K.
+//!         Id is computed from the quadrature current reference either
+//!         analytically or from a table over |Iq| with linear interpolation,
+//!         which costs one multiplication instead of a magnitude and a
+//!         division.  The table memory is provided by the project.
+//!
+//!         The motor parameters are handed over from the background loop with
+//!         MTPA_setParams(), usually the identified values of the estimator.
+//!         A change of K by more than MTPA_K_TOLERANCE rebuilds the table with
+//!         MTPA_updateTable(), one entry per call, and until the table is
+//!         complete the Id is computed analytically.  For a surface magnet
+//!         motor K is very large and the Id is zero.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+
+
+//!
+//!
+//! \defgroup MTPA MTPA
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the maximum number of table entries
+//!
+#define MTPA_MAX_TABLE_SIZE         (64)
+
+//! \brief Defines the largest K, pu of current, above it the motor counts as not salient
+//! \brief At 64 pu the Id at full scale Iq is less than 1% of Iq
+//!
+#define MTPA_MAX_K_PU               (64.0)
+
+//! \brief Defines the relative change of K that rebuilds the table
+//!
+#define MTPA_K_TOLERANCE            (1.0/64.0)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Enumeration of the MTPA modes
+//!
+typedef enum
+{
+  MTPA_Mode_Analytic=0,       //!< Id is computed every run
+  MTPA_Mode_Table             //!< Id is read from the table once it is complete
+} MTPA_Mode_e;
+
+
+//! \brief Defines the maximum torque per ampere (MTPA) object
+//!
+typedef struct _MTPA_Obj_
+{
+  MTPA_Mode_e     mode;               //!< the mode
+  bool            flag_salient;       //!< denotes that the motor is salient, else the Id is zero
+  _iq             K_pu;               //!< the flux over twice the difference of the inductances, pu of current
+  _iq             IdMin_pu;           //!< the most negative Id, pu
+
+  _iq            *pTable;             //!< the Id table over |Iq|, pu
+  uint_least16_t  numTablePoints;     //!< the number of table entries
+  _iq             maxIq_pu;           //!< the Iq of the last table entry, pu
+  _iq             tableScale;         //!< the number of table entries per pu of Iq
+  _iq             K_table_pu;         //!< the K the table is built for, pu
+  uint_least16_t  refreshIndex;       //!< the table entry built next
+  bool            flag_tableValid;    //!< denotes that the table is complete for K_table_pu
+
+  _iq             Id_ref_pu;          //!< the Id reference of the last run, pu
+} MTPA_Obj;
+
+
+//! \brief Defines the MTPA handle
+//!
+typedef struct _MTPA_Obj_ *MTPA_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Initializes the maximum torque per ampere (MTPA) module
+//! \param[in] pMemory   A pointer to the memory for the MTPA object
+//! \param[in] numBytes  The number of bytes allocated for the MTPA object, bytes
+//! \return    The MTPA object handle
+extern MTPA_Handle MTPA_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Sets the motor parameters
+//! \details   Called from the background loop.  Rebuilds the table when K
+//!            changed by more than MTPA_K_TOLERANCE or the saliency appeared
+//! \param[in] handle            The MTPA handle
+//! \param[in] Ls_d_H            The direct axis inductance, H
+//! \param[in] Ls_q_H            The quadrature axis inductance, H
+//! \param[in] flux_VpHz         The flux, V/Hz
+//! \param[in] fullScaleCurrent  The full scale current, A
+extern void MTPA_setParams(MTPA_Handle handle,const float_t Ls_d_H,const float_t Ls_q_H,
+                           const float_t flux_VpHz,const float_t fullScaleCurrent);
+
+
+//! \brief     Sets the table memory
+//! \param[in] handle          The MTPA handle
+//! \param[in] pTable          The pointer to the table
+//! \param[in] numTablePoints  The number of table entries, 2 to MTPA_MAX_TABLE_SIZE
+//! \param[in] maxIq_pu        The Iq of the last entry, pu, larger Iq read the last entry
+extern void MTPA_setTable(MTPA_Handle handle,_iq *pTable,const uint_least16_t numTablePoints,const _iq maxIq_pu);
+
+
+//! \brief     Builds the next table entry when the table is not complete
+//! \details   Called from the background loop, one magnitude and one division per call
+//! \param[in] handle  The MTPA handle
+extern void MTPA_updateTable(MTPA_Handle handle);
+
+
+//! \brief     Computes the MTPA Id
+//! \param[in] K_pu   The flux over twice the difference of the inductances, pu of current
+//! \param[in] Iq_pu  The quadrature current, pu
+//! \return    The Id, pu
+static inline _iq MTPA_computeId_pu(const _iq K_pu,const _iq Iq_pu)
+{
+
+  return(-_IQdiv(_IQmpy(Iq_pu,Iq_pu),K_pu + _IQmag(K_pu,Iq_pu)));
+} // end of MTPA_computeId_pu() function
+
+
+//! \brief     Gets the Id reference of the last run
+//! \param[in] handle  The MTPA handle
+//! \return    The Id reference, pu
+static inline _iq MTPA_getId_ref_pu(MTPA_Handle handle)
+{
+  MTPA_Obj *obj = (MTPA_Obj *)handle;
+
+  return(obj->Id_ref_pu);
+} // end of MTPA_getId_ref_pu() function
+
+
+//! \brief     Gets K
+//! \param[in] handle  The MTPA handle
+//! \return    The flux over twice the difference of the inductances, pu of current
+static inline _iq MTPA_getK_pu(MTPA_Handle handle)
+{
+  MTPA_Obj *obj = (MTPA_Obj *)handle;
+
+  return(obj->K_pu);
+} // end of MTPA_getK_pu() function
+
+
+//! \brief     Gets the mode
+//! \param[in] handle  The MTPA handle
+//! \return    The mode
+static inline MTPA_Mode_e MTPA_getMode(MTPA_Handle handle)
+{
+  MTPA_Obj *obj = (MTPA_Obj *)handle;
+
+  return(obj->mode);
+} // end of MTPA_getMode() function
+
+
+//! \brief     Denotes that the motor is salient
+//! \param[in] handle  The MTPA handle
+//! \return    The salient flag
+static inline bool MTPA_isSalient(MTPA_Handle handle)
+{
+  MTPA_Obj *obj = (MTPA_Obj *)handle;
+
+  return(obj->flag_salient);
+} // end of MTPA_isSalient() function
+
+
+//! \brief     Denotes that the table is complete for the present parameters
+//! \param[in] handle  The MTPA handle
+//! \return    The table valid flag
+static inline bool MTPA_isTableValid(MTPA_Handle handle)
+{
+  MTPA_Obj *obj = (MTPA_Obj *)handle;
+
+  return(obj->flag_tableValid);
+} // end of MTPA_isTableValid() function
+
+
+//! \brief     Sets the most negative Id
+//! \param[in] handle    The MTPA handle
+//! \param[in] IdMin_pu  The most negative Id, pu
+static inline void MTPA_setIdMin_pu(MTPA_Handle handle,const _iq IdMin_pu)
+{
+  MTPA_Obj *obj = (MTPA_Obj *)handle;
+
+  obj->IdMin_pu = IdMin_pu;
+
+  return;
+} // end of MTPA_setIdMin_pu() function
+
+
+//! \brief     Sets the mode
+//! \param[in] handle  The MTPA handle
+//! \param[in] mode    The mode
+static inline void MTPA_setMode(MTPA_Handle handle,const MTPA_Mode_e mode)
+{
+  MTPA_Obj *obj = (MTPA_Obj *)handle;
+
+  obj->mode = mode;
+
+  return;
+} // end of MTPA_setMode() function
+
+
+//! \brief     Runs the MTPA module
+//! \details   Computes the Id reference for the quadrature current reference,
+//!            from the table in MTPA_Mode_Table once it is complete
+//! \param[in] handle    The MTPA handle
+//! \param[in] Iq_ref_pu  The quadrature current reference, pu
+static inline void MTPA_run(MTPA_Handle handle,const _iq Iq_ref_pu)
+{
+  MTPA_Obj *obj = (MTPA_Obj *)handle;
+  _iq Id_pu = _IQ(0.0);
+
+  if(obj->flag_salient)
+    {
+      if((obj->mode == MTPA_Mode_Table) && obj->flag_tableValid)
+        {
+          _iq position = _IQmpy(_IQabs(Iq_ref_pu),obj->tableScale);
+          int_least32_t n = _IQint(position);
+
+          if(n >= (int_least32_t)(obj->numTablePoints - 1))
+            {
+              Id_pu = obj->pTable[obj->numTablePoints - 1];
+            }
+          else
+            {
+              Id_pu = obj->pTable[n] + _IQmpy(obj->pTable[n + 1] - obj->pTable[n],_IQfrac(position));
+            }
+        }
+      else
+        {
+          Id_pu = MTPA_computeId_pu(obj->K_pu,Iq_ref_pu);
+        }
+
+      if(Id_pu < obj->IdMin_pu)
+        {
+          Id_pu = obj->IdMin_pu;
+        }
+    }
+
+  obj->Id_ref_pu = Id_pu;
+
+  return;
+} // end of MTPA_run() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _MTPA_H_ definition
+
@@ -0,0 +1,561 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/obs/src/32b/host/obs_bench.c
+//! \brief  Measures the angle error and the run time of the back-EMF
+//!         observer (OBS) against a reference motor model
+//!
+//!         The reference is a surface magnet motor with the parameters of
+//!         the DJI E300 in the TIDA-00643 user.h, integrated in double
+//!         precision at a fixed speed.  A feedforward of the ideal dq
+//!         voltage holds the currents, the voltage is constant over each
+//!         tick like the mean of the PWM.  The observer sees the current
+//!         sample and the voltage through the first order filter of the
+//!         board, both quantized like the 12-bit ADC.
+//!
+//!         The file is built twice, with the IQ observer in src/32b and,
+//!         with OBS_FLOAT, with the float observer in src/float.  Each
+//!         build prints the angle and speed errors at a set of speeds and
+//!         the time per OBS_run() call and, where the host provides them,
+//!         the cycle and instruction counts.  With -c it returns an error
+//!         when an angle error exceeds the limit of -e.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+// system includes
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef OBS_FLOAT
+#include "sw/modules/obs/src/float/obs.h"
+#else
+#include "sw/modules/obs/src/32b/obs.h"
+#endif
+
+
+// **************************************************************************
+// the defines
+
+#ifdef OBS_FLOAT
+#define BENCH_BUILD_NAME              "float"
+#define BENCH_toObs(A)                ((float_t)(A))
+#define BENCH_fromObs(A)              ((double)(A))
+#else
+#define BENCH_BUILD_NAME              "iq"
+#define BENCH_toObs(A)                _IQ(A)
+#define BENCH_fromObs(A)              _IQtoF(A)
+#endif
+
+#define BENCH_PI                      (3.14159265358979323846)
+
+// the DJI E300 and the scaling of the TIDA-00643 user.h
+#define BENCH_NUM_POLE_PAIRS          (7)
+#define BENCH_RS_Ohm                  (0.08385667)
+#define BENCH_LS_H                    (1.002232e-05)
+#define BENCH_FLUX_Wb                 (0.005794205 / (2.0 * BENCH_PI))
+#define BENCH_FULL_SCALE_VOLTAGE_V    (20.0)
+#define BENCH_FULL_SCALE_CURRENT_A    (23.57)
+#define BENCH_FULL_SCALE_FREQ_Hz      (800.0)
+#define BENCH_ADC_FULL_SCALE_VOLTAGE_V (19.73)
+#define BENCH_ADC_FULL_SCALE_CURRENT_A (47.14)
+#define BENCH_VOLTAGE_FILTER_POLE_rps (2.0 * BENCH_PI * 382.64)
+#define BENCH_FREQ_Hz                 (15000.0)
+
+// the observer settings of the TIDA-00643 user.h
+#define BENCH_EMF_FILTER_Hz           (500.0)
+#define BENCH_PLL_BANDWIDTH_Hz        (150.0)
+#define BENCH_SPEED_FILTER_Hz         (100.0)
+
+#define BENCH_NUM_SUBSTEPS            (16)        // Runge-Kutta steps per tick
+#define BENCH_SETTLE_sec              (0.2)
+#define BENCH_MEASURE_sec             (0.3)
+#define BENCH_IQ_A                    (5.0)
+#define BENCH_DEFAULT_MAX_ERR_deg     (3.0)
+#define BENCH_DEFAULT_NUM_CALLS       (4000000)
+#define BENCH_NUM_TIMED_INPUTS        (4096)      // must be a power of 2
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the reference motor
+//!
+typedef struct _BENCH_Motor_t_
+{
+  double          Iab_A[2];         //!< the alpha/beta current, A
+  double          Vab_filt_V[2];    //!< the voltage feedback, V
+  double          angle_rad;        //!< the electrical angle, rad
+  double          speed_radps;      //!< the electrical speed, rad/s
+} BENCH_Motor_t;
+
+
+//! \brief Defines the observer inputs of one tick
+//!
+typedef struct _BENCH_Input_t_
+{
+  MATH_vec2       Iab;              //!< the current, pu
+  MATH_vec2       Vab;              //!< the voltage, pu
+} BENCH_Input_t;
+
+
+//! \brief Defines the errors at one speed
+//!
+typedef struct _BENCH_Result_t_
+{
+  double          rmsErr_deg;       //!< the rms angle error, electrical degrees
+  double          maxErr_deg;       //!< the largest angle error, electrical degrees
+  double          speedErr;         //!< the mean relative speed error
+} BENCH_Result_t;
+
+
+// **************************************************************************
+// the globals
+
+OBS_Obj gObs;
+
+BENCH_Input_t gTimedInputs[BENCH_NUM_TIMED_INPUTS];
+
+//! \brief The speeds of the error table, krpm
+static const double gSpeeds_krpm[] = {0.5, 1.0, 2.0, 4.0, 6.0, 7.7, -4.0};
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Computes the current derivative of the reference motor
+//! \param[in] pIab_A     The alpha/beta current, A
+//! \param[in] pVab_V     The alpha/beta voltage, V
+//! \param[in] angle_rad  The electrical angle, rad
+//! \param[in] speed_radps  The electrical speed, rad/s
+//! \param[out] pdIab     The derivative, A/s
+static void BENCH_derivative(const double *pIab_A,const double *pVab_V,
+                             const double angle_rad,const double speed_radps,double *pdIab)
+{
+  double Ealpha = -speed_radps * BENCH_FLUX_Wb * sin(angle_rad);
+  double Ebeta = speed_radps * BENCH_FLUX_Wb * cos(angle_rad);
+
+  pdIab[0] = (pVab_V[0] - BENCH_RS_Ohm * pIab_A[0] - Ealpha) / BENCH_LS_H;
+  pdIab[1] = (pVab_V[1] - BENCH_RS_Ohm * pIab_A[1] - Ebeta) / BENCH_LS_H;
+
+  return;
+} // end of BENCH_derivative() function
+
+
+//! \brief     Advances the reference motor by one tick
+//! \param[in] pMotor  The reference motor
+//! \param[in] Iq_A    The quadrature current to hold, A
+static void BENCH_runMotor(BENCH_Motor_t *pMotor,const double Iq_A)
+{
+  double Ts = 1.0 / BENCH_FREQ_Hz;
+  double h = Ts / (double)BENCH_NUM_SUBSTEPS;
+  double w = pMotor->speed_radps;
+  double angleMid_rad = pMotor->angle_rad + 0.5 * w * Ts;
+  double Vd = -w * BENCH_LS_H * Iq_A;
+  double Vq = BENCH_RS_Ohm * Iq_A + w * BENCH_FLUX_Wb;
+  double Vab_V[2];
+  double alpha = exp(-BENCH_VOLTAGE_FILTER_POLE_rps * Ts);
+  int cnt;
+
+  // the dq voltage that holds the current, at the mean angle of the tick
+  Vab_V[0] = Vd * cos(angleMid_rad) - Vq * sin(angleMid_rad);
+  Vab_V[1] = Vd * sin(angleMid_rad) + Vq * cos(angleMid_rad);
+
+  for(cnt=0;cnt<BENCH_NUM_SUBSTEPS;cnt++)
+    {
+      double th = pMotor->angle_rad;
+      double *I = pMotor->Iab_A;
+      double k1[2],k2[2],k3[2],k4[2],Itmp[2];
+
+      BENCH_derivative(I,Vab_V,th,w,k1);
+      Itmp[0] = I[0] + 0.5 * h * k1[0];
+      Itmp[1] = I[1] + 0.5 * h * k1[1];
+      BENCH_derivative(Itmp,Vab_V,th + 0.5 * h * w,w,k2);
+      Itmp[0] = I[0] + 0.5 * h * k2[0];
+      Itmp[1] = I[1] + 0.5 * h * k2[1];
+      BENCH_derivative(Itmp,Vab_V,th + 0.5 * h * w,w,k3);
+      Itmp[0] = I[0] + h * k3[0];
+      Itmp[1] = I[1] + h * k3[1];
+      BENCH_derivative(Itmp,Vab_V,th + h * w,w,k4);
+
+      I[0] += h / 6.0 * (k1[0] + 2.0 * k2[0] + 2.0 * k3[0] + k4[0]);
+      I[1] += h / 6.0 * (k1[1] + 2.0 * k2[1] + 2.0 * k3[1] + k4[1]);
+
+      pMotor->angle_rad = fmod(th + h * w,2.0 * BENCH_PI);
+    }
+
+  // the voltage feedback filter, exact for a voltage held over the tick
+  pMotor->Vab_filt_V[0] = Vab_V[0] + (pMotor->Vab_filt_V[0] - Vab_V[0]) * alpha;
+  pMotor->Vab_filt_V[1] = Vab_V[1] + (pMotor->Vab_filt_V[1] - Vab_V[1]) * alpha;
+
+  return;
+} // end of BENCH_runMotor() function
+
+
+//! \brief     Quantizes a value like the 12-bit ADC
+//! \param[in] value      The value
+//! \param[in] fullScale  The full scale of the ADC, peak to peak
+//! \return    The quantized value
+static double BENCH_quantize(const double value,const double fullScale)
+{
+  double lsb = fullScale / 4096.0;
+
+  return(floor(value / lsb + 0.5) * lsb);
+} // end of BENCH_quantize() function
+
+
+//! \brief     Samples the reference motor
+//! \param[in] pMotor  The reference motor
+//! \param[out] pInput  The observer inputs
+static void BENCH_sample(const BENCH_Motor_t *pMotor,BENCH_Input_t *pInput)
+{
+  uint_least8_t cnt;
+
+  for(cnt=0;cnt<2;cnt++)
+    {
+      double I_A = BENCH_quantize(pMotor->Iab_A[cnt],BENCH_ADC_FULL_SCALE_CURRENT_A);
+      double V_V = BENCH_quantize(pMotor->Vab_filt_V[cnt],BENCH_ADC_FULL_SCALE_VOLTAGE_V);
+
+      pInput->Iab.value[cnt] = BENCH_toObs(I_A / BENCH_FULL_SCALE_CURRENT_A);
+      pInput->Vab.value[cnt] = BENCH_toObs(V_V / BENCH_FULL_SCALE_VOLTAGE_V);
+    }
+
+  return;
+} // end of BENCH_sample() function
+
+
+//! \brief     Sets up the observer the way the project does
+//! \param[in] RsScale  The observer resistance over the motor resistance
+//! \param[in] LsScale  The observer inductance over the motor inductance
+//! \return    The back-EMF observer (OBS) handle
+static OBS_Handle BENCH_setupObs(const double RsScale,const double LsScale)
+{
+  OBS_Handle handle = OBS_init(&gObs,sizeof(gObs));
+  double Ts = 1.0 / BENCH_FREQ_Hz;
+  double Rs = BENCH_RS_Ohm * RsScale;
+  double Fobs = exp(-Rs * Ts / (BENCH_LS_H * LsScale));
+  double wnTs = 2.0 * BENCH_PI * BENCH_PLL_BANDWIDTH_Hz * Ts;
+
+  OBS_setParams(handle,
+                BENCH_toObs(Fobs),
+                BENCH_toObs(Rs / (1.0 - Fobs) * BENCH_FULL_SCALE_CURRENT_A / BENCH_FULL_SCALE_VOLTAGE_V),
+                BENCH_toObs(1.0 - exp(-2.0 * BENCH_PI * BENCH_EMF_FILTER_Hz * Ts)),
+                BENCH_toObs(1.0 - exp(-BENCH_VOLTAGE_FILTER_POLE_rps * Ts)),
+                BENCH_toObs(2.0 * BENCH_PI / (BENCH_VOLTAGE_FILTER_POLE_rps * Ts)));
+
+  OBS_setPll(handle,
+             BENCH_toObs(2.0 * wnTs / (2.0 * BENCH_PI)),
+             BENCH_toObs(wnTs * wnTs / (2.0 * BENCH_PI)),
+             BENCH_toObs(BENCH_FREQ_Hz / BENCH_FULL_SCALE_FREQ_Hz),
+             BENCH_toObs(2.0 * BENCH_PI * BENCH_SPEED_FILTER_Hz * Ts),
+             BENCH_toObs(BENCH_FULL_SCALE_FREQ_Hz * 60.0 / BENCH_NUM_POLE_PAIRS / 1000.0));
+
+  // no forced angle, the PLL locks from zero
+  OBS_setStartup(handle,BENCH_toObs(0.0),BENCH_toObs(0.0),BENCH_toObs(0.0));
+
+  OBS_start(handle);
+
+  return(handle);
+} // end of BENCH_setupObs() function
+
+
+//! \brief     Runs the observer against the reference motor at one speed
+//! \param[in] handle      The back-EMF observer (OBS) handle
+//! \param[in] speed_krpm  The speed, krpm
+//! \param[out] pResult    The errors
+static void BENCH_runSpeed(OBS_Handle handle,const double speed_krpm,BENCH_Result_t *pResult)
+{
+  BENCH_Motor_t motor;
+  double speed_radps = speed_krpm * 1000.0 / 60.0 * 2.0 * BENCH_PI * BENCH_NUM_POLE_PAIRS;
+  double speed_pu = speed_radps / (2.0 * BENCH_PI * BENCH_FULL_SCALE_FREQ_Hz);
+  uint_least32_t numSettle = (uint_least32_t)(BENCH_SETTLE_sec * BENCH_FREQ_Hz);
+  uint_least32_t numTicks = numSettle + (uint_least32_t)(BENCH_MEASURE_sec * BENCH_FREQ_Hz);
+  double sumErr2 = 0.0,maxErr = 0.0,sumSpeed = 0.0;
+  uint_least32_t tick;
+
+  memset(&motor,0,sizeof(motor));
+  motor.speed_radps = speed_radps;
+  motor.angle_rad = 1.0;
+
+  OBS_start(handle);
+
+  for(tick=0;tick<numTicks;tick++)
+    {
+      BENCH_Input_t input;
+
+      BENCH_runMotor(&motor,(speed_krpm < 0.0) ? -BENCH_IQ_A : BENCH_IQ_A);
+      BENCH_sample(&motor,&input);
+
+      OBS_run(handle,&input.Iab,&input.Vab,BENCH_toObs(speed_pu));
+
+      if(tick >= numSettle)
+        {
+          double err_deg = (BENCH_fromObs(OBS_getAngle_pu(handle)) - motor.angle_rad / (2.0 * BENCH_PI)) * 360.0;
+
+          err_deg = fmod(err_deg,360.0);
+          err_deg = (err_deg > 180.0) ? (err_deg - 360.0) : ((err_deg < -180.0) ? (err_deg + 360.0) : err_deg);
+
+          sumErr2 += err_deg * err_deg;
+          maxErr = fmax(maxErr,fabs(err_deg));
+          sumSpeed += BENCH_fromObs(OBS_getFm_pu(handle));
+        }
+
+      gTimedInputs[tick & (BENCH_NUM_TIMED_INPUTS - 1)] = input;
+    }
+
+  pResult->rmsErr_deg = sqrt(sumErr2 / (double)(numTicks - numSettle));
+  pResult->maxErr_deg = maxErr;
+  pResult->speedErr = sumSpeed / (double)(numTicks - numSettle) / speed_pu - 1.0;
+
+  return;
+} // end of BENCH_runSpeed() function
+
+
+//! \brief     Opens one hardware counter of the calling thread
+//! \param[in] config  The perf event
+//! \return    The file descriptor, -1 when not available
+static int BENCH_openCounter(const uint64_t config)
+{
+#ifdef __linux__
+  struct perf_event_attr attr;
+
+  memset(&attr,0,sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  return((int)syscall(__NR_perf_event_open,&attr,0,-1,-1,0));
+#else
+  return(-1);
+#endif
+} // end of BENCH_openCounter() function
+
+
+//! \brief     Starts or stops a hardware counter
+//! \param[in] fd      The file descriptor
+//! \param[in] enable  true to reset and start, false to stop
+static void BENCH_enableCounter(const int fd,const bool enable)
+{
+#ifdef __linux__
+  if(fd >= 0)
+    {
+      if(enable)
+        {
+          ioctl(fd,PERF_EVENT_IOC_RESET,0);
+          ioctl(fd,PERF_EVENT_IOC_ENABLE,0);
+        }
+      else
+        {
+          ioctl(fd,PERF_EVENT_IOC_DISABLE,0);
+        }
+    }
+#endif
+
+  return;
+} // end of BENCH_enableCounter() function
+
+
+//! \brief     Reads a hardware counter
+//! \param[in] fd  The file descriptor
+//! \return    The count, negative when not available
+static double BENCH_readCounter(const int fd)
+{
+  uint64_t count;
+
+  if((fd < 0) || (read(fd,&count,sizeof(count)) != sizeof(count)))
+    {
+      return(-1.0);
+    }
+
+  return((double)count);
+} // end of BENCH_readCounter() function
+
+
+//! \brief     Returns the monotonic time
+//! \return    The time, ns
+static double BENCH_getTime_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return((double)ts.tv_sec * 1.0e9 + (double)ts.tv_nsec);
+} // end of BENCH_getTime_ns() function
+
+
+//! \brief     Prints the usage
+//! \param[in] pName  The program name
+static void BENCH_usage(const char *pName)
+{
+  fprintf(stderr,"usage: %s [-c] [-e deg] [-n calls] [-R scale] [-L scale]\n",pName);
+  fprintf(stderr,"  -c  check, fail when an rms angle error exceeds the limit\n");
+  fprintf(stderr,"  -e  the limit of the rms angle error, default %.1f deg electrical\n",BENCH_DEFAULT_MAX_ERR_deg);
+  fprintf(stderr,"  -n  timed calls, default %d\n",BENCH_DEFAULT_NUM_CALLS);
+  fprintf(stderr,"  -R  observer resistance over the motor resistance, default 1\n");
+  fprintf(stderr,"  -L  observer inductance over the motor inductance, default 1\n");
+
+  return;
+} // end of BENCH_usage() function
+
+
+int main(int argc,char *argv[])
+{
+  bool flag_check = false;
+  double maxErr_deg = BENCH_DEFAULT_MAX_ERR_deg;
+  uint_least32_t numCalls = BENCH_DEFAULT_NUM_CALLS;
+  double RsScale = 1.0,LsScale = 1.0;
+  uint_least32_t numFailed = 0;
+  OBS_Handle handle;
+  int fd_cycles,fd_instr;
+  double start_ns,ns,cycles,instr;
+  uint_least32_t cnt;
+  int opt;
+
+  while((opt = getopt(argc,argv,"ce:n:R:L:")) != -1)
+    {
+      switch(opt)
+        {
+          case 'c':
+            flag_check = true;
+            break;
+          case 'e':
+            maxErr_deg = atof(optarg);
+            break;
+          case 'n':
+            numCalls = strtoul(optarg,NULL,0);
+            break;
+          case 'R':
+            RsScale = atof(optarg);
+            break;
+          case 'L':
+            LsScale = atof(optarg);
+            break;
+          default:
+            BENCH_usage(argv[0]);
+            return(2);
+        }
+    }
+
+  handle = BENCH_setupObs(RsScale,LsScale);
+
+  printf("build %s, Rs x %.2f, Ls x %.2f, Iq %.1f A\n",BENCH_BUILD_NAME,RsScale,LsScale,BENCH_IQ_A);
+  printf("  speed   angle error rms    max   speed error\n");
+
+  for(cnt=0;cnt<sizeof(gSpeeds_krpm)/sizeof(gSpeeds_krpm[0]);cnt++)
+    {
+      BENCH_Result_t result;
+
+      BENCH_runSpeed(handle,gSpeeds_krpm[cnt],&result);
+
+      printf("%5.1f krpm %9.2f deg %6.2f deg %8.3f %%\n",
+             gSpeeds_krpm[cnt],result.rmsErr_deg,result.maxErr_deg,result.speedErr * 100.0);
+
+      if(result.rmsErr_deg > maxErr_deg)
+        {
+          numFailed++;
+        }
+    }
+
+
+  // time the observer on the inputs of the last speed
+#ifdef __linux__
+  fd_cycles = BENCH_openCounter(PERF_COUNT_HW_CPU_CYCLES);
+  fd_instr = BENCH_openCounter(PERF_COUNT_HW_INSTRUCTIONS);
+#else
+  fd_cycles = BENCH_openCounter(0);
+  fd_instr = BENCH_openCounter(0);
+#endif
+
+  BENCH_enableCounter(fd_cycles,true);
+  BENCH_enableCounter(fd_instr,true);
+  start_ns = BENCH_getTime_ns();
+
+  for(cnt=0;cnt<numCalls;cnt++)
+    {
+      const BENCH_Input_t *pInput = &gTimedInputs[cnt & (BENCH_NUM_TIMED_INPUTS - 1)];
+
+      OBS_run(handle,&pInput->Iab,&pInput->Vab,gObs.speedRef_pu);
+    }
+
+  ns = (BENCH_getTime_ns() - start_ns) / (double)numCalls;
+  BENCH_enableCounter(fd_cycles,false);
+  BENCH_enableCounter(fd_instr,false);
+  cycles = BENCH_readCounter(fd_cycles) / (double)numCalls;
+  instr = BENCH_readCounter(fd_instr) / (double)numCalls;
+
+  printf("per tick  %10.1f ns",ns);
+
+  if(cycles >= 0.0)
+    {
+      printf(" %10.1f cycles",cycles);
+    }
+  else
+    {
+      printf(" %10s cycles","n/a");
+    }
+
+  if(instr >= 0.0)
+    {
+      printf(" %10.1f instr\n",instr);
+    }
+  else
+    {
+      printf(" %10s instr\n","n/a");
+    }
+
+  if(flag_check && (numFailed > 0))
+    {
+      printf("FAIL, %lu speeds above %.1f deg rms\n",(unsigned long)numFailed,maxErr_deg);
+      return(1);
+    }
+
+  return(0);
+} // end of main() function
+
+// end of file
@@ -0,0 +1,198 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/obs/src/32b/obs.c
+//! \brief  Portable C code.  These functions define the
+//!         back-EMF observer (OBS) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/obs/src/32b/obs.h"
+
+
+// **************************************************************************
+// the functions
+
+OBS_Handle OBS_init(void *pMemory,const size_t numBytes)
+{
+  OBS_Handle handle;
+  OBS_Obj *obj;
+
+
+  if(numBytes < sizeof(OBS_Obj))
+    return((OBS_Handle)NULL);
+
+  // assign the handle
+  handle = (OBS_Handle)pMemory;
+
+  obj = (OBS_Obj *)handle;
+
+  obj->Fobs = _IQ(0.0);
+  obj->GobsInv = _IQ(0.0);
+  obj->emfFilterCoeff = _IQ(0.0);
+  obj->emfCompScale = _IQ(0.0);
+  obj->currentFilterCoeff = _IQ(0.0);
+  obj->voltageCompScale = _IQ(0.0);
+  obj->Kp = _IQ(0.0);
+  obj->Ki = _IQ(0.0);
+  obj->speedScale = _IQ(0.0);
+  obj->speedScaleInv = _IQ(0.0);
+  obj->speedFilterCoeff = _IQ(0.0);
+  obj->pu_to_krpm_sf = _IQ(0.0);
+  obj->Iq_startup_pu = _IQ(0.0);
+  obj->handoverSpeed_pu = _IQ(0.0);
+  obj->handbackSpeed_pu = _IQ(0.0);
+
+  OBS_stop(handle);
+
+  return(handle);
+} // end of OBS_init() function
+
+
+void OBS_setParams(OBS_Handle handle,
+                   const _iq Fobs,
+                   const _iq GobsInv,
+                   const _iq emfFilterCoeff,
+                   const _iq currentFilterCoeff,
+                   const _iq voltageCompScale)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  obj->Fobs = Fobs;
+  obj->GobsInv = GobsInv;
+  obj->emfFilterCoeff = emfFilterCoeff;
+  obj->emfCompScale = _IQdiv(_IQ(2.0) - emfFilterCoeff,emfFilterCoeff);
+  obj->currentFilterCoeff = currentFilterCoeff;
+  obj->voltageCompScale = voltageCompScale;
+
+  return;
+} // end of OBS_setParams() function
+
+
+void OBS_setPll(OBS_Handle handle,
+                const _iq Kp,
+                const _iq Ki,
+                const _iq speedScale,
+                const _iq speedFilterCoeff,
+                const _iq pu_to_krpm_sf)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  obj->Kp = Kp;
+  obj->Ki = Ki;
+  obj->speedScale = speedScale;
+  obj->speedScaleInv = _IQdiv(_IQ(1.0),speedScale);
+  obj->speedFilterCoeff = speedFilterCoeff;
+  obj->pu_to_krpm_sf = pu_to_krpm_sf;
+
+  return;
+} // end of OBS_setPll() function
+
+
+void OBS_setStartup(OBS_Handle handle,
+                    const _iq Iq_startup_pu,
+                    const _iq handoverSpeed_pu,
+                    const _iq handbackSpeed_pu)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  obj->Iq_startup_pu = Iq_startup_pu;
+  obj->handoverSpeed_pu = handoverSpeed_pu;
+  obj->handbackSpeed_pu = handbackSpeed_pu;
+
+  return;
+} // end of OBS_setStartup() function
+
+
+void OBS_start(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  OBS_stop(handle);
+
+  obj->state = (obj->handoverSpeed_pu > _IQ(0.0)) ? OBS_State_Forced : OBS_State_Run;
+
+  return;
+} // end of OBS_start() function
+
+
+void OBS_startOnAngle(OBS_Handle handle,const _iq angle_pu,const _iq speed_pu,const MATH_vec2 *pEab)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  OBS_stop(handle);
+
+  obj->state = OBS_State_Run;
+
+  obj->Eab.value[0] = pEab->value[0];
+  obj->Eab.value[1] = pEab->value[1];
+
+  obj->speedTick_pu = _IQmpy(speed_pu,obj->speedScaleInv);
+  obj->speed_pu = speed_pu;
+  obj->angle_pu = OBS_wrapAngle_pu(angle_pu - obj->speedTick_pu);
+
+  return;
+} // end of OBS_startOnAngle() function
+
+
+void OBS_stop(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+  uint_least8_t cnt;
+
+  obj->state = OBS_State_Idle;
+  obj->flag_firstTick = true;
+
+  for(cnt=0;cnt<2;cnt++)
+    {
+      obj->Iab_prev.value[cnt] = _IQ(0.0);
+      obj->Iab_filt.value[cnt] = _IQ(0.0);
+      obj->Vab_prev.value[cnt] = _IQ(0.0);
+      obj->Eab.value[cnt] = _IQ(0.0);
+      obj->Eab_comp.value[cnt] = _IQ(0.0);
+    }
+
+  obj->err = _IQ(0.0);
+  obj->speedTick_pu = _IQ(0.0);
+  obj->speed_pu = _IQ(0.0);
+  obj->angle_pu = _IQ(0.0);
+  obj->speedRef_pu = _IQ(0.0);
+  obj->angleForced_pu = _IQ(0.0);
+  obj->Iq_ref_pu = _IQ(0.0);
+
+  return;
+} // end of OBS_stop() function
+
+// end of file
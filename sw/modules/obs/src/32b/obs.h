@@ -0,0 +1,474 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _OBS_H_
+#define _OBS_H_
+
+//! \file   modules/obs/src/32b/obs.h
+//! \brief  Contains the public interface to the
+//!         back-EMF observer (OBS) module routines
+//!
+//!         An open alternative to the angle and speed of the FAST estimator.
+//!         The back-EMF is the part of the voltage the current model of the
+//!         stator does not explain.  Over one tick of Ts, with the voltage
+//!         held constant, the stator current follows
+//!
+//!           I[k] = F*I[k-1] + G*(V - E),  F = exp(-Rs*Ts/Ls),  G = (1 - F)/Rs
+//!
+//!         so E = V - (I[k] - F*I[k-1])/G is the mean back-EMF of the tick.
+//!         This is a reduced order Luenberger observer of the back-EMF with
+//!         the current state taken from the measurement, a first order low
+//!         pass filter of the coefficient emfFilterCoeff is its observer
+//!         gain.  The voltage feedback of the board has a first order filter,
+//!         the current is run through a matched filter so the model holds for
+//!         the filtered signals.
+//!
+//!         The filtered back-EMF lags the rotor by half a tick, by the low
+//!         pass filter and by the voltage feedback filter.  All three are
+//!         known functions of the speed and are undone with one complex
+//!         multiplication before a type 2 PLL locks to the back-EMF.  The
+//!         error of the PLL is the back-EMF on the estimated direct axis
+//!         over its magnitude, about the sine of the angle error.
+//!
+//!         Below the handover speed the back-EMF is too small for the
+//!         angle.  The module then drives a forced angle at the speed
+//!         reference with a fixed quadrature current, the PLL keeps tracking
+//!         the rotor and takes over once its speed agrees with the
+//!         reference.
+//!
+//!         OBS_getAngle_pu(), OBS_getFm_pu() and OBS_getSpeed_krpm() return
+//!         the same units as the EST functions of the same name.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+#include "sw/modules/math/src/32b/math.h"
+
+
+//!
+//!
+//! \defgroup OBS OBS
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the smallest back-EMF magnitude used for the angle error, pu
+//!
+#define OBS_MIN_EMF_pu              (_IQ(0.0005))
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Enumeration for the observer states
+//!
+typedef enum
+{
+  OBS_State_Idle = 0,       //!< the observer does not run
+  OBS_State_Forced,         //!< the forced angle is used, the PLL tracks the rotor
+  OBS_State_Run,            //!< the angle of the PLL is used
+  OBS_NumStates
+} OBS_State_e;
+
+
+//! \brief Defines the back-EMF observer (OBS) object
+//!
+typedef struct _OBS_Obj_
+{
+  OBS_State_e     state;              //!< the state
+
+  _iq             Fobs;               //!< the current decay over one tick, exp(-Rs*Ts/Ls)
+  _iq             GobsInv;            //!< the inverse of the voltage to current gain over one tick, pu
+  _iq             emfFilterCoeff;     //!< the coefficient of the back-EMF low pass filter, the observer gain
+  _iq             emfCompScale;       //!< the lead of the low pass filter, (2 - emfFilterCoeff)/emfFilterCoeff
+  _iq             currentFilterCoeff; //!< the coefficient of the matched current filter, zero without voltage feedback filter
+  _iq             voltageCompScale;   //!< the angle per tick over the voltage feedback filter pole, 2*pi/(pole_rps*Ts)
+  _iq             Kp;                 //!< the proportional gain of the PLL
+  _iq             Ki;                 //!< the integral gain of the PLL
+  _iq             speedScale;         //!< the observer frequency over the full scale frequency
+  _iq             speedScaleInv;      //!< the full scale frequency over the observer frequency
+  _iq             speedFilterCoeff;   //!< the coefficient of the speed low pass filter
+  _iq             pu_to_krpm_sf;      //!< the scale factor from the frequency in pu to the speed in krpm
+  _iq             Iq_startup_pu;      //!< the quadrature current of the forced angle, pu
+  _iq             handoverSpeed_pu;   //!< the speed above which the PLL angle is used, pu, zero to never force the angle
+  _iq             handbackSpeed_pu;   //!< the speed below which the forced angle is used, pu
+
+  bool            flag_firstTick;     //!< denotes that the previous samples are not valid yet
+  MATH_vec2       Iab_prev;           //!< the current sample of the last tick, pu
+  MATH_vec2       Iab_filt;           //!< the current of the last tick filtered like the voltage, pu
+  MATH_vec2       Vab_prev;           //!< the voltage sample of the last tick, pu
+  MATH_vec2       Eab;                //!< the filtered back-EMF, pu
+  MATH_vec2       Eab_comp;           //!< the back-EMF with the filter lags undone, pu
+  _iq             err;                //!< the angle error signal, about the sine of the angle error
+  _iq             speedTick_pu;       //!< the PLL integrator, angle per tick, pu
+  _iq             speed_pu;           //!< the filtered PLL speed, pu
+  _iq             angle_pu;           //!< the PLL angle, -0.5 to 0.5 pu
+  _iq             speedRef_pu;        //!< the speed reference of this tick, pu
+  _iq             angleForced_pu;     //!< the forced angle, -0.5 to 0.5 pu
+  _iq             Iq_ref_pu;          //!< the quadrature current reference of the forced angle, pu
+} OBS_Obj;
+
+
+//! \brief Defines the OBS handle
+//!
+typedef struct _OBS_Obj_ *OBS_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Gets the angle
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The forced angle below the handover speed, else the PLL angle, -0.5 to 0.5 pu
+static inline _iq OBS_getAngle_pu(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return((obj->state == OBS_State_Run) ? obj->angle_pu : obj->angleForced_pu);
+} // end of OBS_getAngle_pu() function
+
+
+//! \brief     Gets the back-EMF with the filter lags undone
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The pointer to the alpha/beta back-EMF, pu
+static inline const MATH_vec2 *OBS_getEab_addr(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(&(obj->Eab_comp));
+} // end of OBS_getEab_addr() function
+
+
+//! \brief     Gets the angle error signal of the PLL
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The back-EMF on the estimated direct axis over its magnitude
+static inline _iq OBS_getErr(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(obj->err);
+} // end of OBS_getErr() function
+
+
+//! \brief     Gets the electrical frequency
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The speed reference below the handover speed, else the PLL speed, pu
+static inline _iq OBS_getFm_pu(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return((obj->state == OBS_State_Run) ? obj->speed_pu : obj->speedRef_pu);
+} // end of OBS_getFm_pu() function
+
+
+//! \brief     Gets the quadrature current reference of the forced angle
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The current, pu, in the direction of the speed reference
+static inline _iq OBS_getIq_ref_pu(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(obj->Iq_ref_pu);
+} // end of OBS_getIq_ref_pu() function
+
+
+//! \brief     Gets the PLL angle, also while the angle is forced
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The PLL angle, -0.5 to 0.5 pu
+static inline _iq OBS_getPllAngle_pu(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(obj->angle_pu);
+} // end of OBS_getPllAngle_pu() function
+
+
+//! \brief     Gets the mechanical speed
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The speed, krpm
+static inline _iq OBS_getSpeed_krpm(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(_IQmpy(OBS_getFm_pu(handle),obj->pu_to_krpm_sf));
+} // end of OBS_getSpeed_krpm() function
+
+
+//! \brief     Gets the state
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The state
+static inline OBS_State_e OBS_getState(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(obj->state);
+} // end of OBS_getState() function
+
+
+//! \brief     Determines if the angle is the rotor angle
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The flag, false while the angle is forced
+static inline bool OBS_isAngleValid(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(obj->state == OBS_State_Run);
+} // end of OBS_isAngleValid() function
+
+
+//! \brief     Initializes the back-EMF observer (OBS) module
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The back-EMF observer (OBS) handle
+extern OBS_Handle OBS_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Sets the observer parameters
+//! \param[in] handle              The back-EMF observer (OBS) handle
+//! \param[in] Fobs                The current decay over one tick, exp(-Rs*Ts/Ls)
+//! \param[in] GobsInv             The inverse of the voltage to current gain over one tick, Rs/(1 - Fobs) in pu
+//! \param[in] emfFilterCoeff      The coefficient of the back-EMF low pass filter, 0 to 1
+//! \param[in] currentFilterCoeff  The coefficient of the voltage feedback filter, 1 - exp(-pole_rps*Ts), zero without one
+//! \param[in] voltageCompScale    The angle per tick over the voltage feedback filter pole, 2*pi/(pole_rps*Ts), zero without one
+extern void OBS_setParams(OBS_Handle handle,
+                          const _iq Fobs,
+                          const _iq GobsInv,
+                          const _iq emfFilterCoeff,
+                          const _iq currentFilterCoeff,
+                          const _iq voltageCompScale);
+
+
+//! \brief     Sets the PLL parameters
+//! \details   The speed scale is the observer frequency over the full scale
+//!            frequency, it converts the PLL integrator from angle per tick
+//!            to the frequency in pu.
+//! \param[in] handle            The back-EMF observer (OBS) handle
+//! \param[in] Kp                The proportional gain of the PLL
+//! \param[in] Ki                The integral gain of the PLL
+//! \param[in] speedScale        The observer frequency over the full scale frequency
+//! \param[in] speedFilterCoeff  The coefficient of the speed low pass filter
+//! \param[in] pu_to_krpm_sf     The scale factor from the frequency in pu to the speed in krpm
+extern void OBS_setPll(OBS_Handle handle,
+                       const _iq Kp,
+                       const _iq Ki,
+                       const _iq speedScale,
+                       const _iq speedFilterCoeff,
+                       const _iq pu_to_krpm_sf);
+
+
+//! \brief     Sets the forced angle start
+//! \param[in] handle            The back-EMF observer (OBS) handle
+//! \param[in] Iq_startup_pu     The quadrature current of the forced angle, pu
+//! \param[in] handoverSpeed_pu  The speed above which the PLL angle is used, pu, zero to never force the angle
+//! \param[in] handbackSpeed_pu  The speed below which the forced angle is used, pu
+extern void OBS_setStartup(OBS_Handle handle,
+                           const _iq Iq_startup_pu,
+                           const _iq handoverSpeed_pu,
+                           const _iq handbackSpeed_pu);
+
+
+//! \brief     Starts the observer, on the forced angle unless the handover speed is zero
+//! \param[in] handle  The back-EMF observer (OBS) handle
+extern void OBS_start(OBS_Handle handle);
+
+
+//! \brief     Starts the observer on a rotor of known angle and speed, e.g. a caught windmilling rotor
+//! \details   The PLL runs from the angle, the speed and the back-EMF, the
+//!            angle is predicted onto the given angle by the next OBS_run().
+//! \param[in] handle    The back-EMF observer (OBS) handle
+//! \param[in] angle_pu  The rotor angle of the next tick, -0.5 to 0.5 pu
+//! \param[in] speed_pu  The electrical frequency, pu
+//! \param[in] pEab      The pointer to the alpha/beta back-EMF of the voltage feedback, pu
+extern void OBS_startOnAngle(OBS_Handle handle,const _iq angle_pu,const _iq speed_pu,const MATH_vec2 *pEab);
+
+
+//! \brief     Stops the observer
+//! \param[in] handle  The back-EMF observer (OBS) handle
+extern void OBS_stop(OBS_Handle handle);
+
+
+//! \brief     Wraps an angle into -0.5 to 0.5 pu
+//! \param[in] angle_pu  The angle, -1.0 to 1.0 pu
+//! \return    The angle, -0.5 to 0.5 pu
+static inline _iq OBS_wrapAngle_pu(const _iq angle_pu)
+{
+  if(angle_pu > _IQ(0.5))
+    {
+      return(angle_pu - _IQ(1.0));
+    }
+  else if(angle_pu < _IQ(-0.5))
+    {
+      return(angle_pu + _IQ(1.0));
+    }
+
+  return(angle_pu);
+} // end of OBS_wrapAngle_pu() function
+
+
+//! \brief     Runs the back-EMF observer and the PLL
+//! \details   Call with the alpha/beta current and voltage feedback of the
+//!            tick, after the Clarke transforms.
+//! \param[in] handle       The back-EMF observer (OBS) handle
+//! \param[in] pIab         The pointer to the alpha/beta current, pu
+//! \param[in] pVab         The pointer to the alpha/beta voltage, pu
+//! \param[in] speedRef_pu  The speed reference, pu
+static inline void OBS_run(OBS_Handle handle,
+                           const MATH_vec2 *pIab,
+                           const MATH_vec2 *pVab,
+                           const _iq speedRef_pu)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+  uint_least8_t cnt;
+
+  if(obj->state == OBS_State_Idle)
+    {
+      return;
+    }
+
+  obj->speedRef_pu = speedRef_pu;
+
+  for(cnt=0;cnt<2;cnt++)
+    {
+      _iq Iin = pIab->value[cnt];
+      _iq IfiltPrev = obj->Iab_filt.value[cnt];
+      _iq Ifilt = Iin;
+
+      // filter the current like the voltage feedback, trapezoidal
+      if((obj->currentFilterCoeff != _IQ(0.0)) && !obj->flag_firstTick)
+        {
+          Ifilt = IfiltPrev + _IQmpy(obj->currentFilterCoeff,((Iin + obj->Iab_prev.value[cnt]) >> 1) - IfiltPrev);
+        }
+
+      if(!obj->flag_firstTick)
+        {
+          // the back-EMF the current model of the stator does not explain
+          _iq Vmean = (pVab->value[cnt] + obj->Vab_prev.value[cnt]) >> 1;
+          _iq Etick = Vmean - _IQmpy(Ifilt - _IQmpy(obj->Fobs,IfiltPrev),obj->GobsInv);
+
+          obj->Eab.value[cnt] += _IQmpy(obj->emfFilterCoeff,Etick - obj->Eab.value[cnt]);
+        }
+
+      obj->Iab_prev.value[cnt] = Iin;
+      obj->Iab_filt.value[cnt] = Ifilt;
+      obj->Vab_prev.value[cnt] = pVab->value[cnt];
+    }
+
+  obj->flag_firstTick = false;
+
+  // undo the lags, the inverse of the low pass filter with the half tick of
+  // the mean is cos(x/2) + j*(2 - c)/c*sin(x/2) for the angle x per tick,
+  // the inverse of the voltage feedback filter is 1 + j*w/pole
+  {
+    _iq halfTick_pu = obj->speedTick_pu >> 1;
+    _iq cr = _IQcosPU(halfTick_pu);
+    _iq ci = _IQmpy(obj->emfCompScale,_IQsinPU(halfTick_pu));
+    _iq b = _IQmpy(obj->voltageCompScale,obj->speedTick_pu);
+    _iq compRe = cr - _IQmpy(ci,b);
+    _iq compIm = ci + _IQmpy(cr,b);
+    _iq Ealpha = obj->Eab.value[0];
+    _iq Ebeta = obj->Eab.value[1];
+
+    obj->Eab_comp.value[0] = _IQmpy(Ealpha,compRe) - _IQmpy(Ebeta,compIm);
+    obj->Eab_comp.value[1] = _IQmpy(Ealpha,compIm) + _IQmpy(Ebeta,compRe);
+  }
+
+  // run the PLL on the angle predicted for this tick, the back-EMF of a
+  // rotor at angle th is w*flux*(-sin(th),cos(th))
+  {
+    _iq anglePred_pu = OBS_wrapAngle_pu(obj->angle_pu + obj->speedTick_pu);
+    _iq cosTh = _IQcosPU(anglePred_pu);
+    _iq sinTh = _IQsinPU(anglePred_pu);
+    _iq Ed = _IQmpy(obj->Eab_comp.value[0],cosTh) + _IQmpy(obj->Eab_comp.value[1],sinTh);
+    _iq Eq = _IQmpy(obj->Eab_comp.value[1],cosTh) - _IQmpy(obj->Eab_comp.value[0],sinTh);
+    _iq Emag = _IQmag(Ed,Eq);
+    _iq dir = (obj->state == OBS_State_Run) ? obj->speedTick_pu : speedRef_pu;
+    _iq err = _IQ(0.0);
+
+    if(Emag > OBS_MIN_EMF_pu)
+      {
+        err = _IQdiv(Ed,Emag);
+        err = (dir < _IQ(0.0)) ? err : -err;
+      }
+
+    obj->err = err;
+
+    // rounded, the truncation of _IQmpy() would bias the speed
+    obj->speedTick_pu += _IQrmpy(obj->Ki,err);
+    obj->angle_pu = OBS_wrapAngle_pu(anglePred_pu + _IQmpy(obj->Kp,err));
+    obj->speed_pu += _IQmpy(obj->speedFilterCoeff,_IQmpy(obj->speedTick_pu,obj->speedScale) - obj->speed_pu);
+  }
+
+  if(obj->state == OBS_State_Forced)
+    {
+      _iq speedErr_pu = _IQabs(obj->speed_pu - speedRef_pu);
+
+      obj->angleForced_pu = OBS_wrapAngle_pu(obj->angleForced_pu + _IQmpy(speedRef_pu,obj->speedScaleInv));
+      obj->Iq_ref_pu = (speedRef_pu < _IQ(0.0)) ? -obj->Iq_startup_pu : obj->Iq_startup_pu;
+
+      // hand over once the PLL agrees with the reference
+      if((_IQabs(speedRef_pu) >= obj->handoverSpeed_pu) && (speedErr_pu < (_IQabs(speedRef_pu) >> 2)))
+        {
+          obj->state = OBS_State_Run;
+          obj->Iq_ref_pu = _IQ(0.0);
+        }
+    }
+  else if(_IQabs(obj->speed_pu) < obj->handbackSpeed_pu)
+    {
+      // force the angle from where the PLL is
+      obj->state = OBS_State_Forced;
+      obj->angleForced_pu = obj->angle_pu;
+    }
+
+  return;
+} // end of OBS_run() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _OBS_H_ definition
+
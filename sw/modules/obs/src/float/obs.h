@@ -0,0 +1,499 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _OBS_H_
+#define _OBS_H_
+
+//! \file   modules/obs/src/float/obs.h
+//! \brief  Contains the public interface to the
+//!         back-EMF observer (OBS) module routines
+//!
+//!         An open alternative to the angle and speed of the FAST estimator.
+//!         The back-EMF is the part of the voltage the current model of the
+//!         stator does not explain.  Over one tick of Ts, with the voltage
+//!         held constant, the stator current follows
+//!
+//!           I[k] = F*I[k-1] + G*(V - E),  F = exp(-Rs*Ts/Ls),  G = (1 - F)/Rs
+//!
+//!         so E = V - (I[k] - F*I[k-1])/G is the mean back-EMF of the tick.
+//!         This is a reduced order Luenberger observer of the back-EMF with
+//!         the current state taken from the measurement, a first order low
+//!         pass filter of the coefficient emfFilterCoeff is its observer
+//!         gain.  The voltage feedback of the board has a first order filter,
+//!         the current is run through a matched filter so the model holds for
+//!         the filtered signals.
+//!
+//!         The filtered back-EMF lags the rotor by half a tick, by the low
+//!         pass filter and by the voltage feedback filter.  All three are
+//!         known functions of the speed and are undone with one complex
+//!         multiplication before a type 2 PLL locks to the back-EMF.  The
+//!         error of the PLL is the back-EMF on the estimated direct axis
+//!         over its magnitude, about the sine of the angle error.
+//!
+//!         Below the handover speed the back-EMF is too small for the
+//!         angle.  The module then drives a forced angle at the speed
+//!         reference with a fixed quadrature current, the PLL keeps tracking
+//!         the rotor and takes over once its speed agrees with the
+//!         reference.
+//!
+//!         OBS_getAngle_pu(), OBS_getFm_pu() and OBS_getSpeed_krpm() return
+//!         the same units as the EST functions of the same name.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/types/src/types.h"
+#ifdef __TMS320C28XX_CLA__
+#include "sw/modules/math/src/float/CLAmath.h"
+#else
+#include <math.h>
+#endif
+
+// modules
+#include "sw/modules/math/src/float/math.h"
+
+
+//!
+//!
+//! \defgroup OBS OBS
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the smallest back-EMF magnitude used for the angle error, pu
+//!
+#define OBS_MIN_EMF_pu              ((float_t)(0.0005))
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Enumeration for the observer states
+//!
+typedef enum
+{
+  OBS_State_Idle = 0,       //!< the observer does not run
+  OBS_State_Forced,         //!< the forced angle is used, the PLL tracks the rotor
+  OBS_State_Run,            //!< the angle of the PLL is used
+  OBS_NumStates
+} OBS_State_e;
+
+
+//! \brief Defines the back-EMF observer (OBS) object
+//!
+typedef struct _OBS_Obj_
+{
+  OBS_State_e     state;              //!< the state
+
+  float_t         Fobs;               //!< the current decay over one tick, exp(-Rs*Ts/Ls)
+  float_t         GobsInv;            //!< the inverse of the voltage to current gain over one tick, pu
+  float_t         emfFilterCoeff;     //!< the coefficient of the back-EMF low pass filter, the observer gain
+  float_t         emfCompScale;       //!< the lead of the low pass filter, (2 - emfFilterCoeff)/emfFilterCoeff
+  float_t         currentFilterCoeff; //!< the coefficient of the matched current filter, zero without voltage feedback filter
+  float_t         voltageCompScale;   //!< the angle per tick over the voltage feedback filter pole, 2*pi/(pole_rps*Ts)
+  float_t         Kp;                 //!< the proportional gain of the PLL
+  float_t         Ki;                 //!< the integral gain of the PLL
+  float_t         speedScale;         //!< the observer frequency over the full scale frequency
+  float_t         speedScaleInv;      //!< the full scale frequency over the observer frequency
+  float_t         speedFilterCoeff;   //!< the coefficient of the speed low pass filter
+  float_t         pu_to_krpm_sf;      //!< the scale factor from the frequency in pu to the speed in krpm
+  float_t         Iq_startup_pu;      //!< the quadrature current of the forced angle, pu
+  float_t         handoverSpeed_pu;   //!< the speed above which the PLL angle is used, pu, zero to never force the angle
+  float_t         handbackSpeed_pu;   //!< the speed below which the forced angle is used, pu
+
+  bool            flag_firstTick;     //!< denotes that the previous samples are not valid yet
+  MATH_vec2       Iab_prev;           //!< the current sample of the last tick, pu
+  MATH_vec2       Iab_filt;           //!< the current of the last tick filtered like the voltage, pu
+  MATH_vec2       Vab_prev;           //!< the voltage sample of the last tick, pu
+  MATH_vec2       Eab;                //!< the filtered back-EMF, pu
+  MATH_vec2       Eab_comp;           //!< the back-EMF with the filter lags undone, pu
+  float_t         err;                //!< the angle error signal, about the sine of the angle error
+  float_t         speedTick_pu;       //!< the PLL integrator, angle per tick, pu
+  float_t         speed_pu;           //!< the filtered PLL speed, pu
+  float_t         angle_pu;           //!< the PLL angle, -0.5 to 0.5 pu
+  float_t         speedRef_pu;        //!< the speed reference of this tick, pu
+  float_t         angleForced_pu;     //!< the forced angle, -0.5 to 0.5 pu
+  float_t         Iq_ref_pu;          //!< the quadrature current reference of the forced angle, pu
+} OBS_Obj;
+
+
+//! \brief Defines the OBS handle
+//!
+typedef struct _OBS_Obj_ *OBS_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Gets the angle
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The forced angle below the handover speed, else the PLL angle, -0.5 to 0.5 pu
+static inline float_t OBS_getAngle_pu(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return((obj->state == OBS_State_Run) ? obj->angle_pu : obj->angleForced_pu);
+} // end of OBS_getAngle_pu() function
+
+
+//! \brief     Gets the back-EMF with the filter lags undone
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The pointer to the alpha/beta back-EMF, pu
+static inline const MATH_vec2 *OBS_getEab_addr(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(&(obj->Eab_comp));
+} // end of OBS_getEab_addr() function
+
+
+//! \brief     Gets the angle error signal of the PLL
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The back-EMF on the estimated direct axis over its magnitude
+static inline float_t OBS_getErr(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(obj->err);
+} // end of OBS_getErr() function
+
+
+//! \brief     Gets the electrical frequency
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The speed reference below the handover speed, else the PLL speed, pu
+static inline float_t OBS_getFm_pu(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return((obj->state == OBS_State_Run) ? obj->speed_pu : obj->speedRef_pu);
+} // end of OBS_getFm_pu() function
+
+
+//! \brief     Gets the quadrature current reference of the forced angle
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The current, pu, in the direction of the speed reference
+static inline float_t OBS_getIq_ref_pu(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(obj->Iq_ref_pu);
+} // end of OBS_getIq_ref_pu() function
+
+
+//! \brief     Gets the PLL angle, also while the angle is forced
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The PLL angle, -0.5 to 0.5 pu
+static inline float_t OBS_getPllAngle_pu(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(obj->angle_pu);
+} // end of OBS_getPllAngle_pu() function
+
+
+//! \brief     Gets the mechanical speed
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The speed, krpm
+static inline float_t OBS_getSpeed_krpm(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(OBS_getFm_pu(handle) * obj->pu_to_krpm_sf);
+} // end of OBS_getSpeed_krpm() function
+
+
+//! \brief     Gets the state
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The state
+static inline OBS_State_e OBS_getState(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(obj->state);
+} // end of OBS_getState() function
+
+
+//! \brief     Determines if the angle is the rotor angle
+//! \param[in] handle  The back-EMF observer (OBS) handle
+//! \return    The flag, false while the angle is forced
+static inline bool OBS_isAngleValid(OBS_Handle handle)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+
+  return(obj->state == OBS_State_Run);
+} // end of OBS_isAngleValid() function
+
+
+//! \brief     Initializes the back-EMF observer (OBS) module
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The back-EMF observer (OBS) handle
+extern OBS_Handle OBS_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Sets the observer parameters
+//! \param[in] handle              The back-EMF observer (OBS) handle
+//! \param[in] Fobs                The current decay over one tick, exp(-Rs*Ts/Ls)
+//! \param[in] GobsInv             The inverse of the voltage to current gain over one tick, Rs/(1 - Fobs) in pu
+//! \param[in] emfFilterCoeff      The coefficient of the back-EMF low pass filter, 0 to 1
+//! \param[in] currentFilterCoeff  The coefficient of the voltage feedback filter, 1 - exp(-pole_rps*Ts), zero without one
+//! \param[in] voltageCompScale    The angle per tick over the voltage feedback filter pole, 2*pi/(pole_rps*Ts), zero without one
+extern void OBS_setParams(OBS_Handle handle,
+                          const float_t Fobs,
+                          const float_t GobsInv,
+                          const float_t emfFilterCoeff,
+                          const float_t currentFilterCoeff,
+                          const float_t voltageCompScale);
+
+
+//! \brief     Sets the PLL parameters
+//! \details   The speed scale is the observer frequency over the full scale
+//!            frequency, it converts the PLL integrator from angle per tick
+//!            to the frequency in pu.
+//! \param[in] handle            The back-EMF observer (OBS) handle
+//! \param[in] Kp                The proportional gain of the PLL
+//! \param[in] Ki                The integral gain of the PLL
+//! \param[in] speedScale        The observer frequency over the full scale frequency
+//! \param[in] speedFilterCoeff  The coefficient of the speed low pass filter
+//! \param[in] pu_to_krpm_sf     The scale factor from the frequency in pu to the speed in krpm
+extern void OBS_setPll(OBS_Handle handle,
+                       const float_t Kp,
+                       const float_t Ki,
+                       const float_t speedScale,
+                       const float_t speedFilterCoeff,
+                       const float_t pu_to_krpm_sf);
+
+
+//! \brief     Sets the forced angle start
+//! \param[in] handle            The back-EMF observer (OBS) handle
+//! \param[in] Iq_startup_pu     The quadrature current of the forced angle, pu
+//! \param[in] handoverSpeed_pu  The speed above which the PLL angle is used, pu, zero to never force the angle
+//! \param[in] handbackSpeed_pu  The speed below which the forced angle is used, pu
+extern void OBS_setStartup(OBS_Handle handle,
+                           const float_t Iq_startup_pu,
+                           const float_t handoverSpeed_pu,
+                           const float_t handbackSpeed_pu);
+
+
+//! \brief     Starts the observer, on the forced angle unless the handover speed is zero
+//! \param[in] handle  The back-EMF observer (OBS) handle
+extern void OBS_start(OBS_Handle handle);
+
+
+//! \brief     Stops the observer
+//! \param[in] handle  The back-EMF observer (OBS) handle
+extern void OBS_stop(OBS_Handle handle);
+
+
+//! \brief     Wraps an angle into -0.5 to 0.5 pu
+//! \param[in] angle_pu  The angle, -1.0 to 1.0 pu
+//! \return    The angle, -0.5 to 0.5 pu
+static inline float_t OBS_wrapAngle_pu(const float_t angle_pu)
+{
+  if(angle_pu > (float_t)0.5)
+    {
+      return(angle_pu - (float_t)1.0);
+    }
+  else if(angle_pu < (float_t)(-0.5))
+    {
+      return(angle_pu + (float_t)1.0);
+    }
+
+  return(angle_pu);
+} // end of OBS_wrapAngle_pu() function
+
+
+//! \brief     Runs the back-EMF observer and the PLL
+//! \details   Call with the alpha/beta current and voltage feedback of the
+//!            tick, after the Clarke transforms.
+//! \param[in] handle       The back-EMF observer (OBS) handle
+//! \param[in] pIab         The pointer to the alpha/beta current, pu
+//! \param[in] pVab         The pointer to the alpha/beta voltage, pu
+//! \param[in] speedRef_pu  The speed reference, pu
+static inline void OBS_run(OBS_Handle handle,
+                           const MATH_vec2 *pIab,
+                           const MATH_vec2 *pVab,
+                           const float_t speedRef_pu)
+{
+  OBS_Obj *obj = (OBS_Obj *)handle;
+  uint_least8_t cnt;
+
+  if(obj->state == OBS_State_Idle)
+    {
+      return;
+    }
+
+  obj->speedRef_pu = speedRef_pu;
+
+  for(cnt=0;cnt<2;cnt++)
+    {
+      float_t Iin = pIab->value[cnt];
+      float_t IfiltPrev = obj->Iab_filt.value[cnt];
+      float_t Ifilt = Iin;
+
+      // filter the current like the voltage feedback, trapezoidal
+      if((obj->currentFilterCoeff != (float_t)0.0) && !obj->flag_firstTick)
+        {
+          Ifilt = IfiltPrev + obj->currentFilterCoeff * ((float_t)0.5 * (Iin + obj->Iab_prev.value[cnt]) - IfiltPrev);
+        }
+
+      if(!obj->flag_firstTick)
+        {
+          // the back-EMF the current model of the stator does not explain
+          float_t Vmean = (float_t)0.5 * (pVab->value[cnt] + obj->Vab_prev.value[cnt]);
+          float_t Etick = Vmean - (Ifilt - obj->Fobs * IfiltPrev) * obj->GobsInv;
+
+          obj->Eab.value[cnt] += obj->emfFilterCoeff * (Etick - obj->Eab.value[cnt]);
+        }
+
+      obj->Iab_prev.value[cnt] = Iin;
+      obj->Iab_filt.value[cnt] = Ifilt;
+      obj->Vab_prev.value[cnt] = pVab->value[cnt];
+    }
+
+  obj->flag_firstTick = false;
+
+  // undo the lags, the inverse of the low pass filter with the half tick of
+  // the mean is cos(x/2) + j*(2 - c)/c*sin(x/2) for the angle x per tick,
+  // the inverse of the voltage feedback filter is 1 + j*w/pole
+  {
+    float_t halfTick_rad = MATH_PI * obj->speedTick_pu;
+    float_t cr = cosf(halfTick_rad);
+    float_t ci = obj->emfCompScale * sinf(halfTick_rad);
+    float_t b = obj->voltageCompScale * obj->speedTick_pu;
+    float_t compRe = cr - ci * b;
+    float_t compIm = ci + cr * b;
+    float_t Ealpha = obj->Eab.value[0];
+    float_t Ebeta = obj->Eab.value[1];
+
+    obj->Eab_comp.value[0] = Ealpha * compRe - Ebeta * compIm;
+    obj->Eab_comp.value[1] = Ealpha * compIm + Ebeta * compRe;
+  }
+
+  // run the PLL on the angle predicted for this tick, the back-EMF of a
+  // rotor at angle th is w*flux*(-sin(th),cos(th))
+  {
+    float_t anglePred_pu = OBS_wrapAngle_pu(obj->angle_pu + obj->speedTick_pu);
+    float_t cosTh = cosf(MATH_TWO_PI * anglePred_pu);
+    float_t sinTh = sinf(MATH_TWO_PI * anglePred_pu);
+    float_t Ed = obj->Eab_comp.value[0] * cosTh + obj->Eab_comp.value[1] * sinTh;
+    float_t Eq = obj->Eab_comp.value[1] * cosTh - obj->Eab_comp.value[0] * sinTh;
+    float_t Emag = sqrtf(Ed * Ed + Eq * Eq);
+    float_t dir = (obj->state == OBS_State_Run) ? obj->speedTick_pu : speedRef_pu;
+    float_t err = (float_t)0.0;
+
+    if(Emag > OBS_MIN_EMF_pu)
+      {
+        err = Ed / Emag;
+        err = (dir < (float_t)0.0) ? err : -err;
+      }
+
+    obj->err = err;
+    obj->speedTick_pu += obj->Ki * err;
+    obj->angle_pu = OBS_wrapAngle_pu(anglePred_pu + obj->Kp * err);
+    obj->speed_pu += obj->speedFilterCoeff * (obj->speedTick_pu * obj->speedScale - obj->speed_pu);
+  }
+
+  if(obj->state == OBS_State_Forced)
+    {
+      float_t speedErr_pu = MATH_abs(obj->speed_pu - speedRef_pu);
+
+      obj->angleForced_pu = OBS_wrapAngle_pu(obj->angleForced_pu + speedRef_pu * obj->speedScaleInv);
+      obj->Iq_ref_pu = (speedRef_pu < (float_t)0.0) ? -obj->Iq_startup_pu : obj->Iq_startup_pu;
+
+      // hand over once the PLL agrees with the reference
+      if((MATH_abs(speedRef_pu) >= obj->handoverSpeed_pu) && (speedErr_pu < (float_t)0.25 * MATH_abs(speedRef_pu)))
+        {
+          obj->state = OBS_State_Run;
+          obj->Iq_ref_pu = (float_t)0.0;
+        }
+    }
+  else if(MATH_abs(obj->speed_pu) < obj->handbackSpeed_pu)
+    {
+      // force the angle from where the PLL is
+      obj->state = OBS_State_Forced;
+      obj->angleForced_pu = obj->angle_pu;
+    }
+
+  return;
+} // end of OBS_run() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _OBS_H_ definition
+
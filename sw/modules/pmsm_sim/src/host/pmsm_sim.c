@@ -0,0 +1,480 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+//! \file   modules/pmsm_sim/src/host/pmsm_sim.c
+//! \brief  Contains the functions for the PMSM plant model used by the host
+//!         simulator
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <math.h>
+
+#include "sw/modules/pmsm_sim/src/host/pmsm_sim.h"
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the largest internal integration step, sec
+//!
+#define PMSM_SIM_MAX_STEP_sec      (0.5e-6)
+
+//! \brief Defines the phase current below which a freewheeling diode stops conducting, A
+//!
+#define PMSM_SIM_ZERO_CURRENT_A    (1.0e-3)
+
+//! \brief Defines the smallest incremental direct axis inductance of the saturation model, pu of Ls_d_H
+//!
+#define PMSM_SIM_MIN_LS_D_FRACTION (0.2)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the integrated plant states
+//!
+typedef struct _PMSM_SIM_State_
+{
+  double Id_A;          //!< the direct axis current, A
+  double Iq_A;          //!< the quadrature axis current, A
+  double speed_radps;   //!< the mechanical speed, rad/s
+  double angle_rad;     //!< the electrical angle, rad
+  double angleMech_rad; //!< the mechanical angle, rad
+} PMSM_SIM_State;
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Computes the incremental direct axis inductance
+//! \details   The magnet flux and a positive Id add up and saturate the
+//!            direct axis, the incremental inductance drops linearly with
+//!            Id.  This is what lets a drive tell the north pole from the
+//!            south pole of the rotor.
+//! \param[in] obj   The plant object
+//! \param[in] Id_A  The direct axis current, A
+//! \return    The incremental direct axis inductance, H
+static double PMSM_SIM_computeLs_d_H(PMSM_SIM_Obj *obj,const double Id_A)
+{
+  double fraction = 1.0 - obj->params.satCoeff_1pA * Id_A;
+
+  if(fraction < PMSM_SIM_MIN_LS_D_FRACTION)
+    {
+      fraction = PMSM_SIM_MIN_LS_D_FRACTION;
+    }
+
+  return(obj->params.Ls_d_H * fraction);
+} // end of PMSM_SIM_computeLs_d_H() function
+
+
+//! \brief     Computes the direct axis flux linkage less the magnet flux
+//! \details   The integral of the incremental inductance of
+//!            PMSM_SIM_computeLs_d_H() over Id, without the lower limit.
+//! \param[in] obj   The plant object
+//! \param[in] Id_A  The direct axis current, A
+//! \return    The flux linkage, Wb
+static double PMSM_SIM_computeFlux_d_Wb(PMSM_SIM_Obj *obj,const double Id_A)
+{
+  double Ld = obj->params.Ls_d_H;
+
+  return(Ld * Id_A - 0.5 * Ld * obj->params.satCoeff_1pA * Id_A * Id_A);
+} // end of PMSM_SIM_computeFlux_d_Wb() function
+
+
+static double PMSM_SIM_computeLoad_Nm(PMSM_SIM_Obj *obj,const double speed_radps,const double angleMech_rad)
+{
+  double Tl_Nm = obj->params.B_Nmps * speed_radps
+               + obj->params.Kload_Nmps2 * speed_radps * fabs(speed_radps);
+
+  // the cogging and the unbalanced load depend on the position only, they
+  // average to zero over a revolution and also act on a rotor at rest
+  if(obj->params.Tcog_Nm != 0.0)
+    {
+      Tl_Nm += obj->params.Tcog_Nm * sin((double)obj->params.numCogPeriods * angleMech_rad);
+    }
+
+  if(obj->params.Timb_Nm != 0.0)
+    {
+      Tl_Nm += obj->params.Timb_Nm * sin(angleMech_rad);
+    }
+
+  // the constant load only opposes motion, it does not drive the rotor
+  if(speed_radps > 0.0)
+    {
+      Tl_Nm += obj->params.Tload_Nm;
+    }
+  else if(speed_radps < 0.0)
+    {
+      Tl_Nm -= obj->params.Tload_Nm;
+    }
+
+  return(Tl_Nm);
+} // end of PMSM_SIM_computeLoad_Nm() function
+
+
+static double PMSM_SIM_computeTorque_Nm(PMSM_SIM_Obj *obj,const PMSM_SIM_State *pState)
+{
+  double Ld = obj->params.Ls_d_H;
+  double Lq = obj->params.Ls_q_H;
+
+  // the saturation lowers the direct axis flux linkage by 0.5*Ld*satCoeff*Id^2
+  return(1.5 * (double)obj->params.numPolePairs
+         * (obj->params.flux_Wb * pState->Iq_A + (Ld - Lq) * pState->Id_A * pState->Iq_A
+            - 0.5 * Ld * obj->params.satCoeff_1pA * pState->Id_A * pState->Id_A * pState->Iq_A));
+} // end of PMSM_SIM_computeTorque_Nm() function
+
+
+static void PMSM_SIM_computeDerivatives(PMSM_SIM_Obj *obj,const PMSM_SIM_State *pState,
+                                        const double *pVab_V,PMSM_SIM_State *pDeriv)
+{
+  double p = (double)obj->params.numPolePairs;
+  double Rs = obj->params.Rs_Ohm;
+  double Ld = PMSM_SIM_computeLs_d_H(obj,pState->Id_A);
+  double Lq = obj->params.Ls_q_H;
+  double we = p * pState->speed_radps;
+  double cosTh = cos(pState->angle_rad);
+  double sinTh = sin(pState->angle_rad);
+  double Vd =  pVab_V[0] * cosTh + pVab_V[1] * sinTh;
+  double Vq = -pVab_V[0] * sinTh + pVab_V[1] * cosTh;
+  double Te = PMSM_SIM_computeTorque_Nm(obj,pState);
+  double Tl = PMSM_SIM_computeLoad_Nm(obj,pState->speed_radps,pState->angleMech_rad);
+
+  pDeriv->Id_A = (Vd - Rs * pState->Id_A + we * Lq * pState->Iq_A) / Ld;
+  pDeriv->Iq_A = (Vq - Rs * pState->Iq_A - we * (PMSM_SIM_computeFlux_d_Wb(obj,pState->Id_A) + obj->params.flux_Wb)) / Lq;
+  pDeriv->speed_radps = (Te - Tl) / obj->params.J_kgm2;
+  pDeriv->angle_rad = we;
+  pDeriv->angleMech_rad = pState->speed_radps;
+
+  return;
+} // end of PMSM_SIM_computeDerivatives() function
+
+
+static void PMSM_SIM_integrate(PMSM_SIM_Obj *obj,const double *pVab_V,const double delta_sec)
+{
+  PMSM_SIM_State x = {obj->Id_A,obj->Iq_A,obj->speed_radps,obj->angle_rad,obj->angleMech_rad};
+  PMSM_SIM_State k1,k2,k3,k4,xt;
+  double h = delta_sec;
+
+
+  PMSM_SIM_computeDerivatives(obj,&x,pVab_V,&k1);
+
+  xt.Id_A = x.Id_A + 0.5 * h * k1.Id_A;
+  xt.Iq_A = x.Iq_A + 0.5 * h * k1.Iq_A;
+  xt.speed_radps = x.speed_radps + 0.5 * h * k1.speed_radps;
+  xt.angle_rad = x.angle_rad + 0.5 * h * k1.angle_rad;
+  xt.angleMech_rad = x.angleMech_rad + 0.5 * h * k1.angleMech_rad;
+  PMSM_SIM_computeDerivatives(obj,&xt,pVab_V,&k2);
+
+  xt.Id_A = x.Id_A + 0.5 * h * k2.Id_A;
+  xt.Iq_A = x.Iq_A + 0.5 * h * k2.Iq_A;
+  xt.speed_radps = x.speed_radps + 0.5 * h * k2.speed_radps;
+  xt.angle_rad = x.angle_rad + 0.5 * h * k2.angle_rad;
+  xt.angleMech_rad = x.angleMech_rad + 0.5 * h * k2.angleMech_rad;
+  PMSM_SIM_computeDerivatives(obj,&xt,pVab_V,&k3);
+
+  xt.Id_A = x.Id_A + h * k3.Id_A;
+  xt.Iq_A = x.Iq_A + h * k3.Iq_A;
+  xt.speed_radps = x.speed_radps + h * k3.speed_radps;
+  xt.angle_rad = x.angle_rad + h * k3.angle_rad;
+  xt.angleMech_rad = x.angleMech_rad + h * k3.angleMech_rad;
+  PMSM_SIM_computeDerivatives(obj,&xt,pVab_V,&k4);
+
+  obj->Id_A += h / 6.0 * (k1.Id_A + 2.0 * k2.Id_A + 2.0 * k3.Id_A + k4.Id_A);
+  obj->Iq_A += h / 6.0 * (k1.Iq_A + 2.0 * k2.Iq_A + 2.0 * k3.Iq_A + k4.Iq_A);
+  obj->speed_radps += h / 6.0 * (k1.speed_radps + 2.0 * k2.speed_radps + 2.0 * k3.speed_radps + k4.speed_radps);
+  obj->angle_rad += h / 6.0 * (k1.angle_rad + 2.0 * k2.angle_rad + 2.0 * k3.angle_rad + k4.angle_rad);
+  obj->angleMech_rad += h / 6.0 * (k1.angleMech_rad + 2.0 * k2.angleMech_rad + 2.0 * k3.angleMech_rad + k4.angleMech_rad);
+
+  // keep the angles in the range 0 to 2*pi
+  obj->angle_rad = fmod(obj->angle_rad,MATH_TWO_PI);
+  if(obj->angle_rad < 0.0)
+    {
+      obj->angle_rad += MATH_TWO_PI;
+    }
+
+  obj->angleMech_rad = fmod(obj->angleMech_rad,MATH_TWO_PI);
+  if(obj->angleMech_rad < 0.0)
+    {
+      obj->angleMech_rad += MATH_TWO_PI;
+    }
+
+  x.Id_A = obj->Id_A;
+  x.Iq_A = obj->Iq_A;
+  obj->Te_Nm = PMSM_SIM_computeTorque_Nm(obj,&x);
+  obj->Tl_Nm = PMSM_SIM_computeLoad_Nm(obj,obj->speed_radps,obj->angleMech_rad);
+
+  return;
+} // end of PMSM_SIM_integrate() function
+
+
+static void PMSM_SIM_abcToAlphaBeta(const double *pAbc,double *pAlphaBeta)
+{
+  pAlphaBeta[0] = (2.0 * pAbc[0] - pAbc[1] - pAbc[2]) * MATH_ONE_OVER_THREE;
+  pAlphaBeta[1] = (pAbc[1] - pAbc[2]) * MATH_ONE_OVER_SQRT_THREE;
+
+  return;
+} // end of PMSM_SIM_abcToAlphaBeta() function
+
+
+static void PMSM_SIM_alphaBetaToAbc(const double *pAlphaBeta,double *pAbc)
+{
+  pAbc[0] = pAlphaBeta[0];
+  pAbc[1] = -0.5 * pAlphaBeta[0] + 1.5 * MATH_ONE_OVER_SQRT_THREE * pAlphaBeta[1];
+  pAbc[2] = -0.5 * pAlphaBeta[0] - 1.5 * MATH_ONE_OVER_SQRT_THREE * pAlphaBeta[1];
+
+  return;
+} // end of PMSM_SIM_alphaBetaToAbc() function
+
+
+void PMSM_SIM_getIabc_A(PMSM_SIM_Handle handle,double *pIabc_A)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+  double cosTh = cos(obj->angle_rad);
+  double sinTh = sin(obj->angle_rad);
+  double Iab_A[2];
+
+  Iab_A[0] = obj->Id_A * cosTh - obj->Iq_A * sinTh;
+  Iab_A[1] = obj->Id_A * sinTh + obj->Iq_A * cosTh;
+
+  PMSM_SIM_alphaBetaToAbc(Iab_A,pIabc_A);
+
+  return;
+} // end of PMSM_SIM_getIabc_A() function
+
+
+void PMSM_SIM_getEabc_V(PMSM_SIM_Handle handle,double *pEabc_V)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+  double we = (double)obj->params.numPolePairs * obj->speed_radps;
+  double Eab_V[2];
+
+  Eab_V[0] = -we * obj->params.flux_Wb * sin(obj->angle_rad);
+  Eab_V[1] =  we * obj->params.flux_Wb * cos(obj->angle_rad);
+
+  PMSM_SIM_alphaBetaToAbc(Eab_V,pEabc_V);
+
+  return;
+} // end of PMSM_SIM_getEabc_V() function
+
+
+PMSM_SIM_Handle PMSM_SIM_init(void *pMemory,const size_t numBytes)
+{
+  PMSM_SIM_Handle handle;
+  PMSM_SIM_Obj *obj;
+
+
+  if(numBytes < sizeof(PMSM_SIM_Obj))
+    return((PMSM_SIM_Handle)NULL);
+
+
+  // assign the handle
+  handle = (PMSM_SIM_Handle)pMemory;
+
+  // assign the object
+  obj = (PMSM_SIM_Obj *)handle;
+
+  // clear the parameters and the state
+  memset(obj,0,sizeof(PMSM_SIM_Obj));
+
+  return(handle);
+} // end of PMSM_SIM_init() function
+
+
+void PMSM_SIM_run(PMSM_SIM_Handle handle,const double *pVabc_V,const double delta_sec)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+  int_least32_t numSteps = (int_least32_t)ceil(delta_sec / PMSM_SIM_MAX_STEP_sec);
+  int_least32_t cnt;
+  double Vab_V[2];
+
+
+  obj->Vabc_V[0] = pVabc_V[0];
+  obj->Vabc_V[1] = pVabc_V[1];
+  obj->Vabc_V[2] = pVabc_V[2];
+
+  // the Clarke transform rejects the common mode, i.e. the star point voltage
+  PMSM_SIM_abcToAlphaBeta(pVabc_V,Vab_V);
+
+  for(cnt=0;cnt<numSteps;cnt++)
+    {
+      PMSM_SIM_integrate(obj,Vab_V,delta_sec / (double)numSteps);
+    }
+
+  return;
+} // end of PMSM_SIM_run() function
+
+
+void PMSM_SIM_runHighZ(PMSM_SIM_Handle handle,const double Vdc_V,const double delta_sec)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+  int_least32_t numSteps = (int_least32_t)ceil(delta_sec / PMSM_SIM_MAX_STEP_sec);
+  double Vd = obj->params.Vdiode_V;
+  double Vhigh = Vdc_V + Vd;
+  double Vlow = -Vd;
+  int_least32_t cnt;
+
+
+  for(cnt=0;cnt<numSteps;cnt++)
+    {
+      double Iabc_A[3],Eabc_V[3],Vab_V[2];
+      double Vn = 0.0;
+      uint_least8_t numConducting = 0;
+      uint_least8_t phase;
+      bool flag_conducting[3];
+
+      PMSM_SIM_getIabc_A(handle,Iabc_A);
+      PMSM_SIM_getEabc_V(handle,Eabc_V);
+
+      // a phase carrying current is clamped to a rail by its freewheeling diode
+      for(phase=0;phase<3;phase++)
+        {
+          flag_conducting[phase] = (fabs(Iabc_A[phase]) > PMSM_SIM_ZERO_CURRENT_A);
+
+          if(flag_conducting[phase])
+            {
+              obj->Vabc_V[phase] = (Iabc_A[phase] > 0.0) ? Vlow : Vhigh;
+              Vn += obj->Vabc_V[phase] - Eabc_V[phase];
+              numConducting++;
+            }
+        }
+
+      if(numConducting > 0)
+        {
+          Vn /= (double)numConducting;
+        }
+      else
+        {
+          double Emax = fmax(Eabc_V[0],fmax(Eabc_V[1],Eabc_V[2]));
+          double Emin = fmin(Eabc_V[0],fmin(Eabc_V[1],Eabc_V[2]));
+
+          if((Emax - Emin) <= (Vhigh - Vlow))
+            {
+              // the back-EMF stays within the rails, the stator is open circuit
+              Vn = fmin(fmax(0.0,Vlow - Emin),Vhigh - Emax);
+
+              for(phase=0;phase<3;phase++)
+                {
+                  obj->Vabc_V[phase] = Eabc_V[phase] + Vn;
+                }
+
+              obj->Id_A = 0.0;
+              obj->Iq_A = 0.0;
+
+              PMSM_SIM_abcToAlphaBeta(obj->Vabc_V,Vab_V);
+              PMSM_SIM_integrate(obj,Vab_V,delta_sec / (double)numSteps);
+
+              obj->Id_A = 0.0;
+              obj->Iq_A = 0.0;
+              continue;
+            }
+
+          // the line to line back-EMF exceeds the DC bus, the diodes rectify
+          Vn = 0.5 * (Vhigh + Vlow - Emax - Emin);
+        }
+
+      // the phases without current follow their back-EMF within the rails
+      for(phase=0;phase<3;phase++)
+        {
+          if(!flag_conducting[phase])
+            {
+              obj->Vabc_V[phase] = fmin(fmax(Eabc_V[phase] + Vn,Vlow),Vhigh);
+            }
+        }
+
+      PMSM_SIM_abcToAlphaBeta(obj->Vabc_V,Vab_V);
+      PMSM_SIM_integrate(obj,Vab_V,delta_sec / (double)numSteps);
+
+      // the diodes block the reverse current
+      PMSM_SIM_getIabc_A(handle,Iabc_A);
+      if((fabs(Iabc_A[0]) < PMSM_SIM_ZERO_CURRENT_A) &&
+         (fabs(Iabc_A[1]) < PMSM_SIM_ZERO_CURRENT_A) &&
+         (fabs(Iabc_A[2]) < PMSM_SIM_ZERO_CURRENT_A))
+        {
+          obj->Id_A = 0.0;
+          obj->Iq_A = 0.0;
+        }
+    }
+
+  return;
+} // end of PMSM_SIM_runHighZ() function
+
+
+void PMSM_SIM_setLoad_Nm(PMSM_SIM_Handle handle,const double Tload_Nm)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+
+  obj->params.Tload_Nm = Tload_Nm;
+
+  return;
+} // end of PMSM_SIM_setLoad_Nm() function
+
+
+void PMSM_SIM_setParams(PMSM_SIM_Handle handle,const PMSM_SIM_Params *pParams)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+
+  obj->params = *pParams;
+
+  obj->Id_A = 0.0;
+  obj->Iq_A = 0.0;
+  obj->speed_radps = 0.0;
+  obj->angle_rad = 0.0;
+  obj->angleMech_rad = 0.0;
+  obj->Te_Nm = 0.0;
+  obj->Tl_Nm = 0.0;
+
+  return;
+} // end of PMSM_SIM_setParams() function
+
+
+void PMSM_SIM_setState(PMSM_SIM_Handle handle,const double speed_radps,const double angle_rad)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+
+  obj->speed_radps = speed_radps;
+  obj->angle_rad = fmod(angle_rad,MATH_TWO_PI);
+
+  if(obj->angle_rad < 0.0)
+    {
+      obj->angle_rad += MATH_TWO_PI;
+    }
+
+  obj->angleMech_rad = obj->angle_rad / (double)obj->params.numPolePairs;
+
+  return;
+} // end of PMSM_SIM_setState() function
+
+// end of file
@@ -0,0 +1,320 @@
+#ifndef _PMSM_SIM_H_
+#define _PMSM_SIM_H_
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+//! \file   modules/pmsm_sim/src/host/pmsm_sim.h
+//! \brief  Contains the public interface to the permanent magnet synchronous
+//!         motor (PMSM) plant model used by the host simulator
+//!
+//!         The model is a lumped dq-frame PMSM with a rigid mechanical load.
+//!         It is driven by the three inverter leg voltages, measured from the
+//!         negative DC rail, so the common mode voltage is rejected the same
+//!         way the floating star point of the real motor rejects it.  All
+//!         quantities are in SI units and double precision, the model never
+//!         runs on the target.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/math/src/32b/math.h"
+#include "sw/modules/types/src/types.h"
+
+
+//!
+//!
+//! \defgroup PMSM_SIM PMSM_SIM
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the PMSM plant parameters
+//!
+typedef struct _PMSM_SIM_Params_
+{
+  uint_least8_t numPolePairs;   //!< the number of pole pairs
+
+  double        Rs_Ohm;         //!< the stator resistance, Ohm
+
+  double        Ls_d_H;         //!< the direct axis stator inductance, H
+
+  double        Ls_q_H;         //!< the quadrature axis stator inductance, H
+
+  double        satCoeff_1pA;   //!< the direct axis saturation, the incremental Ls_d_H drops by this fraction per A of Id, 1/A
+
+  double        flux_Wb;        //!< the permanent magnet flux linkage, Wb
+
+  double        J_kgm2;         //!< the rotor and load inertia, kg*m^2
+
+  double        B_Nmps;         //!< the viscous friction, N*m/(rad/s)
+
+  double        Kload_Nmps2;    //!< the quadratic (propeller) load coefficient, N*m/(rad/s)^2
+
+  double        Tload_Nm;       //!< the constant load torque, N*m, opposes the rotation
+
+  double        Vdiode_V;       //!< the forward voltage of the inverter freewheeling diodes, V
+
+  double        Tcog_Nm;        //!< the amplitude of the cogging torque, N*m
+
+  uint_least16_t numCogPeriods; //!< the number of cogging torque periods per mechanical revolution, the LCM of the slots and the poles
+
+  double        Timb_Nm;        //!< the amplitude of the once per revolution torque of an unbalanced load, N*m
+
+} PMSM_SIM_Params;
+
+
+//! \brief Defines the PMSM plant object
+//!
+typedef struct _PMSM_SIM_Obj_
+{
+  PMSM_SIM_Params params;       //!< the plant parameters
+
+  double          Id_A;         //!< the direct axis current, A
+
+  double          Iq_A;         //!< the quadrature axis current, A
+
+  double          speed_radps;  //!< the mechanical speed, rad/s
+
+  double          angle_rad;    //!< the electrical angle, rad, 0 to 2*pi
+
+  double          angleMech_rad; //!< the mechanical angle, rad, 0 to 2*pi
+
+  double          Te_Nm;        //!< the electromagnetic torque, N*m
+
+  double          Tl_Nm;        //!< the load torque, N*m
+
+  double          Vabc_V[3];    //!< the last applied terminal voltages, referenced to the negative DC rail, V
+
+} PMSM_SIM_Obj;
+
+
+//! \brief Defines the PMSM plant handle
+//!
+typedef struct _PMSM_SIM_Obj_ *PMSM_SIM_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Gets the electrical angle
+//! \param[in] handle  The plant handle
+//! \return    The electrical angle, rad, 0 to 2*pi
+static inline double PMSM_SIM_getAngle_rad(PMSM_SIM_Handle handle)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+
+  return(obj->angle_rad);
+} // end of PMSM_SIM_getAngle_rad() function
+
+
+//! \brief     Gets the mechanical angle
+//! \details   Zero at the electrical angle zero set by PMSM_SIM_setParams()
+//!            or PMSM_SIM_setState(), the cogging and the unbalanced load
+//!            torques are functions of this angle
+//! \param[in] handle  The plant handle
+//! \return    The mechanical angle, rad, 0 to 2*pi
+static inline double PMSM_SIM_getAngleMech_rad(PMSM_SIM_Handle handle)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+
+  return(obj->angleMech_rad);
+} // end of PMSM_SIM_getAngleMech_rad() function
+
+
+//! \brief     Gets the electrical frequency
+//! \param[in] handle  The plant handle
+//! \return    The electrical frequency, Hz
+static inline double PMSM_SIM_getFe_Hz(PMSM_SIM_Handle handle)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+
+  return(obj->speed_radps * (double)obj->params.numPolePairs / MATH_TWO_PI);
+} // end of PMSM_SIM_getFe_Hz() function
+
+
+//! \brief     Gets the direct and quadrature axis currents
+//! \param[in] handle  The plant handle
+//! \param[in] pIdq_A  The pointer to the Id, Iq values, A
+static inline void PMSM_SIM_getIdq_A(PMSM_SIM_Handle handle,double *pIdq_A)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+
+  pIdq_A[0] = obj->Id_A;
+  pIdq_A[1] = obj->Iq_A;
+
+  return;
+} // end of PMSM_SIM_getIdq_A() function
+
+
+//! \brief     Gets the mechanical speed
+//! \param[in] handle  The plant handle
+//! \return    The mechanical speed, rad/s
+static inline double PMSM_SIM_getSpeed_radps(PMSM_SIM_Handle handle)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+
+  return(obj->speed_radps);
+} // end of PMSM_SIM_getSpeed_radps() function
+
+
+//! \brief     Gets the mechanical speed
+//! \param[in] handle  The plant handle
+//! \return    The mechanical speed, krpm
+static inline double PMSM_SIM_getSpeed_krpm(PMSM_SIM_Handle handle)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+
+  return(obj->speed_radps * 60.0 / MATH_TWO_PI / 1000.0);
+} // end of PMSM_SIM_getSpeed_krpm() function
+
+
+//! \brief     Gets the electromagnetic torque
+//! \param[in] handle  The plant handle
+//! \return    The electromagnetic torque, N*m
+static inline double PMSM_SIM_getTorque_Nm(PMSM_SIM_Handle handle)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+
+  return(obj->Te_Nm);
+} // end of PMSM_SIM_getTorque_Nm() function
+
+
+//! \brief     Gets the load torque
+//! \param[in] handle  The plant handle
+//! \return    The load torque including the cogging and the unbalanced load, N*m
+static inline double PMSM_SIM_getLoad_Nm(PMSM_SIM_Handle handle)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+
+  return(obj->Tl_Nm);
+} // end of PMSM_SIM_getLoad_Nm() function
+
+
+//! \brief     Gets the phase currents
+//! \param[in] handle  The plant handle
+//! \param[in] pIabc_A  The pointer to the phase A, B and C currents, A
+extern void PMSM_SIM_getIabc_A(PMSM_SIM_Handle handle,double *pIabc_A);
+
+
+//! \brief     Gets the phase back-EMF voltages, referenced to the star point
+//! \param[in] handle   The plant handle
+//! \param[in] pEabc_V  The pointer to the phase A, B and C back-EMF voltages, V
+extern void PMSM_SIM_getEabc_V(PMSM_SIM_Handle handle,double *pEabc_V);
+
+
+//! \brief     Gets the terminal voltages applied over the last step
+//! \details   With the bridge in high impedance these are the voltages set
+//!            up by the back-EMF and the conducting diodes
+//! \param[in] handle   The plant handle
+//! \param[in] pVabc_V  The pointer to the phase A, B and C terminal voltages, referenced to the negative DC rail, V
+static inline void PMSM_SIM_getVabc_V(PMSM_SIM_Handle handle,double *pVabc_V)
+{
+  PMSM_SIM_Obj *obj = (PMSM_SIM_Obj *)handle;
+
+  pVabc_V[0] = obj->Vabc_V[0];
+  pVabc_V[1] = obj->Vabc_V[1];
+  pVabc_V[2] = obj->Vabc_V[2];
+
+  return;
+} // end of PMSM_SIM_getVabc_V() function
+
+
+//! \brief     Initializes the plant
+//! \param[in] pMemory   A pointer to the memory for the plant object
+//! \param[in] numBytes  The number of bytes allocated for the plant object, bytes
+//! \return    The plant handle
+extern PMSM_SIM_Handle PMSM_SIM_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Advances the plant with the inverter bridge driving the motor
+//! \details   The leg voltages are held constant over the step, which is
+//!            integrated with a fourth order Runge-Kutta method.  The caller
+//!            splits the PWM period at the switching instants.
+//! \param[in] handle     The plant handle
+//! \param[in] pVabc_V    The pointer to the leg voltages, referenced to the negative DC rail, V
+//! \param[in] delta_sec  The integration step, sec
+extern void PMSM_SIM_run(PMSM_SIM_Handle handle,const double *pVabc_V,const double delta_sec);
+
+
+//! \brief     Advances the plant with the inverter bridge in high impedance
+//! \details   Any remaining phase current freewheels through the diodes into
+//!            the DC bus until it reaches zero, after which the stator
+//!            carries no current and only the mechanical part is integrated
+//! \param[in] handle     The plant handle
+//! \param[in] Vdc_V      The DC bus voltage, V
+//! \param[in] delta_sec  The integration step, sec
+extern void PMSM_SIM_runHighZ(PMSM_SIM_Handle handle,const double Vdc_V,const double delta_sec);
+
+
+//! \brief     Sets the constant load torque
+//! \param[in] handle    The plant handle
+//! \param[in] Tload_Nm  The load torque, N*m
+extern void PMSM_SIM_setLoad_Nm(PMSM_SIM_Handle handle,const double Tload_Nm);
+
+
+//! \brief     Sets the plant parameters and resets the state
+//! \param[in] handle   The plant handle
+//! \param[in] pParams  The pointer to the parameters
+extern void PMSM_SIM_setParams(PMSM_SIM_Handle handle,const PMSM_SIM_Params *pParams);
+
+
+//! \brief     Sets the mechanical state, e.g. to start from a windmilling rotor
+//! \details   The mechanical angle is set to the electrical angle over the
+//!            number of pole pairs
+//! \param[in] handle       The plant handle
+//! \param[in] speed_radps  The mechanical speed, rad/s
+//! \param[in] angle_rad    The electrical angle, rad
+extern void PMSM_SIM_setState(PMSM_SIM_Handle handle,const double speed_radps,const double angle_rad);
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+#endif // end of _PMSM_SIM_H_ definition
+
@@ -0,0 +1,441 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/queue/src/host/queue_stress.c
+//! \brief  Checks the event queue (QUEUE) under preemption
+//!
+//!         A periodic timer signal is the posting interrupt, the main loop is
+//!         the background loop and executes the events.  Every signal posts
+//!         a burst of ordered events, which must arrive in order, and one
+//!         throttle event with a key, which replaces the pending throttle
+//!         event.  A second timer signal at another period is the nested
+//!         interrupt, as ecapISR in mainISR, it preempts the first one and
+//!         posts its own ordered events and keyed event.  Every Nth pass the
+//!         main loop stalls, so the queue fills up and drops.  Every posted
+//!         ordered event is either executed or counted as dropped, and the
+//!         last keyed values must arrive.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sw/modules/queue/src/queue.h"
+
+
+// **************************************************************************
+// the defines
+
+#define QUEUE_STRESS_DEFAULT_DURATION_sec  (1.0)
+#define QUEUE_STRESS_TIMER_PERIOD_usec     (20)
+#define QUEUE_STRESS_NESTED_PERIOD_usec    (53)
+#define QUEUE_STRESS_BURST                 (3)         // ordered events per signal
+#define QUEUE_STRESS_STALL_PERIOD          (4096)      // executed events between stalls
+#define QUEUE_STRESS_STALL_LOOPS           (200000)
+#define QUEUE_STRESS_KEY_THROTTLE          (1)
+#define QUEUE_STRESS_KEY_NESTED            (2)
+#define QUEUE_STRESS_MIN_EVENTS            (1000)
+
+
+// **************************************************************************
+// the globals
+
+static QUEUE_Obj queue;
+
+static QUEUE_Handle queueHandle;
+
+static volatile sig_atomic_t gFlag_stop = 0;
+
+// the posting side
+static uintptr_t gSeqPosted = 0;
+
+static uint32_t gNumOrderedDropped = 0;
+
+static uintptr_t gThrottlePosted = 0;
+
+static uintptr_t gThrottleLastOk = 0;
+
+static volatile sig_atomic_t gFlag_inIsr = 0;
+
+// the nested posting side
+static uintptr_t gNestedSeqPosted = 0;
+
+static uint32_t gNumNestedOrderedDropped = 0;
+
+static uintptr_t gNestedPosted = 0;
+
+static uintptr_t gNestedLastOk = 0;
+
+static uint32_t gNumNestedIsrs = 0;
+
+// the executing side
+static uintptr_t gSeqExpected = 1;
+
+static uint32_t gNumOrdered = 0;
+
+static uint32_t gNumOrderErrors = 0;
+
+static uint32_t gNumThrottle = 0;
+
+static uint32_t gNumThrottleErrors = 0;
+
+static uintptr_t gThrottleLast = 0;
+
+static uintptr_t gNestedSeqExpected = 1;
+
+static uint32_t gNumNestedOrdered = 0;
+
+static uint32_t gNumNestedOrderErrors = 0;
+
+static uint32_t gNumNestedErrors = 0;
+
+static uintptr_t gNestedLast = 0;
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     The ordered event, the sequence numbers skip the dropped events only
+//! \param[in] pSeq  The sequence number
+static void QUEUE_STRESS_ordered(void *pSeq)
+{
+  uintptr_t seq = (uintptr_t)pSeq;
+
+  if(seq < gSeqExpected)
+    {
+      gNumOrderErrors++;
+    }
+
+  gSeqExpected = seq + 1;
+  gNumOrdered++;
+
+  return;
+} // end of QUEUE_STRESS_ordered() function
+
+
+//! \brief     The throttle event, the value and its complement must match and never go back
+//! \param[in] pValue  The throttle value
+//! \param[in] pCheck  The complement of the throttle value
+static void QUEUE_STRESS_throttle(void *pValue,void *pCheck)
+{
+  uintptr_t value = (uintptr_t)pValue;
+
+  if(((uintptr_t)pCheck != ~value) || (value <= gThrottleLast))
+    {
+      gNumThrottleErrors++;
+    }
+
+  gThrottleLast = value;
+  gNumThrottle++;
+
+  return;
+} // end of QUEUE_STRESS_throttle() function
+
+
+//! \brief     The ordered event of the nested interrupt
+//! \param[in] pSeq  The sequence number
+static void QUEUE_STRESS_nestedOrdered(void *pSeq)
+{
+  uintptr_t seq = (uintptr_t)pSeq;
+
+  if(seq < gNestedSeqExpected)
+    {
+      gNumNestedOrderErrors++;
+    }
+
+  gNestedSeqExpected = seq + 1;
+  gNumNestedOrdered++;
+
+  return;
+} // end of QUEUE_STRESS_nestedOrdered() function
+
+
+//! \brief     The keyed event of the nested interrupt, checked as the throttle event
+//! \param[in] pValue  The value
+//! \param[in] pCheck  The complement of the value
+static void QUEUE_STRESS_nested(void *pValue,void *pCheck)
+{
+  uintptr_t value = (uintptr_t)pValue;
+
+  if(((uintptr_t)pCheck != ~value) || (value <= gNestedLast))
+    {
+      gNumNestedErrors++;
+    }
+
+  gNestedLast = value;
+
+  return;
+} // end of QUEUE_STRESS_nested() function
+
+
+//! \brief     The nested posting interrupt, it preempts QUEUE_STRESS_isr()
+//! \param[in] sig  The signal number
+static void QUEUE_STRESS_nestedIsr(int sig)
+{
+  EVENT_ArgList argList;
+
+  (void)sig;
+
+  if(gFlag_inIsr)
+    {
+      gNumNestedIsrs++;
+    }
+
+  memset(&argList,0,sizeof(argList));
+
+  argList.arg[0] = (void *)++gNestedSeqPosted;
+
+  if(QUEUE_postEvent(queueHandle,QUEUE_KEY_NONE,(EVENT_Fxn)QUEUE_STRESS_nestedOrdered,&argList,1) != OK)
+    {
+      gNumNestedOrderedDropped++;
+    }
+
+  gNestedPosted++;
+  argList.arg[0] = (void *)gNestedPosted;
+  argList.arg[1] = (void *)~gNestedPosted;
+
+  if(QUEUE_postEvent(queueHandle,QUEUE_STRESS_KEY_NESTED,(EVENT_Fxn)QUEUE_STRESS_nested,&argList,2) == OK)
+    {
+      gNestedLastOk = gNestedPosted;
+    }
+
+  return;
+} // end of QUEUE_STRESS_nestedIsr() function
+
+
+//! \brief     The posting interrupt
+//! \param[in] sig  The signal number
+static void QUEUE_STRESS_isr(int sig)
+{
+  EVENT_ArgList argList;
+  uint_least16_t cnt;
+
+  (void)sig;
+
+  gFlag_inIsr = 1;
+
+  memset(&argList,0,sizeof(argList));
+
+  for(cnt=0;cnt<QUEUE_STRESS_BURST;cnt++)
+    {
+      argList.arg[0] = (void *)++gSeqPosted;
+
+      if(QUEUE_postEvent(queueHandle,QUEUE_KEY_NONE,(EVENT_Fxn)QUEUE_STRESS_ordered,&argList,1) != OK)
+        {
+          gNumOrderedDropped++;
+        }
+    }
+
+  gThrottlePosted++;
+  argList.arg[0] = (void *)gThrottlePosted;
+  argList.arg[1] = (void *)~gThrottlePosted;
+
+  if(QUEUE_postEvent(queueHandle,QUEUE_STRESS_KEY_THROTTLE,(EVENT_Fxn)QUEUE_STRESS_throttle,&argList,2) == OK)
+    {
+      gThrottleLastOk = gThrottlePosted;
+    }
+
+  gFlag_inIsr = 0;
+
+  return;
+} // end of QUEUE_STRESS_isr() function
+
+
+//! \brief     Stops the run
+//! \param[in] sig  The signal number
+static void QUEUE_STRESS_stop(int sig)
+{
+  (void)sig;
+
+  gFlag_stop = 1;
+
+  return;
+} // end of QUEUE_STRESS_stop() function
+
+
+static void QUEUE_STRESS_usage(const char *pName)
+{
+  fprintf(stderr,
+          "usage: %s [-t sec] [-c]\n"
+          "  -t sec  run time, default %.1f s\n"
+          "  -c      check, fail on a lost, reordered or torn event\n",
+          pName,QUEUE_STRESS_DEFAULT_DURATION_sec);
+
+  return;
+} // end of QUEUE_STRESS_usage() function
+
+
+int main(int argc,char *argv[])
+{
+  double duration_sec = QUEUE_STRESS_DEFAULT_DURATION_sec;
+  bool flag_check = false;
+  bool flag_pass;
+  struct sigaction action;
+  struct itimerval timer;
+  struct sigevent event;
+  struct itimerspec nestedTimer;
+  timer_t nestedTimerId;
+  uint32_t numExecuted = 0;
+  int opt;
+
+
+  while((opt = getopt(argc,argv,"t:ch")) != -1)
+    {
+      switch(opt)
+        {
+          case 't':
+            duration_sec = atof(optarg);
+            break;
+          case 'c':
+            flag_check = true;
+            break;
+          default:
+            QUEUE_STRESS_usage(argv[0]);
+            return(opt == 'h' ? 0 : 1);
+        }
+    }
+
+  queueHandle = QUEUE_init(&queue,sizeof(queue));
+
+  // the posting side preempts the main loop at a fixed rate, the end of the
+  // run is a second signal on the process time, most of which the signals
+  // spend in the kernel
+  memset(&action,0,sizeof(action));
+  sigemptyset(&action.sa_mask);
+  action.sa_handler = QUEUE_STRESS_isr;
+  sigaction(SIGALRM,&action,NULL);
+
+  // the nested interrupt has the higher priority, the first one does not
+  // preempt it
+  sigaddset(&action.sa_mask,SIGALRM);
+  action.sa_handler = QUEUE_STRESS_nestedIsr;
+  sigaction(SIGUSR1,&action,NULL);
+
+  sigemptyset(&action.sa_mask);
+  action.sa_handler = QUEUE_STRESS_stop;
+  sigaction(SIGPROF,&action,NULL);
+
+  memset(&event,0,sizeof(event));
+  event.sigev_notify = SIGEV_SIGNAL;
+  event.sigev_signo = SIGUSR1;
+  timer_create(CLOCK_MONOTONIC,&event,&nestedTimerId);
+
+  memset(&nestedTimer,0,sizeof(nestedTimer));
+  nestedTimer.it_interval.tv_nsec = QUEUE_STRESS_NESTED_PERIOD_usec * 1000;
+  nestedTimer.it_value.tv_nsec = QUEUE_STRESS_NESTED_PERIOD_usec * 1000;
+  timer_settime(nestedTimerId,0,&nestedTimer,NULL);
+
+  memset(&timer,0,sizeof(timer));
+  timer.it_interval.tv_usec = QUEUE_STRESS_TIMER_PERIOD_usec;
+  timer.it_value.tv_usec = QUEUE_STRESS_TIMER_PERIOD_usec;
+  setitimer(ITIMER_REAL,&timer,NULL);
+
+  memset(&timer,0,sizeof(timer));
+  timer.it_value.tv_sec = (time_t)duration_sec;
+  timer.it_value.tv_usec = (suseconds_t)((duration_sec - (double)timer.it_value.tv_sec) * 1.0e6);
+  setitimer(ITIMER_PROF,&timer,NULL);
+
+  // the background loop
+  while(!gFlag_stop)
+    {
+      if(QUEUE_executeEvent(queueHandle))
+        {
+          numExecuted++;
+
+          if((numExecuted % QUEUE_STRESS_STALL_PERIOD) == 0)
+            {
+              volatile uint32_t cnt;
+
+              for(cnt=0;cnt<QUEUE_STRESS_STALL_LOOPS;cnt++)
+                {
+                }
+            }
+        }
+    }
+
+  memset(&timer,0,sizeof(timer));
+  setitimer(ITIMER_REAL,&timer,NULL);
+  timer_delete(nestedTimerId);
+
+  // drain
+  while(QUEUE_executeEvent(queueHandle))
+    {
+    }
+
+  printf("ordered events          %lu posted, %lu executed, %lu dropped, %lu out of order\n",
+         (unsigned long)gSeqPosted,(unsigned long)gNumOrdered,
+         (unsigned long)gNumOrderedDropped,(unsigned long)gNumOrderErrors);
+  printf("throttle events         %lu posted, %lu executed, %lu torn or older, last %lu of %lu\n",
+         (unsigned long)gThrottlePosted,(unsigned long)gNumThrottle,(unsigned long)gNumThrottleErrors,
+         (unsigned long)gThrottleLast,(unsigned long)gThrottleLastOk);
+  printf("nested events           %lu posted, %lu executed, %lu dropped, %lu out of order, %lu torn or older, %lu nested\n",
+         (unsigned long)gNestedSeqPosted,(unsigned long)gNumNestedOrdered,
+         (unsigned long)gNumNestedOrderedDropped,(unsigned long)gNumNestedOrderErrors,
+         (unsigned long)gNumNestedErrors,(unsigned long)gNumNestedIsrs);
+  printf("queue                   %lu posts, %lu replaced, %lu dropped, high water mark %u of %u\n",
+         (unsigned long)QUEUE_getNumPosts(queueHandle),
+         (unsigned long)QUEUE_getNumReplaced(queueHandle),
+         (unsigned long)QUEUE_getNumDropped(queueHandle),
+         (unsigned int)QUEUE_getHighWaterMark(queueHandle),(unsigned int)QUEUE_MAX_NUM_EVENTS);
+
+  if(flag_check)
+    {
+      flag_pass = (gNumOrderErrors == 0) &&
+                  (gNumThrottleErrors == 0) &&
+                  (gNumOrdered + gNumOrderedDropped == gSeqPosted) &&
+                  (gThrottleLast == gThrottleLastOk) &&
+                  (gNumNestedOrderErrors == 0) &&
+                  (gNumNestedErrors == 0) &&
+                  (gNumNestedOrdered + gNumNestedOrderedDropped == gNestedSeqPosted) &&
+                  (gNestedLast == gNestedLastOk) &&
+                  (gNumNestedIsrs > 0) &&
+                  (gNumOrdered >= QUEUE_STRESS_MIN_EVENTS);
+
+      printf("%s\n",flag_pass ? "PASS" : "FAIL");
+
+      return(flag_pass ? 0 : 1);
+    }
+
+  return(0);
+} // end of main() function
+
+// end of file
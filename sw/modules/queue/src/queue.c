@@ -46,14 +46,6 @@
 #include "string.h"
 
 
-// **************************************************************************
-// the globals
-
-uint32_t   gEventIndex;
-
-EVENT_Obj  gEvents[QUEUE_MAX_NUM_EVENTS];
-
-
 // **************************************************************************
 // the functions
 
@@ -75,14 +67,16 @@ QUEUE_Handle QUEUE_init(void *pMemory,const size_t numBytes)
   obj = (QUEUE_Obj *)handle;
 
 
-  // configure the queue
-  obj->firstEvent = (EVENT_Handle)pMemory;
-  obj->lastEvent = (EVENT_Handle)pMemory;
+  // zero out the events
+  (void)memset(&obj->events[0],0,sizeof(obj->events));
+  (void)memset((void *)&obj->pendingIdx[0],0,sizeof(obj->pendingIdx));
 
 
-  // zero out the events
-  gEventIndex = 0;
-  (void)memset(&gEvents[0],0,sizeof(gEvents));
+  // configure the queue
+  obj->head = 0;
+  obj->tail = 0;
+
+  QUEUE_resetStats(handle);
 
   return(handle);
 } // end of QUEUE_init() function
@@ -115,4 +109,18 @@ void QUEUE_listen(QUEUE_Handle handle)
 } // end of QUEUE_listen() function
 
 
+void QUEUE_resetStats(QUEUE_Handle handle)
+{
+  QUEUE_Obj *obj = (QUEUE_Obj *)handle;
+
+
+  obj->numPosts = 0;
+  obj->numReplaced = 0;
+  obj->numDropped = 0;
+  obj->highWaterMark = 0;
+
+  return;
+} // end of QUEUE_resetStats() function
+
+
 // end of file
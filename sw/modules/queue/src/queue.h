@@ -36,6 +36,28 @@
 //! \brief  Contains the public interface to the 
 //!         event queue (QUEUE) module routines
 //!
+//!         The queue is a ring of QUEUE_MAX_NUM_EVENTS events.  The
+//!         interrupts post the events and the background loop executes them,
+//!         so work that does not need the ISR is moved out of it.  Posting
+//!         and executing take a constant time.
+//!
+//!         Any interrupt may post, also one that preempts another post, as
+//!         ecapISR preempts mainISR once HAL_enableIsrNesting() lets it.  A
+//!         post masks the interrupts while it claims the place or the key,
+//!         fills in the event and moves the head index, a few tens of
+//!         cycles.  The executing side owns the tail index and runs in the
+//!         background loop only, it never masks the interrupts.
+//!
+//!         An event posted with a key other than QUEUE_KEY_NONE replaces
+//!         the arguments of a pending event of the same key instead of
+//!         taking another place, so a throttle update posted on every frame
+//!         occupies one place until the background loop runs.  The executing
+//!         side clears the key before it reads the event, a later post then
+//!         takes a new place.
+//!
+//!         The queue counts the posted, replaced and dropped events and
+//!         keeps the largest number of pending events, its high water mark.
+//!
 //! (C) Copyright 2011, Texas Instruments, Inc.
 
 
@@ -44,10 +66,11 @@
 
 #include "sw/modules/types/src/types.h"
 
-// TEMP
-#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+#ifndef __TMS320C28XX__
+// the host masks the signals, which stand in for the interrupts
+#include <signal.h>
+#endif
 
-#include "sw/drivers/cpu/src/32b/f28x/f2803x/cpu.h"
 
 //!
 //!
@@ -75,7 +98,22 @@ extern "C" {
 
 //! \brief Defines the maximum number of events per queue
 //! Note: must be a power of 2
-#define    QUEUE_MAX_NUM_EVENTS         8
+#define    QUEUE_MAX_NUM_EVENTS         16
+
+
+//! \brief Defines the number of keys of the replaced events, including QUEUE_KEY_NONE
+//!
+#define    QUEUE_NUM_KEYS               8
+
+
+//! \brief Defines the key of the events that are never replaced
+//!
+#define    QUEUE_KEY_NONE               0
+
+
+#if (QUEUE_MAX_NUM_EVENTS & (QUEUE_MAX_NUM_EVENTS - 1)) != 0
+#error "QUEUE_MAX_NUM_EVENTS must be a power of 2"
+#endif
 
 
 // **************************************************************************
@@ -94,17 +132,14 @@ typedef struct _EVENT_ArgList_
 } EVENT_ArgList;
 
 
-//! \brief Defines the event queue object
+//! \brief Defines the event object
 //!
 typedef struct _EVENT_Obj_
 {
-  struct _EVENT_Obj_  *nextEvent;        //!< the next event in the queue
-  struct _EVENT_Obj_  *prevEvent;        //!< the previous event in the queue
-  bool                 taken;            //!< a flag to indicate if event is taken
-  uint_least8_t        queueNumber;      //!< the queue number
-  uint_least8_t        numArgs;          //!< the number of event arguments
   EVENT_Fxn            eventFxn;         //!< the event function that will be called
   EVENT_ArgList        argList;          //!< the event function argument list
+  uint_least8_t        numArgs;          //!< the number of event arguments
+  uint_least8_t        key;              //!< the key of a replaced event, QUEUE_KEY_NONE if never replaced
 } EVENT_Obj;
 
 
@@ -117,40 +152,121 @@ typedef struct _EVENT_Obj_  *EVENT_Handle;
 //!
 typedef struct _QUEUE_Obj_
 {
-  EVENT_Handle  firstEvent;              //!< the first event in the queue
-  EVENT_Handle  lastEvent;               //!< the last event in the queue
+  EVENT_Obj                events[QUEUE_MAX_NUM_EVENTS];  //!< the ring of events
+  volatile uint_least16_t  head;                          //!< the count of posted events, written by the posting side
+  volatile uint_least16_t  tail;                          //!< the count of executed events, written by the executing side
+  volatile uint_least16_t  pendingIdx[QUEUE_NUM_KEYS];    //!< the index plus one of the pending event of each key, zero if none
+  uint32_t                 numPosts;                      //!< the number of posted events, including the replaced ones
+  uint32_t                 numReplaced;                   //!< the number of events that replaced a pending event
+  uint32_t                 numDropped;                    //!< the number of events dropped on a full queue
+  uint_least16_t           highWaterMark;                 //!< the largest number of pending events
 } QUEUE_Obj;
 
 
-//! \brief Defines the queue status messages
+//! \brief Defines the queue handle
 //!
-typedef enum 
-{
-  QUEUE_STATUS_FIRST_EVENT_TAKEN=0,      //!< the first event taken message
-  QUEUE_STATUS_LAST_EVENT_TAKEN          //!< the last event taken message
-} QUEUE_Status_e;
+typedef struct _QUEUE_Obj_ *QUEUE_Handle;
 
 
-//! \brief Defines the queue handle
+//! \brief Defines the interrupt mask state saved by QUEUE_disableInts()
 //!
-typedef struct _QUEUE_Obj_ *QUEUE_Handle;
+#ifdef __TMS320C28XX__
+typedef uint16_t                 QUEUE_IntState;
+#else
+typedef sigset_t                 QUEUE_IntState;
+#endif
 
 
 // **************************************************************************
-// the globals
+// the function prototypes
 
-//! \brief The event index
-//!
-extern uint32_t gEventIndex;
 
+//! \brief     Masks the interrupts that may post
+//! \details   DINT on the target, on the host all signals are blocked
+//! \return    The previous mask state for QUEUE_restoreInts()
+static inline QUEUE_IntState QUEUE_disableInts(void)
+{
+#ifdef __TMS320C28XX__
+  return(__disable_interrupts());
+#else
+  sigset_t allSignals;
+  sigset_t intState;
 
-//! \brief The array of events
-//!
-extern EVENT_Obj gEvents[QUEUE_MAX_NUM_EVENTS];
+  sigfillset(&allSignals);
+  sigprocmask(SIG_BLOCK,&allSignals,&intState);
 
+  return(intState);
+#endif
+} // end of QUEUE_disableInts() function
 
-// **************************************************************************
-// the function prototypes
+
+//! \brief     Restores the interrupt mask of QUEUE_disableInts()
+//! \param[in] intState  The mask state
+static inline void QUEUE_restoreInts(QUEUE_IntState intState)
+{
+#ifdef __TMS320C28XX__
+  __restore_interrupts(intState);
+#else
+  sigprocmask(SIG_SETMASK,&intState,NULL);
+#endif
+
+  return;
+} // end of QUEUE_restoreInts() function
+
+
+//! \brief     Gets the number of pending events
+//! \param[in] handle  The queue handle
+//! \return    The number of pending events
+static inline uint_least16_t QUEUE_getNumEvents(QUEUE_Handle handle)
+{
+  QUEUE_Obj *obj = (QUEUE_Obj *)handle;
+
+  return((uint_least16_t)((obj->head - obj->tail) & 0xFFFF));
+} // end of QUEUE_getNumEvents() function
+
+
+//! \brief     Gets the largest number of pending events since the last reset
+//! \param[in] handle  The queue handle
+//! \return    The high water mark
+static inline uint_least16_t QUEUE_getHighWaterMark(QUEUE_Handle handle)
+{
+  QUEUE_Obj *obj = (QUEUE_Obj *)handle;
+
+  return(obj->highWaterMark);
+} // end of QUEUE_getHighWaterMark() function
+
+
+//! \brief     Gets the number of posted events, including the replaced ones
+//! \param[in] handle  The queue handle
+//! \return    The number of posted events
+static inline uint32_t QUEUE_getNumPosts(QUEUE_Handle handle)
+{
+  QUEUE_Obj *obj = (QUEUE_Obj *)handle;
+
+  return(obj->numPosts);
+} // end of QUEUE_getNumPosts() function
+
+
+//! \brief     Gets the number of events that replaced a pending event
+//! \param[in] handle  The queue handle
+//! \return    The number of replaced events
+static inline uint32_t QUEUE_getNumReplaced(QUEUE_Handle handle)
+{
+  QUEUE_Obj *obj = (QUEUE_Obj *)handle;
+
+  return(obj->numReplaced);
+} // end of QUEUE_getNumReplaced() function
+
+
+//! \brief     Gets the number of events dropped on a full queue
+//! \param[in] handle  The queue handle
+//! \return    The number of dropped events
+static inline uint32_t QUEUE_getNumDropped(QUEUE_Handle handle)
+{
+  QUEUE_Obj *obj = (QUEUE_Obj *)handle;
+
+  return(obj->numDropped);
+} // end of QUEUE_getNumDropped() function
 
 
 //! \brief     Checks if there is an event available in the queue.
@@ -159,7 +275,7 @@ static inline bool QUEUE_isEvent(QUEUE_Handle handle)
 {
   QUEUE_Obj *obj = (QUEUE_Obj *)handle;
   
-  return(!(obj->firstEvent == (EVENT_Handle)obj));
+  return(obj->head != obj->tail);
 } // end of QUEUE_isEvent() function
 
 
@@ -169,7 +285,7 @@ static inline bool QUEUE_isIdle(QUEUE_Handle handle)
 {
   QUEUE_Obj *obj = (QUEUE_Obj *)handle;
 
-  return(obj->firstEvent == (EVENT_Handle)obj);
+  return(obj->head == obj->tail);
 } // end of QUEUE_isIdle() function
 
 
@@ -186,215 +302,149 @@ extern QUEUE_Handle QUEUE_init(void *pMemory,const size_t numBytes);
 extern void QUEUE_listen(QUEUE_Handle handle);
 
 
-//! \brief     Posts an event to the beginning of the specified queue
+//! \brief     Resets the statistics of the queue, called by the executing side
+//! \param[in] handle  The queue handle
+extern void QUEUE_resetStats(QUEUE_Handle handle);
+
+
+//! \brief     Posts an event to the end of the specified queue, called by the posting side
+//! \details   Safe from any interrupt, the interrupts are masked for the post
 //! \param[in] handle       The queue handle
+//! \param[in] key          The key of a replaced event, QUEUE_KEY_NONE to always take a new place
 //! \param[in] eventFxn     The event function that will be called
 //! \param[in] *pArgList    The pointer to the event argument list
-//! \param[in] numArgs      The number of arguments
-static inline status QUEUE_postEventFirst(QUEUE_Handle handle,
-                                          const EVENT_Fxn eventFxn,
-                                          const EVENT_ArgList *pArgList,
-                                          const uint_least8_t numArgs)
+//! \param[in] numArgs      The number of event arguments
+//! \return    OK, or ERROR when the arguments are invalid or the queue is full
+static inline status QUEUE_postEvent(QUEUE_Handle handle,
+                                     const uint_least8_t key,
+                                     const EVENT_Fxn eventFxn,
+                                     const EVENT_ArgList *pArgList,
+                                     const uint_least8_t numArgs)
 {
+  QUEUE_Obj *obj = (QUEUE_Obj *)handle;
+  QUEUE_IntState intState;
+  uint_least16_t head;
+  uint_least16_t numEvents;
+  uint_least16_t idx;
+  EVENT_Obj *pEvent;
+  status result = OK;
+
 
-  if(numArgs > EVENT_MAX_NUM_ARGS)
+  if((numArgs > EVENT_MAX_NUM_ARGS) || (key >= QUEUE_NUM_KEYS))
     {
       return(ERROR);
     }
-  else
-    {
-      QUEUE_Obj *obj = (QUEUE_Obj *)handle;
-      EVENT_Obj *pEvent;
-      EVENT_Obj *pFirstEvent;
 
-      pEvent = &gEvents[gEventIndex];
+  // a nested post must not take the same place or key, nor the executing
+  // side read the event half written
+  intState = QUEUE_disableInts();
 
-      if(pEvent->taken)
-        return(QUEUE_STATUS_FIRST_EVENT_TAKEN);
+  obj->numPosts++;
+  head = obj->head;
+  numEvents = (uint_least16_t)((head - obj->tail) & 0xFFFF);
 
-      gEventIndex++;
-      gEventIndex &= QUEUE_MAX_NUM_EVENTS-1;
-
-      pEvent->taken = true;
+  if((key != QUEUE_KEY_NONE) && (obj->pendingIdx[key] != 0))
+    {
+      // a pending event of the same key takes the new arguments
+      pEvent = &obj->events[obj->pendingIdx[key] - 1];
 
       pEvent->eventFxn = eventFxn;
-      pEvent->argList.arg[0] = pArgList->arg[0];
-      pEvent->argList.arg[1] = pArgList->arg[1];
-      pEvent->argList.arg[2] = pArgList->arg[2];
-      pEvent->argList.arg[3] = pArgList->arg[3];
-
-      // set the number of arguments
+      pEvent->argList = *pArgList;
       pEvent->numArgs = numArgs;
 
-      // insert the event at top of the queue
-      pFirstEvent = (EVENT_Obj *)obj->firstEvent;
-  
-      pEvent->prevEvent = pFirstEvent->prevEvent;
-      pEvent->nextEvent = pFirstEvent;
-      pFirstEvent->prevEvent = pEvent;
-      obj->firstEvent = (EVENT_Handle)pEvent;
-  
-      return(OK);
+      obj->numReplaced++;
     }
-} // end of QUEUE_postEventFirst() function
-
-
-//! \brief     Posts an event to the end of the specified queue
-//! \param[in] handle       The queue handle
-//! \param[in] eventFxn     The event function that will be called
-//! \param[in] *pArgList    The pointer to the event argument list
-//! \param[in] numArgs      The number of event arguments
-static inline status QUEUE_postEventLast(QUEUE_Handle handle,
-                                         const EVENT_Fxn eventFxn,
-                                         const EVENT_ArgList *pArgList,
-                                         const uint_least8_t numArgs)
-{
-
-  if(numArgs > EVENT_MAX_NUM_ARGS)
+  else if(numEvents >= QUEUE_MAX_NUM_EVENTS)
     {
-      return(ERROR);
+      obj->numDropped++;
+
+      result = ERROR;
     }
   else
     {
-      QUEUE_Obj *obj = (QUEUE_Obj *)handle;
-      EVENT_Obj *pEvent;
-      EVENT_Obj *pLastEvent;
-
-      pEvent = &gEvents[gEventIndex];
-
-      if(pEvent->taken)
-        return(QUEUE_STATUS_LAST_EVENT_TAKEN);
-
-      gEventIndex++;
-      gEventIndex &= QUEUE_MAX_NUM_EVENTS-1;
-
-      pEvent->taken = true;
+      idx = head & (QUEUE_MAX_NUM_EVENTS - 1);
+      pEvent = &obj->events[idx];
 
       pEvent->eventFxn = eventFxn;
-      pEvent->argList.arg[0] = pArgList->arg[0];
-      pEvent->argList.arg[1] = pArgList->arg[1];
-      pEvent->argList.arg[2] = pArgList->arg[2];
-      pEvent->argList.arg[3] = pArgList->arg[3];
-
-      // set the number of arguments
+      pEvent->argList = *pArgList;
       pEvent->numArgs = numArgs;
+      pEvent->key = key;
 
-      // insert the event at the bottom of the queue
-      pLastEvent = (EVENT_Obj *)obj->lastEvent;
-
-      pEvent->prevEvent = pLastEvent;
-      pEvent->nextEvent = pLastEvent->nextEvent;
-      pLastEvent->nextEvent = pEvent;
-      obj->lastEvent = (EVENT_Handle)pEvent;
-
-      return(OK);
-    }
-
-} // end of QUEUE_postEventLast() function
+      if(key != QUEUE_KEY_NONE)
+        {
+          obj->pendingIdx[key] = idx + 1;
+        }
 
+      // publish the event after it is complete
+      obj->head = (head + 1) & 0xFFFF;
 
-//! \brief     Removed the first event from the specified queue
-//! \param[in] handle  The queue handle
-static inline void QUEUE_removeFirstEvent(QUEUE_Handle handle)
-{
-  QUEUE_Obj *obj = (QUEUE_Obj *)handle;
-  EVENT_Obj *pFirstEvent;
-  EVENT_Obj *pNextEvent;
-  EVENT_Obj *pPrevEvent;
-
-
-  // disable interrupts
-  DISABLE_INTERRUPTS;
-
-  pFirstEvent = (EVENT_Obj *)obj->firstEvent;
-
-  pNextEvent = pFirstEvent->nextEvent;
-  pPrevEvent = pFirstEvent->prevEvent;
-
-  pNextEvent->prevEvent = pPrevEvent;
-  pPrevEvent->nextEvent = pNextEvent;
+      numEvents++;
 
-  obj->firstEvent = (EVENT_Handle)pNextEvent;
-
-  pFirstEvent->taken = false;
+      if(numEvents > obj->highWaterMark)
+        {
+          obj->highWaterMark = numEvents;
+        }
+    }
 
-  // enable maskable interrupts
-  ENABLE_INTERRUPTS;
+  QUEUE_restoreInts(intState);
 
-  return;
-} // end of QUEUE_removeFirstEvent() function
+  return(result);
+} // end of QUEUE_postEvent() function
 
 
-//! \brief     Removed the last event from the specified queue
+//! \brief     Checks the specified event queue for an event.  If there is an event, 
+//             it is executed.  Called by the executing side.
 //! \param[in] handle  The queue handle
-//extern void QUEUE_removeLastEvent(QUEUE_Handle handle);
-static inline void QUEUE_removeLastEvent(QUEUE_Handle handle)
+//! \return    true if an event was executed
+static inline bool QUEUE_executeEvent(QUEUE_Handle handle)
 {
   QUEUE_Obj *obj = (QUEUE_Obj *)handle;
-  EVENT_Obj *pLastEvent;
-  EVENT_Obj *pNextEvent;
-  EVENT_Obj *pPrevEvent;
-
-
-  // disable interrupts
-  DISABLE_INTERRUPTS;
-
-  pLastEvent = (EVENT_Obj *)obj->lastEvent;
-
-  pNextEvent = (EVENT_Obj *)pLastEvent->nextEvent;
-  pPrevEvent = (EVENT_Obj *)pLastEvent->prevEvent;
+  uint_least16_t tail = obj->tail;
+  uint_least16_t idx = tail & (QUEUE_MAX_NUM_EVENTS - 1);
+  EVENT_Obj event;
 
-  pNextEvent->prevEvent = pPrevEvent;
-  pPrevEvent->nextEvent = pNextEvent;
 
-  pLastEvent->taken = false;
-
-  obj->lastEvent = (EVENT_Handle)pPrevEvent;
-
-  // enable interrupts
-  ENABLE_INTERRUPTS;
+  if(tail == obj->head)
+    {
+      return(false);
+    }
 
-  return;
-} // end of QUEUE_removeLastEvent() function
+  // stop the replacement first, a post in between replaces the arguments
+  // before they are copied and a post after takes a new place
+  if(obj->events[idx].key != QUEUE_KEY_NONE)
+    {
+      obj->pendingIdx[obj->events[idx].key] = 0;
+    }
 
+  event = obj->events[idx];
 
-//! \brief     Checks the specified event queue for an event.  If there is an event, 
-//             it is executed.
-//! \param[in] handle  The queue handle
-static inline void QUEUE_executeEvent(QUEUE_Handle handle)
-{
-  QUEUE_Obj *obj = (QUEUE_Obj *)handle;
-  EVENT_Obj *pEvent = (EVENT_Obj *)obj->firstEvent;
-  uint_least8_t numArgs = pEvent->numArgs;
+  // free the place before the call, the event may post again
+  obj->tail = (tail + 1) & 0xFFFF;
 
 
   // based on the number of event arguments, make the appropriate event call
-  if(numArgs == 4)
+  if(event.numArgs == 4)
     {
-      (pEvent->eventFxn)(pEvent->argList.arg[0],pEvent->argList.arg[1],pEvent->argList.arg[2],pEvent->argList.arg[3]);
+      (event.eventFxn)(event.argList.arg[0],event.argList.arg[1],event.argList.arg[2],event.argList.arg[3]);
     }
-  else if(numArgs == 3)
+  else if(event.numArgs == 3)
     {
-      (pEvent->eventFxn)(pEvent->argList.arg[0],pEvent->argList.arg[1],pEvent->argList.arg[2]);
+      (event.eventFxn)(event.argList.arg[0],event.argList.arg[1],event.argList.arg[2]);
     }
-  else if(numArgs == 2)
+  else if(event.numArgs == 2)
     {
-      (pEvent->eventFxn)(pEvent->argList.arg[0],pEvent->argList.arg[1]);
+      (event.eventFxn)(event.argList.arg[0],event.argList.arg[1]);
     }
-  else if(numArgs == 1)
+  else if(event.numArgs == 1)
     {
-      (pEvent->eventFxn)(pEvent->argList.arg[0]);
+      (event.eventFxn)(event.argList.arg[0]);
     }
-  else if(numArgs == 0)
+  else if(event.numArgs == 0)
     {
-      (pEvent->eventFxn)();
+      (event.eventFxn)();
     }
 
-
-  // remove the event from the queue
-  QUEUE_removeFirstEvent(handle);
-
-  return;
+  return(true);
 } // end of QUEUE_executeEvent() function
 
 
@@ -403,6 +453,6 @@ static inline void QUEUE_executeEvent(QUEUE_Handle handle)
 #endif // extern "C"
 
 //@} // ingroup
-#endif // end of _QUEUE_H_ definition
 
+#endif // end of _QUEUE_H_ definition
 
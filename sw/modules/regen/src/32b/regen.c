@@ -0,0 +1,108 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/regen/src/32b/regen.c
+//! \brief  Portable C code.  These functions define the
+//!         regenerative braking governor (REGEN) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/regen/src/32b/regen.h"
+
+
+// **************************************************************************
+// the functions
+
+REGEN_Handle REGEN_init(void *pMemory,const size_t numBytes)
+{
+  REGEN_Handle handle;
+  REGEN_Obj *obj;
+
+
+  if(numBytes < sizeof(REGEN_Obj))
+    return((REGEN_Handle)NULL);
+
+  // assign the handle
+  handle = (REGEN_Handle)pMemory;
+
+  obj = (REGEN_Obj *)handle;
+
+  obj->Vstart_pu = _IQ(0.0);
+  obj->Vmax_pu = _IQ(0.0);
+  obj->oneOverBand = _IQ(0.0);
+  obj->IqMax_pu = _IQ(0.0);
+  obj->IdLoss_pu = _IQ(0.0);
+
+  // no limit until the parameters are set
+  obj->frac = _IQ(1.0);
+  obj->IqRegenMax_pu = _IQ(0.0);
+  obj->Fm_pu = _IQ(0.0);
+  obj->flag_braking = false;
+  obj->Id_ref_pu = _IQ(0.0);
+
+  REGEN_resetStats(handle);
+
+  return(handle);
+} // end of REGEN_init() function
+
+
+void REGEN_setParams(REGEN_Handle handle,const _iq Vstart_pu,const _iq Vmax_pu,
+                     const _iq IqMax_pu,const _iq IdLoss_pu)
+{
+  REGEN_Obj *obj = (REGEN_Obj *)handle;
+
+  obj->Vstart_pu = Vstart_pu;
+  obj->Vmax_pu = Vmax_pu;
+  obj->oneOverBand = _IQdiv(_IQ(1.0),Vmax_pu - Vstart_pu);
+  obj->IqMax_pu = IqMax_pu;
+  obj->IdLoss_pu = IdLoss_pu;
+
+  obj->IqRegenMax_pu = _IQmpy(IqMax_pu,obj->frac);
+
+  return;
+} // end of REGEN_setParams() function
+
+
+void REGEN_resetStats(REGEN_Handle handle)
+{
+  REGEN_Obj *obj = (REGEN_Obj *)handle;
+
+  obj->VdcPeak_pu = _IQ(0.0);
+  obj->numLimitedTicks = 0;
+
+  return;
+} // end of REGEN_resetStats() function
+
+// end of file
@@ -0,0 +1,288 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _REGEN_H_
+#define _REGEN_H_
+
+//! \file   modules/regen/src/32b/regen.h
+//! \brief  Contains the public interface to the
+//!         regenerative braking governor (REGEN) module routines
+//!
+//!         A quadrature current against the direction of rotation brakes the
+//!         rotor and returns its kinetic energy to the DC bus.  A battery takes
+//!         it, the bus capacitors alone charge up within milliseconds when the
+//!         battery is disconnected or its protection opened.
+//!
+//!         The governor limits the regenerative Iq from the measured bus
+//!         voltage.  Below Vstart the full current is allowed, from Vstart the
+//!         allowed current drops linearly to zero at Vmax.
+//!
+//!           frac = (Vmax - Vdc)/(Vmax - Vstart), 0 to 1
+//!           |Iq| <= frac*IqMax  while braking
+//!
+//!         The speed controller keeps braking within the limit, the rotor then
+//!         decelerates as fast as the losses and the bus take the energy.  A
+//!         negative Id of (1 - frac)*IdLoss adds the copper losses Rs*Id^2 to
+//!         them while braking, a negative Id also weakens the field and so the
+//!         back-EMF that charges the bus through the diodes.  Motoring is not
+//!         limited.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+
+
+//!
+//!
+//! \defgroup REGEN REGEN
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the regenerative braking governor (REGEN) object
+//!
+typedef struct _REGEN_Obj_
+{
+  _iq             Vstart_pu;          //!< the bus voltage above which the regenerative current is limited, pu
+  _iq             Vmax_pu;            //!< the bus voltage of zero regenerative current, pu
+  _iq             oneOverBand;        //!< one over the difference of the two bus voltages, 1/pu
+  _iq             IqMax_pu;           //!< the largest regenerative Iq, pu
+  _iq             IdLoss_pu;          //!< the Id of the loss injection at Vmax, negative, pu
+
+  _iq             frac;               //!< the allowed fraction of the regenerative current, 0 to 1
+  _iq             IqRegenMax_pu;      //!< the largest regenerative Iq of the tick, pu
+  _iq             Fm_pu;              //!< the speed of the tick, its sign is the direction of rotation, pu
+  bool            flag_braking;       //!< denotes that the last Iq reference was regenerative
+  _iq             Id_ref_pu;          //!< the Id reference of the loss injection, pu
+
+  _iq             VdcPeak_pu;         //!< the highest bus voltage, pu
+  uint_least32_t  numLimitedTicks;    //!< the number of ticks with a regenerative Iq reference cut by the limit
+} REGEN_Obj;
+
+
+//! \brief Defines the REGEN handle
+//!
+typedef struct _REGEN_Obj_ *REGEN_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Initializes the regenerative braking governor (REGEN) module
+//! \param[in] pMemory   A pointer to the memory for the REGEN object
+//! \param[in] numBytes  The number of bytes allocated for the REGEN object, bytes
+//! \return    The REGEN object handle
+extern REGEN_Handle REGEN_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Sets the parameters
+//! \param[in] handle     The REGEN handle
+//! \param[in] Vstart_pu  The bus voltage above which the regenerative current is limited, pu
+//! \param[in] Vmax_pu    The bus voltage of zero regenerative current, pu, larger than Vstart_pu
+//! \param[in] IqMax_pu   The largest regenerative Iq, pu
+//! \param[in] IdLoss_pu  The Id of the loss injection at Vmax, zero or negative, pu
+extern void REGEN_setParams(REGEN_Handle handle,const _iq Vstart_pu,const _iq Vmax_pu,
+                            const _iq IqMax_pu,const _iq IdLoss_pu);
+
+
+//! \brief     Resets the highest bus voltage and the number of limited ticks
+//! \param[in] handle  The REGEN handle
+extern void REGEN_resetStats(REGEN_Handle handle);
+
+
+//! \brief     Gets the allowed fraction of the regenerative current
+//! \param[in] handle  The REGEN handle
+//! \return    The fraction, 0 to 1
+static inline _iq REGEN_getFrac(REGEN_Handle handle)
+{
+  REGEN_Obj *obj = (REGEN_Obj *)handle;
+
+  return(obj->frac);
+} // end of REGEN_getFrac() function
+
+
+//! \brief     Gets the Id reference of the loss injection
+//! \param[in] handle  The REGEN handle
+//! \return    The Id reference, pu
+static inline _iq REGEN_getId_ref_pu(REGEN_Handle handle)
+{
+  REGEN_Obj *obj = (REGEN_Obj *)handle;
+
+  return(obj->Id_ref_pu);
+} // end of REGEN_getId_ref_pu() function
+
+
+//! \brief     Gets the number of ticks with a regenerative Iq reference cut by the limit
+//! \param[in] handle  The REGEN handle
+//! \return    The number of ticks
+static inline uint_least32_t REGEN_getNumLimitedTicks(REGEN_Handle handle)
+{
+  REGEN_Obj *obj = (REGEN_Obj *)handle;
+
+  return(obj->numLimitedTicks);
+} // end of REGEN_getNumLimitedTicks() function
+
+
+//! \brief     Gets the highest bus voltage
+//! \param[in] handle  The REGEN handle
+//! \return    The bus voltage, pu
+static inline _iq REGEN_getVdcPeak_pu(REGEN_Handle handle)
+{
+  REGEN_Obj *obj = (REGEN_Obj *)handle;
+
+  return(obj->VdcPeak_pu);
+} // end of REGEN_getVdcPeak_pu() function
+
+
+//! \brief     Denotes that the governor cuts the regenerative current
+//! \param[in] handle  The REGEN handle
+//! \return    true above Vstart
+static inline bool REGEN_isLimiting(REGEN_Handle handle)
+{
+  REGEN_Obj *obj = (REGEN_Obj *)handle;
+
+  return(obj->frac < _IQ(1.0));
+} // end of REGEN_isLimiting() function
+
+
+//! \brief     Limits the minimum and the maximum of a quadrature current
+//! \details   Only the side against the direction of rotation is limited
+//! \param[in] handle   The REGEN handle
+//! \param[in] pOutMin  The pointer to the minimum, pu
+//! \param[in] pOutMax  The pointer to the maximum, pu
+static inline void REGEN_limitMinMax(REGEN_Handle handle,_iq *pOutMin,_iq *pOutMax)
+{
+  REGEN_Obj *obj = (REGEN_Obj *)handle;
+
+  if(obj->Fm_pu >= _IQ(0.0))
+    {
+      if(*pOutMin < -obj->IqRegenMax_pu)
+        {
+          *pOutMin = -obj->IqRegenMax_pu;
+        }
+    }
+  else
+    {
+      if(*pOutMax > obj->IqRegenMax_pu)
+        {
+          *pOutMax = obj->IqRegenMax_pu;
+        }
+    }
+
+  return;
+} // end of REGEN_limitMinMax() function
+
+
+//! \brief     Limits a quadrature current reference
+//! \details   Also sets the Id reference of the loss injection of the next tick
+//! \param[in] handle     The REGEN handle
+//! \param[in] Iq_ref_pu  The Iq reference, pu
+//! \return    The limited Iq reference, pu
+static inline _iq REGEN_limitIq_ref(REGEN_Handle handle,const _iq Iq_ref_pu)
+{
+  REGEN_Obj *obj = (REGEN_Obj *)handle;
+  _iq Iq_pu = Iq_ref_pu;
+
+  if(obj->Fm_pu >= _IQ(0.0))
+    {
+      if(Iq_pu < -obj->IqRegenMax_pu)
+        {
+          Iq_pu = -obj->IqRegenMax_pu;
+        }
+    }
+  else
+    {
+      if(Iq_pu > obj->IqRegenMax_pu)
+        {
+          Iq_pu = obj->IqRegenMax_pu;
+        }
+    }
+
+  if(Iq_pu != Iq_ref_pu)
+    {
+      obj->numLimitedTicks++;
+    }
+
+  // a reference held at the regenerative limit still asks for braking, also
+  // when the limit has tapered to zero and the speed PI sits on its bound
+  obj->flag_braking = (obj->Fm_pu >= _IQ(0.0)) ? (Iq_ref_pu <= -obj->IqRegenMax_pu) : (Iq_ref_pu >= obj->IqRegenMax_pu);
+
+  obj->Id_ref_pu = obj->flag_braking ? _IQmpy(obj->IdLoss_pu,_IQ(1.0) - obj->frac) : _IQ(0.0);
+
+  return(Iq_pu);
+} // end of REGEN_limitIq_ref() function
+
+
+//! \brief     Runs the governor on the bus voltage of the tick
+//! \param[in] handle  The REGEN handle
+//! \param[in] Vdc_pu  The DC bus voltage, pu
+//! \param[in] Fm_pu   The speed, pu
+static inline void REGEN_run(REGEN_Handle handle,const _iq Vdc_pu,const _iq Fm_pu)
+{
+  REGEN_Obj *obj = (REGEN_Obj *)handle;
+  _iq frac = _IQmpy(obj->Vmax_pu - Vdc_pu,obj->oneOverBand);
+
+  frac = _IQsat(frac,_IQ(1.0),_IQ(0.0));
+
+  obj->frac = frac;
+  obj->IqRegenMax_pu = _IQmpy(obj->IqMax_pu,frac);
+  obj->Fm_pu = Fm_pu;
+
+  if(Vdc_pu > obj->VdcPeak_pu)
+    {
+      obj->VdcPeak_pu = Vdc_pu;
+    }
+
+  return;
+} // end of REGEN_run() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _REGEN_H_ definition
+
@@ -0,0 +1,268 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/sched/src/32b/sched.c
+//! \brief  Portable C code.  These functions define the
+//!         background task scheduler (SCHED) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/sched/src/32b/sched.h"
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Reads the timer and advances the time of the scheduler
+//! \param[in] obj  The scheduler object
+//! \return    The time, cnts
+static uint32_t SCHED_updateTime(SCHED_Obj *obj)
+{
+  uint32_t cnt = obj->readCntFxn();
+  uint32_t deltaCnt;
+
+
+  // the timer counts down and wraps from zero to its period
+  if(cnt <= obj->cnt_z1)
+    {
+      deltaCnt = obj->cnt_z1 - cnt;
+    }
+  else
+    {
+      deltaCnt = obj->cnt_z1 + obj->timerPeriod_cnts - cnt;
+    }
+
+  obj->cnt_z1 = cnt;
+  obj->now_cnts += deltaCnt;
+  obj->elapsed_cnts += deltaCnt;
+
+  return(obj->now_cnts);
+} // end of SCHED_updateTime() function
+
+
+SCHED_Handle SCHED_init(void *pMemory,const size_t numBytes)
+{
+  SCHED_Handle handle;
+  SCHED_Obj *obj;
+
+
+  if(numBytes < sizeof(SCHED_Obj))
+    return((SCHED_Handle)NULL);
+
+  // assign the handle
+  handle = (SCHED_Handle)pMemory;
+
+  obj = (SCHED_Obj *)handle;
+
+  memset(obj,0,sizeof(SCHED_Obj));
+
+  return(handle);
+} // end of SCHED_init() function
+
+
+void SCHED_setParams(SCHED_Handle handle,
+                     const SCHED_ReadCntFxn readCntFxn,
+                     const uint32_t timerFreq_Hz,
+                     const uint32_t timerPeriod_cnts)
+{
+  SCHED_Obj *obj = (SCHED_Obj *)handle;
+
+
+  obj->readCntFxn = readCntFxn;
+  obj->timerFreq_Hz = timerFreq_Hz;
+  obj->timerPeriod_cnts = timerPeriod_cnts + 1;
+
+  obj->cnt_z1 = readCntFxn();
+
+  return;
+} // end of SCHED_setParams() function
+
+
+status SCHED_addTask(SCHED_Handle handle,
+                     const SCHED_TaskFxn taskFxn,
+                     const char *pName,
+                     const uint32_t period_cnts,
+                     const uint32_t deadline_cnts)
+{
+  SCHED_Obj *obj = (SCHED_Obj *)handle;
+  uint_least8_t taskNum;
+
+
+  if((obj->numTasks >= SCHED_MAX_TASKS) || (period_cnts == 0))
+    {
+      return(ERROR);
+    }
+
+  // rate monotonic, the shorter period goes first, equal periods in the order added
+  taskNum = obj->numTasks;
+
+  while((taskNum > 0) && (obj->task[taskNum - 1].period_cnts > period_cnts))
+    {
+      obj->task[taskNum] = obj->task[taskNum - 1];
+      taskNum--;
+    }
+
+  memset(&obj->task[taskNum],0,sizeof(SCHED_Task_t));
+
+  obj->task[taskNum].taskFxn = taskFxn;
+  obj->task[taskNum].pName = pName;
+  obj->task[taskNum].period_cnts = period_cnts;
+  obj->task[taskNum].deadline_cnts = (deadline_cnts != 0) ? deadline_cnts : period_cnts;
+  obj->task[taskNum].release_cnts = obj->now_cnts;
+
+  obj->numTasks++;
+
+  return(OK);
+} // end of SCHED_addTask() function
+
+
+uint32_t SCHED_getLoad_ppm(SCHED_Handle handle,const uint_least8_t taskNum)
+{
+  SCHED_Obj *obj = (SCHED_Obj *)handle;
+  uint64_t window_cnts = obj->elapsed_cnts - obj->statsStart_cnts;
+  uint64_t sumExec_cnts = 0;
+  uint_least8_t cnt;
+
+
+  if(window_cnts == 0)
+    {
+      return(0);
+    }
+
+  if(taskNum < obj->numTasks)
+    {
+      sumExec_cnts = obj->task[taskNum].sumExec_cnts;
+    }
+  else
+    {
+      for(cnt=0;cnt<obj->numTasks;cnt++)
+        {
+          sumExec_cnts += obj->task[cnt].sumExec_cnts;
+        }
+    }
+
+  return((uint32_t)((sumExec_cnts * 1000000) / window_cnts));
+} // end of SCHED_getLoad_ppm() function
+
+
+void SCHED_resetStats(SCHED_Handle handle)
+{
+  SCHED_Obj *obj = (SCHED_Obj *)handle;
+  uint_least8_t cnt;
+
+
+  for(cnt=0;cnt<obj->numTasks;cnt++)
+    {
+      SCHED_Task_t *pTask = &obj->task[cnt];
+
+      pTask->numRuns = 0;
+      pTask->numOverruns = 0;
+      pTask->numSkipped = 0;
+      pTask->maxLateness_cnts = 0;
+      pTask->maxExec_cnts = 0;
+      pTask->sumExec_cnts = 0;
+    }
+
+  obj->statsStart_cnts = obj->elapsed_cnts;
+
+  return;
+} // end of SCHED_resetStats() function
+
+
+bool SCHED_run(SCHED_Handle handle)
+{
+  SCHED_Obj *obj = (SCHED_Obj *)handle;
+  uint32_t start_cnts = SCHED_updateTime(obj);
+  uint32_t end_cnts;
+  uint32_t exec_cnts;
+  uint32_t lateness_cnts;
+  SCHED_Task_t *pTask = NULL;
+  uint_least8_t cnt;
+
+
+  // the shortest period task that is due
+  for(cnt=0;cnt<obj->numTasks;cnt++)
+    {
+      if((int32_t)(start_cnts - obj->task[cnt].release_cnts) >= 0)
+        {
+          pTask = &obj->task[cnt];
+          break;
+        }
+    }
+
+  if(pTask == NULL)
+    {
+      return(false);
+    }
+
+  pTask->taskFxn();
+
+  end_cnts = SCHED_updateTime(obj);
+  exec_cnts = end_cnts - start_cnts;
+  lateness_cnts = end_cnts - pTask->release_cnts;
+
+  pTask->numRuns++;
+  pTask->sumExec_cnts += exec_cnts;
+
+  if(exec_cnts > pTask->maxExec_cnts)
+    {
+      pTask->maxExec_cnts = exec_cnts;
+    }
+
+  if(lateness_cnts > pTask->maxLateness_cnts)
+    {
+      pTask->maxLateness_cnts = lateness_cnts;
+    }
+
+  if(lateness_cnts > pTask->deadline_cnts)
+    {
+      pTask->numOverruns++;
+    }
+
+  // the next release, the releases that already passed by more than a period are skipped
+  pTask->release_cnts += pTask->period_cnts;
+
+  if((int32_t)(end_cnts - pTask->release_cnts) >= (int32_t)pTask->period_cnts)
+    {
+      uint32_t numSkipped = (end_cnts - pTask->release_cnts) / pTask->period_cnts;
+
+      pTask->release_cnts += numSkipped * pTask->period_cnts;
+      pTask->numSkipped += numSkipped;
+    }
+
+  return(true);
+} // end of SCHED_run() function
+
+// end of file
@@ -0,0 +1,240 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _SCHED_H_
+#define _SCHED_H_
+
+//! \file   modules/sched/src/32b/sched.h
+//! \brief  Contains the public interface to the
+//!         background task scheduler (SCHED) module routines
+//!
+//!         The scheduler runs the tasks of the background loop at their own
+//!         rates instead of on every pass.  Every task has a period and a
+//!         deadline, both in counts of a free running CPU timer.  The tasks
+//!         are ordered by their periods, rate monotonic, and SCHED_run()
+//!         runs the shortest period task that is due.  A task always runs to
+//!         its end, there is no preemption between tasks, so a task that
+//!         shares data with another background task needs no protection.
+//!
+//!         A task that ends later than its deadline after its release counts
+//!         an overrun.  A task that is late by more than a period skips the
+//!         releases it missed instead of running them back to back, and
+//!         counts them.
+//!
+//!         The scheduler also measures the time of every task run.  The
+//!         sum over the time since the last reset gives the share of the CPU
+//!         of each task and of the whole background, the CPU budget.  The
+//!         times include the interrupts that preempted the task.
+//!
+//!         The timer counts down from its period to zero and wraps, as the
+//!         CPU timers do.  SCHED_run() must be called at least once per
+//!         timer period.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+// modules
+#include "sw/modules/types/src/types.h"
+
+
+//!
+//!
+//! \defgroup SCHED SCHED
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the maximum number of tasks
+//!
+#define SCHED_MAX_TASKS               (8)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the task function
+//!
+typedef void (*SCHED_TaskFxn)(void);
+
+
+//! \brief Defines the timer read function
+//!
+typedef uint32_t (*SCHED_ReadCntFxn)(void);
+
+
+//! \brief Defines a task and its statistics
+//!
+typedef struct _SCHED_Task_t_
+{
+  SCHED_TaskFxn     taskFxn;            //!< the task function
+  const char       *pName;              //!< the task name, for the reports
+  uint32_t          period_cnts;        //!< the period, cnts
+  uint32_t          deadline_cnts;      //!< the deadline after the release, cnts
+  uint32_t          release_cnts;       //!< the time of the next release, cnts
+
+  uint32_t          numRuns;            //!< the number of runs
+  uint32_t          numOverruns;        //!< the number of runs that ended after the deadline
+  uint32_t          numSkipped;         //!< the number of skipped releases
+  uint32_t          maxLateness_cnts;   //!< the longest time from the release to the end of a run, cnts
+  uint32_t          maxExec_cnts;       //!< the longest run, cnts
+  uint64_t          sumExec_cnts;       //!< the sum of the run times, cnts
+} SCHED_Task_t;
+
+
+//! \brief Defines the background task scheduler (SCHED) object
+//!
+typedef struct _SCHED_Obj_
+{
+  SCHED_Task_t      task[SCHED_MAX_TASKS];  //!< the tasks, the shortest period first
+  uint_least8_t     numTasks;               //!< the number of tasks
+
+  SCHED_ReadCntFxn  readCntFxn;             //!< the function that reads the timer
+  uint32_t          timerPeriod_cnts;       //!< the timer period, cnts
+  uint32_t          timerFreq_Hz;           //!< the timer frequency, Hz
+
+  uint32_t          cnt_z1;                 //!< the timer count of the previous reading, cnts
+  uint32_t          now_cnts;               //!< the time counting up, cnts
+  uint64_t          statsStart_cnts;        //!< the elapsed time at the statistics reset, cnts
+  uint64_t          elapsed_cnts;           //!< the elapsed time since the start, cnts
+} SCHED_Obj;
+
+
+//! \brief Defines the SCHED handle
+//!
+typedef struct _SCHED_Obj_ *SCHED_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Gets the number of tasks
+//! \param[in] handle  The scheduler (SCHED) handle
+//! \return    The number of tasks
+static inline uint_least8_t SCHED_getNumTasks(SCHED_Handle handle)
+{
+  SCHED_Obj *obj = (SCHED_Obj *)handle;
+
+  return(obj->numTasks);
+} // end of SCHED_getNumTasks() function
+
+
+//! \brief     Gets a task and its statistics
+//! \param[in] handle   The scheduler (SCHED) handle
+//! \param[in] taskNum  The task number, in the order of the periods
+//! \return    The pointer to the task
+static inline const SCHED_Task_t *SCHED_getTask(SCHED_Handle handle,const uint_least8_t taskNum)
+{
+  SCHED_Obj *obj = (SCHED_Obj *)handle;
+
+  return(&obj->task[taskNum]);
+} // end of SCHED_getTask() function
+
+
+//! \brief     Gets the timer frequency
+//! \param[in] handle  The scheduler (SCHED) handle
+//! \return    The timer frequency, Hz
+static inline uint32_t SCHED_getTimerFreq_Hz(SCHED_Handle handle)
+{
+  SCHED_Obj *obj = (SCHED_Obj *)handle;
+
+  return(obj->timerFreq_Hz);
+} // end of SCHED_getTimerFreq_Hz() function
+
+
+//! \brief     Initializes the background task scheduler (SCHED) module
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The scheduler (SCHED) handle
+extern SCHED_Handle SCHED_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Sets the timer of the scheduler
+//! \param[in] handle            The scheduler (SCHED) handle
+//! \param[in] readCntFxn        The function that reads the free running timer
+//! \param[in] timerFreq_Hz      The timer frequency, Hz
+//! \param[in] timerPeriod_cnts  The timer period register, the timer counts from it down to zero, cnts
+extern void SCHED_setParams(SCHED_Handle handle,
+                            const SCHED_ReadCntFxn readCntFxn,
+                            const uint32_t timerFreq_Hz,
+                            const uint32_t timerPeriod_cnts);
+
+
+//! \brief     Adds a task, the first release is at the next call of SCHED_run()
+//! \param[in] handle         The scheduler (SCHED) handle
+//! \param[in] taskFxn        The task function
+//! \param[in] pName          The task name
+//! \param[in] period_cnts    The period, cnts
+//! \param[in] deadline_cnts  The deadline after the release, 0 for the period, cnts
+//! \return    OK, or ERROR when all tasks are in use or the period is zero
+extern status SCHED_addTask(SCHED_Handle handle,
+                            const SCHED_TaskFxn taskFxn,
+                            const char *pName,
+                            const uint32_t period_cnts,
+                            const uint32_t deadline_cnts);
+
+
+//! \brief     Gets the share of the CPU of a task since the last reset
+//! \param[in] handle   The scheduler (SCHED) handle
+//! \param[in] taskNum  The task number, SCHED_MAX_TASKS for all tasks together
+//! \return    The share of the CPU, parts per million
+extern uint32_t SCHED_getLoad_ppm(SCHED_Handle handle,const uint_least8_t taskNum);
+
+
+//! \brief     Resets the statistics of all tasks
+//! \param[in] handle  The scheduler (SCHED) handle
+extern void SCHED_resetStats(SCHED_Handle handle);
+
+
+//! \brief     Runs the most urgent task that is due
+//! \param[in] handle  The scheduler (SCHED) handle
+//! \return    true if a task ran, false if none was due
+extern bool SCHED_run(SCHED_Handle handle);
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _SCHED_H_ definition
+
@@ -0,0 +1,517 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/svgen/src/32b/host/svgen_1shunt_check.c
+//! \brief  Checks the single shunt current reconstruction (SVGEN1SHUNT)
+//!         against a model of the inverter and the motor
+//!
+//!         For every modulation index and voltage angle the space vector
+//!         modulator (SVGEN) computes the duties, SVGEN1SHUNT_run() the
+//!         shifted compare values and sample points.  The inverter with
+//!         dead time drives a star connected R-L load with a constant back
+//!         emf that sets the wanted current vector, integrated at the PWM
+//!         clock.  The dc link current passes a first order shunt amplifier
+//!         and is sampled at the two sample points of the last period.
+//!         SVGEN1SHUNT_runRegenCurrent() rebuilds the phase currents from
+//!         the samples.
+//!
+//!         Two errors are tabulated in percent of the current amplitude,
+//!         as the maximum over the angles of each sector.  The sample error
+//!         is the difference to a rebuild from the true phase currents at
+//!         the sample points, it shows windows that are too short for the
+//!         dead time and the amplifier.  The total error is the difference
+//!         to the average phase currents over the PWM period and adds the
+//!         current ripple between the sample points and the period centre,
+//!         which only depends on the motor inductance.  The duty error is
+//!         the difference of the on time of the shifted and the symmetric
+//!         compare values in percent of the period.
+//!
+//!         With -n the compare values are not shifted, which shows where a
+//!         single shunt cannot measure without shifting.  With -c the
+//!         program returns an error when the sample or the duty error
+//!         exceeds its limit.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "sw/modules/svgen/src/32b/svgen.h"
+#include "sw/modules/svgen/src/32b/svgen_1shunt.h"
+
+
+// **************************************************************************
+// the defines
+
+#define SVGEN1SHUNT_CHECK_CLOCK_Hz          (60000000.0)
+#define SVGEN1SHUNT_CHECK_NUM_PERIODS       (30)        // periods to the steady state
+#define SVGEN1SHUNT_CHECK_NUM_ANGLES        (360)
+#define SVGEN1SHUNT_CHECK_NUM_MODS          (9)
+
+#define SVGEN1SHUNT_CHECK_MAX_ERROR_pct     (2.0)       // the limits of -c
+#define SVGEN1SHUNT_CHECK_MAX_DUTY_pct      (1.0)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the inverter and load parameters
+//!
+typedef struct _SVGEN1SHUNT_CHECK_Params_
+{
+  double    pwmFreq_Hz;         //!< the PWM frequency
+  double    Vdc_V;              //!< the dc bus voltage
+  double    Rs_Ohm;             //!< the phase resistance
+  double    Ls_H;               //!< the phase inductance
+  double    current_A;          //!< the current amplitude
+  double    loadAngle_deg;      //!< the angle of the current behind the voltage
+  double    deadTime_sec;       //!< the dead time
+  double    ampTau_sec;         //!< the time constant of the shunt amplifier
+  double    minWidth_sec;       //!< the minimum width of a sample window
+  double    sampleDelay_sec;    //!< the delay from the start of a window to the sample
+  bool      flag_noShift;       //!< do not shift the compare values
+} SVGEN1SHUNT_CHECK_Params;
+
+
+//! \brief Defines the result of one operating point
+//!
+typedef struct _SVGEN1SHUNT_CHECK_Result_
+{
+  SVGEN1SHUNT_Sector_e  sector;
+  double                sampleError_pct;//!< the maximum error to the currents at the sample points
+  double                error_pct;      //!< the maximum error to the average currents
+  double                dutyError_pct;  //!< the maximum duty error of the phases
+  bool                  flag_shifted;
+} SVGEN1SHUNT_CHECK_Result;
+
+
+// **************************************************************************
+// the globals
+
+static const double SVGEN1SHUNT_CHECK_mods[SVGEN1SHUNT_CHECK_NUM_MODS] =
+{
+  0.02, 0.05, 0.1, 0.2, 0.3, 0.5, 0.7, 0.9, 1.0
+};
+
+
+// **************************************************************************
+// the functions
+
+static void SVGEN1SHUNT_CHECK_usage(const char *pName)
+{
+  fprintf(stderr,"usage: %s [-f Hz] [-V V] [-R Ohm] [-L H] [-I A] [-a deg] [-d ns] [-t ns] [-w ns] [-s ns] [-n] [-c]\n",pName);
+  fprintf(stderr,"  -f  PWM frequency, default 45000 Hz\n");
+  fprintf(stderr,"  -V  dc bus voltage, default 11.1 V\n");
+  fprintf(stderr,"  -R  phase resistance, default 0.0839 Ohm\n");
+  fprintf(stderr,"  -L  phase inductance, default 10e-6 H\n");
+  fprintf(stderr,"  -I  current amplitude, default 10 A\n");
+  fprintf(stderr,"  -a  angle of the current behind the voltage, default 30 deg\n");
+  fprintf(stderr,"  -d  dead time, default 200 ns\n");
+  fprintf(stderr,"  -t  shunt amplifier time constant, default 150 ns\n");
+  fprintf(stderr,"  -w  minimum width of a sample window, default 1500 ns\n");
+  fprintf(stderr,"  -s  sample delay, default 1100 ns\n");
+  fprintf(stderr,"  -n  do not shift the compare values\n");
+  fprintf(stderr,"  -c  fail when the sample error exceeds %.1f%% or the duty error %.1f%%\n",
+          SVGEN1SHUNT_CHECK_MAX_ERROR_pct,SVGEN1SHUNT_CHECK_MAX_DUTY_pct);
+
+  return;
+} // end of SVGEN1SHUNT_CHECK_usage() function
+
+
+//! \brief  Runs one operating point
+static void SVGEN1SHUNT_CHECK_run(const SVGEN1SHUNT_CHECK_Params *pParams,
+                                  SVGEN_Handle svgenHandle,
+                                  SVGEN1SHUNT_Handle svgen1shuntHandle,
+                                  const double mod,const double angle_rad,
+                                  SVGEN1SHUNT_CHECK_Result *pResult)
+{
+  SVGEN1SHUNT_Obj *obj = (SVGEN1SHUNT_Obj *)svgen1shuntHandle;
+  uint16_t period = (uint16_t)(SVGEN1SHUNT_CHECK_CLOCK_Hz / (2.0 * pParams->pwmFreq_Hz));
+  double dt_sec = 1.0 / SVGEN1SHUNT_CHECK_CLOCK_Hz;
+  long deadTime_cnts = lround(pParams->deadTime_sec * SVGEN1SHUNT_CHECK_CLOCK_Hz);
+  uint16_t sampleDelay = (uint16_t)lround(pParams->sampleDelay_sec * SVGEN1SHUNT_CHECK_CLOCK_Hz);
+  MATH_vec2 Vab;
+  MATH_vec3 Tabc;
+  MATH_vec3 Iadc,Iideal;
+  uint16_t cmp[3],cmpUp[3],cmpDown[3],trigger[2];
+  double duty[3],dutyMean = 0.0;
+  double current_A[3],emf_V[3],sum_A[3];
+  double sample_A[2] = {0.0,0.0};
+  double ideal_A[2] = {0.0,0.0};
+  double amp_A = 0.0;
+  long lastEdge[3];
+  bool gate_z1[3];
+  int periodNumber,cnt;
+  long t;
+
+
+  // the duties
+  Vab.value[0] = _IQ(mod / sqrt(3.0) * cos(angle_rad));
+  Vab.value[1] = _IQ(mod / sqrt(3.0) * sin(angle_rad));
+  SVGEN_run(svgenHandle,&Vab,&Tabc);
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      double value = (0.5 - _IQtoF(Tabc.value[cnt])) * (double)period;
+
+      cmp[cnt] = (uint16_t)lround(value < 0.0 ? 0.0 : (value > period ? period : value));
+      duty[cnt] = 1.0 - (double)cmp[cnt] / (double)period;
+      dutyMean += duty[cnt] / 3.0;
+    }
+
+  // the shifted compare values
+  SVGEN1SHUNT_run(svgen1shuntHandle,period,cmp[0],cmp[1],cmp[2]);
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      cmpUp[cnt] = pParams->flag_noShift ? cmp[cnt] : obj->cmpUp[cnt];
+      cmpDown[cnt] = pParams->flag_noShift ? cmp[cnt] : obj->cmpDown[cnt];
+    }
+
+  if(pParams->flag_noShift)
+    {
+      trigger[0] = (uint16_t)(cmp[obj->phaseMax] + sampleDelay);
+      trigger[1] = (uint16_t)(cmp[obj->phaseMid] + sampleDelay);
+    }
+  else
+    {
+      trigger[0] = obj->trigger[0];
+      trigger[1] = obj->trigger[1];
+    }
+
+  pResult->sector = obj->sector;
+  pResult->flag_shifted = !pParams->flag_noShift
+                          && ((cmpUp[0] != cmp[0]) || (cmpUp[1] != cmp[1]) || (cmpUp[2] != cmp[2]));
+
+  // the on time error
+  pResult->dutyError_pct = 0.0;
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      double onTime = (double)(2 * period - cmpUp[cnt] - cmpDown[cnt]);
+      double error_pct = fabs(onTime - 2.0 * (period - cmp[cnt])) / (2.0 * period) * 100.0;
+
+      if(error_pct > pResult->dutyError_pct)
+        {
+          pResult->dutyError_pct = error_pct;
+        }
+    }
+
+  // the back emf that holds the current vector at the average voltage, sums to zero
+  for(cnt=0;cnt<3;cnt++)
+    {
+      double phase_rad = angle_rad - (pParams->loadAngle_deg * M_PI / 180.0) - (cnt * 2.0 * M_PI / 3.0);
+
+      current_A[cnt] = pParams->current_A * cos(phase_rad);
+      emf_V[cnt] = pParams->Vdc_V * (duty[cnt] - dutyMean) - (pParams->Rs_Ohm * current_A[cnt]);
+      lastEdge[cnt] = -deadTime_cnts;
+      gate_z1[cnt] = false;
+    }
+
+  // the inverter and the load at the PWM clock
+  for(periodNumber=0;periodNumber<SVGEN1SHUNT_CHECK_NUM_PERIODS;periodNumber++)
+    {
+      bool flag_last = (periodNumber == (SVGEN1SHUNT_CHECK_NUM_PERIODS - 1));
+
+      sum_A[0] = sum_A[1] = sum_A[2] = 0.0;
+
+      for(t=0;t<(2 * (long)period);t++)
+        {
+          long absTime = (long)periodNumber * 2 * period + t;
+          double Vphase_V[3],Vn_V = 0.0,Idc_A = 0.0;
+
+          for(cnt=0;cnt<3;cnt++)
+            {
+              // set on CMPA counting up, clear on CMPB counting down
+              bool gate = (t < period) ? (t >= cmpUp[cnt]) : ((2 * period - t) > cmpDown[cnt]);
+              bool high;
+
+              if(gate != gate_z1[cnt])
+                {
+                  lastEdge[cnt] = absTime;
+                  gate_z1[cnt] = gate;
+                }
+
+              // both switches are off in the dead time and the diodes carry the current
+              if((absTime - lastEdge[cnt]) < deadTime_cnts)
+                {
+                  high = (current_A[cnt] < 0.0);
+                }
+              else
+                {
+                  high = gate;
+                }
+
+              Vphase_V[cnt] = high ? pParams->Vdc_V : 0.0;
+              Vn_V += Vphase_V[cnt] / 3.0;
+
+              if(high)
+                {
+                  Idc_A += current_A[cnt];
+                }
+            }
+
+          // the shunt amplifier
+          amp_A += (Idc_A - amp_A) * (dt_sec / pParams->ampTau_sec);
+
+          if(flag_last)
+            {
+              if((t < period) && (t == trigger[0]))
+                {
+                  sample_A[0] = amp_A;
+                  ideal_A[0] = current_A[obj->phaseMax];
+                }
+
+              if((t < period) && (t == trigger[1]))
+                {
+                  sample_A[1] = amp_A;
+                  ideal_A[1] = -current_A[obj->phaseMin];
+                }
+            }
+
+          for(cnt=0;cnt<3;cnt++)
+            {
+              sum_A[cnt] += current_A[cnt];
+              current_A[cnt] += (Vphase_V[cnt] - Vn_V - emf_V[cnt] - pParams->Rs_Ohm * current_A[cnt])
+                                * (dt_sec / pParams->Ls_H);
+            }
+        }
+    }
+
+  // rebuild the phase currents
+  Iadc.value[0] = _IQ(sample_A[0] / pParams->current_A);
+  Iadc.value[1] = _IQ(sample_A[1] / pParams->current_A);
+  Iadc.value[2] = 0;
+  SVGEN1SHUNT_runRegenCurrent(svgen1shuntHandle,&Iadc);
+
+  // the rebuild from the true currents at the sample points
+  Iideal.value[0] = _IQ(ideal_A[0] / pParams->current_A);
+  Iideal.value[1] = _IQ(ideal_A[1] / pParams->current_A);
+  Iideal.value[2] = 0;
+  SVGEN1SHUNT_runRegenCurrent(svgen1shuntHandle,&Iideal);
+
+  pResult->sampleError_pct = 0.0;
+  pResult->error_pct = 0.0;
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      double average_A = sum_A[cnt] / (2.0 * period);
+      double sampleError_pct = fabs(_IQtoF(Iadc.value[cnt] - Iideal.value[cnt])) * 100.0;
+      double error_pct = fabs(_IQtoF(Iadc.value[cnt]) * pParams->current_A - average_A)
+                         / pParams->current_A * 100.0;
+
+      if(sampleError_pct > pResult->sampleError_pct)
+        {
+          pResult->sampleError_pct = sampleError_pct;
+        }
+
+      if(error_pct > pResult->error_pct)
+        {
+          pResult->error_pct = error_pct;
+        }
+    }
+
+  return;
+} // end of SVGEN1SHUNT_CHECK_run() function
+
+
+int main(int argc,char *argv[])
+{
+  SVGEN1SHUNT_CHECK_Params params =
+  {
+    45000.0, 11.1, 0.0839, 10.0e-6, 10.0, 30.0, 200.0e-9, 150.0e-9, 1500.0e-9, 1100.0e-9, false
+  };
+  SVGEN_Obj svgen;
+  SVGEN1SHUNT_Obj svgen1shunt;
+  SVGEN_Handle svgenHandle;
+  SVGEN1SHUNT_Handle svgen1shuntHandle;
+  double sampleError_pct[SVGEN1SHUNT_CHECK_NUM_MODS][SVGEN1SHUNT_NUM_SECTORS];
+  double error_pct[SVGEN1SHUNT_CHECK_NUM_MODS][SVGEN1SHUNT_NUM_SECTORS];
+  double dutyError_pct[SVGEN1SHUNT_CHECK_NUM_MODS];
+  double shifted_pct[SVGEN1SHUNT_CHECK_NUM_MODS];
+  double maxSampleError_pct = 0.0,maxError_pct = 0.0,maxDutyError_pct = 0.0;
+  bool flag_check = false;
+  int modNumber,angleNumber,sector;
+  int opt;
+
+
+  while((opt = getopt(argc,argv,"f:V:R:L:I:a:d:t:w:s:nch")) != -1)
+    {
+      switch(opt)
+        {
+          case 'f': params.pwmFreq_Hz = atof(optarg); break;
+          case 'V': params.Vdc_V = atof(optarg); break;
+          case 'R': params.Rs_Ohm = atof(optarg); break;
+          case 'L': params.Ls_H = atof(optarg); break;
+          case 'I': params.current_A = atof(optarg); break;
+          case 'a': params.loadAngle_deg = atof(optarg); break;
+          case 'd': params.deadTime_sec = atof(optarg) * 1.0e-9; break;
+          case 't': params.ampTau_sec = atof(optarg) * 1.0e-9; break;
+          case 'w': params.minWidth_sec = atof(optarg) * 1.0e-9; break;
+          case 's': params.sampleDelay_sec = atof(optarg) * 1.0e-9; break;
+          case 'n': params.flag_noShift = true; break;
+          case 'c': flag_check = true; break;
+          default:
+            SVGEN1SHUNT_CHECK_usage(argv[0]);
+            return(2);
+        }
+    }
+
+  if((params.pwmFreq_Hz <= 0.0) || (params.Ls_H <= 0.0) || (params.ampTau_sec <= 0.0) || (params.current_A <= 0.0))
+    {
+      SVGEN1SHUNT_CHECK_usage(argv[0]);
+      return(2);
+    }
+
+  svgenHandle = SVGEN_init(&svgen,sizeof(svgen));
+  SVGEN_setMaxModulation(svgenHandle,SVGEN_MAX_VAB_VOLTAGES);
+
+  svgen1shuntHandle = SVGEN1SHUNT_init(&svgen1shunt,sizeof(svgen1shunt));
+  SVGEN1SHUNT_setParams(svgen1shuntHandle,
+                        (uint16_t)lround(params.minWidth_sec * SVGEN1SHUNT_CHECK_CLOCK_Hz),
+                        (uint16_t)lround(params.sampleDelay_sec * SVGEN1SHUNT_CHECK_CLOCK_Hz));
+
+  for(modNumber=0;modNumber<SVGEN1SHUNT_CHECK_NUM_MODS;modNumber++)
+    {
+      int numShifted = 0;
+
+      for(sector=0;sector<SVGEN1SHUNT_NUM_SECTORS;sector++)
+        {
+          sampleError_pct[modNumber][sector] = 0.0;
+          error_pct[modNumber][sector] = 0.0;
+        }
+
+      dutyError_pct[modNumber] = 0.0;
+
+      for(angleNumber=0;angleNumber<SVGEN1SHUNT_CHECK_NUM_ANGLES;angleNumber++)
+        {
+          SVGEN1SHUNT_CHECK_Result result;
+          double angle_rad = 2.0 * M_PI * angleNumber / SVGEN1SHUNT_CHECK_NUM_ANGLES;
+
+          SVGEN1SHUNT_CHECK_run(&params,svgenHandle,svgen1shuntHandle,
+                                SVGEN1SHUNT_CHECK_mods[modNumber],angle_rad,&result);
+
+          if(result.sampleError_pct > sampleError_pct[modNumber][result.sector])
+            {
+              sampleError_pct[modNumber][result.sector] = result.sampleError_pct;
+            }
+
+          if(result.error_pct > error_pct[modNumber][result.sector])
+            {
+              error_pct[modNumber][result.sector] = result.error_pct;
+            }
+
+          if(result.dutyError_pct > dutyError_pct[modNumber])
+            {
+              dutyError_pct[modNumber] = result.dutyError_pct;
+            }
+
+          if(result.flag_shifted)
+            {
+              numShifted++;
+            }
+
+          if(result.sampleError_pct > maxSampleError_pct)
+            {
+              maxSampleError_pct = result.sampleError_pct;
+            }
+
+          if(result.error_pct > maxError_pct)
+            {
+              maxError_pct = result.error_pct;
+            }
+
+          if(result.dutyError_pct > maxDutyError_pct)
+            {
+              maxDutyError_pct = result.dutyError_pct;
+            }
+        }
+
+      shifted_pct[modNumber] = 100.0 * numShifted / SVGEN1SHUNT_CHECK_NUM_ANGLES;
+    }
+
+  printf("single shunt reconstruction, %.0f Hz PWM, %.1f V, %.0f A at %.0f deg, %s\n",
+         params.pwmFreq_Hz,params.Vdc_V,params.current_A,params.loadAngle_deg,
+         params.flag_noShift ? "no shift" : "shifted");
+  printf("dead time %.0f ns, amplifier %.0f ns, window %.0f ns, sample delay %.0f ns\n\n",
+         params.deadTime_sec * 1.0e9,params.ampTau_sec * 1.0e9,
+         params.minWidth_sec * 1.0e9,params.sampleDelay_sec * 1.0e9);
+
+  printf("max sample error / max total error [%% of current amplitude]\n");
+  printf("   mod");
+
+  for(sector=0;sector<SVGEN1SHUNT_NUM_SECTORS;sector++)
+    {
+      printf("       sector %d",sector + 1);
+    }
+
+  printf("  duty error  shifted\n");
+
+  for(modNumber=0;modNumber<SVGEN1SHUNT_CHECK_NUM_MODS;modNumber++)
+    {
+      printf("%6.2f",SVGEN1SHUNT_CHECK_mods[modNumber]);
+
+      for(sector=0;sector<SVGEN1SHUNT_NUM_SECTORS;sector++)
+        {
+          printf("  %6.2f/%6.2f",sampleError_pct[modNumber][sector],error_pct[modNumber][sector]);
+        }
+
+      printf("  %9.2f%%  %6.1f%%\n",dutyError_pct[modNumber],shifted_pct[modNumber]);
+    }
+
+  printf("\nmax sample error %.2f%%, max total error %.2f%%, max duty error %.2f%%\n",
+         maxSampleError_pct,maxError_pct,maxDutyError_pct);
+
+  if(flag_check)
+    {
+      if((maxSampleError_pct > SVGEN1SHUNT_CHECK_MAX_ERROR_pct) || (maxDutyError_pct > SVGEN1SHUNT_CHECK_MAX_DUTY_pct))
+        {
+          printf("FAIL, limits %.1f%% and %.1f%%\n",SVGEN1SHUNT_CHECK_MAX_ERROR_pct,SVGEN1SHUNT_CHECK_MAX_DUTY_pct);
+          return(1);
+        }
+
+      printf("PASS\n");
+    }
+
+  return(0);
+} // end of main() function
+
+
+// end of file
+
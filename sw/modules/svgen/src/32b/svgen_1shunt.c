@@ -0,0 +1,115 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/svgen/src/32b/svgen_1shunt.c
+//! \brief  Portable C code.  These functions define the
+//!         single shunt current reconstruction (SVGEN1SHUNT) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/svgen/src/32b/svgen_1shunt.h"
+
+
+// **************************************************************************
+// the functions
+
+SVGEN1SHUNT_Handle SVGEN1SHUNT_init(void *pMemory,const size_t numBytes)
+{
+  SVGEN1SHUNT_Handle handle;
+  SVGEN1SHUNT_Obj *obj;
+  uint_least8_t cnt;
+
+
+  if(numBytes < sizeof(SVGEN1SHUNT_Obj))
+    return((SVGEN1SHUNT_Handle)NULL);
+
+  // assign the handle
+  handle = (SVGEN1SHUNT_Handle)pMemory;
+
+  obj = (SVGEN1SHUNT_Obj *)handle;
+
+  obj->minWidth = 0;
+  obj->sampleDelay = 0;
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      obj->cmpUp[cnt] = 0;
+      obj->cmpDown[cnt] = 0;
+    }
+
+  obj->trigger[0] = 0;
+  obj->trigger[1] = 0;
+
+  obj->sector = SVGEN1SHUNT_Sector_1;
+  obj->phaseMax = 0;
+  obj->phaseMid = 1;
+  obj->phaseMin = 2;
+
+  obj->numShifts = 0;
+  obj->numDutyErrors = 0;
+
+  return(handle);
+} // end of SVGEN1SHUNT_init() function
+
+
+void SVGEN1SHUNT_setParams(SVGEN1SHUNT_Handle handle,
+                           const uint16_t minWidth,
+                           const uint16_t sampleDelay)
+{
+  SVGEN1SHUNT_Obj *obj = (SVGEN1SHUNT_Obj *)handle;
+
+
+  obj->minWidth = minWidth;
+
+  // the sample has to start inside the window
+  if(sampleDelay < minWidth)
+    {
+      obj->sampleDelay = sampleDelay;
+    }
+  else if(minWidth > 0)
+    {
+      obj->sampleDelay = minWidth - 1;
+    }
+  else
+    {
+      obj->sampleDelay = 0;
+    }
+
+  return;
+} // end of SVGEN1SHUNT_setParams() function
+
+
+// end of file
+
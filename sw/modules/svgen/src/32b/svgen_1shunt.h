@@ -0,0 +1,419 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _SVGEN1SHUNT_H_
+#define _SVGEN1SHUNT_H_
+
+//! \file   modules/svgen/src/32b/svgen_1shunt.h
+//! \brief  Contains the public interface to the
+//!         single shunt current reconstruction (SVGEN1SHUNT) module routines
+//!
+//!         With a single shunt in the dc link the phase currents are only
+//!         seen while an active vector is applied.  In the up count of an
+//!         up/down counting PWM with the output high above the compare
+//!         value, the phase with the largest duty switches high first:
+//!
+//!           counter  0 ...... c1 ...... c2 ...... c3 ...... PRD
+//!           window              Idc = +Imax  Idc = -Imin
+//!
+//!         c1 <= c2 <= c3 are the sorted compare values of the phases with
+//!         the largest, middle and smallest duty.  Between c1 and c2 only
+//!         the largest duty phase is high and the dc link carries its
+//!         current, between c2 and c3 the smallest duty phase is the only
+//!         one low and the dc link carries its current negated.  The third
+//!         current follows from Ia + Ib + Ic = 0.
+//!
+//!         Near the sector boundaries and at low modulation a window is
+//!         shorter than the time the shunt amplifier needs to settle and
+//!         the ADC needs to sample.  SVGEN1SHUNT_run() then shifts the up
+//!         count compare values apart to open both windows to the minimum
+//!         width and moves the down count compare values the other way,
+//!         so the on time of every phase over the period is unchanged.
+//!         The PWM has to be configured asymmetric, set on CMPA counting up
+//!         and clear on CMPB counting down.  The two ADC start of
+//!         conversions are placed the sample delay after the start of each
+//!         window.
+//!
+//!         A shift the down count cannot compensate, because the down count
+//!         compare would leave the period, leaves a duty error.  It is
+//!         counted but only occurs for duties very close to 0 and 100%.
+//!
+//!         The module sits between the PWM compare values and the HAL,
+//!         in the control ISR:
+//!
+//!           HAL_readAdcData()                   dc link samples in I[0], I[1]
+//!           SVGEN1SHUNT_runRegenCurrent()       phase currents for CLARKE_run()
+//!           ...
+//!           HAL_writePwmData()
+//!           HAL_setTrigger()                    SVGEN1SHUNT_run() on the
+//!                                               compares, writes CMPA, CMPB
+//!                                               and the ADC triggers
+//!
+//!         SVGEN1SHUNT_runRegenCurrent() has to be called before
+//!         SVGEN1SHUNT_run() since the samples were taken with the phase
+//!         order of the compare values written in the previous ISR.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+#include "sw/modules/math/src/32b/math.h"
+
+
+//!
+//!
+//! \defgroup SVGEN1SHUNT SVGEN1SHUNT
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Enumeration for the space vector sectors
+//!
+typedef enum
+{
+  SVGEN1SHUNT_Sector_1=0,     //!< Ta >= Tb >= Tc
+  SVGEN1SHUNT_Sector_2,       //!< Tb >= Ta >= Tc
+  SVGEN1SHUNT_Sector_3,       //!< Tb >= Tc >= Ta
+  SVGEN1SHUNT_Sector_4,       //!< Tc >= Tb >= Ta
+  SVGEN1SHUNT_Sector_5,       //!< Tc >= Ta >= Tb
+  SVGEN1SHUNT_Sector_6,       //!< Ta >= Tc >= Tb
+  SVGEN1SHUNT_NUM_SECTORS
+} SVGEN1SHUNT_Sector_e;
+
+
+//! \brief Defines the single shunt current reconstruction (SVGEN1SHUNT) object
+//!
+typedef struct _SVGEN1SHUNT_Obj_
+{
+  uint16_t              minWidth;       //!< the minimum width of a sample window, PWM counts
+  uint16_t              sampleDelay;    //!< the delay from the start of a window to the sample, PWM counts
+
+  uint16_t              cmpUp[3];       //!< the compare values for the up count, CMPA
+  uint16_t              cmpDown[3];     //!< the compare values for the down count, CMPB
+  uint16_t              trigger[2];     //!< the sample points in the up count
+
+  SVGEN1SHUNT_Sector_e  sector;         //!< the sector of the compare values
+  uint_least8_t         phaseMax;       //!< the phase with the largest duty, sampled in the first window
+  uint_least8_t         phaseMid;       //!< the phase with the middle duty
+  uint_least8_t         phaseMin;       //!< the phase with the smallest duty, sampled in the second window
+
+  uint32_t              numShifts;      //!< the number of periods with shifted compare values
+  uint32_t              numDutyErrors;  //!< the number of periods with an uncompensated shift
+} SVGEN1SHUNT_Obj;
+
+
+//! \brief Defines the SVGEN1SHUNT handle
+//!
+typedef struct _SVGEN1SHUNT_Obj_ *SVGEN1SHUNT_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Gets the compare value for the down count
+//! \param[in] handle    The single shunt current reconstruction (SVGEN1SHUNT) handle
+//! \param[in] phase     The phase, 0 to 2
+//! \return    The compare value, PWM counts
+static inline uint16_t SVGEN1SHUNT_getCmpDown(SVGEN1SHUNT_Handle handle,const uint_least8_t phase)
+{
+  SVGEN1SHUNT_Obj *obj = (SVGEN1SHUNT_Obj *)handle;
+
+  return(obj->cmpDown[phase]);
+} // end of SVGEN1SHUNT_getCmpDown() function
+
+
+//! \brief     Gets the compare value for the up count
+//! \param[in] handle    The single shunt current reconstruction (SVGEN1SHUNT) handle
+//! \param[in] phase     The phase, 0 to 2
+//! \return    The compare value, PWM counts
+static inline uint16_t SVGEN1SHUNT_getCmpUp(SVGEN1SHUNT_Handle handle,const uint_least8_t phase)
+{
+  SVGEN1SHUNT_Obj *obj = (SVGEN1SHUNT_Obj *)handle;
+
+  return(obj->cmpUp[phase]);
+} // end of SVGEN1SHUNT_getCmpUp() function
+
+
+//! \brief     Gets the number of periods with a duty error
+//! \param[in] handle  The single shunt current reconstruction (SVGEN1SHUNT) handle
+//! \return    The number of periods where the down count could not compensate the shift
+static inline uint32_t SVGEN1SHUNT_getNumDutyErrors(SVGEN1SHUNT_Handle handle)
+{
+  SVGEN1SHUNT_Obj *obj = (SVGEN1SHUNT_Obj *)handle;
+
+  return(obj->numDutyErrors);
+} // end of SVGEN1SHUNT_getNumDutyErrors() function
+
+
+//! \brief     Gets the number of periods with shifted compare values
+//! \param[in] handle  The single shunt current reconstruction (SVGEN1SHUNT) handle
+//! \return    The number of periods
+static inline uint32_t SVGEN1SHUNT_getNumShifts(SVGEN1SHUNT_Handle handle)
+{
+  SVGEN1SHUNT_Obj *obj = (SVGEN1SHUNT_Obj *)handle;
+
+  return(obj->numShifts);
+} // end of SVGEN1SHUNT_getNumShifts() function
+
+
+//! \brief     Gets the sector of the last compare values
+//! \param[in] handle  The single shunt current reconstruction (SVGEN1SHUNT) handle
+//! \return    The sector
+static inline SVGEN1SHUNT_Sector_e SVGEN1SHUNT_getSector(SVGEN1SHUNT_Handle handle)
+{
+  SVGEN1SHUNT_Obj *obj = (SVGEN1SHUNT_Obj *)handle;
+
+  return(obj->sector);
+} // end of SVGEN1SHUNT_getSector() function
+
+
+//! \brief     Gets a sample point
+//! \param[in] handle    The single shunt current reconstruction (SVGEN1SHUNT) handle
+//! \param[in] window    The sample window, 0 or 1
+//! \return    The sample point in the up count, PWM counts
+static inline uint16_t SVGEN1SHUNT_getTrigger(SVGEN1SHUNT_Handle handle,const uint_least8_t window)
+{
+  SVGEN1SHUNT_Obj *obj = (SVGEN1SHUNT_Obj *)handle;
+
+  return(obj->trigger[window]);
+} // end of SVGEN1SHUNT_getTrigger() function
+
+
+//! \brief     Initializes the single shunt current reconstruction (SVGEN1SHUNT) module
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The single shunt current reconstruction (SVGEN1SHUNT) handle
+extern SVGEN1SHUNT_Handle SVGEN1SHUNT_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Sets the parameters
+//! \details   The minimum width is the time from the switching edge that
+//!            opens a window until the ADC has finished sampling: dead
+//!            time, switching transient, amplifier settling and the ADC
+//!            acquisition window.  The sample delay is the same without
+//!            the acquisition window.
+//! \param[in] handle       The single shunt current reconstruction (SVGEN1SHUNT) handle
+//! \param[in] minWidth     The minimum width of a sample window, PWM counts
+//! \param[in] sampleDelay  The delay from the start of a window to the sample, PWM counts
+extern void SVGEN1SHUNT_setParams(SVGEN1SHUNT_Handle handle,
+                                  const uint16_t minWidth,
+                                  const uint16_t sampleDelay);
+
+
+//! \brief     Rebuilds the phase currents from the two dc link samples
+//! \details   Uses the phase order of the compare values the samples were
+//!            taken with, so it has to be called before SVGEN1SHUNT_run()
+//!            in the ISR.  The dc link current is positive when it flows
+//!            from the dc bus into the motor.
+//! \param[in] handle    The single shunt current reconstruction (SVGEN1SHUNT) handle
+//! \param[in] pAdcData  The pointer to the currents, the first and second window
+//!                      samples in value[0] and value[1] on input, the phase
+//!                      currents on output
+static inline void SVGEN1SHUNT_runRegenCurrent(SVGEN1SHUNT_Handle handle,MATH_vec3 *pAdcData)
+{
+  SVGEN1SHUNT_Obj *obj = (SVGEN1SHUNT_Obj *)handle;
+  _iq Idc1 = pAdcData->value[0];
+  _iq Idc2 = pAdcData->value[1];
+
+  // first window, only the largest duty phase is high
+  pAdcData->value[obj->phaseMax] = Idc1;
+
+  // second window, only the smallest duty phase is low
+  pAdcData->value[obj->phaseMin] = -Idc2;
+
+  // the currents sum to zero
+  pAdcData->value[obj->phaseMid] = Idc2 - Idc1;
+
+  return;
+} // end of SVGEN1SHUNT_runRegenCurrent() function
+
+
+//! \brief     Shifts the compare values to open both sample windows
+//! \details   Computes the up and down count compare values and the sample
+//!            points from the symmetric compare values of the three phases,
+//!            see the file description.  The period must be at least twice
+//!            the minimum width.
+//! \param[in] handle  The single shunt current reconstruction (SVGEN1SHUNT) handle
+//! \param[in] period  The PWM period register, PWM counts
+//! \param[in] cmp1    The symmetric compare value of phase A
+//! \param[in] cmp2    The symmetric compare value of phase B
+//! \param[in] cmp3    The symmetric compare value of phase C
+static inline void SVGEN1SHUNT_run(SVGEN1SHUNT_Handle handle,const uint16_t period,
+                                   const uint16_t cmp1,const uint16_t cmp2,const uint16_t cmp3)
+{
+  SVGEN1SHUNT_Obj *obj = (SVGEN1SHUNT_Obj *)handle;
+  int32_t minWidth = (int32_t)obj->minWidth;
+  int32_t cmp[3];
+  int32_t cmpLow,cmpMid,cmpHigh;
+  int32_t cmpDown;
+  uint_least8_t phaseMax,phaseMid,phaseMin;
+  uint_least8_t cnt;
+  bool flag_dutyError = false;
+
+
+  cmp[0] = (int32_t)cmp1;
+  cmp[1] = (int32_t)cmp2;
+  cmp[2] = (int32_t)cmp3;
+
+
+  // sort the phases, the smallest compare value is the largest duty
+  if(cmp[0] <= cmp[1])
+    {
+      if(cmp[1] <= cmp[2])
+        {
+          obj->sector = SVGEN1SHUNT_Sector_1;
+          phaseMax = 0; phaseMid = 1; phaseMin = 2;
+        }
+      else if(cmp[0] <= cmp[2])
+        {
+          obj->sector = SVGEN1SHUNT_Sector_6;
+          phaseMax = 0; phaseMid = 2; phaseMin = 1;
+        }
+      else
+        {
+          obj->sector = SVGEN1SHUNT_Sector_5;
+          phaseMax = 2; phaseMid = 0; phaseMin = 1;
+        }
+    }
+  else
+    {
+      if(cmp[0] <= cmp[2])
+        {
+          obj->sector = SVGEN1SHUNT_Sector_2;
+          phaseMax = 1; phaseMid = 0; phaseMin = 2;
+        }
+      else if(cmp[1] <= cmp[2])
+        {
+          obj->sector = SVGEN1SHUNT_Sector_3;
+          phaseMax = 1; phaseMid = 2; phaseMin = 0;
+        }
+      else
+        {
+          obj->sector = SVGEN1SHUNT_Sector_4;
+          phaseMax = 2; phaseMid = 1; phaseMin = 0;
+        }
+    }
+
+  obj->phaseMax = phaseMax;
+  obj->phaseMid = phaseMid;
+  obj->phaseMin = phaseMin;
+
+
+  // keep the middle phase in place unless both windows do not fit around it
+  cmpMid = cmp[phaseMid];
+
+  if(cmpMid < minWidth)
+    {
+      cmpMid = minWidth;
+    }
+  else if(cmpMid > ((int32_t)period - minWidth))
+    {
+      cmpMid = (int32_t)period - minWidth;
+    }
+
+  // open the first window towards zero and the second towards the period
+  cmpLow = cmp[phaseMax];
+
+  if(cmpLow > (cmpMid - minWidth))
+    {
+      cmpLow = cmpMid - minWidth;
+    }
+
+  cmpHigh = cmp[phaseMin];
+
+  if(cmpHigh < (cmpMid + minWidth))
+    {
+      cmpHigh = cmpMid + minWidth;
+    }
+
+  obj->cmpUp[phaseMax] = (uint16_t)cmpLow;
+  obj->cmpUp[phaseMid] = (uint16_t)cmpMid;
+  obj->cmpUp[phaseMin] = (uint16_t)cmpHigh;
+
+  if((cmpLow != cmp[phaseMax]) || (cmpMid != cmp[phaseMid]) || (cmpHigh != cmp[phaseMin]))
+    {
+      obj->numShifts++;
+    }
+
+
+  // the down count keeps the on time, (PRD - up) + (PRD - down) = 2 (PRD - cmp)
+  for(cnt=0;cnt<3;cnt++)
+    {
+      cmpDown = (cmp[cnt] << 1) - (int32_t)obj->cmpUp[cnt];
+
+      if(cmpDown < 0)
+        {
+          cmpDown = 0;
+          flag_dutyError = true;
+        }
+      else if(cmpDown > (int32_t)period)
+        {
+          cmpDown = (int32_t)period;
+          flag_dutyError = true;
+        }
+
+      obj->cmpDown[cnt] = (uint16_t)cmpDown;
+    }
+
+  if(flag_dutyError)
+    {
+      obj->numDutyErrors++;
+    }
+
+
+  // sample at the end of the settling time in each window
+  obj->trigger[0] = (uint16_t)(cmpLow + (int32_t)obj->sampleDelay);
+  obj->trigger[1] = (uint16_t)(cmpMid + (int32_t)obj->sampleDelay);
+
+  return;
+} // end of SVGEN1SHUNT_run() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _SVGEN1SHUNT_H_ definition
+
@@ -0,0 +1,114 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/svgen/src/32b/svgen_dpwm.c
+//! \brief  Portable C code.  These functions define the
+//!         discontinuous PWM (SVGEN_DPWM) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/svgen/src/32b/svgen_dpwm.h"
+
+
+// **************************************************************************
+// the functions
+
+SVGEN_DPWM_Handle SVGEN_DPWM_init(void *pMemory,const size_t numBytes)
+{
+  SVGEN_DPWM_Handle handle;
+  SVGEN_DPWM_Obj *obj;
+
+
+  if(numBytes < sizeof(SVGEN_DPWM_Obj))
+    return((SVGEN_DPWM_Handle)NULL);
+
+  // assign the handle
+  handle = (SVGEN_DPWM_Handle)pMemory;
+
+  obj = (SVGEN_DPWM_Obj *)handle;
+
+  obj->mode = SVGEN_DPWM_Mode_SVPWM;
+  obj->activeMode = SVGEN_DPWM_Mode_SVPWM;
+
+  obj->Tlimit = _IQ(0.5);
+  obj->oneOverTwoTlimit2 = _IQ(2.0);
+  obj->modulationOn2 = _IQ(1.0);
+  obj->modulationOff2 = _IQ(1.0);
+  obj->modulation2 = _IQ(0.0);
+
+  obj->clampPhase = -1;
+
+  obj->lossFilterCoeff = _IQ(1.0);
+  obj->switchedCurrent_pu = _IQ(0.0);
+  obj->totalCurrent_pu = _IQ(0.0);
+
+  return(handle);
+} // end of SVGEN_DPWM_init() function
+
+
+void SVGEN_DPWM_setMode(SVGEN_DPWM_Handle handle,const SVGEN_DPWM_Mode_e mode)
+{
+  SVGEN_DPWM_Obj *obj = (SVGEN_DPWM_Obj *)handle;
+
+  obj->mode = (mode < SVGEN_DPWM_NUM_MODES) ? mode : SVGEN_DPWM_Mode_SVPWM;
+
+  return;
+} // end of SVGEN_DPWM_setMode() function
+
+
+void SVGEN_DPWM_setParams(SVGEN_DPWM_Handle handle,
+                          const _iq dutySpan,
+                          const _iq modulationOn,
+                          const _iq modulationOff,
+                          const _iq lossFilterCoeff)
+{
+  SVGEN_DPWM_Obj *obj = (SVGEN_DPWM_Obj *)handle;
+  _iq Tlimit = dutySpan >> 1;
+
+  obj->Tlimit = Tlimit;
+  obj->oneOverTwoTlimit2 = _IQdiv(_IQ(0.5),_IQmpy(Tlimit,Tlimit));
+
+  obj->modulationOn2 = _IQmpy(modulationOn,modulationOn);
+
+  // the hysteresis keeps the mode from toggling at the threshold
+  obj->modulationOff2 = (modulationOff < modulationOn) ? _IQmpy(modulationOff,modulationOff) : obj->modulationOn2;
+
+  obj->lossFilterCoeff = _IQsat(lossFilterCoeff,_IQ(1.0),_IQ(0.0));
+
+  return;
+} // end of SVGEN_DPWM_setParams() function
+
+
+// end of file
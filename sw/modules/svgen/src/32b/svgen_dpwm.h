@@ -0,0 +1,386 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _SVGEN_DPWM_H_
+#define _SVGEN_DPWM_H_
+
+//! \file   modules/svgen/src/32b/svgen_dpwm.h
+//! \brief  Contains the public interface to the
+//!         discontinuous PWM (SVGEN_DPWM) module routines
+//!
+//!         SVGEN_run() centers the duties with the min-max common mode term
+//!         and every leg switches in every PWM period.  A discontinuous PWM
+//!         chooses the common mode term so one leg sits at 0 or 100% duty
+//!         for 120 degrees of the electrical period in total, the line
+//!         voltages are unchanged and a third of the switching events are
+//!         saved.  The modes differ in where a leg is clamped relative to
+//!         the peak of its phase voltage:
+//!
+//!           DPWM0    60 degrees centered 30 degrees before the peak
+//!           DPWM1    60 degrees centered on the peak
+//!           DPWM2    60 degrees centered 30 degrees after the peak
+//!           DPWM3    the two 30 degree intervals beside the peak
+//!           DPWMMAX  the phase with the largest voltage to the upper rail
+//!           DPWMMIN  the phase with the smallest voltage to the lower rail
+//!
+//!         A leg saves the most switching loss when it is clamped around the
+//!         peak of its current, DPWM1 for currents in phase with the voltage
+//!         and DPWM2 for the lagging currents of a motor at speed.
+//!
+//!         At low modulation the clamped leg doubles the current ripple of
+//!         the other two, the module therefore only clamps above a
+//!         modulation index threshold and uses the duties of SVGEN_run()
+//!         below it.  The modulation index is 1 at the largest voltage the
+//!         space vector modulation reaches without saturation.
+//!
+//!         The module runs on the duties of SVGEN_run() between the
+//!         controller and the HAL:
+//!
+//!           CTRL_run()              space vector duties in Tabc
+//!           SVGEN_DPWM_run()        one leg clamped above the threshold
+//!           HAL_writePwmData()
+//!
+//!         It sums the current magnitudes of the switching legs and of all
+//!         legs, their ratio estimates the switching loss relative to the
+//!         space vector modulation.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/iqmath/src/32b/IQmathLib.h"
+#include "sw/modules/math/src/32b/math.h"
+
+
+//!
+//!
+//! \defgroup SVGEN_DPWM SVGEN_DPWM
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Enumeration for the PWM modes
+//!
+typedef enum
+{
+  SVGEN_DPWM_Mode_SVPWM=0,    //!< the continuous space vector modulation of SVGEN_run()
+  SVGEN_DPWM_Mode_DPWM0,      //!< clamped 60 degrees, centered 30 degrees before the peak
+  SVGEN_DPWM_Mode_DPWM1,      //!< clamped 60 degrees, centered on the peak
+  SVGEN_DPWM_Mode_DPWM2,      //!< clamped 60 degrees, centered 30 degrees after the peak
+  SVGEN_DPWM_Mode_DPWM3,      //!< clamped 2x30 degrees beside the peak
+  SVGEN_DPWM_Mode_DPWMMAX,    //!< clamped 120 degrees to the upper rail
+  SVGEN_DPWM_Mode_DPWMMIN,    //!< clamped 120 degrees to the lower rail
+  SVGEN_DPWM_NUM_MODES
+} SVGEN_DPWM_Mode_e;
+
+
+//! \brief Defines the discontinuous PWM (SVGEN_DPWM) object
+//!
+typedef struct _SVGEN_DPWM_Obj_
+{
+  SVGEN_DPWM_Mode_e  mode;                //!< the mode above the modulation threshold
+  SVGEN_DPWM_Mode_e  activeMode;          //!< the mode of the last run
+
+  _iq                Tlimit;              //!< the Tabc of 0 and 100% duty
+  _iq                oneOverTwoTlimit2;   //!< 1/(2*Tlimit^2), scales the squared modulation index
+  _iq                modulationOn2;       //!< the squared modulation index to start clamping
+  _iq                modulationOff2;      //!< the squared modulation index to stop clamping
+  _iq                modulation2;         //!< the squared modulation index of the last run
+
+  int_least8_t       clampPhase;          //!< the clamped phase of the last run, -1 for none
+
+  _iq                lossFilterCoeff;     //!< the coefficient of the current filters, 0 to 1
+  _iq                switchedCurrent_pu;  //!< the filtered current magnitude of the switching legs, pu
+  _iq                totalCurrent_pu;     //!< the filtered current magnitude of all legs, pu
+} SVGEN_DPWM_Obj;
+
+
+//! \brief Defines the SVGEN_DPWM handle
+//!
+typedef struct _SVGEN_DPWM_Obj_ *SVGEN_DPWM_Handle;
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Gets the mode of the last run
+//! \param[in] handle  The discontinuous PWM (SVGEN_DPWM) handle
+//! \return    The mode, SVGEN_DPWM_Mode_SVPWM below the modulation threshold
+static inline SVGEN_DPWM_Mode_e SVGEN_DPWM_getActiveMode(SVGEN_DPWM_Handle handle)
+{
+  SVGEN_DPWM_Obj *obj = (SVGEN_DPWM_Obj *)handle;
+
+  return(obj->activeMode);
+} // end of SVGEN_DPWM_getActiveMode() function
+
+
+//! \brief     Gets the clamped phase of the last run
+//! \param[in] handle  The discontinuous PWM (SVGEN_DPWM) handle
+//! \return    The phase, 0 to 2, or -1 when no phase is clamped
+static inline int_least8_t SVGEN_DPWM_getClampPhase(SVGEN_DPWM_Handle handle)
+{
+  SVGEN_DPWM_Obj *obj = (SVGEN_DPWM_Obj *)handle;
+
+  return(obj->clampPhase);
+} // end of SVGEN_DPWM_getClampPhase() function
+
+
+//! \brief     Gets the mode above the modulation threshold
+//! \param[in] handle  The discontinuous PWM (SVGEN_DPWM) handle
+//! \return    The mode
+static inline SVGEN_DPWM_Mode_e SVGEN_DPWM_getMode(SVGEN_DPWM_Handle handle)
+{
+  SVGEN_DPWM_Obj *obj = (SVGEN_DPWM_Obj *)handle;
+
+  return(obj->mode);
+} // end of SVGEN_DPWM_getMode() function
+
+
+//! \brief     Gets the modulation index of the last run
+//! \details   Takes a square root, call it from the background
+//! \param[in] handle  The discontinuous PWM (SVGEN_DPWM) handle
+//! \return    The modulation index, 1 at the largest unsaturated voltage
+static inline _iq SVGEN_DPWM_getModulation(SVGEN_DPWM_Handle handle)
+{
+  SVGEN_DPWM_Obj *obj = (SVGEN_DPWM_Obj *)handle;
+
+  return(_IQsqrt(obj->modulation2));
+} // end of SVGEN_DPWM_getModulation() function
+
+
+//! \brief     Gets the filtered current magnitude of the switching legs
+//! \param[in] handle  The discontinuous PWM (SVGEN_DPWM) handle
+//! \return    The sum of the current magnitudes of the legs that switch, pu
+static inline _iq SVGEN_DPWM_getSwitchedCurrent_pu(SVGEN_DPWM_Handle handle)
+{
+  SVGEN_DPWM_Obj *obj = (SVGEN_DPWM_Obj *)handle;
+
+  return(obj->switchedCurrent_pu);
+} // end of SVGEN_DPWM_getSwitchedCurrent_pu() function
+
+
+//! \brief     Gets the filtered current magnitude of all legs
+//! \details   The switched current of the space vector modulation
+//! \param[in] handle  The discontinuous PWM (SVGEN_DPWM) handle
+//! \return    The sum of the current magnitudes of the three legs, pu
+static inline _iq SVGEN_DPWM_getTotalCurrent_pu(SVGEN_DPWM_Handle handle)
+{
+  SVGEN_DPWM_Obj *obj = (SVGEN_DPWM_Obj *)handle;
+
+  return(obj->totalCurrent_pu);
+} // end of SVGEN_DPWM_getTotalCurrent_pu() function
+
+
+//! \brief     Initializes the discontinuous PWM (SVGEN_DPWM) module
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The discontinuous PWM (SVGEN_DPWM) handle
+extern SVGEN_DPWM_Handle SVGEN_DPWM_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Sets the mode above the modulation threshold
+//! \param[in] handle  The discontinuous PWM (SVGEN_DPWM) handle
+//! \param[in] mode    The mode, SVGEN_DPWM_Mode_SVPWM never clamps
+extern void SVGEN_DPWM_setMode(SVGEN_DPWM_Handle handle,const SVGEN_DPWM_Mode_e mode);
+
+
+//! \brief     Sets the parameters
+//! \details   The duty span is the change of Tabc from 0 to 100% duty, 1.0
+//!            for HALs mapping Tabc from -0.5 to 0.5 and 2.0 for HALs mapping
+//!            Tabc from -1.0 to 1.0.  The module clamps above modulationOn
+//!            and returns to the space vector modulation below modulationOff.
+//! \param[in] handle           The discontinuous PWM (SVGEN_DPWM) handle
+//! \param[in] dutySpan         The change of Tabc from 0 to 100% duty
+//! \param[in] modulationOn     The modulation index to start clamping
+//! \param[in] modulationOff    The modulation index to stop clamping, below modulationOn
+//! \param[in] lossFilterCoeff  The coefficient of the current filters, the run rate over the filter bandwidth, 0 to 1
+extern void SVGEN_DPWM_setParams(SVGEN_DPWM_Handle handle,
+                                 const _iq dutySpan,
+                                 const _iq modulationOn,
+                                 const _iq modulationOff,
+                                 const _iq lossFilterCoeff);
+
+
+//! \brief     Runs the discontinuous PWM
+//! \param[in] handle  The discontinuous PWM (SVGEN_DPWM) handle
+//! \param[in] pIabc   The pointer to the phase currents, pu
+//! \param[in] pTabc   The pointer to the duties of SVGEN_run(), changed in place
+static inline void SVGEN_DPWM_run(SVGEN_DPWM_Handle handle,
+                                  const MATH_vec3 *pIabc,
+                                  MATH_vec3 *pTabc)
+{
+  SVGEN_DPWM_Obj *obj = (SVGEN_DPWM_Obj *)handle;
+  SVGEN_DPWM_Mode_e mode;
+  _iq Vabc[3];
+  _iq Vcom;
+  _iq sumV2 = _IQ(0.0);
+  _iq switchedCurrent = _IQ(0.0);
+  _iq totalCurrent = _IQ(0.0);
+  int_least8_t clampPhase = -1;
+  bool flag_upper = true;
+  uint_least8_t phaseMax = 0;
+  uint_least8_t phaseMin = 0;
+  uint_least8_t cnt;
+
+
+  // remove the common mode term to get the phase voltages
+  Vcom = _IQmpy(pTabc->value[0] + pTabc->value[1] + pTabc->value[2],_IQ(1.0/3.0));
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      Vabc[cnt] = pTabc->value[cnt] - Vcom;
+      sumV2 += _IQmpy(Vabc[cnt],Vabc[cnt]);
+
+      if(Vabc[cnt] > Vabc[phaseMax])
+        {
+          phaseMax = cnt;
+        }
+
+      if(Vabc[cnt] < Vabc[phaseMin])
+        {
+          phaseMin = cnt;
+        }
+    }
+
+  // the magnitude is sqrt(2/3*sumV2), 2*Tlimit/sqrt(3) at modulation index 1
+  obj->modulation2 = _IQmpy(sumV2,obj->oneOverTwoTlimit2);
+
+  if(obj->activeMode == SVGEN_DPWM_Mode_SVPWM)
+    {
+      mode = (obj->modulation2 > obj->modulationOn2) ? obj->mode : SVGEN_DPWM_Mode_SVPWM;
+    }
+  else
+    {
+      mode = (obj->modulation2 < obj->modulationOff2) ? SVGEN_DPWM_Mode_SVPWM : obj->mode;
+    }
+
+  switch(mode)
+    {
+      case SVGEN_DPWM_Mode_DPWM0:
+      case SVGEN_DPWM_Mode_DPWM2:
+        {
+          // the line voltages are the phase voltages shifted by -30 or +30 degrees,
+          // clamp the phase of the largest line voltage magnitude
+          _iq maxMag = _IQ(-1.0);
+          uint_least8_t other = (mode == SVGEN_DPWM_Mode_DPWM0) ? 1 : 2;
+
+          for(cnt=0;cnt<3;cnt++)
+            {
+              _iq Vline = Vabc[cnt] - Vabc[(cnt + other) % 3];
+              _iq mag = _IQabs(Vline);
+
+              if(mag > maxMag)
+                {
+                  maxMag = mag;
+                  clampPhase = (int_least8_t)cnt;
+                  flag_upper = (Vline >= _IQ(0.0));
+                }
+            }
+        }
+        break;
+
+      case SVGEN_DPWM_Mode_DPWM1:
+        flag_upper = ((Vabc[phaseMax] + Vabc[phaseMin]) >= _IQ(0.0));
+        clampPhase = (int_least8_t)(flag_upper ? phaseMax : phaseMin);
+        break;
+
+      case SVGEN_DPWM_Mode_DPWM3:
+        flag_upper = ((Vabc[phaseMax] + Vabc[phaseMin]) < _IQ(0.0));
+        clampPhase = (int_least8_t)(flag_upper ? phaseMax : phaseMin);
+        break;
+
+      case SVGEN_DPWM_Mode_DPWMMAX:
+        flag_upper = true;
+        clampPhase = (int_least8_t)phaseMax;
+        break;
+
+      case SVGEN_DPWM_Mode_DPWMMIN:
+        flag_upper = false;
+        clampPhase = (int_least8_t)phaseMin;
+        break;
+
+      default:
+        // keep the duties of SVGEN_run()
+        mode = SVGEN_DPWM_Mode_SVPWM;
+        break;
+    }
+
+  if(clampPhase >= 0)
+    {
+      Vcom = (flag_upper ? obj->Tlimit : -obj->Tlimit) - Vabc[clampPhase];
+
+      for(cnt=0;cnt<3;cnt++)
+        {
+          pTabc->value[cnt] = Vabc[cnt] + Vcom;
+        }
+    }
+
+  for(cnt=0;cnt<3;cnt++)
+    {
+      _iq current = _IQabs(pIabc->value[cnt]);
+
+      totalCurrent += current;
+
+      if((int_least8_t)cnt != clampPhase)
+        {
+          switchedCurrent += current;
+        }
+    }
+
+  obj->switchedCurrent_pu += _IQmpy(obj->lossFilterCoeff,switchedCurrent - obj->switchedCurrent_pu);
+  obj->totalCurrent_pu += _IQmpy(obj->lossFilterCoeff,totalCurrent - obj->totalCurrent_pu);
+
+  obj->activeMode = mode;
+  obj->clampPhase = clampPhase;
+
+  return;
+} // end of SVGEN_DPWM_run() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+
+#endif // end of _SVGEN_DPWM_H_ definition
+
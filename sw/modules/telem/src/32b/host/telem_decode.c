@@ -0,0 +1,782 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/telem/src/32b/host/telem_decode.c
+//! \brief  Decodes the frames of the serial telemetry (TELEM) module
+//!
+//!         The frames are read from a file, a serial port or a pseudo
+//!         terminal.  With -p the decoder opens a pseudo terminal and prints
+//!         its name, the host simulator then writes the SCIA output to it
+//!         (proj_lab05b_sim -u <name>).
+//!
+//!         The telemetry channels are written as CSV to the standard output,
+//!         one line per key or delta frame.  The frames of a TRIGLOG capture
+//!         are written to the file given with -l.  The frame, CRC error and
+//!         sequence gap counts are printed at the end.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "sw/modules/telem/src/32b/telem.h"
+
+
+// **************************************************************************
+// the defines
+
+#define TELEM_DECODE_MAX_ENCODED_BYTES  (TELEM_TX_BUF_SIZE)
+#define TELEM_DECODE_MAX_LOG_CHANNELS   (TRIGLOG_MAX_CHANNELS)
+#define TELEM_DECODE_MAX_NAME_LENGTH    (32)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the state of the decoder
+//!
+typedef struct _TELEM_DECODE_Obj_
+{
+  uint8_t   encoded[TELEM_DECODE_MAX_ENCODED_BYTES];  //!< the bytes of the current frame
+  uint32_t  numEncoded;         //!< the number of bytes of the current frame
+  bool      flag_overrun;       //!< denotes that the current frame is too long
+
+  int32_t   value[TELEM_MAX_CHANNELS];  //!< the channel values
+  uint32_t  numChannels;        //!< the number of channels of the last key frame
+  bool      flag_sync;          //!< denotes that the values are valid
+  uint8_t   seqNumber_z1;       //!< the sequence number of the previous frame
+
+  char      name[TELEM_MAX_CHANNELS][TELEM_DECODE_MAX_NAME_LENGTH];  //!< the column names
+  int       qFmt[TELEM_MAX_CHANNELS];   //!< the IQ format of the columns, 0 for integers
+  uint32_t  numNames;           //!< the number of named columns
+  bool      flag_headerDone;    //!< denotes that the CSV header was written
+
+  FILE      *pLogFile;          //!< the file of the TRIGLOG captures
+  uint32_t  numLogCaptures;     //!< the number of captures received
+
+  uint32_t  numFrames;          //!< the number of telemetry frames
+  uint32_t  numKeyFrames;       //!< the number of key frames
+  uint32_t  numLogFrames;       //!< the number of TRIGLOG frames
+  uint32_t  numCrcErrors;       //!< the number of frames with a CRC or length error
+  uint32_t  numGaps;            //!< the number of sequence gaps
+  uint32_t  numLost;            //!< the number of frames missed in the gaps
+  uint64_t  numBytes;           //!< the number of bytes received
+  uint32_t  time_usec_first;    //!< the time of the first telemetry frame
+  uint32_t  time_usec_last;     //!< the time of the last telemetry frame
+} TELEM_DECODE_Obj;
+
+
+// **************************************************************************
+// the globals
+
+static volatile sig_atomic_t TELEM_DECODE_flag_stop = 0;
+
+
+// **************************************************************************
+// the functions
+
+static void TELEM_DECODE_usage(const char *pName)
+{
+  fprintf(stderr,"usage: %s [-p | -b baud] [-f name[:q],...] [-l file.csv] [<input>]\n",pName);
+  fprintf(stderr,"  <input>  file or serial port with the frames, the standard input if none\n");
+  fprintf(stderr,"  -p       open a pseudo terminal and print its name on the standard error\n");
+  fprintf(stderr,"  -b       baud rate of a serial port input\n");
+  fprintf(stderr,"  -f       names of the channels after the time, :q scales an IQ value\n");
+  fprintf(stderr,"           by 2^-q, e.g. -f Speed_krpm:24,Torque_Nm:24,VdcBus_kV:24,Iq_A:24,State\n");
+  fprintf(stderr,"  -l       write the TRIGLOG captures to this file\n");
+
+  return;
+} // end of TELEM_DECODE_usage() function
+
+
+static void TELEM_DECODE_stop(int sig)
+{
+  (void)sig;
+  TELEM_DECODE_flag_stop = 1;
+
+  return;
+} // end of TELEM_DECODE_stop() function
+
+
+//! \brief  Computes the CRC-16/CCITT-FALSE as TELEM_computeCrc() does
+static uint16_t TELEM_DECODE_computeCrc(const uint8_t *pData,const uint32_t numBytes)
+{
+  uint16_t crc = 0xFFFF;
+  uint32_t cnt;
+  int bit;
+
+  for(cnt=0;cnt<numBytes;cnt++)
+    {
+      crc ^= (uint16_t)pData[cnt] << 8;
+
+      for(bit=0;bit<8;bit++)
+        {
+          crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+
+  return(crc);
+} // end of TELEM_DECODE_computeCrc() function
+
+
+//! \brief  Decodes a COBS encoded frame without the delimiter
+//! \return The number of decoded bytes, -1 for an invalid frame
+static int TELEM_DECODE_cobs(const uint8_t *pIn,const uint32_t numIn,uint8_t *pOut)
+{
+  uint32_t inIndex = 0;
+  int numOut = 0;
+
+  while(inIndex < numIn)
+    {
+      uint32_t code = pIn[inIndex++];
+      uint32_t cnt;
+
+      if((code == 0) || ((inIndex + code - 1) > numIn))
+        {
+          return(-1);
+        }
+
+      for(cnt=1;cnt<code;cnt++)
+        {
+          pOut[numOut++] = pIn[inIndex++];
+        }
+
+      // a code below 0xFF stands for a zero, except after the last block
+      if((code < 0xFF) && (inIndex < numIn))
+        {
+          pOut[numOut++] = 0;
+        }
+    }
+
+  return(numOut);
+} // end of TELEM_DECODE_cobs() function
+
+
+static uint32_t TELEM_DECODE_getU16(const uint8_t *pData)
+{
+  return((uint32_t)pData[0] | ((uint32_t)pData[1] << 8));
+} // end of TELEM_DECODE_getU16() function
+
+
+static uint32_t TELEM_DECODE_getU32(const uint8_t *pData)
+{
+  return((uint32_t)pData[0] | ((uint32_t)pData[1] << 8) |
+         ((uint32_t)pData[2] << 16) | ((uint32_t)pData[3] << 24));
+} // end of TELEM_DECODE_getU32() function
+
+
+static void TELEM_DECODE_printValue(FILE *pFile,const int32_t value,const int qFmt)
+{
+  if(qFmt > 0)
+    {
+      fprintf(pFile,",%.6f",(double)value / (double)((uint64_t)1 << qFmt));
+    }
+  else
+    {
+      fprintf(pFile,",%ld",(long)value);
+    }
+
+  return;
+} // end of TELEM_DECODE_printValue() function
+
+
+static void TELEM_DECODE_writeTelemetry(TELEM_DECODE_Obj *obj)
+{
+  uint32_t channelNumber;
+
+  if(!obj->flag_headerDone)
+    {
+      printf("time_usec");
+
+      for(channelNumber=1;channelNumber<obj->numChannels;channelNumber++)
+        {
+          if((channelNumber - 1) < obj->numNames)
+            {
+              printf(",%s",obj->name[channelNumber - 1]);
+            }
+          else
+            {
+              printf(",ch%lu",(unsigned long)channelNumber);
+            }
+        }
+
+      printf("\n");
+      obj->flag_headerDone = true;
+    }
+
+  printf("%lu",(unsigned long)(uint32_t)obj->value[0]);
+
+  for(channelNumber=1;channelNumber<obj->numChannels;channelNumber++)
+    {
+      int qFmt = ((channelNumber - 1) < obj->numNames) ? obj->qFmt[channelNumber - 1] : 0;
+
+      TELEM_DECODE_printValue(stdout,obj->value[channelNumber],qFmt);
+    }
+
+  printf("\n");
+
+  if(obj->numFrames == 1)
+    {
+      obj->time_usec_first = (uint32_t)obj->value[0];
+    }
+
+  obj->time_usec_last = (uint32_t)obj->value[0];
+
+  return;
+} // end of TELEM_DECODE_writeTelemetry() function
+
+
+//! \brief  Checks the sequence number of a key or delta frame
+//! \return true when no frame was missed
+static bool TELEM_DECODE_checkSeq(TELEM_DECODE_Obj *obj,const uint8_t seqNumber)
+{
+  uint8_t numMissed = (uint8_t)(seqNumber - obj->seqNumber_z1 - 1);
+
+  obj->seqNumber_z1 = seqNumber;
+
+  if(obj->flag_sync && (numMissed != 0))
+    {
+      obj->numGaps++;
+      obj->numLost += numMissed;
+
+      return(false);
+    }
+
+  return(true);
+} // end of TELEM_DECODE_checkSeq() function
+
+
+static void TELEM_DECODE_runKey(TELEM_DECODE_Obj *obj,const uint8_t *pData,const uint32_t numBytes)
+{
+  uint32_t numChannels;
+  uint32_t channelNumber;
+
+  if(numBytes < 1)
+    {
+      obj->numCrcErrors++;
+      return;
+    }
+
+  numChannels = pData[0];
+
+  if((numChannels == 0) || (numChannels > TELEM_MAX_CHANNELS) ||
+     (numBytes != (1 + (numChannels * 4))))
+    {
+      obj->numCrcErrors++;
+      return;
+    }
+
+  for(channelNumber=0;channelNumber<numChannels;channelNumber++)
+    {
+      obj->value[channelNumber] = (int32_t)TELEM_DECODE_getU32(&pData[1 + (channelNumber * 4)]);
+    }
+
+  obj->numChannels = numChannels;
+  obj->flag_sync = true;
+  obj->numFrames++;
+  obj->numKeyFrames++;
+
+  TELEM_DECODE_writeTelemetry(obj);
+
+  return;
+} // end of TELEM_DECODE_runKey() function
+
+
+static void TELEM_DECODE_runDelta(TELEM_DECODE_Obj *obj,const uint8_t *pData,const uint32_t numBytes)
+{
+  int32_t value[TELEM_MAX_CHANNELS];
+  uint32_t index = 0;
+  uint32_t channelNumber;
+
+  for(channelNumber=0;channelNumber<obj->numChannels;channelNumber++)
+    {
+      uint32_t zigzag = 0;
+      int shift = 0;
+      int32_t delta;
+
+      do
+        {
+          if((index >= numBytes) || (shift > 28))
+            {
+              obj->numCrcErrors++;
+              obj->flag_sync = false;
+              return;
+            }
+
+          zigzag |= (uint32_t)(pData[index] & 0x7F) << shift;
+          shift += 7;
+        } while(pData[index++] & 0x80);
+
+      delta = (int32_t)((zigzag >> 1) ^ (uint32_t)(-(int32_t)(zigzag & 1)));
+      value[channelNumber] = (int32_t)((uint32_t)obj->value[channelNumber] + (uint32_t)delta);
+    }
+
+  if(index != numBytes)
+    {
+      obj->numCrcErrors++;
+      obj->flag_sync = false;
+      return;
+    }
+
+  memcpy(obj->value,value,obj->numChannels * sizeof(int32_t));
+  obj->numFrames++;
+
+  TELEM_DECODE_writeTelemetry(obj);
+
+  return;
+} // end of TELEM_DECODE_runDelta() function
+
+
+static void TELEM_DECODE_runLog(TELEM_DECODE_Obj *obj,const uint8_t *pData,const uint32_t numBytes)
+{
+  uint32_t frameNumber,numFrames,trigFrameNumber,numChannels,trigSource;
+  int32_t trigValue;
+  uint32_t channelNumber;
+
+  if(numBytes < 12)
+    {
+      obj->numCrcErrors++;
+      return;
+    }
+
+  frameNumber = TELEM_DECODE_getU16(&pData[0]);
+  numFrames = TELEM_DECODE_getU16(&pData[2]);
+  trigFrameNumber = TELEM_DECODE_getU16(&pData[4]);
+  numChannels = pData[6];
+  trigSource = pData[7];
+  trigValue = (int32_t)TELEM_DECODE_getU32(&pData[8]);
+
+  if((numChannels > TELEM_DECODE_MAX_LOG_CHANNELS) || (numBytes != (12 + (numChannels * 4))))
+    {
+      obj->numCrcErrors++;
+      return;
+    }
+
+  obj->numLogFrames++;
+
+  if(frameNumber == 0)
+    {
+      obj->numLogCaptures++;
+      fprintf(stderr,"TRIGLOG capture %lu: %lu frames, trigger at frame %lu, source %lu, value %ld\n",
+              (unsigned long)obj->numLogCaptures,(unsigned long)numFrames,
+              (unsigned long)trigFrameNumber,(unsigned long)trigSource,(long)trigValue);
+    }
+
+  if(obj->pLogFile == NULL)
+    {
+      return;
+    }
+
+  if((frameNumber == 0) && (obj->numLogCaptures == 1))
+    {
+      fprintf(obj->pLogFile,"capture,frame,trigFrame,trigSource,trigValue");
+
+      for(channelNumber=0;channelNumber<numChannels;channelNumber++)
+        {
+          fprintf(obj->pLogFile,",ch%lu",(unsigned long)channelNumber);
+        }
+
+      fprintf(obj->pLogFile,"\n");
+    }
+
+  fprintf(obj->pLogFile,"%lu,%lu,%lu,%lu,%ld",(unsigned long)obj->numLogCaptures,
+          (unsigned long)frameNumber,(unsigned long)trigFrameNumber,
+          (unsigned long)trigSource,(long)trigValue);
+
+  for(channelNumber=0;channelNumber<numChannels;channelNumber++)
+    {
+      fprintf(obj->pLogFile,",%ld",(long)(int32_t)TELEM_DECODE_getU32(&pData[12 + (channelNumber * 4)]));
+    }
+
+  fprintf(obj->pLogFile,"\n");
+
+  return;
+} // end of TELEM_DECODE_runLog() function
+
+
+//! \brief  Decodes one frame, the bytes between two delimiters
+static void TELEM_DECODE_runFrame(TELEM_DECODE_Obj *obj)
+{
+  uint8_t frame[TELEM_DECODE_MAX_ENCODED_BYTES];
+  int numBytes;
+  uint16_t crc;
+
+  if(obj->numEncoded == 0)
+    {
+      return;
+    }
+
+  numBytes = obj->flag_overrun ? -1 : TELEM_DECODE_cobs(obj->encoded,obj->numEncoded,frame);
+
+  if(numBytes < 4)
+    {
+      obj->numCrcErrors++;
+      return;
+    }
+
+  crc = TELEM_DECODE_computeCrc(frame,numBytes - 2);
+
+  if(crc != (((uint16_t)frame[numBytes - 2] << 8) | frame[numBytes - 1]))
+    {
+      obj->numCrcErrors++;
+      return;
+    }
+
+  numBytes -= 2;
+
+  switch(frame[0])
+    {
+      case TELEM_FRAME_KEY:
+        TELEM_DECODE_checkSeq(obj,frame[1]);
+        TELEM_DECODE_runKey(obj,&frame[2],numBytes - 2);
+        break;
+      case TELEM_FRAME_DELTA:
+        // a delta frame needs the previous values
+        if(!TELEM_DECODE_checkSeq(obj,frame[1]))
+          {
+            obj->flag_sync = false;
+          }
+
+        if(obj->flag_sync)
+          {
+            TELEM_DECODE_runDelta(obj,&frame[2],numBytes - 2);
+          }
+        break;
+      case TELEM_FRAME_LOG:
+        TELEM_DECODE_runLog(obj,&frame[2],numBytes - 2);
+        break;
+      default:
+        obj->numCrcErrors++;
+        break;
+    }
+
+  return;
+} // end of TELEM_DECODE_runFrame() function
+
+
+static void TELEM_DECODE_run(TELEM_DECODE_Obj *obj,const uint8_t *pData,const size_t numBytes)
+{
+  size_t cnt;
+
+  obj->numBytes += numBytes;
+
+  for(cnt=0;cnt<numBytes;cnt++)
+    {
+      if(pData[cnt] == 0)
+        {
+          TELEM_DECODE_runFrame(obj);
+          obj->numEncoded = 0;
+          obj->flag_overrun = false;
+        }
+      else if(obj->numEncoded < TELEM_DECODE_MAX_ENCODED_BYTES)
+        {
+          obj->encoded[obj->numEncoded++] = pData[cnt];
+        }
+      else
+        {
+          obj->flag_overrun = true;
+        }
+    }
+
+  return;
+} // end of TELEM_DECODE_run() function
+
+
+static bool TELEM_DECODE_parseNames(TELEM_DECODE_Obj *obj,const char *pNames)
+{
+  const char *pName = pNames;
+
+  while((*pName != '\0') && (obj->numNames < (TELEM_MAX_CHANNELS - 1)))
+    {
+      size_t length = strcspn(pName,",");
+      size_t nameLength = strcspn(pName,",:");
+      int qFmt = 0;
+
+      if((nameLength == 0) || (nameLength >= TELEM_DECODE_MAX_NAME_LENGTH))
+        {
+          return(false);
+        }
+
+      if(nameLength < length)
+        {
+          qFmt = atoi(&pName[nameLength + 1]);
+
+          if((qFmt < 1) || (qFmt > 31))
+            {
+              return(false);
+            }
+        }
+
+      memcpy(obj->name[obj->numNames],pName,nameLength);
+      obj->name[obj->numNames][nameLength] = '\0';
+      obj->qFmt[obj->numNames] = qFmt;
+      obj->numNames++;
+
+      pName += length;
+
+      if(*pName == ',')
+        {
+          pName++;
+        }
+    }
+
+  return(true);
+} // end of TELEM_DECODE_parseNames() function
+
+
+static speed_t TELEM_DECODE_getSpeed(const long baudRate)
+{
+  switch(baudRate)
+    {
+      case 9600:    return(B9600);
+      case 19200:   return(B19200);
+      case 38400:   return(B38400);
+      case 57600:   return(B57600);
+      case 115200:  return(B115200);
+      case 230400:  return(B230400);
+      case 460800:  return(B460800);
+      case 500000:  return(B500000);
+      case 921600:  return(B921600);
+      case 1000000: return(B1000000);
+      default:      return(B0);
+    }
+} // end of TELEM_DECODE_getSpeed() function
+
+
+//! \brief  Sets a terminal to pass the bytes unchanged
+static int TELEM_DECODE_setRaw(const int fd,const speed_t speed)
+{
+  struct termios tio;
+
+  if(tcgetattr(fd,&tio) != 0)
+    {
+      return(-1);
+    }
+
+  cfmakeraw(&tio);
+  tio.c_cflag |= CLOCAL | CREAD;
+  tio.c_cc[VMIN] = 1;
+  tio.c_cc[VTIME] = 0;
+
+  if(speed != B0)
+    {
+      cfsetispeed(&tio,speed);
+      cfsetospeed(&tio,speed);
+    }
+
+  return(tcsetattr(fd,TCSANOW,&tio));
+} // end of TELEM_DECODE_setRaw() function
+
+
+//! \brief  Opens a pseudo terminal and returns the file descriptor of the master
+static int TELEM_DECODE_openPty(void)
+{
+  int fd = posix_openpt(O_RDWR | O_NOCTTY);
+  const char *pSlaveName;
+  int slaveFd;
+
+  if((fd < 0) || (grantpt(fd) != 0) || (unlockpt(fd) != 0) ||
+     ((pSlaveName = ptsname(fd)) == NULL))
+    {
+      perror("pseudo terminal");
+      return(-1);
+    }
+
+  // the writer gets a raw terminal even when it does not set it up itself
+  slaveFd = open(pSlaveName,O_RDWR | O_NOCTTY);
+
+  if(slaveFd >= 0)
+    {
+      TELEM_DECODE_setRaw(slaveFd,B0);
+      close(slaveFd);
+    }
+
+  TELEM_DECODE_setRaw(fd,B0);
+
+  fprintf(stderr,"%s\n",pSlaveName);
+
+  return(fd);
+} // end of TELEM_DECODE_openPty() function
+
+
+int main(int argc,char *argv[])
+{
+  static TELEM_DECODE_Obj decode;
+  TELEM_DECODE_Obj *obj = &decode;
+  const char *pLogFileName = NULL;
+  bool flag_pty = false;
+  long baudRate = 0;
+  uint8_t buffer[4096];
+  int fd = STDIN_FILENO;
+  int opt;
+
+  while((opt = getopt(argc,argv,"pb:f:l:h")) != -1)
+    {
+      switch(opt)
+        {
+          case 'p':
+            flag_pty = true;
+            break;
+          case 'b':
+            baudRate = strtol(optarg,NULL,0);
+            if(TELEM_DECODE_getSpeed(baudRate) == B0)
+              {
+                fprintf(stderr,"unsupported baud rate %ld\n",baudRate);
+                return(EXIT_FAILURE);
+              }
+            break;
+          case 'f':
+            if(!TELEM_DECODE_parseNames(obj,optarg))
+              {
+                fprintf(stderr,"invalid channel names %s\n",optarg);
+                return(EXIT_FAILURE);
+              }
+            break;
+          case 'l':
+            pLogFileName = optarg;
+            break;
+          default:
+            TELEM_DECODE_usage(argv[0]);
+            return(EXIT_FAILURE);
+        }
+    }
+
+  if((flag_pty && (optind < argc)) || ((argc - optind) > 1))
+    {
+      TELEM_DECODE_usage(argv[0]);
+      return(EXIT_FAILURE);
+    }
+
+  if(flag_pty)
+    {
+      fd = TELEM_DECODE_openPty();
+    }
+  else if(optind < argc)
+    {
+      fd = open(argv[optind],O_RDONLY | O_NOCTTY);
+
+      if((fd >= 0) && isatty(fd))
+        {
+          TELEM_DECODE_setRaw(fd,TELEM_DECODE_getSpeed(baudRate));
+        }
+    }
+
+  if(fd < 0)
+    {
+      if(!flag_pty)
+        {
+          perror(argv[optind]);
+        }
+
+      return(EXIT_FAILURE);
+    }
+
+  if(pLogFileName != NULL)
+    {
+      obj->pLogFile = fopen(pLogFileName,"w");
+
+      if(obj->pLogFile == NULL)
+        {
+          perror(pLogFileName);
+          return(EXIT_FAILURE);
+        }
+    }
+
+  signal(SIGINT,TELEM_DECODE_stop);
+  signal(SIGTERM,TELEM_DECODE_stop);
+
+  while(!TELEM_DECODE_flag_stop)
+    {
+      ssize_t numBytes = read(fd,buffer,sizeof(buffer));
+
+      if(numBytes > 0)
+        {
+          TELEM_DECODE_run(obj,buffer,(size_t)numBytes);
+        }
+      else if((numBytes < 0) && (errno == EINTR))
+        {
+          continue;
+        }
+      else if(flag_pty && (numBytes < 0) && (errno == EIO) && (obj->numBytes == 0))
+        {
+          // the pseudo terminal has no writer yet
+          usleep(10000);
+        }
+      else
+        {
+          // end of the file, or the writer closed the pseudo terminal
+          break;
+        }
+    }
+
+  fflush(stdout);
+
+  if(obj->pLogFile != NULL)
+    {
+      fclose(obj->pLogFile);
+    }
+
+  fprintf(stderr,"bytes %llu, frames %lu (%lu key), log frames %lu, CRC errors %lu, gaps %lu (%lu frames lost)\n",
+          (unsigned long long)obj->numBytes,(unsigned long)obj->numFrames,
+          (unsigned long)obj->numKeyFrames,(unsigned long)obj->numLogFrames,
+          (unsigned long)obj->numCrcErrors,(unsigned long)obj->numGaps,
+          (unsigned long)obj->numLost);
+
+  if(obj->numFrames > 1)
+    {
+      double time_sec = (double)(uint32_t)(obj->time_usec_last - obj->time_usec_first) * 1.0e-6;
+
+      if(time_sec > 0.0)
+        {
+          fprintf(stderr,"telemetry time %.3f s, %.1f frames/s\n",time_sec,
+                  (double)(obj->numFrames - 1) / time_sec);
+        }
+    }
+
+  return(EXIT_SUCCESS);
+} // end of main() function
+
+
+// end of file
@@ -0,0 +1,441 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/telem/src/32b/telem.c
+//! \brief  Portable C code.  These functions define the
+//!         serial telemetry (TELEM) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/telem/src/32b/telem.h"
+
+
+// **************************************************************************
+// the defines
+
+
+// **************************************************************************
+// the globals
+
+//! \brief The CRC-16/CCITT-FALSE table, one entry per nibble
+//!
+static const uint16_t TELEM_crcTable[16] =
+{
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+
+// **************************************************************************
+// the functions
+
+//! \brief     Computes the CRC-16/CCITT-FALSE of bytes
+//! \param[in] pData     The pointer to the bytes, one per word
+//! \param[in] numBytes  The number of bytes
+//! \return    The CRC
+static uint16_t TELEM_computeCrc(const uint16_t *pData,const uint_least16_t numBytes)
+{
+  uint16_t crc = 0xFFFF;
+  uint_least16_t cnt;
+
+  for(cnt=0;cnt<numBytes;cnt++)
+    {
+      uint16_t data = pData[cnt] & 0xFF;
+
+      crc = ((crc << 4) & 0xFFFF) ^ TELEM_crcTable[((crc >> 12) ^ (data >> 4)) & 0xF];
+      crc = ((crc << 4) & 0xFFFF) ^ TELEM_crcTable[((crc >> 12) ^ data) & 0xF];
+    }
+
+  return(crc);
+} // end of TELEM_computeCrc() function
+
+
+//! \brief     Appends the CRC to the frame, COBS encodes it into the transmit buffer and
+//!            appends the delimiter
+//! \param[in] obj       The pointer to the serial telemetry (TELEM) object
+//! \param[in] numBytes  The number of bytes of the frame
+static void TELEM_sendFrame(TELEM_Obj *obj,uint_least16_t numBytes)
+{
+  uint16_t crc = TELEM_computeCrc(obj->frame,numBytes);
+  uint_least16_t codeIndex = 0;
+  uint_least16_t txLength = 1;
+  uint16_t code = 1;
+  uint_least16_t cnt;
+
+  obj->frame[numBytes++] = crc >> 8;
+  obj->frame[numBytes++] = crc & 0xFF;
+
+  for(cnt=0;cnt<numBytes;cnt++)
+    {
+      if(obj->frame[cnt] == 0)
+        {
+          obj->txBuf[codeIndex] = code;
+          codeIndex = txLength++;
+          code = 1;
+        }
+      else
+        {
+          obj->txBuf[txLength++] = obj->frame[cnt];
+          code++;
+
+          if(code == 0xFF)
+            {
+              obj->txBuf[codeIndex] = code;
+              codeIndex = txLength++;
+              code = 1;
+            }
+        }
+    }
+
+  obj->txBuf[codeIndex] = code;
+  obj->txBuf[txLength++] = 0;
+
+  obj->txLength = txLength;
+  obj->txIndex = 0;
+
+  return;
+} // end of TELEM_sendFrame() function
+
+
+//! \brief     Puts a 16-bit little endian value into the frame
+//! \param[in] pFrame  The pointer to the frame position
+//! \param[in] value   The value
+//! \return    The pointer to the next frame position
+static uint16_t *TELEM_putU16(uint16_t *pFrame,const uint16_t value)
+{
+  *pFrame++ = value & 0xFF;
+  *pFrame++ = (value >> 8) & 0xFF;
+
+  return(pFrame);
+} // end of TELEM_putU16() function
+
+
+//! \brief     Puts a 32-bit little endian value into the frame
+//! \param[in] pFrame  The pointer to the frame position
+//! \param[in] value   The value
+//! \return    The pointer to the next frame position
+static uint16_t *TELEM_putU32(uint16_t *pFrame,const uint32_t value)
+{
+  *pFrame++ = (uint16_t)(value & 0xFF);
+  *pFrame++ = (uint16_t)((value >> 8) & 0xFF);
+  *pFrame++ = (uint16_t)((value >> 16) & 0xFF);
+  *pFrame++ = (uint16_t)((value >> 24) & 0xFF);
+
+  return(pFrame);
+} // end of TELEM_putU32() function
+
+
+//! \brief     Builds and sends a key or delta frame of all channels
+//! \param[in] obj  The pointer to the serial telemetry (TELEM) object
+static void TELEM_sendTelemetry(TELEM_Obj *obj)
+{
+  uint16_t *pFrame = obj->frame;
+  uint_least16_t channelNumber;
+
+  if(obj->keyCnt == 0)
+    {
+      *pFrame++ = TELEM_FRAME_KEY;
+      *pFrame++ = obj->seqNumber & 0xFF;
+      *pFrame++ = obj->numChannels;
+
+      for(channelNumber=0;channelNumber<obj->numChannels;channelNumber++)
+        {
+          int32_t value = *obj->pChan[channelNumber];
+
+          pFrame = TELEM_putU32(pFrame,(uint32_t)value);
+          obj->value_z1[channelNumber] = value;
+        }
+
+      obj->keyCnt = obj->keyPeriod;
+    }
+  else
+    {
+      *pFrame++ = TELEM_FRAME_DELTA;
+      *pFrame++ = obj->seqNumber & 0xFF;
+
+      for(channelNumber=0;channelNumber<obj->numChannels;channelNumber++)
+        {
+          int32_t value = *obj->pChan[channelNumber];
+          int32_t delta = (int32_t)((uint32_t)value - (uint32_t)obj->value_z1[channelNumber]);
+          uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+
+          // seven bits per byte, the low bits first
+          while(zigzag >= 0x80)
+            {
+              *pFrame++ = (uint16_t)((zigzag & 0x7F) | 0x80);
+              zigzag >>= 7;
+            }
+
+          *pFrame++ = (uint16_t)zigzag;
+
+          obj->value_z1[channelNumber] = value;
+        }
+    }
+
+  obj->keyCnt--;
+  obj->seqNumber++;
+  obj->numFrames++;
+
+  TELEM_sendFrame(obj,(uint_least16_t)(pFrame - obj->frame));
+
+  return;
+} // end of TELEM_sendTelemetry() function
+
+
+//! \brief     Builds and sends the next frame of a TRIGLOG capture
+//! \param[in] obj  The pointer to the serial telemetry (TELEM) object
+static void TELEM_sendLog(TELEM_Obj *obj)
+{
+  TRIGLOG_Obj *log = (TRIGLOG_Obj *)obj->triglogHandle;
+  uint_least16_t numFrames = TRIGLOG_getNumCaptureFrames(obj->triglogHandle);
+  const int32_t *pLogFrame = TRIGLOG_getCaptureFrame(obj->triglogHandle,obj->logFrameNumber);
+  uint16_t *pFrame = obj->frame;
+  uint_least16_t channelNumber;
+
+  // the capture is gone when the logger was armed again
+  if(pLogFrame == NULL)
+    {
+      obj->flag_logPending = false;
+      return;
+    }
+
+  *pFrame++ = TELEM_FRAME_LOG;
+  *pFrame++ = obj->seqNumber & 0xFF;
+  pFrame = TELEM_putU16(pFrame,obj->logFrameNumber);
+  pFrame = TELEM_putU16(pFrame,numFrames);
+  pFrame = TELEM_putU16(pFrame,TRIGLOG_getTrigFrameNumber(obj->triglogHandle));
+  *pFrame++ = log->numChannels;
+  *pFrame++ = TRIGLOG_getTrigSource(obj->triglogHandle) & 0xFF;
+  pFrame = TELEM_putU32(pFrame,(uint32_t)TRIGLOG_getTrigValue(obj->triglogHandle));
+
+  for(channelNumber=0;channelNumber<log->numChannels;channelNumber++)
+    {
+      pFrame = TELEM_putU32(pFrame,(uint32_t)pLogFrame[channelNumber]);
+    }
+
+  obj->logFrameNumber++;
+
+  if(obj->logFrameNumber >= numFrames)
+    {
+      obj->flag_logPending = false;
+    }
+
+  TELEM_sendFrame(obj,(uint_least16_t)(pFrame - obj->frame));
+
+  return;
+} // end of TELEM_sendLog() function
+
+
+TELEM_Handle TELEM_init(void *pMemory,const size_t numBytes)
+{
+  TELEM_Handle handle;
+  TELEM_Obj *obj;
+
+  if(numBytes < sizeof(TELEM_Obj))
+    return((TELEM_Handle)NULL);
+
+  // assign the handle
+  handle = (TELEM_Handle)pMemory;
+
+  obj = (TELEM_Obj *)handle;
+
+  obj->triglogHandle = NULL;
+  obj->flag_enable = false;
+
+  TELEM_setParams(handle,1000000,0xFFFFFFFF,1000,TELEM_DEFAULT_KEY_PERIOD);
+
+  return(handle);
+} // end of TELEM_init() function
+
+
+uint_least16_t TELEM_addChannel(TELEM_Handle handle,const volatile int32_t *pSrc)
+{
+  TELEM_Obj *obj = (TELEM_Obj *)handle;
+  uint_least16_t channelNumber = obj->numChannels;
+
+  if((channelNumber >= TELEM_MAX_CHANNELS) || (pSrc == NULL))
+    {
+      return(0);
+    }
+
+  obj->pChan[channelNumber] = pSrc;
+  obj->numChannels++;
+
+  // the receiver needs the new channel in a key frame
+  obj->keyCnt = 0;
+
+  return(channelNumber);
+} // end of TELEM_addChannel() function
+
+
+void TELEM_run(TELEM_Handle handle,const uint32_t timerCnt)
+{
+  TELEM_Obj *obj = (TELEM_Obj *)handle;
+  uint32_t deltaCnt;
+
+  // the time starts at the first call
+  if(obj->flag_firstRun)
+    {
+      obj->cnt_z1 = timerCnt;
+      obj->flag_firstRun = false;
+    }
+
+  // handle wrap around of the timer count
+  // NOTE: count down timer
+  if(timerCnt > obj->cnt_z1)
+    {
+      deltaCnt = obj->cnt_z1 + obj->timerPeriod_cnts - timerCnt + 1;
+    }
+  else
+    {
+      deltaCnt = obj->cnt_z1 - timerCnt;
+    }
+
+  obj->cnt_z1 = timerCnt;
+
+  // the time channel
+  obj->usecRem_cnts += deltaCnt;
+
+  if(obj->usecRem_cnts >= obj->cntsPerUsec)
+    {
+      uint32_t numUsec = obj->usecRem_cnts / obj->cntsPerUsec;
+
+      obj->time_usec = (int32_t)((uint32_t)obj->time_usec + numUsec);
+      obj->usecRem_cnts -= numUsec * obj->cntsPerUsec;
+    }
+
+  if(!obj->flag_enable)
+    {
+      obj->elapsed_cnts = 0;
+      return;
+    }
+
+  obj->elapsed_cnts += deltaCnt;
+
+  // frames that are due while the output is still busy are skipped
+  if(obj->elapsed_cnts >= (2 * obj->framePeriod_cnts))
+    {
+      uint32_t numPeriods = obj->elapsed_cnts / obj->framePeriod_cnts;
+
+      obj->numSkipped += numPeriods - 1;
+      obj->elapsed_cnts -= (numPeriods - 1) * obj->framePeriod_cnts;
+    }
+
+  if(obj->txIndex < obj->txLength)
+    {
+      return;
+    }
+
+  if(obj->elapsed_cnts >= obj->framePeriod_cnts)
+    {
+      obj->elapsed_cnts -= obj->framePeriod_cnts;
+
+      TELEM_sendTelemetry(obj);
+
+      return;
+    }
+
+  // a new capture of the logger
+  if((obj->triglogHandle != NULL) && !obj->flag_logPending &&
+     (TRIGLOG_getState(obj->triglogHandle) == TRIGLOG_State_Done) &&
+     (TRIGLOG_getTrigCallCnt(obj->triglogHandle) != obj->logTrigCallCnt))
+    {
+      obj->logTrigCallCnt = TRIGLOG_getTrigCallCnt(obj->triglogHandle);
+      obj->logFrameNumber = 0;
+      obj->flag_logPending = true;
+    }
+
+  if(obj->flag_logPending)
+    {
+      TELEM_sendLog(obj);
+    }
+
+  return;
+} // end of TELEM_run() function
+
+
+void TELEM_setParams(TELEM_Handle handle,
+                     const uint32_t timerFreq_Hz,
+                     const uint32_t timerPeriod_cnts,
+                     const uint32_t frameRate_Hz,
+                     const uint_least16_t keyPeriod)
+{
+  TELEM_Obj *obj = (TELEM_Obj *)handle;
+
+  obj->timerPeriod_cnts = timerPeriod_cnts;
+  obj->cntsPerUsec = (timerFreq_Hz >= 1000000) ? (timerFreq_Hz / 1000000) : 1;
+  obj->framePeriod_cnts = (frameRate_Hz > 0) ? (timerFreq_Hz / frameRate_Hz) : timerFreq_Hz;
+  obj->cnt_z1 = 0;
+  obj->flag_firstRun = true;
+  obj->elapsed_cnts = 0;
+  obj->usecRem_cnts = 0;
+  obj->time_usec = 0;
+
+  obj->keyPeriod = (keyPeriod > 0) ? keyPeriod : 1;
+  obj->keyCnt = 0;
+  obj->seqNumber = 0;
+
+  obj->txLength = 0;
+  obj->txIndex = 0;
+
+  obj->logTrigCallCnt = 0;
+  obj->logFrameNumber = 0;
+  obj->flag_logPending = false;
+
+  obj->numFrames = 0;
+  obj->numSkipped = 0;
+
+  // channel 0 is the time
+  obj->pChan[0] = &obj->time_usec;
+  obj->numChannels = 1;
+
+  return;
+} // end of TELEM_setParams() function
+
+
+void TELEM_setTriglog(TELEM_Handle handle,TRIGLOG_Handle triglogHandle)
+{
+  TELEM_Obj *obj = (TELEM_Obj *)handle;
+
+  // a capture that is complete now is sent too, a trigger is never in call zero
+  obj->triglogHandle = triglogHandle;
+  obj->logTrigCallCnt = 0;
+  obj->flag_logPending = false;
+
+  return;
+} // end of TELEM_setTriglog() function
+
+
+// end of file
@@ -0,0 +1,272 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _TELEM_H_
+#define _TELEM_H_
+
+//! \file   modules/telem/src/32b/telem.h
+//! \brief  Contains the public interface to the
+//!         serial telemetry (TELEM) module routines
+//!
+//!         The telemetry samples up to TELEM_MAX_CHANNELS 32-bit variables
+//!         at a fixed rate in the background loop and sends them as binary
+//!         frames through a byte output such as the SCI transmit FIFO.
+//!         Channel 0 is the time of the sample in microseconds.
+//!
+//!         Every frame is COBS encoded and ends with a zero byte, so the
+//!         receiver finds the next frame after any error.  Before encoding
+//!         a frame is
+//!
+//!             type, sequence, data, CRC-16 high byte, CRC-16 low byte
+//!
+//!         with the CRC-16/CCITT-FALSE of type, sequence and data.  The
+//!         types are
+//!
+//!             TELEM_FRAME_KEY    number of channels, then every channel as
+//!                                a 32-bit little endian value
+//!             TELEM_FRAME_DELTA  the difference of every channel to the
+//!                                previous frame, zigzag and varint coded
+//!             TELEM_FRAME_LOG    one frame of a TRIGLOG capture: frame
+//!                                number, number of frames and trigger frame
+//!                                number as 16-bit little endian values, the
+//!                                number of channels, the trigger source,
+//!                                the trigger value and the channels as
+//!                                32-bit little endian values
+//!
+//!         The sequence number counts the key and delta frames, a receiver
+//!         that misses one waits for the next key frame.  Frames of a TRIGLOG
+//!         capture are sent once per capture in the time left between the
+//!         telemetry frames.
+//!
+//!         TELEM_run() builds at most one frame per call and never waits
+//!         for the output, TELEM_getTxData() and TELEM_advanceTx() hand the
+//!         bytes to the output as it takes them.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+// modules
+#include "sw/modules/types/src/types.h"
+#include "sw/modules/triglog/src/32b/triglog.h"
+
+
+//!
+//!
+//! \defgroup TELEM TELEM
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the maximum number of channels, including the time
+//!
+#define TELEM_MAX_CHANNELS            (12)
+
+//! \brief Defines the frame types
+//!
+#define TELEM_FRAME_KEY               (0x4B)
+#define TELEM_FRAME_DELTA             (0x44)
+#define TELEM_FRAME_LOG               (0x4C)
+
+//! \brief Defines the maximum number of bytes of a frame before encoding
+//!
+#define TELEM_MAX_FRAME_BYTES         (2 + (TELEM_MAX_CHANNELS * 5) + 2)
+
+//! \brief Defines the size of the transmit buffer, bytes
+//! \details One COBS code byte per 254 bytes, one more and the delimiter
+//!
+#define TELEM_TX_BUF_SIZE             (TELEM_MAX_FRAME_BYTES + (TELEM_MAX_FRAME_BYTES / 254) + 2)
+
+//! \brief Defines the default number of frames per key frame
+//!
+#define TELEM_DEFAULT_KEY_PERIOD      (100)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Defines the serial telemetry (TELEM) object
+//!
+typedef struct _TELEM_Obj_
+{
+  const volatile int32_t *pChan[TELEM_MAX_CHANNELS];  //!< the pointers to the sent variables
+  int32_t          value_z1[TELEM_MAX_CHANNELS];      //!< the values of the previous frame
+  uint_least16_t   numChannels;         //!< the number of channels, including the time
+
+  uint32_t         timerPeriod_cnts;    //!< the period of the count down timer, cnts
+  uint32_t         cntsPerUsec;         //!< the timer counts per microsecond
+  uint32_t         framePeriod_cnts;    //!< the frame period, cnts
+  uint32_t         cnt_z1;              //!< the timer count of the previous call, cnts
+  bool             flag_firstRun;       //!< denotes that TELEM_run() has not run since TELEM_setParams()
+  uint32_t         elapsed_cnts;        //!< the time since the frame was due, cnts
+  uint32_t         usecRem_cnts;        //!< the timer counts not yet added to the time, cnts
+  int32_t          time_usec;           //!< the time, usec, wraps around
+
+  uint_least16_t   keyPeriod;           //!< the number of frames per key frame
+  uint_least16_t   keyCnt;              //!< the frames until the next key frame
+  uint_least16_t   seqNumber;           //!< the sequence number of the key and delta frames
+
+  uint16_t         frame[TELEM_MAX_FRAME_BYTES];  //!< the frame being built, one byte per word
+  uint16_t         txBuf[TELEM_TX_BUF_SIZE];      //!< the encoded frame, one byte per word
+  uint_least16_t   txLength;            //!< the number of bytes in the transmit buffer
+  uint_least16_t   txIndex;             //!< the number of bytes handed to the output
+
+  TRIGLOG_Handle   triglogHandle;       //!< the logger whose captures are sent, NULL for none
+  uint32_t         logTrigCallCnt;      //!< the trigger call count of the capture last sent
+  uint_least16_t   logFrameNumber;      //!< the next capture frame to send
+  bool             flag_logPending;     //!< denotes that a capture is being sent
+
+  uint32_t         numFrames;           //!< the number of telemetry frames sent
+  uint32_t         numSkipped;          //!< the number of telemetry frames skipped for a busy output
+  bool             flag_enable;         //!< a flag to enable the telemetry
+} TELEM_Obj;
+
+
+//! \brief Defines the TELEM handle
+//!
+typedef struct _TELEM_Obj_ *TELEM_Handle;
+
+
+// **************************************************************************
+// the globals
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Initializes the serial telemetry (TELEM) object
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The serial telemetry (TELEM) object handle
+extern TELEM_Handle TELEM_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Adds a channel
+//! \param[in] handle  The serial telemetry (TELEM) handle
+//! \param[in] pSrc    The pointer to the sent variable
+//! \return    The channel number, zero if all channels are in use
+extern uint_least16_t TELEM_addChannel(TELEM_Handle handle,const volatile int32_t *pSrc);
+
+
+//! \brief     Runs the telemetry, call from the background loop
+//! \details   Builds the next frame when the output has taken the previous one
+//! \param[in] handle    The serial telemetry (TELEM) handle
+//! \param[in] timerCnt  The count of the free running count down timer, cnts
+extern void TELEM_run(TELEM_Handle handle,const uint32_t timerCnt);
+
+
+//! \brief     Sets the telemetry parameters and removes all channels
+//! \param[in] handle            The serial telemetry (TELEM) handle
+//! \param[in] timerFreq_Hz      The timer frequency, Hz
+//! \param[in] timerPeriod_cnts  The timer period, cnts
+//! \param[in] frameRate_Hz      The telemetry frame rate, Hz
+//! \param[in] keyPeriod         The number of frames per key frame
+extern void TELEM_setParams(TELEM_Handle handle,
+                            const uint32_t timerFreq_Hz,
+                            const uint32_t timerPeriod_cnts,
+                            const uint32_t frameRate_Hz,
+                            const uint_least16_t keyPeriod);
+
+
+//! \brief     Sets the logger whose captures are sent
+//! \param[in] handle         The serial telemetry (TELEM) handle
+//! \param[in] triglogHandle  The triggered data logging (TRIGLOG) handle, NULL for none
+extern void TELEM_setTriglog(TELEM_Handle handle,TRIGLOG_Handle triglogHandle);
+
+
+//! \brief     Marks bytes of the transmit buffer as taken by the output
+//! \param[in] handle    The serial telemetry (TELEM) handle
+//! \param[in] numBytes  The number of bytes taken
+static inline void TELEM_advanceTx(TELEM_Handle handle,const uint_least16_t numBytes)
+{
+  TELEM_Obj *obj = (TELEM_Obj *)handle;
+
+  obj->txIndex += numBytes;
+
+  return;
+} // end of TELEM_advanceTx() function
+
+
+//! \brief     Gets the bytes of the transmit buffer not yet taken by the output
+//! \param[in]  handle  The serial telemetry (TELEM) handle
+//! \param[out] ppData  The pointer to the pointer to the bytes, one per word
+//! \return     The number of bytes
+static inline uint_least16_t TELEM_getTxData(TELEM_Handle handle,const uint16_t **ppData)
+{
+  TELEM_Obj *obj = (TELEM_Obj *)handle;
+
+  *ppData = &obj->txBuf[obj->txIndex];
+
+  return(obj->txLength - obj->txIndex);
+} // end of TELEM_getTxData() function
+
+
+//! \brief     Gets the number of telemetry frames skipped because the output was busy
+//! \param[in] handle  The serial telemetry (TELEM) handle
+//! \return    The number of frames
+static inline uint32_t TELEM_getNumSkipped(TELEM_Handle handle)
+{
+  TELEM_Obj *obj = (TELEM_Obj *)handle;
+
+  return(obj->numSkipped);
+} // end of TELEM_getNumSkipped() function
+
+
+//! \brief     Sets the flag to enable the telemetry
+//! \param[in] handle  The serial telemetry (TELEM) handle
+//! \param[in] state   The desired state
+static inline void TELEM_setFlag_enable(TELEM_Handle handle,const bool state)
+{
+  TELEM_Obj *obj = (TELEM_Obj *)handle;
+
+  obj->flag_enable = state;
+
+  return;
+} // end of TELEM_setFlag_enable() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+#endif // end of _TELEM_H_ definition
+
@@ -0,0 +1,274 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//! \file   modules/triglog/src/32b/triglog.c
+//! \brief  Portable C code.  These functions define the
+//!         triggered data logging (TRIGLOG) module routines
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+#include "sw/modules/triglog/src/32b/triglog.h"
+
+
+// **************************************************************************
+// the globals
+
+
+// **************************************************************************
+// the functions
+
+TRIGLOG_Handle TRIGLOG_init(void *pMemory,const size_t numBytes)
+{
+  TRIGLOG_Handle handle;
+  TRIGLOG_Obj *obj;
+  uint_least16_t cnt;
+
+  if(numBytes < sizeof(TRIGLOG_Obj))
+    return((TRIGLOG_Handle)NULL);
+
+  // assign the handle
+  handle = (TRIGLOG_Handle)pMemory;
+
+  obj = (TRIGLOG_Obj *)handle;
+
+  for(cnt=0;cnt<TRIGLOG_MAX_CHANNELS;cnt++)
+    {
+      obj->pChan[cnt] = NULL;
+    }
+
+  for(cnt=0;cnt<TRIGLOG_NUM_TRIGS;cnt++)
+    {
+      obj->trig[cnt].type = TRIGLOG_TrigType_Off;
+      obj->trig[cnt].pSrc = NULL;
+      obj->trig[cnt].level = 0;
+      obj->trig[cnt].value_z1 = 0;
+    }
+
+  obj->pBuffer = NULL;
+  obj->bufferSize = 0;
+  obj->numChannels = 0;
+  obj->numFrames = 0;
+  obj->numPreFrames = 0;
+  obj->decimation = 1;
+  obj->decimationCnt = 0;
+  obj->writeIndex = 0;
+  obj->numFramesLogged = 0;
+  obj->postCnt = 0;
+  obj->trigIndex = 0;
+  obj->trigNumPreFrames = 0;
+  obj->trigSource = 0;
+  obj->trigValue = 0;
+  obj->callCnt = 0;
+  obj->trigCallCnt = 0;
+  obj->state = TRIGLOG_State_Idle;
+  obj->flag_arm = false;
+  obj->flag_swTrig = false;
+  obj->swTrigCause = 0;
+
+  return(handle);
+} // end of TRIGLOG_init() function
+
+
+void TRIGLOG_arm(TRIGLOG_Handle handle)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+  uint_least16_t trigNumber;
+
+  obj->flag_arm = false;
+
+  if(obj->numFrames == 0)
+    {
+      return;
+    }
+
+  // the edge triggers start from the present values
+  for(trigNumber=0;trigNumber<TRIGLOG_NUM_TRIGS;trigNumber++)
+    {
+      TRIGLOG_Trig_t *pTrig = &obj->trig[trigNumber];
+
+      if(pTrig->type != TRIGLOG_TrigType_Off)
+        {
+          pTrig->value_z1 = *pTrig->pSrc;
+        }
+    }
+
+  obj->decimationCnt = 0;
+  obj->writeIndex = 0;
+  obj->numFramesLogged = 0;
+  obj->postCnt = 0;
+  obj->trigIndex = 0;
+  obj->trigNumPreFrames = 0;
+  obj->trigSource = 0;
+  obj->trigValue = 0;
+  obj->callCnt = 0;
+  obj->trigCallCnt = 0;
+  obj->flag_swTrig = false;
+  obj->state = TRIGLOG_State_Armed;
+
+  return;
+} // end of TRIGLOG_arm() function
+
+
+uint_least16_t TRIGLOG_setParams(TRIGLOG_Handle handle,
+                                 int32_t *pBuffer,
+                                 const uint_least16_t bufferSize,
+                                 const uint_least16_t numChannels,
+                                 const uint_least16_t decimation,
+                                 const uint_least16_t numPreFrames)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+  uint_least16_t cnt;
+
+  obj->state = TRIGLOG_State_Idle;
+  obj->flag_arm = false;
+  obj->numFrames = 0;
+
+  for(cnt=0;cnt<TRIGLOG_MAX_CHANNELS;cnt++)
+    {
+      obj->pChan[cnt] = NULL;
+    }
+
+  for(cnt=0;cnt<TRIGLOG_NUM_TRIGS;cnt++)
+    {
+      obj->trig[cnt].type = TRIGLOG_TrigType_Off;
+    }
+
+  if((pBuffer == NULL) || (numChannels == 0) || (numChannels > TRIGLOG_MAX_CHANNELS) ||
+     (bufferSize < (2 * numChannels)) || (decimation == 0))
+    {
+      return(0);
+    }
+
+  obj->pBuffer = pBuffer;
+  obj->numChannels = numChannels;
+  obj->numFrames = bufferSize / numChannels;
+  obj->bufferSize = obj->numFrames * numChannels;
+  obj->decimation = decimation;
+
+  // at least the trigger frame is recorded after the trigger
+  if(numPreFrames < obj->numFrames)
+    {
+      obj->numPreFrames = numPreFrames;
+    }
+  else
+    {
+      obj->numPreFrames = obj->numFrames - 1;
+    }
+
+  // until the channels are set they log the first word of the buffer
+  for(cnt=0;cnt<TRIGLOG_MAX_CHANNELS;cnt++)
+    {
+      obj->pChan[cnt] = pBuffer;
+    }
+
+  return(obj->numFrames);
+} // end of TRIGLOG_setParams() function
+
+
+void TRIGLOG_setChannel(TRIGLOG_Handle handle,
+                        const uint_least16_t channelNumber,
+                        const volatile int32_t *pSrc)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+
+  if((channelNumber < TRIGLOG_MAX_CHANNELS) && (pSrc != NULL))
+    {
+      obj->pChan[channelNumber] = pSrc;
+    }
+
+  return;
+} // end of TRIGLOG_setChannel() function
+
+
+void TRIGLOG_setTrig(TRIGLOG_Handle handle,
+                     const uint_least16_t trigNumber,
+                     const TRIGLOG_TrigType_e type,
+                     const volatile int32_t *pSrc,
+                     const int32_t level)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+
+  if(trigNumber >= TRIGLOG_NUM_TRIGS)
+    {
+      return;
+    }
+
+  obj->trig[trigNumber].type = (pSrc != NULL) ? type : TRIGLOG_TrigType_Off;
+  obj->trig[trigNumber].pSrc = pSrc;
+  obj->trig[trigNumber].level = level;
+  obj->trig[trigNumber].value_z1 = (pSrc != NULL) ? *pSrc : 0;
+
+  return;
+} // end of TRIGLOG_setTrig() function
+
+
+uint_least16_t TRIGLOG_getNumCaptureFrames(TRIGLOG_Handle handle)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+
+  if(obj->state != TRIGLOG_State_Done)
+    {
+      return(0);
+    }
+
+  return(obj->trigNumPreFrames + obj->numFrames - obj->numPreFrames);
+} // end of TRIGLOG_getNumCaptureFrames() function
+
+
+const int32_t *TRIGLOG_getCaptureFrame(TRIGLOG_Handle handle,const uint_least16_t frameNumber)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+  uint_least32_t index;
+
+  if(frameNumber >= TRIGLOG_getNumCaptureFrames(handle))
+    {
+      return(NULL);
+    }
+
+  // the oldest frame is trigNumPreFrames frames before the trigger frame
+  index = (uint_least32_t)obj->trigIndex + obj->bufferSize -
+          (uint_least32_t)obj->trigNumPreFrames * obj->numChannels +
+          (uint_least32_t)frameNumber * obj->numChannels;
+
+  while(index >= obj->bufferSize)
+    {
+      index -= obj->bufferSize;
+    }
+
+  return(&obj->pBuffer[index]);
+} // end of TRIGLOG_getCaptureFrame() function
+
+
+// end of file
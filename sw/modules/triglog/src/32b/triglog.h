@@ -0,0 +1,489 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#ifndef _TRIGLOG_H_
+#define _TRIGLOG_H_
+
+//! \file   modules/triglog/src/32b/triglog.h
+//! \brief  Contains the public interface to the
+//!         triggered data logging (TRIGLOG) module routines
+//!
+//!         The logger samples up to TRIGLOG_MAX_CHANNELS 32-bit variables
+//!         into one ring buffer, one frame of all channels at a time, with
+//!         the channels of a frame next to each other.  A frame is stored
+//!         every decimation-th call of TRIGLOG_run().
+//!
+//!         Once armed the logger records continuously and checks its
+//!         triggers on every call, so short events are not missed when the
+//!         frames are decimated.  A trigger compares a 32-bit variable with
+//!         a level, or is fired from the code with TRIGLOG_trigger().  After
+//!         the trigger the logger records the post trigger frames and stops,
+//!         so the buffer holds the pre trigger frames, the trigger frame and
+//!         the post trigger frames until the logger is armed again.  Without
+//!         a trigger the logger free runs like DATALOG.
+//!
+//!         TRIGLOG_run() has no loop longer than the number of channels and
+//!         triggers and no division, so it runs in the ISR at a bounded and
+//!         constant cost.
+//!
+//! (C) Copyright 2015, Texas Instruments, Inc.
+
+
+// **************************************************************************
+// the includes
+
+// modules
+#include "sw/modules/types/src/types.h"
+
+
+//!
+//!
+//! \defgroup TRIGLOG TRIGLOG
+//!
+//@{
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// **************************************************************************
+// the defines
+
+//! \brief Defines the maximum number of channels
+//!
+#define TRIGLOG_MAX_CHANNELS          (8)
+
+//! \brief Defines the number of triggers
+//!
+#define TRIGLOG_NUM_TRIGS             (4)
+
+//! \brief Defines the trigger source of TRIGLOG_trigger()
+//!
+#define TRIGLOG_TRIG_SOFTWARE         (TRIGLOG_NUM_TRIGS)
+
+
+// **************************************************************************
+// the typedefs
+
+//! \brief Enumeration for the logger states
+//!
+typedef enum
+{
+  TRIGLOG_State_Idle=0,         //!< not recording
+  TRIGLOG_State_Armed,          //!< recording, waiting for a trigger
+  TRIGLOG_State_Triggered,      //!< recording the post trigger frames
+  TRIGLOG_State_Done            //!< the capture is complete
+} TRIGLOG_State_e;
+
+
+//! \brief Enumeration for the trigger conditions
+//!
+typedef enum
+{
+  TRIGLOG_TrigType_Off=0,       //!< the trigger is disabled
+  TRIGLOG_TrigType_Rising,      //!< the value rises above the level
+  TRIGLOG_TrigType_Falling,     //!< the value falls below the level
+  TRIGLOG_TrigType_AbsAbove,    //!< the magnitude of the value is above the level
+  TRIGLOG_TrigType_Equal,       //!< the value becomes equal to the level
+  TRIGLOG_TrigType_Change       //!< the value changes
+} TRIGLOG_TrigType_e;
+
+
+//! \brief Defines a trigger
+//!
+typedef struct _TRIGLOG_Trig_t_
+{
+  TRIGLOG_TrigType_e       type;        //!< the trigger condition
+  const volatile int32_t  *pSrc;        //!< the pointer to the compared variable
+  int32_t                  level;       //!< the trigger level
+  int32_t                  value_z1;    //!< the value of the previous call
+} TRIGLOG_Trig_t;
+
+
+//! \brief Defines the triggered data logging (TRIGLOG) object
+//!
+typedef struct _TRIGLOG_Obj_
+{
+  const volatile int32_t *pChan[TRIGLOG_MAX_CHANNELS];  //!< the pointers to the logged variables
+  TRIGLOG_Trig_t   trig[TRIGLOG_NUM_TRIGS];             //!< the triggers
+
+  int32_t         *pBuffer;             //!< the pointer to the ring buffer
+  uint_least16_t   bufferSize;          //!< the number of words of the ring buffer in use
+  uint_least16_t   numChannels;         //!< the number of channels
+  uint_least16_t   numFrames;           //!< the number of frames of the ring buffer
+  uint_least16_t   numPreFrames;        //!< the number of frames before the trigger frame
+  uint_least16_t   decimation;          //!< the number of calls per stored frame
+  uint_least16_t   decimationCnt;       //!< the calls until the next stored frame
+
+  uint_least16_t   writeIndex;          //!< the word index of the next frame
+  uint_least16_t   numFramesLogged;     //!< the number of frames since arming, saturates at numFrames
+  uint_least16_t   postCnt;             //!< the number of frames left to record after the trigger
+
+  uint_least16_t   trigIndex;           //!< the word index of the trigger frame
+  uint_least16_t   trigNumPreFrames;    //!< the number of valid frames before the trigger frame
+  uint_least16_t   trigSource;          //!< the trigger that fired, TRIGLOG_TRIG_SOFTWARE for TRIGLOG_trigger()
+  int32_t          trigValue;           //!< the value of the trigger variable, or the cause given to TRIGLOG_trigger()
+  uint32_t         callCnt;             //!< the number of calls since arming
+  uint32_t         trigCallCnt;         //!< the number of calls from arming to the trigger
+
+  TRIGLOG_State_e  state;               //!< the logger state
+  bool             flag_arm;            //!< a flag to arm the logger in the next call
+  bool             flag_swTrig;         //!< a flag to trigger in the next call
+  int32_t          swTrigCause;         //!< the cause given to TRIGLOG_trigger()
+} TRIGLOG_Obj;
+
+
+//! \brief Defines the TRIGLOG handle
+//!
+typedef struct _TRIGLOG_Obj_ *TRIGLOG_Handle;
+
+
+// **************************************************************************
+// the globals
+
+
+// **************************************************************************
+// the function prototypes
+
+//! \brief     Initializes the triggered data logging (TRIGLOG) object
+//! \param[in] pMemory   A pointer to the memory for the object
+//! \param[in] numBytes  The number of bytes allocated for the object, bytes
+//! \return    The triggered data logging (TRIGLOG) object handle
+extern TRIGLOG_Handle TRIGLOG_init(void *pMemory,const size_t numBytes);
+
+
+//! \brief     Arms the logger, call when TRIGLOG_run() is not running
+//! \details   From the background loop use TRIGLOG_setFlag_arm() instead
+//! \param[in] handle  The triggered data logging (TRIGLOG) handle
+extern void TRIGLOG_arm(TRIGLOG_Handle handle);
+
+
+//! \brief     Sets the ring buffer and the capture window
+//! \details   Stops the logger and disables all channels and triggers
+//! \param[in] handle        The triggered data logging (TRIGLOG) handle
+//! \param[in] pBuffer       The pointer to the ring buffer
+//! \param[in] bufferSize    The number of words of the ring buffer
+//! \param[in] numChannels   The number of channels, 1 to TRIGLOG_MAX_CHANNELS
+//! \param[in] decimation    The number of calls per stored frame, at least 1
+//! \param[in] numPreFrames  The number of frames before the trigger frame
+//! \return    The number of frames of the ring buffer, zero for invalid parameters
+extern uint_least16_t TRIGLOG_setParams(TRIGLOG_Handle handle,
+                                        int32_t *pBuffer,
+                                        const uint_least16_t bufferSize,
+                                        const uint_least16_t numChannels,
+                                        const uint_least16_t decimation,
+                                        const uint_least16_t numPreFrames);
+
+
+//! \brief     Sets the variable of a channel
+//! \param[in] handle         The triggered data logging (TRIGLOG) handle
+//! \param[in] channelNumber  The channel number
+//! \param[in] pSrc           The pointer to the logged variable
+extern void TRIGLOG_setChannel(TRIGLOG_Handle handle,
+                               const uint_least16_t channelNumber,
+                               const volatile int32_t *pSrc);
+
+
+//! \brief     Sets a trigger
+//! \param[in] handle      The triggered data logging (TRIGLOG) handle
+//! \param[in] trigNumber  The trigger number
+//! \param[in] type        The trigger condition
+//! \param[in] pSrc        The pointer to the compared variable
+//! \param[in] level       The trigger level
+extern void TRIGLOG_setTrig(TRIGLOG_Handle handle,
+                            const uint_least16_t trigNumber,
+                            const TRIGLOG_TrigType_e type,
+                            const volatile int32_t *pSrc,
+                            const int32_t level);
+
+
+//! \brief     Gets the number of frames of a complete capture
+//! \param[in] handle  The triggered data logging (TRIGLOG) handle
+//! \return    The number of frames, zero unless the state is TRIGLOG_State_Done
+extern uint_least16_t TRIGLOG_getNumCaptureFrames(TRIGLOG_Handle handle);
+
+
+//! \brief     Gets a frame of a complete capture
+//! \param[in] handle       The triggered data logging (TRIGLOG) handle
+//! \param[in] frameNumber  The frame number, zero is the oldest frame
+//! \return    The pointer to the channels of the frame, NULL if there is no such frame
+extern const int32_t *TRIGLOG_getCaptureFrame(TRIGLOG_Handle handle,const uint_least16_t frameNumber);
+
+
+//! \brief     Gets the logger state
+//! \param[in] handle  The triggered data logging (TRIGLOG) handle
+//! \return    The logger state
+static inline TRIGLOG_State_e TRIGLOG_getState(TRIGLOG_Handle handle)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+
+  return(obj->state);
+} // end of TRIGLOG_getState() function
+
+
+//! \brief     Gets the number of channels
+//! \param[in] handle  The triggered data logging (TRIGLOG) handle
+//! \return    The number of channels
+static inline uint_least16_t TRIGLOG_getNumChannels(TRIGLOG_Handle handle)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+
+  return(obj->numChannels);
+} // end of TRIGLOG_getNumChannels() function
+
+
+//! \brief     Gets the frame number of the trigger frame in a complete capture
+//! \param[in] handle  The triggered data logging (TRIGLOG) handle
+//! \return    The frame number
+static inline uint_least16_t TRIGLOG_getTrigFrameNumber(TRIGLOG_Handle handle)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+
+  return(obj->trigNumPreFrames);
+} // end of TRIGLOG_getTrigFrameNumber() function
+
+
+//! \brief     Gets the trigger that fired
+//! \param[in] handle  The triggered data logging (TRIGLOG) handle
+//! \return    The trigger number, TRIGLOG_TRIG_SOFTWARE for TRIGLOG_trigger()
+static inline uint_least16_t TRIGLOG_getTrigSource(TRIGLOG_Handle handle)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+
+  return(obj->trigSource);
+} // end of TRIGLOG_getTrigSource() function
+
+
+//! \brief     Gets the value of the trigger variable when the trigger fired
+//! \param[in] handle  The triggered data logging (TRIGLOG) handle
+//! \return    The value, or the cause given to TRIGLOG_trigger()
+static inline int32_t TRIGLOG_getTrigValue(TRIGLOG_Handle handle)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+
+  return(obj->trigValue);
+} // end of TRIGLOG_getTrigValue() function
+
+
+//! \brief     Gets the number of calls from arming to the trigger
+//! \param[in] handle  The triggered data logging (TRIGLOG) handle
+//! \return    The number of calls
+static inline uint32_t TRIGLOG_getTrigCallCnt(TRIGLOG_Handle handle)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+
+  return(obj->trigCallCnt);
+} // end of TRIGLOG_getTrigCallCnt() function
+
+
+//! \brief     Sets the flag to arm the logger in the next call of TRIGLOG_run()
+//! \param[in] handle  The triggered data logging (TRIGLOG) handle
+//! \param[in] state   The desired state
+static inline void TRIGLOG_setFlag_arm(TRIGLOG_Handle handle,const bool state)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+
+  obj->flag_arm = state;
+
+  return;
+} // end of TRIGLOG_setFlag_arm() function
+
+
+//! \brief     Triggers the logger from the code in the next call of TRIGLOG_run()
+//! \details   Ignored unless the logger is armed
+//! \param[in] handle  The triggered data logging (TRIGLOG) handle
+//! \param[in] cause   The cause, returned by TRIGLOG_getTrigValue()
+static inline void TRIGLOG_trigger(TRIGLOG_Handle handle,const int32_t cause)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+
+  if(obj->state == TRIGLOG_State_Armed)
+    {
+      obj->swTrigCause = cause;
+      obj->flag_swTrig = true;
+    }
+
+  return;
+} // end of TRIGLOG_trigger() function
+
+
+//! \brief     Checks a trigger condition
+//! \param[in] pTrig  The pointer to the trigger
+//! \param[in] value  The value of the trigger variable
+//! \return    The trigger state, true when the condition is met
+static inline bool TRIGLOG_checkTrig(const TRIGLOG_Trig_t *pTrig,const int32_t value)
+{
+  bool flag_trig;
+
+  switch(pTrig->type)
+    {
+      case TRIGLOG_TrigType_Rising:
+        flag_trig = (value > pTrig->level) && (pTrig->value_z1 <= pTrig->level);
+        break;
+      case TRIGLOG_TrigType_Falling:
+        flag_trig = (value < pTrig->level) && (pTrig->value_z1 >= pTrig->level);
+        break;
+      case TRIGLOG_TrigType_AbsAbove:
+        flag_trig = (value > pTrig->level) || (value < -pTrig->level);
+        break;
+      case TRIGLOG_TrigType_Equal:
+        flag_trig = (value == pTrig->level) && (pTrig->value_z1 != pTrig->level);
+        break;
+      case TRIGLOG_TrigType_Change:
+        flag_trig = (value != pTrig->value_z1);
+        break;
+      default:
+        flag_trig = false;
+        break;
+    }
+
+  return(flag_trig);
+} // end of TRIGLOG_checkTrig() function
+
+
+//! \brief     Runs the logger, call once per ISR
+//! \param[in] handle  The triggered data logging (TRIGLOG) handle
+static inline void TRIGLOG_run(TRIGLOG_Handle handle)
+{
+  TRIGLOG_Obj *obj = (TRIGLOG_Obj *)handle;
+
+  if(obj->flag_arm)
+    {
+      TRIGLOG_arm(handle);
+    }
+
+  if((obj->state == TRIGLOG_State_Idle) || (obj->state == TRIGLOG_State_Done))
+    {
+      return;
+    }
+
+  obj->callCnt++;
+
+  if(obj->state == TRIGLOG_State_Armed)
+    {
+      uint_least16_t trigSource = TRIGLOG_TRIG_SOFTWARE + 1;
+      int32_t trigValue = 0;
+      uint_least16_t trigNumber;
+
+      // check all triggers so the previous values stay current
+      for(trigNumber=0;trigNumber<TRIGLOG_NUM_TRIGS;trigNumber++)
+        {
+          TRIGLOG_Trig_t *pTrig = &obj->trig[trigNumber];
+
+          if(pTrig->type != TRIGLOG_TrigType_Off)
+            {
+              int32_t value = *pTrig->pSrc;
+
+              if((trigSource > TRIGLOG_NUM_TRIGS) && TRIGLOG_checkTrig(pTrig,value))
+                {
+                  trigSource = trigNumber;
+                  trigValue = value;
+                }
+
+              pTrig->value_z1 = value;
+            }
+        }
+
+      if((trigSource > TRIGLOG_NUM_TRIGS) && obj->flag_swTrig)
+        {
+          trigSource = TRIGLOG_TRIG_SOFTWARE;
+          trigValue = obj->swTrigCause;
+        }
+
+      if(trigSource <= TRIGLOG_NUM_TRIGS)
+        {
+          obj->state = TRIGLOG_State_Triggered;
+          obj->trigSource = trigSource;
+          obj->trigValue = trigValue;
+          obj->trigCallCnt = obj->callCnt;
+          obj->trigIndex = obj->writeIndex;
+          obj->trigNumPreFrames = (obj->numFramesLogged < obj->numPreFrames) ? obj->numFramesLogged : obj->numPreFrames;
+          obj->postCnt = obj->numFrames - obj->numPreFrames;
+
+          // the trigger frame is always stored
+          obj->decimationCnt = 0;
+        }
+
+      obj->flag_swTrig = false;
+    }
+
+  if(obj->decimationCnt == 0)
+    {
+      int32_t *pFrame = &obj->pBuffer[obj->writeIndex];
+      uint_least16_t channelNumber;
+
+      for(channelNumber=0;channelNumber<obj->numChannels;channelNumber++)
+        {
+          pFrame[channelNumber] = *obj->pChan[channelNumber];
+        }
+
+      obj->writeIndex += obj->numChannels;
+
+      if(obj->writeIndex >= obj->bufferSize)
+        {
+          obj->writeIndex = 0;
+        }
+
+      if(obj->numFramesLogged < obj->numFrames)
+        {
+          obj->numFramesLogged++;
+        }
+
+      if(obj->state == TRIGLOG_State_Triggered)
+        {
+          obj->postCnt--;
+
+          if(obj->postCnt == 0)
+            {
+              obj->state = TRIGLOG_State_Done;
+            }
+        }
+
+      obj->decimationCnt = obj->decimation - 1;
+    }
+  else
+    {
+      obj->decimationCnt--;
+    }
+
+  return;
+} // end of TRIGLOG_run() function
+
+
+#ifdef __cplusplus
+}
+#endif // extern "C"
+
+//@} // ingroup
+#endif // end of _TRIGLOG_H_ definition
+
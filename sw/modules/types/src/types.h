@@ -123,7 +123,18 @@ typedef float           float_t;
 
 //! \brief Defines the portable data type for 64 bit, signed floating-point data
 //!
+#if defined(__TMS320C28XX__) || defined(__TMS320C28XX_CLA__)
 typedef long double     double_t;
+#else
+// the host C library defines double_t, which is already 64 bits wide
+#include <math.h>
+
+// the C2000 compiler defines NULL as 0 and user.h uses it for unused motor parameters
+#include <stddef.h>
+#include <stdlib.h>
+#undef NULL
+#define NULL 0
+#endif
 
 
 #ifdef __TMS320C28XX_CLA__
@@ -915,6 +915,42 @@ void USER_calcPIgains(CTRL_Handle handle)
 #endif
 
 
+void USER_calcFwFfTable(_iq *pTable,const uint_least16_t numPoints,const float_t maxIndex_pu,const float_t VsRef_pu)
+{
+  float_t flux_Wb = USER_MOTOR_RATED_FLUX/MATH_TWO_PI;
+  float_t minId_A = USER_MAX_NEGATIVE_ID_REF_CURRENT_A;
+  uint_least16_t cnt;
+
+  for(cnt=0;cnt<numPoints;cnt++)
+    {
+      // the index is the speed over the DC bus voltage, the phase voltage peak is Vs/2 of the DC bus
+      float_t index_pu = maxIndex_pu*(float_t)cnt/(float_t)(numPoints - 1);
+      float_t Id_A = 0.0;
+
+      if(index_pu > 0.0)
+        {
+          float_t fluxMax_Wb = VsRef_pu*USER_IQ_FULL_SCALE_VOLTAGE_V/(2.0*MATH_TWO_PI*USER_IQ_FULL_SCALE_FREQ_Hz*index_pu);
+
+          // without load, w*(flux + Ls_d*Id) reaches the voltage reference
+          Id_A = (fluxMax_Wb - flux_Wb)/USER_MOTOR_Ls_d;
+        }
+
+      if(Id_A > 0.0)
+        {
+          Id_A = 0.0;
+        }
+      else if(Id_A < minId_A)
+        {
+          Id_A = minId_A;
+        }
+
+      pTable[cnt] = _IQ(Id_A/USER_IQ_FULL_SCALE_CURRENT_A);
+    }
+
+  return;
+} // end of USER_calcFwFfTable() function
+
+
 //! \brief     Computes the scale factor needed to convert from torque created by Ld, Lq, Id and Iq, from per unit to Nm
 //!
 _iq USER_computeTorque_Ls_Id_Iq_pu_to_Nm_sf(void)
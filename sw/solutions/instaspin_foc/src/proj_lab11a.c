@@ -58,6 +58,7 @@
 #endif
 
 // Include header files used in the main function
+#include "sw/modules/filter/src/32b/filter_bank.h"
 
 // **************************************************************************
 // the defines
@@ -86,8 +87,8 @@ uint16_t        pidCntSpeed;                  //!< count variable to decimate th
 IPARK_Handle    iparkHandle;                  //!< the handle for the inverse Park transform
 IPARK_Obj       ipark;                        //!< the inverse Park transform object
 
-FILTER_FO_Handle  filterHandle[6];            //!< the handles for the 3-current and 3-voltage filters for offset calculation
-FILTER_FO_Obj     filter[6];                  //!< the 3-current and 3-voltage filters for offset calculation
+FILTER_BANK_Handle filterBankHandle;         //!< the handle for the 3-current and 3-voltage filters for offset calculation
+FILTER_BANK_Obj    filterBank;               //!< the 3-current and 3-voltage filters for offset calculation, channels 0-2 are the currents
 
 SVGENCURRENT_Obj     svgencurrent;
 SVGENCURRENT_Handle  svgencurrentHandle;
@@ -338,18 +339,14 @@ void main(void)
 
   // initialize and configure offsets using filters
   {
-    uint16_t cnt = 0;
     _iq b0 = _IQ(gUserParams.offsetPole_rps/(float_t)gUserParams.ctrlFreq_Hz);
     _iq a1 = (b0 - _IQ(1.0));
     _iq b1 = _IQ(0.0);
 
-    for(cnt=0;cnt<6;cnt++)
-      {
-        filterHandle[cnt] = FILTER_FO_init(&filter[cnt],sizeof(filter[0]));
-        FILTER_FO_setDenCoeffs(filterHandle[cnt],a1);
-        FILTER_FO_setNumCoeffs(filterHandle[cnt],b0,b1);
-        FILTER_FO_setInitialConditions(filterHandle[cnt],_IQ(0.0),_IQ(0.0));
-      }
+    // one bank for all six channels, the initial conditions are zero
+    filterBankHandle = FILTER_BANK_init(&filterBank,sizeof(filterBank));
+    FILTER_BANK_setDenCoeffs(filterBankHandle,a1,_IQ(0.0));
+    FILTER_BANK_setNumCoeffs(filterBankHandle,b0,b1,_IQ(0.0));
 
     gMotorVars.Flag_enableOffsetcalc = false;
   }
@@ -902,12 +899,12 @@ void runOffsetsCalculation(void)
       // reset offsets used
       gOffsets_I_pu.value[cnt] = _IQ(0.0);
       gOffsets_V_pu.value[cnt] = _IQ(0.0);
-
-      // run offset estimation
-      FILTER_FO_run(filterHandle[cnt],gAdcData.I.value[cnt]);
-      FILTER_FO_run(filterHandle[cnt+3],gAdcData.V.value[cnt]);
     }
 
+  // run offset estimation
+  FILTER_BANK_runFo(filterBankHandle,0,3,gAdcData.I.value);
+  FILTER_BANK_runFo(filterBankHandle,3,3,gAdcData.V.value);
+
   if(gOffsetCalcCount++ >= gUserParams.ctrlWaitTime[CTRL_State_OffLine])
     {
       gMotorVars.Flag_enableOffsetcalc = false;
@@ -916,12 +913,12 @@ void runOffsetsCalculation(void)
       for(cnt=0;cnt<3;cnt++)
         {
           // get calculated offsets from filter
-          gOffsets_I_pu.value[cnt] = FILTER_FO_get_y1(filterHandle[cnt]);
-          gOffsets_V_pu.value[cnt] = FILTER_FO_get_y1(filterHandle[cnt+3]);
+          gOffsets_I_pu.value[cnt] = FILTER_BANK_get_y1(filterBankHandle,cnt);
+          gOffsets_V_pu.value[cnt] = FILTER_BANK_get_y1(filterBankHandle,cnt+3);
 
           // clear filters
-          FILTER_FO_setInitialConditions(filterHandle[cnt],_IQ(0.0),_IQ(0.0));
-          FILTER_FO_setInitialConditions(filterHandle[cnt+3],_IQ(0.0),_IQ(0.0));
+          FILTER_BANK_setInitialConditions(filterBankHandle,cnt,_IQ(0.0),_IQ(0.0),_IQ(0.0),_IQ(0.0));
+          FILTER_BANK_setInitialConditions(filterBankHandle,cnt+3,_IQ(0.0),_IQ(0.0),_IQ(0.0),_IQ(0.0));
         }
     }
 